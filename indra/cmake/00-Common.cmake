@@ -45,7 +45,7 @@ set(CMAKE_CONFIGURATION_TYPES "RelWithDebInfo;Release;Debug" CACHE STRING
     "Supported build types." FORCE)
 
 # SIMD config
-option(USE_AVX2 "Enable usage of the AVX2 instruction set" OFF)
+option(USE_AVX2 "Enable usage of the AVX2 and FMA instruction sets" OFF)
 option(USE_AVX "Enable usage of the AVX instruction set" OFF)
 option(USE_SSE42 "Enable usage of the SSE4.2 instruction set" ON)
 
@@ -196,7 +196,7 @@ if (LINUX)
   endif()
 
   if (USE_AVX2)
-    add_compile_options(-mavx2)
+    add_compile_options(-mavx2 -mfma)
   elseif (USE_AVX)
     add_compile_options(-mavx)
   elseif (USE_SSE42)
@@ -32,12 +32,17 @@
 
 // Linden library includes
 #include "llimage.h"
+#include "llimagebc.h"
+#include "llimagedxt.h"
 #include "llimagefilter.h"
 #include "llimagejpeg.h"
 #include "llimagepng.h"
 #include "llimagebmp.h"
 #include "llimagetga.h"
 #include "llimagej2c.h"
+#include "llimagemips.h"
+#include "llimagesimd.h"
+#include "llimageworker.h"
 #include "lldir.h"
 #include "lldiriterator.h"
 #include "v4coloru.h"
@@ -45,6 +50,9 @@
 #include "llcleanup.h"
 
 // system libraries
+#include <atomic>
+#include <ctime>
+#include <functional>
 #include <iostream>
 
 // doc string provided when invoking the program with --help
@@ -97,6 +105,29 @@ static const char USAGE[] = "\n"
 "        Results in <metric>_report.csv\n"
 " -s, --image-stats\n"
 "        Output stats for each input and output image.\n"
+" -refine, --refine_benchmark\n"
+"        Decode each j2c input at every discard level from 5 down to 0, the way textures\n"
+"        sharpen in the viewer, and report the CPU time per fully refined texture.\n"
+"        Each sequence is run once with a new image per level and once reusing the same\n"
+"        image so that the decoder can carry state over between levels.\n"
+"        The wall clock latency until the full resolution image is ready is reported too.\n"
+" -threads, --decode_threads <n>\n"
+"        Let j2c images of 1024x1024 pixels or more use up to <n> threads while decoding.\n"
+"        Default is 1 (single threaded).\n"
+" -kernels, --kernel_benchmark\n"
+"        Time the LLImageRaw flip, conversion, compositing and scaling operations on the\n"
+"        input images with each pixel kernel set this CPU supports (scalar, SSE4.1/NEON, AVX2).\n"
+"        Uses a generated 1000x1000 image when no input is given.\n"
+" -mips, --mip_benchmark\n"
+"        Time building full mip chains of the input images with the 8 bit box filter used\n"
+"        when uploading textures and with each LLImageMipChain filter, one at a time and\n"
+"        in parallel on the image decode pool.\n"
+"        Uses generated 1024x1024 and 2048x2048 images when no input is given.\n"
+" -bc, --bc_benchmark\n"
+"        Block compress the input images to BC1, BC3, BC5 and BC7 at each quality setting\n"
+"        and report the encode time and PSNR of the decoded result, then time compressing\n"
+"        full mip chains on the image decode pool at normal quality.\n"
+"        Uses a generated 1024x1024 image when no input is given.\n"
 "\n";
 
 // true when all image loading is done. Used by metric logging thread to know when to stop the thread.
@@ -192,6 +223,468 @@ LLPointer<LLImageRaw> load_image(const std::string &src_filename, int discard_le
     return raw_image;
 }
 
+struct RefineTimes
+{
+    F64 mCPU = 0.0;      // seconds of CPU over all the decodes
+    F64 mLatency = 0.0;  // wall clock seconds until discard 0 was decoded
+};
+
+// Decode a j2c file at each discard level from coarsest to finest.
+// With reuse_image, a single LLImageJ2C is decoded repeatedly as LLTextureFetch does.
+bool refine_image(const std::string &src_filename, bool reuse_image, RefineTimes &times)
+{
+    LLPointer<LLImageJ2C> image;
+    std::clock_t cpu = 0;
+    LLTimer latency;
+    for (S32 discard_level = MAX_DISCARD_LEVEL; discard_level >= 0; --discard_level)
+    {
+        if (image.isNull() || !reuse_image)
+        {
+            image = new LLImageJ2C;
+            if (!image->load(src_filename))
+            {
+                return false;
+            }
+        }
+        image->setDiscardLevel(discard_level);
+
+        LLPointer<LLImageRaw> raw_image = new LLImageRaw;
+        std::clock_t start = std::clock();
+        bool success = image->decode(raw_image, 0.0f) && raw_image->getData();
+        cpu += std::clock() - start;
+        if (!success)
+        {
+            return false;
+        }
+    }
+    times.mCPU = (F64)cpu / CLOCKS_PER_SEC;
+    times.mLatency = latency.getElapsedTimeF64();
+    return true;
+}
+
+void refine_benchmark(const std::list<std::string> &input_filenames)
+{
+    RefineTimes total_fresh;
+    RefineTimes total_reused;
+    S32 count = 0;
+    for (const std::string &file_name : input_filenames)
+    {
+        if (LLImageBase::getCodecFromExtension(gDirUtilp->getExtension(file_name)) != IMG_CODEC_J2C)
+        {
+            continue;
+        }
+        RefineTimes fresh;
+        RefineTimes reused;
+        if (!refine_image(file_name, false, fresh) || !refine_image(file_name, true, reused))
+        {
+            std::cout << "Error: Image " << file_name << " could not be decoded" << std::endl;
+            continue;
+        }
+        std::cout << file_name << " : new image " << fresh.mCPU * 1000.0 << " ms CPU, "
+                  << fresh.mLatency * 1000.0 << " ms to full res; reused image "
+                  << reused.mCPU * 1000.0 << " ms CPU, "
+                  << reused.mLatency * 1000.0 << " ms to full res" << std::endl;
+        total_fresh.mCPU += fresh.mCPU;
+        total_fresh.mLatency += fresh.mLatency;
+        total_reused.mCPU += reused.mCPU;
+        total_reused.mLatency += reused.mLatency;
+        count++;
+    }
+
+    if (count)
+    {
+        std::cout << "Refined " << count << " textures, per fully refined texture : new image "
+                  << total_fresh.mCPU * 1000.0 / count << " ms CPU, "
+                  << total_fresh.mLatency * 1000.0 / count << " ms to full res; reused image "
+                  << total_reused.mCPU * 1000.0 / count << " ms CPU, "
+                  << total_reused.mLatency * 1000.0 / count << " ms to full res" << std::endl;
+    }
+}
+
+// Run op a few times on fresh copies of src and return the average wall clock seconds per call
+template<typename OP>
+F64 time_kernel(LLImageRaw* src, OP op)
+{
+    const S32 RUNS = 20;
+    F64 total = 0.0;
+    for (S32 run = 0; run < RUNS; ++run)
+    {
+        LLPointer<LLImageRaw> image = new LLImageRaw(src->getData(), src->getWidth(), src->getHeight(), src->getComponents());
+        LLTimer timer;
+        op(image);
+        total += timer.getElapsedTimeF64();
+    }
+    return total / RUNS;
+}
+
+void kernel_benchmark_image(const std::string &name, LLPointer<LLImageRaw> raw_image)
+{
+    LLPointer<LLImageRaw> rgb = new LLImageRaw(raw_image->getWidth(), raw_image->getHeight(), 3);
+    LLPointer<LLImageRaw> rgba = new LLImageRaw(raw_image->getWidth(), raw_image->getHeight(), 4);
+    if (raw_image->getComponents() == 4)
+    {
+        rgba->copyUnscaled(raw_image);
+        rgb->copyUnscaled4onto3(raw_image);
+    }
+    else
+    {
+        rgb->copyUnscaled(raw_image);
+        rgba->copyUnscaled3onto4(raw_image);
+    }
+    // Compositing only does real work where alpha is partial
+    U8* data = rgba->getData();
+    for (S32 i = 0; i < rgba->getWidth() * rgba->getHeight(); ++i)
+    {
+        data[i * 4 + 3] = (U8)(i * 7);
+    }
+
+    const S32 width = rgb->getWidth();
+    const S32 height = rgb->getHeight();
+    const S32 pow2_width = LLImageRaw::expandDimToPowerOfTwo(width);
+    const S32 pow2_height = LLImageRaw::expandDimToPowerOfTwo(height);
+    LLPointer<LLImageRaw> smaller_rgb = rgb->scaled(width * 3 / 4, height * 3 / 4);
+
+    struct Kernel
+    {
+        const char* mName;
+        std::function<F64()> mRun;
+    };
+    const Kernel kernels[] = {
+        { "verticalFlip", [&]() { return time_kernel(rgba, [](LLImageRaw* image) { image->verticalFlip(); }); } },
+        { "copyUnscaled3onto4", [&]() { return time_kernel(rgba, [&](LLImageRaw* image) { image->copyUnscaled3onto4(rgb); }); } },
+        { "copyUnscaled4onto3", [&]() { return time_kernel(rgb, [&](LLImageRaw* image) { image->copyUnscaled4onto3(rgba); }); } },
+        { "compositeUnscaled4onto3", [&]() { return time_kernel(rgb, [&](LLImageRaw* image) { image->compositeUnscaled4onto3(rgba); }); } },
+        { "compositeScaled4onto3", [&]() { return time_kernel(smaller_rgb, [&](LLImageRaw* image) { image->compositeScaled4onto3(rgba); }); } },
+        { "scale up 3", [&]() { return time_kernel(rgb, [&](LLImageRaw* image) { image->scale(pow2_width, pow2_height); }); } },
+        { "scale up 4", [&]() { return time_kernel(rgba, [&](LLImageRaw* image) { image->scale(pow2_width, pow2_height); }); } },
+        { "scale down 4", [&]() { return time_kernel(rgba, [&](LLImageRaw* image) { image->scale(pow2_width / 4, pow2_height / 4); }); } },
+    };
+
+    std::cout << name << " (" << width << "x" << height << "), ms per call:" << std::endl;
+    for (const Kernel &kernel : kernels)
+    {
+        std::cout << "    " << kernel.mName;
+        F64 scalar_time = 0.0;
+        for (S32 set = LLImageSIMD::KERNELS_SCALAR; set <= LLImageSIMD::getSupportedKernels(); ++set)
+        {
+            LLImageSIMD::setKernels((LLImageSIMD::EKernels)set);
+            F64 seconds = kernel.mRun();
+            if (set == LLImageSIMD::KERNELS_SCALAR)
+            {
+                scalar_time = seconds;
+            }
+            std::cout << " : " << LLImageSIMD::getKernelsName((LLImageSIMD::EKernels)set) << " " << seconds * 1000.0;
+            if (set != LLImageSIMD::KERNELS_SCALAR && seconds > 0.0)
+            {
+                std::cout << " (x" << scalar_time / seconds << ")";
+            }
+        }
+        std::cout << std::endl;
+    }
+    LLImageSIMD::setKernels(LLImageSIMD::getSupportedKernels());
+}
+
+void kernel_benchmark(const std::list<std::string> &input_filenames)
+{
+    if (input_filenames.empty())
+    {
+        // Not a power of two, like the images that end up scaled in the viewer
+        LLPointer<LLImageRaw> noise = new LLImageRaw(1000, 1000, 4);
+        U8* data = noise->getData();
+        for (S32 i = 0; i < noise->getDataSize(); ++i)
+        {
+            data[i] = (U8)((i * 2654435761U) >> 24);
+        }
+        kernel_benchmark_image("generated", noise);
+        return;
+    }
+
+    for (const std::string &file_name : input_filenames)
+    {
+        LLPointer<LLImageRaw> raw_image = load_image(file_name, -1, NULL, 0, false);
+        if (!raw_image)
+        {
+            std::cout << "Error: Image " << file_name << " could not be loaded" << std::endl;
+            continue;
+        }
+        kernel_benchmark_image(file_name, raw_image);
+    }
+}
+
+// Box filtered 8 bit chain as LLImageGL::setImage() builds it when it
+// can't use glGenerateMipmap()
+void box_mips(const LLImageRaw* src)
+{
+    S32 w = src->getWidth();
+    S32 h = src->getHeight();
+    S32 components = src->getComponents();
+    std::vector<U8> prev(src->getData(), src->getData() + w * h * components);
+    std::vector<U8> next;
+    while (w > 1 && h > 1)
+    {
+        w >>= 1;
+        h >>= 1;
+        next.resize(w * h * components);
+        LLImageBase::generateMip(prev.data(), next.data(), w, h, components);
+        prev.swap(next);
+    }
+}
+
+void mip_benchmark_image(const std::string &name, LLPointer<LLImageRaw> raw_image, LLImageDecodeThread &pool)
+{
+    const S32 RUNS = 5;
+    const S32 PARALLEL_CHAINS = 8;
+    std::cout << name << " (" << raw_image->getWidth() << "x" << raw_image->getHeight() << "x"
+              << (S32)raw_image->getComponents() << "), ms per chain:" << std::endl;
+
+    LLTimer timer;
+    for (S32 run = 0; run < RUNS; ++run)
+    {
+        box_mips(raw_image);
+    }
+    std::cout << "    8 bit box : " << timer.getElapsedTimeF64() * 1000.0 / RUNS << std::endl;
+
+    const char* filter_names[] = { "box", "kaiser", "lanczos" };
+    for (S32 filter = 0; filter < LLImageMipChain::FILTER_COUNT; ++filter)
+    {
+        LLImageMipChain::Params params;
+        params.mFilter = (LLImageMipChain::EFilter)filter;
+
+        timer.reset();
+        for (S32 run = 0; run < RUNS; ++run)
+        {
+            LLPointer<LLImageMipChain> mips = new LLImageMipChain();
+            mips->generate(raw_image, params);
+        }
+        F64 serial = timer.getElapsedTimeF64() / RUNS;
+
+        // Images aren't thread safe refcounted, give each request its own
+        std::vector<LLPointer<LLImageRaw> > copies;
+        for (S32 chain = 0; chain < PARALLEL_CHAINS; ++chain)
+        {
+            copies.push_back(new LLImageRaw(raw_image->getData(), raw_image->getWidth(), raw_image->getHeight(), raw_image->getComponents()));
+        }
+        std::atomic<S32> done(0);
+        timer.reset();
+        for (const LLPointer<LLImageRaw> &copy : copies)
+        {
+            pool.generateMips(copy, params, [&done](LLImageMipChain* mips, U32 request_id) { ++done; });
+        }
+        while (done < PARALLEL_CHAINS)
+        {
+            ms_sleep(1);
+        }
+        F64 parallel = timer.getElapsedTimeF64() / PARALLEL_CHAINS;
+
+        std::cout << "    " << filter_names[filter] << " : " << serial * 1000.0
+                  << ", on the decode pool : " << parallel * 1000.0 << std::endl;
+    }
+}
+
+void mip_benchmark(const std::list<std::string> &input_filenames)
+{
+    LLImageDecodeThread pool;
+    if (input_filenames.empty())
+    {
+        for (S32 size : { 1024, 2048 })
+        {
+            // Noise with a cut out alpha so that coverage is matched too
+            LLPointer<LLImageRaw> noise = new LLImageRaw(size, size, 4);
+            U8* data = noise->getData();
+            for (S32 i = 0; i < noise->getDataSize(); ++i)
+            {
+                data[i] = (U8)((i * 2654435761U) >> 24);
+            }
+            for (S32 i = 0; i < size * size; ++i)
+            {
+                data[i * 4 + 3] = data[i * 4 + 3] < 80 ? 255 : 0;
+            }
+            mip_benchmark_image("generated", noise, pool);
+        }
+    }
+
+    for (const std::string &file_name : input_filenames)
+    {
+        LLPointer<LLImageRaw> raw_image = load_image(file_name, -1, NULL, 0, false);
+        if (!raw_image)
+        {
+            std::cout << "Error: Image " << file_name << " could not be loaded" << std::endl;
+            continue;
+        }
+        mip_benchmark_image(file_name, raw_image, pool);
+    }
+    pool.shutdown();
+}
+
+// PSNR over the first channels of two RGBA buffers, in dB
+F64 rgba_psnr(const U8* a, const U8* b, S32 pixels, S32 channels)
+{
+    F64 error = 0.0;
+    for (S32 i = 0; i < pixels; ++i)
+    {
+        for (S32 c = 0; c < channels; ++c)
+        {
+            F64 d = (F64)a[i * 4 + c] - (F64)b[i * 4 + c];
+            error += d * d;
+        }
+    }
+    error /= (F64)pixels * channels;
+    return error > 0.0 ? 10.0 * log10(255.0 * 255.0 / error) : 99.99;
+}
+
+void bc_benchmark_image(const std::string &name, LLPointer<LLImageRaw> raw_image, LLImageDecodeThread &pool)
+{
+    const S32 PARALLEL_IMAGES = 8;
+    S32 width = raw_image->getWidth();
+    S32 height = raw_image->getHeight();
+    S32 components = raw_image->getComponents();
+    S32 pixels = width * height;
+    std::cout << name << " (" << width << "x" << height << "x" << components << "), ms and dB:" << std::endl;
+
+    // Reference as the encoder sees it: luminance spread to RGB, opaque
+    // when there is no alpha
+    std::vector<U8> reference(pixels * 4);
+    const U8* src = raw_image->getData();
+    for (S32 i = 0; i < pixels; ++i)
+    {
+        const U8* in = src + i * components;
+        U8* out = &reference[i * 4];
+        out[0] = in[0];
+        out[1] = in[components > 2 ? 1 : 0];
+        out[2] = in[components > 2 ? 2 : 0];
+        out[3] = (components == 2 || components == 4) ? in[components - 1] : 255;
+    }
+
+    const char* quality_names[] = { "fast", "normal", "high" };
+    std::vector<U8> decoded(pixels * 4);
+    for (S32 format = 0; format < LLImageBC::FORMAT_COUNT; ++format)
+    {
+        LLImageBC::EFormat bc_format = (LLImageBC::EFormat)format;
+        std::vector<U8> compressed(LLImageBC::levelBytes(bc_format, width, height));
+        for (S32 quality = 0; quality < LLImageBC::QUALITY_COUNT; ++quality)
+        {
+            LLTimer timer;
+            LLImageBC::compress(bc_format, (LLImageBC::EQuality)quality, src, width, height, components, compressed.data());
+            F64 encode_time = timer.getElapsedTimeF64();
+            LLImageBC::decompress(bc_format, compressed.data(), width, height, decoded.data());
+
+            F64 psnr = 0.0;
+            if (bc_format == LLImageBC::FORMAT_BC5)
+            {
+                // The first two channels as they are
+                std::vector<U8> channels(pixels * 4);
+                for (S32 i = 0; i < pixels; ++i)
+                {
+                    channels[i * 4] = src[i * components];
+                    channels[i * 4 + 1] = src[i * components + (components > 1 ? 1 : 0)];
+                }
+                psnr = rgba_psnr(channels.data(), decoded.data(), pixels, 2);
+            }
+            else if (bc_format == LLImageBC::FORMAT_BC1)
+            {
+                // Cut out texels have no color to compare
+                std::vector<U8> cutout(reference);
+                for (S32 i = 0; i < pixels; ++i)
+                {
+                    U8* texel = &cutout[i * 4];
+                    texel[3] = texel[3] < 128 ? 0 : 255;
+                    if (!texel[3])
+                    {
+                        texel[0] = texel[1] = texel[2] = 0;
+                    }
+                }
+                psnr = rgba_psnr(cutout.data(), decoded.data(), pixels, 4);
+            }
+            else
+            {
+                psnr = rgba_psnr(reference.data(), decoded.data(), pixels, 4);
+            }
+
+            std::cout << "    " << LLImageBC::getFormatName(bc_format) << " " << quality_names[quality]
+                      << " : " << encode_time * 1000.0 << " ms, " << psnr << " dB" << std::endl;
+        }
+    }
+
+    // Whole chains the way the texture pipeline would ask for them, which
+    // needs power of two sizes
+    std::vector<LLPointer<LLImageRaw> > copies;
+    for (S32 image = 0; image < PARALLEL_IMAGES; ++image)
+    {
+        LLPointer<LLImageRaw> copy = new LLImageRaw(raw_image->getData(), width, height, components);
+        copy->biasedScaleToPowerOfTwo();
+        copies.push_back(copy);
+    }
+    const LLImageDXT::EFileFormat chain_formats[] = {
+        LLImageDXT::FORMAT_DXR1, LLImageDXT::FORMAT_DXR5, LLImageDXT::FORMAT_BC5R, LLImageDXT::FORMAT_BC7R
+    };
+    for (S32 format = 0; format < LLImageBC::FORMAT_COUNT; ++format)
+    {
+        std::atomic<S32> done(0);
+        std::atomic<S32> failed(0);
+        LLTimer timer;
+        for (const LLPointer<LLImageRaw> &copy : copies)
+        {
+            pool.compressImage(copy, chain_formats[format], LLImageBC::QUALITY_NORMAL,
+                               [&done, &failed](LLImageDXT* compressed, U32 request_id)
+                               {
+                                   failed += !compressed;
+                                   ++done;
+                               });
+        }
+        while (done < PARALLEL_IMAGES)
+        {
+            ms_sleep(1);
+        }
+        F64 parallel = timer.getElapsedTimeF64() / PARALLEL_IMAGES;
+        std::cout << "    " << LLImageBC::getFormatName((LLImageBC::EFormat)format) << " mip chain of "
+                  << copies[0]->getWidth() << "x" << copies[0]->getHeight() << " on the decode pool : "
+                  << parallel * 1000.0 << " ms";
+        if (failed)
+        {
+            std::cout << " (" << (S32)failed << " failed)";
+        }
+        std::cout << std::endl;
+    }
+}
+
+void bc_benchmark(const std::list<std::string> &input_filenames)
+{
+    LLImageDecodeThread pool;
+    if (input_filenames.empty())
+    {
+        // Gradients with some noise, closer to real textures than plain
+        // noise, which no block format can hold
+        const S32 size = 1024;
+        LLPointer<LLImageRaw> texture = new LLImageRaw(size, size, 4);
+        U8* data = texture->getData();
+        for (S32 y = 0; y < size; ++y)
+        {
+            for (S32 x = 0; x < size; ++x)
+            {
+                U8* texel = data + (y * size + x) * 4;
+                U8 noise = (U8)((((y * size + x) * 2654435761U) >> 24) & 15);
+                texel[0] = (U8)llmin(255, x / 4 + noise);
+                texel[1] = (U8)llmin(255, y / 4 + noise);
+                texel[2] = (U8)(((x ^ y) >> 3) & 0xff);
+                texel[3] = (U8)(255 - ((x + y) >> 3));
+            }
+        }
+        bc_benchmark_image("generated", texture, pool);
+    }
+
+    for (const std::string &file_name : input_filenames)
+    {
+        LLPointer<LLImageRaw> raw_image = load_image(file_name, -1, NULL, 0, false);
+        if (!raw_image)
+        {
+            std::cout << "Error: Image " << file_name << " could not be loaded" << std::endl;
+            continue;
+        }
+        bc_benchmark_image(file_name, raw_image, pool);
+    }
+    pool.shutdown();
+}
+
 // Save a raw image instance into a file
 bool save_image(const std::string &dest_filename, LLPointer<LLImageRaw> raw_image, int blocks_size, int precincts_size, int levels, bool reversible, bool output_stats)
 {
@@ -349,6 +842,11 @@ int main(int argc, char** argv)
     // Other optional parsed arguments
     bool analyze_performance = false;
     bool image_stats = false;
+    bool refine = false;
+    bool kernels = false;
+    bool mips = false;
+    bool bc = false;
+    int decode_threads = 1;
     int* region = NULL;
     int discard_level = -1;
     int load_size = 0;
@@ -557,6 +1055,59 @@ int main(int argc, char** argv)
         {
             image_stats = true;
         }
+        else if (!strcmp(argv[arg], "--refine_benchmark") || !strcmp(argv[arg], "-refine"))
+        {
+            refine = true;
+        }
+        else if (!strcmp(argv[arg], "--kernel_benchmark") || !strcmp(argv[arg], "-kernels"))
+        {
+            kernels = true;
+        }
+        else if (!strcmp(argv[arg], "--mip_benchmark") || !strcmp(argv[arg], "-mips"))
+        {
+            mips = true;
+        }
+        else if (!strcmp(argv[arg], "--bc_benchmark") || !strcmp(argv[arg], "-bc"))
+        {
+            bc = true;
+        }
+        else if (!strcmp(argv[arg], "--decode_threads") || !strcmp(argv[arg], "-threads"))
+        {
+            std::string value_str;
+            if ((arg + 1) < argc)
+            {
+                value_str = argv[arg+1];
+            }
+            if (((arg + 1) >= argc) || (value_str[0] == '-'))
+            {
+                std::cout << "No valid --decode_threads argument given, decode_threads ignored" << std::endl;
+            }
+            else
+            {
+                decode_threads = atoi(value_str.c_str());
+            }
+        }
+    }
+
+    if (kernels)
+    {
+        kernel_benchmark(input_filenames);
+        SUBSYSTEM_CLEANUP(LLImage);
+        return 0;
+    }
+
+    if (mips)
+    {
+        mip_benchmark(input_filenames);
+        SUBSYSTEM_CLEANUP(LLImage);
+        return 0;
+    }
+
+    if (bc)
+    {
+        bc_benchmark(input_filenames);
+        SUBSYSTEM_CLEANUP(LLImage);
+        return 0;
     }
 
     // Check arguments consistency. Exit with proper message if inconsistent.
@@ -572,6 +1123,15 @@ int main(int argc, char** argv)
     }
 
 
+    LLImageJ2C::setDecodeThreading(decode_threads, 1024 * 1024);
+
+    if (refine)
+    {
+        refine_benchmark(input_filenames);
+        SUBSYSTEM_CLEANUP(LLImage);
+        return 0;
+    }
+
     // Create the logging thread if required
     if (LLFastTimer::sMetricLog)
     {
@@ -0,0 +1,420 @@
+/**
+ * @file llmeshopt_libtest.cpp
+ * @brief Imports .dae and .gltf models and generates their LODs with LLMeshLODGenerator
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+#include "linden_common.h"
+#include "llpointer.h"
+#include "lltimer.h"
+
+// Linden library includes
+#include "llapr.h"
+#include "lldaeloader.h"
+#include "llgltfloader.h"
+#include "llmeshlodgenerator.h"
+#include "llmodel.h"
+#include "llmodelloader.h"
+
+// system libraries
+#include <iostream>
+#include <memory>
+
+// doc string provided when invoking the program with --help
+static const char USAGE[] = "\n"
+"usage:\tllmeshopt_libtest [options]\n"
+"\n"
+" -h, --help\n"
+"        Print this help\n"
+" -i, --input <file1 .. file2>\n"
+"        List of .dae, .gltf or .glb models to generate LODs for. All models of all files\n"
+"        are simplified as one batch, like the models of one upload.\n"
+" -threads, --threads <n>\n"
+"        Width of the MeshLOD thread pool, the calling thread works too.\n"
+"        Default is the number of cores minus one.\n"
+" -compare, --compare\n"
+"        Also import the models and generate every LOD on the calling thread only,\n"
+"        report the speedups and check that both imports gave the same models.\n"
+" -import, --import_only\n"
+"        Only import the models, don't generate LODs.\n"
+" -importthreads, --import_threads <n>\n"
+"        Width of the ModelImport thread pool meshes and skins are converted on, the\n"
+"        loader thread works too. Default is the number of cores minus one.\n"
+" -d, --decimation <f>\n"
+"        Each LOD keeps 1/<f> of the triangles of the one above. Default is 3.\n"
+" -e, --error <f>\n"
+"        Largest deviation allowed, relative to the face size. Default is 1 (no limit).\n"
+" -nw, --normal_weight <f>\n"
+"        Weight of normals in the simplification error, 0 ignores them. Default is 0.5.\n"
+" -uvw, --uv_weight <f>\n"
+"        Weight of texture coordinates in the simplification error, 0 ignores them.\n"
+"        Default is 1.\n"
+" -lock, --lock_border\n"
+"        Keep the open edges of each face in place.\n"
+" -nosloppy, --no_sloppy\n"
+"        Never fall back to sloppy simplification.\n"
+" -nooverdraw, --no_overdraw\n"
+"        Only optimize the generated faces for the vertex cache.\n"
+" -meshlets, --meshlets\n"
+"        Count the meshlets of 64 vertices and 124 triangles each LOD splits into.\n"
+"\n";
+
+static const char* LOD_NAMES[] = { "lowest", "low", "medium", "high" };
+static const char* METHOD_NAMES[] = { "copied", "attributes", "positions", "sloppy", "empty" };
+
+namespace
+{
+    // The loaders run here synchronously, no callback is ever needed
+    void no_load_callback(LLModelLoader::scene&, LLModelLoader::model_list&, S32, void*) {}
+    LLJoint* no_joint_lookup(const std::string&, void*) { return NULL; }
+    U32 no_texture_load(LLImportMaterial&, void*) { return 0; }
+    void no_state_callback(U32, void*) {}
+}
+
+// Loads every model of filename into models, returns false on failure.
+// Adds the time spent parsing and converting the file to seconds.
+bool load_models(const std::string& filename, LLModelLoader::model_list& models, U32 import_threads, F64& seconds)
+{
+    JointTransformMap joint_transforms;
+    JointNameSet joints_from_nodes;
+    JointMap joint_aliases;
+
+    std::string extension = filename.substr(filename.rfind('.') + 1);
+    LLStringUtil::toLower(extension);
+
+    std::unique_ptr<LLModelLoader> loader;
+    if (extension == "dae")
+    {
+        loader.reset(new LLDAELoader(filename, LLModel::LOD_HIGH,
+            no_load_callback, no_joint_lookup, no_texture_load, no_state_callback, NULL,
+            joint_transforms, joints_from_nodes, joint_aliases, 110, U32_MAX, false));
+    }
+    else if (extension == "gltf" || extension == "glb")
+    {
+        loader.reset(new LLGLTFLoader(filename, LLModel::LOD_HIGH,
+            no_load_callback, no_joint_lookup, no_texture_load, no_state_callback, NULL,
+            joint_transforms, joints_from_nodes, joint_aliases, 110, U32_MAX));
+    }
+    else
+    {
+        std::cout << "Unknown model type: " << filename << std::endl;
+        return false;
+    }
+
+    loader->setImportThreads(import_threads);
+
+    LLTimer timer;
+    bool loaded = loader->OpenFile(filename);
+    seconds += timer.getElapsedTimeF64();
+
+    if (!loaded || loader->mModelList.empty())
+    {
+        std::cout << "Failed to load models from " << filename << std::endl;
+        return false;
+    }
+
+    for (LLPointer<LLModel>& model : loader->mModelList)
+    {
+        if (model->getNumVolumeFaces() > 0)
+        {
+            models.push_back(model);
+        }
+    }
+    return true;
+}
+
+// Loads every input file, returns the number of seconds it took
+F64 import_models(const std::vector<std::string>& filenames, LLModelLoader::model_list& models, U32 import_threads)
+{
+    F64 seconds = 0.0;
+    for (const std::string& filename : filenames)
+    {
+        load_models(filename, models, import_threads, seconds);
+    }
+
+    U32 triangles = 0;
+    for (LLPointer<LLModel>& model : models)
+    {
+        for (S32 face = 0; face < model->getNumVolumeFaces(); ++face)
+        {
+            triangles += model->getVolumeFace(face).mNumIndices / 3;
+        }
+    }
+    std::cout << "Import: " << models.size() << " models, " << triangles << " triangles in "
+              << seconds << "s on " << (import_threads + 1) << " threads" << std::endl;
+    return seconds;
+}
+
+bool same_face(const LLVolumeFace& a, const LLVolumeFace& b)
+{
+    if (a.mNumVertices != b.mNumVertices || a.mNumIndices != b.mNumIndices)
+    {
+        return false;
+    }
+    if (memcmp(a.mIndices, b.mIndices, a.mNumIndices * sizeof(U16)) ||
+        memcmp(a.mPositions, b.mPositions, a.mNumVertices * sizeof(LLVector4a)))
+    {
+        return false;
+    }
+    if ((a.mNormals == NULL) != (b.mNormals == NULL) ||
+        (a.mNormals && memcmp(a.mNormals, b.mNormals, a.mNumVertices * sizeof(LLVector4a))))
+    {
+        return false;
+    }
+    if ((a.mTexCoords == NULL) != (b.mTexCoords == NULL) ||
+        (a.mTexCoords && memcmp(a.mTexCoords, b.mTexCoords, a.mNumVertices * sizeof(LLVector2))))
+    {
+        return false;
+    }
+    return true;
+}
+
+// True when both imports gave the same models in the same order
+bool same_models(const LLModelLoader::model_list& a, const LLModelLoader::model_list& b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (a[i]->mLabel != b[i]->mLabel ||
+            a[i]->mMaterialList != b[i]->mMaterialList ||
+            a[i]->getNumVolumeFaces() != b[i]->getNumVolumeFaces() ||
+            a[i]->mSkinWeights.size() != b[i]->mSkinWeights.size())
+        {
+            return false;
+        }
+        for (S32 face = 0; face < a[i]->getNumVolumeFaces(); ++face)
+        {
+            if (!same_face(a[i]->getVolumeFace(face), b[i]->getVolumeFace(face)))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void report(const std::string& name, const LLMeshLODGenerator& generator, bool meshlets)
+{
+    std::cout << name << ": " << generator.getNumModels() << " models in "
+              << generator.getSeconds() << "s on " << generator.getNumThreads() << " threads" << std::endl;
+
+    for (S32 lod = LLMeshLODGenerator::LOD_HIGH; lod >= 0; --lod)
+    {
+        if (lod != LLMeshLODGenerator::LOD_HIGH && !generator.hasLOD(lod))
+        {
+            continue;
+        }
+        std::cout << "    " << LOD_NAMES[lod] << ": " << generator.getNumTriangles(lod) << " triangles";
+        if (lod != LLMeshLODGenerator::LOD_HIGH)
+        {
+            if (meshlets)
+            {
+                std::cout << ", " << generator.getNumMeshlets(lod) << " meshlets";
+            }
+            for (S32 method = LLMeshLODGenerator::METHOD_COPY; method <= LLMeshLODGenerator::METHOD_EMPTY; ++method)
+            {
+                U32 faces = generator.getNumFaces(lod, (LLMeshLODGenerator::EMethod)method);
+                if (faces)
+                {
+                    std::cout << ", " << faces << " " << METHOD_NAMES[method];
+                }
+            }
+        }
+        std::cout << std::endl;
+    }
+}
+
+// Reads the float after option arg, returns false and warns if there is none
+bool get_float_arg(int argc, char** argv, int& arg, F32& value)
+{
+    if ((arg + 1) >= argc || argv[arg + 1][0] == '-')
+    {
+        std::cout << "No valid " << argv[arg] << " argument given, default used" << std::endl;
+        return false;
+    }
+    value = (F32)atof(argv[++arg]);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> input_filenames;
+    LLMeshLODGenerator::Settings settings;
+    U32 threads = LLMeshLODGenerator::getDefaultThreads();
+    U32 import_threads = LLModelLoader::getDefaultImportThreads();
+    bool compare = false;
+    bool import_only = false;
+
+    // Init whatever is necessary
+    ll_init_apr();
+
+    // Analyze command line arguments
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        if (!strcmp(argv[arg], "--help") || !strcmp(argv[arg], "-h"))
+        {
+            // Send the usage to standard out
+            std::cout << USAGE << std::endl;
+            return 0;
+        }
+        else if ((!strcmp(argv[arg], "--input") || !strcmp(argv[arg], "-i")) && arg < argc-1)
+        {
+            // if arg starts with '-', we consider it's not a file name but some other argument
+            while ((arg + 1) < argc && argv[arg + 1][0] != '-')
+            {
+                input_filenames.push_back(argv[++arg]);
+            }
+        }
+        else if (!strcmp(argv[arg], "--threads") || !strcmp(argv[arg], "-threads"))
+        {
+            F32 value = 0.f;
+            if (get_float_arg(argc, argv, arg, value))
+            {
+                threads = (U32)llmax(value, 0.f);
+            }
+        }
+        else if (!strcmp(argv[arg], "--compare") || !strcmp(argv[arg], "-compare"))
+        {
+            compare = true;
+        }
+        else if (!strcmp(argv[arg], "--import_only") || !strcmp(argv[arg], "-import"))
+        {
+            import_only = true;
+        }
+        else if (!strcmp(argv[arg], "--import_threads") || !strcmp(argv[arg], "-importthreads"))
+        {
+            F32 value = 0.f;
+            if (get_float_arg(argc, argv, arg, value))
+            {
+                import_threads = (U32)llmax(value, 0.f);
+            }
+        }
+        else if (!strcmp(argv[arg], "--decimation") || !strcmp(argv[arg], "-d"))
+        {
+            F32 value = 0.f;
+            if (get_float_arg(argc, argv, arg, value))
+            {
+                settings.setDecimation(value);
+            }
+        }
+        else if (!strcmp(argv[arg], "--error") || !strcmp(argv[arg], "-e"))
+        {
+            get_float_arg(argc, argv, arg, settings.mTargetError);
+        }
+        else if (!strcmp(argv[arg], "--normal_weight") || !strcmp(argv[arg], "-nw"))
+        {
+            get_float_arg(argc, argv, arg, settings.mNormalWeight);
+        }
+        else if (!strcmp(argv[arg], "--uv_weight") || !strcmp(argv[arg], "-uvw"))
+        {
+            get_float_arg(argc, argv, arg, settings.mUVWeight);
+        }
+        else if (!strcmp(argv[arg], "--lock_border") || !strcmp(argv[arg], "-lock"))
+        {
+            settings.mLockBorder = true;
+        }
+        else if (!strcmp(argv[arg], "--no_sloppy") || !strcmp(argv[arg], "-nosloppy"))
+        {
+            settings.mAllowSloppy = false;
+        }
+        else if (!strcmp(argv[arg], "--no_overdraw") || !strcmp(argv[arg], "-nooverdraw"))
+        {
+            settings.mOptimizeOverdraw = false;
+        }
+        else if (!strcmp(argv[arg], "--meshlets") || !strcmp(argv[arg], "-meshlets"))
+        {
+            settings.mBuildMeshlets = true;
+        }
+    }
+
+    if (input_filenames.empty())
+    {
+        std::cout << "No input file, nothing to do -> exit" << std::endl;
+        return 0;
+    }
+
+    LLModelLoader::model_list models;
+    F64 imported = import_models(input_filenames, models, import_threads);
+    if (models.empty())
+    {
+        std::cout << "No models loaded -> exit" << std::endl;
+        return 1;
+    }
+
+    if (compare)
+    {
+        LLModelLoader::model_list serial_models;
+        F64 serial = import_models(input_filenames, serial_models, 0);
+        if (imported > 0.0)
+        {
+            std::cout << "Import speedup: " << serial / imported << "x" << std::endl;
+        }
+        if (!same_models(models, serial_models))
+        {
+            std::cout << "Imports differ between the pool and the loader thread" << std::endl;
+            return 1;
+        }
+    }
+
+    if (import_only)
+    {
+        models.clear();
+        ll_cleanup_apr();
+        return 0;
+    }
+
+    // One generator at a time, they share the "MeshLOD" pool name
+    F64 pooled = 0.0;
+    {
+        LLMeshLODGenerator generator(settings, threads);
+        for (LLPointer<LLModel>& model : models)
+        {
+            generator.addModel(model);
+        }
+        generator.generate();
+        pooled = generator.getSeconds();
+        report("Pool", generator, settings.mBuildMeshlets);
+    }
+
+    if (compare)
+    {
+        LLMeshLODGenerator serial(settings, 0);
+        for (LLPointer<LLModel>& model : models)
+        {
+            serial.addModel(model);
+        }
+        serial.generate();
+        report("Calling thread", serial, settings.mBuildMeshlets);
+
+        if (pooled > 0.0)
+        {
+            std::cout << "Speedup: " << serial.getSeconds() / pooled << "x" << std::endl;
+        }
+    }
+
+    models.clear();
+    ll_cleanup_apr();
+    return 0;
+}
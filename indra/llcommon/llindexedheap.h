@@ -0,0 +1,213 @@
+/**
+ * @file llindexedheap.h
+ * @brief Binary max heap whose entries can be reprioritized or removed
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLINDEXEDHEAP_H
+#define LL_LLINDEXEDHEAP_H
+
+#include "llerror.h"
+
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include <utility>
+#include <vector>
+
+//--------------------------------------------------------
+// LLIndexedHeap
+//
+// Priority queue of unique keys, highest priority on top. Unlike
+// std::priority_queue a key that is already queued can have its priority
+// changed, or be removed, in O(log n), so it suits work lists fed by
+// change events: push the key again whenever something about it changes
+// and pop the most urgent ones each frame.
+//--------------------------------------------------------
+
+template <typename Key, typename Priority = F32, typename Hash = boost::hash<Key> >
+class LLIndexedHeap
+{
+public:
+    typedef typename std::vector<std::pair<Key, Priority> >::size_type size_type;
+
+    bool empty() const { return mHeap.empty(); }
+    size_type size() const { return mHeap.size(); }
+    void clear() { mHeap.clear(); mIndex.clear(); }
+    void reserve(size_type count) { mHeap.reserve(count); mIndex.reserve(count); }
+
+    bool contains(const Key& key) const { return mIndex.find(key) != mIndex.end(); }
+
+    // Queues key, or moves it to priority if it is already queued
+    void set(const Key& key, Priority priority)
+    {
+        typename index_map_t::iterator iter = mIndex.find(key);
+        if (iter == mIndex.end())
+        {
+            mIndex.emplace(key, mHeap.size());
+            mHeap.emplace_back(key, priority);
+            siftUp(mHeap.size() - 1);
+        }
+        else
+        {
+            size_type pos = iter->second;
+            Priority old = mHeap[pos].second;
+            mHeap[pos].second = priority;
+            if (old < priority)
+            {
+                siftUp(pos);
+            }
+            else
+            {
+                siftDown(pos);
+            }
+        }
+    }
+
+    // Queues key, or raises its priority if it is already queued lower.
+    // Several events for the same key before it is popped keep the most
+    // urgent one.
+    void raise(const Key& key, Priority priority)
+    {
+        typename index_map_t::iterator iter = mIndex.find(key);
+        if (iter == mIndex.end() || mHeap[iter->second].second < priority)
+        {
+            set(key, priority);
+        }
+    }
+
+    // Returns false if key wasn't queued
+    bool erase(const Key& key)
+    {
+        typename index_map_t::iterator iter = mIndex.find(key);
+        if (iter == mIndex.end())
+        {
+            return false;
+        }
+        size_type pos = iter->second;
+        mIndex.erase(iter);
+        removeAt(pos);
+        return true;
+    }
+
+    const Key& top() const
+    {
+        llassert(!mHeap.empty());
+        return mHeap.front().first;
+    }
+
+    Priority topPriority() const
+    {
+        llassert(!mHeap.empty());
+        return mHeap.front().second;
+    }
+
+    Key pop()
+    {
+        llassert(!mHeap.empty());
+        Key key = mHeap.front().first;
+        mIndex.erase(key);
+        removeAt(0);
+        return key;
+    }
+
+private:
+    // Moves the last entry into the hole at pos, whose key is already out
+    // of the index
+    void removeAt(size_type pos)
+    {
+        size_type last = mHeap.size() - 1;
+        if (pos != last)
+        {
+            Priority old = mHeap[pos].second;
+            mHeap[pos] = std::move(mHeap[last]);
+            mIndex[mHeap[pos].first] = pos;
+            mHeap.pop_back();
+            if (old < mHeap[pos].second)
+            {
+                siftUp(pos);
+            }
+            else
+            {
+                siftDown(pos);
+            }
+        }
+        else
+        {
+            mHeap.pop_back();
+        }
+    }
+
+    void siftUp(size_type pos)
+    {
+        std::pair<Key, Priority> entry = std::move(mHeap[pos]);
+        while (pos > 0)
+        {
+            size_type parent = (pos - 1) / 2;
+            if (!(mHeap[parent].second < entry.second))
+            {
+                break;
+            }
+            place(pos, std::move(mHeap[parent]));
+            pos = parent;
+        }
+        place(pos, std::move(entry));
+    }
+
+    void siftDown(size_type pos)
+    {
+        size_type count = mHeap.size();
+        std::pair<Key, Priority> entry = std::move(mHeap[pos]);
+        while (true)
+        {
+            size_type child = pos * 2 + 1;
+            if (child >= count)
+            {
+                break;
+            }
+            if (child + 1 < count && mHeap[child].second < mHeap[child + 1].second)
+            {
+                ++child;
+            }
+            if (!(entry.second < mHeap[child].second))
+            {
+                break;
+            }
+            place(pos, std::move(mHeap[child]));
+            pos = child;
+        }
+        place(pos, std::move(entry));
+    }
+
+    void place(size_type pos, std::pair<Key, Priority>&& entry)
+    {
+        mIndex[entry.first] = pos;
+        mHeap[pos] = std::move(entry);
+    }
+
+private:
+    typedef boost::unordered_flat_map<Key, size_type, Hash> index_map_t;
+    std::vector<std::pair<Key, Priority> > mHeap;
+    index_map_t mIndex;
+};
+
+#endif // LL_LLINDEXEDHEAP_H
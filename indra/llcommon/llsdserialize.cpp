@@ -2354,6 +2354,77 @@ LLUZipHelper::EZipRresult LLUZipHelper::unzip_llsd(LLSD& data, const U8* in, S32
     free(result);
     return ZR_OK;
 }
+
+LLUZipHelper::EZipRresult LLUZipHelper::unzip(std::vector<U8>& out, const U8* in, S32 size)
+{
+    out.clear();
+
+    z_stream strm;
+    strm.zalloc = Z_NULL;
+    strm.zfree = Z_NULL;
+    strm.opaque = Z_NULL;
+    strm.avail_in = size;
+    strm.next_in = const_cast<U8*>(in);
+
+    if (inflateInit2(&strm, MAX_WBITS) != Z_OK)
+    {
+        return ZR_MEM_ERROR;
+    }
+
+    // Inflate straight into out, which starts at a guess of the inflated
+    // size and doubles as needed
+    size_t cur_size = 0;
+    S32 ret = Z_OK;
+    try
+    {
+        out.resize(llmax((size_t)size * 4, (size_t)4096));
+        do
+        {
+            if (cur_size == out.size())
+            {
+                out.resize(out.size() * 2);
+            }
+            strm.avail_out = (uInt)(out.size() - cur_size);
+            strm.next_out = out.data() + cur_size;
+            ret = inflate(&strm, Z_NO_FLUSH);
+            switch (ret)
+            {
+            case Z_NEED_DICT:
+            case Z_DATA_ERROR:
+                inflateEnd(&strm);
+                out.clear();
+                return ZR_DATA_ERROR;
+            case Z_STREAM_ERROR:
+                inflateEnd(&strm);
+                out.clear();
+                return ZR_BUFFER_ERROR;
+            case Z_MEM_ERROR:
+                inflateEnd(&strm);
+                out.clear();
+                return ZR_MEM_ERROR;
+            }
+            cur_size = out.size() - strm.avail_out;
+        } while (strm.avail_out == 0 && ret != Z_STREAM_END);
+    }
+    catch (const std::bad_alloc&)
+    {
+        inflateEnd(&strm);
+        out.clear();
+        return ZR_MEM_ERROR;
+    }
+
+    inflateEnd(&strm);
+
+    if (ret != Z_STREAM_END)
+    {
+        out.clear();
+        return ZR_DATA_ERROR;
+    }
+
+    out.resize(cur_size);
+    return ZR_OK;
+}
+
 //This unzip function will only work with a gzip header and trailer - while the contents
 //of the actual compressed data is the same for either format (gzip vs zlib ), the headers
 //and trailers are different for the formats.
@@ -865,6 +865,9 @@ class LL_COMMON_API LLUZipHelper : public LLRefCount
     // return OK or reason for failure
     static EZipRresult unzip_llsd(LLSD& data, std::istream& is, S32 size);
     static EZipRresult unzip_llsd(LLSD& data, const U8* in, S32 size);
+    // Inflate without parsing, for callers that read the binary LLSD
+    // themselves. out holds exactly the inflated bytes on success.
+    static EZipRresult unzip(std::vector<U8>& out, const U8* in, S32 size);
 };
 
 //dirty little zip functions -- yell at davep
@@ -0,0 +1,185 @@
+/**
+ * @file   llindexedheap_test.cpp
+ * @brief  Test for llindexedheap.h
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+// Precompiled header
+#include "linden_common.h"
+// associated header
+#include "llindexedheap.h"
+// std headers
+#include <algorithm>
+#include <chrono>
+// other Linden headers
+#include "../test/lltut.h"
+
+namespace tut
+{
+    struct indexedheap_data
+    {
+        U32 mSeed = 1234;
+        U32 random(U32 range)
+        {
+            mSeed = mSeed * 1103515245 + 12345;
+            return (mSeed >> 8) % range;
+        }
+    };
+    typedef test_group<indexedheap_data> indexedheap_group;
+    typedef indexedheap_group::object object;
+    indexedheap_group indexedheap("LLIndexedHeap");
+
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("pops in priority order");
+
+        LLIndexedHeap<S32> heap;
+        std::vector<F32> priorities;
+        for (S32 i = 0; i < 500; ++i)
+        {
+            priorities.push_back((F32)random(1000));
+            heap.set(i, priorities.back());
+        }
+        ensure_equals("size", heap.size(), (size_t)500);
+
+        F32 last = 1e9f;
+        std::vector<bool> seen(500, false);
+        while (!heap.empty())
+        {
+            F32 top = heap.topPriority();
+            S32 key = heap.pop();
+            ensure("descending", top <= last);
+            ensure_equals("priority kept with key", top, priorities[key]);
+            ensure("popped once", !seen[key]);
+            seen[key] = true;
+            last = top;
+        }
+        ensure("all popped", std::find(seen.begin(), seen.end(), false) == seen.end());
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("reprioritize and erase");
+
+        LLIndexedHeap<S32> heap;
+        for (S32 i = 0; i < 10; ++i)
+        {
+            heap.set(i, (F32)i);
+        }
+        heap.set(2, 100.f);
+        ensure_equals("raised to top", heap.top(), 2);
+        heap.set(2, -1.f);
+        ensure_equals("lowered", heap.top(), 9);
+        heap.raise(9, 1.f);
+        ensure_equals("raise doesn't lower", heap.topPriority(), 9.f);
+        heap.raise(3, 50.f);
+        ensure_equals("raise raises", heap.top(), 3);
+        heap.set(11, 5.5f);
+        ensure_equals("queued once", heap.size(), (size_t)11);
+
+        ensure("erase queued", heap.erase(3));
+        ensure("erase missing", !heap.erase(3));
+        ensure("gone", !heap.contains(3));
+        ensure("others kept", heap.contains(11));
+
+        std::vector<S32> order;
+        while (!heap.empty())
+        {
+            order.push_back(heap.pop());
+        }
+        const S32 expected[] = { 9, 8, 7, 6, 11, 5, 4, 1, 0, 2 };
+        ensure_equals("count", order.size(), (size_t)10);
+        for (S32 i = 0; i < 10; ++i)
+        {
+            ensure_equals("order", order[i], expected[i]);
+        }
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("synthetic texture population");
+
+        // A scene's worth of textures whose on-screen size changes a few at
+        // a time, like the texture list sees while moving around. Each
+        // frame the changed ones are pushed and a bounded number of the
+        // largest are handled, instead of rescanning the whole list.
+        const S32 TEXTURES = 20000;
+        const S32 FRAMES = 300;
+        const S32 CHANGES_PER_FRAME = TEXTURES / 100;
+        const S32 UPDATES_PER_FRAME = 64;
+
+        std::vector<F32> vsize(TEXTURES);
+        for (S32 i = 0; i < TEXTURES; ++i)
+        {
+            vsize[i] = (F32)random(1024 * 1024);
+        }
+
+        LLIndexedHeap<S32> heap;
+        heap.reserve(TEXTURES);
+        auto start = std::chrono::steady_clock::now();
+        S32 handled = 0;
+        for (S32 frame = 0; frame < FRAMES; ++frame)
+        {
+            for (S32 i = 0; i < CHANGES_PER_FRAME; ++i)
+            {
+                S32 tex = random(TEXTURES);
+                vsize[tex] = (F32)random(1024 * 1024);
+                heap.raise(tex, vsize[tex]);
+            }
+            F32 last = 1e12f;
+            for (S32 i = 0; i < UPDATES_PER_FRAME && !heap.empty(); ++i)
+            {
+                F32 top = heap.topPriority();
+                ensure("largest first", top <= last);
+                last = top;
+                heap.pop();
+                ++handled;
+            }
+            ensure("bounded backlog", heap.size() <= (size_t)TEXTURES);
+        }
+        auto heap_time = std::chrono::steady_clock::now() - start;
+
+        // What a full rescan costs for the same frames: find the same
+        // number of largest textures by sorting everything
+        start = std::chrono::steady_clock::now();
+        std::vector<std::pair<F32, S32> > scan(TEXTURES);
+        for (S32 frame = 0; frame < FRAMES; ++frame)
+        {
+            for (S32 i = 0; i < TEXTURES; ++i)
+            {
+                scan[i] = std::make_pair(vsize[i], i);
+            }
+            std::partial_sort(scan.begin(), scan.begin() + UPDATES_PER_FRAME, scan.end(),
+                              [](const std::pair<F32, S32>& a, const std::pair<F32, S32>& b) { return a.first > b.first; });
+        }
+        auto scan_time = std::chrono::steady_clock::now() - start;
+
+        ensure_equals("handled", handled, FRAMES * UPDATES_PER_FRAME);
+        LL_INFOS() << TEXTURES << " textures, " << FRAMES << " frames: heap "
+                   << std::chrono::duration_cast<std::chrono::microseconds>(heap_time).count() << " us, rescan "
+                   << std::chrono::duration_cast<std::chrono::microseconds>(scan_time).count() << " us" << LL_ENDL;
+    }
+}
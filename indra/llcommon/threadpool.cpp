@@ -25,6 +25,11 @@
 
 #include <boost/fiber/algo/round_robin.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 /*****************************************************************************
 *   Custom fiber scheduler for worker threads
 *****************************************************************************/
@@ -130,6 +135,63 @@ void LL::ThreadPoolBase::close()
     }
 }
 
+void LL::ThreadPoolBase::runJobs(size_t count, const std::function<void(size_t)>& job,
+                                  size_t max_threads)
+{
+    if (!count)
+    {
+        return;
+    }
+
+    // Shared with the posted tasks: one that only starts after runJobs()
+    // has returned finds no job left and touches nothing else
+    struct Jobs
+    {
+        const std::function<void(size_t)>* mJob;
+        size_t mCount;
+        std::atomic<size_t> mNext{ 0 };
+        size_t mDone{ 0 };
+        std::mutex mMutex;
+        std::condition_variable mAllDone;
+
+        void work()
+        {
+            size_t done = 0;
+            for (size_t i = mNext++; i < mCount; i = mNext++)
+            {
+                (*mJob)(i);
+                ++done;
+            }
+            if (done)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mDone += done;
+                if (mDone == mCount)
+                {
+                    mAllDone.notify_all();
+                }
+            }
+        }
+    };
+    auto jobs = std::make_shared<Jobs>();
+    jobs->mJob = &job;
+    jobs->mCount = count;
+
+    // The caller takes one share, a pool thread each of the others
+    size_t threads = std::min({ getWidth(), max_threads, count - 1 });
+    for (size_t i = 0; i < threads; ++i)
+    {
+        if (!mQueue->post([jobs]() { jobs->work(); }))
+        {
+            break;
+        }
+    }
+    jobs->work();
+
+    std::unique_lock<std::mutex> lock(jobs->mMutex);
+    jobs->mAllDone.wait(lock, [&jobs]() { return jobs->mDone == jobs->mCount; });
+}
+
 void LL::ThreadPoolBase::run(const std::string& name)
 {
 #if LL_WINDOWS
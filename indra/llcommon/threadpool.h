@@ -15,6 +15,8 @@
 
 #include "threadpool_fwd.h"
 #include "workqueue.h"
+#include <functional>
+#include <limits>
 #include <memory>                   // std::unique_ptr
 #include <string>
 #include <thread>
@@ -60,6 +62,17 @@ namespace LL
         std::string getName() const { return mName; }
         size_t getWidth() const { return mThreads.size(); }
 
+        /**
+         * Call job(0) to job(count - 1) on up to max_threads of this pool's
+         * threads and on the calling thread, which takes whatever jobs are
+         * left. Returns once every job has run. The caller never waits on a
+         * worker that hasn't started yet, so other work queued on the pool,
+         * a closed pool, or a call from one of the pool's own threads only
+         * leaves more of the jobs to the caller.
+         */
+        void runJobs(size_t count, const std::function<void(size_t)>& job,
+                     size_t max_threads = std::numeric_limits<size_t>::max());
+
         /**
          * Override run() if you need special processing. The default run()
          * implementation simply calls WorkQueue::runUntilClose().
@@ -153,9 +153,14 @@ const int HTTP_CONNECTION_LIMIT_MAX = 256;
 const long HTTP_PIPELINING_DEFAULT = 0L;
 const long HTTP_PIPELINING_MAX = 20L;
 
+// HTTP/2 multiplexing limits (streams per connection)
+const long HTTP_HTTP2_STREAMS_DEFAULT = 0L;
+const long HTTP_HTTP2_STREAMS_MAX = 100L;
+
 // Miscellaneous defaults
 const bool HTTP_USE_RETRY_AFTER_DEFAULT = true;
 const long HTTP_THROTTLE_RATE_DEFAULT = 0L;
+const long HTTP_ADAPTIVE_CONCURRENCY_DEFAULT = 0L;
 
 // Tuning parameters
 
@@ -163,6 +168,19 @@ const long HTTP_THROTTLE_RATE_DEFAULT = 0L;
 // request, ready and active queues.
 const int HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS = 2;
 
+// Adaptive concurrency controller.  Requests queued beyond the
+// best observed round trip (limit * (1 - min_rtt / rtt)) are
+// kept between ALPHA and BETA by adding or removing one request
+// per round trip.  Overload responses halve the limit at most
+// once per smoothed round trip.  The minimum RTT is re-sampled
+// every WINDOW so a changed route isn't judged by a stale best.
+const double HTTP_ADAPTIVE_QUEUE_ALPHA = 2.0;
+const double HTTP_ADAPTIVE_QUEUE_BETA = 4.0;
+const double HTTP_ADAPTIVE_RTT_GAIN = 0.125;
+const double HTTP_ADAPTIVE_DECREASE_FACTOR = 0.5;
+const HttpTime HTTP_ADAPTIVE_MIN_RTT_WINDOW = 10E6L; // 10 sec
+const HttpTime HTTP_ADAPTIVE_THROUGHPUT_WINDOW = 1E6L; // 1 sec
+
 // Block allocation size (a tuning parameter) is found
 // in bufferarray.h.
 
@@ -27,6 +27,7 @@
 #include "_httplibcurl.h"
 
 #include "httpheaders.h"
+#include "httpstats.h"
 #include "bufferarray.h"
 #include "_httpoprequest.h"
 #include "_httppolicy.h"
@@ -409,6 +410,19 @@ bool HttpLibcurl::completeRequest(CURLM * multi_handle, CURL * handle, CURLcode
         }
     }
 
+    if (handle)
+    {
+        // Streams vs. connections accounting.  NUM_CONNECTS is zero
+        // when the transfer was carried on an existing connection.
+        long http_version(0L);
+        long new_connects(0L);
+        curl_easy_getinfo(handle, CURLINFO_HTTP_VERSION, &http_version);
+        curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &new_connects);
+        HTTPStats::instance().recordTransport(op->mReqPolicy,
+                                              CURL_HTTP_VERSION_2_0 == http_version,
+                                              S32(new_connects));
+    }
+
     if (multi_handle && handle)
     {
         // Detach from multi and recycle handle
@@ -487,7 +501,26 @@ void HttpLibcurl::policyUpdated(int policy_class)
         policy.stallPolicy(policy_class, false);
         mDirtyPolicy[policy_class] = false;
 
-        if (options.mPipelining > 1)
+        if (options.mHttp2Streams > 0)
+        {
+            // HTTP/2 multiplexing.  Requests negotiate h2 individually
+            // (see HttpOpRequest::prepareRequest()) and libcurl then
+            // runs them as streams on as few connections as the
+            // per-host limit allows.
+            check_curl_multi_setopt(multi_handle,
+                                     CURLMOPT_PIPELINING,
+                                     CURLPIPE_MULTIPLEX);
+            check_curl_multi_setopt(multi_handle,
+                                     CURLMOPT_MAX_CONCURRENT_STREAMS,
+                                     long(options.mHttp2Streams));
+            check_curl_multi_setopt(multi_handle,
+                                     CURLMOPT_MAX_HOST_CONNECTIONS,
+                                     long(options.mPerHostConnectionLimit));
+            check_curl_multi_setopt(multi_handle,
+                                     CURLMOPT_MAX_TOTAL_CONNECTIONS,
+                                     long(options.mConnectionLimit));
+        }
+        else if (options.mPipelining > 1)
         {
             // We'll try to do pipelining on this multihandle
             check_curl_multi_setopt(multi_handle,
@@ -107,6 +107,10 @@ void os_strlower(char * str);
 // Error testing and reporting for libcurl status codes
 void check_curl_easy_code(CURLcode code, int curl_setopt_option);
 
+// Reply body bytes received for a request, counted in the stats and
+// toward the adaptive throughput of its policy class.
+void count_delivered_bytes(const LLCore::HttpOpRequest & op, size_t bytes);
+
 // This is a template because different 'option' values require different
 // types for 'ARG'. Just pass them through unchanged (by value).
 template <typename ARG>
@@ -148,9 +152,13 @@ HttpOpRequest::HttpOpRequest()
       mReplyFullLength(0),
       mReplyHeaders(),
       mReplyRetryAfter(0),
+      mReplySink(),
+      mReplySinkStarted(false),
+      mReplyStreamed(0),
       mPolicyRetries(0),
       mPolicy503Retries(0),
       mPolicyRetryAt(HttpTime(0)),
+      mPolicyActiveAt(HttpTime(0)),
       mPolicyRetryLimit(HTTP_RETRY_COUNT_DEFAULT),
       mPolicyMinRetryBackoff(HttpTime(HTTP_RETRY_BACKOFF_MIN_DEFAULT)),
       mPolicyMaxRetryBackoff(HttpTime(HTTP_RETRY_BACKOFF_MAX_DEFAULT)),
@@ -226,7 +234,8 @@ void HttpOpRequest::stageFromActive(HttpService * service)
         // (and there may not be due to protocol violations,
         // HEAD requests, etc., see BUG-2295) Verify that what it
         // says is consistent with the received data.
-        if (mReplyBody && mReplyBody->size() && mReplyLength != mReplyBody->size())
+        if ((mReplyBody && mReplyBody->size() && mReplyLength != mReplyBody->size())
+            || (mReplyStreamed && mReplyLength != mReplyStreamed))
         {
             // Not as expected, fail the request
             mStatus = HttpStatus(HttpStatus::LLCORE, HE_INV_CONTENT_RANGE_HDR);
@@ -249,6 +258,9 @@ void HttpOpRequest::stageFromActive(HttpService * service)
     mCurlTemp = NULL;
     mCurlTempLen = 0;
 
+    // Sink is done with, let it go from this thread as well
+    mReplySink.reset();
+
     addAsReply();
 }
 
@@ -261,6 +273,7 @@ void HttpOpRequest::visitNotifier(HttpRequest * request)
         HttpResponse * response = new HttpResponse();
         response->setStatus(mStatus);
         response->setBody(mReplyBody);
+        response->setStreamedSize(mReplyStreamed);
         response->setHeaders(mReplyHeaders);
         response->setRequestURL(mReqURL);
 
@@ -495,6 +508,8 @@ HttpStatus HttpOpRequest::prepareRequest(HttpService * service)
     mReplyFullLength = 0;
     mReplyHeaders.reset();
     mReplyConType.clear();
+    mReplySinkStarted = false;
+    mReplyStreamed = 0;
 
     // *FIXME:  better error handling later
     HttpStatus status;
@@ -562,6 +577,15 @@ HttpStatus HttpOpRequest::prepareRequest(HttpService * service)
 
     check_curl_easy_setopt(mCurlHandle, CURLOPT_NOBODY, nobody);
 
+    const bool use_http2(cpolicy.mHttp2Streams > 0);
+    if (use_http2)
+    {
+        // Offer h2 during the TLS handshake and prefer waiting for a
+        // stream on an existing connection over opening a new one.
+        check_curl_easy_setopt(mCurlHandle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        check_curl_easy_setopt(mCurlHandle, CURLOPT_PIPEWAIT, 1L);
+    }
+
     // The Linksys WRT54G V5 router has an issue with frequent
     // DNS lookups from LAN machines.  If they happen too often,
     // like for every HTTP request, the router gets annoyed after
@@ -659,12 +683,14 @@ HttpStatus HttpOpRequest::prepareRequest(HttpService * service)
         break;
     }
 
-    if (!mReqHeaders || !mReqHeaders->find(HTTP_OUT_HEADER_CONNECTION))
+    // Connection-specific headers are meaningless (and forbidden) on
+    // HTTP/2 where connection lifetime is negotiated by the protocol.
+    if (!use_http2 && (!mReqHeaders || !mReqHeaders->find(HTTP_OUT_HEADER_CONNECTION)))
     {
         mCurlHeaders = curl_slist_append(mCurlHeaders, "Connection: keep-alive");
     }
 
-    if (!mReqHeaders || !mReqHeaders->find(HTTP_OUT_HEADER_KEEP_ALIVE))
+    if (!use_http2 && (!mReqHeaders || !mReqHeaders->find(HTTP_OUT_HEADER_KEEP_ALIVE)))
     {
         mCurlHeaders = curl_slist_append(mCurlHeaders, "Keep-Alive: 300");
     }
@@ -787,14 +813,46 @@ size_t HttpOpRequest::writeCallback(void * data, size_t size, size_t nmemb, void
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
     HttpOpRequest::ptr_t op(HttpOpRequest::fromHandle<HttpOpRequest>(userdata));
+    const size_t req_size(size * nmemb);
+
+    if (op->mReplySink)
+    {
+        if (! op->mReplySinkStarted)
+        {
+            // Only successful bodies go to the sink.  Error pages
+            // fall through to the BufferArray like any other request.
+            long code(0L);
+            curl_easy_getinfo(op->mCurlHandle, CURLINFO_RESPONSE_CODE, &code);
+            if (code >= 200L && code < 300L)
+            {
+                if (! op->mReplySink->onBodyStart(HttpStatus(int(code)),
+                                                  size_t(op->mReplyOffset),
+                                                  op->mReplyLength,
+                                                  op->mReplyFullLength))
+                {
+                    return 0;                   // CURLE_WRITE_ERROR
+                }
+                op->mReplySinkStarted = true;
+            }
+        }
+        if (op->mReplySinkStarted)
+        {
+            if (! op->mReplySink->onBodyData(static_cast<char *>(data), req_size))
+            {
+                return 0;
+            }
+            op->mReplyStreamed += req_size;
+            count_delivered_bytes(*op, req_size);
+            return req_size;
+        }
+    }
 
     if (! op->mReplyBody)
     {
         op->mReplyBody = new BufferArray();
     }
-    const size_t req_size(size * nmemb);
     const size_t write_size(op->mReplyBody->append(static_cast<char *>(data), req_size));
-    HTTPStats::instance().recordDataDown(write_size);
+    count_delivered_bytes(*op, write_size);
     return write_size;
 }
 
@@ -1359,4 +1417,14 @@ void check_curl_easy_code(CURLcode code, int curl_setopt_option)
     }
 }
 
+
+void count_delivered_bytes(const LLCore::HttpOpRequest & op, size_t bytes)
+{
+    LLCore::HTTPStats::instance().recordDataDown(bytes);
+    if (op.mCurlService)
+    {
+        op.mCurlService->getPolicy().addDeliveredBytes(op.mReqPolicy, bytes);
+    }
+}
+
 }  // end anonymous namespace
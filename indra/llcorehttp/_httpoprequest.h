@@ -218,11 +218,15 @@ class HttpOpRequest final : public HttpOperation
     HttpHeaders::ptr_t  mReplyHeaders;
     std::string         mReplyConType;
     int                 mReplyRetryAfter;
+    HttpResponseSink::ptr_t mReplySink;         // Optional receiver of 2xx bodies
+    bool                mReplySinkStarted;      // Sink accepted the current attempt's body
+    size_t              mReplyStreamed;         // Bytes handed to sink this attempt
 
     // Policy data
     int                 mPolicyRetries;
     int                 mPolicy503Retries;
     HttpTime            mPolicyRetryAt;
+    HttpTime            mPolicyActiveAt;        // when last handed to transport (mcs)
     int                 mPolicyRetryLimit;
     HttpTime            mPolicyMinRetryBackoff; // initial delay between retries (mcs)
     HttpTime            mPolicyMaxRetryBackoff;
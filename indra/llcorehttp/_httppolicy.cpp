@@ -60,7 +60,15 @@ struct HttpPolicy::ClassState
         : mThrottleEnd(0),
           mThrottleLeft(0L),
           mRequestCount(0L),
-          mStallStaging(false)
+          mStallStaging(false),
+          mAdaptiveLimit(0.0),
+          mSmoothedRtt(0),
+          mMinRtt(0),
+          mMinRttAt(0),
+          mLastDecreaseAt(0),
+          mThroughput(0.0),
+          mThroughputAt(0),
+          mThroughputBytes(0)
         {}
 
     HttpReadyQueue      mReadyQueue;
@@ -71,11 +79,23 @@ struct HttpPolicy::ClassState
     long                mThrottleLeft;
     long                mRequestCount;
     bool                mStallStaging;
+
+    // Adaptive concurrency state, @see adaptConcurrency().
+    // A zero limit means the controller hasn't started.
+    double              mAdaptiveLimit;
+    HttpTime            mSmoothedRtt;
+    HttpTime            mMinRtt;
+    HttpTime            mMinRttAt;
+    HttpTime            mLastDecreaseAt;
+    double              mThroughput;            // bytes/sec, smoothed
+    HttpTime            mThroughputAt;          // start of current window
+    size_t              mThroughputBytes;       // received in current window
 };
 
 
 HttpPolicy::HttpPolicy(HttpService * service)
-    : mService(service)
+    : mService(service),
+      mNextClass(0)
 {
     // Create default class
     mClasses.push_back(new ClassState());
@@ -223,8 +243,14 @@ HttpService::ELoopSpeed HttpPolicy::processReadyQueue()
     HttpService::ELoopSpeed result(HttpService::REQUEST_SLEEP);
     HttpLibcurl & transport(mService->getTransport());
 
-    for (int policy_class(0); policy_class < mClasses.size(); ++policy_class)
+    // Rotate the class served first on each pass so that no class
+    // is consistently staged ahead of the others.
+    const int class_count(mClasses.size());
+    mNextClass = (mNextClass + 1) % class_count;
+
+    for (int class_index(0); class_index < class_count; ++class_index)
     {
+        const int policy_class((mNextClass + class_index) % class_count);
         ClassState & state(*mClasses[policy_class]);
         HttpRetryQueue & retryq(state.mRetryQueue);
         HttpReadyQueue & readyq(state.mReadyQueue);
@@ -254,11 +280,39 @@ HttpService::ELoopSpeed HttpPolicy::processReadyQueue()
         }
 
         int active(transport.getActiveCountInClass(policy_class));
-        int active_limit(state.mOptions.mPipelining > 1L
-                         ? (state.mOptions.mPerHostConnectionLimit
-                            * state.mOptions.mPipelining)
-                         : state.mOptions.mConnectionLimit);
+        int active_limit(state.mOptions.mConnectionLimit);
+        if (state.mOptions.mHttp2Streams > 0L)
+        {
+            active_limit = state.mOptions.mPerHostConnectionLimit * state.mOptions.mHttp2Streams;
+        }
+        else if (state.mOptions.mPipelining > 1L)
+        {
+            active_limit = state.mOptions.mPerHostConnectionLimit * state.mOptions.mPipelining;
+        }
+        if (state.mOptions.mAdaptiveConcurrency)
+        {
+            // Static limit is now the ceiling.  Start the controller
+            // at the user-visible concurrency and let it find its way.
+            if (state.mAdaptiveLimit <= 0.0)
+            {
+                state.mAdaptiveLimit = llmin(state.mOptions.mPerHostConnectionLimit, long(active_limit));
+            }
+            state.mAdaptiveLimit = llclamp(state.mAdaptiveLimit, 1.0, double(active_limit));
+            active_limit = llmax(1, int(state.mAdaptiveLimit));
+        }
+        else
+        {
+            state.mAdaptiveLimit = 0.0;
+        }
         int needed(active_limit - active);      // Expect negatives here
+        if (state.mOptions.mHttp2Streams > 0L)
+        {
+            // Multiplexed classes can have hundreds of free slots.  Stage
+            // at most one connection's worth of streams per pass so that
+            // a deep texture queue doesn't hold up mesh or inventory
+            // requests waiting behind it in this loop.
+            needed = llmin(needed, int(state.mOptions.mHttp2Streams));
+        }
 
         if (needed > 0)
         {
@@ -271,6 +325,7 @@ HttpService::ELoopSpeed HttpPolicy::processReadyQueue()
 
                 retryq.pop();
 
+                op->mPolicyActiveAt = now;
                 op->stageFromReady(mService);
                 op.reset();
 
@@ -302,6 +357,7 @@ HttpService::ELoopSpeed HttpPolicy::processReadyQueue()
                 HttpOpRequest::ptr_t op(readyq.top());
                 readyq.pop();
 
+                op->mPolicyActiveAt = now;
                 op->stageFromReady(mService);
                 op.reset();
 
@@ -383,6 +439,12 @@ bool HttpPolicy::cancel(HttpHandle handle)
 
 bool HttpPolicy::stageAfterCompletion(const HttpOpRequest::ptr_t &op)
 {
+    const int policy_class(op->mReqPolicy);
+    if (policy_class < mClasses.size())
+    {
+        adaptConcurrency(*mClasses[policy_class], policy_class, op);
+    }
+
     // Retry or finalize
     if (! op->mStatus)
     {
@@ -432,6 +494,108 @@ bool HttpPolicy::stageAfterCompletion(const HttpOpRequest::ptr_t &op)
 }
 
 
+// Adaptive concurrency controller.
+//
+// Follows TCP Vegas:  with the limit at L and the best round
+// trip seen at minRTT, a smoothed round trip of sRTT means about
+// L * (1 - minRTT / sRTT) requests are waiting in queues somewhere
+// rather than being worked on.  Keep that backlog between ALPHA
+// and BETA by moving the limit one request per round trip (1/L
+// per completion).  A 503 or 429 is an explicit overload signal
+// and halves the limit, AIMD style, at most once per round trip
+// so that a burst of rejections from one window counts once.
+//
+// Requests that failed in transport carry no useful timing and
+// are ignored.  Growth also stops while the class isn't using
+// the limit it already has, otherwise an idle class would
+// ratchet up to the ceiling and dump a burst on the next load.
+void HttpPolicy::adaptConcurrency(ClassState & state, int policy_class, const opReqPtr_t & op)
+{
+    static const HttpStatus error_503(503);
+    static const HttpStatus error_429(429);
+
+    if (! state.mOptions.mAdaptiveConcurrency
+        || state.mAdaptiveLimit <= 0.0
+        || ! op->mPolicyActiveAt)
+    {
+        return;
+    }
+
+    const HttpTime now(totalTime());
+    const bool overloaded(op->mStatus == error_503 || op->mStatus == error_429);
+
+    if (overloaded)
+    {
+        const HttpTime hold_off(state.mSmoothedRtt ? state.mSmoothedRtt : HttpTime(1000000));
+        if (now - state.mLastDecreaseAt >= hold_off)
+        {
+            state.mAdaptiveLimit = llmax(1.0, state.mAdaptiveLimit * HTTP_ADAPTIVE_DECREASE_FACTOR);
+            state.mLastDecreaseAt = now;
+        }
+    }
+    else if (op->mStatus)
+    {
+        const HttpTime rtt(llmax(now - op->mPolicyActiveAt, HttpTime(1)));
+
+        if (! state.mMinRtt || rtt < state.mMinRtt || now - state.mMinRttAt > HTTP_ADAPTIVE_MIN_RTT_WINDOW)
+        {
+            state.mMinRtt = rtt;
+            state.mMinRttAt = now;
+        }
+        if (! state.mSmoothedRtt)
+        {
+            state.mSmoothedRtt = rtt;
+        }
+        else
+        {
+            state.mSmoothedRtt = HttpTime(state.mSmoothedRtt * (1.0 - HTTP_ADAPTIVE_RTT_GAIN)
+                                          + rtt * HTTP_ADAPTIVE_RTT_GAIN);
+        }
+
+        const double limit(state.mAdaptiveLimit);
+        const double queued(limit * (1.0 - double(state.mMinRtt) / double(state.mSmoothedRtt)));
+        if (queued < HTTP_ADAPTIVE_QUEUE_ALPHA)
+        {
+            const int active(mService->getTransport().getActiveCountInClass(policy_class));
+            if (active + 1 >= int(limit))
+            {
+                state.mAdaptiveLimit += 1.0 / limit;
+            }
+        }
+        else if (queued > HTTP_ADAPTIVE_QUEUE_BETA)
+        {
+            state.mAdaptiveLimit = llmax(1.0, limit - 1.0 / limit);
+        }
+        // Upper clamp happens in processReadyQueue() where the
+        // static limit is computed.
+    }
+
+    // Throughput over whole windows, smoothed across them.  Only
+    // reported, the limit is driven by delay and overload.  Bytes
+    // come in through addDeliveredBytes() as they arrive.
+    if (! state.mThroughputAt)
+    {
+        state.mThroughputAt = now;
+    }
+    else if (now - state.mThroughputAt >= HTTP_ADAPTIVE_THROUGHPUT_WINDOW)
+    {
+        const double rate(state.mThroughputBytes * 1.0E6 / double(now - state.mThroughputAt));
+        state.mThroughput = state.mThroughput > 0.0
+            ? state.mThroughput * (1.0 - HTTP_ADAPTIVE_RTT_GAIN) + rate * HTTP_ADAPTIVE_RTT_GAIN
+            : rate;
+        state.mThroughputAt = now;
+        state.mThroughputBytes = 0;
+    }
+
+    HTTPStats::instance().recordConcurrency(policy_class,
+                                            state.mAdaptiveLimit,
+                                            state.mSmoothedRtt / 1.0E6,
+                                            state.mMinRtt / 1.0E6,
+                                            state.mThroughput,
+                                            overloaded);
+}
+
+
 HttpPolicyClass & HttpPolicy::getClassOptions(HttpRequest::policy_t pclass)
 {
     llassert_always(pclass < mClasses.size());
@@ -440,6 +604,15 @@ HttpPolicyClass & HttpPolicy::getClassOptions(HttpRequest::policy_t pclass)
 }
 
 
+void HttpPolicy::addDeliveredBytes(HttpRequest::policy_t policy_class, size_t bytes)
+{
+    if (policy_class < mClasses.size() && mClasses[policy_class]->mOptions.mAdaptiveConcurrency)
+    {
+        mClasses[policy_class]->mThroughputBytes += bytes;
+    }
+}
+
+
 int HttpPolicy::getReadyCount(HttpRequest::policy_t policy_class) const
 {
     if (policy_class < mClasses.size())
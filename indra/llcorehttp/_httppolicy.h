@@ -149,6 +149,13 @@ class HttpPolicy
     /// that point.
     HttpPolicyClass & getClassOptions(HttpRequest::policy_t pclass);
 
+    /// Count reply body bytes toward a class's throughput as
+    /// transport receives them, whether they end up in a
+    /// BufferArray or are streamed to a sink.
+    ///
+    /// Threading:  called by worker thread
+    void addDeliveredBytes(HttpRequest::policy_t policy_class, size_t bytes);
+
     /// Get ready counts for a particular policy class
     ///
     /// Threading:  called by worker thread
@@ -166,9 +173,17 @@ class HttpPolicy
     struct ClassState;
     typedef std::vector<ClassState *>   class_list_t;
 
+    /// Feed a completed request into its class's adaptive
+    /// concurrency controller (if enabled) adjusting the number
+    /// of requests the class may have in flight.
+    ///
+    /// Threading:  called by worker thread
+    void adaptConcurrency(ClassState & state, int policy_class, const opReqPtr_t & op);
+
     HttpPolicyGlobal                    mGlobalOptions;
     class_list_t                        mClasses;
     HttpService *                       mService;               // Naked pointer, not refcounted, not owner
+    int                                 mNextClass;             // First class served on next ready queue pass
 };  // end class HttpPolicy
 
 }  // end namespace LLCore
@@ -237,6 +237,43 @@ HttpHandle HttpRequest::requestGetByteRange(policy_t policy_id,
 }
 
 
+HttpHandle HttpRequest::requestGetToSink(policy_t policy_id,
+                                         const std::string & url,
+                                         size_t offset,
+                                         size_t len,
+                                         const HttpOptions::ptr_t & options,
+                                         const HttpHeaders::ptr_t & headers,
+                                         const HttpResponseSink::ptr_t & sink,
+                                         HttpHandler::ptr_t user_handler)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_NETWORK;
+    HttpStatus status;
+
+    if (! sink)
+    {
+        mLastReqStatus = HttpStatus(HttpStatus::LLCORE, HE_INVALID_ARG);
+        return LLCORE_HTTP_HANDLE_INVALID;
+    }
+
+    HttpOpRequest::ptr_t op = std::make_shared<HttpOpRequest>();
+    if (! (status = op->setupGetByteRange(policy_id, url, offset, len, options, headers)))
+    {
+        mLastReqStatus = status;
+        return LLCORE_HTTP_HANDLE_INVALID;
+    }
+    op->mReplySink = sink;
+    op->setReplyPath(mReplyQueue, user_handler);
+    if (! (status = mRequestQueue->addOp(op)))          // transfers refcount
+    {
+        mLastReqStatus = status;
+        return LLCORE_HTTP_HANDLE_INVALID;
+    }
+
+    mLastReqStatus = status;
+    return op->getHandle();
+}
+
+
 HttpHandle HttpRequest::requestPost(policy_t policy_id,
                                     const std::string & url,
                                     BufferArray * body,
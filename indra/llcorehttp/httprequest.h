@@ -31,6 +31,7 @@
 
 #include "httpcommon.h"
 #include "httphandler.h"
+#include "httpresponsesink.h"
 
 #include "httpheaders.h"
 #include "httpoptions.h"
@@ -236,6 +237,32 @@ class HttpRequest
         /// Global only
         PO_USER_AGENT,
 
+        /// If greater than 0, requests in this class negotiate
+        /// HTTP/2 (via ALPN on TLS connections, falling back to
+        /// HTTP/1.1 when the server declines) and are multiplexed
+        /// as concurrent streams over shared connections.  Value
+        /// gives the maximum number of concurrent streams allowed
+        /// on a single connection.  When non-zero, this takes the
+        /// place of PO_PIPELINING_DEPTH in computing the in-flight
+        /// request limit which becomes PO_PER_HOST_CONNECTION_LIMIT
+        /// times this value.  Zero, the default, keeps the class
+        /// on HTTP/1.1.
+        ///
+        /// Per-class only
+        PO_HTTP2_STREAMS,
+
+        /// If non-zero, the number of requests this class keeps in
+        /// flight is adjusted at runtime rather than held at the
+        /// limit derived from PO_CONNECTION_LIMIT, PO_PIPELINING_DEPTH
+        /// and PO_HTTP2_STREAMS.  That limit becomes a ceiling.  The
+        /// controller grows the in-flight count while round-trip
+        /// times stay near the best observed, shrinks it as queueing
+        /// delay builds and halves it on 503 or 429 responses.
+        /// Zero, the default, keeps the static limit.
+        ///
+        /// Per-class only
+        PO_ADAPTIVE_CONCURRENCY,
+
         PO_LAST  // Always at end
     };
 
@@ -394,6 +421,33 @@ class HttpRequest
                                    HttpHandler::ptr_t handler);
 
 
+    /// Queue an HTTP GET, optionally with a 'Range' header, whose
+    /// successful response body is handed to a sink as it arrives
+    /// instead of being collected into a BufferArray.  Otherwise
+    /// identical to @see requestGetByteRange().  The HttpResponse
+    /// delivered to the handler has no body when the sink was used.
+    ///
+    /// @param  policy_id       @see requestGet()
+    /// @param  url             "
+    /// @param  offset          @see requestGetByteRange().  Zero for
+    /// @param  len             both requests the whole resource.
+    /// @param  options         @see requestGet()
+    /// @param  headers         "
+    /// @param  sink            Receiver of the body, @see HttpResponseSink.
+    ///                         Required.
+    /// @param  handler         @see requestGet()
+    /// @return                 "
+    ///
+    HttpHandle requestGetToSink(policy_t policy_id,
+                                const std::string & url,
+                                size_t offset,
+                                size_t len,
+                                const HttpOptions::ptr_t & options,
+                                const HttpHeaders::ptr_t & headers,
+                                const HttpResponseSink::ptr_t & sink,
+                                HttpHandler::ptr_t handler);
+
+
     /// Queue a full HTTP POST.  Query arguments and body may
     /// be provided.  Caller is responsible for escaping and
     /// encoding and communicating the content types.
@@ -39,6 +39,7 @@ HttpResponse::HttpResponse()
       mReplyLength(0U),
       mReplyFullLength(0U),
       mBufferArray(NULL),
+      mStreamedSize(0),
       mHeaders(),
       mRetries(0U),
       m503Retries(0U),
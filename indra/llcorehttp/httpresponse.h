@@ -113,6 +113,19 @@ class HttpResponse final : public LLCoreInt::RefCounted
     /// in.  It is legal to set the data to NULL.
     void setBody(BufferArray * ba);
 
+    /// Number of body bytes handed to an HttpResponseSink rather
+    /// than collected in the body, @see HttpRequest::requestGetToSink().
+    /// Zero when no sink was used or the body was an error page.
+    size_t getStreamedSize() const
+        {
+            return mStreamedSize;
+        }
+
+    void setStreamedSize(size_t size)
+        {
+            mStreamedSize = size;
+        }
+
     /// And a getter for the headers.  And as with @see getResponse(),
     /// if headers aren't available because the operation doesn't produce
     /// any or delivery of headers wasn't requested in the options, this
@@ -223,6 +236,7 @@ class HttpResponse final : public LLCoreInt::RefCounted
     unsigned int        mReplyLength;
     unsigned int        mReplyFullLength;
     BufferArray *       mBufferArray;
+    size_t              mStreamedSize;
     HttpHeaders::ptr_t  mHeaders;
     std::string         mContentType;
     unsigned int        mRetries;
@@ -0,0 +1,97 @@
+/**
+ * @file httpresponsesink.h
+ * @brief Public-facing declarations for the HttpResponseSink class
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef _LLCORE_HTTP_RESPONSE_SINK_H_
+#define _LLCORE_HTTP_RESPONSE_SINK_H_
+
+
+#include "httpcommon.h"
+
+
+namespace LLCore
+{
+
+
+/// HttpResponseSink receives the body of a successful response
+/// as libcurl delivers it rather than having the library collect
+/// it in a BufferArray.  Callers with somewhere better to put the
+/// data (a preallocated decode buffer, a cache file, an incremental
+/// parser) derive from this and pass an instance with the request,
+/// @see HttpRequest::requestGetToSink().
+///
+/// Only 2xx bodies are streamed.  Error bodies are still collected
+/// into the response's BufferArray so that existing failure
+/// handling keeps working.  When a body was streamed, the response
+/// delivered to the HttpHandler has no body and reports the byte
+/// count through @see HttpResponse::getStreamedSize().
+///
+/// Threading:  Both methods are invoked on the worker thread while
+/// the request is active.  The library holds a reference until the
+/// request completes and the completion notification is delivered
+/// after the last call, so the handler may read what the sink
+/// collected without further locking.
+///
+/// Allocation:  Refcounted via std::shared_ptr.  An instance may
+/// only be given to a single request at a time.
+class HttpResponseSink
+{
+public:
+    typedef std::shared_ptr<HttpResponseSink> ptr_t;
+
+    virtual ~HttpResponseSink() = default;
+
+    /// Invoked before the first byte of a successful body.  If the
+    /// request is retried after a partial transfer this is invoked
+    /// again and the sink must discard anything it was given for
+    /// the earlier attempt.
+    ///
+    /// @param  status          HTTP status of the response (200, 206...)
+    /// @param  offset          Content-Range values as described for
+    /// @param  length          @see HttpResponse::getRange().  All
+    /// @param  full_length     zero when the header was absent.
+    ///
+    /// @return                 False to refuse the body.  The transfer
+    ///                         is aborted and the request fails with
+    ///                         a libcurl write error.
+    ///
+    virtual bool onBodyStart(const HttpStatus & status,
+                             size_t offset,
+                             size_t length,
+                             size_t full_length) = 0;
+
+    /// Invoked with each chunk of body data in order.  The data is
+    /// only valid for the duration of the call.
+    ///
+    /// @return                 False to abort the transfer as above.
+    ///
+    virtual bool onBodyData(const char * data, size_t size) = 0;
+
+};  // end class HttpResponseSink
+
+
+}   // end namespace LLCore
+
+#endif  // _LLCORE_HTTP_RESPONSE_SINK_H_
@@ -37,7 +37,12 @@ HTTPStats::HTTPStats()
 
 void HTTPStats::resetStats()
 {
-    mResutCodes.clear();
+    {
+        std::lock_guard<std::mutex> lock(mMapsMutex);
+        mResutCodes.clear();
+        mTransport.clear();
+        mConcurrency.clear();
+    }
     mDataDown.reset();
     mDataUp.reset();
     mRequests = 0;
@@ -46,6 +51,7 @@ void HTTPStats::resetStats()
 
 void HTTPStats::recordResultCode(S32 code)
 {
+    std::lock_guard<std::mutex> lock(mMapsMutex);
     std::map<S32, S32>::iterator it;
 
     it = mResutCodes.find(code);
@@ -57,6 +63,61 @@ void HTTPStats::recordResultCode(S32 code)
 
 }
 
+
+void HTTPStats::recordTransport(S32 policy_class, bool http2, S32 new_connections)
+{
+    std::lock_guard<std::mutex> lock(mMapsMutex);
+    TransportCounts & counts(mTransport[policy_class]);
+
+    if (http2)
+        ++counts.mHttp2Streams;
+    else
+        ++counts.mHttp1Requests;
+    counts.mConnections += new_connections;
+}
+
+
+void HTTPStats::recordConcurrency(S32 policy_class, F64 limit, F64 smoothed_rtt,
+                                  F64 min_rtt, F64 throughput, bool overloaded)
+{
+    std::lock_guard<std::mutex> lock(mMapsMutex);
+    ConcurrencyState & state(mConcurrency[policy_class]);
+
+    state.mLimit = limit;
+    state.mSmoothedRtt = smoothed_rtt;
+    state.mMinRtt = min_rtt;
+    state.mThroughput = throughput;
+    ++state.mSamples;
+    if (overloaded)
+        ++state.mOverloads;
+}
+
+
+bool HTTPStats::getConcurrency(S32 policy_class, ConcurrencyState & state) const
+{
+    std::lock_guard<std::mutex> lock(mMapsMutex);
+    std::map<S32, ConcurrencyState>::const_iterator it(mConcurrency.find(policy_class));
+
+    if (it == mConcurrency.end())
+        return false;
+
+    state = (*it).second;
+    return true;
+}
+
+
+bool HTTPStats::getTransport(S32 policy_class, TransportCounts & counts) const
+{
+    std::lock_guard<std::mutex> lock(mMapsMutex);
+    std::map<S32, TransportCounts>::const_iterator it(mTransport.find(policy_class));
+
+    if (it == mTransport.end())
+        return false;
+
+    counts = (*it).second;
+    return true;
+}
+
 namespace
 {
     std::string byte_count_converter(F32 bytes)
@@ -92,11 +153,36 @@ void HTTPStats::dumpStats()
     out << std::endl;
     out << "Result Codes:" << std::endl << "--- -----" << std::endl;
 
+    std::unique_lock<std::mutex> lock(mMapsMutex);
+
     for (std::map<S32, S32>::iterator it = mResutCodes.begin(); it != mResutCodes.end(); ++it)
     {
         out << (*it).first << " " << (*it).second << std::endl;
     }
 
+    out << std::endl;
+    out << "Transport by policy class:" << std::endl << "Class HTTP/1 HTTP/2-streams New-connections" << std::endl;
+
+    for (std::map<S32, TransportCounts>::iterator it = mTransport.begin(); it != mTransport.end(); ++it)
+    {
+        out << (*it).first << " " << (*it).second.mHttp1Requests
+            << " " << (*it).second.mHttp2Streams
+            << " " << (*it).second.mConnections << std::endl;
+    }
+
+    out << std::endl;
+    out << "Adaptive concurrency by policy class:" << std::endl << "Class Limit SRTT(ms) MinRTT(ms) Throughput Overloads" << std::endl;
+
+    for (std::map<S32, ConcurrencyState>::iterator it = mConcurrency.begin(); it != mConcurrency.end(); ++it)
+    {
+        out << (*it).first << " " << std::setprecision(3) << (*it).second.mLimit
+            << " " << ((*it).second.mSmoothedRtt * 1000.0)
+            << " " << ((*it).second.mMinRtt * 1000.0)
+            << " " << byte_count_converter((*it).second.mThroughput) << "/s"
+            << " " << (*it).second.mOverloads << std::endl;
+    }
+    lock.unlock();
+
     LL_WARNS("HTTPCore") << out.str() << LL_ENDL;
 }
 
@@ -33,6 +33,9 @@
 #include "llsingleton.h"
 #include "llsd.h"
 
+#include <map>
+#include <mutex>
+
 namespace LLCore
 {
     class HTTPStats final : public LLSingleton<HTTPStats>
@@ -59,6 +62,45 @@ namespace LLCore
 
         void    recordResultCode(S32 code);
 
+        /// Record how a completed request was carried:  as an HTTP/2
+        /// stream or an HTTP/1.x exchange, and how many new connections
+        /// it had to open (zero when an existing one was reused).
+        void    recordTransport(S32 policy_class, bool http2, S32 new_connections);
+
+        /// Snapshot of a policy class's adaptive concurrency
+        /// controller.  Times are in seconds, throughput in bytes
+        /// per second.
+        struct ConcurrencyState
+        {
+            F64     mLimit = 0.0;
+            F64     mSmoothedRtt = 0.0;
+            F64     mMinRtt = 0.0;
+            F64     mThroughput = 0.0;
+            S32     mSamples = 0;
+            S32     mOverloads = 0;     // 503/429 responses seen
+        };
+
+        /// Record the controller state after it has reacted to a
+        /// completed request.  'overloaded' is true when that
+        /// request's status forced a multiplicative decrease.
+        void    recordConcurrency(S32 policy_class, F64 limit, F64 smoothed_rtt,
+                                  F64 min_rtt, F64 throughput, bool overloaded);
+
+        /// Returns false if the class has never run adaptively.
+        bool    getConcurrency(S32 policy_class, ConcurrencyState & state) const;
+
+        /// Requests completed on a policy class by transport, and
+        /// the connections they opened between them.
+        struct TransportCounts
+        {
+            S32     mHttp1Requests = 0;
+            S32     mHttp2Streams = 0;
+            S32     mConnections = 0;
+        };
+
+        /// Returns false if the class has completed no requests.
+        bool    getTransport(S32 policy_class, TransportCounts & counts) const;
+
         void    dumpStats();
     private:
         StatsAccumulator mDataDown;
@@ -66,7 +108,12 @@ namespace LLCore
 
         S32              mRequests;
 
+        // The maps are written by the llcorehttp worker thread and
+        // read from the caller's.
+        mutable std::mutex mMapsMutex;
         std::map<S32, S32> mResutCodes;
+        std::map<S32, TransportCounts> mTransport;   // keyed by policy class
+        std::map<S32, ConcurrencyState> mConcurrency; // keyed by policy class
     };
 
 
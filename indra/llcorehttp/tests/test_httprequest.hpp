@@ -32,6 +32,7 @@
 #include "httpheaders.h"
 #include "httpresponse.h"
 #include "httpoptions.h"
+#include "httpstats.h"
 #include "_httpservice.h"
 #include "_httprequestqueue.h"
 
@@ -85,7 +86,9 @@ public:
                  const std::string & name)
         : mState(state),
           mName(name),
-          mExpectHandle(LLCORE_HTTP_HANDLE_INVALID)
+          mExpectHandle(LLCORE_HTTP_HANDLE_INVALID),
+          mLastHadBody(false),
+          mLastStreamedSize(0)
         {}
 
     virtual void onCompleted(HttpHandle handle, HttpResponse * response)
@@ -107,6 +110,11 @@ public:
             {
                 mState->mHandlerCalls++;
             }
+            if (response)
+            {
+                mLastHadBody = NULL != response->getBody();
+                mLastStreamedSize = response->getStreamedSize();
+            }
             if (! mHeadersRequired.empty() || ! mHeadersDisallowed.empty())
             {
                 ensure("Response required with header check", response != NULL);
@@ -183,6 +191,39 @@ public:
     std::string mCheckContentType;
     regex_container_t mHeadersRequired;
     regex_container_t mHeadersDisallowed;
+    bool mLastHadBody;
+    size_t mLastStreamedSize;
+};
+
+class TestSink : public LLCore::HttpResponseSink
+{
+public:
+    TestSink()
+        : mStarts(0),
+          mChunks(0),
+          mRefuse(false)
+        {}
+
+    virtual bool onBodyStart(const HttpStatus & status, size_t, size_t, size_t)
+        {
+            ++mStarts;
+            mStatus = status;
+            mData.clear();
+            return ! mRefuse;
+        }
+
+    virtual bool onBodyData(const char * data, size_t size)
+        {
+            ++mChunks;
+            mData.append(data, size);
+            return true;
+        }
+
+    int mStarts;
+    int mChunks;
+    bool mRefuse;
+    HttpStatus mStatus;
+    std::string mData;
 };
 
 typedef test_group<HttpRequestTestData> HttpRequestTestGroupType;
@@ -3012,6 +3053,710 @@ void HttpRequestTestObjectType::test<23>()
 }
 
 
+template <> template <>
+void HttpRequestTestObjectType::test<24>()
+{
+    ScopedCurlInit ready;
+
+    // Warmup boost::regex to pre-alloc memory for memory size tests
+    boost::regex warmup("askldjflasdj;f", boost::regex::icase);
+    boost::regex_match("akl;sjflajfk;ajsk", warmup);
+
+    std::string url_base(get_base_url());
+
+    set_test_name("HttpRequest GETs on an HTTP/2 policy class");
+
+    // The test peer speaks cleartext HTTP/1.1 so this exercises the
+    // fallback path:  requests on a multiplexed class must still
+    // complete and must not carry HTTP/1-only connection headers.
+    TestHandler2 handler(this, "handler");
+    LLCore::HttpHandler::ptr_t handlerp(&handler, NoOpDeletor);
+    mHandlerCalls = 0;
+
+    HttpRequest * req = NULL;
+    HttpOptions::ptr_t options;
+
+    try
+    {
+        // Get singletons created
+        HttpRequest::createService();
+
+        HttpRequest::policy_t pclass(HttpRequest::createPolicyClass());
+        ensure("Policy class created", pclass != HttpRequest::INVALID_POLICY_ID);
+
+        long ret_value(0);
+        HttpStatus status(HttpRequest::setStaticPolicyOption(HttpRequest::PO_HTTP2_STREAMS,
+                                                             pclass, 1000L, &ret_value));
+        ensure("HTTP/2 streams option accepted", bool(status));
+        ensure("HTTP/2 streams clamped to maximum", 100L == ret_value);
+
+        status = HttpRequest::setStaticPolicyOption(HttpRequest::PO_HTTP2_STREAMS,
+                                                    HttpRequest::GLOBAL_POLICY_ID, 16L, NULL);
+        ensure("HTTP/2 streams rejected as a global option", ! status);
+
+        status = HttpRequest::setStaticPolicyOption(HttpRequest::PO_HTTP2_STREAMS,
+                                                    pclass, 16L, &ret_value);
+        ensure("HTTP/2 streams set", bool(status) && 16L == ret_value);
+
+        // Start threading early so that thread memory is invariant
+        // over the test.
+        HttpRequest::startThread();
+
+        // create a new ref counted object with an implicit reference
+        req = new HttpRequest();
+
+        options = HttpOptions::ptr_t(new HttpOptions());
+        options->setWantHeaders(true);
+
+        mStatus = HttpStatus(200);
+        handler.mHeadersDisallowed.push_back(
+            regex_container_t::value_type(
+                boost::regex("X-Reflect-keep-alive", boost::regex::icase),
+                boost::regex(".*", boost::regex::icase)));
+
+        const int request_count(8);
+        for (int i(0); i < request_count; ++i)
+        {
+            HttpHandle handle = req->requestGet(pclass,
+                                                url_base,
+                                                options,
+                                                HttpHeaders::ptr_t(),
+                                                handlerp);
+            ensure("Valid handle returned for get request", handle != LLCORE_HTTP_HANDLE_INVALID);
+        }
+
+        // Run the notification pump.
+        int count(0);
+        int limit(LOOP_COUNT_LONG);
+        while (count++ < limit && mHandlerCalls < request_count)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Requests executed in reasonable time", count < limit);
+        ensure("One handler invocation per request", mHandlerCalls == request_count);
+
+        // Okay, request a shutdown of the servicing thread
+        mStatus = HttpStatus();
+        mHandlerCalls = 0;
+        handler.mHeadersDisallowed.clear();
+        HttpHandle handle = req->requestStopThread(handlerp);
+        ensure("Valid handle returned for second request", handle != LLCORE_HTTP_HANDLE_INVALID);
+
+        // Run the notification pump again
+        count = 0;
+        limit = LOOP_COUNT_LONG;
+        while (count++ < limit && mHandlerCalls < 1)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Second request executed in reasonable time", count < limit);
+        ensure("Second handler invocation", mHandlerCalls == 1);
+
+        // See that we actually shutdown the thread
+        count = 0;
+        limit = LOOP_COUNT_SHORT;
+        while (count++ < limit && ! HttpService::isStopped())
+        {
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Thread actually stopped running", HttpService::isStopped());
+
+        // release options
+        options.reset();
+
+        // release the request object
+        delete req;
+        req = NULL;
+
+        // Shut down service
+        HttpRequest::destroyService();
+    }
+    catch (...)
+    {
+        stop_thread(req);
+        options.reset();
+        delete req;
+        HttpRequest::destroyService();
+        throw;
+    }
+}
+
+
+template <> template <>
+void HttpRequestTestObjectType::test<25>()
+{
+    ScopedCurlInit ready;
+
+    std::string url_base(get_base_url());
+
+    set_test_name("HttpRequest adaptive concurrency under simulated latency");
+
+    // The peer answers '/delay/' requests one at a time after a short
+    // sleep so round trips grow with the number in flight, the shape
+    // of a congested link.  The controller should see queueing above
+    // the best round trip, then halve its limit on 503s.
+    TestHandler2 handler(this, "handler");
+    LLCore::HttpHandler::ptr_t handlerp(&handler, NoOpDeletor);
+    mHandlerCalls = 0;
+
+    HttpRequest * req = NULL;
+    HttpOptions::ptr_t options;
+
+    try
+    {
+        // Get singletons created
+        HttpRequest::createService();
+        HTTPStats::instance().resetStats();
+
+        HttpRequest::policy_t pclass(HttpRequest::createPolicyClass());
+        ensure("Policy class created", pclass != HttpRequest::INVALID_POLICY_ID);
+
+        long ret_value(0);
+        HttpStatus status(HttpRequest::setStaticPolicyOption(HttpRequest::PO_ADAPTIVE_CONCURRENCY,
+                                                             pclass, 5L, &ret_value));
+        ensure("Adaptive concurrency option accepted", bool(status));
+        ensure("Adaptive concurrency clamped to boolean", 1L == ret_value);
+
+        status = HttpRequest::setStaticPolicyOption(HttpRequest::PO_ADAPTIVE_CONCURRENCY,
+                                                    HttpRequest::GLOBAL_POLICY_ID, 1L, NULL);
+        ensure("Adaptive concurrency rejected as a global option", ! status);
+
+        status = HttpRequest::setStaticPolicyOption(HttpRequest::PO_CONNECTION_LIMIT,
+                                                    pclass, 8L, NULL);
+        ensure("Connection limit set", bool(status));
+        status = HttpRequest::setStaticPolicyOption(HttpRequest::PO_PER_HOST_CONNECTION_LIMIT,
+                                                    pclass, 8L, NULL);
+        ensure("Per-host connection limit set", bool(status));
+
+        // Start threading early so that thread memory is invariant
+        // over the test.
+        HttpRequest::startThread();
+
+        // create a new ref counted object with an implicit reference
+        req = new HttpRequest();
+
+        options = HttpOptions::ptr_t(new HttpOptions());
+        options->setRetries(0);
+
+        // Delayed GETs to build a round trip history
+        mStatus = HttpStatus(200);
+        const int request_count(24);
+        for (int i(0); i < request_count; ++i)
+        {
+            HttpHandle handle = req->requestGet(pclass,
+                                                url_base + "/delay/",
+                                                options,
+                                                HttpHeaders::ptr_t(),
+                                                handlerp);
+            ensure("Valid handle returned for delayed get request", handle != LLCORE_HTTP_HANDLE_INVALID);
+        }
+
+        // Run the notification pump.
+        int count(0);
+        int limit(LOOP_COUNT_LONG);
+        while (count++ < limit && mHandlerCalls < request_count)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Delayed requests executed in reasonable time", count < limit);
+        ensure("One handler invocation per delayed request", mHandlerCalls == request_count);
+
+        // Now overload responses
+        mStatus = HttpStatus(503);
+        mHandlerCalls = 0;
+        const int overload_count(4);
+        for (int i(0); i < overload_count; ++i)
+        {
+            HttpHandle handle = req->requestGet(pclass,
+                                                url_base + "/503/3/",
+                                                options,
+                                                HttpHeaders::ptr_t(),
+                                                handlerp);
+            ensure("Valid handle returned for 503 request", handle != LLCORE_HTTP_HANDLE_INVALID);
+        }
+
+        count = 0;
+        limit = LOOP_COUNT_LONG;
+        while (count++ < limit && mHandlerCalls < overload_count)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("503 requests executed in reasonable time", count < limit);
+        ensure("One handler invocation per 503 request", mHandlerCalls == overload_count);
+
+        // Okay, request a shutdown of the servicing thread
+        mStatus = HttpStatus();
+        mHandlerCalls = 0;
+        HttpHandle handle = req->requestStopThread(handlerp);
+        ensure("Valid handle returned for second request", handle != LLCORE_HTTP_HANDLE_INVALID);
+
+        // Run the notification pump again
+        count = 0;
+        limit = LOOP_COUNT_LONG;
+        while (count++ < limit && mHandlerCalls < 1)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Second request executed in reasonable time", count < limit);
+        ensure("Second handler invocation", mHandlerCalls == 1);
+
+        // See that we actually shutdown the thread
+        count = 0;
+        limit = LOOP_COUNT_SHORT;
+        while (count++ < limit && ! HttpService::isStopped())
+        {
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Thread actually stopped running", HttpService::isStopped());
+
+        // Worker is stopped, controller state is now stable
+        HTTPStats::ConcurrencyState state;
+        ensure("Controller state recorded", HTTPStats::instance().getConcurrency(pclass, state));
+        ensure("Every completion sampled", state.mSamples == request_count + overload_count);
+        ensure("Best round trip includes the server delay", state.mMinRtt >= 0.04);
+        ensure("Smoothed round trip shows queueing", state.mSmoothedRtt > state.mMinRtt);
+        ensure("Overloads seen", state.mOverloads == overload_count);
+        ensure("Limit halved below the static ceiling", state.mLimit >= 1.0 && state.mLimit <= 5.0);
+
+        // release options
+        options.reset();
+
+        // release the request object
+        delete req;
+        req = NULL;
+
+        // Shut down service
+        HttpRequest::destroyService();
+    }
+    catch (...)
+    {
+        stop_thread(req);
+        options.reset();
+        delete req;
+        HttpRequest::destroyService();
+        throw;
+    }
+}
+
+
+template <> template <>
+void HttpRequestTestObjectType::test<26>()
+{
+    ScopedCurlInit ready;
+
+    std::string url_base(get_base_url());
+
+    set_test_name("HttpRequest GETs streamed to a response sink");
+
+    TestHandler2 handler(this, "handler");
+    LLCore::HttpHandler::ptr_t handlerp(&handler, NoOpDeletor);
+    mHandlerCalls = 0;
+
+    HttpRequest * req = NULL;
+
+    try
+    {
+        // Get singletons created
+        HttpRequest::createService();
+
+        // Start threading early so that thread memory is invariant
+        // over the test.
+        HttpRequest::startThread();
+
+        // create a new ref counted object with an implicit reference
+        req = new HttpRequest();
+
+        // A sink is required
+        HttpHandle handle = req->requestGetToSink(HttpRequest::DEFAULT_POLICY_ID,
+                                                  url_base,
+                                                  0,
+                                                  0,
+                                                  HttpOptions::ptr_t(),
+                                                  HttpHeaders::ptr_t(),
+                                                  HttpResponseSink::ptr_t(),
+                                                  handlerp);
+        ensure("Request without a sink refused", handle == LLCORE_HTTP_HANDLE_INVALID);
+        ensure("Invalid argument status", req->getStatus() == HttpStatus(HttpStatus::LLCORE, HE_INVALID_ARG));
+
+        // Successful body goes to the sink
+        std::shared_ptr<TestSink> sink(std::make_shared<TestSink>());
+        mStatus = HttpStatus(200);
+        handle = req->requestGetToSink(HttpRequest::DEFAULT_POLICY_ID,
+                                       url_base,
+                                       0,
+                                       0,
+                                       HttpOptions::ptr_t(),
+                                       HttpHeaders::ptr_t(),
+                                       sink,
+                                       handlerp);
+        ensure("Valid handle returned for sink request", handle != LLCORE_HTTP_HANDLE_INVALID);
+
+        // Run the notification pump.
+        int count(0);
+        int limit(LOOP_COUNT_LONG);
+        while (count++ < limit && mHandlerCalls < 1)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Request executed in reasonable time", count < limit);
+        ensure("One handler invocation for request", mHandlerCalls == 1);
+        ensure("Sink started once", sink->mStarts == 1);
+        ensure("Sink saw success status", sink->mStatus == HttpStatus(200));
+        ensure("Sink received the body", sink->mData.find("success") != std::string::npos);
+        ensure("Response carries no body", ! handler.mLastHadBody);
+        ensure("Response reports streamed size", handler.mLastStreamedSize == sink->mData.size());
+
+        // Error bodies bypass the sink
+        std::shared_ptr<TestSink> fail_sink(std::make_shared<TestSink>());
+        mStatus = HttpStatus(400);
+        mHandlerCalls = 0;
+        HttpOptions::ptr_t options(new HttpOptions());
+        options->setRetries(0);
+        handle = req->requestGetToSink(HttpRequest::DEFAULT_POLICY_ID,
+                                       url_base + "/503/99/",      // 400 with a body
+                                       0,
+                                       0,
+                                       options,
+                                       HttpHeaders::ptr_t(),
+                                       fail_sink,
+                                       handlerp);
+        ensure("Valid handle returned for failing sink request", handle != LLCORE_HTTP_HANDLE_INVALID);
+
+        count = 0;
+        limit = LOOP_COUNT_LONG;
+        while (count++ < limit && mHandlerCalls < 1)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Failing request executed in reasonable time", count < limit);
+        ensure("One handler invocation for failing request", mHandlerCalls == 1);
+        ensure("Sink not started for error page", fail_sink->mStarts == 0);
+        ensure("Error page kept in the body", handler.mLastHadBody);
+        ensure("Nothing streamed for error page", handler.mLastStreamedSize == 0);
+
+        // A refusing sink aborts the transfer
+        std::shared_ptr<TestSink> refuse_sink(std::make_shared<TestSink>());
+        refuse_sink->mRefuse = true;
+        mStatus = HttpStatus(HttpStatus::EXT_CURL_EASY, CURLE_WRITE_ERROR);
+        mHandlerCalls = 0;
+        handle = req->requestGetToSink(HttpRequest::DEFAULT_POLICY_ID,
+                                       url_base,
+                                       0,
+                                       0,
+                                       options,
+                                       HttpHeaders::ptr_t(),
+                                       refuse_sink,
+                                       handlerp);
+        ensure("Valid handle returned for refused sink request", handle != LLCORE_HTTP_HANDLE_INVALID);
+
+        count = 0;
+        limit = LOOP_COUNT_LONG;
+        while (count++ < limit && mHandlerCalls < 1)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Refused request executed in reasonable time", count < limit);
+        ensure("One handler invocation for refused request", mHandlerCalls == 1);
+        ensure("Refusing sink got no data", refuse_sink->mChunks == 0);
+        options.reset();
+
+        // Okay, request a shutdown of the servicing thread
+        mStatus = HttpStatus();
+        mHandlerCalls = 0;
+        handle = req->requestStopThread(handlerp);
+        ensure("Valid handle returned for second request", handle != LLCORE_HTTP_HANDLE_INVALID);
+
+        // Run the notification pump again
+        count = 0;
+        limit = LOOP_COUNT_LONG;
+        while (count++ < limit && mHandlerCalls < 1)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Second request executed in reasonable time", count < limit);
+        ensure("Second handler invocation", mHandlerCalls == 1);
+
+        // See that we actually shutdown the thread
+        count = 0;
+        limit = LOOP_COUNT_SHORT;
+        while (count++ < limit && ! HttpService::isStopped())
+        {
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Thread actually stopped running", HttpService::isStopped());
+
+        // release the request object
+        delete req;
+        req = NULL;
+
+        // Shut down service
+        HttpRequest::destroyService();
+    }
+    catch (...)
+    {
+        stop_thread(req);
+        delete req;
+        HttpRequest::destroyService();
+        throw;
+    }
+}
+
+
+template <> template <>
+void HttpRequestTestObjectType::test<27>()
+{
+    ScopedCurlInit ready;
+
+    std::string url_base(get_base_url());
+
+    set_test_name("HttpRequest streamed GETs count toward adaptive throughput");
+
+    // Streamed replies never get a BufferArray so their bytes have to
+    // be counted as transport delivers them.  The peer serializes
+    // '/delay/' requests, enough of them span a throughput window.
+    TestHandler2 handler(this, "handler");
+    LLCore::HttpHandler::ptr_t handlerp(&handler, NoOpDeletor);
+    mHandlerCalls = 0;
+
+    HttpRequest * req = NULL;
+    HttpOptions::ptr_t options;
+
+    try
+    {
+        // Get singletons created
+        HttpRequest::createService();
+        HTTPStats::instance().resetStats();
+
+        HttpRequest::policy_t pclass(HttpRequest::createPolicyClass());
+        ensure("Policy class created", pclass != HttpRequest::INVALID_POLICY_ID);
+
+        HttpStatus status(HttpRequest::setStaticPolicyOption(HttpRequest::PO_ADAPTIVE_CONCURRENCY,
+                                                             pclass, 1L, NULL));
+        ensure("Adaptive concurrency option accepted", bool(status));
+
+        // Start threading early so that thread memory is invariant
+        // over the test.
+        HttpRequest::startThread();
+
+        // create a new ref counted object with an implicit reference
+        req = new HttpRequest();
+
+        options = HttpOptions::ptr_t(new HttpOptions());
+        options->setRetries(0);
+
+        mStatus = HttpStatus(200);
+        const int request_count(32);
+        std::vector<std::shared_ptr<TestSink> > sinks;
+        for (int i(0); i < request_count; ++i)
+        {
+            sinks.push_back(std::make_shared<TestSink>());
+            HttpHandle handle = req->requestGetToSink(pclass,
+                                                      url_base + "/delay/",
+                                                      0,
+                                                      0,
+                                                      options,
+                                                      HttpHeaders::ptr_t(),
+                                                      sinks.back(),
+                                                      handlerp);
+            ensure("Valid handle returned for streamed get request", handle != LLCORE_HTTP_HANDLE_INVALID);
+        }
+
+        // Run the notification pump.
+        int count(0);
+        int limit(LOOP_COUNT_LONG);
+        while (count++ < limit && mHandlerCalls < request_count)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Streamed requests executed in reasonable time", count < limit);
+        ensure("One handler invocation per streamed request", mHandlerCalls == request_count);
+        for (int i(0); i < request_count; ++i)
+        {
+            ensure("Body went to the sink", ! sinks[i]->mData.empty());
+        }
+
+        // Okay, request a shutdown of the servicing thread
+        mStatus = HttpStatus();
+        mHandlerCalls = 0;
+        HttpHandle handle = req->requestStopThread(handlerp);
+        ensure("Valid handle returned for second request", handle != LLCORE_HTTP_HANDLE_INVALID);
+
+        // Run the notification pump again
+        count = 0;
+        limit = LOOP_COUNT_LONG;
+        while (count++ < limit && mHandlerCalls < 1)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Second request executed in reasonable time", count < limit);
+        ensure("Second handler invocation", mHandlerCalls == 1);
+
+        // See that we actually shutdown the thread
+        count = 0;
+        limit = LOOP_COUNT_SHORT;
+        while (count++ < limit && ! HttpService::isStopped())
+        {
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Thread actually stopped running", HttpService::isStopped());
+
+        HTTPStats::ConcurrencyState state;
+        ensure("Controller state recorded", HTTPStats::instance().getConcurrency(pclass, state));
+        ensure("Every completion sampled", state.mSamples == request_count);
+        ensure("Streamed bytes measured as throughput", state.mThroughput > 0.0);
+
+        // release options
+        options.reset();
+
+        // release the request object
+        delete req;
+        req = NULL;
+
+        // Shut down service
+        HttpRequest::destroyService();
+    }
+    catch (...)
+    {
+        stop_thread(req);
+        options.reset();
+        delete req;
+        HttpRequest::destroyService();
+        throw;
+    }
+}
+
+
+template <> template <>
+void HttpRequestTestObjectType::test<28>()
+{
+    ScopedCurlInit ready;
+
+    std::string url_base(get_base_url() + "/keepalive/"); // path to kept-alive HTTP/1.1 answers
+
+    set_test_name("HttpRequest HTTP/2 class requests share a connection");
+
+    // The peer can't negotiate h2 but '/keepalive/' answers as
+    // HTTP/1.1 on a connection it keeps open.  With the class held to
+    // one connection per host, libcurl must queue the class's requests
+    // onto that one connection, and the transport counts show both the
+    // reuse and the HTTP/1.1 fallback.
+    TestHandler2 handler(this, "handler");
+    LLCore::HttpHandler::ptr_t handlerp(&handler, NoOpDeletor);
+    mHandlerCalls = 0;
+
+    HttpRequest * req = NULL;
+
+    try
+    {
+        // Get singletons created
+        HttpRequest::createService();
+        HTTPStats::instance().resetStats();
+
+        HttpRequest::policy_t pclass(HttpRequest::createPolicyClass());
+        ensure("Policy class created", pclass != HttpRequest::INVALID_POLICY_ID);
+
+        HttpStatus status(HttpRequest::setStaticPolicyOption(HttpRequest::PO_HTTP2_STREAMS,
+                                                             pclass, 16L, NULL));
+        ensure("HTTP/2 streams set", bool(status));
+        status = HttpRequest::setStaticPolicyOption(HttpRequest::PO_CONNECTION_LIMIT,
+                                                    pclass, 1L, NULL);
+        ensure("Connection limit set", bool(status));
+        status = HttpRequest::setStaticPolicyOption(HttpRequest::PO_PER_HOST_CONNECTION_LIMIT,
+                                                    pclass, 1L, NULL);
+        ensure("Per-host connection limit set", bool(status));
+
+        // Start threading early so that thread memory is invariant
+        // over the test.
+        HttpRequest::startThread();
+
+        // create a new ref counted object with an implicit reference
+        req = new HttpRequest();
+
+        // All issued at once:  the class admits streams times the
+        // per-host limit so none are held back by policy.
+        mStatus = HttpStatus(200);
+        const int request_count(8);
+        for (int i(0); i < request_count; ++i)
+        {
+            HttpHandle handle = req->requestGet(pclass,
+                                                url_base,
+                                                HttpOptions::ptr_t(),
+                                                HttpHeaders::ptr_t(),
+                                                handlerp);
+            ensure("Valid handle returned for get request", handle != LLCORE_HTTP_HANDLE_INVALID);
+        }
+
+        // Run the notification pump.
+        int count(0);
+        int limit(LOOP_COUNT_LONG);
+        while (count++ < limit && mHandlerCalls < request_count)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Requests executed in reasonable time", count < limit);
+        ensure("One handler invocation per request", mHandlerCalls == request_count);
+
+        HTTPStats::TransportCounts counts;
+        ensure("Transport recorded", HTTPStats::instance().getTransport(pclass, counts));
+        ensure("Every request fell back to HTTP/1.1",
+               counts.mHttp1Requests == request_count && counts.mHttp2Streams == 0);
+        ensure("Requests shared one connection", counts.mConnections == 1);
+
+        // Okay, request a shutdown of the servicing thread
+        mStatus = HttpStatus();
+        mHandlerCalls = 0;
+        HttpHandle handle = req->requestStopThread(handlerp);
+        ensure("Valid handle returned for second request", handle != LLCORE_HTTP_HANDLE_INVALID);
+
+        // Run the notification pump again
+        count = 0;
+        limit = LOOP_COUNT_LONG;
+        while (count++ < limit && mHandlerCalls < 1)
+        {
+            req->update(1000000);
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Second request executed in reasonable time", count < limit);
+        ensure("Second handler invocation", mHandlerCalls == 1);
+
+        // See that we actually shutdown the thread
+        count = 0;
+        limit = LOOP_COUNT_SHORT;
+        while (count++ < limit && ! HttpService::isStopped())
+        {
+            usleep(LOOP_SLEEP_INTERVAL);
+        }
+        ensure("Thread actually stopped running", HttpService::isStopped());
+
+        // release the request object
+        delete req;
+        req = NULL;
+
+        // Shut down service, closing the kept-alive connection
+        HttpRequest::destroyService();
+    }
+    catch (...)
+    {
+        stop_thread(req);
+        delete req;
+        HttpRequest::destroyService();
+        throw;
+    }
+}
+
+
 }  // end namespace tut
 
 namespace
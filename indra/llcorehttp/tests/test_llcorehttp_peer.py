@@ -67,6 +67,13 @@ class TestHTTPRequestHandler(BaseHTTPRequestHandler):
                            "Content-Range: bytes 0-75/2983",
                            "Content-Length: 76"
     -- '/bug2295/inv_cont_range/0/'  Generates HE_INVALID_CONTENT_RANGE error in llcorehttp.
+    - '/delay/'         Sleep briefly before answering.  The server
+                        handles one request at a time so concurrent
+                        requests queue behind each other, simulating
+                        a congested link.
+    - '/keepalive/'     Answer as HTTP/1.1 and leave the connection
+                        open for the next request.  Only one connection
+                        is served at a time so clients must reuse it.
     - '/503/'           Generate 503 responses with various kinds
                         of 'retry-after' headers
     -- '/503/0/'            "Retry-After: 2"   
@@ -147,8 +154,15 @@ def do_PUT(self):
 
     def answer(self, data, withdata=True):
         debug("%s.answer(%s): self.path = %r", self.__class__.__name__, data, self.path)
+        if "/keepalive/" in self.path:
+            # The request line has been parsed as for an HTTP/1.0
+            # server, which always closes.  Override before replying.
+            self.protocol_version = "HTTP/1.1"
+            self.close_connection = False
         if "/sleep/" in self.path:
             time.sleep(30)
+        elif "/delay/" in self.path:
+            time.sleep(0.05)
 
         if "/503/" in self.path:
             # Tests for various kinds of 'Retry-After' header parsing
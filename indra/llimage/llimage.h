@@ -287,11 +287,6 @@ class LLImageRaw final : public LLImageBase
     // Create an image from a local file (generally used in tools)
     //bool createFromFile(const std::string& filename, bool j2c_lowest_mip_only = false);
 
-    void copyLineScaled( U8* in, U8* out, S32 in_pixel_len, S32 out_pixel_len, S32 in_pixel_step, S32 out_pixel_step );
-    void compositeRowScaled4onto3( U8* in, U8* out, S32 in_pixel_len, S32 out_pixel_len );
-
-    U8  fastFractionalMult(U8 a,U8 b);
-
     void setDataAndSize(U8 *data, S32 width, S32 height, S8 components) ;
 
 public:
@@ -0,0 +1,951 @@
+/**
+ * @file llimagebc.cpp
+ * @brief Block compression (BC1, BC3, BC5, BC7) of raw image data
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llimagebc.h"
+#include "llmath.h"
+
+namespace
+{
+    const S32 BLOCK_PIXELS = 16;
+
+    // Endpoint refinement passes per quality level
+    const S32 REFINE_PASSES[LLImageBC::QUALITY_COUNT] = { 0, 1, 3 };
+
+    // BC7 4 bit index interpolation weights, out of 64
+    const S32 BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    //------------------------------------------------------------------------
+    // Endpoint fitting, shared by the formats. Points are 0-255 floats with
+    // N channels, endpoints are returned the same way.
+
+    template<S32 N>
+    void fit_endpoints(const F32 (*points)[N], S32 count, bool fast, F32* e0, F32* e1)
+    {
+        F32 mean[N] = {};
+        F32 low[N], high[N];
+        for (S32 c = 0; c < N; ++c)
+        {
+            low[c] = 255.f;
+            high[c] = 0.f;
+        }
+        for (S32 i = 0; i < count; ++i)
+        {
+            for (S32 c = 0; c < N; ++c)
+            {
+                mean[c] += points[i][c];
+                low[c] = llmin(low[c], points[i][c]);
+                high[c] = llmax(high[c], points[i][c]);
+            }
+        }
+        for (S32 c = 0; c < N; ++c)
+        {
+            mean[c] /= (F32)count;
+        }
+
+        F32 cov[N][N] = {};
+        for (S32 i = 0; i < count; ++i)
+        {
+            for (S32 a = 0; a < N; ++a)
+            {
+                for (S32 b = 0; b < N; ++b)
+                {
+                    cov[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+                }
+            }
+        }
+
+        if (fast)
+        {
+            // Bounding box, with channels that fall as the dominant one
+            // rises running the other way, pulled in a little since the
+            // extremes are rarely worth an endpoint
+            S32 major = 0;
+            for (S32 c = 1; c < N; ++c)
+            {
+                if (cov[c][c] > cov[major][major])
+                {
+                    major = c;
+                }
+            }
+            for (S32 c = 0; c < N; ++c)
+            {
+                F32 inset = (high[c] - low[c]) / 16.f;
+                bool flip = cov[major][c] < 0.f;
+                e0[c] = flip ? high[c] - inset : low[c] + inset;
+                e1[c] = flip ? low[c] + inset : high[c] - inset;
+            }
+            return;
+        }
+
+        // Principal axis by power iteration, starting along the box diagonal
+        F32 axis[N];
+        F32 length = 0.f;
+        for (S32 c = 0; c < N; ++c)
+        {
+            axis[c] = high[c] - low[c];
+            length += axis[c] * axis[c];
+        }
+        if (length <= 0.f)
+        {
+            for (S32 c = 0; c < N; ++c)
+            {
+                e0[c] = e1[c] = mean[c];
+            }
+            return;
+        }
+        for (S32 iteration = 0; iteration < 8; ++iteration)
+        {
+            F32 next[N] = {};
+            for (S32 a = 0; a < N; ++a)
+            {
+                for (S32 b = 0; b < N; ++b)
+                {
+                    next[a] += cov[a][b] * axis[b];
+                }
+            }
+            length = 0.f;
+            for (S32 c = 0; c < N; ++c)
+            {
+                length += next[c] * next[c];
+            }
+            if (length <= 0.f)
+            {
+                break;
+            }
+            length = 1.f / sqrtf(length);
+            for (S32 c = 0; c < N; ++c)
+            {
+                axis[c] = next[c] * length;
+            }
+        }
+        length = 0.f;
+        for (S32 c = 0; c < N; ++c)
+        {
+            length += axis[c] * axis[c];
+        }
+        length = 1.f / sqrtf(length);
+
+        F32 t_min = F32_MAX, t_max = -F32_MAX;
+        for (S32 i = 0; i < count; ++i)
+        {
+            F32 t = 0.f;
+            for (S32 c = 0; c < N; ++c)
+            {
+                t += (points[i][c] - mean[c]) * axis[c] * length;
+            }
+            t_min = llmin(t_min, t);
+            t_max = llmax(t_max, t);
+        }
+        for (S32 c = 0; c < N; ++c)
+        {
+            e0[c] = llclamp(mean[c] + axis[c] * length * t_min, 0.f, 255.f);
+            e1[c] = llclamp(mean[c] + axis[c] * length * t_max, 0.f, 255.f);
+        }
+    }
+
+    // Least squares endpoints for points interpolated with weight[i] of e1
+    template<S32 N>
+    bool refine_endpoints(const F32 (*points)[N], const F32* weights, S32 count, F32* e0, F32* e1)
+    {
+        F32 aa = 0.f, ab = 0.f, bb = 0.f;
+        F32 ax[N] = {}, bx[N] = {};
+        for (S32 i = 0; i < count; ++i)
+        {
+            F32 b = weights[i];
+            F32 a = 1.f - b;
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+            for (S32 c = 0; c < N; ++c)
+            {
+                ax[c] += a * points[i][c];
+                bx[c] += b * points[i][c];
+            }
+        }
+        F32 det = aa * bb - ab * ab;
+        if (fabsf(det) < 1.e-6f)
+        {
+            return false;
+        }
+        det = 1.f / det;
+        for (S32 c = 0; c < N; ++c)
+        {
+            e0[c] = llclamp((bb * ax[c] - ab * bx[c]) * det, 0.f, 255.f);
+            e1[c] = llclamp((aa * bx[c] - ab * ax[c]) * det, 0.f, 255.f);
+        }
+        return true;
+    }
+
+    //------------------------------------------------------------------------
+    // BC1 colors, also the color half of BC3
+
+    U16 pack_565(const F32* color)
+    {
+        S32 r = ll_round(color[0] * (31.f / 255.f));
+        S32 g = ll_round(color[1] * (63.f / 255.f));
+        S32 b = ll_round(color[2] * (31.f / 255.f));
+        return (U16)((llclamp(r, 0, 31) << 11) | (llclamp(g, 0, 63) << 5) | llclamp(b, 0, 31));
+    }
+
+    void unpack_565(U16 value, S32* color)
+    {
+        S32 r = (value >> 11) & 31;
+        S32 g = (value >> 5) & 63;
+        S32 b = value & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    // Four colors when c0 > c1, otherwise three and transparent black
+    void color_palette(U16 c0, U16 c1, bool four_colors, S32 (*palette)[4])
+    {
+        unpack_565(c0, palette[0]);
+        unpack_565(c1, palette[1]);
+        palette[0][3] = palette[1][3] = 255;
+        for (S32 c = 0; c < 3; ++c)
+        {
+            if (four_colors)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            else
+            {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+        }
+        palette[2][3] = 255;
+        palette[3][3] = four_colors ? 255 : 0;
+    }
+
+    struct ColorBlock
+    {
+        U16 mColor0;
+        U16 mColor1;
+        U32 mIndices;
+        S32 mError;
+    };
+
+    // Quantize the endpoints for a mode and pick the nearest color for each
+    // pixel. Transparent pixels take index 3 in three color mode.
+    ColorBlock index_colors(const F32 (*pixels)[3], const bool* transparent, const F32* e0, const F32* e1, bool four_colors)
+    {
+        ColorBlock block;
+        block.mColor0 = pack_565(e0);
+        block.mColor1 = pack_565(e1);
+        block.mIndices = 0;
+        block.mError = 0;
+        if (four_colors ? block.mColor0 < block.mColor1 : block.mColor0 > block.mColor1)
+        {
+            std::swap(block.mColor0, block.mColor1);
+        }
+
+        S32 palette[4][4];
+        color_palette(block.mColor0, block.mColor1, four_colors, palette);
+        // Equal endpoints decode as three colors whatever was meant; index
+        // 0 is the color either way
+        S32 choices = block.mColor0 == block.mColor1 ? 1 : (four_colors ? 4 : 3);
+
+        for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            S32 best = 3;
+            if (!transparent[i])
+            {
+                S32 best_error = S32_MAX;
+                for (S32 index = 0; index < choices; ++index)
+                {
+                    S32 error = 0;
+                    for (S32 c = 0; c < 3; ++c)
+                    {
+                        S32 d = (S32)pixels[i][c] - palette[index][c];
+                        error += d * d;
+                    }
+                    if (error < best_error)
+                    {
+                        best_error = error;
+                        best = index;
+                    }
+                }
+                block.mError += best_error;
+            }
+            block.mIndices |= (U32)best << (i * 2);
+        }
+        return block;
+    }
+
+    ColorBlock fit_colors(const F32 (*pixels)[3], const bool* transparent, S32 opaque, LLImageBC::EQuality quality, bool four_colors)
+    {
+        F32 points[BLOCK_PIXELS][3];
+        S32 count = 0;
+        for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            if (!transparent[i])
+            {
+                memcpy(points[count++], pixels[i], sizeof(points[0]));
+            }
+        }
+
+        F32 e0[3], e1[3];
+        fit_endpoints<3>(points, opaque, quality == LLImageBC::QUALITY_FAST, e0, e1);
+        ColorBlock best = index_colors(pixels, transparent, e0, e1, four_colors);
+
+        const F32 four_weights[4] = { 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+        const F32 three_weights[4] = { 0.f, 1.f, 0.5f, 0.f };
+        for (S32 pass = 0; pass < REFINE_PASSES[quality] && best.mError > 0; ++pass)
+        {
+            // Weights are relative to the endpoints as stored, which may
+            // have been swapped
+            S32 palette[4][4];
+            color_palette(best.mColor0, best.mColor1, four_colors, palette);
+            F32 weights[BLOCK_PIXELS];
+            S32 n = 0;
+            for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+            {
+                if (!transparent[i])
+                {
+                    S32 index = (best.mIndices >> (i * 2)) & 3;
+                    weights[n++] = four_colors ? four_weights[index] : three_weights[index];
+                }
+            }
+            if (!refine_endpoints<3>(points, weights, opaque, e0, e1))
+            {
+                break;
+            }
+            ColorBlock refined = index_colors(pixels, transparent, e0, e1, four_colors);
+            if (refined.mError >= best.mError)
+            {
+                break;
+            }
+            best = refined;
+        }
+        return best;
+    }
+
+    // bc1 allows three color mode and punch through alpha, the color half
+    // of BC3 is always decoded with four colors
+    void encode_color_block(const U8* rgba, LLImageBC::EQuality quality, bool bc1, U8* out)
+    {
+        F32 pixels[BLOCK_PIXELS][3];
+        bool transparent[BLOCK_PIXELS];
+        S32 opaque = 0;
+        for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            for (S32 c = 0; c < 3; ++c)
+            {
+                pixels[i][c] = rgba[i * 4 + c];
+            }
+            transparent[i] = bc1 && rgba[i * 4 + 3] < 128;
+            opaque += !transparent[i];
+        }
+
+        ColorBlock block;
+        if (!opaque)
+        {
+            block.mColor0 = block.mColor1 = 0;
+            block.mIndices = 0xffffffff;
+        }
+        else if (opaque < BLOCK_PIXELS)
+        {
+            block = fit_colors(pixels, transparent, opaque, quality, false);
+        }
+        else
+        {
+            block = fit_colors(pixels, transparent, opaque, quality, true);
+            if (bc1 && quality == LLImageBC::QUALITY_HIGH && block.mError > 0)
+            {
+                ColorBlock three = fit_colors(pixels, transparent, opaque, quality, false);
+                if (three.mError < block.mError)
+                {
+                    block = three;
+                }
+            }
+        }
+
+        out[0] = (U8)block.mColor0;
+        out[1] = (U8)(block.mColor0 >> 8);
+        out[2] = (U8)block.mColor1;
+        out[3] = (U8)(block.mColor1 >> 8);
+        for (S32 i = 0; i < 4; ++i)
+        {
+            out[4 + i] = (U8)(block.mIndices >> (i * 8));
+        }
+    }
+
+    void decode_color_block(const U8* in, bool bc1, U8* rgba)
+    {
+        U16 c0 = in[0] | (in[1] << 8);
+        U16 c1 = in[2] | (in[3] << 8);
+        U32 indices = in[4] | (in[5] << 8) | (in[6] << 16) | ((U32)in[7] << 24);
+        S32 palette[4][4];
+        color_palette(c0, c1, !bc1 || c0 > c1, palette);
+        for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            const S32* color = palette[(indices >> (i * 2)) & 3];
+            for (S32 c = 0; c < 4; ++c)
+            {
+                rgba[i * 4 + c] = (U8)color[c];
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // BC4 single channel blocks, the alpha of BC3 and both halves of BC5
+
+    // Eight values when v0 > v1, otherwise six plus 0 and 255
+    void value_palette(S32 v0, S32 v1, S32* palette)
+    {
+        palette[0] = v0;
+        palette[1] = v1;
+        if (v0 > v1)
+        {
+            for (S32 i = 2; i < 8; ++i)
+            {
+                palette[i] = ((8 - i) * v0 + (i - 1) * v1) / 7;
+            }
+        }
+        else
+        {
+            for (S32 i = 2; i < 6; ++i)
+            {
+                palette[i] = ((6 - i) * v0 + (i - 1) * v1) / 5;
+            }
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+    }
+
+    struct ValueBlock
+    {
+        S32 mValue0;
+        S32 mValue1;
+        U64 mIndices;
+        S32 mError;
+    };
+
+    ValueBlock index_values(const S32* values, S32 v0, S32 v1)
+    {
+        ValueBlock block;
+        block.mValue0 = v0;
+        block.mValue1 = v1;
+        block.mIndices = 0;
+        block.mError = 0;
+        S32 palette[8];
+        value_palette(v0, v1, palette);
+        for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            S32 best = 0;
+            S32 best_error = S32_MAX;
+            for (S32 index = 0; index < 8; ++index)
+            {
+                S32 d = values[i] - palette[index];
+                if (d * d < best_error)
+                {
+                    best_error = d * d;
+                    best = index;
+                }
+            }
+            block.mError += best_error;
+            block.mIndices |= (U64)best << (i * 3);
+        }
+        return block;
+    }
+
+    ValueBlock refine_values(const S32* values, ValueBlock best, S32 passes)
+    {
+        // Weight of v1 for each index in eight value mode
+        const F32 weights[8] = { 0.f, 1.f, 1.f / 7.f, 2.f / 7.f, 3.f / 7.f, 4.f / 7.f, 5.f / 7.f, 6.f / 7.f };
+        F32 points[BLOCK_PIXELS][1];
+        for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            points[i][0] = (F32)values[i];
+        }
+        for (S32 pass = 0; pass < passes && best.mError > 0; ++pass)
+        {
+            F32 pixel_weights[BLOCK_PIXELS];
+            for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+            {
+                pixel_weights[i] = weights[(best.mIndices >> (i * 3)) & 7];
+            }
+            F32 e0, e1;
+            if (!refine_endpoints<1>(points, pixel_weights, BLOCK_PIXELS, &e0, &e1))
+            {
+                break;
+            }
+            S32 v0 = ll_round(e0);
+            S32 v1 = ll_round(e1);
+            if (v0 == v1)
+            {
+                break;
+            }
+            ValueBlock refined = v0 > v1 ? index_values(values, v0, v1) : index_values(values, v1, v0);
+            if (refined.mError >= best.mError)
+            {
+                break;
+            }
+            best = refined;
+        }
+        return best;
+    }
+
+    void encode_value_block(const U8* data, S32 stride, LLImageBC::EQuality quality, U8* out)
+    {
+        S32 values[BLOCK_PIXELS];
+        S32 low = 255, high = 0;
+        S32 inner_low = 255, inner_high = 0;   // ignoring 0 and 255
+        for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            values[i] = data[i * stride];
+            low = llmin(low, values[i]);
+            high = llmax(high, values[i]);
+            if (values[i] > 0 && values[i] < 255)
+            {
+                inner_low = llmin(inner_low, values[i]);
+                inner_high = llmax(inner_high, values[i]);
+            }
+        }
+
+        ValueBlock block;
+        if (low == high)
+        {
+            block.mValue0 = block.mValue1 = low;
+            block.mIndices = 0;
+        }
+        else
+        {
+            block = index_values(values, high, low);
+            block = refine_values(values, block, REFINE_PASSES[quality]);
+            if (quality == LLImageBC::QUALITY_HIGH && block.mError > 0 && inner_low <= inner_high)
+            {
+                // Six values between the inner extremes, with exact 0 and 255
+                ValueBlock six = index_values(values, inner_low, inner_high);
+                if (six.mError < block.mError)
+                {
+                    block = six;
+                }
+            }
+        }
+
+        out[0] = (U8)block.mValue0;
+        out[1] = (U8)block.mValue1;
+        for (S32 i = 0; i < 6; ++i)
+        {
+            out[2 + i] = (U8)(block.mIndices >> (i * 8));
+        }
+    }
+
+    void decode_value_block(const U8* in, U8* data, S32 stride)
+    {
+        S32 palette[8];
+        value_palette(in[0], in[1], palette);
+        U64 indices = 0;
+        for (S32 i = 0; i < 6; ++i)
+        {
+            indices |= (U64)in[2 + i] << (i * 8);
+        }
+        for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            data[i * stride] = (U8)palette[(indices >> (i * 3)) & 7];
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // BC7 mode 6: RGBA endpoints of 7 bits plus a shared low bit each
+
+    struct BitWriter
+    {
+        BitWriter(U8* out) : mOut(out), mPosition(0) { memset(out, 0, 16); }
+
+        void write(U32 value, S32 bits)
+        {
+            for (S32 i = 0; i < bits; ++i, ++mPosition)
+            {
+                mOut[mPosition >> 3] |= ((value >> i) & 1) << (mPosition & 7);
+            }
+        }
+
+        U8* mOut;
+        S32 mPosition;
+    };
+
+    struct BitReader
+    {
+        BitReader(const U8* in) : mIn(in), mPosition(0) {}
+
+        U32 read(S32 bits)
+        {
+            U32 value = 0;
+            for (S32 i = 0; i < bits; ++i, ++mPosition)
+            {
+                value |= ((mIn[mPosition >> 3] >> (mPosition & 7)) & 1) << i;
+            }
+            return value;
+        }
+
+        const U8* mIn;
+        S32 mPosition;
+    };
+
+    struct Mode6Block
+    {
+        S32 mEndpoints[2][4];   // 8 bit, low bit is the p bit
+        U8 mIndices[BLOCK_PIXELS];
+        S32 mError;
+    };
+
+    void quantize_mode6(const F32* endpoint, S32 pbit, S32* out)
+    {
+        for (S32 c = 0; c < 4; ++c)
+        {
+            S32 q = llclamp(ll_round((endpoint[c] - (F32)pbit) * 0.5f), 0, 127);
+            out[c] = (q << 1) | pbit;
+        }
+    }
+
+    // p bit bringing an endpoint closest to where it was
+    S32 best_pbit(const F32* endpoint)
+    {
+        F32 error[2] = { 0.f, 0.f };
+        for (S32 pbit = 0; pbit < 2; ++pbit)
+        {
+            S32 quantized[4];
+            quantize_mode6(endpoint, pbit, quantized);
+            for (S32 c = 0; c < 4; ++c)
+            {
+                F32 d = endpoint[c] - (F32)quantized[c];
+                error[pbit] += d * d;
+            }
+        }
+        return error[1] < error[0] ? 1 : 0;
+    }
+
+    void index_mode6(const F32 (*pixels)[4], Mode6Block& block)
+    {
+        S32 palette[16][4];
+        for (S32 index = 0; index < 16; ++index)
+        {
+            for (S32 c = 0; c < 4; ++c)
+            {
+                palette[index][c] = ((64 - BC7_WEIGHTS[index]) * block.mEndpoints[0][c]
+                                     + BC7_WEIGHTS[index] * block.mEndpoints[1][c] + 32) >> 6;
+            }
+        }
+        block.mError = 0;
+        for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            S32 best = 0;
+            S32 best_error = S32_MAX;
+            for (S32 index = 0; index < 16; ++index)
+            {
+                S32 error = 0;
+                for (S32 c = 0; c < 4; ++c)
+                {
+                    S32 d = (S32)pixels[i][c] - palette[index][c];
+                    error += d * d;
+                }
+                if (error < best_error)
+                {
+                    best_error = error;
+                    best = index;
+                }
+            }
+            block.mIndices[i] = (U8)best;
+            block.mError += best_error;
+        }
+    }
+
+    Mode6Block quantize_and_index(const F32 (*pixels)[4], const F32* e0, const F32* e1, bool opaque, bool search_pbits)
+    {
+        Mode6Block best;
+        if (opaque)
+        {
+            // Only a set p bit reaches 255, and opaque textures must stay
+            // exactly opaque or they get sorted as alpha blended
+            quantize_mode6(e0, 1, best.mEndpoints[0]);
+            quantize_mode6(e1, 1, best.mEndpoints[1]);
+            index_mode6(pixels, best);
+            return best;
+        }
+        if (!search_pbits)
+        {
+            quantize_mode6(e0, best_pbit(e0), best.mEndpoints[0]);
+            quantize_mode6(e1, best_pbit(e1), best.mEndpoints[1]);
+            index_mode6(pixels, best);
+            return best;
+        }
+
+        best.mError = S32_MAX;
+        for (S32 pbits = 0; pbits < 4; ++pbits)
+        {
+            Mode6Block block;
+            quantize_mode6(e0, pbits & 1, block.mEndpoints[0]);
+            quantize_mode6(e1, pbits >> 1, block.mEndpoints[1]);
+            index_mode6(pixels, block);
+            if (block.mError < best.mError)
+            {
+                best = block;
+            }
+        }
+        return best;
+    }
+
+    void encode_bc7_block(const U8* rgba, LLImageBC::EQuality quality, U8* out)
+    {
+        F32 pixels[BLOCK_PIXELS][4];
+        bool opaque = true;
+        for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            for (S32 c = 0; c < 4; ++c)
+            {
+                pixels[i][c] = rgba[i * 4 + c];
+            }
+            opaque = opaque && rgba[i * 4 + 3] == 255;
+        }
+
+        bool search_pbits = quality == LLImageBC::QUALITY_HIGH;
+        F32 e0[4], e1[4];
+        fit_endpoints<4>(pixels, BLOCK_PIXELS, quality == LLImageBC::QUALITY_FAST, e0, e1);
+        Mode6Block block = quantize_and_index(pixels, e0, e1, opaque, search_pbits);
+
+        for (S32 pass = 0; pass < REFINE_PASSES[quality] && block.mError > 0; ++pass)
+        {
+            F32 weights[BLOCK_PIXELS];
+            for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+            {
+                weights[i] = (F32)BC7_WEIGHTS[block.mIndices[i]] / 64.f;
+            }
+            if (!refine_endpoints<4>(pixels, weights, BLOCK_PIXELS, e0, e1))
+            {
+                break;
+            }
+            Mode6Block refined = quantize_and_index(pixels, e0, e1, opaque, search_pbits);
+            if (refined.mError >= block.mError)
+            {
+                break;
+            }
+            block = refined;
+        }
+
+        // The first index is stored without its top bit, so it must be
+        // below 8. Swapping the endpoints mirrors the indices.
+        if (block.mIndices[0] & 8)
+        {
+            for (S32 c = 0; c < 4; ++c)
+            {
+                std::swap(block.mEndpoints[0][c], block.mEndpoints[1][c]);
+            }
+            for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+            {
+                block.mIndices[i] = 15 - block.mIndices[i];
+            }
+        }
+
+        BitWriter bits(out);
+        bits.write(1 << 6, 7);
+        for (S32 c = 0; c < 4; ++c)
+        {
+            bits.write(block.mEndpoints[0][c] >> 1, 7);
+            bits.write(block.mEndpoints[1][c] >> 1, 7);
+        }
+        bits.write(block.mEndpoints[0][0] & 1, 1);
+        bits.write(block.mEndpoints[1][0] & 1, 1);
+        bits.write(block.mIndices[0], 3);
+        for (S32 i = 1; i < BLOCK_PIXELS; ++i)
+        {
+            bits.write(block.mIndices[i], 4);
+        }
+    }
+
+    void decode_bc7_block(const U8* in, U8* rgba)
+    {
+        // Mode 6 is six zero bits then a one
+        if ((in[0] & 0x7f) != (1 << 6))
+        {
+            memset(rgba, 0, BLOCK_PIXELS * 4);
+            return;
+        }
+        BitReader bits(in);
+        bits.read(7);
+        S32 endpoints[2][4];
+        for (S32 c = 0; c < 4; ++c)
+        {
+            endpoints[0][c] = bits.read(7) << 1;
+            endpoints[1][c] = bits.read(7) << 1;
+        }
+        S32 p0 = bits.read(1);
+        S32 p1 = bits.read(1);
+        for (S32 c = 0; c < 4; ++c)
+        {
+            endpoints[0][c] |= p0;
+            endpoints[1][c] |= p1;
+        }
+        for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            S32 weight = BC7_WEIGHTS[bits.read(i == 0 ? 3 : 4)];
+            for (S32 c = 0; c < 4; ++c)
+            {
+                rgba[i * 4 + c] = (U8)(((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6);
+            }
+        }
+    }
+}
+
+S32 LLImageBC::blockBytes(EFormat format)
+{
+    return format == FORMAT_BC1 ? 8 : 16;
+}
+
+S32 LLImageBC::levelBytes(EFormat format, S32 width, S32 height)
+{
+    return ((width + 3) / 4) * ((height + 3) / 4) * blockBytes(format);
+}
+
+const char* LLImageBC::getFormatName(EFormat format)
+{
+    switch (format)
+    {
+    case FORMAT_BC1: return "BC1";
+    case FORMAT_BC3: return "BC3";
+    case FORMAT_BC5: return "BC5";
+    case FORMAT_BC7: return "BC7";
+    default: return "unknown";
+    }
+}
+
+void LLImageBC::compressBlock(EFormat format, EQuality quality, const U8* rgba, U8* out)
+{
+    quality = (EQuality)llclamp((S32)quality, 0, QUALITY_COUNT - 1);
+    switch (format)
+    {
+    case FORMAT_BC1:
+        encode_color_block(rgba, quality, true, out);
+        break;
+    case FORMAT_BC3:
+        encode_value_block(rgba + 3, 4, quality, out);
+        encode_color_block(rgba, quality, false, out + 8);
+        break;
+    case FORMAT_BC5:
+        encode_value_block(rgba, 4, quality, out);
+        encode_value_block(rgba + 1, 4, quality, out + 8);
+        break;
+    case FORMAT_BC7:
+        encode_bc7_block(rgba, quality, out);
+        break;
+    default:
+        llassert(false);
+        break;
+    }
+}
+
+void LLImageBC::decompressBlock(EFormat format, const U8* in, U8* rgba)
+{
+    switch (format)
+    {
+    case FORMAT_BC1:
+        decode_color_block(in, true, rgba);
+        break;
+    case FORMAT_BC3:
+        decode_color_block(in + 8, false, rgba);
+        decode_value_block(in, rgba + 3, 4);
+        break;
+    case FORMAT_BC5:
+        decode_value_block(in, rgba, 4);
+        decode_value_block(in + 8, rgba + 1, 4);
+        for (S32 i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            rgba[i * 4 + 2] = 0;
+            rgba[i * 4 + 3] = 255;
+        }
+        break;
+    case FORMAT_BC7:
+        decode_bc7_block(in, rgba);
+        break;
+    default:
+        llassert(false);
+        break;
+    }
+}
+
+void LLImageBC::compress(EFormat format, EQuality quality, const U8* data, S32 width, S32 height, S32 components, U8* out)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+
+    const S32 block_bytes = blockBytes(format);
+    U8 block[BLOCK_PIXELS * 4];
+    for (S32 by = 0; by < height; by += 4)
+    {
+        for (S32 bx = 0; bx < width; bx += 4)
+        {
+            for (S32 y = 0; y < 4; ++y)
+            {
+                const U8* row = data + llmin(by + y, height - 1) * width * components;
+                for (S32 x = 0; x < 4; ++x)
+                {
+                    const U8* in = row + llmin(bx + x, width - 1) * components;
+                    U8* pixel = block + (y * 4 + x) * 4;
+                    if (format == FORMAT_BC5 || components >= 3)
+                    {
+                        pixel[0] = in[0];
+                        pixel[1] = in[components > 1 ? 1 : 0];
+                        pixel[2] = in[components > 2 ? 2 : 0];
+                        pixel[3] = components == 4 ? in[3] : 255;
+                    }
+                    else
+                    {
+                        pixel[0] = pixel[1] = pixel[2] = in[0];
+                        pixel[3] = components == 2 ? in[1] : 255;
+                    }
+                }
+            }
+            compressBlock(format, quality, block, out);
+            out += block_bytes;
+        }
+    }
+}
+
+void LLImageBC::decompress(EFormat format, const U8* in, S32 width, S32 height, U8* rgba)
+{
+    const S32 block_bytes = blockBytes(format);
+    U8 block[BLOCK_PIXELS * 4];
+    for (S32 by = 0; by < height; by += 4)
+    {
+        for (S32 bx = 0; bx < width; bx += 4)
+        {
+            decompressBlock(format, in, block);
+            in += block_bytes;
+            for (S32 y = 0; y < 4 && by + y < height; ++y)
+            {
+                for (S32 x = 0; x < 4 && bx + x < width; ++x)
+                {
+                    memcpy(rgba + ((by + y) * width + bx + x) * 4, block + (y * 4 + x) * 4, 4);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/**
+ * @file llimagebc.h
+ * @brief Block compression (BC1, BC3, BC5, BC7) of raw image data
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMAGEBC_H
+#define LL_LLIMAGEBC_H
+
+// CPU encoder for the GPU block compressed formats, so that textures can
+// be compressed once on a worker thread (and cached) rather than by the
+// driver on every upload. LLImageDXT::encodeCompressed() wraps this into
+// a full mip chain ready for LLImageGL.
+//
+// Every format works on 4x4 pixel blocks. Partial blocks at the right and
+// bottom edges repeat the last column and row.
+//
+// BC7 output only uses mode 6 (one subset, RGBA with 4 bit indices), which
+// every BC7 decoder handles the same way. The partitioned modes would gain
+// a little on blocks with several distinct colors. decompress() handles
+// everything compress() produces, which is what it is for; other BC7 modes
+// decode to transparent black.
+namespace LLImageBC
+{
+    enum EFormat
+    {
+        FORMAT_BC1 = 0,     // RGB with 1 bit alpha, 4 bits per pixel (DXT1)
+        FORMAT_BC3,         // RGBA, 8 bits per pixel (DXT5)
+        FORMAT_BC5,         // two independent channels for normal maps, 8 bits per pixel
+        FORMAT_BC7,         // RGBA, 8 bits per pixel, best quality
+        FORMAT_COUNT
+    };
+
+    enum EQuality
+    {
+        QUALITY_FAST = 0,   // bounding box endpoints
+        QUALITY_NORMAL,     // principal axis endpoints refined once
+        QUALITY_HIGH,       // more refinement, and tries the alternate block modes
+        QUALITY_COUNT
+    };
+
+    S32 blockBytes(EFormat format);
+    // Bytes for one width x height level, partial blocks included
+    S32 levelBytes(EFormat format, S32 width, S32 height);
+    const char* getFormatName(EFormat format);
+
+    // Compress one level. One and two channel images are luminance and
+    // luminance alpha, except for BC5 which takes the first two channels
+    // as they are. Images without alpha come out opaque. out must hold
+    // levelBytes().
+    void compress(EFormat format, EQuality quality, const U8* data, S32 width, S32 height, S32 components, U8* out);
+
+    // Decode a level back to RGBA, for checking the quality of the
+    // encoder. BC5 fills red and green, with blue 0 and alpha 255.
+    void decompress(EFormat format, const U8* in, S32 width, S32 height, U8* rgba);
+
+    // A single block, 16 RGBA pixels in rows
+    void compressBlock(EFormat format, EQuality quality, const U8* rgba, U8* out);
+    void decompressBlock(EFormat format, const U8* in, U8* rgba);
+}
+
+#endif // LL_LLIMAGEBC_H
@@ -0,0 +1,330 @@
+/**
+ * @file llimagebufferpool.cpp
+ * @brief Size-classed pool for image pixel buffers
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llimagebufferpool.h"
+
+#include "llmemory.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    // Size classes, smallest first: 3 KB, 4 KB, 6 KB, 8 KB, ... 12 MB, 16 MB
+    const S32 MIN_SHIFT = 10;
+    const S32 CLASS_COUNT = 26;
+    const S32 MIN_POOLED_SIZE = 3 << MIN_SHIFT;
+    const S32 MAX_POOLED_SIZE = 1 << 24;
+
+    // Each thread keeps up to THREAD_CACHE_DEPTH buffers of each size up
+    // to 256x256 RGBA, and THREAD_CACHE_BYTES in all
+    const S32 THREAD_CACHE_MAX_SIZE = 256 * 256 * 4;
+    const size_t THREAD_CACHE_DEPTH = 4;
+    const S64 THREAD_CACHE_BYTES = 2 * 1024 * 1024;
+
+    // Shared buffers idle for longer than this are released by update()
+    const std::chrono::seconds MAX_IDLE_TIME(10);
+
+    typedef std::chrono::steady_clock::time_point time_point_t;
+
+    S32 class_size(S32 index)
+    {
+        return (index & 1) ? 1 << (index / 2 + MIN_SHIFT + 2) : 3 << (index / 2 + MIN_SHIFT);
+    }
+
+    // Returns -1 for sizes that aren't pooled
+    S32 size_class(S32 size)
+    {
+        if (size < MIN_POOLED_SIZE || size > MAX_POOLED_SIZE)
+        {
+            return -1;
+        }
+        U32 value = (U32)size;
+        bool three = (value % 3) == 0;
+        if (three)
+        {
+            value /= 3;
+        }
+        if (value & (value - 1))
+        {
+            return -1;
+        }
+        S32 shift = 0;
+        while (value >>= 1)
+        {
+            ++shift;
+        }
+        return three ? (shift - MIN_SHIFT) * 2 : (shift - MIN_SHIFT - 2) * 2 + 1;
+    }
+
+    std::atomic<S64> sMaxBytes(0);
+    std::atomic<S64> sCachedBytes(0);   // shared and per thread
+    std::atomic<U64> sHits(0);
+    std::atomic<U64> sMisses(0);
+    std::atomic<S64> sReleasedBytes(0);
+    std::atomic<U32> sTrimGeneration(0);
+
+    struct SharedPool
+    {
+        struct Entry
+        {
+            U8* mData;
+            time_point_t mTime;
+        };
+
+        std::mutex mMutex;
+        std::deque<Entry> mFree[CLASS_COUNT]; // oldest first
+        S64 mBytes = 0;
+
+        // Releases buffers idle since before cutoff, then the oldest ones
+        // until at most keep_bytes are left
+        void release(S64 keep_bytes, time_point_t cutoff)
+        {
+            std::vector<U8*> released;
+            S64 released_bytes = 0;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                while (true)
+                {
+                    S32 oldest = -1;
+                    for (S32 i = 0; i < CLASS_COUNT; ++i)
+                    {
+                        if (!mFree[i].empty() && (oldest < 0 || mFree[i].front().mTime < mFree[oldest].front().mTime))
+                        {
+                            oldest = i;
+                        }
+                    }
+                    if (oldest < 0 || (mBytes <= keep_bytes && mFree[oldest].front().mTime >= cutoff))
+                    {
+                        break;
+                    }
+                    released.push_back(mFree[oldest].front().mData);
+                    mFree[oldest].pop_front();
+                    mBytes -= class_size(oldest);
+                    released_bytes += class_size(oldest);
+                }
+            }
+            for (U8* data : released)
+            {
+                ll_aligned_free_16(data);
+            }
+            sCachedBytes -= released_bytes;
+            sReleasedBytes += released_bytes;
+        }
+    };
+
+    // Never destroyed, images may be freed from static destructors and
+    // exiting threads after this file's statics are gone
+    SharedPool& shared_pool()
+    {
+        static SharedPool* pool = new SharedPool;
+        return *pool;
+    }
+
+    struct ThreadCache
+    {
+        std::vector<U8*> mFree[CLASS_COUNT];
+        S64 mBytes = 0;
+        U32 mGeneration = 0;
+
+        ~ThreadCache()
+        {
+            release();
+        }
+
+        void release()
+        {
+            for (S32 i = 0; i < CLASS_COUNT; ++i)
+            {
+                for (U8* data : mFree[i])
+                {
+                    ll_aligned_free_16(data);
+                }
+                mFree[i].clear();
+            }
+            sCachedBytes -= mBytes;
+            sReleasedBytes += mBytes;
+            mBytes = 0;
+        }
+
+        // Drops everything if trim() was called since the last use
+        void checkTrim()
+        {
+            U32 generation = sTrimGeneration.load(std::memory_order_relaxed);
+            if (generation != mGeneration)
+            {
+                mGeneration = generation;
+                release();
+            }
+        }
+    };
+
+    thread_local ThreadCache sThreadCache;
+}
+
+//static
+U8* LLImageBufferPool::allocate(S32 size)
+{
+    S32 index = size_class(size);
+    if (index < 0 || sMaxBytes.load(std::memory_order_relaxed) <= 0)
+    {
+        return (U8*)ll_aligned_malloc_16(size);
+    }
+
+    if (size <= THREAD_CACHE_MAX_SIZE)
+    {
+        ThreadCache& cache = sThreadCache;
+        cache.checkTrim();
+        if (!cache.mFree[index].empty())
+        {
+            U8* data = cache.mFree[index].back();
+            cache.mFree[index].pop_back();
+            cache.mBytes -= size;
+            sCachedBytes -= size;
+            ++sHits;
+            return data;
+        }
+    }
+
+    SharedPool& pool = shared_pool();
+    {
+        std::lock_guard<std::mutex> lock(pool.mMutex);
+        std::deque<SharedPool::Entry>& entries = pool.mFree[index];
+        if (!entries.empty())
+        {
+            U8* data = entries.back().mData;
+            entries.pop_back();
+            pool.mBytes -= size;
+            sCachedBytes -= size;
+            ++sHits;
+            return data;
+        }
+    }
+
+    ++sMisses;
+    return (U8*)ll_aligned_malloc_16(size);
+}
+
+//static
+void LLImageBufferPool::free(U8* data, S32 size)
+{
+    if (!data)
+    {
+        return;
+    }
+    S32 index = size_class(size);
+    S64 max_bytes = sMaxBytes.load(std::memory_order_relaxed);
+    if (index < 0 || max_bytes <= 0)
+    {
+        ll_aligned_free_16(data);
+        return;
+    }
+
+    if (size <= THREAD_CACHE_MAX_SIZE)
+    {
+        ThreadCache& cache = sThreadCache;
+        cache.checkTrim();
+        if (cache.mFree[index].size() < THREAD_CACHE_DEPTH && cache.mBytes + size <= THREAD_CACHE_BYTES)
+        {
+            cache.mFree[index].push_back(data);
+            cache.mBytes += size;
+            sCachedBytes += size;
+            return;
+        }
+    }
+
+    SharedPool& pool = shared_pool();
+    {
+        std::lock_guard<std::mutex> lock(pool.mMutex);
+        if (pool.mBytes + size <= max_bytes)
+        {
+            pool.mFree[index].push_back({ data, std::chrono::steady_clock::now() });
+            pool.mBytes += size;
+            sCachedBytes += size;
+            return;
+        }
+    }
+
+    // The shared pool is full
+    ll_aligned_free_16(data);
+}
+
+//static
+void LLImageBufferPool::setMaxBytes(S64 bytes)
+{
+    bytes = llmax(bytes, (S64)0);
+    sMaxBytes = bytes;
+    if (bytes == 0)
+    {
+        trim();
+    }
+    else
+    {
+        shared_pool().release(bytes, time_point_t::min());
+    }
+}
+
+//static
+S64 LLImageBufferPool::getMaxBytes()
+{
+    return sMaxBytes;
+}
+
+//static
+void LLImageBufferPool::update()
+{
+    shared_pool().release(sMaxBytes, std::chrono::steady_clock::now() - MAX_IDLE_TIME);
+}
+
+//static
+void LLImageBufferPool::trim()
+{
+    ++sTrimGeneration;
+    sThreadCache.checkTrim();
+    shared_pool().release(0, time_point_t::max());
+}
+
+//static
+bool LLImageBufferPool::isPooledSize(S32 size)
+{
+    return size_class(size) >= 0;
+}
+
+//static
+LLImageBufferPool::Stats LLImageBufferPool::getStats()
+{
+    Stats stats;
+    stats.mCachedBytes = sCachedBytes;
+    stats.mHits = sHits;
+    stats.mMisses = sMisses;
+    stats.mReleasedBytes = sReleasedBytes;
+    return stats;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file llimagebufferpool.h
+ * @brief Size-classed pool for image pixel buffers
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMAGEBUFFERPOOL_H
+#define LL_LLIMAGEBUFFERPOOL_H
+
+#include "stdtypes.h"
+
+// Recycles the buffers LLImageBase allocates for decodes, scales and
+// uploads, so that loading and dropping thousands of textures reuses the
+// same memory instead of fragmenting the heap.
+//
+// Only the sizes of power of two images are pooled: 2^n and 3 * 2^n bytes
+// from 3 KB to 16 MB, which covers 32x32 to 2048x2048 at any number of
+// components. Other sizes go straight to ll_aligned_malloc_16(). Buffers
+// are plain ll_aligned_malloc_16() blocks of exactly the requested size,
+// so a pooled buffer may be freed with ll_aligned_free_16() and any
+// ll_aligned_malloc_16() buffer may be handed to free().
+//
+// Each thread keeps a few small buffers of its own, the rest are shared
+// under a mutex. The pool is off until setMaxBytes() is called with a
+// non zero size.
+class LLImageBufferPool
+{
+public:
+    // Thread safe
+    static U8* allocate(S32 size);
+    static void free(U8* data, S32 size);
+
+    // Upper bound for the idle buffers in the shared pool, 0 to release
+    // them all and stop pooling. Each thread also holds up to 2 MB of
+    // small buffers of its own. Thread safe.
+    static void setMaxBytes(S64 bytes);
+    static S64 getMaxBytes();
+
+    // Releases buffers that have been idle for a while. Call periodically,
+    // from any one thread.
+    static void update();
+    // Releases every idle buffer, for when memory runs short. Other
+    // threads drop their own buffers the next time they use the pool.
+    static void trim();
+
+    static bool isPooledSize(S32 size);
+
+    struct Stats
+    {
+        S64 mCachedBytes = 0;   // idle buffers, ready for reuse
+        U64 mHits = 0;          // pooled sizes served from an idle buffer
+        U64 mMisses = 0;        // pooled sizes that had to be allocated
+        S64 mReleasedBytes = 0; // idle buffers released by update() or trim()
+    };
+    static Stats getStats();
+};
+
+#endif // LL_LLIMAGEBUFFERPOOL_H
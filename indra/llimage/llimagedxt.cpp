@@ -26,12 +26,13 @@
 #include "linden_common.h"
 
 #include "llimagedxt.h"
+#include "llimagemips.h"
 #include "llmemory.h"
 
 //static
 void LLImageDXT::checkMinWidthHeight(EFileFormat format, S32& width, S32& height)
 {
-    S32 mindim = (format >= FORMAT_DXT1 && format <= FORMAT_DXR5) ? 4 : 1;
+    S32 mindim = (format >= FORMAT_DXT1 && format <= FORMAT_BC7R) ? 4 : 1;
     width = llmax(width, mindim);
     height = llmax(height, mindim);
 }
@@ -49,6 +50,8 @@ S32 LLImageDXT::formatBits(EFileFormat format)
       case FORMAT_DXR3:     return 8;
       case FORMAT_DXR5:     return 8;
       case FORMAT_DXT5:     return 8;
+      case FORMAT_BC5R:     return 8;
+      case FORMAT_BC7R:     return 8;
       case FORMAT_RGB8:     return 24;
       case FORMAT_RGBA8:    return 32;
       default:
@@ -79,6 +82,8 @@ S32 LLImageDXT::formatComponents(EFileFormat format)
       case FORMAT_DXR3:     return 4;
       case FORMAT_DXT5:     return 4;
       case FORMAT_DXR5:     return 4;
+      case FORMAT_BC5R:     return 2;
+      case FORMAT_BC7R:     return 4;
       case FORMAT_RGB8:     return 3;
       case FORMAT_RGBA8:    return 4;
       default:
@@ -106,6 +111,8 @@ LLImageDXT::EFileFormat LLImageDXT::getFormat(S32 fourcc)
         case 0x33545844: return FORMAT_DXT3;
         case 0x34545844: return FORMAT_DXT4;
         case 0x35545844: return FORMAT_DXT5;
+        case 0x52354342: return FORMAT_BC5R;
+        case 0x52374342: return FORMAT_BC7R;
         default: return FORMAT_UNKNOWN;
     }
 }
@@ -129,10 +136,25 @@ S32 LLImageDXT::getFourCC(EFileFormat format)
         case FORMAT_DXT3: return 0x33545844;
         case FORMAT_DXT4: return 0x34545844;
         case FORMAT_DXT5: return 0x35545844;
+        case FORMAT_BC5R: return 0x52354342;
+        case FORMAT_BC7R: return 0x52374342;
         default: return 0x00000000;
     }
 }
 
+//static
+LLImageBC::EFormat LLImageDXT::getBlockFormat(EFileFormat format)
+{
+    switch(format)
+    {
+        case FORMAT_DXR1: return LLImageBC::FORMAT_BC1;
+        case FORMAT_DXR5: return LLImageBC::FORMAT_BC3;
+        case FORMAT_BC5R: return LLImageBC::FORMAT_BC5;
+        case FORMAT_BC7R: return LLImageBC::FORMAT_BC7;
+        default: return LLImageBC::FORMAT_COUNT;
+    }
+}
+
 //static
 void LLImageDXT::calcDiscardWidthHeight(S32 discard_level, EFileFormat format, S32& width, S32& height)
 {
@@ -259,7 +281,7 @@ bool LLImageDXT::decode(LLImageRaw* raw_image, F32 time)
     //  but we don't use it any more!
     llassert_always(raw_image);
 
-    if (mFileFormat >= FORMAT_DXT1 && mFileFormat <= FORMAT_DXR5)
+    if (isCompressed())
     {
         LL_WARNS() << "Attempt to decode compressed LLImageDXT to Raw (unsupported)" << LL_ENDL;
         return false;
@@ -404,6 +426,93 @@ bool LLImageDXT::encode(const LLImageRaw* raw_image, F32 time)
     return encodeDXT(raw_image, time, false);
 }
 
+bool LLImageDXT::encodeCompressed(const LLImageRaw* raw_image, EFileFormat format, LLImageBC::EQuality quality)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    llassert_always(raw_image);
+    resetLastError();
+
+    LLImageBC::EFormat block_format = getBlockFormat(format);
+    if (block_format == LLImageBC::FORMAT_COUNT)
+    {
+        setLastError("LLImageDXT::encodeCompressed: not a block compressed format");
+        return false;
+    }
+
+    // formatBytes() sizes levels by bits per pixel, which only matches the
+    // block count when every level is a whole number of blocks or fits in one
+    S32 width = raw_image->getWidth();
+    S32 height = raw_image->getHeight();
+    if (width <= 0 || height <= 0 || (width & (width - 1)) || (height & (height - 1)))
+    {
+        setLastError("LLImageDXT::encodeCompressed: dimensions must be powers of two");
+        return false;
+    }
+
+    S32 nmips = calcNumMips(width, height);
+    LLImageMipChain::Params params;
+    params.mMaxLevels = nmips;
+    if (format == FORMAT_BC5R)
+    {
+        // Normal maps and other data, not colors
+        params.mSRGB = false;
+        params.mPreserveAlphaCoverage = false;
+    }
+    LLPointer<LLImageMipChain> mips = new LLImageMipChain();
+    if (!mips->generate(raw_image, params))
+    {
+        setLastError("LLImageDXT::encodeCompressed: failed to build mips");
+        return false;
+    }
+
+    setSize(width, height, formatComponents(format));
+    mHeaderSize = sizeof(dxtfile_header_t);
+    mFileFormat = format;
+
+    S32 totbytes = mHeaderSize;
+    for (S32 mip = 0; mip < nmips; mip++)
+    {
+        totbytes += formatBytes(format, mips->getWidth(mip), mips->getHeight(mip));
+    }
+
+    if (!allocateData(totbytes))
+    {
+        setLastError("LLImageDXT::encodeCompressed: out of memory");
+        return false;
+    }
+
+    U8* data = getData();
+    dxtfile_header_t* header = (dxtfile_header_t*)data;
+    memset(header, 0, mHeaderSize);
+    header->fourcc = 0x20534444;
+    header->pixel_fmt.fourcc = getFourCC(format);
+    header->num_mips = nmips;
+    header->maxwidth = width;
+    header->maxheight = height;
+
+    for (S32 mip = 0; mip < nmips; mip++)
+    {
+        llassert(LLImageBC::levelBytes(block_format, mips->getWidth(mip), mips->getHeight(mip))
+                 == formatBytes(format, mips->getWidth(mip), mips->getHeight(mip)));
+        LLImageBC::compress(block_format, quality, mips->getLevelData(mip), mips->getWidth(mip), mips->getHeight(mip),
+                            mips->getComponents(), data + getMipOffset(mip));
+    }
+
+    return true;
+}
+
+//static
+LLPointer<LLImageDXT> LLImageDXT::createCompressed(const LLImageRaw* raw_image, EFileFormat format, LLImageBC::EQuality quality)
+{
+    LLPointer<LLImageDXT> compressed = new LLImageDXT();
+    if (!compressed->encodeCompressed(raw_image, format, quality))
+    {
+        LL_DEBUGS() << "LLImageDXT::createCompressed: failed to compress image" << LL_ENDL;
+        compressed = NULL;
+    }
+    return compressed;
+}
+
 // virtual
 bool LLImageDXT::convertToDXR()
 {
@@ -415,6 +524,8 @@ bool LLImageDXT::convertToDXR()
       case FORMAT_DXR3:
       case FORMAT_DXR4:
       case FORMAT_DXR5:
+      case FORMAT_BC5R:
+      case FORMAT_BC7R:
         return false; // nothing to do
       case FORMAT_DXT1: newformat = FORMAT_DXR1; break;
       case FORMAT_DXT2: newformat = FORMAT_DXR2; break;
@@ -27,6 +27,7 @@
 #define LL_LLIMAGEDXT_H
 
 #include "llimage.h"
+#include "llimagebc.h"
 #include "llpointer.h"
 
 // This class decodes and encodes LL DXT files (which may unclude uncompressed RGB or RGBA mipped data)
@@ -51,6 +52,8 @@ class LLImageDXT final : public LLImageFormatted
         FORMAT_DXR3,
         FORMAT_DXR4,
         FORMAT_DXR5,
+        FORMAT_BC5R,    // two channel RGTC2, reversed mips like DXR
+        FORMAT_BC7R,    // BPTC, reversed mips like DXR
         FORMAT_NOFILE = 0xff,
     };
 
@@ -104,6 +107,14 @@ class LLImageDXT final : public LLImageFormatted
     /*virtual*/ bool decode(LLImageRaw* raw_image, F32 decode_time);
     /*virtual*/ bool encode(const LLImageRaw* raw_image, F32 encode_time);
 
+    // Block compress a power of two image into one of the reversed mip
+    // formats (DXR1, DXR5, BC5R or BC7R), building the mips with
+    // LLImageMipChain. The result can be handed straight to
+    // LLImageGL::createGLTexture() or written out as is.
+    bool encodeCompressed(const LLImageRaw* raw_image, EFileFormat format, LLImageBC::EQuality quality);
+    // Same, into a new image. Null on failure.
+    static LLPointer<LLImageDXT> createCompressed(const LLImageRaw* raw_image, EFileFormat format, LLImageBC::EQuality quality);
+
     /*virtual*/ S32 calcHeaderSize();
     /*virtual*/ S32 calcDataSize(S32 discard_level = 0);
 
@@ -112,8 +123,8 @@ class LLImageDXT final : public LLImageFormatted
     void setFormat();
     S32 getMipOffset(S32 discard);
 
-    EFileFormat getFileFormat() { return mFileFormat; }
-    bool isCompressed() { return (mFileFormat >= FORMAT_DXT1 && mFileFormat <= FORMAT_DXR5); }
+    EFileFormat getFileFormat() const { return mFileFormat; }
+    bool isCompressed() { return (mFileFormat >= FORMAT_DXT1 && mFileFormat <= FORMAT_BC7R); }
 
     bool convertToDXR(); // convert from DXT to DXR
 
@@ -125,6 +136,8 @@ class LLImageDXT final : public LLImageFormatted
 
     static EFileFormat getFormat(S32 fourcc);
     static S32 getFourCC(EFileFormat format);
+    // Block format of a reversed mip format, FORMAT_COUNT if it isn't one
+    static LLImageBC::EFormat getBlockFormat(EFileFormat format);
 
     static void calcDiscardWidthHeight(S32 discard_level, EFileFormat format, S32& width, S32& height);
     static S32 calcNumMips(S32 width, S32 height);
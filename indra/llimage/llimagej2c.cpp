@@ -42,6 +42,10 @@ LLImageJ2CImpl* fallbackCreateLLImageJ2CImpl();
 LLImageCompressionTester* LLImageJ2C::sTesterp = NULL ;
 const std::string sTesterName("ImageCompressionTester");
 
+S32 LLImageJ2C::sDecodeThreadBudget = 0;
+S32 LLImageJ2C::sDecodeThreadMinArea = 0;
+std::atomic<S32> LLImageJ2C::sDecodeThreadsBusy(0);
+
 //static
 std::string LLImageJ2C::getEngineInfo()
 {
@@ -51,9 +55,44 @@ std::string LLImageJ2C::getEngineInfo()
     return impl->getEngineInfo();
 }
 
+//static
+void LLImageJ2C::setDecodeThreading(S32 budget, S32 min_area)
+{
+    sDecodeThreadBudget = budget;
+    sDecodeThreadMinArea = min_area;
+}
+
+// Every decode counts one busy thread.  Large images may take more,
+// up to whatever the budget has left over after the other decodes.
+//static
+S32 LLImageJ2C::acquireDecodeThreads(S32 area)
+{
+    S32 wanted = 1;
+    if (sDecodeThreadBudget > 1 && sDecodeThreadMinArea > 0 && area >= sDecodeThreadMinArea)
+    {
+        wanted = sDecodeThreadBudget;
+    }
+
+    S32 busy = sDecodeThreadsBusy.load();
+    S32 threads;
+    do
+    {
+        threads = llclamp(sDecodeThreadBudget - busy, 1, wanted);
+    }
+    while (!sDecodeThreadsBusy.compare_exchange_weak(busy, busy + threads));
+    return threads;
+}
+
+//static
+void LLImageJ2C::releaseDecodeThreads(S32 threads)
+{
+    sDecodeThreadsBusy -= threads;
+}
+
 LLImageJ2C::LLImageJ2C() :  LLImageFormatted(IMG_CODEC_J2C),
                             mMaxBytes(0),
                             mRawDiscardLevel(-1),
+                            mDecodeThreads(1),
                             mRate(DEFAULT_COMPRESSION_RATE),
                             mReversible(false),
                             mAreaUsedForDataSizeCalcs(0)
@@ -98,6 +137,26 @@ S8  LLImageJ2C::getRawDiscardLevel()
     return mRawDiscardLevel;
 }
 
+// virtual
+void LLImageJ2C::deleteData()
+{
+    if (mImpl)
+    {
+        mImpl->resetDecodeState();
+    }
+    LLImageFormatted::deleteData();
+}
+
+// virtual
+U8* LLImageJ2C::reallocateData(S32 size)
+{
+    if (mImpl)
+    {
+        mImpl->resetDecodeState();
+    }
+    return LLImageFormatted::reallocateData(size);
+}
+
 bool LLImageJ2C::updateData()
 {
     bool res = true;
@@ -131,7 +190,10 @@ bool LLImageJ2C::updateData()
 
 bool LLImageJ2C::initDecode(LLImageRaw &raw_image, int discard_level, int* region)
 {
-    setDiscardLevel(discard_level != -1 ? discard_level : 0);
+    if (discard_level != -1)
+    {
+        setDiscardLevel(discard_level);
+    }
     return mImpl->initDecode(*this,raw_image,discard_level,region);
 }
 
@@ -168,7 +230,11 @@ bool LLImageJ2C::decodeChannels(LLImageRaw *raw_imagep, F32 decode_time, S32 fir
         // Update the raw discard level
         updateRawDiscardLevel();
         mDecoding = true;
+        S32 reduce = llmax((S32)mRawDiscardLevel, 0);
+        mDecodeThreads = acquireDecodeThreads((getWidth() >> reduce) * (getHeight() >> reduce));
         res = mImpl->decodeImpl(*this, *raw_imagep, decode_time, first_channel, max_channel_count);
+        releaseDecodeThreads(mDecodeThreads);
+        mDecodeThreads = 1;
     }
 
     if (res)
@@ -31,6 +31,8 @@
 #include "llassettype.h"
 #include "llmetricperformancetester.h"
 
+#include <atomic>
+
 // JPEG2000 : compression rate used in j2c conversion.
 const F32 DEFAULT_COMPRESSION_RATE = 1.f/8.f;
 
@@ -55,10 +57,17 @@ class LLImageJ2C final : public LLImageFormatted
     /*virtual*/ S32 calcDataSize(S32 discard_level = 0);
     /*virtual*/ S32 calcDiscardLevelBytes(S32 bytes);
     /*virtual*/ S8  getRawDiscardLevel();
+    /*virtual*/ void deleteData();
+    /*virtual*/ U8* reallocateData(S32 size);
     // Override these so that we don't try to set a global variable from a DLL
     /*virtual*/ void resetLastError();
     /*virtual*/ void setLastError(const std::string& message, const std::string& filename = std::string());
 
+    // Restrict the next decode to a discard level (-1 leaves it) and a
+    // sub-rect, NULL for the whole image.  The region is x0, y0, x1, y1 in
+    // full resolution pixels with rows counted from the bottom as in
+    // LLImageRaw.  Channels still come from decodeChannels().  Returns
+    // false if the decoder can't restrict decodes.
     bool initDecode(LLImageRaw &raw_image, int discard_level, int* region);
     bool initEncode(LLImageRaw &raw_image, int blocks_size, int precincts_size, int levels);
 
@@ -78,6 +87,15 @@ class LLImageJ2C final : public LLImageFormatted
 
     static std::string getEngineInfo();
 
+    // Intra-image decode threading.  Images of at least min_area pixels
+    // (at the discard level being decoded) may use spare threads out of
+    // a budget shared by every concurrent decode, so that large textures
+    // finish sooner without oversubscribing the cores given to decoding.
+    // A budget of zero or less, or a min_area of zero, disables it.
+    static void setDecodeThreading(S32 budget, S32 min_area);
+    // Threads the decoder may use for the decode in progress
+    S32 getDecodeThreads() const { return mDecodeThreads; }
+
 protected:
     friend class LLImageJ2CImpl;
     friend class LLImageJ2COJ;
@@ -92,6 +110,7 @@ class LLImageJ2C final : public LLImageFormatted
     U32 mAreaUsedForDataSizeCalcs;              // Height * width used to calculate mDataSizes
 
     S8  mRawDiscardLevel;
+    S32 mDecodeThreads;
     F32 mRate;
     bool mReversible;
     std::unique_ptr<LLImageJ2CImpl> mImpl;
@@ -99,6 +118,13 @@ class LLImageJ2C final : public LLImageFormatted
 
     // Image compression/decompression tester
     static LLImageCompressionTester* sTesterp;
+
+    static S32 acquireDecodeThreads(S32 area);
+    static void releaseDecodeThreads(S32 threads);
+
+    static S32 sDecodeThreadBudget;
+    static S32 sDecodeThreadMinArea;
+    static std::atomic<S32> sDecodeThreadsBusy;
 };
 
 // Derive from this class to implement JPEG2000 decoding
@@ -125,6 +151,9 @@ class LLImageJ2CImpl
     virtual bool initEncode(LLImageJ2C &base, LLImageRaw &raw_image, int blocks_size = -1, int precincts_size = -1, int levels = 0) = 0;
 
     virtual std::string getEngineInfo() const = 0;
+    // Drop any state kept from previous decodes, called whenever the
+    // codestream data is replaced or freed.
+    virtual void resetDecodeState() {}
 
     friend class LLImageJ2C;
 };
@@ -0,0 +1,514 @@
+/**
+ * @file llimagemips.cpp
+ * @brief Filtered mip chains for LLImageRaw
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llimagemips.h"
+
+#include "llimage.h"
+#include "llmath.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Filter shapes, in units of destination pixels. Kaiser parameters
+    // are the usual ones for mip generation (as in NVTT).
+    const F32 KAISER_WIDTH = 3.f;
+    const F32 KAISER_ALPHA = 4.f;
+    const F32 LANCZOS_LOBES = 3.f;
+
+    // Binary search steps when matching alpha coverage, and the largest
+    // alpha scale tried
+    const S32 COVERAGE_STEPS = 10;
+    const F32 COVERAGE_MAX_SCALE = 4.f;
+
+    F32 sinc(F32 x)
+    {
+        if (fabsf(x) < 1.e-4f)
+        {
+            return 1.f;
+        }
+        x *= F_PI;
+        return sinf(x) / x;
+    }
+
+    // Modified Bessel function of the first kind, order 0
+    F32 bessel_i0(F32 x)
+    {
+        F32 sum = 1.f;
+        F32 term = 1.f;
+        F32 half_x_sq = x * x * 0.25f;
+        for (S32 k = 1; k < 32 && term > sum * 1.e-7f; ++k)
+        {
+            term *= half_x_sq / F32(k * k);
+            sum += term;
+        }
+        return sum;
+    }
+
+    F32 filter_support(LLImageMipChain::EFilter filter)
+    {
+        switch (filter)
+        {
+        case LLImageMipChain::FILTER_KAISER:
+            return KAISER_WIDTH;
+        case LLImageMipChain::FILTER_LANCZOS:
+            return LANCZOS_LOBES;
+        default:
+            return 0.5f;
+        }
+    }
+
+    F32 filter_weight(LLImageMipChain::EFilter filter, F32 x)
+    {
+        x = fabsf(x);
+        switch (filter)
+        {
+        case LLImageMipChain::FILTER_KAISER:
+            if (x >= KAISER_WIDTH)
+            {
+                return 0.f;
+            }
+            {
+                F32 t = x / KAISER_WIDTH;
+                return sinc(x) * bessel_i0(KAISER_ALPHA * sqrtf(1.f - t * t)) / bessel_i0(KAISER_ALPHA);
+            }
+        case LLImageMipChain::FILTER_LANCZOS:
+            return x < LANCZOS_LOBES ? sinc(x) * sinc(x / LANCZOS_LOBES) : 0.f;
+        default:
+            return x <= 0.5f ? 1.f : 0.f;
+        }
+    }
+
+    // Normalized weights and source indices for resampling one dimension
+    // from in_len to out_len samples
+    struct FilterTaps
+    {
+        FilterTaps(LLImageMipChain::EFilter filter, S32 in_len, S32 out_len, bool wrap)
+        {
+            F32 scale = (F32)in_len / (F32)out_len;
+            F32 support = filter_support(filter) * scale;
+            mCount = (S32)ceilf(support * 2.f) + 1;
+            mFirst.resize(out_len);
+            mIndex.resize(out_len * mCount);
+            mWeight.resize(out_len * mCount);
+
+            for (S32 out = 0; out < out_len; ++out)
+            {
+                F32 center = ((F32)out + 0.5f) * scale;
+                S32 first = (S32)floorf(center - support);
+                mFirst[out] = first;
+
+                F32 total = 0.f;
+                for (S32 k = 0; k < mCount; ++k)
+                {
+                    S32 in = first + k;
+                    F32 weight = filter_weight(filter, ((F32)in + 0.5f - center) / scale);
+                    mIndex[out * mCount + k] = wrap ? ((in % in_len) + in_len) % in_len : llclamp(in, 0, in_len - 1);
+                    mWeight[out * mCount + k] = weight;
+                    total += weight;
+                }
+                for (S32 k = 0; k < mCount; ++k)
+                {
+                    mWeight[out * mCount + k] /= total;
+                }
+            }
+        }
+
+        S32 mCount;
+        std::vector<S32> mFirst;    // unwrapped position of the first tap
+        std::vector<S32> mIndex;
+        std::vector<F32> mWeight;
+    };
+
+    // sRGB transfer functions. Decoding is a table lookup. Encoding
+    // compares against the linear values halfway between sRGB codes so
+    // that it rounds exactly, starting from a coarse table that leaves
+    // at most a couple of steps to walk.
+    class SRGBTables
+    {
+    public:
+        static const SRGBTables& instance()
+        {
+            static const SRGBTables tables;
+            return tables;
+        }
+
+        F32 toLinear(U8 value) const { return mToLinear[value]; }
+
+        // value in [0, 1]
+        U8 fromLinear(F32 value) const
+        {
+            S32 code = mStart[(S32)(value * (F32)(START_SIZE - 1))];
+            while (code < 255 && mThresholds[code] <= value)
+            {
+                ++code;
+            }
+            return (U8)code;
+        }
+
+    private:
+        SRGBTables()
+        {
+            for (S32 i = 0; i < 256; ++i)
+            {
+                mToLinear[i] = decode((F32)i / 255.f);
+            }
+            for (S32 i = 0; i < 255; ++i)
+            {
+                mThresholds[i] = decode(((F32)i + 0.5f) / 255.f);
+            }
+            for (S32 i = 0; i < START_SIZE; ++i)
+            {
+                F32 value = (F32)i / (F32)(START_SIZE - 1);
+                mStart[i] = (U8)(std::upper_bound(mThresholds, mThresholds + 255, value) - mThresholds);
+            }
+        }
+
+        static F32 decode(F32 c)
+        {
+            return c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+        }
+
+        static const S32 START_SIZE = 4096;
+
+        F32 mToLinear[256];
+        F32 mThresholds[255];
+        U8 mStart[START_SIZE];
+    };
+
+    // How texels are converted between bytes and the premultiplied
+    // linear floats the filter works on. Alpha is the last channel of
+    // two and four channel images.
+    template<S32 COMPONENTS>
+    struct PixelFormat
+    {
+        static const S32 ALPHA = (COMPONENTS == 2 || COMPONENTS == 4) ? COMPONENTS - 1 : -1;
+        static const S32 COLORS = ALPHA < 0 ? COMPONENTS : COMPONENTS - 1;
+
+        PixelFormat(bool srgb)
+        :   mSRGB(srgb ? &SRGBTables::instance() : NULL)
+        {
+        }
+
+        void unpack(const U8* in, F32* out, S32 pixels) const
+        {
+            for (S32 i = 0; i < pixels; ++i, in += COMPONENTS, out += COMPONENTS)
+            {
+                F32 alpha = 1.f;
+                if (ALPHA >= 0)
+                {
+                    alpha = (F32)in[ALPHA] * (1.f / 255.f);
+                    out[ALPHA] = alpha;
+                }
+                for (S32 c = 0; c < COLORS; ++c)
+                {
+                    out[c] = (mSRGB ? mSRGB->toLinear(in[c]) : (F32)in[c] * (1.f / 255.f)) * alpha;
+                }
+            }
+        }
+
+        void pack(const F32* in, U8* out, S32 pixels, F32 alpha_scale) const
+        {
+            for (S32 i = 0; i < pixels; ++i, in += COMPONENTS, out += COMPONENTS)
+            {
+                F32 inv_alpha = 1.f;
+                if (ALPHA >= 0)
+                {
+                    F32 alpha = in[ALPHA];
+                    inv_alpha = alpha > 0.f ? 1.f / alpha : 0.f;
+                    out[ALPHA] = (U8)ll_round(llclamp(alpha * alpha_scale, 0.f, 1.f) * 255.f);
+                }
+                for (S32 c = 0; c < COLORS; ++c)
+                {
+                    F32 value = llclamp(in[c] * inv_alpha, 0.f, 1.f);
+                    out[c] = mSRGB ? mSRGB->fromLinear(value) : (U8)ll_round(value * 255.f);
+                }
+            }
+        }
+
+        // Undo the overshoot of the sinc filters
+        void clamp(F32* data, S32 pixels) const
+        {
+            for (S32 i = 0; i < pixels; ++i, data += COMPONENTS)
+            {
+                F32 alpha = 1.f;
+                if (ALPHA >= 0)
+                {
+                    alpha = data[ALPHA] = llclamp(data[ALPHA], 0.f, 1.f);
+                }
+                for (S32 c = 0; c < COLORS; ++c)
+                {
+                    data[c] = llclamp(data[c], 0.f, alpha);
+                }
+            }
+        }
+
+        // threshold is the lowest alpha that rounds to a byte passing the test
+        static F32 coverage(const F32* data, S32 pixels, F32 threshold, F32 scale)
+        {
+            S32 count = 0;
+            for (S32 i = 0; i < pixels; ++i, data += COMPONENTS)
+            {
+                count += data[ALPHA] * scale >= threshold;
+            }
+            return (F32)count / (F32)pixels;
+        }
+
+        // Alpha scale making the share of texels above the cutoff closest to target
+        static F32 matchCoverage(const F32* data, S32 pixels, F32 threshold, F32 target)
+        {
+            F32 best_scale = 1.f;
+            F32 best_error = fabsf(coverage(data, pixels, threshold, 1.f) - target);
+            F32 low = 0.f;
+            F32 high = COVERAGE_MAX_SCALE;
+            for (S32 step = 0; step < COVERAGE_STEPS && best_error > 0.f; ++step)
+            {
+                F32 scale = (low + high) * 0.5f;
+                F32 result = coverage(data, pixels, threshold, scale);
+                if (result < target)
+                {
+                    low = scale;
+                }
+                else
+                {
+                    high = scale;
+                }
+                if (fabsf(result - target) < best_error)
+                {
+                    best_error = fabsf(result - target);
+                    best_scale = scale;
+                }
+            }
+            return best_scale;
+        }
+
+        const SRGBTables* mSRGB;
+    };
+
+    template<S32 COMPONENTS>
+    void filter_row(const FilterTaps& taps, const F32* in, F32* out, S32 out_len)
+    {
+        const S32* index = taps.mIndex.data();
+        const F32* weight = taps.mWeight.data();
+        for (S32 x = 0; x < out_len; ++x, out += COMPONENTS)
+        {
+            F32 sum[COMPONENTS] = {};
+            for (S32 k = 0; k < taps.mCount; ++k, ++index, ++weight)
+            {
+                const F32* texel = in + *index * COMPONENTS;
+                for (S32 c = 0; c < COMPONENTS; ++c)
+                {
+                    sum[c] += *weight * texel[c];
+                }
+            }
+            for (S32 c = 0; c < COMPONENTS; ++c)
+            {
+                out[c] = sum[c];
+            }
+        }
+    }
+
+    // Fill levels 1 and up of a chain whose level n is stored at
+    // chain + offsets[n]
+    template<S32 COMPONENTS>
+    void build_levels(const U8* data, S32 width, S32 height, S32 levels,
+                      U8* chain, const size_t* offsets, const LLImageMipChain::Params& params)
+    {
+        typedef PixelFormat<COMPONENTS> format_t;
+        format_t format(params.mSRGB);
+        LLImageMipChain::EFilter filter = (LLImageMipChain::EFilter)llclamp((S32)params.mFilter, 0, LLImageMipChain::FILTER_COUNT - 1);
+
+        // Shaders compare the stored byte, alpha / 255 > cutoff
+        F32 alpha_threshold = ((F32)llfloor(llclamp(params.mAlphaCutoff, 0.f, 1.f) * 255.f) + 0.5f) / 255.f;
+        F32 target_coverage = -1.f;
+        if (format_t::ALPHA >= 0 && params.mPreserveAlphaCoverage)
+        {
+            S32 count = 0;
+            const U8* alpha = data + format_t::ALPHA;
+            for (S32 i = 0; i < width * height; ++i, alpha += COMPONENTS)
+            {
+                count += (F32)*alpha / 255.f >= alpha_threshold;
+            }
+            if (count > 0 && count < width * height)
+            {
+                target_coverage = (F32)count / (F32)(width * height);
+            }
+        }
+
+        // Each level is filtered from the float version of the one above,
+        // rows first. Filtered rows are kept in a ring with a slot per
+        // vertical tap, so every source row is filtered horizontally once
+        // (bar the edges) without holding a whole intermediate image.
+        std::vector<F32> src;
+        std::vector<F32> dst;
+        std::vector<F32> row(width * COMPONENTS);
+        std::vector<F32> ring;
+        std::vector<S32> ring_rows;
+        for (S32 level = 1; level < levels; ++level)
+        {
+            S32 src_width = llmax(1, width >> (level - 1));
+            S32 src_height = llmax(1, height >> (level - 1));
+            S32 dst_width = llmax(1, width >> level);
+            S32 dst_height = llmax(1, height >> level);
+            S32 dst_row_len = dst_width * COMPONENTS;
+
+            FilterTaps horizontal(filter, src_width, dst_width, params.mWrap);
+            FilterTaps vertical(filter, src_height, dst_height, params.mWrap);
+            ring.resize(vertical.mCount * dst_row_len);
+            ring_rows.assign(vertical.mCount, -1);
+            dst.resize(dst_height * dst_row_len);
+
+            for (S32 y = 0; y < dst_height; ++y)
+            {
+                F32* out = dst.data() + y * dst_row_len;
+                std::fill(out, out + dst_row_len, 0.f);
+                for (S32 k = 0; k < vertical.mCount; ++k)
+                {
+                    S32 src_y = vertical.mIndex[y * vertical.mCount + k];
+                    S32 slot = ((vertical.mFirst[y] + k) % vertical.mCount + vertical.mCount) % vertical.mCount;
+                    F32* filtered = ring.data() + slot * dst_row_len;
+                    if (ring_rows[slot] != src_y)
+                    {
+                        const F32* in;
+                        if (level == 1)
+                        {
+                            format.unpack(data + src_y * width * COMPONENTS, row.data(), width);
+                            in = row.data();
+                        }
+                        else
+                        {
+                            in = src.data() + src_y * src_width * COMPONENTS;
+                        }
+                        filter_row<COMPONENTS>(horizontal, in, filtered, dst_width);
+                        ring_rows[slot] = src_y;
+                    }
+
+                    F32 weight = vertical.mWeight[y * vertical.mCount + k];
+                    for (S32 i = 0; i < dst_row_len; ++i)
+                    {
+                        out[i] += weight * filtered[i];
+                    }
+                }
+            }
+            format.clamp(dst.data(), dst_width * dst_height);
+
+            F32 alpha_scale = 1.f;
+            if (target_coverage >= 0.f)
+            {
+                alpha_scale = format_t::matchCoverage(dst.data(), dst_width * dst_height, alpha_threshold, target_coverage);
+            }
+            // Later levels are filtered from the unscaled alpha so that the
+            // corrections don't compound
+            format.pack(dst.data(), chain + offsets[level], dst_width * dst_height, alpha_scale);
+
+            src.swap(dst);
+        }
+    }
+}
+
+bool LLImageMipChain::generate(const LLImageRaw* image, const Params& params)
+{
+    if (!image || image->isBufferInvalid())
+    {
+        clear();
+        return false;
+    }
+    return generate(image->getData(), image->getWidth(), image->getHeight(), image->getComponents(), params);
+}
+
+bool LLImageMipChain::generate(const U8* data, S32 width, S32 height, S32 components, const Params& params)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+
+    clear();
+    if (!data || width <= 0 || height <= 0 || components < 1 || components > 4)
+    {
+        return false;
+    }
+
+    S32 levels = 1;
+    while ((width >> levels) > 0 || (height >> levels) > 0)
+    {
+        ++levels;
+    }
+    if (params.mMaxLevels > 0)
+    {
+        levels = llmin(levels, params.mMaxLevels);
+    }
+
+    mWidth = width;
+    mHeight = height;
+    mComponents = components;
+
+    // Smaller levels go first
+    size_t total = 0;
+    mLevelOffsets.resize(levels);
+    for (S32 level = levels - 1; level >= 0; --level)
+    {
+        mLevelOffsets[level] = total;
+        total += getLevelSize(level);
+    }
+    try
+    {
+        mData.resize(total);
+    }
+    catch (const std::bad_alloc&)
+    {
+        LL_WARNS() << "Failed to allocate " << total << " bytes for the mip chain of a "
+                   << width << "x" << height << " image" << LL_ENDL;
+        clear();
+        return false;
+    }
+    memcpy(mData.data() + mLevelOffsets[0], data, width * height * components);
+
+    switch (components)
+    {
+    case 1:
+        build_levels<1>(data, width, height, levels, mData.data(), mLevelOffsets.data(), params);
+        break;
+    case 2:
+        build_levels<2>(data, width, height, levels, mData.data(), mLevelOffsets.data(), params);
+        break;
+    case 3:
+        build_levels<3>(data, width, height, levels, mData.data(), mLevelOffsets.data(), params);
+        break;
+    default:
+        build_levels<4>(data, width, height, levels, mData.data(), mLevelOffsets.data(), params);
+        break;
+    }
+    return true;
+}
+
+void LLImageMipChain::clear()
+{
+    mData.clear();
+    mLevelOffsets.clear();
+    mWidth = 0;
+    mHeight = 0;
+    mComponents = 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file llimagemips.h
+ * @brief Filtered mip chains for LLImageRaw
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMAGEMIPS_H
+#define LL_LLIMAGEMIPS_H
+
+#include "llrefcount.h"
+
+#include <vector>
+
+class LLImageRaw;
+
+// A complete mip chain built on the CPU, as an alternative to the box
+// filter of LLImageBase::generateMip() and to glGenerateMipmap().
+//
+// Each level is resampled from the one above it with a windowed sinc
+// (or box) filter. Colors are filtered in linear light and weighted by
+// alpha so that transparent texels don't darken their neighbours, and
+// the alpha of each level can be rescaled so that the share of texels
+// passing an alpha test stays what it was at full resolution, which
+// keeps alpha masked foliage and fences from thinning out with distance.
+//
+// The levels are stored the way LLImageGL::setImage() wants them when
+// called with data_hasmips: smallest level first, full resolution last,
+// each level padded to 4 bytes like LLImageGL::dataFormatBytes(). Level
+// n is max(1, width >> n) by max(1, height >> n) pixels.
+//
+// Generation only reads the source image and touches nothing global,
+// so chains can be built on any thread, see LLImageDecodeThread::generateMips().
+class LLImageMipChain : public LLThreadSafeRefCount
+{
+public:
+    enum EFilter
+    {
+        FILTER_BOX = 0,     // 2x2 average, same as generateMip() but gamma correct
+        FILTER_KAISER,      // Kaiser windowed sinc, sharp with little ringing
+        FILTER_LANCZOS,     // Lanczos 3, sharpest
+        FILTER_COUNT
+    };
+
+    struct Params
+    {
+        EFilter mFilter = FILTER_KAISER;
+        // Color channels hold sRGB values, filter them in linear light.
+        // Turn off for normal maps and other data textures.
+        bool mSRGB = true;
+        // Sample across the edges as GL_REPEAT does rather than clamping.
+        bool mWrap = true;
+        // Keep the fraction of texels with alpha above mAlphaCutoff
+        // constant across levels. Ignored for images without alpha or
+        // whose alpha is entirely above or below the cutoff.
+        bool mPreserveAlphaCoverage = true;
+        F32 mAlphaCutoff = 0.5f;
+        // Stop after this many levels including the full resolution one,
+        // 0 for a full chain down to 1x1.
+        S32 mMaxLevels = 0;
+    };
+
+    LLImageMipChain() = default;
+
+    bool generate(const LLImageRaw* image, const Params& params);
+    // components is 1 to 4, rows are tightly packed
+    bool generate(const U8* data, S32 width, S32 height, S32 components, const Params& params);
+    void clear();
+
+    bool isEmpty() const { return mLevelOffsets.empty(); }
+    S32 getLevelCount() const { return (S32)mLevelOffsets.size(); }
+    S32 getWidth(S32 level = 0) const { return llmax(1, mWidth >> level); }
+    S32 getHeight(S32 level = 0) const { return llmax(1, mHeight >> level); }
+    S32 getComponents() const { return mComponents; }
+
+    const U8* getLevelData(S32 level) const { return mData.data() + mLevelOffsets[level]; }
+    S32 getLevelSize(S32 level) const { return levelBytes(getWidth(level), getHeight(level), mComponents); }
+    // Whole chain, starting with the smallest level
+    const U8* getData() const { return mData.data(); }
+    size_t getDataSize() const { return mData.size(); }
+
+    static S32 levelBytes(S32 width, S32 height, S32 components) { return (width * height * components + 3) & ~3; }
+
+protected:
+    ~LLImageMipChain() = default;
+
+private:
+    std::vector<U8> mData;
+    std::vector<size_t> mLevelOffsets;  // into mData, level 0 first
+    S32 mWidth = 0;
+    S32 mHeight = 0;
+    S32 mComponents = 0;
+};
+
+#endif // LL_LLIMAGEMIPS_H
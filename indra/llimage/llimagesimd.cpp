@@ -0,0 +1,1777 @@
+/**
+ * @file llimagesimd.cpp
+ * @brief Vectorized pixel kernels used by LLImageRaw
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llimagesimd.h"
+
+#include "llmath.h"
+
+#include <boost/preprocessor.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define LL_IMAGE_SIMD_SSE41 1
+#include <immintrin.h>
+#if defined(__x86_64__) || defined(_M_X64)
+#define LL_IMAGE_SIMD_AVX2 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define LL_IMAGE_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// GCC and clang only emit AVX2 instructions in functions that ask for
+// them unless the whole build uses -mavx2 (USE_AVX2). MSVC allows the
+// intrinsics anywhere.
+#if LL_IMAGE_SIMD_AVX2 && (defined(__GNUC__) || defined(__clang__))
+#define LL_TARGET_AVX2 __attribute__((target("avx2")))
+#define LL_TARGET_XSAVE __attribute__((target("xsave")))
+#else
+#define LL_TARGET_AVX2
+#define LL_TARGET_XSAVE
+#endif
+
+
+//..................................................................................
+//..................................................................................
+// Helper macrose's for generate cycle unwrap templates
+//..................................................................................
+#define _UNROL_GEN_TPL_arg_0(arg)
+#define _UNROL_GEN_TPL_arg_1(arg) arg
+
+#define _UNROL_GEN_TPL_comma_0
+#define _UNROL_GEN_TPL_comma_1 BOOST_PP_COMMA()
+//..................................................................................
+#define _UNROL_GEN_TPL_ARGS_macro(z,n,seq) \
+    BOOST_PP_CAT(_UNROL_GEN_TPL_arg_, BOOST_PP_MOD(n, 2))(BOOST_PP_SEQ_ELEM(n, seq)) BOOST_PP_CAT(_UNROL_GEN_TPL_comma_, BOOST_PP_AND(BOOST_PP_MOD(n, 2), BOOST_PP_NOT_EQUAL(BOOST_PP_INC(n), BOOST_PP_SEQ_SIZE(seq))))
+
+#define _UNROL_GEN_TPL_ARGS(seq) \
+    BOOST_PP_REPEAT(BOOST_PP_SEQ_SIZE(seq), _UNROL_GEN_TPL_ARGS_macro, seq)
+//..................................................................................
+
+#define _UNROL_GEN_TPL_TYPE_ARGS_macro(z,n,seq) \
+    BOOST_PP_SEQ_ELEM(n, seq) BOOST_PP_CAT(_UNROL_GEN_TPL_comma_, BOOST_PP_AND(BOOST_PP_MOD(n, 2), BOOST_PP_NOT_EQUAL(BOOST_PP_INC(n), BOOST_PP_SEQ_SIZE(seq))))
+
+#define _UNROL_GEN_TPL_TYPE_ARGS(seq) \
+    BOOST_PP_REPEAT(BOOST_PP_SEQ_SIZE(seq), _UNROL_GEN_TPL_TYPE_ARGS_macro, seq)
+//..................................................................................
+#define _UNROLL_GEN_TPL_foreach_ee(z, n, seq) \
+    executor<n>(_UNROL_GEN_TPL_ARGS(seq));
+
+#define _UNROLL_GEN_TPL(name, args_seq, operation, spec) \
+    template<> struct name<spec> { \
+    private: \
+        template<S32 _idx> inline void executor(_UNROL_GEN_TPL_TYPE_ARGS(args_seq)) { \
+            BOOST_PP_SEQ_ENUM(operation) ; \
+        } \
+    public: \
+        inline void operator()(_UNROL_GEN_TPL_TYPE_ARGS(args_seq)) { \
+            BOOST_PP_REPEAT(spec, _UNROLL_GEN_TPL_foreach_ee, args_seq) \
+        } \
+};
+//..................................................................................
+#define _UNROLL_GEN_TPL_foreach_seq_macro(r, data, elem) \
+    _UNROLL_GEN_TPL(BOOST_PP_SEQ_ELEM(0, data), BOOST_PP_SEQ_ELEM(1, data), BOOST_PP_SEQ_ELEM(2, data), elem)
+
+#define UNROLL_GEN_TPL(name, args_seq, operation, spec_seq) \
+    /*general specialization - should not be implemented!*/ \
+    template<U8> struct name { inline void operator()(_UNROL_GEN_TPL_TYPE_ARGS(args_seq)) { /*static_assert(!"Should not be instantiated.");*/  } }; \
+    BOOST_PP_SEQ_FOR_EACH(_UNROLL_GEN_TPL_foreach_seq_macro, (name)(args_seq)(operation), spec_seq)
+//..................................................................................
+//..................................................................................
+
+
+//..................................................................................
+// Generated unrolling loop templates with specializations
+//..................................................................................
+//example: for(c = 0; c < ch; ++c) comp[c] = cx[0] = 0;
+UNROLL_GEN_TPL(uroll_zeroze_cx_comp, (S32 *)(cx)(S32 *)(comp), (cx[_idx] = comp[_idx] = 0), (1)(3)(4));
+//example: for(c = 0; c < ch; ++c) comp[c] >>= 4;
+UNROLL_GEN_TPL(uroll_comp_rshftasgn_constval, (S32 *)(comp)(const S32)(cval), (comp[_idx] >>= cval), (1)(3)(4));
+//example: for(c = 0; c < ch; ++c) comp[c] = (cx[c] >> 5) * yap;
+UNROLL_GEN_TPL(uroll_comp_asgn_cx_rshft_cval_all_mul_val, (S32 *)(comp)(S32 *)(cx)(const S32)(cval)(S32)(val), (comp[_idx] = (cx[_idx] >> cval) * val), (1)(3)(4));
+//example: for(c = 0; c < ch; ++c) comp[c] += (cx[c] >> 5) * Cy;
+UNROLL_GEN_TPL(uroll_comp_plusasgn_cx_rshft_cval_all_mul_val, (S32 *)(comp)(S32 *)(cx)(const S32)(cval)(S32)(val), (comp[_idx] += (cx[_idx] >> cval) * val), (1)(3)(4));
+//example: for(c = 0; c < ch; ++c) comp[c] += pix[c] * info.xapoints[x];
+UNROLL_GEN_TPL(uroll_inp_plusasgn_pix_mul_val, (S32 *)(comp)(const U8 *)(pix)(S32)(val), (comp[_idx] += pix[_idx] * val), (1)(3)(4));
+//example: for(c = 0; c < ch; ++c) cx[c] = pix[c] * info.xapoints[x];
+UNROLL_GEN_TPL(uroll_inp_asgn_pix_mul_val, (S32 *)(comp)(const U8 *)(pix)(S32)(val), (comp[_idx] = pix[_idx] * val), (1)(3)(4));
+//example: for(c = 0; c < ch; ++c) comp[c] = ((cx[c] * info.yapoints[y]) + (comp[c] * (256 - info.yapoints[y]))) >> 16;
+UNROLL_GEN_TPL(uroll_comp_asgn_cx_mul_apoint_plus_comp_mul_inv_apoint_allshifted_16_r, (S32 *)(comp)(S32 *)(cx)(S32)(apoint), (comp[_idx] = ((cx[_idx] * apoint) + (comp[_idx] * (256 - apoint))) >> 16), (1)(3)(4));
+//example: for(c = 0; c < ch; ++c) comp[c] = (comp[c] + pix[c] * info.yapoints[y]) >> 8;
+UNROLL_GEN_TPL(uroll_comp_asgn_comp_plus_pix_mul_apoint_allshifted_8_r, (S32 *)(comp)(const U8 *)(pix)(S32)(apoint), (comp[_idx] = (comp[_idx] + pix[_idx] * apoint) >> 8), (1)(3)(4));
+//example: for(c = 0; c < ch; ++c) comp[c] = ((comp[c]*(256 - info.xapoints[x])) + ((cx[c] * info.xapoints[x]))) >> 12;
+UNROLL_GEN_TPL(uroll_comp_asgn_comp_mul_inv_apoint_plus_cx_mul_apoint_allshifted_12_r, (S32 *)(comp)(S32)(apoint)(S32 *)(cx), (comp[_idx] = ((comp[_idx] * (256-apoint)) + (cx[_idx] * apoint)) >> 12), (1)(3)(4));
+//example: for(c = 0; c < ch; ++c) *dptr++ = comp[c]&0xff;
+UNROLL_GEN_TPL(uroll_uref_dptr_inc_asgn_comp_and_ff, (U8 *&)(dptr)(S32 *)(comp), (*dptr++ = comp[_idx]&0xff), (1)(3)(4));
+//example: for(c = 0; c < ch; ++c) *dptr++ = (sptr[info.xpoints[x]*ch + c])&0xff;
+UNROLL_GEN_TPL(uroll_uref_dptr_inc_asgn_sptr_apoint_plus_idx_alland_ff, (U8 *&)(dptr)(const U8 *)(sptr)(S32)(apoint), (*dptr++ = sptr[apoint + _idx]&0xff), (1)(3)(4));
+//example: for(c = 0; c < ch; ++c) *dptr++ = (comp[c]>>10)&0xff;
+UNROLL_GEN_TPL(uroll_uref_dptr_inc_asgn_comp_rshft_cval_and_ff, (U8 *&)(dptr)(S32 *)(comp)(const S32)(cval), (*dptr++ = (comp[_idx]>>cval)&0xff), (1)(3)(4));
+//..................................................................................
+
+
+template<U8 ch>
+struct scale_info
+{
+public:
+    std::vector<S32> xpoints;
+    std::vector<const U8*> ystrides;
+    std::vector<S32> xapoints, yapoints;
+    S32 xup_yup;
+
+public:
+    //unrolling loop types declaration
+    typedef uroll_zeroze_cx_comp<ch>                                                        uroll_zeroze_cx_comp_t;
+    typedef uroll_comp_rshftasgn_constval<ch>                                               uroll_comp_rshftasgn_constval_t;
+    typedef uroll_comp_asgn_cx_rshft_cval_all_mul_val<ch>                                   uroll_comp_asgn_cx_rshft_cval_all_mul_val_t;
+    typedef uroll_comp_plusasgn_cx_rshft_cval_all_mul_val<ch>                               uroll_comp_plusasgn_cx_rshft_cval_all_mul_val_t;
+    typedef uroll_inp_plusasgn_pix_mul_val<ch>                                              uroll_inp_plusasgn_pix_mul_val_t;
+    typedef uroll_inp_asgn_pix_mul_val<ch>                                                  uroll_inp_asgn_pix_mul_val_t;
+    typedef uroll_comp_asgn_cx_mul_apoint_plus_comp_mul_inv_apoint_allshifted_16_r<ch>      uroll_comp_asgn_cx_mul_apoint_plus_comp_mul_inv_apoint_allshifted_16_r_t;
+    typedef uroll_comp_asgn_comp_plus_pix_mul_apoint_allshifted_8_r<ch>                     uroll_comp_asgn_comp_plus_pix_mul_apoint_allshifted_8_r_t;
+    typedef uroll_comp_asgn_comp_mul_inv_apoint_plus_cx_mul_apoint_allshifted_12_r<ch>      uroll_comp_asgn_comp_mul_inv_apoint_plus_cx_mul_apoint_allshifted_12_r_t;
+    typedef uroll_uref_dptr_inc_asgn_comp_and_ff<ch>                                        uroll_uref_dptr_inc_asgn_comp_and_ff_t;
+    typedef uroll_uref_dptr_inc_asgn_sptr_apoint_plus_idx_alland_ff<ch>                     uroll_uref_dptr_inc_asgn_sptr_apoint_plus_idx_alland_ff_t;
+    typedef uroll_uref_dptr_inc_asgn_comp_rshft_cval_and_ff<ch>                             uroll_uref_dptr_inc_asgn_comp_rshft_cval_and_ff_t;
+
+public:
+    scale_info(const U8 *src, U32 srcW, U32 srcH, U32 dstW, U32 dstH, U32 srcStride)
+        : xup_yup((dstW >= srcW) + ((dstH >= srcH) << 1))
+    {
+        calc_x_points(srcW, dstW);
+        calc_y_strides(src, srcStride, srcH, dstH);
+        calc_aa_points(srcW, dstW, xup_yup&1, xapoints);
+        calc_aa_points(srcH, dstH, xup_yup&2, yapoints);
+    }
+
+private:
+    //...........................................................................................
+    void calc_x_points(U32 srcW, U32 dstW)
+    {
+        xpoints.resize(dstW+1);
+
+        S32 val = dstW >= srcW ? 0x8000 * srcW / dstW - 0x8000 : 0;
+        S32 inc = (srcW << 16) / dstW;
+
+        for(U32 i = 0, j = 0; i < dstW; ++i, ++j, val += inc)
+        {
+            xpoints[j] = llmax(0, val >> 16);
+        }
+    }
+    //...........................................................................................
+    void calc_y_strides(const U8 *src, U32 srcStride, U32 srcH, U32 dstH)
+    {
+        ystrides.resize(dstH+1);
+
+        S32 val = dstH >= srcH ? 0x8000 * srcH / dstH - 0x8000 : 0;
+        S32 inc = (srcH << 16) / dstH;
+
+        for(U32 i = 0, j = 0; i < dstH; ++i, ++j, val += inc)
+        {
+            ystrides[j] = src + llmax(0, val >> 16) * srcStride;
+        }
+    }
+    //...........................................................................................
+    void calc_aa_points(U32 srcSz, U32 dstSz, bool scale_up, std::vector<S32> &vp)
+    {
+        vp.resize(dstSz);
+
+        if(scale_up)
+        {
+            S32 val = 0x8000 * srcSz / dstSz - 0x8000;
+            S32 inc = (srcSz << 16) / dstSz;
+            U32 pos;
+
+            for(U32 i = 0, j = 0; i < dstSz; ++i, ++j, val += inc)
+            {
+                pos = val >> 16;
+
+                if (pos >= (srcSz - 1))
+                    vp[j] = 0;
+                else
+                    vp[j] = (val >> 8) - ((val >> 8) & 0xffffff00);
+            }
+        }
+        else
+        {
+            S32 inc = (srcSz << 16) / dstSz;
+            S32 Cp = ((dstSz << 14) / srcSz) + 1;
+            S32 ap;
+
+            for(U32 i = 0, j = 0, val = 0; i < dstSz; ++i, ++j, val += inc)
+            {
+                ap = ((0x100 - ((val >> 8) & 0xff)) * Cp) >> 8;
+                vp[j] = ap | (Cp << 16);
+            }
+        }
+    }
+};
+
+
+template<U8 ch>
+inline void bilinear_scale(
+    const U8 *src, U32 srcW, U32 srcH, U32 srcStride
+    , U8 *dst, U32 dstW, U32 dstH, U32 dstStride
+    )
+{
+    typedef scale_info<ch> scale_info_t;
+
+    scale_info_t info(src, srcW, srcH, dstW, dstH, srcStride);
+
+    const U8 *sptr;
+    U8 *dptr;
+    U32 x, y;
+    const U8 *pix;
+
+    S32 cx[ch], comp[ch];
+
+
+    if(3 == info.xup_yup)
+    { //scale x/y - up
+        for(y = 0; y < dstH; ++y)
+        {
+            dptr = dst + (y * dstStride);
+            sptr = info.ystrides[y];
+
+            if(0 < info.yapoints[y])
+            {
+                for(x = 0; x < dstW; ++x)
+                {
+                    //for(c = 0; c < ch; ++c) cx[c] = comp[c] = 0;
+                    typename scale_info_t::uroll_zeroze_cx_comp_t()(cx, comp);
+
+                    if(0 < info.xapoints[x])
+                    {
+                        pix = info.ystrides[y] + info.xpoints[x] * ch;
+
+                        //for(c = 0; c < ch; ++c) comp[c] = pix[c] * (256 - info.xapoints[x]);
+                        typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(comp, pix, 256 - info.xapoints[x]);
+
+                        pix += ch;
+
+                        //for(c = 0; c < ch; ++c) comp[c] += pix[c] * info.xapoints[x];
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(comp, pix, info.xapoints[x]);
+
+                        pix += srcStride;
+
+                        //for(c = 0; c < ch; ++c) cx[c] = pix[c] * info.xapoints[x];
+                        typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(cx, pix, info.xapoints[x]);
+
+                        pix -= ch;
+
+                        //for(c = 0; c < ch; ++c) {
+                        //  cx[c] += pix[c] * (256 - info.xapoints[x]);
+                        //  comp[c] = ((cx[c] * info.yapoints[y]) + (comp[c] * (256 - info.yapoints[y]))) >> 16;
+                        //  *dptr++ = comp[c]&0xff;
+                        //}
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, 256 - info.xapoints[x]);
+                        typename scale_info_t::uroll_comp_asgn_cx_mul_apoint_plus_comp_mul_inv_apoint_allshifted_16_r_t()(comp, cx, info.yapoints[y]);
+                        typename scale_info_t::uroll_uref_dptr_inc_asgn_comp_and_ff_t()(dptr, comp);
+                    }
+                    else
+                    {
+                        pix = info.ystrides[y] + info.xpoints[x] * ch;
+
+                        //for(c = 0; c < ch; ++c) comp[c] = pix[c] * (256 - info.yapoints[y]);
+                        typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(comp, pix, 256-info.yapoints[y]);
+
+                        pix += srcStride;
+
+                        //for(c = 0; c < ch; ++c) {
+                        //  comp[c] = (comp[c] + pix[c] * info.yapoints[y]) >> 8;
+                        //  *dptr++ = comp[c]&0xff;
+                        //}
+                        typename scale_info_t::uroll_comp_asgn_comp_plus_pix_mul_apoint_allshifted_8_r_t()(comp, pix, info.yapoints[y]);
+                        typename scale_info_t::uroll_uref_dptr_inc_asgn_comp_and_ff_t()(dptr, comp);
+                    }
+                }
+            }
+            else
+            {
+                for(x = 0; x < dstW; ++x)
+                {
+                    if(0 < info.xapoints[x])
+                    {
+                        pix = info.ystrides[y] + info.xpoints[x] * ch;
+
+                        //for(c = 0; c < ch; ++c) {
+                        //  comp[c] = pix[c] * (256 - info.xapoints[x]);
+                        //  comp[c] = (comp[c] + pix[c] * info.xapoints[x]) >> 8;
+                        //  *dptr++ = comp[c]&0xff;
+                        //}
+                        typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(comp, pix, 256 - info.xapoints[x]);
+                        typename scale_info_t::uroll_comp_asgn_comp_plus_pix_mul_apoint_allshifted_8_r_t()(comp, pix, info.xapoints[x]);
+                        typename scale_info_t::uroll_uref_dptr_inc_asgn_comp_and_ff_t()(dptr, comp);
+                    }
+                    else
+                    {
+                        //for(c = 0; c < ch; ++c) *dptr++ = (sptr[info.xpoints[x]*ch + c])&0xff;
+                        typename scale_info_t::uroll_uref_dptr_inc_asgn_sptr_apoint_plus_idx_alland_ff_t()(dptr, sptr, info.xpoints[x]*ch);
+                    }
+                }
+            }
+        }
+    }
+    else if(info.xup_yup == 1)
+    { //scaling down vertically
+        S32 Cy, j;
+        S32 yap;
+
+        for(y = 0; y < dstH; y++)
+        {
+            Cy = info.yapoints[y] >> 16;
+            yap = info.yapoints[y] & 0xffff;
+
+            dptr = dst + (y * dstStride);
+
+            for(x = 0; x < dstW; x++)
+            {
+                pix = info.ystrides[y] + info.xpoints[x] * ch;
+
+                //for(c = 0; c < ch; ++c) comp[c] = pix[c] * yap;
+                typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(comp, pix, yap);
+
+                pix += srcStride;
+
+                for(j = (1 << 14) - yap; j > Cy; j -= Cy, pix += srcStride)
+                {
+                    //for(c = 0; c < ch; ++c) comp[c] += pix[c] * Cy;
+                    typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(comp, pix, Cy);
+                }
+
+                if(j > 0)
+                {
+                    //for(c = 0; c < ch; ++c) comp[c] += pix[c] * j;
+                    typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(comp, pix, j);
+                }
+
+                if(info.xapoints[x] > 0)
+                {
+                    pix = info.ystrides[y] + info.xpoints[x]*ch + ch;
+                    //for(c = 0; c < ch; ++c) cx[c] = pix[c] * yap;
+                    typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(cx, pix, yap);
+
+                    pix += srcStride;
+                    for(j = (1 << 14) - yap; j > Cy; j -= Cy)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * Cy;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, Cy);
+                        pix += srcStride;
+                    }
+
+                    if(j > 0)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * j;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, j);
+                    }
+
+                    //for(c = 0; c < ch; ++c) comp[c] = ((comp[c]*(256 - info.xapoints[x])) + ((cx[c] * info.xapoints[x]))) >> 12;
+                    typename scale_info_t::uroll_comp_asgn_comp_mul_inv_apoint_plus_cx_mul_apoint_allshifted_12_r_t()(comp, info.xapoints[x], cx);
+                }
+                else
+                {
+                    //for(c = 0; c < ch; ++c) comp[c] >>= 4;
+                    typename scale_info_t::uroll_comp_rshftasgn_constval_t()(comp, 4);
+                }
+
+                //for(c = 0; c < ch; ++c) *dptr++ = (comp[c]>>10)&0xff;
+                typename scale_info_t::uroll_uref_dptr_inc_asgn_comp_rshft_cval_and_ff_t()(dptr, comp, 10);
+            }
+        }
+    }
+    else if(info.xup_yup == 2)
+    { // scaling down horizontally
+        S32 Cx, j;
+        S32 xap;
+
+        for(y = 0; y < dstH; y++)
+        {
+            dptr = dst + (y * dstStride);
+
+            for(x = 0; x < dstW; x++)
+            {
+                Cx = info.xapoints[x] >> 16;
+                xap = info.xapoints[x] & 0xffff;
+
+                pix = info.ystrides[y] + info.xpoints[x] * ch;
+
+                //for(c = 0; c < ch; ++c) comp[c] = pix[c] * xap;
+                typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(comp, pix, xap);
+
+                pix+=ch;
+                for(j = (1 << 14) - xap; j > Cx; j -= Cx)
+                {
+                    //for(c = 0; c < ch; ++c) comp[c] += pix[c] * Cx;
+                    typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(comp, pix, Cx);
+                    pix+=ch;
+                }
+
+                if(j > 0)
+                {
+                    //for(c = 0; c < ch; ++c) comp[c] += pix[c] * j;
+                    typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(comp, pix, j);
+                }
+
+                if(info.yapoints[y] > 0)
+                {
+                    pix = info.ystrides[y] + info.xpoints[x]*ch + srcStride;
+                    //for(c = 0; c < ch; ++c) cx[c] = pix[c] * xap;
+                    typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(cx, pix, xap);
+
+                    pix+=ch;
+                    for(j = (1 << 14) - xap; j > Cx; j -= Cx)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * Cx;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, Cx);
+                        pix+=ch;
+                    }
+
+                    if(j > 0)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * j;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, j);
+                    }
+
+                    //for(c = 0; c < ch; ++c) comp[c] = ((comp[c] * (256 - info.yapoints[y])) + ((cx[c] * info.yapoints[y]))) >> 12;
+                    typename scale_info_t::uroll_comp_asgn_comp_mul_inv_apoint_plus_cx_mul_apoint_allshifted_12_r_t()(comp, info.yapoints[y], cx);
+                }
+                else
+                {
+                    //for(c = 0; c < ch; ++c) comp[c] >>= 4;
+                    typename scale_info_t::uroll_comp_rshftasgn_constval_t()(comp, 4);
+                }
+
+                //for(c = 0; c < ch; ++c) *dptr++ = (comp[c]>>10)&0xff;
+                typename scale_info_t::uroll_uref_dptr_inc_asgn_comp_rshft_cval_and_ff_t()(dptr, comp, 10);
+            }
+        }
+    }
+    else
+    { //scale x/y - down
+        S32 Cx, Cy, i, j;
+        S32 xap, yap;
+
+        for(y = 0; y < dstH; y++)
+        {
+            Cy = info.yapoints[y] >> 16;
+            yap = info.yapoints[y] & 0xffff;
+
+            dptr = dst + (y * dstStride);
+            for(x = 0; x < dstW; x++)
+            {
+                Cx = info.xapoints[x] >> 16;
+                xap = info.xapoints[x] & 0xffff;
+
+                sptr = info.ystrides[y] + info.xpoints[x] * ch;
+                pix = sptr;
+                sptr += srcStride;
+
+                //for(c = 0; c < ch; ++c) cx[c] = pix[c] * xap;
+                typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(cx, pix, xap);
+
+                pix+=ch;
+                for(i = (1 << 14) - xap; i > Cx; i -= Cx)
+                {
+                    //for(c = 0; c < ch; ++c) cx[c] += pix[c] * Cx;
+                    typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, Cx);
+                    pix+=ch;
+                }
+
+                if(i > 0)
+                {
+                    //for(c = 0; c < ch; ++c) cx[c] += pix[c] * i;
+                    typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, i);
+                }
+
+                //for(c = 0; c < ch; ++c) comp[c] = (cx[c] >> 5) * yap;
+                typename scale_info_t::uroll_comp_asgn_cx_rshft_cval_all_mul_val_t()(comp, cx, 5, yap);
+
+                for(j = (1 << 14) - yap; j > Cy; j -= Cy)
+                {
+                    pix = sptr;
+                    sptr += srcStride;
+
+                    //for(c = 0; c < ch; ++c) cx[c] = pix[c] * xap;
+                    typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(cx, pix, xap);
+
+                    pix+=ch;
+                    for(i = (1 << 14) - xap; i > Cx; i -= Cx)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * Cx;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, Cx);
+                        pix+=ch;
+                    }
+
+                    if(i > 0)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * i;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, i);
+                    }
+
+                    //for(c = 0; c < ch; ++c) comp[c] += (cx[c] >> 5) * Cy;
+                    typename scale_info_t::uroll_comp_plusasgn_cx_rshft_cval_all_mul_val_t()(comp, cx, 5, Cy);
+                }
+
+                if(j > 0)
+                {
+                    pix = sptr;
+                    sptr += srcStride;
+
+                    //for(c = 0; c < ch; ++c) cx[c] = pix[c] * xap;
+                    typename scale_info_t::uroll_inp_asgn_pix_mul_val_t()(cx, pix, xap);
+
+                    pix+=ch;
+                    for(i = (1 << 14) - xap; i > Cx; i -= Cx)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * Cx;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, Cx);
+                        pix+=ch;
+                    }
+
+                    if(i > 0)
+                    {
+                        //for(c = 0; c < ch; ++c) cx[c] += pix[c] * i;
+                        typename scale_info_t::uroll_inp_plusasgn_pix_mul_val_t()(cx, pix, i);
+                    }
+
+                    //for(c = 0; c < ch; ++c) comp[c] += (cx[c] >> 5) * j;
+                    typename scale_info_t::uroll_comp_plusasgn_cx_rshft_cval_all_mul_val_t()(comp, cx, 5, j);
+                }
+
+                //for(c = 0; c < ch; ++c) *dptr++ = (comp[c]>>23)&0xff;
+                typename scale_info_t::uroll_uref_dptr_inc_asgn_comp_rshft_cval_and_ff_t()(dptr, comp, 23);
+            }
+        }
+    } //else
+}
+
+//---------------------------------------------------------------------------
+// Scalar reference kernels
+//---------------------------------------------------------------------------
+
+namespace
+{
+    // Calculates (U8)(255*(a/255.f)*(b/255.f) + 0.5f).  Thanks, Jim Blinn!
+    inline U8 fast_fractional_mult(U8 a, U8 b)
+    {
+        U32 i = a * b + 128;
+        return U8((i + (i >> 8)) >> 8);
+    }
+
+    void flip_rows_scalar(U8* data, S32 row_bytes, S32 rows)
+    {
+        for (S32 row = 0; row < rows / 2; ++row)
+        {
+            U8* row_a = data + row * row_bytes;
+            U8* row_b = data + (rows - 1 - row) * row_bytes;
+            std::swap_ranges(row_a, row_a + row_bytes, row_b);
+        }
+    }
+
+    void copy_3onto4_scalar(const U8* src, U8* dst, S32 pixels)
+    {
+        for (S32 i = 0; i < pixels; ++i)
+        {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = 255;
+            src += 3;
+            dst += 4;
+        }
+    }
+
+    void copy_4onto3_scalar(const U8* src, U8* dst, S32 pixels)
+    {
+        for (S32 i = 0; i < pixels; ++i)
+        {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            src += 4;
+            dst += 3;
+        }
+    }
+
+    inline void composite_pixel(const U8* src, U8* dst)
+    {
+        U8 alpha = src[3];
+        if (alpha)
+        {
+            if (255 == alpha)
+            {
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+            }
+            else
+            {
+                U8 transparency = 255 - alpha;
+                dst[0] = fast_fractional_mult(dst[0], transparency) + fast_fractional_mult(src[0], alpha);
+                dst[1] = fast_fractional_mult(dst[1], transparency) + fast_fractional_mult(src[1], alpha);
+                dst[2] = fast_fractional_mult(dst[2], transparency) + fast_fractional_mult(src[2], alpha);
+            }
+        }
+    }
+
+    void composite_4onto3_scalar(const U8* src, U8* dst, S32 pixels)
+    {
+        for (S32 i = 0; i < pixels; ++i)
+        {
+            composite_pixel(src, dst);
+            src += 4;
+            dst += 3;
+        }
+    }
+
+    void copy_line_scaled_scalar(const U8* in, U8* out, S32 components, S32 in_pixel_len, S32 out_pixel_len, S32 in_pixel_step, S32 out_pixel_step)
+    {
+        const F32 ratio = F32(in_pixel_len) / out_pixel_len; // ratio of old to new
+        const F32 norm_factor = 1.f / ratio;
+
+        S32 goff = components >= 2 ? 1 : 0;
+        S32 boff = components >= 3 ? 2 : 0;
+        for( S32 x = 0; x < out_pixel_len; x++ )
+        {
+            // Sample input pixels in range from sample0 to sample1.
+            // Avoid floating point accumulation error... don't just add ratio each time.  JC
+            const F32 sample0 = x * ratio;
+            const F32 sample1 = (x+1) * ratio;
+            const S32 index0 = llfloor(sample0);            // left integer (floor)
+            const S32 index1 = llfloor(sample1);            // right integer (floor)
+            const F32 fract0 = 1.f - (sample0 - F32(index0));   // spill over on left
+            const F32 fract1 = sample1 - F32(index1);           // spill-over on right
+
+            if( index0 == index1 )
+            {
+                // Interval is embedded in one input pixel
+                memcpy(out + x * out_pixel_step * components, in + index0 * in_pixel_step * components, components);
+            }
+            else
+            {
+                // Left straddle
+                S32 t1 = index0 * in_pixel_step * components;
+                F32 r = in[t1 + 0] * fract0;
+                F32 g = in[t1 + goff] * fract0;
+                F32 b = in[t1 + boff] * fract0;
+                F32 a = 0;
+                if( components == 4)
+                {
+                    a = in[t1 + 3] * fract0;
+                }
+
+                // Central interval
+                for( S32 u = index0 + 1; u < index1; u++ )
+                {
+                    S32 t2 = u * in_pixel_step * components;
+                    r += in[t2 + 0];
+                    g += in[t2 + goff];
+                    b += in[t2 + boff];
+                    if (components == 4)
+                    {
+                        a += in[t2 + 3];
+                    }
+                }
+
+                // right straddle
+                // Watch out for reading off of end of input array.
+                if( fract1 && index1 < in_pixel_len )
+                {
+                    S32 t3 = index1 * in_pixel_step * components;
+                    r += in[t3 + 0] * fract1;
+                    g += in[t3 + goff] * fract1;
+                    b += in[t3 + boff] * fract1;
+                    if (components == 4)
+                    {
+                        a += in[t3 + 3] * fract1;
+                    }
+                }
+
+                r *= norm_factor;
+                g *= norm_factor;
+                b *= norm_factor;
+                a *= norm_factor;  // skip conditional
+
+                S32 t4 = x * out_pixel_step * components;
+                out[t4 + 0] = U8(ll_round(r));
+                if (components >= 2)
+                    out[t4 + 1] = U8(ll_round(g));
+                if (components >= 3)
+                    out[t4 + 2] = U8(ll_round(b));
+                if( components == 4)
+                    out[t4 + 3] = U8(ll_round(a));
+            }
+        }
+    }
+
+    void composite_row_scaled_4onto3_scalar(const U8* in, U8* out, S32 in_pixel_len, S32 out_pixel_len)
+    {
+        const S32 IN_COMPONENTS = 4;
+        const S32 OUT_COMPONENTS = 3;
+
+        const F32 ratio = F32(in_pixel_len) / out_pixel_len; // ratio of old to new
+        const F32 norm_factor = 1.f / ratio;
+
+        for( S32 x = 0; x < out_pixel_len; x++ )
+        {
+            // Sample input pixels in range from sample0 to sample1.
+            // Avoid floating point accumulation error... don't just add ratio each time.  JC
+            const F32 sample0 = x * ratio;
+            const F32 sample1 = (x+1) * ratio;
+            const S32 index0 = S32(sample0);            // left integer (floor)
+            const S32 index1 = S32(sample1);            // right integer (floor)
+            const F32 fract0 = 1.f - (sample0 - F32(index0));   // spill over on left
+            const F32 fract1 = sample1 - F32(index1);           // spill-over on right
+
+            U8 in_scaled[IN_COMPONENTS];
+
+            if( index0 == index1 )
+            {
+                // Interval is embedded in one input pixel
+                memcpy(in_scaled, in + index0 * IN_COMPONENTS, IN_COMPONENTS);
+            }
+            else
+            {
+                // Left straddle
+                S32 t1 = index0 * IN_COMPONENTS;
+                F32 r = in[t1 + 0] * fract0;
+                F32 g = in[t1 + 1] * fract0;
+                F32 b = in[t1 + 2] * fract0;
+                F32 a = in[t1 + 3] * fract0;
+
+                // Central interval
+                for( S32 u = index0 + 1; u < index1; u++ )
+                {
+                    S32 t2 = u * IN_COMPONENTS;
+                    r += in[t2 + 0];
+                    g += in[t2 + 1];
+                    b += in[t2 + 2];
+                    a += in[t2 + 3];
+                }
+
+                // right straddle
+                // Watch out for reading off of end of input array.
+                if( fract1 && index1 < in_pixel_len )
+                {
+                    S32 t3 = index1 * IN_COMPONENTS;
+                    r += in[t3 + 0] * fract1;
+                    g += in[t3 + 1] * fract1;
+                    b += in[t3 + 2] * fract1;
+                    a += in[t3 + 3] * fract1;
+                }
+
+                r *= norm_factor;
+                g *= norm_factor;
+                b *= norm_factor;
+                a *= norm_factor;
+
+                in_scaled[0] = U8(ll_round(r));
+                in_scaled[1] = U8(ll_round(g));
+                in_scaled[2] = U8(ll_round(b));
+                in_scaled[3] = U8(ll_round(a));
+            }
+
+            composite_pixel(in_scaled, out);
+            out += OUT_COMPONENTS;
+        }
+    }
+
+    void bilinear_scale_scalar(const U8 *src, U32 srcW, U32 srcH, U32 ch, U32 srcStride, U8 *dst, U32 dstW, U32 dstH, U32 dstStride)
+    {
+        switch(ch)
+        {
+        case 1:
+            bilinear_scale<1>(src, srcW, srcH, srcStride, dst, dstW, dstH, dstStride);
+            break;
+        case 3:
+            bilinear_scale<3>(src, srcW, srcH, srcStride, dst, dstW, dstH, dstStride);
+            break;
+        case 4:
+            bilinear_scale<4>(src, srcW, srcH, srcStride, dst, dstW, dstH, dstStride);
+            break;
+        default:
+            llassert(!"Implement if need");
+            break;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+// Per-pixel vector helpers
+//
+// A pixel of up to four channels is held one channel per lane, either as
+// S32 for the fixed point resampler or as F32 for the box filters. The
+// arithmetic mirrors the scalar code lane for lane so that the results
+// stay identical.
+//---------------------------------------------------------------------------
+
+#if LL_IMAGE_SIMD_SSE41 || LL_IMAGE_SIMD_NEON
+
+namespace
+{
+    inline U32 load_pixel_bits(const U8* p, S32 components)
+    {
+        U32 bits = 0;
+        memcpy(&bits, p, components);
+        return bits;
+    }
+
+#if LL_IMAGE_SIMD_SSE41
+    typedef __m128i pixel_i;
+    typedef __m128 pixel_f;
+
+    inline pixel_i load_pixel_i(const U8* p, S32 components)
+    {
+        return _mm_cvtepu8_epi32(_mm_cvtsi32_si128((S32)load_pixel_bits(p, components)));
+    }
+
+    inline pixel_i mul_i(pixel_i a, S32 v) { return _mm_mullo_epi32(a, _mm_set1_epi32(v)); }
+    inline pixel_i add_i(pixel_i a, pixel_i b) { return _mm_add_epi32(a, b); }
+    inline pixel_i shr_i(pixel_i a, S32 bits) { return _mm_sra_epi32(a, _mm_cvtsi32_si128(bits)); }
+
+    // Stores the low byte of each lane, like the scalar "& 0xff"
+    inline void store_pixel_i(U8* p, pixel_i a, S32 components)
+    {
+        a = _mm_and_si128(a, _mm_set1_epi32(0xff));
+        a = _mm_packus_epi32(a, a);
+        a = _mm_packus_epi16(a, a);
+        S32 bits = _mm_cvtsi128_si32(a);
+        memcpy(p, &bits, components);
+    }
+
+    inline pixel_f zero_f() { return _mm_setzero_ps(); }
+
+    inline pixel_f load_pixel_f(const U8* p, S32 components)
+    {
+        return _mm_cvtepi32_ps(load_pixel_i(p, components));
+    }
+
+    inline pixel_f mul_f(pixel_f a, F32 v) { return _mm_mul_ps(a, _mm_set1_ps(v)); }
+    inline pixel_f add_f(pixel_f a, pixel_f b) { return _mm_add_ps(a, b); }
+
+    // ll_round() of each lane
+    inline void store_pixel_f(U8* p, pixel_f a, S32 components)
+    {
+        pixel_i rounded = _mm_cvttps_epi32(_mm_floor_ps(_mm_add_ps(a, _mm_set1_ps(0.5f))));
+        store_pixel_i(p, rounded, components);
+    }
+#else
+    typedef int32x4_t pixel_i;
+    typedef float32x4_t pixel_f;
+
+    inline pixel_i load_pixel_i(const U8* p, S32 components)
+    {
+        uint8x8_t bytes = vreinterpret_u8_u32(vdup_n_u32(load_pixel_bits(p, components)));
+        return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(vmovl_u8(bytes))));
+    }
+
+    inline pixel_i mul_i(pixel_i a, S32 v) { return vmulq_n_s32(a, v); }
+    inline pixel_i add_i(pixel_i a, pixel_i b) { return vaddq_s32(a, b); }
+    inline pixel_i shr_i(pixel_i a, S32 bits) { return vshlq_s32(a, vdupq_n_s32(-bits)); }
+
+    inline void store_pixel_i(U8* p, pixel_i a, S32 components)
+    {
+        uint16x4_t words = vmovn_u32(vreinterpretq_u32_s32(vandq_s32(a, vdupq_n_s32(0xff))));
+        uint8x8_t bytes = vmovn_u16(vcombine_u16(words, words));
+        U32 bits = vget_lane_u32(vreinterpret_u32_u8(bytes), 0);
+        memcpy(p, &bits, components);
+    }
+
+    inline pixel_f zero_f() { return vdupq_n_f32(0.f); }
+
+    inline pixel_f load_pixel_f(const U8* p, S32 components)
+    {
+        return vcvtq_f32_s32(load_pixel_i(p, components));
+    }
+
+    inline pixel_f mul_f(pixel_f a, F32 v) { return vmulq_n_f32(a, v); }
+    inline pixel_f add_f(pixel_f a, pixel_f b) { return vaddq_f32(a, b); }
+
+    inline void store_pixel_f(U8* p, pixel_f a, S32 components)
+    {
+        pixel_i rounded = vcvtq_s32_f32(vrndmq_f32(vaddq_f32(a, vdupq_n_f32(0.5f))));
+        uint16x4_t words = vqmovun_s32(rounded);
+        uint8x8_t bytes = vqmovn_u16(vcombine_u16(words, words));
+        U32 bits = vget_lane_u32(vreinterpret_u32_u8(bytes), 0);
+        memcpy(p, &bits, components);
+    }
+#endif
+
+    //-----------------------------------------------------------------------
+    // Vector variants of the per-pixel kernels, shared by SSE4.1 and NEON
+    //-----------------------------------------------------------------------
+
+    void copy_line_scaled_vector(const U8* in, U8* out, S32 components, S32 in_pixel_len, S32 out_pixel_len, S32 in_pixel_step, S32 out_pixel_step)
+    {
+        const F32 ratio = F32(in_pixel_len) / out_pixel_len;
+        const F32 norm_factor = 1.f / ratio;
+        const S32 in_stride = in_pixel_step * components;
+
+        for (S32 x = 0; x < out_pixel_len; x++)
+        {
+            const F32 sample0 = x * ratio;
+            const F32 sample1 = (x + 1) * ratio;
+            const S32 index0 = llfloor(sample0);
+            const S32 index1 = llfloor(sample1);
+            const F32 fract0 = 1.f - (sample0 - F32(index0));
+            const F32 fract1 = sample1 - F32(index1);
+
+            U8* outp = out + x * out_pixel_step * components;
+            if (index0 == index1)
+            {
+                memcpy(outp, in + index0 * in_stride, components);
+                continue;
+            }
+
+            const U8* inp = in + index0 * in_stride;
+            pixel_f sum = mul_f(load_pixel_f(inp, components), fract0);
+            for (S32 u = index0 + 1; u < index1; u++)
+            {
+                inp += in_stride;
+                sum = add_f(sum, load_pixel_f(inp, components));
+            }
+            if (fract1 && index1 < in_pixel_len)
+            {
+                sum = add_f(sum, mul_f(load_pixel_f(in + index1 * in_stride, components), fract1));
+            }
+            store_pixel_f(outp, mul_f(sum, norm_factor), components);
+        }
+    }
+
+    void composite_row_scaled_4onto3_vector(const U8* in, U8* out, S32 in_pixel_len, S32 out_pixel_len)
+    {
+        const F32 ratio = F32(in_pixel_len) / out_pixel_len;
+        const F32 norm_factor = 1.f / ratio;
+
+        for (S32 x = 0; x < out_pixel_len; x++, out += 3)
+        {
+            const F32 sample0 = x * ratio;
+            const F32 sample1 = (x + 1) * ratio;
+            const S32 index0 = S32(sample0);
+            const S32 index1 = S32(sample1);
+            const F32 fract0 = 1.f - (sample0 - F32(index0));
+            const F32 fract1 = sample1 - F32(index1);
+
+            if (index0 == index1)
+            {
+                composite_pixel(in + index0 * 4, out);
+                continue;
+            }
+
+            const U8* inp = in + index0 * 4;
+            pixel_f sum = mul_f(load_pixel_f(inp, 4), fract0);
+            for (S32 u = index0 + 1; u < index1; u++)
+            {
+                inp += 4;
+                sum = add_f(sum, load_pixel_f(inp, 4));
+            }
+            if (fract1 && index1 < in_pixel_len)
+            {
+                sum = add_f(sum, mul_f(load_pixel_f(in + index1 * 4, 4), fract1));
+            }
+
+            U8 in_scaled[4];
+            store_pixel_f(in_scaled, mul_f(sum, norm_factor), 4);
+            composite_pixel(in_scaled, out);
+        }
+    }
+
+    // Same walk as bilinear_scale<ch>() above with the channel loops in lanes
+    template<U8 ch>
+    void bilinear_scale_vector(const U8 *src, U32 srcW, U32 srcH, U32 srcStride, U8 *dst, U32 dstW, U32 dstH, U32 dstStride)
+    {
+        scale_info<ch> info(src, srcW, srcH, dstW, dstH, srcStride);
+
+        U8 *dptr;
+        U32 x, y;
+        const U8 *pix;
+        pixel_i cx, comp;
+
+        if (3 == info.xup_yup)
+        { //scale x/y - up
+            for (y = 0; y < dstH; ++y)
+            {
+                dptr = dst + (y * dstStride);
+                const S32 yap = info.yapoints[y];
+
+                if (0 < yap)
+                {
+                    for (x = 0; x < dstW; ++x, dptr += ch)
+                    {
+                        const S32 xap = info.xapoints[x];
+                        pix = info.ystrides[y] + info.xpoints[x] * ch;
+                        if (0 < xap)
+                        {
+                            comp = add_i(mul_i(load_pixel_i(pix, ch), 256 - xap), mul_i(load_pixel_i(pix + ch, ch), xap));
+                            pix += srcStride;
+                            cx = add_i(mul_i(load_pixel_i(pix + ch, ch), xap), mul_i(load_pixel_i(pix, ch), 256 - xap));
+                            comp = shr_i(add_i(mul_i(cx, yap), mul_i(comp, 256 - yap)), 16);
+                        }
+                        else
+                        {
+                            comp = mul_i(load_pixel_i(pix, ch), 256 - yap);
+                            comp = shr_i(add_i(comp, mul_i(load_pixel_i(pix + srcStride, ch), yap)), 8);
+                        }
+                        store_pixel_i(dptr, comp, ch);
+                    }
+                }
+                else
+                {
+                    for (x = 0; x < dstW; ++x, dptr += ch)
+                    {
+                        const S32 xap = info.xapoints[x];
+                        pix = info.ystrides[y] + info.xpoints[x] * ch;
+                        if (0 < xap)
+                        {
+                            // Matches the scalar path, which weights the same pixel twice here
+                            pixel_i p = load_pixel_i(pix, ch);
+                            comp = shr_i(add_i(mul_i(p, 256 - xap), mul_i(p, xap)), 8);
+                            store_pixel_i(dptr, comp, ch);
+                        }
+                        else
+                        {
+                            memcpy(dptr, pix, ch);
+                        }
+                    }
+                }
+            }
+        }
+        else if (info.xup_yup == 1)
+        { //scaling down vertically
+            S32 Cy, j;
+            S32 yap;
+
+            for (y = 0; y < dstH; y++)
+            {
+                Cy = info.yapoints[y] >> 16;
+                yap = info.yapoints[y] & 0xffff;
+
+                dptr = dst + (y * dstStride);
+
+                for (x = 0; x < dstW; x++, dptr += ch)
+                {
+                    pix = info.ystrides[y] + info.xpoints[x] * ch;
+                    comp = mul_i(load_pixel_i(pix, ch), yap);
+                    pix += srcStride;
+                    for (j = (1 << 14) - yap; j > Cy; j -= Cy, pix += srcStride)
+                    {
+                        comp = add_i(comp, mul_i(load_pixel_i(pix, ch), Cy));
+                    }
+                    if (j > 0)
+                    {
+                        comp = add_i(comp, mul_i(load_pixel_i(pix, ch), j));
+                    }
+
+                    const S32 xap = info.xapoints[x];
+                    if (xap > 0)
+                    {
+                        pix = info.ystrides[y] + info.xpoints[x] * ch + ch;
+                        cx = mul_i(load_pixel_i(pix, ch), yap);
+                        pix += srcStride;
+                        for (j = (1 << 14) - yap; j > Cy; j -= Cy, pix += srcStride)
+                        {
+                            cx = add_i(cx, mul_i(load_pixel_i(pix, ch), Cy));
+                        }
+                        if (j > 0)
+                        {
+                            cx = add_i(cx, mul_i(load_pixel_i(pix, ch), j));
+                        }
+                        comp = shr_i(add_i(mul_i(comp, 256 - xap), mul_i(cx, xap)), 12);
+                    }
+                    else
+                    {
+                        comp = shr_i(comp, 4);
+                    }
+                    store_pixel_i(dptr, shr_i(comp, 10), ch);
+                }
+            }
+        }
+        else if (info.xup_yup == 2)
+        { // scaling down horizontally
+            S32 Cx, j;
+            S32 xap;
+
+            for (y = 0; y < dstH; y++)
+            {
+                dptr = dst + (y * dstStride);
+                const S32 yap = info.yapoints[y];
+
+                for (x = 0; x < dstW; x++, dptr += ch)
+                {
+                    Cx = info.xapoints[x] >> 16;
+                    xap = info.xapoints[x] & 0xffff;
+
+                    pix = info.ystrides[y] + info.xpoints[x] * ch;
+                    comp = mul_i(load_pixel_i(pix, ch), xap);
+                    pix += ch;
+                    for (j = (1 << 14) - xap; j > Cx; j -= Cx, pix += ch)
+                    {
+                        comp = add_i(comp, mul_i(load_pixel_i(pix, ch), Cx));
+                    }
+                    if (j > 0)
+                    {
+                        comp = add_i(comp, mul_i(load_pixel_i(pix, ch), j));
+                    }
+
+                    if (yap > 0)
+                    {
+                        pix = info.ystrides[y] + info.xpoints[x] * ch + srcStride;
+                        cx = mul_i(load_pixel_i(pix, ch), xap);
+                        pix += ch;
+                        for (j = (1 << 14) - xap; j > Cx; j -= Cx, pix += ch)
+                        {
+                            cx = add_i(cx, mul_i(load_pixel_i(pix, ch), Cx));
+                        }
+                        if (j > 0)
+                        {
+                            cx = add_i(cx, mul_i(load_pixel_i(pix, ch), j));
+                        }
+                        comp = shr_i(add_i(mul_i(comp, 256 - yap), mul_i(cx, yap)), 12);
+                    }
+                    else
+                    {
+                        comp = shr_i(comp, 4);
+                    }
+                    store_pixel_i(dptr, shr_i(comp, 10), ch);
+                }
+            }
+        }
+        else
+        { //scale x/y - down
+            S32 Cx, Cy, i, j;
+            S32 xap, yap;
+            const U8 *sptr;
+
+            for (y = 0; y < dstH; y++)
+            {
+                Cy = info.yapoints[y] >> 16;
+                yap = info.yapoints[y] & 0xffff;
+
+                dptr = dst + (y * dstStride);
+                for (x = 0; x < dstW; x++, dptr += ch)
+                {
+                    Cx = info.xapoints[x] >> 16;
+                    xap = info.xapoints[x] & 0xffff;
+
+                    sptr = info.ystrides[y] + info.xpoints[x] * ch;
+
+                    // One source row, weighted horizontally
+                    auto row_sum = [&](const U8* row) -> pixel_i
+                    {
+                        pixel_i sum = mul_i(load_pixel_i(row, ch), xap);
+                        row += ch;
+                        for (i = (1 << 14) - xap; i > Cx; i -= Cx, row += ch)
+                        {
+                            sum = add_i(sum, mul_i(load_pixel_i(row, ch), Cx));
+                        }
+                        if (i > 0)
+                        {
+                            sum = add_i(sum, mul_i(load_pixel_i(row, ch), i));
+                        }
+                        return sum;
+                    };
+
+                    comp = mul_i(shr_i(row_sum(sptr), 5), yap);
+                    sptr += srcStride;
+                    for (j = (1 << 14) - yap; j > Cy; j -= Cy, sptr += srcStride)
+                    {
+                        comp = add_i(comp, mul_i(shr_i(row_sum(sptr), 5), Cy));
+                    }
+                    if (j > 0)
+                    {
+                        comp = add_i(comp, mul_i(shr_i(row_sum(sptr), 5), j));
+                    }
+                    store_pixel_i(dptr, shr_i(comp, 23), ch);
+                }
+            }
+        }
+    }
+
+    void bilinear_scale_vector(const U8 *src, U32 srcW, U32 srcH, U32 ch, U32 srcStride, U8 *dst, U32 dstW, U32 dstH, U32 dstStride)
+    {
+        switch (ch)
+        {
+        case 3:
+            bilinear_scale_vector<3>(src, srcW, srcH, srcStride, dst, dstW, dstH, dstStride);
+            break;
+        case 4:
+            bilinear_scale_vector<4>(src, srcW, srcH, srcStride, dst, dstW, dstH, dstStride);
+            break;
+        default:
+            // A single channel does not fill a vector, the scalar version is as fast
+            bilinear_scale_scalar(src, srcW, srcH, ch, srcStride, dst, dstW, dstH, dstStride);
+            break;
+        }
+    }
+}
+
+#endif // LL_IMAGE_SIMD_SSE41 || LL_IMAGE_SIMD_NEON
+
+//---------------------------------------------------------------------------
+// SSE4.1 / AVX2 row kernels
+//---------------------------------------------------------------------------
+
+#if LL_IMAGE_SIMD_SSE41
+
+namespace
+{
+    inline S32 load_s32(const U8* p)
+    {
+        S32 bits;
+        memcpy(&bits, p, sizeof(bits));
+        return bits;
+    }
+
+    inline void store_s32(U8* p, S32 bits)
+    {
+        memcpy(p, &bits, sizeof(bits));
+    }
+
+    // RGB RGB RGB RGB -> RGB_ RGB_ RGB_ RGB_ and back
+    inline __m128i expand_3to4_mask() { return _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1); }
+    inline __m128i pack_4to3_mask() { return _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1); }
+
+    // Twelve bytes, without touching the next four
+    inline __m128i load_12(const U8* p)
+    {
+        return _mm_insert_epi32(_mm_loadl_epi64((const __m128i*)p), load_s32(p + 8), 2);
+    }
+
+    inline void store_12(U8* p, __m128i v)
+    {
+        _mm_storel_epi64((__m128i*)p, v);
+        store_s32(p + 8, _mm_extract_epi32(v, 2));
+    }
+
+    // Blend of two pixels held as eight 16 bit channels, bit exact with
+    // fast_fractional_mult(d, 255 - a) + fast_fractional_mult(s, a)
+    inline __m128i blend_epi16(__m128i s, __m128i d)
+    {
+        const __m128i bias = _mm_set1_epi16(128);
+        __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), a);
+        __m128i dt = _mm_add_epi16(_mm_mullo_epi16(d, inv), bias);
+        __m128i st = _mm_add_epi16(_mm_mullo_epi16(s, a), bias);
+        dt = _mm_srli_epi16(_mm_add_epi16(dt, _mm_srli_epi16(dt, 8)), 8);
+        st = _mm_srli_epi16(_mm_add_epi16(st, _mm_srli_epi16(st, 8)), 8);
+        // The scalar sum is truncated to a byte, not saturated
+        return _mm_and_si128(_mm_add_epi16(dt, st), _mm_set1_epi16(0xff));
+    }
+
+    void flip_rows_sse41(U8* data, S32 row_bytes, S32 rows)
+    {
+        for (S32 row = 0; row < rows / 2; ++row)
+        {
+            U8* row_a = data + row * row_bytes;
+            U8* row_b = data + (rows - 1 - row) * row_bytes;
+            S32 i = 0;
+            for (; i + 16 <= row_bytes; i += 16)
+            {
+                __m128i a = _mm_loadu_si128((const __m128i*)(row_a + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(row_b + i));
+                _mm_storeu_si128((__m128i*)(row_a + i), b);
+                _mm_storeu_si128((__m128i*)(row_b + i), a);
+            }
+            std::swap_ranges(row_a + i, row_a + row_bytes, row_b + i);
+        }
+    }
+
+    void copy_3onto4_sse41(const U8* src, U8* dst, S32 pixels)
+    {
+        const __m128i expand = expand_3to4_mask();
+        const __m128i alpha = _mm_set1_epi32((S32)0xff000000);
+        S32 i = 0;
+        // A 16 byte load covers five and a third pixels, stop while it stays in bounds
+        for (; i + 6 <= pixels; i += 4)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(src + i * 3));
+            _mm_storeu_si128((__m128i*)(dst + i * 4), _mm_or_si128(_mm_shuffle_epi8(v, expand), alpha));
+        }
+        copy_3onto4_scalar(src + i * 3, dst + i * 4, pixels - i);
+    }
+
+    void copy_4onto3_sse41(const U8* src, U8* dst, S32 pixels)
+    {
+        const __m128i pack = pack_4to3_mask();
+        S32 i = 0;
+        for (; i + 4 <= pixels; i += 4)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(src + i * 4));
+            store_12(dst + i * 3, _mm_shuffle_epi8(v, pack));
+        }
+        copy_4onto3_scalar(src + i * 4, dst + i * 3, pixels - i);
+    }
+
+    void composite_4onto3_sse41(const U8* src, U8* dst, S32 pixels)
+    {
+        const __m128i expand = expand_3to4_mask();
+        const __m128i pack = pack_4to3_mask();
+        const __m128i zero = _mm_setzero_si128();
+        S32 i = 0;
+        for (; i + 4 <= pixels; i += 4)
+        {
+            __m128i s = _mm_loadu_si128((const __m128i*)(src + i * 4));
+            __m128i d = _mm_shuffle_epi8(load_12(dst + i * 3), expand);
+            __m128i lo = blend_epi16(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero));
+            __m128i hi = blend_epi16(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero));
+            store_12(dst + i * 3, _mm_shuffle_epi8(_mm_packus_epi16(lo, hi), pack));
+        }
+        composite_4onto3_scalar(src + i * 4, dst + i * 3, pixels - i);
+    }
+}
+
+#endif // LL_IMAGE_SIMD_SSE41
+
+#if LL_IMAGE_SIMD_AVX2
+
+namespace
+{
+    LL_TARGET_AVX2 inline __m256i broadcast_mask(__m128i mask)
+    {
+        return _mm256_broadcastsi128_si256(mask);
+    }
+
+    // Same as blend_epi16() on two lanes of two pixels each
+    LL_TARGET_AVX2 inline __m256i blend_epi16_avx2(__m256i s, __m256i d)
+    {
+        const __m256i bias = _mm256_set1_epi16(128);
+        __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m256i inv = _mm256_sub_epi16(_mm256_set1_epi16(255), a);
+        __m256i dt = _mm256_add_epi16(_mm256_mullo_epi16(d, inv), bias);
+        __m256i st = _mm256_add_epi16(_mm256_mullo_epi16(s, a), bias);
+        dt = _mm256_srli_epi16(_mm256_add_epi16(dt, _mm256_srli_epi16(dt, 8)), 8);
+        st = _mm256_srli_epi16(_mm256_add_epi16(st, _mm256_srli_epi16(st, 8)), 8);
+        return _mm256_and_si256(_mm256_add_epi16(dt, st), _mm256_set1_epi16(0xff));
+    }
+
+    LL_TARGET_AVX2 void flip_rows_avx2(U8* data, S32 row_bytes, S32 rows)
+    {
+        for (S32 row = 0; row < rows / 2; ++row)
+        {
+            U8* row_a = data + row * row_bytes;
+            U8* row_b = data + (rows - 1 - row) * row_bytes;
+            S32 i = 0;
+            for (; i + 32 <= row_bytes; i += 32)
+            {
+                __m256i a = _mm256_loadu_si256((const __m256i*)(row_a + i));
+                __m256i b = _mm256_loadu_si256((const __m256i*)(row_b + i));
+                _mm256_storeu_si256((__m256i*)(row_a + i), b);
+                _mm256_storeu_si256((__m256i*)(row_b + i), a);
+            }
+            std::swap_ranges(row_a + i, row_a + row_bytes, row_b + i);
+        }
+    }
+
+    LL_TARGET_AVX2 void copy_3onto4_avx2(const U8* src, U8* dst, S32 pixels)
+    {
+        const __m256i expand = broadcast_mask(expand_3to4_mask());
+        const __m256i alpha = _mm256_set1_epi32((S32)0xff000000);
+        S32 i = 0;
+        // The second load ends 28 bytes in, a little past eight pixels
+        for (; i + 10 <= pixels; i += 8)
+        {
+            const U8* s = src + i * 3;
+            __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)s)),
+                                                _mm_loadu_si128((const __m128i*)(s + 12)), 1);
+            _mm256_storeu_si256((__m256i*)(dst + i * 4), _mm256_or_si256(_mm256_shuffle_epi8(v, expand), alpha));
+        }
+        copy_3onto4_sse41(src + i * 3, dst + i * 4, pixels - i);
+    }
+
+    LL_TARGET_AVX2 void copy_4onto3_avx2(const U8* src, U8* dst, S32 pixels)
+    {
+        const __m256i pack = broadcast_mask(pack_4to3_mask());
+        // Close the gap between the twelve useful bytes of each lane
+        const __m256i merge = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+        S32 i = 0;
+        for (; i + 8 <= pixels; i += 8)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(src + i * 4));
+            v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, pack), merge);
+            U8* d = dst + i * 3;
+            _mm_storeu_si128((__m128i*)d, _mm256_castsi256_si128(v));
+            _mm_storel_epi64((__m128i*)(d + 16), _mm256_extracti128_si256(v, 1));
+        }
+        copy_4onto3_sse41(src + i * 4, dst + i * 3, pixels - i);
+    }
+
+    LL_TARGET_AVX2 void composite_4onto3_avx2(const U8* src, U8* dst, S32 pixels)
+    {
+        const __m256i expand = broadcast_mask(expand_3to4_mask());
+        const __m256i pack = broadcast_mask(pack_4to3_mask());
+        const __m256i zero = _mm256_setzero_si256();
+        S32 i = 0;
+        for (; i + 8 <= pixels; i += 8)
+        {
+            U8* dp = dst + i * 3;
+            __m256i s = _mm256_loadu_si256((const __m256i*)(src + i * 4));
+            __m256i d = _mm256_inserti128_si256(_mm256_castsi128_si256(load_12(dp)), load_12(dp + 12), 1);
+            d = _mm256_shuffle_epi8(d, expand);
+            __m256i lo = blend_epi16_avx2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero));
+            __m256i hi = blend_epi16_avx2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero));
+            __m256i out = _mm256_shuffle_epi8(_mm256_packus_epi16(lo, hi), pack);
+            store_12(dp, _mm256_castsi256_si128(out));
+            store_12(dp + 12, _mm256_extracti128_si256(out, 1));
+        }
+        composite_4onto3_sse41(src + i * 4, dst + i * 3, pixels - i);
+    }
+
+#if defined(_MSC_VER)
+    LL_TARGET_XSAVE U64 read_xcr0()
+    {
+        return _xgetbv(0);
+    }
+
+    bool cpu_has_avx2()
+    {
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+        {
+            return false;
+        }
+        __cpuid(info, 1);
+        const int osxsave_avx = (1 << 27) | (1 << 28);
+        if ((info[2] & osxsave_avx) != osxsave_avx)
+        {
+            return false;
+        }
+        // The OS has to save the YMM registers too
+        if ((read_xcr0() & 6) != 6)
+        {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }
+#else
+    bool cpu_has_avx2()
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    }
+#endif
+}
+
+#endif // LL_IMAGE_SIMD_AVX2
+
+//---------------------------------------------------------------------------
+// NEON row kernels
+//---------------------------------------------------------------------------
+
+#if LL_IMAGE_SIMD_NEON
+
+namespace
+{
+    // Rounded a * b / 255 of eight channels, as fast_fractional_mult()
+    inline uint8x8_t fractional_mult_u8(uint8x8_t a, uint8x8_t b)
+    {
+        uint16x8_t i = vaddq_u16(vmull_u8(a, b), vdupq_n_u16(128));
+        return vshrn_n_u16(vaddq_u16(i, vshrq_n_u16(i, 8)), 8);
+    }
+
+    void flip_rows_neon(U8* data, S32 row_bytes, S32 rows)
+    {
+        for (S32 row = 0; row < rows / 2; ++row)
+        {
+            U8* row_a = data + row * row_bytes;
+            U8* row_b = data + (rows - 1 - row) * row_bytes;
+            S32 i = 0;
+            for (; i + 16 <= row_bytes; i += 16)
+            {
+                uint8x16_t a = vld1q_u8(row_a + i);
+                uint8x16_t b = vld1q_u8(row_b + i);
+                vst1q_u8(row_a + i, b);
+                vst1q_u8(row_b + i, a);
+            }
+            std::swap_ranges(row_a + i, row_a + row_bytes, row_b + i);
+        }
+    }
+
+    void copy_3onto4_neon(const U8* src, U8* dst, S32 pixels)
+    {
+        S32 i = 0;
+        for (; i + 16 <= pixels; i += 16)
+        {
+            uint8x16x3_t rgb = vld3q_u8(src + i * 3);
+            uint8x16x4_t rgba;
+            rgba.val[0] = rgb.val[0];
+            rgba.val[1] = rgb.val[1];
+            rgba.val[2] = rgb.val[2];
+            rgba.val[3] = vdupq_n_u8(255);
+            vst4q_u8(dst + i * 4, rgba);
+        }
+        copy_3onto4_scalar(src + i * 3, dst + i * 4, pixels - i);
+    }
+
+    void copy_4onto3_neon(const U8* src, U8* dst, S32 pixels)
+    {
+        S32 i = 0;
+        for (; i + 16 <= pixels; i += 16)
+        {
+            uint8x16x4_t rgba = vld4q_u8(src + i * 4);
+            uint8x16x3_t rgb;
+            rgb.val[0] = rgba.val[0];
+            rgb.val[1] = rgba.val[1];
+            rgb.val[2] = rgba.val[2];
+            vst3q_u8(dst + i * 3, rgb);
+        }
+        copy_4onto3_scalar(src + i * 4, dst + i * 3, pixels - i);
+    }
+
+    void composite_4onto3_neon(const U8* src, U8* dst, S32 pixels)
+    {
+        S32 i = 0;
+        for (; i + 8 <= pixels; i += 8)
+        {
+            uint8x8x4_t s = vld4_u8(src + i * 4);
+            uint8x8x3_t d = vld3_u8(dst + i * 3);
+            uint8x8_t alpha = s.val[3];
+            uint8x8_t transparency = vsub_u8(vdup_n_u8(255), alpha);
+            for (S32 c = 0; c < 3; ++c)
+            {
+                d.val[c] = vadd_u8(fractional_mult_u8(d.val[c], transparency), fractional_mult_u8(s.val[c], alpha));
+            }
+            vst3_u8(dst + i * 3, d);
+        }
+        composite_4onto3_scalar(src + i * 4, dst + i * 3, pixels - i);
+    }
+}
+
+#endif // LL_IMAGE_SIMD_NEON
+
+//---------------------------------------------------------------------------
+// Dispatch
+//---------------------------------------------------------------------------
+
+namespace
+{
+    LLImageSIMD::EKernels detect_kernels()
+    {
+#if LL_IMAGE_SIMD_AVX2
+        if (cpu_has_avx2())
+        {
+            return LLImageSIMD::KERNELS_AVX2;
+        }
+#endif
+#if LL_IMAGE_SIMD_SSE41 || LL_IMAGE_SIMD_NEON
+        // Both are part of the baseline of any build that enables them
+        return LLImageSIMD::KERNELS_VECTOR;
+#else
+        return LLImageSIMD::KERNELS_SCALAR;
+#endif
+    }
+
+    std::atomic<S32> sKernels(LLImageSIMD::getSupportedKernels());
+
+    inline LLImageSIMD::EKernels current_kernels()
+    {
+        return (LLImageSIMD::EKernels)sKernels.load(std::memory_order_relaxed);
+    }
+}
+
+LLImageSIMD::EKernels LLImageSIMD::getSupportedKernels()
+{
+    static const EKernels supported = detect_kernels();
+    return supported;
+}
+
+void LLImageSIMD::setKernels(EKernels kernels)
+{
+    kernels = llclamp(kernels, KERNELS_SCALAR, getSupportedKernels());
+    if (sKernels.exchange(kernels, std::memory_order_relaxed) != kernels)
+    {
+        LL_INFOS("Image") << "Using " << getKernelsName(kernels) << " image kernels" << LL_ENDL;
+    }
+}
+
+LLImageSIMD::EKernels LLImageSIMD::getKernels()
+{
+    return current_kernels();
+}
+
+const char* LLImageSIMD::getKernelsName(EKernels kernels)
+{
+    switch (kernels)
+    {
+    case KERNELS_SCALAR:
+        return "scalar";
+    case KERNELS_VECTOR:
+#if LL_IMAGE_SIMD_NEON
+        return "NEON";
+#else
+        return "SSE4.1";
+#endif
+    case KERNELS_AVX2:
+        return "AVX2";
+    default:
+        return "unknown";
+    }
+}
+
+void LLImageSIMD::flipRows(U8* data, S32 row_bytes, S32 rows)
+{
+    switch (current_kernels())
+    {
+#if LL_IMAGE_SIMD_AVX2
+    case KERNELS_AVX2:
+        flip_rows_avx2(data, row_bytes, rows);
+        return;
+#endif
+#if LL_IMAGE_SIMD_SSE41
+    case KERNELS_VECTOR:
+        flip_rows_sse41(data, row_bytes, rows);
+        return;
+#elif LL_IMAGE_SIMD_NEON
+    case KERNELS_VECTOR:
+        flip_rows_neon(data, row_bytes, rows);
+        return;
+#endif
+    default:
+        flip_rows_scalar(data, row_bytes, rows);
+        return;
+    }
+}
+
+void LLImageSIMD::copy3onto4(const U8* src, U8* dst, S32 pixels)
+{
+    switch (current_kernels())
+    {
+#if LL_IMAGE_SIMD_AVX2
+    case KERNELS_AVX2:
+        copy_3onto4_avx2(src, dst, pixels);
+        return;
+#endif
+#if LL_IMAGE_SIMD_SSE41
+    case KERNELS_VECTOR:
+        copy_3onto4_sse41(src, dst, pixels);
+        return;
+#elif LL_IMAGE_SIMD_NEON
+    case KERNELS_VECTOR:
+        copy_3onto4_neon(src, dst, pixels);
+        return;
+#endif
+    default:
+        copy_3onto4_scalar(src, dst, pixels);
+        return;
+    }
+}
+
+void LLImageSIMD::copy4onto3(const U8* src, U8* dst, S32 pixels)
+{
+    switch (current_kernels())
+    {
+#if LL_IMAGE_SIMD_AVX2
+    case KERNELS_AVX2:
+        copy_4onto3_avx2(src, dst, pixels);
+        return;
+#endif
+#if LL_IMAGE_SIMD_SSE41
+    case KERNELS_VECTOR:
+        copy_4onto3_sse41(src, dst, pixels);
+        return;
+#elif LL_IMAGE_SIMD_NEON
+    case KERNELS_VECTOR:
+        copy_4onto3_neon(src, dst, pixels);
+        return;
+#endif
+    default:
+        copy_4onto3_scalar(src, dst, pixels);
+        return;
+    }
+}
+
+void LLImageSIMD::composite4onto3(const U8* src, U8* dst, S32 pixels)
+{
+    switch (current_kernels())
+    {
+#if LL_IMAGE_SIMD_AVX2
+    case KERNELS_AVX2:
+        composite_4onto3_avx2(src, dst, pixels);
+        return;
+#endif
+#if LL_IMAGE_SIMD_SSE41
+    case KERNELS_VECTOR:
+        composite_4onto3_sse41(src, dst, pixels);
+        return;
+#elif LL_IMAGE_SIMD_NEON
+    case KERNELS_VECTOR:
+        composite_4onto3_neon(src, dst, pixels);
+        return;
+#endif
+    default:
+        composite_4onto3_scalar(src, dst, pixels);
+        return;
+    }
+}
+
+// The per-pixel kernels work one pixel per vector, AVX2 has nothing to add there
+
+void LLImageSIMD::copyLineScaled(const U8* in, U8* out, S32 components, S32 in_pixel_len, S32 out_pixel_len, S32 in_pixel_step, S32 out_pixel_step)
+{
+    llassert(components >= 1 && components <= 4);
+#if LL_IMAGE_SIMD_SSE41 || LL_IMAGE_SIMD_NEON
+    if (current_kernels() != KERNELS_SCALAR)
+    {
+        copy_line_scaled_vector(in, out, components, in_pixel_len, out_pixel_len, in_pixel_step, out_pixel_step);
+        return;
+    }
+#endif
+    copy_line_scaled_scalar(in, out, components, in_pixel_len, out_pixel_len, in_pixel_step, out_pixel_step);
+}
+
+void LLImageSIMD::compositeRowScaled4onto3(const U8* in, U8* out, S32 in_pixel_len, S32 out_pixel_len)
+{
+#if LL_IMAGE_SIMD_SSE41 || LL_IMAGE_SIMD_NEON
+    if (current_kernels() != KERNELS_SCALAR)
+    {
+        composite_row_scaled_4onto3_vector(in, out, in_pixel_len, out_pixel_len);
+        return;
+    }
+#endif
+    composite_row_scaled_4onto3_scalar(in, out, in_pixel_len, out_pixel_len);
+}
+
+void LLImageSIMD::bilinearScale(const U8* src, U32 src_width, U32 src_height, U32 components, U32 src_stride,
+                                U8* dst, U32 dst_width, U32 dst_height, U32 dst_stride)
+{
+#if LL_IMAGE_SIMD_SSE41 || LL_IMAGE_SIMD_NEON
+    if (current_kernels() != KERNELS_SCALAR)
+    {
+        bilinear_scale_vector(src, src_width, src_height, components, src_stride, dst, dst_width, dst_height, dst_stride);
+        return;
+    }
+#endif
+    bilinear_scale_scalar(src, src_width, src_height, components, src_stride, dst, dst_width, dst_height, dst_stride);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file llimagesimd.h
+ * @brief Vectorized pixel kernels used by LLImageRaw
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMAGESIMD_H
+#define LL_LLIMAGESIMD_H
+
+// Row and pixel kernels behind LLImageRaw's scaling, compositing and
+// format conversion. Each kernel has a scalar reference implementation
+// and vector variants (SSE4.1 or NEON, plus AVX2 on x86-64 for the bulk
+// byte shuffles). The variant is chosen once at startup from what the
+// build and the CPU support and can be lowered with setKernels() for
+// testing, benchmarking, or to rule the vector paths out when chasing
+// a rendering bug.
+//
+// The integer kernels produce the same bytes as the scalar reference.
+// copyLineScaled() and compositeRowScaled4onto3() work in floating point
+// and may differ by one where the compiler contracts the scalar version
+// differently.
+namespace LLImageSIMD
+{
+    enum EKernels
+    {
+        KERNELS_SCALAR = 0,
+        KERNELS_VECTOR,     // SSE4.1 on x86, NEON on ARM
+        KERNELS_AVX2,
+        KERNELS_COUNT
+    };
+
+    // Best kernel set supported by both this build and the running CPU
+    EKernels getSupportedKernels();
+
+    // Kernel set used by the functions below. Requests above
+    // getSupportedKernels() are clamped. Thread safe, but meant to be
+    // called at startup or from tests.
+    void setKernels(EKernels kernels);
+    EKernels getKernels();
+    const char* getKernelsName(EKernels kernels);
+
+    // Reverse the order of rows in place
+    void flipRows(U8* data, S32 row_bytes, S32 rows);
+
+    // RGB to RGBA with opaque alpha, and RGBA to RGB
+    void copy3onto4(const U8* src, U8* dst, S32 pixels);
+    void copy4onto3(const U8* src, U8* dst, S32 pixels);
+
+    // Alpha blend RGBA src over RGB dst, same pixel count
+    void composite4onto3(const U8* src, U8* dst, S32 pixels);
+
+    // Box filter one line of components-channel pixels from in_pixel_len
+    // to out_pixel_len samples. The steps are in pixels, so a column of
+    // an image is scaled by passing the image width.
+    void copyLineScaled(const U8* in, U8* out, S32 components,
+                        S32 in_pixel_len, S32 out_pixel_len,
+                        S32 in_pixel_step, S32 out_pixel_step);
+
+    // Box filter one row of RGBA pixels and blend it over a row of RGB
+    void compositeRowScaled4onto3(const U8* in, U8* out, S32 in_pixel_len, S32 out_pixel_len);
+
+    // Bilinear (up) / area averaging (down) resample used by LLImageRaw::scale().
+    // components must be 1, 3 or 4.
+    void bilinearScale(const U8* src, U32 src_width, U32 src_height, U32 components, U32 src_stride,
+                       U8* dst, U32 dst_width, U32 dst_height, U32 dst_stride);
+}
+
+#endif // LL_LLIMAGESIMD_H
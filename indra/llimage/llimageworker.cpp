@@ -28,6 +28,7 @@
 
 #include "llimageworker.h"
 #include "llimagedxt.h"
+#include "llimagej2c.h"
 #include "threadpool.h"
 
 /*--------------------------------------------------------------------------*/
@@ -38,18 +39,22 @@ class ImageRequest
                  S32 discard,
                  BOOL needs_aux,
                  const LLPointer<LLImageDecodeThread::Responder>& responder,
-                 U32 request_id);
+                 U32 request_id,
+                 const LLImageDecodeThread::DecodeParams& params = LLImageDecodeThread::DecodeParams());
     virtual ~ImageRequest();
 
     /*virtual*/ bool processRequest();
     /*virtual*/ void finishRequest(bool completed);
 
 private:
+    void extractPart();
+
     // LLPointers stored in ImageRequest MUST be LLPointer instances rather
     // than references: we need to increment the refcount when storing these.
     // input
     LLPointer<LLImageFormatted> mFormattedImage;
     S32 mDiscardLevel;
+    LLImageDecodeThread::DecodeParams mParams;
     U32 mRequestId;
     BOOL mNeedsAux;
     // output
@@ -115,6 +120,82 @@ LLImageDecodeThread::handle_t LLImageDecodeThread::decodeImage(
     return decode_id;
 }
 
+LLImageDecodeThread::handle_t LLImageDecodeThread::decodeImage(
+    const LLPointer<LLImageFormatted>& image,
+    S32 discard,
+    const DecodeParams& params,
+    const LLPointer<LLImageDecodeThread::Responder>& responder)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+
+    U32 decode_id = ++mDecodeCount;
+    bool posted = mThreadPool->getQueue().post(
+        [req = ImageRequest(image, discard, FALSE, responder, decode_id, params)]
+        () mutable
+        {
+            auto done = req.processRequest();
+            req.finishRequest(done);
+        });
+    if (! posted)
+    {
+        LL_DEBUGS() << "Tried to start decoding on shutdown" << LL_ENDL;
+        return 0;
+    }
+
+    return decode_id;
+}
+
+LLImageDecodeThread::handle_t LLImageDecodeThread::generateMips(
+    const LLPointer<LLImageRaw>& image,
+    const LLImageMipChain::Params& params,
+    const mips_callback_t& callback)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+
+    U32 request_id = ++mDecodeCount;
+    bool posted = mThreadPool->getQueue().post(
+        [image, params, callback, request_id]()
+        {
+            LLPointer<LLImageMipChain> mips = new LLImageMipChain();
+            if (!mips->generate(image, params))
+            {
+                mips = NULL;
+            }
+            callback(mips, request_id);
+        });
+    if (! posted)
+    {
+        LL_DEBUGS() << "Tried to generate mips on shutdown" << LL_ENDL;
+        return 0;
+    }
+
+    return request_id;
+}
+
+LLImageDecodeThread::handle_t LLImageDecodeThread::compressImage(
+    const LLPointer<LLImageRaw>& image,
+    LLImageDXT::EFileFormat format,
+    LLImageBC::EQuality quality,
+    const compress_callback_t& callback)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+
+    U32 request_id = ++mDecodeCount;
+    bool posted = mThreadPool->getQueue().post(
+        [image, format, quality, callback, request_id]()
+        {
+            LLPointer<LLImageDXT> compressed = LLImageDXT::createCompressed(image, format, quality);
+            callback(compressed, request_id);
+        });
+    if (! posted)
+    {
+        LL_DEBUGS() << "Tried to compress an image on shutdown" << LL_ENDL;
+        return 0;
+    }
+
+    return request_id;
+}
+
 void LLImageDecodeThread::shutdown()
 {
     mThreadPool->close();
@@ -124,15 +205,39 @@ LLImageDecodeThread::Responder::~Responder()
 {
 }
 
+void LLImageDecodeThread::DecodeParams::setRegion(S32 x0, S32 y0, S32 x1, S32 y1)
+{
+    mRegion[0] = x0;
+    mRegion[1] = y0;
+    mRegion[2] = x1;
+    mRegion[3] = y1;
+}
+
+std::string LLImageDecodeThread::DecodeParams::getCacheKey() const
+{
+    if (isFullImage())
+    {
+        return std::string();
+    }
+    std::string key = llformat("c%d.%d", mFirstChannel, mMaxChannelCount);
+    if (hasRegion())
+    {
+        key += llformat("r%d.%d.%d.%d", mRegion[0], mRegion[1], mRegion[2], mRegion[3]);
+    }
+    return key;
+}
+
 //----------------------------------------------------------------------------
 
 ImageRequest::ImageRequest(const LLPointer<LLImageFormatted>& image,
                            S32 discard,
                            BOOL needs_aux,
                            const LLPointer<LLImageDecodeThread::Responder>& responder,
-                           U32 request_id)
+                           U32 request_id,
+                           const LLImageDecodeThread::DecodeParams& params)
     : mFormattedImage(image),
       mDiscardLevel(discard),
+      mParams(params),
       mNeedsAux(needs_aux),
       mDecodedRaw(FALSE),
       mDecodedAux(FALSE),
@@ -183,9 +288,36 @@ bool ImageRequest::processRequest()
                                               mFormattedImage->getHeight(),
                                               mFormattedImage->getComponents());
         }
-        done = mFormattedImage->decode(mDecodedImageRaw, decode_time_slice);
+        if (mFormattedImage->getCodec() == IMG_CODEC_J2C)
+        {
+            // J2C decoders skip unwanted channels themselves.  A region
+            // only applies to the next decode, and only when asked for.
+            if (mParams.hasRegion())
+            {
+                LLImageJ2C* j2c = (LLImageJ2C*)mFormattedImage.get();
+                if (j2c->initDecode(*mDecodedImageRaw, -1, mParams.mRegion))
+                {
+                    mParams.setRegion(0, 0, 0, 0);
+                }
+            }
+            done = mFormattedImage->decodeChannels(mDecodedImageRaw, decode_time_slice, mParams.mFirstChannel, mParams.mMaxChannelCount);
+            if (done)
+            {
+                mParams.mFirstChannel = 0;
+                mParams.mMaxChannelCount = 4;
+            }
+        }
+        else
+        {
+            done = mFormattedImage->decode(mDecodedImageRaw, decode_time_slice);
+        }
         // some decoders are removing data when task is complete and there were errors
         mDecodedRaw = done && mDecodedImageRaw->getData();
+        if (mDecodedRaw && !mParams.isFullImage())
+        {
+            // Whatever the decoder couldn't skip
+            extractPart();
+        }
 
         // Pick up errors from decoding
         mErrorString = LLImage::getLastThreadError();
@@ -209,6 +341,59 @@ bool ImageRequest::processRequest()
     return done;
 }
 
+// Cut a decoded image down to the channels and region still in mParams
+void ImageRequest::extractPart()
+{
+    LLImageRaw* src = mDecodedImageRaw;
+    S32 src_components = src->getComponents();
+    S32 first_channel = llmin(mParams.mFirstChannel, src_components - 1);
+    S32 channels = llclamp(src_components - first_channel, 1, mParams.mMaxChannelCount);
+
+    // The region is in full resolution pixels, scale it to the decoded level
+    S32 x0 = 0, y0 = 0, x1 = src->getWidth(), y1 = src->getHeight();
+    if (mParams.hasRegion())
+    {
+        S32 shift = 0;
+        while (shift < MAX_DISCARD_LEVEL && ((mFormattedImage->getWidth() + (1 << shift) - 1) >> shift) > src->getWidth())
+        {
+            ++shift;
+        }
+        x0 = llclamp(mParams.mRegion[0] >> shift, 0, x1);
+        y0 = llclamp(mParams.mRegion[1] >> shift, 0, y1);
+        x1 = llclamp((mParams.mRegion[2] + (1 << shift) - 1) >> shift, x0, x1);
+        y1 = llclamp((mParams.mRegion[3] + (1 << shift) - 1) >> shift, y0, y1);
+    }
+    if (x1 <= x0 || y1 <= y0)
+    {
+        mErrorString = "Empty decode region";
+        mDecodedRaw = FALSE;
+        return;
+    }
+
+    LLPointer<LLImageRaw> dst = new LLImageRaw(x1 - x0, y1 - y0, channels);
+    if (!dst->getData())
+    {
+        mErrorString = "Memory error";
+        mDecodedRaw = FALSE;
+        return;
+    }
+    const U8* src_data = src->getData();
+    U8* dst_data = dst->getData();
+    for (S32 y = y0; y < y1; ++y)
+    {
+        const U8* in = src_data + (y * src->getWidth() + x0) * src_components + first_channel;
+        for (S32 x = x0; x < x1; ++x)
+        {
+            for (S32 c = 0; c < channels; ++c)
+            {
+                *dst_data++ = in[c];
+            }
+            in += src_components;
+        }
+    }
+    mDecodedImageRaw = dst;
+}
+
 void ImageRequest::finishRequest(bool completed)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
@@ -28,9 +28,13 @@
 #define LL_LLIMAGEWORKER_H
 
 #include "llimage.h"
+#include "llimagedxt.h"
+#include "llimagemips.h"
 #include "llpointer.h"
 #include "threadpool_fwd.h"
 
+#include <functional>
+
 class LLImageDecodeThread
 {
 public:
@@ -42,6 +46,27 @@ class LLImageDecodeThread
         virtual void completed(bool success, const std::string& error_message, LLImageRaw* raw, LLImageRaw* aux, U32 request_id) = 0;
     };
 
+    // What part of an image a request wants.  The defaults decode
+    // everything.  Channels follow LLImageFormatted::decodeChannels();
+    // the region is in full resolution pixels, rows counted from the
+    // bottom as in LLImageRaw, and comes back scaled by the discard
+    // level.  Decoders that can't skip work decode the whole image
+    // and the result is cut down to match.
+    struct DecodeParams
+    {
+        S32 mFirstChannel = 0;
+        S32 mMaxChannelCount = 4;
+        S32 mRegion[4] = { 0, 0, 0, 0 };    // x0, y0, x1, y1
+
+        void setRegion(S32 x0, S32 y0, S32 x1, S32 y1);
+        bool hasRegion() const { return mRegion[2] > mRegion[0] && mRegion[3] > mRegion[1]; }
+        bool isFullImage() const { return mFirstChannel == 0 && mMaxChannelCount >= 4 && !hasRegion(); }
+
+        // Suffix distinguishing this decode from others of the same
+        // image when caching results, empty for a full decode.
+        std::string getCacheKey() const;
+    };
+
 public:
     LLImageDecodeThread(bool threaded = true);
     virtual ~LLImageDecodeThread();
@@ -51,6 +76,26 @@ class LLImageDecodeThread
     handle_t decodeImage(const LLPointer<LLImageFormatted>& image,
                          S32 discard, BOOL needs_aux,
                          const LLPointer<Responder>& responder);
+    // Decode part of an image, see DecodeParams
+    handle_t decodeImage(const LLPointer<LLImageFormatted>& image,
+                         S32 discard, const DecodeParams& params,
+                         const LLPointer<Responder>& responder);
+
+    // Build a mip chain for an image on the pool, see LLImageMipChain.
+    // The callback runs on a pool thread with a null chain if generation
+    // failed. The image must not change until then.
+    typedef std::function<void(LLImageMipChain* mips, U32 request_id)> mips_callback_t;
+    handle_t generateMips(const LLPointer<LLImageRaw>& image,
+                          const LLImageMipChain::Params& params,
+                          const mips_callback_t& callback);
+
+    // Block compress an image with its mips on the pool, see
+    // LLImageDXT::encodeCompressed(). Same callback rules as generateMips().
+    typedef std::function<void(LLImageDXT* compressed, U32 request_id)> compress_callback_t;
+    handle_t compressImage(const LLPointer<LLImageRaw>& image,
+                           LLImageDXT::EFileFormat format,
+                           LLImageBC::EQuality quality,
+                           const compress_callback_t& callback);
     size_t getPending();
     size_t update(F32 max_time_ms);
     S32 getTotalDecodeCount() { return mDecodeCount; }
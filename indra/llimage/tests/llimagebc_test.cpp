@@ -0,0 +1,285 @@
+/**
+ * @file llimagebc_test.cpp
+ * @brief LLImageBC block compression checks
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llimagebc.h"
+#include "llmath.h"
+
+#include "../test/lltut.h"
+
+#include <vector>
+
+namespace tut
+{
+    struct imagebc_test
+    {
+        // Smooth gradients with a little noise, the sort of content the
+        // encoders are meant for
+        static std::vector<U8> makeImage(S32 width, S32 height)
+        {
+            std::vector<U8> data(width * height * 4);
+            U32 seed = 1234;
+            for (S32 y = 0; y < height; ++y)
+            {
+                for (S32 x = 0; x < width; ++x)
+                {
+                    seed = seed * 1103515245 + 12345;
+                    S32 noise = (seed >> 16) % 8;
+                    U8* pixel = &data[(y * width + x) * 4];
+                    pixel[0] = (U8)llmin(255, x * 255 / width + noise);
+                    pixel[1] = (U8)llmin(255, y * 255 / height + noise);
+                    pixel[2] = (U8)((x + y) * 255 / (width + height));
+                    pixel[3] = (U8)(255 - y * 255 / height);
+                }
+            }
+            return data;
+        }
+
+        static F64 psnr(const std::vector<U8>& a, const std::vector<U8>& b, S32 channels)
+        {
+            F64 error = 0.0;
+            S32 pixels = (S32)a.size() / 4;
+            for (S32 i = 0; i < pixels; ++i)
+            {
+                for (S32 c = 0; c < channels; ++c)
+                {
+                    F64 d = (F64)a[i * 4 + c] - (F64)b[i * 4 + c];
+                    error += d * d;
+                }
+            }
+            error /= (F64)(pixels * channels);
+            return error > 0.0 ? 10.0 * log10(255.0 * 255.0 / error) : 100.0;
+        }
+
+        static std::vector<U8> roundTrip(LLImageBC::EFormat format, LLImageBC::EQuality quality,
+                                         const std::vector<U8>& data, S32 width, S32 height, S32 components)
+        {
+            std::vector<U8> compressed(LLImageBC::levelBytes(format, width, height));
+            LLImageBC::compress(format, quality, data.data(), width, height, components, compressed.data());
+            std::vector<U8> decoded(width * height * 4);
+            LLImageBC::decompress(format, compressed.data(), width, height, decoded.data());
+            return decoded;
+        }
+    };
+    typedef test_group<imagebc_test> imagebc_t;
+    typedef imagebc_t::object imagebc_object_t;
+    tut::imagebc_t tut_imagebc("LLImageBC");
+
+    template<> template<>
+    void imagebc_object_t::test<1>()
+    {
+        set_test_name("sizes");
+
+        ensure_equals("BC1 block", LLImageBC::blockBytes(LLImageBC::FORMAT_BC1), 8);
+        ensure_equals("BC7 block", LLImageBC::blockBytes(LLImageBC::FORMAT_BC7), 16);
+        ensure_equals("whole blocks", LLImageBC::levelBytes(LLImageBC::FORMAT_BC3, 16, 8), 8 * 16);
+        ensure_equals("partial blocks", LLImageBC::levelBytes(LLImageBC::FORMAT_BC1, 5, 3), 2 * 8);
+        ensure_equals("one pixel", LLImageBC::levelBytes(LLImageBC::FORMAT_BC5, 1, 1), 16);
+    }
+
+    template<> template<>
+    void imagebc_object_t::test<2>()
+    {
+        set_test_name("quality");
+
+        const S32 width = 32, height = 32;
+        // Lowest acceptable PSNR for each format, in dB
+        const F64 floor[LLImageBC::FORMAT_COUNT] = { 30.0, 32.0, 45.0, 31.0 };
+        const S32 channels[LLImageBC::FORMAT_COUNT] = { 3, 4, 2, 4 };
+        for (S32 format = 0; format < LLImageBC::FORMAT_COUNT; ++format)
+        {
+            std::vector<U8> data = makeImage(width, height);
+            if (format == LLImageBC::FORMAT_BC1)
+            {
+                // Alpha below half is cut out
+                for (S32 i = 0; i < width * height; ++i)
+                {
+                    data[i * 4 + 3] = 255;
+                }
+            }
+            F64 previous = 0.0;
+            for (S32 quality = 0; quality < LLImageBC::QUALITY_COUNT; ++quality)
+            {
+                std::vector<U8> decoded = roundTrip((LLImageBC::EFormat)format, (LLImageBC::EQuality)quality,
+                                                    data, width, height, 4);
+                F64 result = psnr(data, decoded, channels[format]);
+                std::string name = LLImageBC::getFormatName((LLImageBC::EFormat)format);
+                ensure(name + " psnr", result > floor[format]);
+                // Higher settings never pick a worse block
+                ensure(name + " improves with quality", result >= previous - 0.01);
+                previous = result;
+            }
+        }
+    }
+
+    template<> template<>
+    void imagebc_object_t::test<3>()
+    {
+        set_test_name("flat colors");
+
+        // A flat block can't always be hit exactly by interpolated 565
+        // endpoints, but must be close, and BC5/BC7 get it exact or nearly
+        const U8 color[] = { 200, 100, 30, 160 };
+        std::vector<U8> data(8 * 8 * 4);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = color[i % 4];
+        }
+        for (S32 format = 0; format < LLImageBC::FORMAT_COUNT; ++format)
+        {
+            S32 tolerance = format == LLImageBC::FORMAT_BC5 ? 0 : (format == LLImageBC::FORMAT_BC7 ? 1 : 4);
+            S32 channels = format == LLImageBC::FORMAT_BC5 ? 2 : (format == LLImageBC::FORMAT_BC1 ? 3 : 4);
+            std::vector<U8> decoded = roundTrip((LLImageBC::EFormat)format, LLImageBC::QUALITY_NORMAL, data, 8, 8, 4);
+            for (S32 i = 0; i < 8 * 8; ++i)
+            {
+                for (S32 c = 0; c < channels; ++c)
+                {
+                    ensure("flat", llabs(S32(decoded[i * 4 + c]) - S32(color[c])) <= tolerance);
+                }
+            }
+        }
+    }
+
+    template<> template<>
+    void imagebc_object_t::test<4>()
+    {
+        set_test_name("alpha");
+
+        // BC1 keeps cutout alpha, BC3 keeps alpha exactly for two levels
+        std::vector<U8> data(4 * 4 * 4, 128);
+        for (S32 i = 0; i < 16; ++i)
+        {
+            data[i * 4 + 3] = (i & 1) ? 255 : 0;
+        }
+        std::vector<U8> decoded = roundTrip(LLImageBC::FORMAT_BC1, LLImageBC::QUALITY_FAST, data, 4, 4, 4);
+        for (S32 i = 0; i < 16; ++i)
+        {
+            ensure_equals("BC1 cutout", decoded[i * 4 + 3], data[i * 4 + 3]);
+            if (data[i * 4 + 3])
+            {
+                ensure("BC1 opaque color", llabs(S32(decoded[i * 4]) - 128) <= 4);
+            }
+        }
+        decoded = roundTrip(LLImageBC::FORMAT_BC3, LLImageBC::QUALITY_FAST, data, 4, 4, 4);
+        for (S32 i = 0; i < 16; ++i)
+        {
+            ensure_equals("BC3 alpha", decoded[i * 4 + 3], data[i * 4 + 3]);
+        }
+
+        // Images without alpha come out opaque
+        std::vector<U8> rgb(4 * 4 * 3, 90);
+        for (S32 format = 0; format < LLImageBC::FORMAT_COUNT; ++format)
+        {
+            if (format == LLImageBC::FORMAT_BC5)
+            {
+                continue;
+            }
+            decoded = roundTrip((LLImageBC::EFormat)format, LLImageBC::QUALITY_HIGH, rgb, 4, 4, 3);
+            for (S32 i = 0; i < 16; ++i)
+            {
+                ensure_equals("opaque", decoded[i * 4 + 3], 255);
+            }
+        }
+    }
+
+    template<> template<>
+    void imagebc_object_t::test<5>()
+    {
+        set_test_name("bc7 mode 6 layout");
+
+        // One ramp between two colors, which mode 6 can follow closely
+        std::vector<U8> data(16 * 4);
+        for (S32 i = 0; i < 16; ++i)
+        {
+            data[i * 4] = (U8)(20 + i * 13);
+            data[i * 4 + 1] = (U8)(200 - i * 10);
+            data[i * 4 + 2] = (U8)(50 + i * 7);
+            data[i * 4 + 3] = (U8)(255 - i * 6);
+        }
+        U8 block[16];
+        for (S32 quality = 0; quality < LLImageBC::QUALITY_COUNT; ++quality)
+        {
+            LLImageBC::compressBlock(LLImageBC::FORMAT_BC7, (LLImageBC::EQuality)quality, data.data(), block);
+            // Mode 6 is six zero bits then a one
+            ensure_equals("mode", block[0] & 0x7f, 0x40);
+            // The p bits sit at 63 and 64, the three bit anchor index after
+            // them. Flipping a p bit moves every texel by at most one step.
+            std::vector<U8> decoded(16 * 4), flipped(16 * 4);
+            LLImageBC::decompressBlock(LLImageBC::FORMAT_BC7, block, decoded.data());
+            ensure("decodes", psnr(data, decoded, 4) > 35.0);
+            block[7] ^= 0x80;
+            LLImageBC::decompressBlock(LLImageBC::FORMAT_BC7, block, flipped.data());
+            for (S32 i = 0; i < 16 * 4; ++i)
+            {
+                ensure("p bit", llabs(S32(decoded[i]) - S32(flipped[i])) <= 1);
+            }
+        }
+    }
+
+    template<> template<>
+    void imagebc_object_t::test<6>()
+    {
+        set_test_name("partial blocks and channels");
+
+        // 6x5 image: the edge blocks repeat the last row and column
+        const S32 width = 6, height = 5;
+        std::vector<U8> gray(width * height);
+        for (S32 i = 0; i < width * height; ++i)
+        {
+            gray[i] = (U8)(i * 8);
+        }
+        std::vector<U8> compressed(LLImageBC::levelBytes(LLImageBC::FORMAT_BC7, width, height));
+        LLImageBC::compress(LLImageBC::FORMAT_BC7, LLImageBC::QUALITY_NORMAL, gray.data(), width, height, 1,
+                            compressed.data());
+        std::vector<U8> decoded(width * height * 4);
+        LLImageBC::decompress(LLImageBC::FORMAT_BC7, compressed.data(), width, height, decoded.data());
+        for (S32 i = 0; i < width * height; ++i)
+        {
+            // Luminance spreads to all three colors
+            for (S32 c = 0; c < 3; ++c)
+            {
+                ensure("luminance", llabs(S32(decoded[i * 4 + c]) - S32(gray[i])) <= 12);
+            }
+        }
+
+        // BC5 takes the first two channels as they are. Eight evenly
+        // spaced values per channel fit its palette exactly.
+        std::vector<U8> normals(4 * 4 * 3);
+        for (S32 i = 0; i < 16; ++i)
+        {
+            normals[i * 3] = (U8)((i % 8) * 30);
+            normals[i * 3 + 1] = (U8)(255 - (i / 2) * 35);
+            normals[i * 3 + 2] = 255;
+        }
+        decoded = roundTrip(LLImageBC::FORMAT_BC5, LLImageBC::QUALITY_NORMAL, normals, 4, 4, 3);
+        for (S32 i = 0; i < 16; ++i)
+        {
+            ensure("red", llabs(S32(decoded[i * 4]) - S32(normals[i * 3])) <= 1);
+            ensure("green", llabs(S32(decoded[i * 4 + 1]) - S32(normals[i * 3 + 1])) <= 1);
+        }
+    }
+}
@@ -0,0 +1,232 @@
+/**
+ * @file llimagebufferpool_test.cpp
+ * @brief LLImageBufferPool reuse, trimming and churn
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llimagebufferpool.h"
+#include "llmemory.h"
+
+#include "../test/lltut.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace tut
+{
+    struct imagebufferpool_test
+    {
+        imagebufferpool_test()
+        {
+            LLImageBufferPool::setMaxBytes(64 * 1024 * 1024);
+        }
+
+        ~imagebufferpool_test()
+        {
+            LLImageBufferPool::setMaxBytes(0);
+        }
+
+        // What a teleport looks like to the allocator: textures of mixed
+        // power of two sizes created and dropped in no particular order,
+        // with a window of them alive at a time
+        static void churn(bool pooled, S32 iterations, U32 seed)
+        {
+            static const S32 sizes[] = { 32 * 32 * 4, 64 * 64 * 3, 128 * 128 * 4, 256 * 256 * 3,
+                                         256 * 256 * 4, 512 * 512 * 3, 512 * 512 * 4, 1024 * 512 * 4 };
+            const S32 LIVE = 32;
+            std::vector<std::pair<U8*, S32> > live(LIVE, std::make_pair((U8*)NULL, 0));
+            for (S32 i = 0; i < iterations; ++i)
+            {
+                seed = seed * 1103515245 + 12345;
+                std::pair<U8*, S32>& slot = live[(seed >> 8) % LIVE];
+                if (slot.first)
+                {
+                    if (pooled)
+                    {
+                        LLImageBufferPool::free(slot.first, slot.second);
+                    }
+                    else
+                    {
+                        ll_aligned_free_16(slot.first);
+                    }
+                }
+                slot.second = sizes[(seed >> 16) % LL_ARRAY_SIZE(sizes)];
+                slot.first = pooled ? LLImageBufferPool::allocate(slot.second) : (U8*)ll_aligned_malloc_16(slot.second);
+                // Touch it the way a decode would
+                memset(slot.first, i, slot.second);
+            }
+            for (std::pair<U8*, S32>& slot : live)
+            {
+                if (pooled)
+                {
+                    LLImageBufferPool::free(slot.first, slot.second);
+                }
+                else
+                {
+                    ll_aligned_free_16(slot.first);
+                }
+            }
+        }
+    };
+    typedef test_group<imagebufferpool_test> imagebufferpool_t;
+    typedef imagebufferpool_t::object imagebufferpool_object_t;
+    tut::imagebufferpool_t tut_imagebufferpool("LLImageBufferPool");
+
+    template<> template<>
+    void imagebufferpool_object_t::test<1>()
+    {
+        set_test_name("size classes");
+
+        ensure("32x32 RGBA", LLImageBufferPool::isPooledSize(32 * 32 * 4));
+        ensure("64x64 RGB", LLImageBufferPool::isPooledSize(64 * 64 * 3));
+        ensure("512x256 LA", LLImageBufferPool::isPooledSize(512 * 256 * 2));
+        ensure("2048x2048 RGBA", LLImageBufferPool::isPooledSize(2048 * 2048 * 4));
+        ensure("2048x2048 RGB", LLImageBufferPool::isPooledSize(2048 * 2048 * 3));
+        ensure("too small", !LLImageBufferPool::isPooledSize(16 * 16 * 4));
+        ensure("too big", !LLImageBufferPool::isPooledSize(4096 * 2048 * 4));
+        ensure("not a power of two", !LLImageBufferPool::isPooledSize(1024 * 768 * 3));
+        ensure("odd", !LLImageBufferPool::isPooledSize(12345));
+    }
+
+    template<> template<>
+    void imagebufferpool_object_t::test<2>()
+    {
+        set_test_name("reuse");
+
+        // Small buffers come back from the thread's own cache, large ones
+        // from the shared pool
+        const S32 sizes[] = { 128 * 128 * 4, 1024 * 1024 * 3 };
+        for (S32 size : sizes)
+        {
+            LLImageBufferPool::Stats before = LLImageBufferPool::getStats();
+            U8* first = LLImageBufferPool::allocate(size);
+            ensure("aligned", ((uintptr_t)first & 15) == 0);
+            memset(first, 0xAB, size);
+            LLImageBufferPool::free(first, size);
+            ensure_equals("cached", LLImageBufferPool::getStats().mCachedBytes, before.mCachedBytes + size);
+
+            U8* second = LLImageBufferPool::allocate(size);
+            ensure("reused", first == second);
+            LLImageBufferPool::Stats after = LLImageBufferPool::getStats();
+            ensure_equals("hit", after.mHits, before.mHits + 1);
+            ensure_equals("not cached", after.mCachedBytes, before.mCachedBytes);
+            LLImageBufferPool::free(second, size);
+        }
+
+        // Buffers from ll_aligned_malloc_16() of a pooled size are accepted
+        U8* outside = (U8*)ll_aligned_malloc_16(64 * 64 * 4);
+        LLImageBufferPool::free(outside, 64 * 64 * 4);
+        ensure("adopted", LLImageBufferPool::allocate(64 * 64 * 4) == outside);
+        LLImageBufferPool::free(outside, 64 * 64 * 4);
+
+        // Other sizes pass straight through
+        LLImageBufferPool::Stats before = LLImageBufferPool::getStats();
+        U8* odd = LLImageBufferPool::allocate(1000 * 3);
+        LLImageBufferPool::free(odd, 1000 * 3);
+        LLImageBufferPool::Stats after = LLImageBufferPool::getStats();
+        ensure_equals("not cached", after.mCachedBytes, before.mCachedBytes);
+        ensure_equals("not counted", after.mHits + after.mMisses, before.mHits + before.mMisses);
+    }
+
+    template<> template<>
+    void imagebufferpool_object_t::test<3>()
+    {
+        set_test_name("limits and trim");
+
+        // The shared pool holds no more than its limit
+        LLImageBufferPool::trim();
+        LLImageBufferPool::setMaxBytes(4 * 1024 * 1024);
+        const S32 size = 1024 * 1024 * 4;
+        std::vector<U8*> buffers;
+        for (S32 i = 0; i < 3; ++i)
+        {
+            buffers.push_back(LLImageBufferPool::allocate(size));
+        }
+        for (U8* data : buffers)
+        {
+            LLImageBufferPool::free(data, size);
+        }
+        ensure_equals("capped", LLImageBufferPool::getStats().mCachedBytes, (S64)size);
+
+        // Lowering the limit releases the excess
+        LLImageBufferPool::setMaxBytes(1024 * 1024);
+        ensure_equals("lowered", LLImageBufferPool::getStats().mCachedBytes, (S64)0);
+
+        // trim() empties the shared pool and this thread's cache
+        LLImageBufferPool::setMaxBytes(64 * 1024 * 1024);
+        U8* small = LLImageBufferPool::allocate(64 * 64 * 4);
+        U8* large = LLImageBufferPool::allocate(size);
+        LLImageBufferPool::free(small, 64 * 64 * 4);
+        LLImageBufferPool::free(large, size);
+        ensure("filled", LLImageBufferPool::getStats().mCachedBytes > 0);
+        LLImageBufferPool::Stats before = LLImageBufferPool::getStats();
+        LLImageBufferPool::trim();
+        LLImageBufferPool::Stats after = LLImageBufferPool::getStats();
+        ensure_equals("trimmed", after.mCachedBytes, (S64)0);
+        ensure_equals("released", after.mReleasedBytes, before.mReleasedBytes + size + 64 * 64 * 4);
+
+        // Disabled, nothing is kept
+        LLImageBufferPool::setMaxBytes(0);
+        LLImageBufferPool::free(LLImageBufferPool::allocate(size), size);
+        ensure_equals("disabled", LLImageBufferPool::getStats().mCachedBytes, (S64)0);
+    }
+
+    template<> template<>
+    void imagebufferpool_object_t::test<4>()
+    {
+        set_test_name("churn");
+
+        // Several decode threads allocating and freeing at once, then the
+        // same churn through the system allocator for comparison
+        const S32 THREADS = 4;
+        const S32 ITERATIONS = 2000;
+        std::chrono::steady_clock::duration times[2];
+        for (S32 pooled = 1; pooled >= 0; --pooled)
+        {
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            for (S32 i = 0; i < THREADS; ++i)
+            {
+                threads.emplace_back(&imagebufferpool_test::churn, pooled != 0, ITERATIONS, (U32)(i + 1));
+            }
+            for (std::thread& thread : threads)
+            {
+                thread.join();
+            }
+            times[pooled] = std::chrono::steady_clock::now() - start;
+        }
+
+        LLImageBufferPool::Stats stats = LLImageBufferPool::getStats();
+        ensure("mostly reused", stats.mHits > stats.mMisses);
+        // Exited threads dropped their own caches, only the shared pool is left
+        ensure("bounded", stats.mCachedBytes <= LLImageBufferPool::getMaxBytes());
+
+        LL_INFOS() << THREADS << " threads x " << ITERATIONS << " buffers: pooled "
+                   << std::chrono::duration_cast<std::chrono::microseconds>(times[1]).count() << " us, malloc "
+                   << std::chrono::duration_cast<std::chrono::microseconds>(times[0]).count() << " us, "
+                   << stats.mHits << " hits " << stats.mMisses << " misses" << LL_ENDL;
+    }
+}
@@ -0,0 +1,229 @@
+/**
+ * @file llimagemips_test.cpp
+ * @brief LLImageMipChain layout and filtering checks
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llimagemips.h"
+#include "../llimage.h"
+#include "llmath.h"
+
+#include "../test/lltut.h"
+
+#include <vector>
+
+// -------------------------------------------------------------------------------------------
+// Stubbing: the tests build chains from plain buffers, the LLImageRaw overload is not used
+const U8* LLImageBase::getData() const { return NULL; }
+bool LLImageBase::isBufferInvalid() const { return true; }
+// End Stubbing
+// -------------------------------------------------------------------------------------------
+
+namespace tut
+{
+    struct imagemips_test
+    {
+        static LLPointer<LLImageMipChain> build(const std::vector<U8>& data, S32 width, S32 height, S32 components,
+                                                const LLImageMipChain::Params& params)
+        {
+            LLPointer<LLImageMipChain> mips = new LLImageMipChain();
+            ensure("generated", mips->generate(data.data(), width, height, components, params));
+            return mips;
+        }
+
+        static F32 coverage(const LLImageMipChain* mips, S32 level)
+        {
+            const U8* data = mips->getLevelData(level);
+            S32 pixels = mips->getWidth(level) * mips->getHeight(level);
+            S32 count = 0;
+            for (S32 i = 0; i < pixels; ++i)
+            {
+                count += data[i * 4 + 3] > 127;
+            }
+            return (F32)count / (F32)pixels;
+        }
+    };
+    typedef test_group<imagemips_test> imagemips_t;
+    typedef imagemips_t::object imagemips_object_t;
+    tut::imagemips_t tut_imagemips("LLImageMipChain");
+
+    const LLImageMipChain::EFilter FILTERS[] = {
+        LLImageMipChain::FILTER_BOX, LLImageMipChain::FILTER_KAISER, LLImageMipChain::FILTER_LANCZOS
+    };
+
+    template<> template<>
+    void imagemips_object_t::test<1>()
+    {
+        set_test_name("layout");
+
+        std::vector<U8> data(8 * 4 * 3);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = (U8)i;
+        }
+        LLPointer<LLImageMipChain> mips = build(data, 8, 4, 3, LLImageMipChain::Params());
+
+        ensure_equals("levels", mips->getLevelCount(), 4);
+        ensure_equals("level 2 width", mips->getWidth(2), 2);
+        ensure_equals("level 2 height", mips->getHeight(2), 1);
+        ensure_equals("level 3 width", mips->getWidth(3), 1);
+        ensure_equals("padded", mips->getLevelSize(2), 8);
+        ensure_equals("total size", mips->getDataSize(), (size_t)(96 + 24 + 8 + 4));
+
+        // What LLImageGL::setImage() walks back through with data_hasmips
+        ensure("smallest first", mips->getData() == mips->getLevelData(3));
+        for (S32 level = 1; level < mips->getLevelCount(); ++level)
+        {
+            ensure_equals("level before the previous", mips->getLevelData(level - 1) - mips->getLevelData(level),
+                          (ptrdiff_t)mips->getLevelSize(level));
+        }
+        ensure("full resolution copied", memcmp(mips->getLevelData(0), data.data(), data.size()) == 0);
+
+        LLImageMipChain::Params params;
+        params.mMaxLevels = 2;
+        mips = build(data, 8, 4, 3, params);
+        ensure_equals("limited levels", mips->getLevelCount(), 2);
+        ensure("level 0 last", mips->getLevelData(0) + mips->getLevelSize(0) == mips->getData() + mips->getDataSize());
+
+        ensure("rejects empty image", !mips->generate(data.data(), 0, 4, 3, params));
+        ensure("cleared", mips->isEmpty());
+    }
+
+    template<> template<>
+    void imagemips_object_t::test<2>()
+    {
+        set_test_name("flat color stays flat");
+
+        const U8 color[] = { 200, 100, 30, 160 };
+        for (S32 components = 1; components <= 4; ++components)
+        {
+            std::vector<U8> data(16 * 8 * components);
+            for (size_t i = 0; i < data.size(); ++i)
+            {
+                data[i] = color[i % components];
+            }
+            for (LLImageMipChain::EFilter filter : FILTERS)
+            {
+                for (bool wrap : { true, false })
+                {
+                    LLImageMipChain::Params params;
+                    params.mFilter = filter;
+                    params.mWrap = wrap;
+                    LLPointer<LLImageMipChain> mips = build(data, 16, 8, components, params);
+                    for (S32 level = 1; level < mips->getLevelCount(); ++level)
+                    {
+                        const U8* texel = mips->getLevelData(level);
+                        for (S32 i = 0; i < mips->getWidth(level) * mips->getHeight(level) * components; ++i)
+                        {
+                            ensure("flat", llabs(S32(texel[i]) - S32(color[i % components])) <= 1);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    template<> template<>
+    void imagemips_object_t::test<3>()
+    {
+        set_test_name("gamma correct");
+
+        // Black and white checkerboard averages to half the light, which
+        // is 188 in sRGB rather than the 128 of a plain byte average
+        std::vector<U8> data(8 * 8 * 3);
+        for (S32 y = 0; y < 8; ++y)
+        {
+            for (S32 x = 0; x < 8; ++x)
+            {
+                U8 value = ((x + y) & 1) ? 255 : 0;
+                for (S32 c = 0; c < 3; ++c)
+                {
+                    data[(y * 8 + x) * 3 + c] = value;
+                }
+            }
+        }
+
+        for (LLImageMipChain::EFilter filter : FILTERS)
+        {
+            LLImageMipChain::Params params;
+            params.mFilter = filter;
+            LLPointer<LLImageMipChain> mips = build(data, 8, 8, 3, params);
+            const U8* level = mips->getLevelData(1);
+            for (S32 i = 0; i < 4 * 4 * 3; ++i)
+            {
+                ensure("linear light average", level[i] >= 187 && level[i] <= 188);
+            }
+
+            params.mSRGB = false;
+            mips = build(data, 8, 8, 3, params);
+            level = mips->getLevelData(1);
+            for (S32 i = 0; i < 4 * 4 * 3; ++i)
+            {
+                ensure("plain average", level[i] >= 127 && level[i] <= 128);
+            }
+        }
+    }
+
+    template<> template<>
+    void imagemips_object_t::test<4>()
+    {
+        set_test_name("alpha coverage");
+
+        // Sparse opaque texels, like leaves on a transparent background.
+        // Averaging alone drops every texel of the smaller levels below
+        // the cutoff.
+        const S32 size = 64;
+        std::vector<U8> data(size * size * 4, 255);
+        U32 seed = 4321;
+        S32 opaque = 0;
+        for (S32 i = 0; i < size * size; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            bool visible = ((seed >> 16) % 100) < 30;
+            data[i * 4 + 3] = visible ? 255 : 0;
+            opaque += visible;
+        }
+        F32 target = (F32)opaque / (F32)(size * size);
+
+        for (LLImageMipChain::EFilter filter : FILTERS)
+        {
+            LLImageMipChain::Params params;
+            params.mFilter = filter;
+            params.mPreserveAlphaCoverage = false;
+            LLPointer<LLImageMipChain> mips = build(data, size, size, 4, params);
+            ensure("coverage lost without correction", coverage(mips, 3) < target * 0.5f);
+
+            params.mPreserveAlphaCoverage = true;
+            mips = build(data, size, size, 4, params);
+            for (S32 level = 1; level <= 4; ++level)
+            {
+                ensure("coverage kept", fabsf(coverage(mips, level) - target) < 0.1f);
+            }
+            // Colors aren't touched by the alpha scale
+            const U8* texel = mips->getLevelData(2);
+            ensure("color kept", texel[0] >= 254 && texel[1] >= 254 && texel[2] >= 254);
+        }
+    }
+}
@@ -0,0 +1,231 @@
+/**
+ * @file llimagesimd_test.cpp
+ * @brief LLImageSIMD kernels compared against their scalar reference
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llimagesimd.h"
+#include "llmath.h"
+
+#include "../test/lltut.h"
+
+#include <vector>
+
+namespace tut
+{
+    struct imagesimd_test
+    {
+        imagesimd_test()
+        :   mSeed(12345)
+        ,   mKernels(LLImageSIMD::getKernels())
+        {
+        }
+
+        ~imagesimd_test()
+        {
+            LLImageSIMD::setKernels(mKernels);
+        }
+
+        // Deterministic noise, with a third of the alpha channel forced
+        // to the fully transparent and fully opaque fast paths
+        std::vector<U8> noise(S32 pixels, S32 components)
+        {
+            std::vector<U8> data(pixels * components);
+            for (U8& value : data)
+            {
+                mSeed = mSeed * 1103515245 + 12345;
+                value = U8(mSeed >> 16);
+            }
+            if (components == 4)
+            {
+                for (S32 i = 0; i < pixels; i += 3)
+                {
+                    data[i * 4 + 3] = (i & 1) ? 255 : 0;
+                }
+            }
+            return data;
+        }
+
+        static S32 maxDifference(const std::vector<U8>& a, const std::vector<U8>& b)
+        {
+            S32 result = 0;
+            for (size_t i = 0; i < a.size(); ++i)
+            {
+                result = llmax(result, llabs(S32(a[i]) - S32(b[i])));
+            }
+            return result;
+        }
+
+        U32 mSeed;
+        LLImageSIMD::EKernels mKernels;
+    };
+    typedef test_group<imagesimd_test> imagesimd_t;
+    typedef imagesimd_t::object imagesimd_object_t;
+    tut::imagesimd_t tut_imagesimd("LLImageSIMD");
+
+    // Odd sizes so that every kernel runs both its vector body and its tail
+    const S32 WIDTHS[] = { 1, 3, 7, 16, 33, 130 };
+    const S32 HEIGHT = 5;
+
+    template<> template<>
+    void imagesimd_object_t::test<1>()
+    {
+        set_test_name("scalar reference");
+
+        LLImageSIMD::setKernels(LLImageSIMD::KERNELS_SCALAR);
+        ensure_equals("kernels", LLImageSIMD::getKernels(), LLImageSIMD::KERNELS_SCALAR);
+
+        const U8 src[] = { 10, 20, 30, 0,   40, 50, 60, 255,   200, 100, 0, 128 };
+        U8 dst[] = { 100, 100, 100,   100, 100, 100,   100, 100, 100 };
+        LLImageSIMD::composite4onto3(src, dst, 3);
+        ensure_equals("transparent keeps dst", dst[0], 100);
+        ensure_equals("opaque copies src", dst[3], 40);
+        ensure_equals("blend r", dst[6], 150);
+        ensure_equals("blend b", dst[8], 50);
+
+        U8 rgba[12];
+        LLImageSIMD::copy3onto4(dst, rgba, 3);
+        ensure_equals("alpha filled", rgba[7], 255);
+        ensure_equals("rgb copied", rgba[4], 40);
+
+        U8 rows[] = { 1, 2, 3, 4, 5, 6 };
+        LLImageSIMD::flipRows(rows, 2, 3);
+        ensure_equals("first row", rows[0], 5);
+        ensure_equals("middle row", rows[2], 3);
+        ensure_equals("last row", rows[5], 2);
+    }
+
+    template<> template<>
+    void imagesimd_object_t::test<2>()
+    {
+        set_test_name("conversions match scalar");
+
+        for (S32 kernels = LLImageSIMD::KERNELS_VECTOR; kernels <= LLImageSIMD::getSupportedKernels(); ++kernels)
+        {
+            std::string name = LLImageSIMD::getKernelsName((LLImageSIMD::EKernels)kernels);
+            for (S32 width : WIDTHS)
+            {
+                S32 pixels = width * HEIGHT;
+                std::vector<U8> rgb = noise(pixels, 3);
+                std::vector<U8> rgba = noise(pixels, 4);
+
+                std::vector<U8> expected(pixels * 4), actual(pixels * 4);
+                LLImageSIMD::setKernels(LLImageSIMD::KERNELS_SCALAR);
+                LLImageSIMD::copy3onto4(rgb.data(), expected.data(), pixels);
+                LLImageSIMD::setKernels((LLImageSIMD::EKernels)kernels);
+                LLImageSIMD::copy3onto4(rgb.data(), actual.data(), pixels);
+                ensure(name + " copy3onto4", expected == actual);
+
+                expected.assign(pixels * 3, 0);
+                actual.assign(pixels * 3, 0);
+                LLImageSIMD::setKernels(LLImageSIMD::KERNELS_SCALAR);
+                LLImageSIMD::copy4onto3(rgba.data(), expected.data(), pixels);
+                LLImageSIMD::setKernels((LLImageSIMD::EKernels)kernels);
+                LLImageSIMD::copy4onto3(rgba.data(), actual.data(), pixels);
+                ensure(name + " copy4onto3", expected == actual);
+
+                expected = rgb;
+                actual = rgb;
+                LLImageSIMD::setKernels(LLImageSIMD::KERNELS_SCALAR);
+                LLImageSIMD::composite4onto3(rgba.data(), expected.data(), pixels);
+                LLImageSIMD::setKernels((LLImageSIMD::EKernels)kernels);
+                LLImageSIMD::composite4onto3(rgba.data(), actual.data(), pixels);
+                ensure(name + " composite4onto3", expected == actual);
+
+                expected = rgb;
+                actual = rgb;
+                LLImageSIMD::setKernels(LLImageSIMD::KERNELS_SCALAR);
+                LLImageSIMD::flipRows(expected.data(), width * 3, HEIGHT);
+                LLImageSIMD::setKernels((LLImageSIMD::EKernels)kernels);
+                LLImageSIMD::flipRows(actual.data(), width * 3, HEIGHT);
+                ensure(name + " flipRows", expected == actual);
+            }
+        }
+    }
+
+    template<> template<>
+    void imagesimd_object_t::test<3>()
+    {
+        set_test_name("resampling matches scalar");
+
+        const S32 sizes[][4] = {
+            { 33, 17, 64, 64 },     // up
+            { 130, 70, 32, 16 },    // down
+            { 33, 70, 64, 16 },     // up horizontally, down vertically
+            { 130, 17, 32, 64 },    // down horizontally, up vertically
+            { 7, 3, 7, 3 },         // same size
+        };
+
+        for (S32 kernels = LLImageSIMD::KERNELS_VECTOR; kernels <= LLImageSIMD::getSupportedKernels(); ++kernels)
+        {
+            std::string name = LLImageSIMD::getKernelsName((LLImageSIMD::EKernels)kernels);
+            for (const auto& size : sizes)
+            {
+                for (S32 components : { 1, 3, 4 })
+                {
+                    std::vector<U8> src = noise(size[0] * size[1], components);
+                    std::vector<U8> expected(size[2] * size[3] * components);
+                    std::vector<U8> actual(expected.size());
+
+                    LLImageSIMD::setKernels(LLImageSIMD::KERNELS_SCALAR);
+                    LLImageSIMD::bilinearScale(src.data(), size[0], size[1], components, size[0] * components,
+                                               expected.data(), size[2], size[3], size[2] * components);
+                    LLImageSIMD::setKernels((LLImageSIMD::EKernels)kernels);
+                    LLImageSIMD::bilinearScale(src.data(), size[0], size[1], components, size[0] * components,
+                                               actual.data(), size[2], size[3], size[2] * components);
+                    ensure(name + " bilinearScale", expected == actual);
+
+                    // One column, stepping a row at a time, as compositeScaled4onto3() does
+                    std::vector<U8> line_expected(size[3] * components);
+                    std::vector<U8> line_actual(line_expected.size());
+                    LLImageSIMD::setKernels(LLImageSIMD::KERNELS_SCALAR);
+                    LLImageSIMD::copyLineScaled(src.data(), line_expected.data(), components, size[1], size[3], size[0], 1);
+                    LLImageSIMD::setKernels((LLImageSIMD::EKernels)kernels);
+                    LLImageSIMD::copyLineScaled(src.data(), line_actual.data(), components, size[1], size[3], size[0], 1);
+                    ensure(name + " copyLineScaled", maxDifference(line_expected, line_actual) <= 1);
+                }
+
+                std::vector<U8> row = noise(size[0], 4);
+                std::vector<U8> expected = noise(size[2], 3);
+                std::vector<U8> actual = expected;
+                LLImageSIMD::setKernels(LLImageSIMD::KERNELS_SCALAR);
+                LLImageSIMD::compositeRowScaled4onto3(row.data(), expected.data(), size[0], size[2]);
+                LLImageSIMD::setKernels((LLImageSIMD::EKernels)kernels);
+                LLImageSIMD::compositeRowScaled4onto3(row.data(), actual.data(), size[0], size[2]);
+                ensure(name + " compositeRowScaled4onto3", maxDifference(expected, actual) <= 1);
+            }
+        }
+    }
+
+    template<> template<>
+    void imagesimd_object_t::test<4>()
+    {
+        set_test_name("kernel selection");
+
+        LLImageSIMD::setKernels(LLImageSIMD::KERNELS_AVX2);
+        ensure_equals("clamped to supported", LLImageSIMD::getKernels(), LLImageSIMD::getSupportedKernels());
+        ensure("named", LLImageSIMD::getKernelsName(LLImageSIMD::getKernels()) != std::string("unknown"));
+    }
+}
@@ -29,6 +29,7 @@
 #include "linden_common.h"
 // Class to test
 #include "../llimageworker.h"
+#include "../llimagej2c.h"
 // For timer class
 #include "../llcommon/lltimer.h"
 // for lltrace class
@@ -69,6 +70,9 @@ U8* LLImageRaw::reallocateData(S32 size) { return NULL; }
 const U8* LLImageBase::getData() const { return NULL; }
 U8* LLImageBase::getData() { return NULL; }
 const std::string& LLImage::getLastThreadError() { static std::string msg; return msg; }
+bool LLImageJ2C::initDecode(LLImageRaw &raw_image, int discard_level, int* region) { return false; }
+bool LLImageMipChain::generate(const LLImageRaw* image, const Params& params) { return false; }
+LLPointer<LLImageDXT> LLImageDXT::createCompressed(const LLImageRaw* raw_image, EFileFormat format, LLImageBC::EQuality quality) { return NULL; }
 
 // End Stubbing
 // -------------------------------------------------------------------------------------------
@@ -166,4 +170,44 @@ namespace tut
         // Verifies that the responder has now been called
         ensure("LLImageDecodeThread: threaded work unit not processed", done == true);
     }
+
+    template<> template<>
+    void imagedecodethread_object_t::test<2>()
+    {
+        // Partial decode parameters and their cache keys
+        LLImageDecodeThread::DecodeParams params;
+        ensure("LLImageDecodeThread: default params not a full decode", params.isFullImage());
+        ensure("LLImageDecodeThread: full decode has a cache key", params.getCacheKey().empty());
+
+        LLImageDecodeThread::DecodeParams alpha;
+        alpha.mFirstChannel = 3;
+        alpha.mMaxChannelCount = 1;
+        ensure("LLImageDecodeThread: channel subset is a full decode", !alpha.isFullImage());
+
+        LLImageDecodeThread::DecodeParams rect;
+        rect.setRegion(0, 0, 64, 32);
+        ensure("LLImageDecodeThread: region not set", rect.hasRegion());
+        ensure("LLImageDecodeThread: region decode is a full decode", !rect.isFullImage());
+        ensure("LLImageDecodeThread: partial decodes share a cache key", alpha.getCacheKey() != rect.getCacheKey());
+        ensure("LLImageDecodeThread: empty cache key for partial decode", !alpha.getCacheKey().empty() && !rect.getCacheKey().empty());
+
+        LLImageDecodeThread::DecodeParams empty;
+        empty.setRegion(8, 8, 8, 16);
+        ensure("LLImageDecodeThread: empty region accepted", !empty.hasRegion());
+
+        // A partial request goes through the queue like any other
+        mThread = new LLImageDecodeThread(true);
+        bool done = false;
+        LLImageDecodeThread::handle_t decodeHandle = mThread->decodeImage(NULL, 0, alpha, new responder_test(&done));
+        ensure("LLImageDecodeThread:  partial decodeImage(), returned handle is null", decodeHandle != 0);
+        const U32 INCREMENT_TIME = 500;
+        const U32 MAX_TIME = 20 * INCREMENT_TIME;
+        U32 total_time = 0;
+        while ((done == false) && (total_time < MAX_TIME))
+        {
+            ms_sleep(INCREMENT_TIME);
+            total_time += INCREMENT_TIME;
+        }
+        ensure("LLImageDecodeThread: partial work unit not processed", done == true);
+    }
 }
@@ -32,6 +32,8 @@
 
 #include "lltimer.h"
 
+#include <algorithm>
+
 struct LLJp2StreamReader
 {
     LLJp2StreamReader(LLImageJ2C* pImage) : m_pImage(pImage), m_Position(0) { }
@@ -215,15 +217,297 @@ int ceildivpow2(int a, int b)
     return (a + (1 << b) - 1) >> b;
 }
 
+// An open OpenJPEG decoder positioned after the main header.  OpenJPEG
+// (2.3 and later) keeps the codestream of a single-tiled image in memory
+// after decoding it, so the same codec can decode it again at another
+// resolution factor without re-reading and re-parsing the tile parts.
+// Second Life textures are single-tiled; anything else decodes once.
+struct LLImageJ2COJ::DecodeSession
+{
+    DecodeSession(LLImageJ2C &base)
+        : mStreamReader(&base),
+          mData(base.getData()),
+          mDataSize(base.getDataSize())
+    {
+        // Ends with the EOC marker.  A partial download is replaced by a
+        // longer buffer when more arrives, so its session is never reused.
+        mComplete = mDataSize >= 2 && mData[mDataSize - 2] == 0xff && mData[mDataSize - 1] == 0xd9;
+    }
+
+    ~DecodeSession()
+    {
+        if (mImage)
+        {
+            opj_image_destroy(mImage);
+        }
+        if (mDecoded)
+        {
+            opj_end_decompress(mCodec, mStream);
+        }
+        if (mStream)
+        {
+            opj_stream_destroy(mStream);
+        }
+        if (mCodec)
+        {
+            opj_destroy_codec(mCodec);
+        }
+    }
+
+    // Only valid while the base image still holds the same codestream
+    // and the same part of it is wanted
+    bool canResume(LLImageJ2C &base, S32 first_channel, S32 max_channel_count, const S32* region) const
+    {
+        return mResumable && mDecoded &&
+            mData == base.getData() && mDataSize == base.getDataSize() &&
+            mFirstChannel == first_channel && mMaxChannelCount == max_channel_count &&
+            mHasRegion == (region != nullptr) &&
+            (!region || std::equal(region, region + 4, mRequestedRegion));
+    }
+
+    // Decode only the requested components and area.  Called once,
+    // after open().  Components are only skipped when that doesn't
+    // split the three that share the multiple component transform.
+    bool restrict(S32 first_channel, S32 max_channel_count, const S32* region)
+    {
+        mFirstChannel = first_channel;
+        mMaxChannelCount = max_channel_count;
+
+        S32 channels = llmin(mNumComps - first_channel, max_channel_count);
+        if (channels < mNumComps &&
+            ((first_channel == 0 && channels >= llmin(mNumComps, 3)) || first_channel >= 3))
+        {
+            std::vector<OPJ_UINT32> indices(channels);
+            for (S32 i = 0; i < channels; ++i)
+            {
+                indices[i] = first_channel + i;
+            }
+            if (!opj_set_decoded_components(mCodec, channels, indices.data(), OPJ_FALSE))
+            {
+                return false;
+            }
+            mComponentOffset = first_channel;
+        }
+
+        if (region)
+        {
+            // Flip from LLImageRaw's bottom-up rows to the codestream's
+            S32 width = mImage->x1 - mImage->x0;
+            S32 height = mImage->y1 - mImage->y0;
+            mRegion[0] = llclamp(region[0], 0, width);
+            mRegion[1] = llclamp(region[1], 0, height);
+            mRegion[2] = llclamp(region[2], mRegion[0], width);
+            mRegion[3] = llclamp(region[3], mRegion[1], height);
+            mHasRegion = mRegion[2] > mRegion[0] && mRegion[3] > mRegion[1];
+            if (!mHasRegion)
+            {
+                return false;
+            }
+            std::copy(region, region + 4, mRequestedRegion);
+        }
+        return true;
+    }
+
+    bool open(S32 reduce, S32 threads)
+    {
+        opj_dparameters_t parameters;   /* decompression parameters */
+
+        /* set decoding parameters to default values */
+        opj_set_default_decoder_parameters(&parameters);
+
+        parameters.cp_reduce = reduce;
+
+        /* get a decoder handle */
+        mCodec = opj_create_decompress(OPJ_CODEC_J2K);
+        if (!mCodec)
+        {
+            return false;
+        }
+
+#if 0
+        /* catch events using our callbacks and give a local context */
+        opj_set_error_handler(mCodec, error_callback, nullptr);
+        opj_set_warning_handler(mCodec, warning_callback, nullptr);
+        opj_set_info_handler(mCodec, info_callback, nullptr);
+#endif
+
+        /* setup the decoder decoding parameters using user parameters */
+        if (!opj_setup_decoder(mCodec, &parameters))
+        {
+            return false;
+        }
+
+        //opj_decoder_set_strict_mode(mCodec, OPJ_FALSE);
+
+        if (threads > 1)
+        {
+            // Failure leaves the codec single threaded, which is fine
+            opj_codec_set_threads(mCodec, threads);
+        }
+
+        /* open a byte stream */
+        mStream = opj_stream_default_create(OPJ_STREAM_READ);
+        opj_stream_set_read_function(mStream, LLJp2StreamReader::readStream);
+        opj_stream_set_skip_function(mStream, LLJp2StreamReader::skipStream);
+        opj_stream_set_seek_function(mStream, LLJp2StreamReader::seekStream);
+        opj_stream_set_user_data(mStream, &mStreamReader, nullptr);
+        opj_stream_set_user_data_length(mStream, mDataSize);
+
+        if (!opj_read_header(mStream, mCodec, &mImage) || !mImage)
+        {
+            return false;
+        }
+        mNumComps = mImage->numcomps;
+
+        opj_codestream_info_v2_t* info = opj_get_cstr_info(mCodec);
+        if (info)
+        {
+            mResumable = (info->tw == 1 && info->th == 1);
+            opj_destroy_cstr_info(&info);
+        }
+        return true;
+    }
+
+    bool decode(S32 reduce, bool resumed)
+    {
+        // Recompute the output dimensions for the new factor.  The
+        // tile data read by the previous decode is used as is.
+        if (resumed && !opj_set_decoded_resolution_factor(mCodec, reduce))
+        {
+            return false;
+        }
+        if (mHasRegion)
+        {
+            S32 height = mImage->y1 - mImage->y0;
+            if (!opj_set_decode_area(mCodec, mImage,
+                                     mImage->x0 + mRegion[0], mImage->y0 + height - mRegion[3],
+                                     mImage->x0 + mRegion[2], mImage->y0 + height - mRegion[1]))
+            {
+                return false;
+            }
+        }
+        else if (resumed && !opj_set_decode_area(mCodec, mImage, 0, 0, 0, 0))
+        {
+            return false;
+        }
+
+        /* decode the stream and fill the image structure */
+        mDecoded = opj_decode(mCodec, mStream, mImage);
+        return mDecoded && mImage->numcomps;
+    }
+
+    void releaseSamples()
+    {
+        for (OPJ_UINT32 comp = 0; comp < mImage->numcomps; ++comp)
+        {
+            opj_image_data_free(mImage->comps[comp].data);
+            mImage->comps[comp].data = nullptr;
+        }
+    }
+
+    LLJp2StreamReader mStreamReader;
+    opj_codec_t*  mCodec = nullptr;
+    opj_stream_t* mStream = nullptr;
+    opj_image_t*  mImage = nullptr;
+    const U8*     mData;
+    size_t        mDataSize;
+    S32           mNumComps = 0;       // in the codestream
+    S32           mFirstChannel = 0;   // as requested
+    S32           mMaxChannelCount = 0;
+    S32           mComponentOffset = 0; // first component in mImage when only some are decoded
+    S32           mRequestedRegion[4] = { 0, 0, 0, 0 };
+    S32           mRegion[4] = { 0, 0, 0, 0 };  // clamped to the image
+    bool          mHasRegion = false;
+    bool          mResumable = false;  // single tile, may be decoded again
+    bool          mComplete = false;   // whole codestream, no more data coming
+    bool          mDecoded = false;
+};
+
 LLImageJ2COJ::LLImageJ2COJ()
-    : LLImageJ2CImpl()
+    : LLImageJ2CImpl(),
+      mRegion{ 0, 0, 0, 0 },
+      mHasRegion(false)
+{
+}
+
+LLImageJ2COJ::~LLImageJ2COJ()
+{
+    resetDecodeState();
+}
+
+std::mutex LLImageJ2COJ::sRetainedMutex;
+std::list<LLImageJ2COJ*> LLImageJ2COJ::sRetained;
+std::atomic<U64> LLImageJ2COJ::sResumedDecodes{ 0 };
+
+// static
+S32 LLImageJ2COJ::getRetainedSessionCount()
+{
+    std::lock_guard<std::mutex> lock(sRetainedMutex);
+    return (S32)sRetained.size();
+}
+
+// static
+U64 LLImageJ2COJ::getResumedDecodeCount()
+{
+    return sResumedDecodes;
+}
+
+void LLImageJ2COJ::retainSession()
+{
+    std::lock_guard<std::mutex> lock(sRetainedMutex);
+    // Most recently used at the back
+    sRetained.remove(this);
+    sRetained.push_back(this);
+
+    // A decoder busy with a decode of its own is skipped, it can't be
+    // waited for while holding sRetainedMutex
+    auto it = sRetained.begin();
+    while ((S32)sRetained.size() > MAX_RETAINED_SESSIONS && *it != this)
+    {
+        LLImageJ2COJ* oldest = *it;
+        if (oldest->mSessionMutex.try_lock())
+        {
+            oldest->mDecodeSession.reset();
+            oldest->mSessionMutex.unlock();
+            it = sRetained.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void LLImageJ2COJ::releaseSession()
+{
+    if (mDecodeSession)
+    {
+        mDecodeSession.reset();
+        std::lock_guard<std::mutex> lock(sRetainedMutex);
+        sRetained.remove(this);
+    }
+}
+
+void LLImageJ2COJ::resetDecodeState()
 {
+    std::lock_guard<std::mutex> lock(mSessionMutex);
+    releaseSession();
 }
 
 bool LLImageJ2COJ::initDecode(LLImageJ2C &base, LLImageRaw &raw_image, int discard_level, int* region)
 {
-    // No specific implementation for this method in the OpenJpeg case
-    return false;
+    if (discard_level >= 0)
+    {
+        base.setDiscardLevel(discard_level);
+    }
+
+    // Applies to the next decode only
+    mHasRegion = (region != nullptr);
+    if (region)
+    {
+        std::copy(region, region + 4, mRegion);
+    }
+    return true;
 }
 
 bool LLImageJ2COJ::initEncode(LLImageJ2C &base, LLImageRaw &raw_image, int blocks_size, int precincts_size, int levels)
@@ -275,102 +559,72 @@ bool LLImageJ2COJ::decodeImpl(LLImageJ2C &base, LLImageRaw &raw_image, F32 decod
         ++position;
     }
 
-    opj_dparameters_t parameters;   /* decompression parameters */
-    opj_image_t *image = NULL;
-
-    /* set decoding parameters to default values */
-    opj_set_default_decoder_parameters(&parameters);
-
-    parameters.cp_reduce = base.getRawDiscardLevel();
-
-    /* decode the code-stream */
-    /* ---------------------- */
-
-    /* JPEG-2000 codestream */
-
-    /* get a decoder handle */
-    opj_codec_t* opj_decoder_p = opj_create_decompress(OPJ_CODEC_J2K);
-    if (!opj_decoder_p)
+    // Reuse the codec from the previous decode when refining the same
+    // codestream, otherwise start a new session.
+    // A multithreaded decode needs a codec of its own: OpenJPEG fixes
+    // the thread count when the header is read.
+    std::lock_guard<std::mutex> session_lock(mSessionMutex);
+    S32 reduce = llmax((S32)base.getRawDiscardLevel(), 0);
+    S32 threads = opj_has_thread_support() ? base.getDecodeThreads() : 1;
+    const S32* region = mHasRegion ? mRegion : nullptr;
+    mHasRegion = false;
+    bool resumed = threads <= 1 && mDecodeSession &&
+                   mDecodeSession->canResume(base, first_channel, max_channel_count, region);
+    if (resumed)
+    {
+        ++sResumedDecodes;
+    }
+    else
     {
+        releaseSession();
+        mDecodeSession = std::make_unique<DecodeSession>(base);
+        if (!mDecodeSession->open(reduce, threads))
+        {
 #ifdef SHOW_DEBUG
-        LL_DEBUGS("Texture") << "ERROR -> decodeImpl: failed to create decoder!" << LL_ENDL;
+            LL_DEBUGS("Texture") << "ERROR -> decodeImpl: failed to read header!" << LL_ENDL;
 #endif
-        base.decodeFailed();
-        return true; // done
-    }
+            releaseSession();
+            base.decodeFailed();
+            return true; // done
+        }
 
-#if 0
-    /* catch events using our callbacks and give a local context */
-    opj_set_error_handler(opj_decoder_p, error_callback, nullptr);
-    opj_set_warning_handler(opj_decoder_p, warning_callback, nullptr);
-    opj_set_info_handler(opj_decoder_p, info_callback, nullptr);
-#endif
+        if (mDecodeSession->mNumComps <= first_channel)
+        {
+            LL_WARNS() << "trying to decode more channels than are present in image: numcomps: " << mDecodeSession->mNumComps << " first_channel: " << first_channel << LL_ENDL;
+            releaseSession();
+            base.decodeFailed();
+            return true; // done
+        }
 
-    /* setup the decoder decoding parameters using user parameters */
-    if (!opj_setup_decoder(opj_decoder_p, &parameters))
-    {
+        if (!mDecodeSession->restrict(first_channel, max_channel_count, region))
+        {
 #ifdef SHOW_DEBUG
-        LL_DEBUGS("Texture") << "ERROR -> decodeImpl: failed to decode image!" << LL_ENDL;
+            LL_DEBUGS("Texture") << "ERROR -> decodeImpl: invalid channels or region!" << LL_ENDL;
 #endif
-        opj_destroy_codec(opj_decoder_p);
-        base.decodeFailed();
-        return true; // done
+            releaseSession();
+            base.decodeFailed();
+            return true; // done
+        }
     }
 
-    //opj_decoder_set_strict_mode(opj_decoder_p, OPJ_FALSE);
-
-    /* open a byte stream */
-    LLJp2StreamReader streamReader(&base);
-    opj_stream_t* opj_stream_p = opj_stream_default_create(OPJ_STREAM_READ);
-    opj_stream_set_read_function(opj_stream_p, LLJp2StreamReader::readStream);
-    opj_stream_set_skip_function(opj_stream_p, LLJp2StreamReader::skipStream);
-    opj_stream_set_seek_function(opj_stream_p, LLJp2StreamReader::seekStream);
-    opj_stream_set_user_data(opj_stream_p, &streamReader, nullptr);
-    opj_stream_set_user_data_length(opj_stream_p, base.getDataSize());
-
-    /* decode the stream and fill the image structure */
-    bool success = opj_read_header(opj_stream_p, opj_decoder_p, &image) &&
-                    opj_decode(opj_decoder_p, opj_stream_p, image) &&
-                    opj_end_decompress(opj_decoder_p, opj_stream_p);
-
-    /* close the byte stream */
-    opj_stream_destroy(opj_stream_p);
-
-    /* free remaining structures */
-    opj_destroy_codec(opj_decoder_p);
-
-
     // The image decode failed if the return was NULL or the component
     // count was zero.  The latter is just a sanity check before we
     // dereference the array.
-    if (!success || !image || !image->numcomps)
+    if (!mDecodeSession->decode(reduce, resumed))
     {
 #ifdef SHOW_DEBUG
         LL_DEBUGS("Texture") << "ERROR -> decodeImpl: failed to decode image!" << LL_ENDL;
 #endif
-        if (image)
-        {
-            opj_image_destroy(image);
-        }
+        releaseSession();
         base.decodeFailed();
         return true; // done
     }
 
-    if(image->numcomps <= first_channel)
-    {
-        LL_WARNS() << "trying to decode more channels than are present in image: numcomps: " << image->numcomps << " first_channel: " << first_channel << LL_ENDL;
-        if (image)
-        {
-            opj_image_destroy(image);
-        }
-        base.decodeFailed();
-
-        return true;
-    }
+    opj_image_t* image = mDecodeSession->mImage;
 
     // Copy image data into our raw image format (instead of the separate channel format
 
-    S32 img_components = image->numcomps;
+    S32 img_components = mDecodeSession->mNumComps;
     S32 channels = img_components - first_channel;
     if( channels > max_channel_count )
         channels = max_channel_count;
@@ -386,11 +640,17 @@ bool LLImageJ2COJ::decodeImpl(LLImageJ2C &base, LLImageRaw &raw_image, F32 decod
     S32 f=image->comps[0].factor;
     S32 width = ceildivpow2(image->x1 - image->x0, f);
     S32 height = ceildivpow2(image->y1 - image->y0, f);
+    if (mDecodeSession->mHasRegion)
+    {
+        // Sub-rect edges round separately, take the size OpenJPEG used
+        width = image->comps[0].w;
+        height = image->comps[0].h;
+    }
     raw_image.resize(width, height, channels);
     U8 *rawp = raw_image.getData();
     if (!rawp)
     {
-        opj_image_destroy(image);
+        releaseSession();
         base.setLastError("Memory error");
         base.decodeFailed();
         return true; // done
@@ -399,17 +659,20 @@ bool LLImageJ2COJ::decodeImpl(LLImageJ2C &base, LLImageRaw &raw_image, F32 decod
     // first_channel is what channel to start copying from
     // dest is what channel to copy to.  first_channel comes from the
     // argument, dest always starts writing at channel zero.
+    // When only some components were decoded, image->comps starts at
+    // the first of them.
     for (S32 comp = first_channel, dest=0; comp < first_channel + channels;
         comp++, dest++)
     {
-        if (image->comps[comp].data)
+        const opj_image_comp_t& image_comp = image->comps[comp - mDecodeSession->mComponentOffset];
+        if (image_comp.data)
         {
             S32 offset = dest;
             for (S32 y = (height - 1); y >= 0; y--)
             {
                 for (S32 x = 0; x < width; x++)
                 {
-                    rawp[offset] = image->comps[comp].data[y*comp_width + x];
+                    rawp[offset] = image_comp.data[y*comp_width + x];
                     offset += channels;
                 }
             }
@@ -419,14 +682,25 @@ bool LLImageJ2COJ::decodeImpl(LLImageJ2C &base, LLImageRaw &raw_image, F32 decod
 #ifdef SHOW_DEBUG
             LL_DEBUGS("Texture") << "ERROR -> decodeImpl: failed to decode image! (NULL comp data - OpenJPEG bug)" << LL_ENDL;
 #endif
-            opj_image_destroy(image);
+            releaseSession();
             base.decodeFailed();
             return true; // done
         }
     }
 
-    /* free image data structure */
-    opj_image_destroy(image);
+    if (reduce <= 0 || threads > 1 || !mDecodeSession->mResumable || !mDecodeSession->mComplete)
+    {
+        // Fully refined (or nothing to carry over), free the codec.
+        // Multithreaded codecs aren't kept since they own a thread pool.
+        releaseSession();
+    }
+    else
+    {
+        // Keep the codestream but not the decoded samples, the
+        // next decode produces a new set at its own resolution.
+        mDecodeSession->releaseSamples();
+        retainSession();
+    }
 
     return true; // done
 }
@@ -29,11 +29,23 @@
 
 #include "llimagej2c.h"
 
+#include <atomic>
+#include <list>
+#include <mutex>
+
 class LLImageJ2COJ final : public LLImageJ2CImpl
 {
 public:
     LLImageJ2COJ();
-    virtual ~LLImageJ2COJ() = default;
+    virtual ~LLImageJ2COJ();
+
+    // Decoders holding on to a session, at most MAX_RETAINED_SESSIONS
+    static S32 getRetainedSessionCount();
+    // Decodes that reused the previous decode's session
+    static U64 getResumedDecodeCount();
+
+    static constexpr S32 MAX_RETAINED_SESSIONS = 32;
+
 protected:
     virtual bool getMetadata(LLImageJ2C &base);
     virtual bool decodeImpl(LLImageJ2C &base, LLImageRaw &raw_image, F32 decode_time, S32 first_channel, S32 max_channel_count);
@@ -42,6 +54,30 @@ class LLImageJ2COJ final : public LLImageJ2CImpl
     virtual bool initDecode(LLImageJ2C &base, LLImageRaw &raw_image, int discard_level = -1, int* region = NULL);
     virtual bool initEncode(LLImageJ2C &base, LLImageRaw &raw_image, int blocks_size = -1, int precincts_size = -1, int levels = 0);
     virtual std::string getEngineInfo() const;
+    virtual void resetDecodeState();
+
+private:
+    // Codec state kept between decodes of the same codestream so that
+    // refining a texture to a lower discard level doesn't start over.
+    struct DecodeSession;
+    std::unique_ptr<DecodeSession> mDecodeSession;
+    // Held for a whole decode and whenever mDecodeSession changes
+    std::mutex mSessionMutex;
+
+    // Keeping a session registers the decoder in a process wide list,
+    // the least recently used one is evicted when the list is full.
+    // Both are called with mSessionMutex held.
+    void retainSession();
+    void releaseSession();
+
+    static std::mutex sRetainedMutex;
+    static std::list<LLImageJ2COJ*> sRetained;
+    static std::atomic<U64> sResumedDecodes;
+
+    // Sub-rect from initDecode() for the next decode, full resolution
+    // pixels with rows bottom up as in LLImageRaw: x0, y0, x1, y1
+    S32 mRegion[4];
+    bool mHasRegion;
 };
 
 #endif
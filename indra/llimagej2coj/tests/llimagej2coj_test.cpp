@@ -0,0 +1,175 @@
+/**
+ * @file llimagej2coj_test.cpp
+ * @brief LLImageJ2COJ decode sessions kept between discard levels
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llimagej2coj.h"
+#include "llimage.h"
+#include "llimagebufferpool.h"
+
+#include "../test/lltut.h"
+
+#include <vector>
+
+namespace tut
+{
+    struct imagej2coj_test
+    {
+        static const S32 SIZE = 128;
+
+        imagej2coj_test()
+        {
+            // Single tiled, six resolution levels, as textures are encoded
+            LLPointer<LLImageRaw> raw = new LLImageRaw(SIZE, SIZE, 3);
+            U8* data = raw->getData();
+            for (S32 y = 0; y < SIZE; ++y)
+            {
+                for (S32 x = 0; x < SIZE; ++x, data += 3)
+                {
+                    data[0] = (U8)(x * 2);
+                    data[1] = (U8)(y * 2);
+                    data[2] = (U8)(((x / 8) ^ (y / 8)) & 1 ? 224 : 32);
+                }
+            }
+            mEncoded = new LLImageJ2C;
+            ensure("encoded", mEncoded->encode(raw, 0.f));
+        }
+
+        // Another image holding the whole codestream
+        LLPointer<LLImageJ2C> copy() const
+        {
+            LLPointer<LLImageJ2C> image = new LLImageJ2C;
+            image->setData(bytes(0, mEncoded->getDataSize()), mEncoded->getDataSize());
+            image->updateData();
+            return image;
+        }
+
+        // Bytes [offset, offset + size) of the codestream in a buffer an
+        // LLImageFormatted can take over, as fetched data arrives
+        U8* bytes(S32 offset, S32 size) const
+        {
+            U8* data = LLImageBufferPool::allocate(size);
+            memcpy(data, mEncoded->getData() + offset, size);
+            return data;
+        }
+
+        static LLPointer<LLImageRaw> decode(LLImageJ2C* image, S32 discard)
+        {
+            LLPointer<LLImageRaw> raw = new LLImageRaw;
+            image->initDecode(*raw, discard, nullptr);
+            image->decode(raw, 0.f);
+            return raw;
+        }
+
+        static bool same(const LLImageRaw* a, const LLImageRaw* b)
+        {
+            return a->getWidth() == b->getWidth() && a->getHeight() == b->getHeight() &&
+                a->getComponents() == b->getComponents() && a->getDataSize() == b->getDataSize() &&
+                a->getData() && !memcmp(a->getData(), b->getData(), a->getDataSize());
+        }
+
+        LLPointer<LLImageJ2C> mEncoded;
+    };
+    typedef test_group<imagej2coj_test> imagej2coj_t;
+    typedef imagej2coj_t::object imagej2coj_object_t;
+    tut::imagej2coj_t tut_imagej2coj("LLImageJ2COJ");
+
+    template<> template<>
+    void imagej2coj_object_t::test<1>()
+    {
+        set_test_name("refining a decoded codestream resumes its session");
+
+        LLPointer<LLImageJ2C> image = copy();
+        LLPointer<LLImageRaw> low = decode(image, 2);
+        ensure_equals("discard 2 width", low->getWidth(), SIZE / 4);
+        ensure_equals("session kept", LLImageJ2COJ::getRetainedSessionCount(), 1);
+
+        U64 resumed = LLImageJ2COJ::getResumedDecodeCount();
+        LLPointer<LLImageRaw> full = decode(image, 0);
+        ensure_equals("resumed", LLImageJ2COJ::getResumedDecodeCount(), resumed + 1);
+        ensure_equals("session freed at full resolution", LLImageJ2COJ::getRetainedSessionCount(), 0);
+
+        // Same pixels as decoding from scratch
+        LLPointer<LLImageRaw> fresh = decode(copy(), 0);
+        ensure_equals("fresh decode not resumed", LLImageJ2COJ::getResumedDecodeCount(), resumed + 1);
+        ensure_equals("full width", full->getWidth(), SIZE);
+        ensure("same as a fresh decode", same(full, fresh));
+    }
+
+    template<> template<>
+    void imagej2coj_object_t::test<2>()
+    {
+        set_test_name("partial codestreams and new data don't keep a session");
+
+        // A texture being fetched: whatever the decode of the partial data
+        // gives, the rest arrives in a new buffer
+        S32 size = mEncoded->getDataSize();
+        S32 head = size * 2 / 3;
+        LLPointer<LLImageJ2C> image = new LLImageJ2C;
+        image->setData(bytes(0, head), head);
+        image->updateData();
+        decode(image, 2);
+        ensure_equals("partial not kept", LLImageJ2COJ::getRetainedSessionCount(), 0);
+
+        image->appendData(bytes(head, size - head), size - head);
+        decode(image, 2);
+        ensure_equals("complete kept", LLImageJ2COJ::getRetainedSessionCount(), 1);
+
+        image->setData(bytes(0, size), size);
+        ensure_equals("freed with the data", LLImageJ2COJ::getRetainedSessionCount(), 0);
+
+        U64 resumed = LLImageJ2COJ::getResumedDecodeCount();
+        decode(image, 0);
+        ensure_equals("new data not resumed", LLImageJ2COJ::getResumedDecodeCount(), resumed);
+    }
+
+    template<> template<>
+    void imagej2coj_object_t::test<3>()
+    {
+        set_test_name("retained sessions are capped, oldest evicted");
+
+        const S32 EXTRA = 4;
+        std::vector<LLPointer<LLImageJ2C> > images;
+        for (S32 i = 0; i < LLImageJ2COJ::MAX_RETAINED_SESSIONS + EXTRA; ++i)
+        {
+            images.push_back(copy());
+            decode(images.back(), 1);
+        }
+        ensure_equals("capped", LLImageJ2COJ::getRetainedSessionCount(), LLImageJ2COJ::MAX_RETAINED_SESSIONS);
+
+        U64 resumed = LLImageJ2COJ::getResumedDecodeCount();
+        for (S32 i = 0; i < EXTRA; ++i)
+        {
+            decode(images[i], 0);
+        }
+        ensure_equals("oldest evicted", LLImageJ2COJ::getResumedDecodeCount(), resumed);
+        decode(images.back(), 0);
+        ensure_equals("newest kept", LLImageJ2COJ::getResumedDecodeCount(), resumed + 1);
+
+        images.clear();
+        ensure_equals("freed with the decoders", LLImageJ2COJ::getRetainedSessionCount(), 0);
+    }
+}
@@ -260,7 +260,10 @@ LLImageJ2CKDU::LLImageJ2CKDU() : LLImageJ2CImpl(),
     mDecodeState(),
     mBlocksSize(-1),
     mPrecinctsSize(-1),
-    mLevels(0)
+    mLevels(0),
+    mDecodeDiscard(-1),
+    mDecodeRegion{ 0, 0, 0, 0 },
+    mHasDecodeRegion(false)
 {
 }
 
@@ -388,12 +391,26 @@ void LLImageJ2CKDU::cleanupCodeStream()
     mTileIndicesp.reset();
 }
 
-// This is the protected virtual method called by LLImageJ2C::initDecode().
-// However, as far as nat can tell, LLImageJ2C::initDecode() is called only by
-// llimage_libtest.cpp's load_image() function. No detectable production use.
+// This is the protected virtual method called by LLImageJ2C::initDecode(),
+// from llimage_libtest.cpp's load_image() and from LLImageDecodeThread for
+// sub-rect requests. It only remembers the restrictions: the codestream is
+// set up by the next decodeImpl(), which knows the channels wanted.
 bool LLImageJ2CKDU::initDecode(LLImageJ2C &base, LLImageRaw &raw_image, int discard_level, int* region)
 {
-    return initDecode(base,raw_image,0.0f,MODE_FAST,0,4,discard_level,region);
+    // A codestream left from an unfinished decode would ignore them
+    cleanupCodeStream();
+
+    mDecodeDiscard = discard_level;
+    mHasDecodeRegion = (region != NULL);
+    if (region)
+    {
+        // Flip from LLImageRaw's bottom-up rows to the codestream's
+        mDecodeRegion[0] = region[0];
+        mDecodeRegion[1] = base.getHeight() - region[3];
+        mDecodeRegion[2] = region[2];
+        mDecodeRegion[3] = base.getHeight() - region[1];
+    }
+    return true;
 }
 
 bool LLImageJ2CKDU::initEncode(LLImageJ2C &base, LLImageRaw &raw_image, int blocks_size, int precincts_size, int levels)
@@ -519,7 +536,13 @@ bool LLImageJ2CKDU::decodeImpl(LLImageJ2C &base, LLImageRaw &raw_image, F32 deco
 
     if (!mCodeStreamp->exists())
     {
-        if (!initDecode(base, raw_image, decode_time, mode, first_channel, max_channel_count))
+        // Restrictions from initDecode() apply to this decode only
+        int discard_level = mDecodeDiscard;
+        int region[4] = { mDecodeRegion[0], mDecodeRegion[1], mDecodeRegion[2], mDecodeRegion[3] };
+        bool has_region = mHasDecodeRegion;
+        mDecodeDiscard = -1;
+        mHasDecodeRegion = false;
+        if (!initDecode(base, raw_image, decode_time, mode, first_channel, max_channel_count, discard_level, has_region ? region : NULL))
         {
             // Initializing the J2C decode failed, bail out.
             cleanupCodeStream();
@@ -122,6 +122,12 @@ class LLImageJ2CKDU : public LLImageJ2CImpl
     int mPrecinctsSize;
     int mLevels;
 
+    // Discard level and sub-rect from initDecode() for the next decode,
+    // the region flipped to the codestream's top-down rows
+    int mDecodeDiscard;
+    int mDecodeRegion[4];
+    bool mHasDecodeRegion;
+
     // Temporary variables for in-progress decodes...
     // We don't own this LLImageRaw. We're simply pointing to an instance
     // passed into initDecode().
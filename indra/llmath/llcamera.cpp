@@ -291,6 +291,216 @@ S32 LLCamera::AABBInRegionFrustumNoFarClip(const LLVector4a& center, const LLVec
     return AABBInFrustumNoFarClip(center, radius, mRegionPlanes);
 }
 
+U32 LLCamera::getRegionFrustumPlanes(LLPlane* planes, bool far_clip) const
+{
+    U32 count = 0;
+    U32 max_planes = llmin(mPlaneCount, (U32) AGENT_PLANE_USER_CLIP_NUM);
+    for (U32 i = 0; i < max_planes; i++)
+    {
+        if (mPlaneMask[i] < PLANE_MASK_NUM && (far_clip || i != AGENT_PLANE_FAR))
+        {
+            planes[count++] = mRegionPlanes[i];
+        }
+    }
+    return count;
+}
+
+void LLAABBBatch::reserve(U32 count)
+{
+    count = (count + 3) & ~3;
+    for (U32 i = 0; i < 3; i++)
+    {
+        mCenter[i].reserve(count);
+        mSize[i].reserve(count);
+    }
+}
+
+U32 LLAABBBatch::add(const LLVector4a& center, const LLVector4a& size)
+{
+    if (mCount + 1 > mCenter[0].size())
+    {
+        // Room for the next four, the padding is never looked at
+        for (U32 i = 0; i < 3; i++)
+        {
+            mCenter[i].resize(mCount + 4);
+            mSize[i].resize(mCount + 4);
+        }
+    }
+
+    for (U32 i = 0; i < 3; i++)
+    {
+        mCenter[i][mCount] = center[i];
+        mSize[i][mCount] = size[i];
+    }
+    return mCount++;
+}
+
+U32 LLCamera::AABBInFrustumBatch(const LLAABBBatch& boxes, U32* visible, U32* inside, bool far_clip, const LLPlane* planes) const
+{
+    if (!planes)
+    {
+        //use agent space
+        planes = mAgentPlanes;
+    }
+
+    // Splat the planes once, with the octant mask turned into the signs
+    // the half sizes get, the way sFrustumScaler is used for one box
+    LLVector4a normal[AGENT_PLANE_USER_CLIP_NUM][3];
+    LLVector4a scaler[AGENT_PLANE_USER_CLIP_NUM][3];
+    LLVector4a dist[AGENT_PLANE_USER_CLIP_NUM];
+    U32 plane_count = 0;
+    U32 max_planes = llmin(mPlaneCount, (U32) AGENT_PLANE_USER_CLIP_NUM);
+    for (U32 i = 0; i < max_planes; i++)
+    {
+        U8 mask = mPlaneMask[i];
+        if (mask < PLANE_MASK_NUM && (far_clip || i != AGENT_PLANE_FAR))
+        {
+            const LLPlane& p(planes[i]);
+            for (U32 j = 0; j < 3; j++)
+            {
+                normal[plane_count][j].splat(p[j]);
+                scaler[plane_count][j].splat(sFrustumScaler[mask][j]);
+            }
+            dist[plane_count].splat(-p[3]);
+            plane_count++;
+        }
+    }
+
+    const U32 count = boxes.getCount();
+    memset(visible, 0, LLAABBBatch::getMaskSize(count) * sizeof(U32));
+    memset(inside, 0, LLAABBBatch::getMaskSize(count) * sizeof(U32));
+
+    U32 num_visible = 0;
+    for (U32 i = 0; i < count; i += 4)
+    {
+        LLVector4a center[3], size[3];
+        for (U32 j = 0; j < 3; j++)
+        {
+            center[j].loadua(boxes.getCenter(j) + i);
+            size[j].loadua(boxes.getSize(j) + i);
+        }
+
+        const U32 lanes = (count - i >= 4) ? 0xf : (1 << (count - i)) - 1;
+        U32 out = 0;
+        U32 partial = 0;
+        for (U32 p = 0; p < plane_count; p++)
+        {
+            // Nearest and farthest corner of each box along the normal,
+            // summed in the order LLVector4a::dot3() sums
+            LLVector4a min_dot, max_dot;
+            for (U32 j = 0; j < 3; j++)
+            {
+                LLVector4a rscale, minp, maxp;
+                rscale.setMul(size[j], scaler[p][j]);
+                minp.setSub(center[j], rscale);
+                maxp.setAdd(center[j], rscale);
+                minp.mul(normal[p][j]);
+                maxp.mul(normal[p][j]);
+                if (j == 0)
+                {
+                    min_dot = minp;
+                    max_dot = maxp;
+                }
+                else
+                {
+                    min_dot.add(minp);
+                    max_dot.add(maxp);
+                }
+            }
+
+            out |= min_dot.greaterThan(dist[p]).getGatheredBits();
+            partial |= max_dot.greaterThan(dist[p]).getGatheredBits();
+            if ((out & lanes) == lanes)
+            {
+                break;
+            }
+        }
+
+        const U32 vis = ~out & lanes;
+        visible[i >> 5] |= vis << (i & 31);
+        inside[i >> 5] |= (vis & ~partial) << (i & 31);
+        num_visible += (vis & 1) + ((vis >> 1) & 1) + ((vis >> 2) & 1) + (vis >> 3);
+    }
+
+    return num_visible;
+}
+
+U32 LLCamera::AABBInRegionFrustumBatch(const LLAABBBatch& boxes, U32* visible, U32* inside, bool far_clip) const
+{
+    return AABBInFrustumBatch(boxes, visible, inside, far_clip, mRegionPlanes);
+}
+
+void LLCamera::calcPixelAreaBatch(const LLAABBBatch& boxes, F32 pixel_angle, F32* pixel_area, const U32* visible) const
+{
+    LLVector4a origin[3];
+    for (U32 j = 0; j < 3; j++)
+    {
+        origin[j].splat(mOrigin.mV[j]);
+    }
+
+    LLVector4a ramp_dist, ramp_scale, ramp_mul;
+    ramp_dist.splat(16.f);
+    ramp_scale.splat(1.f / 16.f);
+    ramp_mul.splat(16.f);
+
+    const U32 count = boxes.getCount();
+    for (U32 i = 0; i < count; i += 4)
+    {
+        const U32 lanes = (count - i >= 4) ? 0xf : (1 << (count - i)) - 1;
+        const U32 todo = visible ? (visible[i >> 5] >> (i & 31)) & lanes : lanes;
+        if (!todo)
+        {
+            continue;
+        }
+
+        LLVector4a dist_sqrd, len_sqrd;
+        for (U32 j = 0; j < 3; j++)
+        {
+            LLVector4a look_at, size;
+            look_at.loadua(boxes.getCenter(j) + i);
+            look_at.sub(origin[j]);
+            look_at.mul(look_at);
+            size.loadua(boxes.getSize(j) + i);
+            size.mul(size);
+            if (j == 0)
+            {
+                dist_sqrd = look_at;
+                len_sqrd = size;
+            }
+            else
+            {
+                dist_sqrd.add(look_at);
+                len_sqrd.add(size);
+            }
+        }
+
+        LLVector4a dist = _mm_sqrt_ps(dist_sqrd);
+        LLVector4a len = _mm_sqrt_ps(len_sqrd);
+
+        //ramp down distance for nearby objects
+        LLVector4a near_dist;
+        near_dist.setMul(dist, ramp_scale);
+        near_dist.mul(near_dist);
+        near_dist.mul(ramp_mul);
+        dist.setSelectWithMask(dist.lessThan(ramp_dist), near_dist, dist);
+
+        LLVector4a ratio;
+        ratio.setDiv(len, dist);
+
+        // atan has no vector form here, the rest is per box
+        LL_ALIGN_16(F32 tan_angle[4]);
+        ratio.store4a(tan_angle);
+        for (U32 j = 0; j < 4; j++)
+        {
+            if (todo & (1 << j))
+            {
+                F32 radius = atanf(tan_angle[j]) * pixel_angle;
+                pixel_area[i + j] = radius * radius * F_PI;
+            }
+        }
+    }
+}
+
 int LLCamera::sphereInFrustumQuick(const LLVector3 &sphere_center, const F32 radius)
 {
     LLVector3 dist = sphere_center-mFrustCenter;
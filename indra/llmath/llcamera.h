@@ -33,6 +33,8 @@
 #include "llplane.h"
 #include "llvector4a.h"
 
+#include <vector>
+
 const F32 DEFAULT_FIELD_OF_VIEW     = 60.f * DEG_TO_RAD;
 const F32 DEFAULT_ASPECT_RATIO      = 640.f / 480.f;
 const F32 DEFAULT_NEAR_PLANE        = 0.25f;
@@ -51,6 +53,42 @@ const F32 MIN_FAR_PLANE     = 0.2f;
 static const F32 MIN_FIELD_OF_VIEW = 5.0f * DEG_TO_RAD;
 static const F32 MAX_FIELD_OF_VIEW = 190.f * DEG_TO_RAD;
 
+// Boxes for LLCamera's batched frustum tests, given as center and half
+// size like AABBInFrustum() takes them. Each component has an array of its
+// own, padded to a multiple of four, so that four boxes load at once.
+class LLAABBBatch
+{
+public:
+    LLAABBBatch() : mCount(0) { }
+
+    // Keeps the storage for the next batch
+    void clear() { mCount = 0; }
+    void reserve(U32 count);
+
+    // Appends a box and returns its index
+    U32 add(const LLVector4a& center, const LLVector4a& size);
+
+    U32 getCount() const                { return mCount; }
+    const F32* getCenter(U32 axis) const { return mCenter[axis].data(); }
+    const F32* getSize(U32 axis) const  { return mSize[axis].data(); }
+
+    // Words needed for the masks of count boxes
+    static U32 getMaskSize(U32 count)   { return (count + 31) / 32; }
+
+    // What AABBInFrustum() returns for box index, from the masks filled in
+    // by LLCamera::AABBInFrustumBatch()
+    static S32 getResult(const U32* visible, const U32* inside, U32 index)
+    {
+        const U32 bit = 1 << (index & 31);
+        return (visible[index >> 5] & bit) ? ((inside[index >> 5] & bit) ? 2 : 1) : 0;
+    }
+
+private:
+    std::vector<F32> mCenter[3];
+    std::vector<F32> mSize[3];
+    U32 mCount;
+};
+
 // An LLCamera is an LLCoorFrame with a view frustum.
 // This means that it has several methods for moving it around
 // that are inherited from the LLCoordFrame() class :
@@ -202,6 +240,24 @@ class LLCamera
     S32 AABBInFrustumNoFarClip(const LLVector4a& center, const LLVector4a& radius, const LLPlane* planes = NULL);
     S32 AABBInRegionFrustumNoFarClip(const LLVector4a& center, const LLVector4a& radius);
 
+    // AABBInFrustum(), or AABBInFrustumNoFarClip() without far_clip, for all
+    // boxes of the batch, four at a time. Bit i % 32 of visible[i / 32] is
+    // set when box i isn't outside, and of inside[i / 32] when it is fully
+    // inside. Both need LLAABBBatch::getMaskSize() words. Returns how many
+    // boxes are visible.
+    U32 AABBInFrustumBatch(const LLAABBBatch& boxes, U32* visible, U32* inside, bool far_clip = true, const LLPlane* planes = NULL) const;
+    U32 AABBInRegionFrustumBatch(const LLAABBBatch& boxes, U32* visible, U32* inside, bool far_clip = true) const;
+
+    // Screen area of each box in pixels, worked out like
+    // LLPipeline::calcPixelArea() with pixel_angle pixels per radian. When
+    // visible is given only the visible boxes get an area.
+    void calcPixelAreaBatch(const LLAABBBatch& boxes, F32 pixel_angle, F32* pixel_area, const U32* visible = NULL) const;
+
+    // Copies the region space planes the AABBInRegionFrustum tests check,
+    // skipping ignored planes, and the far plane unless far_clip is set.
+    // planes must hold AGENT_PLANE_USER_CLIP_NUM. Returns how many were copied.
+    U32 getRegionFrustumPlanes(LLPlane* planes, bool far_clip) const;
+
     //does a quick 'n dirty sphere-sphere check
     S32 sphereInFrustumQuick(const LLVector3 &sphere_center, const F32 radius);
 
@@ -0,0 +1,719 @@
+/**
+ * @file lllinearoctree.h
+ * @brief Octree stored in flat arrays in Morton order
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLLINEAROCTREE_H
+#define LL_LLLINEAROCTREE_H
+
+#include "llmath.h"
+#include "llplane.h"
+#include "llvector4a.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <unordered_map>
+#include <vector>
+
+// An alternative to LLOctreeNode for trees that are culled far more often
+// than they change.
+//
+// Elements are sorted by the Morton code of the loose octree cell they
+// belong to, so the elements of a node, and of its whole subtree, sit next
+// to each other in one array, and so do the children of a node. Nodes
+// refer to their children and elements by index, there are no pointers and
+// no listeners. Bounds of nodes and elements are kept one array per axis,
+// so the frustum is tested against four boxes at once.
+//
+// Changes are batched. insert() and remove() only queue the element, and
+// update() applies everything queued in one merge. Bounds are read from the
+// element when it is queued, so an element that moves has to be inserted
+// again. Like LLOctreeNode<T, LLPointer<T>>, the tree holds a reference to
+// every element when T_PTR is an LLPointer.
+//
+// T must provide getPositionGroup(), getBinRadius() and getSpatialExtents(),
+// like LLViewerOctreeEntry.
+template <class T, typename T_PTR> class LLLinearOctree;
+
+// Read only view of one node, with the accessor names of LLOctreeNode
+template <class T, typename T_PTR>
+class LLLinearOctreeNode
+{
+public:
+    typedef LLLinearOctree<T, T_PTR> tree_t;
+    typedef const T_PTR* const_element_iter;
+
+    LLLinearOctreeNode(const tree_t* tree, U32 index) : mTree(tree), mIndex(index) { }
+
+    U32 getIndex() const                        { return mIndex; }
+    U32 getDepth() const                        { return mTree->mNodes[mIndex].mDepth; }
+
+    // A leaf holds every element of its cell, an inner node only the ones
+    // too big for its children
+    bool isLeaf() const                         { return getChildCount() == 0; }
+    U32 getElementCount() const                 { return mTree->mNodes[mIndex].mElementCount; }
+    const_element_iter getDataBegin() const     { return mTree->mData.data() + mTree->mNodes[mIndex].mFirstElement; }
+    const_element_iter getDataEnd() const       { return getDataBegin() + getElementCount(); }
+
+    U32 getChildCount() const                   { return mTree->mNodes[mIndex].mChildCount; }
+    LLLinearOctreeNode getChild(U32 i) const    { return LLLinearOctreeNode(mTree, mTree->mNodes[mIndex].mFirstChild + i); }
+
+    // Bounds of every element in the subtree, the size is the half extent
+    // like LLOctreeNode::getSize()
+    LLVector4a getCenter() const                { return mTree->getNodeBound(mIndex, 0); }
+    LLVector4a getSize() const                  { return mTree->getNodeBound(mIndex, 3); }
+
+private:
+    const tree_t* mTree;
+    U32 mIndex;
+};
+
+// Same shape as LLOctreeTraveler
+template <class T, typename T_PTR>
+class LLLinearOctreeTraveler
+{
+public:
+    typedef LLLinearOctreeNode<T, T_PTR> node_t;
+
+    virtual ~LLLinearOctreeTraveler() = default;
+    virtual void traverse(const node_t& node);
+    virtual void visit(const node_t& branch) = 0;
+};
+
+template <class T, typename T_PTR>
+class LLLinearOctree
+{
+    friend class LLLinearOctreeNode<T, T_PTR>;
+
+public:
+    typedef LLLinearOctreeNode<T, T_PTR> node_t;
+    typedef LLLinearOctreeTraveler<T, T_PTR> traveler_t;
+
+    // Cells at MAX_DEPTH are 1/1024 of the root
+    static const U32 MAX_DEPTH = 10;
+    static const U32 MAX_PLANES = 8;
+
+    // Planes in the form LLCamera keeps them. A box is out when it is
+    // entirely on the positive side of any plane.
+    class Frustum
+    {
+    public:
+        Frustum() : mCount(0) { }
+
+        void addPlane(const LLPlane& plane);
+        U32 getPlaneCount() const { return mCount; }
+
+    private:
+        friend class LLLinearOctree;
+
+        LLVector4a mNormal[MAX_PLANES][3];      // each component splatted
+        LLVector4a mAbsNormal[MAX_PLANES][3];
+        LLVector4a mDistance[MAX_PLANES];
+        U32 mCount;
+    };
+
+    // A leaf is split once more than max_capacity elements fall in it,
+    // until MAX_DEPTH
+    explicit LLLinearOctree(U32 max_capacity);
+
+    // Queued until update(). The last of several calls for the same element
+    // wins, and an insert of an element already in the tree moves it.
+    void insert(T_PTR data);
+    void remove(T_PTR data);
+    bool hasPendingChanges() const              { return !mPending.empty(); }
+
+    // Applies every queued change and rebuilds the nodes
+    void update();
+    void clear();
+
+    U32 getElementCount() const                 { return (U32)mData.size(); }
+    U32 getNodeCount() const                    { return (U32)mNodes.size(); }
+    size_t getMemoryUsage() const;
+
+    // Always valid, the root of an empty tree has no elements
+    node_t getRoot() const                      { return node_t(this, 0); }
+    void accept(traveler_t* traveler) const     { traveler->traverse(getRoot()); }
+
+    // Calls visit(const T_PTR&) once for every element whose box isn't
+    // outside the frustum, in no particular order. Subtrees entirely inside
+    // are passed on without testing their elements.
+    template <typename F> void cull(const Frustum& frustum, F&& visit) const;
+
+private:
+    struct Node
+    {
+        U32 mFirstChild;
+        U32 mFirstElement;
+        U32 mElementCount;
+        U32 mSubtreeEnd;    // end of the elements of the whole subtree
+        U8 mChildCount;
+        U8 mDepth;
+    };
+
+    struct Element
+    {
+        U64 mKey;
+        T_PTR mData;
+        LLVector4a mCenter;
+        LLVector4a mSize;
+    };
+
+    // Bounds arrays, center then half extent per axis, padded so four
+    // lanes can always be loaded
+    enum { BOUNDS_PADDING = 3 };
+    typedef std::vector<F32> bounds_t[6];
+
+    bool fitsRoot(const LLVector4a& center) const;
+    void setRoot(const std::vector<Element>& elements);
+    U64 getKey(const LLVector4a& center, F32 radius) const;
+    void makeElement(const T_PTR& data, Element& element) const;
+    void buildNodes();
+    void buildNode(U32 index, U32 begin, U32 end, U32 depth, std::vector<LLVector4a>& bounds);
+    LLVector4a getNodeBound(U32 index, U32 offset) const;
+
+    // Lanes of the four boxes starting at first that aren't outside, and in
+    // inside the ones entirely inside. Only the low count lanes are set.
+    static U32 testBoxes(const Frustum& frustum, const bounds_t& bounds, U32 first, U32 count, U32& inside);
+
+    static T* getRaw(const T_PTR& data) { return data; }
+
+private:
+    std::vector<U64> mKeys;
+    std::vector<T_PTR> mData;
+    bounds_t mElementBounds;
+    std::vector<Node> mNodes;
+    bounds_t mNodeBounds;
+
+    struct Pending
+    {
+        T_PTR mData;
+        bool mInsert;
+    };
+    std::unordered_map<T*, Pending> mPending;
+
+    LLVector4a mRootMin;
+    F32 mRootWidth;
+    F32 mCellScale;     // cells at MAX_DEPTH per meter
+    U32 mMaxCapacity;
+};
+
+template <class T, typename T_PTR>
+void LLLinearOctreeTraveler<T, T_PTR>::traverse(const node_t& node)
+{
+    visit(node);
+    for (U32 i = 0; i < node.getChildCount(); i++)
+    {
+        traverse(node.getChild(i));
+    }
+}
+
+template <class T, typename T_PTR>
+void LLLinearOctree<T, T_PTR>::Frustum::addPlane(const LLPlane& plane)
+{
+    llassert(mCount < MAX_PLANES);
+    if (mCount >= MAX_PLANES)
+    {
+        return;
+    }
+
+    for (U32 i = 0; i < 3; i++)
+    {
+        mNormal[mCount][i].splat(plane[i]);
+        mAbsNormal[mCount][i].setAbs(mNormal[mCount][i]);
+    }
+    mDistance[mCount].splat(plane[3]);
+    mCount++;
+}
+
+template <class T, typename T_PTR>
+LLLinearOctree<T, T_PTR>::LLLinearOctree(U32 max_capacity)
+    : mRootWidth(0.f),
+      mCellScale(0.f),
+      mMaxCapacity(llmax(max_capacity, (U32)1))
+{
+    mRootMin.clear();
+    clear();
+}
+
+template <class T, typename T_PTR>
+void LLLinearOctree<T, T_PTR>::insert(T_PTR data)
+{
+    T* raw = getRaw(data);
+    if (raw)
+    {
+        Pending& pending = mPending[raw];
+        pending.mData = data;
+        pending.mInsert = true;
+    }
+}
+
+template <class T, typename T_PTR>
+void LLLinearOctree<T, T_PTR>::remove(T_PTR data)
+{
+    T* raw = getRaw(data);
+    if (raw)
+    {
+        Pending& pending = mPending[raw];
+        pending.mData = data;
+        pending.mInsert = false;
+    }
+}
+
+template <class T, typename T_PTR>
+void LLLinearOctree<T, T_PTR>::clear()
+{
+    mKeys.clear();
+    mData.clear();
+    mPending.clear();
+    mRootWidth = 0.f;
+    buildNodes();
+}
+
+template <class T, typename T_PTR>
+size_t LLLinearOctree<T, T_PTR>::getMemoryUsage() const
+{
+    size_t bytes = mKeys.capacity() * sizeof(U64) + mData.capacity() * sizeof(T_PTR) +
+                   mNodes.capacity() * sizeof(Node);
+    for (U32 i = 0; i < 6; i++)
+    {
+        bytes += (mElementBounds[i].capacity() + mNodeBounds[i].capacity()) * sizeof(F32);
+    }
+    return bytes;
+}
+
+template <class T, typename T_PTR>
+bool LLLinearOctree<T, T_PTR>::fitsRoot(const LLVector4a& center) const
+{
+    if (mRootWidth <= 0.f)
+    {
+        return false;
+    }
+    for (U32 i = 0; i < 3; i++)
+    {
+        F32 offset = center[i] - mRootMin[i];
+        if (offset < 0.f || offset >= mRootWidth)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class T, typename T_PTR>
+void LLLinearOctree<T, T_PTR>::setRoot(const std::vector<Element>& elements)
+{
+    // Cube around every center with room to grow, so that a tree that only
+    // gains the odd element doesn't have to sort everything again
+    LLVector4a min, max;
+    min = max = elements[0].mCenter;
+    for (const Element& element : elements)
+    {
+        update_min_max(min, max, element.mCenter);
+    }
+
+    LLVector4a size;
+    size.setSub(max, min);
+    F32 width = llmax(llmax(size[0], size[1]), llmax(size[2], 1.f)) * 2.f;
+
+    LLVector4a half;
+    half.splat(width * 0.5f);
+    mRootMin.setAdd(min, max);
+    mRootMin.mul(0.5f);
+    mRootMin.sub(half);
+    mRootWidth = width;
+    mCellScale = (F32)(1 << MAX_DEPTH) / width;
+}
+
+// Interleaves the low 10 bits of each axis, x lowest
+inline U64 ll_linear_octree_morton(U32 x, U32 y, U32 z)
+{
+    U64 code = 0;
+    for (U32 i = 0; i < 10; i++)
+    {
+        code |= (U64)(((x >> i) & 1) | (((y >> i) & 1) << 1) | (((z >> i) & 1) << 2)) << (i * 3);
+    }
+    return code;
+}
+
+template <class T, typename T_PTR>
+U64 LLLinearOctree<T, T_PTR>::getKey(const LLVector4a& center, F32 radius) const
+{
+    static_assert(MAX_DEPTH <= 10, "keys hold 10 bits per axis");
+    const U32 cells = 1 << MAX_DEPTH;
+
+    U32 cell[3];
+    for (U32 i = 0; i < 3; i++)
+    {
+        F32 offset = (center[i] - mRootMin[i]) * mCellScale;
+        cell[i] = (U32)llclamp((S32)offset, 0, (S32)cells - 1);
+    }
+
+    // Deepest level whose cells, stretched by half their width on each
+    // side, still hold the whole element
+    U32 depth = 0;
+    F32 half_width = mRootWidth * 0.5f;
+    while (depth < MAX_DEPTH && radius <= half_width * 0.5f)
+    {
+        depth++;
+        half_width *= 0.5f;
+    }
+
+    // Dropping the bits below the cell's level sorts every cell right
+    // before its descendants, the level breaks the tie with its first child
+    const U32 shift = (MAX_DEPTH - depth) * 3;
+    U64 code = (ll_linear_octree_morton(cell[0], cell[1], cell[2]) >> shift) << shift;
+    return (code << 4) | depth;
+}
+
+template <class T, typename T_PTR>
+void LLLinearOctree<T, T_PTR>::makeElement(const T_PTR& data, Element& element) const
+{
+    const LLVector4a* extents = data->getSpatialExtents();
+    element.mData = data;
+    element.mCenter.setAdd(extents[0], extents[1]);
+    element.mCenter.mul(0.5f);
+    element.mSize.setSub(extents[1], extents[0]);
+    element.mSize.mul(0.5f);
+    element.mKey = getKey(data->getPositionGroup(), data->getBinRadius());
+}
+
+template <class T, typename T_PTR>
+void LLLinearOctree<T, T_PTR>::update()
+{
+    if (mPending.empty())
+    {
+        return;
+    }
+
+    std::vector<Element> added;
+    added.reserve(mPending.size());
+    bool fits = true;
+    for (auto& pending : mPending)
+    {
+        if (pending.second.mInsert)
+        {
+            added.emplace_back();
+            makeElement(pending.second.mData, added.back());
+            fits = fits && fitsRoot(pending.second.mData->getPositionGroup());
+        }
+    }
+
+    // Everything that stays, in order. Elements with a pending change are
+    // dropped, the inserted ones are back in added.
+    std::vector<Element> kept;
+    kept.reserve(mData.size());
+    for (U32 i = 0; i < mData.size(); i++)
+    {
+        if (mPending.find(getRaw(mData[i])) == mPending.end())
+        {
+            kept.emplace_back();
+            Element& element = kept.back();
+            element.mKey = mKeys[i];
+            element.mData = mData[i];
+            element.mCenter.set(mElementBounds[0][i], mElementBounds[1][i], mElementBounds[2][i]);
+            element.mSize.set(mElementBounds[3][i], mElementBounds[4][i], mElementBounds[5][i]);
+        }
+    }
+    mPending.clear();
+
+    auto less = [](const Element& lhs, const Element& rhs) { return lhs.mKey < rhs.mKey; };
+
+    std::vector<Element> elements;
+    if (fits)
+    {
+        std::sort(added.begin(), added.end(), less);
+        elements.resize(kept.size() + added.size());
+        std::merge(kept.begin(), kept.end(), added.begin(), added.end(), elements.begin(), less);
+    }
+    else
+    {
+        // Something landed outside the root, start over with a bigger one
+        elements.swap(kept);
+        elements.insert(elements.end(), added.begin(), added.end());
+        setRoot(elements);
+        for (Element& element : elements)
+        {
+            element.mKey = getKey(element.mData->getPositionGroup(), element.mData->getBinRadius());
+        }
+        std::sort(elements.begin(), elements.end(), less);
+    }
+
+    const U32 count = (U32)elements.size();
+    mKeys.resize(count);
+    mData.resize(count);
+    for (U32 i = 0; i < 6; i++)
+    {
+        mElementBounds[i].resize(count + BOUNDS_PADDING);
+    }
+    for (U32 i = 0; i < count; i++)
+    {
+        Element& element = elements[i];
+        mKeys[i] = element.mKey;
+        mData[i] = element.mData;
+        for (U32 j = 0; j < 3; j++)
+        {
+            mElementBounds[j][i] = element.mCenter[j];
+            mElementBounds[j + 3][i] = element.mSize[j];
+        }
+    }
+
+    if (count == 0)
+    {
+        mRootWidth = 0.f;
+    }
+    buildNodes();
+}
+
+template <class T, typename T_PTR>
+void LLLinearOctree<T, T_PTR>::buildNodes()
+{
+    mNodes.clear();
+    mNodes.emplace_back();
+
+    // Min and max of every node, turned into center and size at the end
+    std::vector<LLVector4a> bounds(2);
+    buildNode(0, 0, (U32)mData.size(), 0, bounds);
+
+    const U32 count = (U32)mNodes.size();
+    for (U32 i = 0; i < 6; i++)
+    {
+        mNodeBounds[i].assign(count + BOUNDS_PADDING, 0.f);
+    }
+    for (U32 i = 0; i < count; i++)
+    {
+        LLVector4a center, size;
+        center.setAdd(bounds[i * 2], bounds[i * 2 + 1]);
+        center.mul(0.5f);
+        size.setSub(bounds[i * 2 + 1], bounds[i * 2]);
+        size.mul(0.5f);
+        for (U32 j = 0; j < 3; j++)
+        {
+            mNodeBounds[j][i] = center[j];
+            mNodeBounds[j + 3][i] = size[j];
+        }
+    }
+}
+
+template <class T, typename T_PTR>
+void LLLinearOctree<T, T_PTR>::buildNode(U32 index, U32 begin, U32 end, U32 depth, std::vector<LLVector4a>& bounds)
+{
+    Node node;
+    node.mFirstChild = 0;
+    node.mFirstElement = begin;
+    node.mElementCount = end - begin;
+    node.mSubtreeEnd = end;
+    node.mChildCount = 0;
+    node.mDepth = (U8)depth;
+
+    if (end - begin > mMaxCapacity && depth < MAX_DEPTH)
+    {
+        // Elements too big for the children come first
+        U32 first = begin;
+        while (first < end && (mKeys[first] & 0xf) == depth)
+        {
+            first++;
+        }
+        node.mElementCount = first - begin;
+
+        // Then one run per occupied child, in octant order
+        const U32 shift = (MAX_DEPTH - depth - 1) * 3 + 4;
+        std::vector<U32> runs;
+        for (U32 i = first; i < end; i++)
+        {
+            if (i == first || ((mKeys[i] >> shift) & 7) != ((mKeys[i - 1] >> shift) & 7))
+            {
+                runs.push_back(i);
+            }
+        }
+        runs.push_back(end);
+
+        node.mFirstChild = (U32)mNodes.size();
+        node.mChildCount = (U8)(runs.size() - 1);
+        mNodes.resize(mNodes.size() + node.mChildCount);
+        bounds.resize(mNodes.size() * 2);
+        for (U32 i = 0; i < node.mChildCount; i++)
+        {
+            buildNode(node.mFirstChild + i, runs[i], runs[i + 1], depth + 1, bounds);
+        }
+    }
+    mNodes[index] = node;
+
+    LLVector4a min, max;
+    if (begin == end)
+    {
+        min.clear();
+        max.clear();
+    }
+    else
+    {
+        min.splat(FLT_MAX);
+        max.splat(-FLT_MAX);
+        for (U32 i = begin; i < begin + node.mElementCount; i++)
+        {
+            LLVector4a center(mElementBounds[0][i], mElementBounds[1][i], mElementBounds[2][i]);
+            LLVector4a size(mElementBounds[3][i], mElementBounds[4][i], mElementBounds[5][i]);
+            LLVector4a low, high;
+            low.setSub(center, size);
+            high.setAdd(center, size);
+            min.setMin(min, low);
+            max.setMax(max, high);
+        }
+        for (U32 i = 0; i < node.mChildCount; i++)
+        {
+            U32 child = node.mFirstChild + i;
+            min.setMin(min, bounds[child * 2]);
+            max.setMax(max, bounds[child * 2 + 1]);
+        }
+    }
+    bounds[index * 2] = min;
+    bounds[index * 2 + 1] = max;
+}
+
+template <class T, typename T_PTR>
+LLVector4a LLLinearOctree<T, T_PTR>::getNodeBound(U32 index, U32 offset) const
+{
+    return LLVector4a(mNodeBounds[offset][index], mNodeBounds[offset + 1][index], mNodeBounds[offset + 2][index]);
+}
+
+template <class T, typename T_PTR>
+U32 LLLinearOctree<T, T_PTR>::testBoxes(const Frustum& frustum, const bounds_t& bounds, U32 first, U32 count, U32& inside)
+{
+    LLVector4a center[3], size[3];
+    for (U32 i = 0; i < 3; i++)
+    {
+        center[i].loadua(bounds[i].data() + first);
+        size[i].loadua(bounds[i + 3].data() + first);
+    }
+
+    const U32 lanes = (1 << count) - 1;
+    U32 out = 0;
+    U32 partial = 0;
+    for (U32 i = 0; i < frustum.mCount; i++)
+    {
+        // Signed distance of the centers, and how far the boxes reach
+        // along the normal
+        LLVector4a dist, radius, t;
+        dist.setMul(frustum.mNormal[i][0], center[0]);
+        t.setMul(frustum.mNormal[i][1], center[1]);
+        dist.add(t);
+        t.setMul(frustum.mNormal[i][2], center[2]);
+        dist.add(t);
+        dist.add(frustum.mDistance[i]);
+
+        radius.setMul(frustum.mAbsNormal[i][0], size[0]);
+        t.setMul(frustum.mAbsNormal[i][1], size[1]);
+        radius.add(t);
+        t.setMul(frustum.mAbsNormal[i][2], size[2]);
+        radius.add(t);
+
+        LLVector4a near_dist, far_dist;
+        near_dist.setSub(dist, radius);
+        far_dist.setAdd(dist, radius);
+        out |= near_dist.greaterThan(LLVector4a::getZero()).getGatheredBits();
+        partial |= far_dist.greaterThan(LLVector4a::getZero()).getGatheredBits();
+
+        if ((out & lanes) == lanes)
+        {
+            break;
+        }
+    }
+
+    U32 visible = ~out & lanes;
+    inside = visible & ~partial;
+    return visible;
+}
+
+template <class T, typename T_PTR>
+template <typename F>
+void LLLinearOctree<T, T_PTR>::cull(const Frustum& frustum, F&& visit) const
+{
+    if (mData.empty())
+    {
+        return;
+    }
+
+    U32 inside = 0;
+    if (!testBoxes(frustum, mNodeBounds, 0, 1, inside))
+    {
+        return;
+    }
+    if (inside)
+    {
+        for (const T_PTR& data : mData)
+        {
+            visit(data);
+        }
+        return;
+    }
+
+    // Nodes partly inside. Each level pushes at most eight.
+    U32 stack[(MAX_DEPTH + 1) * 8];
+    U32 top = 0;
+    stack[top++] = 0;
+    while (top)
+    {
+        const Node& node = mNodes[stack[--top]];
+
+        for (U32 i = node.mFirstElement; i < node.mFirstElement + node.mElementCount; i += 4)
+        {
+            U32 visible = testBoxes(frustum, mElementBounds, i, llmin(node.mFirstElement + node.mElementCount - i, (U32)4), inside);
+            for (U32 lane = 0; visible; lane++, visible >>= 1)
+            {
+                if (visible & 1)
+                {
+                    visit(mData[i + lane]);
+                }
+            }
+        }
+
+        for (U32 i = 0; i < node.mChildCount; i += 4)
+        {
+            U32 first = node.mFirstChild + i;
+            U32 visible = testBoxes(frustum, mNodeBounds, first, llmin((U32)node.mChildCount - i, (U32)4), inside);
+            for (U32 lane = 0; visible; lane++, visible >>= 1, inside >>= 1)
+            {
+                if (!(visible & 1))
+                {
+                    continue;
+                }
+
+                const Node& child = mNodes[first + lane];
+                if (inside & 1)
+                {
+                    // The whole subtree at once
+                    for (U32 j = child.mFirstElement; j < child.mSubtreeEnd; j++)
+                    {
+                        visit(mData[j]);
+                    }
+                }
+                else
+                {
+                    stack[top++] = first + lane;
+                }
+            }
+        }
+    }
+}
+
+#endif // LL_LLLINEAROCTREE_H
@@ -350,6 +350,11 @@ class alignas(16) LLMatrix4a
     //Fast(er). Treats v[VW] as 0.f
     inline void rotate(const LLVector4a& v, LLVector4a& res) const
     {
+#if LL_SIMD_FMA
+        LLQuad r = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), mMatrix[2]);
+        r = _mm_fmadd_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), mMatrix[1], r);
+        res = _mm_fmadd_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), mMatrix[0], r);
+#else
         LLVector4a x,y,z;
 
         x.splat<0>(v);
@@ -362,11 +367,18 @@ class alignas(16) LLMatrix4a
 
         x.add(y);
         res.setAdd(x,z);
+#endif
     }
 
     //Proper. v[VW] as v[VW]
     inline void rotate4(const LLVector4a& v, LLVector4a& res) const
     {
+#if LL_SIMD_FMA
+        LLQuad r = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), mMatrix[3]);
+        r = _mm_fmadd_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), mMatrix[2], r);
+        r = _mm_fmadd_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), mMatrix[1], r);
+        res = _mm_fmadd_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), mMatrix[0], r);
+#else
         LLVector4a x,y,z,w;
 
         x.splat<0>(v);
@@ -382,11 +394,17 @@ class alignas(16) LLMatrix4a
         x.add(y);
         z.add(w);
         res.setAdd(x,z);
+#endif
     }
 
     //Fast(er). Treats v[VW] as 1.f
     inline void affineTransform(const LLVector4a& v, LLVector4a& res) const
     {
+#if LL_SIMD_FMA
+        LLQuad r = _mm_fmadd_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), mMatrix[2], mMatrix[3]);
+        r = _mm_fmadd_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), mMatrix[1], r);
+        res = _mm_fmadd_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), mMatrix[0], r);
+#else
         LLVector4a x,y,z;
 
         x.splat<0>(v);
@@ -400,6 +418,7 @@ class alignas(16) LLMatrix4a
         x.add(y);
         z.add(mMatrix[3]);
         res.setAdd(x,z);
+#endif
     }
 
     inline void perspectiveTransform(const LLVector4a& v, LLVector4a& res) const
@@ -802,10 +821,17 @@ static_assert(std::is_standard_layout<LLMatrix4a>::value, "LLMatrix4a must be a
 inline LLVector4a rowMul(const LLVector4a &row, const LLMatrix4a &mat)
 {
     LLVector4a result;
+#if LL_SIMD_FMA
+    result = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), mat.mMatrix[0]);
+    result = _mm_fmadd_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), mat.mMatrix[1], result);
+    result = _mm_fmadd_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), mat.mMatrix[2], result);
+    result = _mm_fmadd_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), mat.mMatrix[3], result);
+#else
     result = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), mat.mMatrix[0]);
     result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), mat.mMatrix[1]));
     result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), mat.mMatrix[2]));
     result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), mat.mMatrix[3]));
+#endif
     return result;
 }
 
@@ -43,6 +43,20 @@
 #include <xmmintrin.h>
 #include <emmintrin.h>
 
+// 8-wide and fused multiply-add paths, picked at build time by USE_AVX2.
+// MSVC doesn't define __FMA__, but every AVX2 target it builds for has FMA.
+#if defined(__AVX2__)
+#define LL_SIMD_AVX2 1
+#else
+#define LL_SIMD_AVX2 0
+#endif
+
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define LL_SIMD_FMA 1
+#else
+#define LL_SIMD_FMA 0
+#endif
+
 #include "llmemory.h"
 #include "llsimdtypes.h"
 #include "llsimdtypes.inl"
@@ -0,0 +1,210 @@
+/**
+ * @file llvector4abatch.cpp
+ * @brief Transforms, normalization and bounds over arrays of LLVector4a
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llvector4abatch.h"
+
+#if LL_SIMD_AVX2
+namespace
+{
+    // Both 128 bit lanes hold the same row
+    inline __m256 load_row(const LLVector4a& row)
+    {
+        return _mm256_broadcast_ps(reinterpret_cast<const __m128*>(row.getF32ptr()));
+    }
+
+    inline __m256 load_pair(const LLVector4a* v)
+    {
+        return _mm256_loadu_ps(v->getF32ptr());
+    }
+
+    inline void store_pair(LLVector4a* v, __m256 q)
+    {
+        _mm256_storeu_ps(v->getF32ptr(), q);
+    }
+
+    // Each vector of the pair splatted, v[VX] to all four of its lanes for i = 0
+    template<int i>
+    inline __m256 splat_pair(__m256 v)
+    {
+        return _mm256_permute_ps(v, _MM_SHUFFLE(i, i, i, i));
+    }
+
+    // Same evaluation order as LLMatrix4a::affineTransform()
+    inline __m256 affine_pair(__m256 v, __m256 r0, __m256 r1, __m256 r2, __m256 r3)
+    {
+#if LL_SIMD_FMA
+        __m256 r = _mm256_fmadd_ps(splat_pair<2>(v), r2, r3);
+        r = _mm256_fmadd_ps(splat_pair<1>(v), r1, r);
+        return _mm256_fmadd_ps(splat_pair<0>(v), r0, r);
+#else
+        __m256 xy = _mm256_add_ps(_mm256_mul_ps(splat_pair<0>(v), r0), _mm256_mul_ps(splat_pair<1>(v), r1));
+        __m256 zw = _mm256_add_ps(_mm256_mul_ps(splat_pair<2>(v), r2), r3);
+        return _mm256_add_ps(xy, zw);
+#endif
+    }
+
+    // Same evaluation order as LLMatrix4a::rotate()
+    inline __m256 rotate_pair(__m256 v, __m256 r0, __m256 r1, __m256 r2)
+    {
+#if LL_SIMD_FMA
+        __m256 r = _mm256_mul_ps(splat_pair<2>(v), r2);
+        r = _mm256_fmadd_ps(splat_pair<1>(v), r1, r);
+        return _mm256_fmadd_ps(splat_pair<0>(v), r0, r);
+#else
+        __m256 xy = _mm256_add_ps(_mm256_mul_ps(splat_pair<0>(v), r0), _mm256_mul_ps(splat_pair<1>(v), r1));
+        return _mm256_add_ps(xy, _mm256_mul_ps(splat_pair<2>(v), r2));
+#endif
+    }
+
+    // x*x + y*y + z*z of each vector of the pair, in all four of its lanes
+    inline __m256 length3_squared_pair(__m256 v)
+    {
+        __m256 sq = _mm256_blend_ps(_mm256_mul_ps(v, v), _mm256_setzero_ps(), 0x88);
+        sq = _mm256_add_ps(sq, _mm256_permute_ps(sq, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm256_add_ps(sq, _mm256_permute_ps(sq, _MM_SHUFFLE(1, 0, 3, 2)));
+    }
+}
+#endif
+
+void LLVector4aBatch::affineTransform(const LLMatrix4a& mat, const LLVector4a* src, LLVector4a* dst, U32 count)
+{
+    U32 i = 0;
+#if LL_SIMD_AVX2
+    const __m256 r0 = load_row(mat.mMatrix[0]);
+    const __m256 r1 = load_row(mat.mMatrix[1]);
+    const __m256 r2 = load_row(mat.mMatrix[2]);
+    const __m256 r3 = load_row(mat.mMatrix[3]);
+
+    // Two pairs a pass so the two dependency chains overlap
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256 a = affine_pair(load_pair(src + i), r0, r1, r2, r3);
+        __m256 b = affine_pair(load_pair(src + i + 2), r0, r1, r2, r3);
+        store_pair(dst + i, a);
+        store_pair(dst + i + 2, b);
+    }
+    if (i + 2 <= count)
+    {
+        store_pair(dst + i, affine_pair(load_pair(src + i), r0, r1, r2, r3));
+        i += 2;
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        mat.affineTransform(src[i], dst[i]);
+    }
+}
+
+void LLVector4aBatch::rotate(const LLMatrix4a& mat, const LLVector4a* src, LLVector4a* dst, U32 count)
+{
+    U32 i = 0;
+#if LL_SIMD_AVX2
+    const __m256 r0 = load_row(mat.mMatrix[0]);
+    const __m256 r1 = load_row(mat.mMatrix[1]);
+    const __m256 r2 = load_row(mat.mMatrix[2]);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256 a = rotate_pair(load_pair(src + i), r0, r1, r2);
+        __m256 b = rotate_pair(load_pair(src + i + 2), r0, r1, r2);
+        store_pair(dst + i, a);
+        store_pair(dst + i + 2, b);
+    }
+    if (i + 2 <= count)
+    {
+        store_pair(dst + i, rotate_pair(load_pair(src + i), r0, r1, r2));
+        i += 2;
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        mat.rotate(src[i], dst[i]);
+    }
+}
+
+void LLVector4aBatch::normalize3fast(LLVector4a* v, U32 count)
+{
+    U32 i = 0;
+#if LL_SIMD_AVX2
+    for (; i + 2 <= count; i += 2)
+    {
+        __m256 q = load_pair(v + i);
+        store_pair(v + i, _mm256_mul_ps(q, _mm256_rsqrt_ps(length3_squared_pair(q))));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        v[i].normalize3fast();
+    }
+}
+
+void LLVector4aBatch::getMinMax(const LLVector4a* v, U32 count, LLVector4a& min, LLVector4a& max)
+{
+    llassert(count > 0);
+    min = v[0];
+    max = v[0];
+    updateMinMax(v + 1, count - 1, min, max);
+}
+
+void LLVector4aBatch::updateMinMax(const LLVector4a* v, U32 count, LLVector4a& min, LLVector4a& max)
+{
+    U32 i = 0;
+#if LL_SIMD_AVX2
+    if (count >= 2)
+    {
+        __m256 lo = _mm256_set_m128(min, min);
+        __m256 hi = _mm256_set_m128(max, max);
+        for (; i + 2 <= count; i += 2)
+        {
+            __m256 q = load_pair(v + i);
+            lo = _mm256_min_ps(lo, q);
+            hi = _mm256_max_ps(hi, q);
+        }
+        min = _mm_min_ps(_mm256_castps256_ps128(lo), _mm256_extractf128_ps(lo, 1));
+        max = _mm_max_ps(_mm256_castps256_ps128(hi), _mm256_extractf128_ps(hi, 1));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        min.setMin(min, v[i]);
+        max.setMax(max, v[i]);
+    }
+}
+
+const char* LLVector4aBatch::getBackendName()
+{
+#if LL_SIMD_AVX2 && LL_SIMD_FMA
+    return "AVX2+FMA";
+#elif LL_SIMD_AVX2
+    return "AVX2";
+#elif defined(__SSE4_1__)
+    return "SSE4.1";
+#else
+    return "SSE2";
+#endif
+}
@@ -0,0 +1,65 @@
+/**
+ * @file llvector4abatch.h
+ * @brief Transforms, normalization and bounds over arrays of LLVector4a
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLVECTOR4ABATCH_H
+#define LL_LLVECTOR4ABATCH_H
+
+#include "llmath.h"
+#include "llmatrix4a.h"
+#include "llvector4a.h"
+
+// The per vertex loops of face and rigged mesh building, one call per array.
+// Built with USE_AVX2 these work on two vectors per 256 bit register and use
+// fused multiply-add, otherwise they run the LLVector4a and LLMatrix4a code
+// one vector at a time. Either way the transforms give the same bits as
+// LLMatrix4a::affineTransform() and rotate() of the same build, so batched
+// and unbatched callers can be mixed.
+//
+// src and dst may be the same array. Neither needs more than the usual 16
+// byte alignment.
+namespace LLVector4aBatch
+{
+    // dst[i] = mat.affineTransform(src[i]), w of src treated as 1
+    void affineTransform(const LLMatrix4a& mat, const LLVector4a* src, LLVector4a* dst, U32 count);
+
+    // dst[i] = mat.rotate(src[i]), w of src treated as 0
+    void rotate(const LLMatrix4a& mat, const LLVector4a* src, LLVector4a* dst, U32 count);
+
+    // LLVector4a::normalize3fast() on each element. Zero length vectors
+    // aren't handled, w is scaled along with xyz.
+    void normalize3fast(LLVector4a* v, U32 count);
+
+    // Bounds of count > 0 vectors, all four components
+    void getMinMax(const LLVector4a* v, U32 count, LLVector4a& min, LLVector4a& max);
+
+    // Widens min and max to take in count vectors
+    void updateMinMax(const LLVector4a* v, U32 count, LLVector4a& min, LLVector4a& max);
+
+    // "AVX2+FMA", "AVX2", "SSE4.1" or "SSE2", for logs and benchmark reports
+    const char* getBackendName();
+}
+
+#endif // LL_LLVECTOR4ABATCH_H
@@ -49,11 +49,13 @@
 #include "llvolume.h"
 #include "llstl.h"
 #include "llsdserialize.h"
+#include "llmemorystream.h"
 #include "llvector4a.h"
 #include "llmatrix4a.h"
 #include "llmeshoptimizer.h"
 #include "lltimer.h"
 #include "llvolumeoctree.h"
+#include "threadpool.h"
 
 #include "mikktspace/mikktspace.hh"
 
@@ -1964,7 +1966,8 @@ void LLPathParams::copyParams(const LLPathParams &params)
     setSkew(params.getSkew());
 }
 
-S32 LLVolume::sNumMeshPoints = 0;
+std::atomic<S32> LLVolume::sNumMeshPoints(0);
+bool LLVolume::sUseBVH = true;
 
 LLVolume::LLVolume(const LLVolumeParams &params, const F32 detail, const BOOL generate_single_face, const BOOL is_unique)
     : mParams(params)
@@ -1976,6 +1979,7 @@ LLVolume::LLVolume(const LLVolumeParams &params, const F32 detail, const BOOL ge
     mSurfaceArea = 1.f; //only calculated for sculpts, defaults to 1 for all other prims
     mIsMeshAssetLoaded = false;
     mIsMeshAssetUnavaliable = false;
+    mGenerating = false;
     mLODScaleBias.setVec(1,1,1);
     mHullPoints = NULL;
     mHullIndices = NULL;
@@ -2303,429 +2307,1092 @@ bool LLVolumeFace::VertexData::compareNormal(const LLVolumeFace::VertexData& rhs
     return retval;
 }
 
-bool LLVolume::unpackVolumeFaces(std::istream& is, S32 size)
+// One face of a mesh LOD as it comes off the wire. Binaries point into the
+// inflated asset, or into the LLSD it was parsed to.
+struct LLMeshFaceSource
 {
-    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME
-
-    //input stream is now pointing at a zlib compressed block of LLSD
-    //decompress block
-    LLSD mdl;
-    U32 uzip_result = LLUZipHelper::unzip_llsd(mdl, is, size);
-    if (uzip_result != LLUZipHelper::ZR_OK)
+    struct Binary
     {
-        LL_DEBUGS("MeshStreaming") << "Failed to unzip LLSD blob for LoD with code " << uzip_result << " , will probably fetch from sim again." << LL_ENDL;
-        return false;
-    }
-    return unpackVolumeFacesInternal(mdl);
-}
+        const U8* mData = nullptr;
+        size_t mSize = 0;
+    };
 
-bool LLVolume::unpackVolumeFaces(U8* in_data, S32 size)
-{
-    //input data is now pointing at a zlib compressed block of LLSD
-    //decompress block
-    LLSD mdl;
-    U32 uzip_result = LLUZipHelper::unzip_llsd(mdl, in_data, size);
-    if (uzip_result != LLUZipHelper::ZR_OK)
-    {
-        LL_DEBUGS("MeshStreaming") << "Failed to unzip LLSD blob for LoD with code " << uzip_result << " , will probably fetch from sim again." << LL_ENDL;
-        return false;
-    }
-    return unpackVolumeFacesInternal(mdl);
-}
+    bool mNoGeometry = false;
+    Binary mPosition;
+    Binary mNormal;
+    Binary mTexCoord0;
+    Binary mTriangleList;
+    bool mHasWeights = false;
+    Binary mWeights;
+    LLVector3 mPositionMin;
+    LLVector3 mPositionMax;
+    LLVector2 mTexCoord0Min;
+    LLVector2 mTexCoord0Max;
+    bool mHasNormalizedScale = false;
+    LLVector3 mNormalizedScale;
+};
 
-bool LLVolume::unpackVolumeFacesInternal(const LLSD& mdl)
+namespace
 {
+    // Same limit as LLUZipHelper::unzip_llsd()
+    const S32 MESH_LOD_MAX_DEPTH = 96;
+
+    // Reads the binary LLSD of a mesh LOD in place: an array of face maps
+    // with the geometry in binary values. Anything unexpected, including
+    // anything LLSDBinaryParser might read differently, makes read() return
+    // false so that the caller can fall back to the generic parser.
+    class MeshLODReader
     {
-        U32 face_count = mdl.size();
+    public:
+        MeshLODReader(const U8* data, size_t size)
+            : mCur(data),
+              mEnd(data + size)
+        {
+        }
 
-        if (face_count == 0)
-        { //no faces unpacked, treat as failed decode
-            LL_WARNS() << "found no faces!" << LL_ENDL;
-            return false;
+        bool read(std::vector<LLMeshFaceSource>& faces)
+        {
+            U32 count = 0;
+            if (!expect('[') || !readU32(count) || count > (U32)(mEnd - mCur))
+            {
+                return false;
+            }
+            faces.resize(count);
+            for (LLMeshFaceSource& face : faces)
+            {
+                if (!readFace(face))
+                {
+                    return false;
+                }
+            }
+            return expect(']');
         }
 
-        mVolumeFaces.resize(face_count);
+    private:
+        // Deeper values are left to LLSDBinaryParser
+        static const S32 MAX_SKIP_DEPTH = 16;
 
-        for (size_t i = 0; i < face_count; ++i)
+        bool expect(U8 marker)
         {
-            LLVolumeFace& face = mVolumeFaces[i];
+            if (mCur < mEnd && *mCur == marker)
+            {
+                ++mCur;
+                return true;
+            }
+            return false;
+        }
 
-            const auto& mdl_face = mdl[i];
+        bool readU32(U32& value)
+        {
+            if (mEnd - mCur < 4)
+            {
+                return false;
+            }
+            value = ((U32)mCur[0] << 24) | ((U32)mCur[1] << 16) | ((U32)mCur[2] << 8) | (U32)mCur[3];
+            mCur += 4;
+            return true;
+        }
 
-            if (mdl_face.has("NoGeometry"))
-            { //face has no geometry, continue
-                face.resizeIndices(3);
-                face.resizeVertices(1);
-                face.mPositions->clear();
-                face.mNormals->clear();
-                face.mTexCoords->setZero();
-                memset(face.mIndices, 0, sizeof(U16)*3);
-                continue;
+        bool readBytes(const U8*& data, size_t& size)
+        {
+            U32 length = 0;
+            if (!readU32(length) || length > (size_t)(mEnd - mCur))
+            {
+                return false;
             }
+            data = mCur;
+            size = length;
+            mCur += length;
+            return true;
+        }
 
-            const LLSD::Binary& pos = mdl_face["Position"].asBinary();
-            const LLSD::Binary& norm = mdl_face["Normal"].asBinary();
-#if 0 // keep this code for now in case we decide to add support for on-the-wire tangents
-            const LLSD::Binary& tangent = mdl_face["Tangent"].asBinary();
-#endif
-            const LLSD::Binary& tc = mdl_face["TexCoord0"].asBinary();
-            const LLSD::Binary& idx = mdl_face["TriangleList"].asBinary();
+        // A value that LLSD::asReal() reads as a number
+        bool readReal(F64& value)
+        {
+            if (mCur >= mEnd)
+            {
+                return false;
+            }
+            U8 marker = *mCur++;
+            switch (marker)
+            {
+            case 'r':
+            {
+                if (mEnd - mCur < 8)
+                {
+                    return false;
+                }
+                U64 bits = 0;
+                for (S32 i = 0; i < 8; ++i)
+                {
+                    bits = (bits << 8) | mCur[i];
+                }
+                memcpy(&value, &bits, sizeof(value));
+                mCur += 8;
+                return true;
+            }
+            case 'i':
+            {
+                U32 bits = 0;
+                if (!readU32(bits))
+                {
+                    return false;
+                }
+                value = (F64)(S32)bits;
+                return true;
+            }
+            case '0':
+                value = 0.0;
+                return true;
+            case '1':
+                value = 1.0;
+                return true;
+            case '!':
+                value = 0.0;
+                return true;
+            default:
+                return false;
+            }
+        }
 
-            //copy out indices
-            S32 num_indices = idx.size() / 2;
-            const S32 indices_to_discard = num_indices % 3;
-            if (indices_to_discard > 0)
+        // An array read the way LLVector3::setValue() and
+        // LLVector2::setValue() read it: missing elements are 0, extra
+        // elements are ignored
+        bool readVector(F32* out, U32 components)
+        {
+            U32 count = 0;
+            if (!expect('[') || !readU32(count))
             {
-                // Invalid number of triangle indices
-                LL_WARNS() << "Incomplete triangle discarded from face! Indices count " << num_indices << " was not divisible by 3. face index: " << i << " Total: " << face_count << LL_ENDL;
-                num_indices -= indices_to_discard;
+                return false;
             }
-            face.resizeIndices(num_indices);
+            for (U32 i = 0; i < count; ++i)
+            {
+                F64 value = 0.0;
+                if (!readReal(value))
+                {
+                    return false;
+                }
+                if (i < components)
+                {
+                    out[i] = (F32)value;
+                }
+            }
+            for (U32 i = count; i < components; ++i)
+            {
+                out[i] = 0.f;
+            }
+            return expect(']');
+        }
 
-            if (num_indices > 2 && !face.mIndices)
+        // { "Min": [...], "Max": [...] }
+        bool readDomain(F32* min, F32* max, U32 components)
+        {
+            U32 count = 0;
+            if (!expect('{') || !readU32(count))
             {
-                LL_WARNS() << "Failed to allocate " << num_indices << " indices for face index: " << i << " Total: " << face_count << LL_ENDL;
-                continue;
+                return false;
             }
+            bool has_min = false;
+            bool has_max = false;
+            for (U32 i = 0; i < count; ++i)
+            {
+                const U8* key = nullptr;
+                size_t key_size = 0;
+                if (!expect('k') || !readBytes(key, key_size))
+                {
+                    return false;
+                }
+                if (isKey(key, key_size, "Min"))
+                {
+                    if (has_min || !readVector(min, components))
+                    {
+                        return false;
+                    }
+                    has_min = true;
+                }
+                else if (isKey(key, key_size, "Max"))
+                {
+                    if (has_max || !readVector(max, components))
+                    {
+                        return false;
+                    }
+                    has_max = true;
+                }
+                else if (!skipValue(0))
+                {
+                    return false;
+                }
+            }
+            return expect('}');
+        }
 
-            if (idx.empty() || face.mNumIndices < 3)
-            { //why is there an empty index list?
-                LL_WARNS() << "Empty face present! Face index: " << i << " Total: " << face_count << LL_ENDL;
-                continue;
+        bool readBinary(LLMeshFaceSource::Binary& binary)
+        {
+            if (binary.mData || !expect('b'))
+            {
+                return false;
             }
+            // mData is set even when empty, which catches a second copy
+            // of the key
+            return readBytes(binary.mData, binary.mSize);
+        }
 
-            U16* indices = (U16*) &(idx[0]);
-            for (U32 j = 0; j < num_indices; ++j)
+        bool readFace(LLMeshFaceSource& face)
+        {
+            U32 count = 0;
+            if (!expect('{') || !readU32(count))
             {
-                face.mIndices[j] = indices[j];
+                return false;
             }
+            bool has_position_domain = false;
+            bool has_tc_domain = false;
+            for (U32 i = 0; i < count; ++i)
+            {
+                const U8* key = nullptr;
+                size_t key_size = 0;
+                if (!expect('k') || !readBytes(key, key_size))
+                {
+                    return false;
+                }
 
-            //copy out vertices
-            U32 num_verts = pos.size()/(3*2);
-            face.resizeVertices(num_verts);
+                bool ok = true;
+                if (isKey(key, key_size, "Position"))
+                {
+                    ok = readBinary(face.mPosition);
+                }
+                else if (isKey(key, key_size, "Normal"))
+                {
+                    ok = readBinary(face.mNormal);
+                }
+                else if (isKey(key, key_size, "TexCoord0"))
+                {
+                    ok = readBinary(face.mTexCoord0);
+                }
+                else if (isKey(key, key_size, "TriangleList"))
+                {
+                    ok = readBinary(face.mTriangleList);
+                }
+                else if (isKey(key, key_size, "Weights"))
+                {
+                    ok = readBinary(face.mWeights);
+                    face.mHasWeights = true;
+                }
+                else if (isKey(key, key_size, "PositionDomain"))
+                {
+                    ok = !has_position_domain && readDomain(face.mPositionMin.mV, face.mPositionMax.mV, 3);
+                    has_position_domain = true;
+                }
+                else if (isKey(key, key_size, "TexCoord0Domain"))
+                {
+                    ok = !has_tc_domain && readDomain(face.mTexCoord0Min.mV, face.mTexCoord0Max.mV, 2);
+                    has_tc_domain = true;
+                }
+                else if (isKey(key, key_size, "NormalizedScale"))
+                {
+                    ok = !face.mHasNormalizedScale && readVector(face.mNormalizedScale.mV, 3);
+                    face.mHasNormalizedScale = true;
+                }
+                else if (isKey(key, key_size, "NoGeometry"))
+                {
+                    ok = !face.mNoGeometry && skipValue(0);
+                    face.mNoGeometry = true;
+                }
+                else
+                {
+                    ok = skipValue(0);
+                }
+                if (!ok)
+                {
+                    return false;
+                }
+            }
+            return expect('}');
+        }
 
-            if (num_verts > 0 && !face.mPositions)
+        bool skipValue(S32 depth)
+        {
+            if (mCur >= mEnd || depth > MAX_SKIP_DEPTH)
             {
-                LL_WARNS() << "Failed to allocate " << num_verts << " vertices for face index: " << i << " Total: " << face_count << LL_ENDL;
-                face.resizeIndices(0);
-                continue;
+                return false;
+            }
+            U8 marker = *mCur++;
+            U32 count = 0;
+            const U8* data = nullptr;
+            size_t size = 0;
+            switch (marker)
+            {
+            case '!':
+            case '0':
+            case '1':
+                return true;
+            case 'i':
+                return readU32(count);
+            case 'r':
+            case 'd':
+                if (mEnd - mCur < 8)
+                {
+                    return false;
+                }
+                mCur += 8;
+                return true;
+            case 'u':
+                if (mEnd - mCur < 16)
+                {
+                    return false;
+                }
+                mCur += 16;
+                return true;
+            case 's':
+            case 'l':
+            case 'b':
+                return readBytes(data, size);
+            case '[':
+                if (!readU32(count))
+                {
+                    return false;
+                }
+                for (U32 i = 0; i < count; ++i)
+                {
+                    if (!skipValue(depth + 1))
+                    {
+                        return false;
+                    }
+                }
+                return expect(']');
+            case '{':
+                if (!readU32(count))
+                {
+                    return false;
+                }
+                for (U32 i = 0; i < count; ++i)
+                {
+                    if (!expect('k') || !readBytes(data, size) || !skipValue(depth + 1))
+                    {
+                        return false;
+                    }
+                }
+                return expect('}');
+            default:
+                // including notation style strings
+                return false;
             }
+        }
 
-            LLVector3 minp;
-            LLVector3 maxp;
-            LLVector2 min_tc;
-            LLVector2 max_tc;
+        static bool isKey(const U8* key, size_t key_size, const char* name)
+        {
+            size_t name_size = strlen(name);
+            return key_size == name_size && memcmp(key, name, name_size) == 0;
+        }
 
-            minp.setValue(mdl_face["PositionDomain"]["Min"]);
-            maxp.setValue(mdl_face["PositionDomain"]["Max"]);
-            LLVector4a min_pos, max_pos;
-            min_pos.load3(minp.mV);
-            max_pos.load3(maxp.mV);
+    private:
+        const U8* mCur;
+        const U8* mEnd;
+    };
 
-            min_tc.setValue(mdl_face["TexCoord0Domain"]["Min"]);
-            max_tc.setValue(mdl_face["TexCoord0Domain"]["Max"]);
+    LLMeshFaceSource::Binary get_binary(const LLSD& sd)
+    {
+        const LLSD::Binary& binary = sd.asBinary();
+        LLMeshFaceSource::Binary result;
+        result.mData = binary.empty() ? nullptr : binary.data();
+        result.mSize = binary.size();
+        return result;
+    }
+
+    // Dequantizes 16 bit x, y, z triplets into (q / 65535 * scale + offset)
+    // with w = offset.w, one vertex per SSE2 operation. Matches
+    // LLVector4a::set()/div()/mul()/add() exactly.
+    void dequantize_xyz(LLVector4a* out, const U8* in, U32 count, const LLVector4a& scale, const LLVector4a& offset)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i xyz_mask = _mm_set_epi32(0, -1, -1, -1);
+        const __m128 max_value = _mm_set1_ps(65535.f);
+        for (U32 j = 0; j < count; ++j)
+        {
+            __m128i q;
+            if (j + 1 < count)
+            {
+                // reads the x of the next vertex, masked off below
+                q = _mm_loadl_epi64((const __m128i*)(in + j * 6));
+            }
+            else
+            {
+                U16 last[4] = { 0, 0, 0, 0 };
+                memcpy(last, in + j * 6, 6);
+                q = _mm_loadl_epi64((const __m128i*)last);
+            }
+            q = _mm_and_si128(_mm_unpacklo_epi16(q, zero), xyz_mask);
+            __m128 v = _mm_div_ps(_mm_cvtepi32_ps(q), max_value);
+            v = _mm_mul_ps(v, scale);
+            out[j] = _mm_add_ps(v, offset);
+        }
+    }
 
-            //unpack normalized scale/translation
-            if (mdl_face.has("NormalizedScale"))
+    // Dequantizes 16 bit u, v pairs two vertices at a time, as above
+    void dequantize_uv(LLVector2* out, const U8* in, U32 count, const LLVector4a& scale, const LLVector4a& offset)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 max_value = _mm_set1_ps(65535.f);
+        LLVector4a* out4 = (LLVector4a*)out;
+        for (U32 j = 0; j < count; j += 2)
+        {
+            __m128i q;
+            if (j < count - 1)
             {
-                face.mNormalizedScale.setValue(mdl_face["NormalizedScale"]);
+                q = _mm_loadl_epi64((const __m128i*)(in + j * 4));
             }
             else
             {
-                face.mNormalizedScale.set(1, 1, 1);
+                U16 last[4] = { 0, 0, 0, 0 };
+                memcpy(last, in + j * 4, 4);
+                q = _mm_loadl_epi64((const __m128i*)last);
             }
+            __m128 v = _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(q, zero)), max_value);
+            v = _mm_mul_ps(v, scale);
+            *out4++ = _mm_add_ps(v, offset);
+        }
+    }
 
-            LLVector4a pos_range;
-            pos_range.setSub(max_pos, min_pos);
-            LLVector2 tc_range2 = max_tc - min_tc;
+    // Turns one face of a mesh LOD into face, the same way for the binary
+    // reader and the LLSD path
+    void unpack_mesh_face(LLVolumeFace& face, const LLMeshFaceSource& src, size_t i, size_t face_count,
+                          bool do_mirror, bool do_invert)
+    {
+        if (src.mNoGeometry)
+        { //face has no geometry, continue
+            face.resizeIndices(3);
+            face.resizeVertices(1);
+            face.mPositions->clear();
+            face.mNormals->clear();
+            face.mTexCoords->setZero();
+            memset(face.mIndices, 0, sizeof(U16)*3);
+            return;
+        }
 
-            LLVector4a tc_range;
-            tc_range.set(tc_range2[0], tc_range2[1], tc_range2[0], tc_range2[1]);
-            LLVector4a min_tc4(min_tc[0], min_tc[1], min_tc[0], min_tc[1]);
+        const LLMeshFaceSource::Binary& pos = src.mPosition;
+        const LLMeshFaceSource::Binary& norm = src.mNormal;
+        const LLMeshFaceSource::Binary& tc = src.mTexCoord0;
+        const LLMeshFaceSource::Binary& idx = src.mTriangleList;
 
-            LLVector4a* pos_out = face.mPositions;
-            LLVector4a* norm_out = face.mNormals;
-            LLVector4a* tc_out = (LLVector4a*) face.mTexCoords;
+        //copy out indices
+        S32 num_indices = (S32)(idx.mSize / 2);
+        const S32 indices_to_discard = num_indices % 3;
+        if (indices_to_discard > 0)
+        {
+            // Invalid number of triangle indices
+            LL_WARNS() << "Incomplete triangle discarded from face! Indices count " << num_indices << " was not divisible by 3. face index: " << i << " Total: " << face_count << LL_ENDL;
+            num_indices -= indices_to_discard;
+        }
+        face.resizeIndices(num_indices);
+
+        if (num_indices > 2 && !face.mIndices)
+        {
+            LL_WARNS() << "Failed to allocate " << num_indices << " indices for face index: " << i << " Total: " << face_count << LL_ENDL;
+            return;
+        }
+
+        if (idx.mSize == 0 || face.mNumIndices < 3)
+        { //why is there an empty index list?
+            LL_WARNS() << "Empty face present! Face index: " << i << " Total: " << face_count << LL_ENDL;
+            return;
+        }
+
+        memcpy(face.mIndices, idx.mData, num_indices * sizeof(U16));
+
+        //copy out vertices
+        U32 num_verts = (U32)(pos.mSize / (3 * 2));
+        face.resizeVertices(num_verts);
+
+        if (num_verts > 0 && !face.mPositions)
+        {
+            LL_WARNS() << "Failed to allocate " << num_verts << " vertices for face index: " << i << " Total: " << face_count << LL_ENDL;
+            face.resizeIndices(0);
+            return;
+        }
+
+        LLVector4a min_pos, max_pos;
+        min_pos.load3(src.mPositionMin.mV);
+        max_pos.load3(src.mPositionMax.mV);
 
+        const LLVector2& min_tc = src.mTexCoord0Min;
+        const LLVector2& max_tc = src.mTexCoord0Max;
+
+        //unpack normalized scale/translation
+        if (src.mHasNormalizedScale)
+        {
+            face.mNormalizedScale = src.mNormalizedScale;
+        }
+        else
+        {
+            face.mNormalizedScale.set(1, 1, 1);
+        }
+
+        LLVector4a pos_range;
+        pos_range.setSub(max_pos, min_pos);
+        LLVector2 tc_range2 = max_tc - min_tc;
+
+        LLVector4a tc_range;
+        tc_range.set(tc_range2[0], tc_range2[1], tc_range2[0], tc_range2[1]);
+        LLVector4a min_tc4(min_tc[0], min_tc[1], min_tc[0], min_tc[1]);
+
+        dequantize_xyz(face.mPositions, pos.mData, num_verts, pos_range, min_pos);
+
+        // Normals and texture coordinates shorter than the positions are
+        // treated as missing rather than read past
+        if (norm.mSize > 0 && norm.mSize >= num_verts * 6)
+        {
+            // n / 65535 * 2 - 1
+            dequantize_xyz(face.mNormals, norm.mData, num_verts, LLVector4a(2.f), LLVector4a(0.f));
+            for (U32 j = 0; j < num_verts; ++j)
             {
-                U16* v = (U16*) &(pos[0]);
-                for (U32 j = 0; j < num_verts; ++j)
-                {
-                    pos_out->set((F32) v[0], (F32) v[1], (F32) v[2]);
-                    pos_out->div(65535.f);
-                    pos_out->mul(pos_range);
-                    pos_out->add(min_pos);
-                    pos_out++;
-                    v += 3;
-                }
+                face.mNormals[j].sub(1.f);
+            }
+        }
+        else
+        {
+            for (U32 j = 0; j < num_verts; ++j)
+            {
+                face.mNormals[j].clear();
+            }
+        }
+
+        if (tc.mSize > 0 && tc.mSize >= num_verts * 4)
+        {
+            dequantize_uv(face.mTexCoords, tc.mData, num_verts, tc_range, min_tc4);
+        }
+        else
+        {
+            LLVector4a* tc_out = (LLVector4a*) face.mTexCoords;
+            for (U32 j = 0; j < num_verts; j += 2)
+            {
+                tc_out->clear();
+                tc_out++;
+            }
+        }
 
+        if (src.mHasWeights)
+        {
+            face.allocateWeights(num_verts);
+            if (!face.mWeights && num_verts)
+            {
+                LL_WARNS() << "Failed to allocate " << num_verts << " weights for face index: " << i << " Total: " << face_count << LL_ENDL;
+                face.resizeIndices(0);
+                face.resizeVertices(0);
+                return;
             }
 
+            const U8* weights = src.mWeights.mData;
+            size_t weight_size = src.mWeights.mSize;
+
+            U32 idx = 0;
+
+            U32 cur_vertex = 0;
+            while (idx < weight_size && cur_vertex < num_verts)
             {
-                if (!norm.empty())
+                const U8 END_INFLUENCES = 0xFF;
+                U8 joint = weights[idx++];
+
+                U32 cur_influence = 0;
+                LLVector4 wght(0,0,0,0);
+                U32 joints[4] = {0,0,0,0};
+                LLVector4 joints_with_weights(0,0,0,0);
+
+                while (joint != END_INFLUENCES && idx < weight_size)
                 {
-                    U16* n = (U16*) &(norm[0]);
-                    for (U32 j = 0; j < num_verts; ++j)
+                    U16 influence = weights[idx++];
+                    influence |= ((U16) weights[idx++] << 8);
+
+                    F32 w = llclamp((F32) influence / 65535.f, 0.001f, 0.999f);
+                    wght.mV[cur_influence] = w;
+                    joints[cur_influence] = joint;
+                    cur_influence++;
+
+                    if (cur_influence >= 4)
                     {
-                        norm_out->set((F32) n[0], (F32) n[1], (F32) n[2]);
-                        norm_out->div(65535.f);
-                        norm_out->mul(2.f);
-                        norm_out->sub(1.f);
-                        norm_out++;
-                        n += 3;
+                        joint = END_INFLUENCES;
                     }
-                }
-                else
-                {
-                    for (U32 j = 0; j < num_verts; ++j)
+                    else
                     {
-                        norm_out->clear();
-                        norm_out++; // or just norm_out[j].clear();
+                        joint = weights[idx++];
                     }
                 }
+                F32 wsum = wght.mV[VX] + wght.mV[VY] + wght.mV[VZ] + wght.mV[VW];
+                if (wsum <= 0.f)
+                {
+                    wght = LLVector4(0.999f,0.f,0.f,0.f);
+                }
+                for (U32 k=0; k<4; k++)
+                {
+                    F32 f_combined = (F32) joints[k] + wght[k];
+                    joints_with_weights[k] = f_combined;
+                    // Any weights we added above should wind up non-zero and applied to a specific bone.
+                    // A failure here would indicate a floating point precision error in the math.
+                    llassert((k >= cur_influence) || (f_combined - S32(f_combined) > 0.0f));
+                }
+                face.mWeights[cur_vertex].loadua(joints_with_weights.mV);
+
+                cur_vertex++;
             }
 
-#if 0 // keep this code for now in case we decide to add support for on-the-wire tangents
+            if (cur_vertex != num_verts || idx != weight_size)
             {
-                if (!tangent.empty())
+                LL_WARNS() << "Vertex weight count does not match vertex count!" << LL_ENDL;
+            }
+
+        }
+
+        // translate to actions:
+        bool do_reflect_x = false;
+        bool do_reverse_triangles = false;
+        bool do_invert_normals = false;
+
+        if (do_mirror)
+        {
+            do_reflect_x = true;
+            do_reverse_triangles = !do_reverse_triangles;
+        }
+
+        if (do_invert)
+        {
+            do_invert_normals = true;
+            do_reverse_triangles = !do_reverse_triangles;
+        }
+
+        // now do the work
+
+        if (do_reflect_x)
+        {
+            LLVector4a* p = (LLVector4a*) face.mPositions;
+            LLVector4a* n = (LLVector4a*) face.mNormals;
+
+            for (S32 i = 0; i < face.mNumVertices; i++)
+            {
+                p[i].mul(-1.0f);
+                n[i].mul(-1.0f);
+            }
+        }
+
+        if (do_invert_normals)
+        {
+            LLVector4a* n = (LLVector4a*) face.mNormals;
+
+            for (S32 i = 0; i < face.mNumVertices; i++)
+            {
+                n[i].mul(-1.0f);
+            }
+        }
+
+        if (do_reverse_triangles)
+        {
+            for (U32 j = 0; j < face.mNumIndices; j += 3)
+            {
+                // swap the 2nd and 3rd index
+                S32 swap = face.mIndices[j+1];
+                face.mIndices[j+1] = face.mIndices[j+2];
+                face.mIndices[j+2] = swap;
+            }
+        }
+
+        //calculate bounding box
+        // VFExtents change
+        LLVector4a& min = face.mExtents[0];
+        LLVector4a& max = face.mExtents[1];
+
+        if (face.mNumVertices < 3)
+        { //empty face, use a dummy 1cm (at 1m scale) bounding box
+            min.splat(-0.005f);
+            max.splat(0.005f);
+        }
+        else
+        {
+            min = max = face.mPositions[0];
+
+            for (S32 i = 1; i < face.mNumVertices; ++i)
+            {
+                min.setMin(min, face.mPositions[i]);
+                max.setMax(max, face.mPositions[i]);
+            }
+
+            if (face.mTexCoords)
+            {
+                LLVector2& min_tc = face.mTexCoordExtents[0];
+                LLVector2& max_tc = face.mTexCoordExtents[1];
+
+                min_tc = face.mTexCoords[0];
+                max_tc = face.mTexCoords[0];
+
+                for (U32 j = 1; j < face.mNumVertices; ++j)
                 {
-                    face.allocateTangents(face.mNumVertices);
-                    U16* t = (U16*)&(tangent[0]);
+                    update_min_max(min_tc, max_tc, face.mTexCoords[j]);
+                }
+            }
+            else
+            {
+                face.mTexCoordExtents[0].set(0,0);
+                face.mTexCoordExtents[1].set(1,1);
+            }
+        }
+    }
+}
+
+bool LLVolume::unpackVolumeFaces(std::istream& is, S32 size)
+{
+    std::unique_ptr<U8[]> in(new(std::nothrow) U8[size]);
+    if (!in)
+    {
+        LL_DEBUGS("MeshStreaming") << "Failed to allocate " << size << " bytes for LoD, will probably fetch from sim again." << LL_ENDL;
+        return false;
+    }
+    is.read((char*) in.get(), size);
+    return unpackVolumeFaces(in.get(), size);
+}
 
-                    // NOTE: tangents coming from the asset may not be mikkt space, but they should always be used by the GLTF shaders to
-                    // maintain compliance with the GLTF spec
-                    LLVector4a* t_out = face.mTangents;
+bool LLVolume::unpackVolumeFaces(U8* in_data, S32 size)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME
+
+    //input data is now pointing at a zlib compressed block of LLSD
+    //decompress block
+    std::vector<U8> inflated;
+    U32 uzip_result = LLUZipHelper::unzip(inflated, in_data, size);
+    if (uzip_result != LLUZipHelper::ZR_OK)
+    {
+        LL_DEBUGS("MeshStreaming") << "Failed to unzip LLSD blob for LoD with code " << uzip_result << " , will probably fetch from sim again." << LL_ENDL;
+        return false;
+    }
+
+    llssize llsd_size = (llssize)inflated.size();
+    char* llsd = strip_deprecated_header((char*)inflated.data(), llsd_size);
+
+    // Read the faces straight out of the inflated block, the binaries are
+    // never copied into an LLSD
+    std::vector<LLMeshFaceSource> faces;
+    if (MeshLODReader((const U8*)llsd, llsd_size).read(faces))
+    {
+        return unpackMeshFaces(faces);
+    }
+
+    // Not laid out the way the uploader writes it, take the long way
+    LLSD mdl;
+    LLMemoryStream istrm((const U8*)llsd, (S32)llsd_size);
+    if (!LLSDSerialize::fromBinary(mdl, istrm, llsd_size, MESH_LOD_MAX_DEPTH))
+    {
+        LL_DEBUGS("MeshStreaming") << "Failed to parse LLSD blob for LoD, will probably fetch from sim again." << LL_ENDL;
+        return false;
+    }
+    return unpackVolumeFacesInternal(mdl);
+}
+
+bool LLVolume::unpackVolumeFaces(const LLSD& mdl)
+{
+    return unpackVolumeFacesInternal(mdl);
+}
+
+bool LLVolume::unpackVolumeFacesInternal(const LLSD& mdl)
+{
+    std::vector<LLMeshFaceSource> faces(mdl.size());
+    for (size_t i = 0; i < faces.size(); ++i)
+    {
+        const LLSD& mdl_face = mdl[i];
+        LLMeshFaceSource& face = faces[i];
+
+        if (mdl_face.has("NoGeometry"))
+        {
+            face.mNoGeometry = true;
+            continue;
+        }
+
+        face.mPosition = get_binary(mdl_face["Position"]);
+        face.mNormal = get_binary(mdl_face["Normal"]);
+#if 0 // keep this code for now in case we decide to add support for on-the-wire tangents
+        face.mTangent = get_binary(mdl_face["Tangent"]);
+#endif
+        face.mTexCoord0 = get_binary(mdl_face["TexCoord0"]);
+        face.mTriangleList = get_binary(mdl_face["TriangleList"]);
+        if (mdl_face.has("Weights"))
+        {
+            face.mHasWeights = true;
+            face.mWeights = get_binary(mdl_face["Weights"]);
+        }
+
+        face.mPositionMin.setValue(mdl_face["PositionDomain"]["Min"]);
+        face.mPositionMax.setValue(mdl_face["PositionDomain"]["Max"]);
+        face.mTexCoord0Min.setValue(mdl_face["TexCoord0Domain"]["Min"]);
+        face.mTexCoord0Max.setValue(mdl_face["TexCoord0Domain"]["Max"]);
+
+        if (mdl_face.has("NormalizedScale"))
+        {
+            face.mHasNormalizedScale = true;
+            face.mNormalizedScale.setValue(mdl_face["NormalizedScale"]);
+        }
+    }
+    return unpackMeshFaces(faces);
+}
 
-                    for (U32 j = 0; j < num_verts; ++j)
-                    {
-                        t_out->set((F32)t[0], (F32)t[1], (F32)t[2], (F32) t[3]);
-                        t_out->div(65535.f);
-                        t_out->mul(2.f);
-                        t_out->sub(1.f);
+bool LLVolume::unpackMeshFaces(const std::vector<LLMeshFaceSource>& faces)
+{
+    size_t face_count = faces.size();
 
-                        F32* tp = t_out->getF32ptr();
-                        tp[3] = tp[3] < 0.f ? -1.f : 1.f;
+    if (face_count == 0)
+    { //no faces unpacked, treat as failed decode
+        LL_WARNS() << "found no faces!" << LL_ENDL;
+        return false;
+    }
 
-                        t_out++;
-                        t += 4;
-                    }
-                }
-            }
-#endif
+    // modifier flags?
+    bool do_mirror = (mParams.getSculptType() & LL_SCULPT_FLAG_MIRROR);
+    bool do_invert = (mParams.getSculptType() &LL_SCULPT_FLAG_INVERT);
 
-            {
-                if (!tc.empty())
-                {
-                    U16* t = (U16*) &(tc[0]);
-                    for (U32 j = 0; j < num_verts; j+=2)
-                    {
-                        if (j < num_verts-1)
-                        {
-                            tc_out->set((F32) t[0], (F32) t[1], (F32) t[2], (F32) t[3]);
-                        }
-                        else
-                        {
-                            tc_out->set((F32) t[0], (F32) t[1], 0.f, 0.f);
-                        }
+    mVolumeFaces.resize(face_count);
 
-                        t += 4;
+    for (size_t i = 0; i < face_count; ++i)
+    {
+        unpack_mesh_face(mVolumeFaces[i], faces[i], i, face_count, do_mirror, do_invert);
+    }
 
-                        tc_out->div(65535.f);
-                        tc_out->mul(tc_range);
-                        tc_out->add(min_tc4);
+    if (!cacheOptimize(true))
+    {
+        // Out of memory?
+        LL_WARNS() << "Failed to optimize!" << LL_ENDL;
+        mVolumeFaces.clear();
+        return false;
+    }
 
-                        tc_out++;
-                    }
-                }
-                else
-                {
-                    for (U32 j = 0; j < num_verts; j += 2)
-                    {
-                        tc_out->clear();
-                        tc_out++;
-                    }
-                }
-            }
+    mSculptLevel = 0;  // success!
 
-            if (mdl_face.has("Weights"))
-            {
-                face.allocateWeights(num_verts);
-                if (!face.mWeights && num_verts)
-                {
-                    LL_WARNS() << "Failed to allocate " << num_verts << " weights for face index: " << i << " Total: " << face_count << LL_ENDL;
-                    face.resizeIndices(0);
-                    face.resizeVertices(0);
-                    continue;
-                }
+    return true;
+}
 
-                const LLSD::Binary& weights = mdl_face["Weights"].asBinary();
+// Decoded faces layout, native byte order:
+//  DecodedFacesHeader
+//  per face:
+//   DecodedFaceHeader
+//   positions, normals and texture coordinates, as resizeVertices() allocates them
+//   tangents, if DECODED_FACE_TANGENTS
+//   weights, if DECODED_FACE_WEIGHTS
+//   indices, padded to 16 bytes
+namespace
+{
+    const U32 DECODED_FACES_VERSION = 1;
 
-                U32 idx = 0;
+    enum
+    {
+        DECODED_FACE_TANGENTS = 0x1,
+        DECODED_FACE_WEIGHTS = 0x2,
+        DECODED_FACE_OPTIMIZED = 0x4
+    };
 
-                U32 cur_vertex = 0;
-                size_t weight_size = weights.size();
-                while (idx < weight_size && cur_vertex < num_verts)
-                {
-                    const U8 END_INFLUENCES = 0xFF;
-                    U8 joint = weights[idx++];
+    struct DecodedFacesHeader
+    {
+        U32 mVersion;
+        U32 mFaceCount;
+        U32 mPad[2];
+    };
 
-                    U32 cur_influence = 0;
-                    LLVector4 wght(0,0,0,0);
-                    U32 joints[4] = {0,0,0,0};
-                    LLVector4 joints_with_weights(0,0,0,0);
+    struct DecodedFaceHeader
+    {
+        F32 mExtents[12]; // min, max and center, as LLVector4a
+        F32 mTexCoordExtents[4];
+        F32 mNormalizedScale[4];
+        S32 mNumVertices;
+        S32 mNumIndices;
+        U32 mFlags;
+        U32 mPad;
+    };
 
-                    while (joint != END_INFLUENCES && idx < weight_size)
-                    {
-                        U16 influence = weights[idx++];
-                        influence |= ((U16) weights[idx++] << 8);
+    static_assert(sizeof(DecodedFacesHeader) % 16 == 0, "decoded face arrays must stay aligned");
+    static_assert(sizeof(DecodedFaceHeader) % 16 == 0, "decoded face arrays must stay aligned");
 
-                        F32 w = llclamp((F32) influence / 65535.f, 0.001f, 0.999f);
-                        wght.mV[cur_influence] = w;
-                        joints[cur_influence] = joint;
-                        cur_influence++;
+    size_t decoded_tc_bytes(S32 num_verts)
+    {
+        return ((num_verts * sizeof(LLVector2)) + 0xF) & ~0xF;
+    }
 
-                        if (cur_influence >= 4)
-                        {
-                            joint = END_INFLUENCES;
-                        }
-                        else
-                        {
-                            joint = weights[idx++];
-                        }
-                    }
-                    F32 wsum = wght.mV[VX] + wght.mV[VY] + wght.mV[VZ] + wght.mV[VW];
-                    if (wsum <= 0.f)
-                    {
-                        wght = LLVector4(0.999f,0.f,0.f,0.f);
-                    }
-                    for (U32 k=0; k<4; k++)
-                    {
-                        F32 f_combined = (F32) joints[k] + wght[k];
-                        joints_with_weights[k] = f_combined;
-                        // Any weights we added above should wind up non-zero and applied to a specific bone.
-                        // A failure here would indicate a floating point precision error in the math.
-                        llassert((k >= cur_influence) || (f_combined - S32(f_combined) > 0.0f));
-                    }
-                    face.mWeights[cur_vertex].loadua(joints_with_weights.mV);
+    size_t decoded_index_bytes(S32 num_indices)
+    {
+        return ((num_indices * sizeof(U16)) + 0xF) & ~0xF;
+    }
+}
 
-                    cur_vertex++;
-                }
+void LLVolume::packDecodedFaces(std::vector<U8>& out) const
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
 
-                if (cur_vertex != num_verts || idx != weights.size())
-                {
-                    LL_WARNS() << "Vertex weight count does not match vertex count!" << LL_ENDL;
-                }
+    size_t size = sizeof(DecodedFacesHeader);
+    for (const LLVolumeFace& face : mVolumeFaces)
+    {
+        size += sizeof(DecodedFaceHeader);
+        size += sizeof(LLVector4a) * 2 * face.mNumVertices + decoded_tc_bytes(face.mNumVertices);
+        size += face.mTangents ? sizeof(LLVector4a) * face.mNumVertices : 0;
+        size += face.mWeights ? sizeof(LLVector4a) * face.mNumVertices : 0;
+        size += decoded_index_bytes(face.mNumIndices);
+    }
+    out.assign(size, 0);
 
-            }
+    U8* dst = out.data();
+    DecodedFacesHeader* header = (DecodedFacesHeader*)dst;
+    header->mVersion = DECODED_FACES_VERSION;
+    header->mFaceCount = (U32)mVolumeFaces.size();
+    dst += sizeof(DecodedFacesHeader);
 
-            // modifier flags?
-            bool do_mirror = (mParams.getSculptType() & LL_SCULPT_FLAG_MIRROR);
-            bool do_invert = (mParams.getSculptType() &LL_SCULPT_FLAG_INVERT);
+    for (const LLVolumeFace& face : mVolumeFaces)
+    {
+        S32 num_verts = face.mNumVertices;
+        DecodedFaceHeader* face_header = (DecodedFaceHeader*)dst;
+        memcpy(face_header->mExtents, face.mExtents, sizeof(LLVector4a) * 2);
+        memcpy(face_header->mExtents + 8, face.mCenter, sizeof(LLVector4a));
+        face_header->mTexCoordExtents[0] = face.mTexCoordExtents[0].mV[0];
+        face_header->mTexCoordExtents[1] = face.mTexCoordExtents[0].mV[1];
+        face_header->mTexCoordExtents[2] = face.mTexCoordExtents[1].mV[0];
+        face_header->mTexCoordExtents[3] = face.mTexCoordExtents[1].mV[1];
+        face_header->mNormalizedScale[0] = face.mNormalizedScale.mV[0];
+        face_header->mNormalizedScale[1] = face.mNormalizedScale.mV[1];
+        face_header->mNormalizedScale[2] = face.mNormalizedScale.mV[2];
+        face_header->mNumVertices = num_verts;
+        face_header->mNumIndices = face.mNumIndices;
+        face_header->mFlags = (face.mTangents ? DECODED_FACE_TANGENTS : 0) |
+                              (face.mWeights ? DECODED_FACE_WEIGHTS : 0) |
+                              (face.mOptimized ? DECODED_FACE_OPTIMIZED : 0);
+        dst += sizeof(DecodedFaceHeader);
 
+        if (num_verts > 0)
+        {
+            // normals and texture coordinates are copied on their own in
+            // case the face has room for more vertices than it uses
+            memcpy(dst, face.mPositions, sizeof(LLVector4a) * num_verts);
+            dst += sizeof(LLVector4a) * num_verts;
+            memcpy(dst, face.mNormals, sizeof(LLVector4a) * num_verts);
+            dst += sizeof(LLVector4a) * num_verts;
+            memcpy(dst, face.mTexCoords, sizeof(LLVector2) * num_verts);
+            dst += decoded_tc_bytes(num_verts);
+        }
+        if (face.mTangents)
+        {
+            memcpy(dst, face.mTangents, sizeof(LLVector4a) * num_verts);
+            dst += sizeof(LLVector4a) * num_verts;
+        }
+        if (face.mWeights)
+        {
+            memcpy(dst, face.mWeights, sizeof(LLVector4a) * num_verts);
+            dst += sizeof(LLVector4a) * num_verts;
+        }
+        if (face.mNumIndices > 0)
+        {
+            memcpy(dst, face.mIndices, sizeof(U16) * face.mNumIndices);
+        }
+        dst += decoded_index_bytes(face.mNumIndices);
+    }
+    llassert(dst == out.data() + out.size());
+}
 
-            // translate to actions:
-            bool do_reflect_x = false;
-            bool do_reverse_triangles = false;
-            bool do_invert_normals = false;
+bool LLVolume::unpackDecodedFaces(const U8* data, S32 size)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
 
-            if (do_mirror)
-            {
-                do_reflect_x = true;
-                do_reverse_triangles = !do_reverse_triangles;
-            }
+    const U8* src = data;
+    const U8* end = data + size;
+    const DecodedFacesHeader* header = (const DecodedFacesHeader*)src;
+    if (size < (S32)sizeof(DecodedFacesHeader) || header->mVersion != DECODED_FACES_VERSION || header->mFaceCount == 0 ||
+        header->mFaceCount > (U32)(size / sizeof(DecodedFaceHeader)))
+    {
+        return false;
+    }
+    src += sizeof(DecodedFacesHeader);
 
-            if (do_invert)
-            {
-                do_invert_normals = true;
-                do_reverse_triangles = !do_reverse_triangles;
-            }
+    mVolumeFaces.clear();
+    mVolumeFaces.resize(header->mFaceCount);
+    for (LLVolumeFace& face : mVolumeFaces)
+    {
+        if (end - src < (ptrdiff_t)sizeof(DecodedFaceHeader))
+        {
+            mVolumeFaces.clear();
+            return false;
+        }
+        const DecodedFaceHeader* face_header = (const DecodedFaceHeader*)src;
+        src += sizeof(DecodedFaceHeader);
 
-            // now do the work
+        S32 num_verts = face_header->mNumVertices;
+        S32 num_indices = face_header->mNumIndices;
+        U32 flags = face_header->mFlags;
+        if (num_verts < 0 || num_verts > 65536 || num_indices < 0 || num_indices % 3 != 0 ||
+            (num_indices > 0 && num_verts == 0))
+        {
+            mVolumeFaces.clear();
+            return false;
+        }
+        size_t vertex_bytes = sizeof(LLVector4a) * 2 * num_verts + decoded_tc_bytes(num_verts);
+        size_t extra_bytes = sizeof(LLVector4a) * num_verts;
+        size_t face_bytes = vertex_bytes + decoded_index_bytes(num_indices) +
+                            ((flags & DECODED_FACE_TANGENTS) ? extra_bytes : 0) +
+                            ((flags & DECODED_FACE_WEIGHTS) ? extra_bytes : 0);
+        if ((size_t)(end - src) < face_bytes)
+        {
+            mVolumeFaces.clear();
+            return false;
+        }
 
-            if (do_reflect_x)
+        if (num_verts > 0)
+        {
+            face.resizeVertices(num_verts);
+            if (!face.mPositions)
             {
-                LLVector4a* p = (LLVector4a*) face.mPositions;
-                LLVector4a* n = (LLVector4a*) face.mNormals;
-
-                for (S32 i = 0; i < face.mNumVertices; i++)
-                {
-                    p[i].mul(-1.0f);
-                    n[i].mul(-1.0f);
-                }
+                LL_WARNS() << "Failed to allocate " << num_verts << " vertices" << LL_ENDL;
+                mVolumeFaces.clear();
+                return false;
             }
-
-            if (do_invert_normals)
+            // Same layout as the face's own buffer
+            memcpy(face.mPositions, src, vertex_bytes);
+            src += vertex_bytes;
+        }
+        if (flags & DECODED_FACE_TANGENTS)
+        {
+            face.allocateTangents(num_verts);
+            if (num_verts > 0)
             {
-                LLVector4a* n = (LLVector4a*) face.mNormals;
-
-                for (S32 i = 0; i < face.mNumVertices; i++)
-                {
-                    n[i].mul(-1.0f);
-                }
+                memcpy(face.mTangents, src, extra_bytes);
             }
-
-            if (do_reverse_triangles)
+            src += extra_bytes;
+        }
+        if (flags & DECODED_FACE_WEIGHTS)
+        {
+            face.allocateWeights(num_verts);
+            if (num_verts > 0)
             {
-                for (U32 j = 0; j < face.mNumIndices; j += 3)
-                {
-                    // swap the 2nd and 3rd index
-                    S32 swap = face.mIndices[j+1];
-                    face.mIndices[j+1] = face.mIndices[j+2];
-                    face.mIndices[j+2] = swap;
-                }
+                memcpy(face.mWeights, src, extra_bytes);
             }
-
-            //calculate bounding box
-            // VFExtents change
-            LLVector4a& min = face.mExtents[0];
-            LLVector4a& max = face.mExtents[1];
-
-            if (face.mNumVertices < 3)
-            { //empty face, use a dummy 1cm (at 1m scale) bounding box
-                min.splat(-0.005f);
-                max.splat(0.005f);
+            src += extra_bytes;
+        }
+        if (num_indices > 0)
+        {
+            face.resizeIndices(num_indices);
+            if (!face.mIndices)
+            {
+                LL_WARNS() << "Failed to allocate " << num_indices << " indices" << LL_ENDL;
+                mVolumeFaces.clear();
+                return false;
             }
-            else
+            memcpy(face.mIndices, src, decoded_index_bytes(num_indices));
+            for (S32 i = 0; i < num_indices; ++i)
             {
-                min = max = face.mPositions[0];
-
-                for (S32 i = 1; i < face.mNumVertices; ++i)
+                if (face.mIndices[i] >= num_verts)
                 {
-                    min.setMin(min, face.mPositions[i]);
-                    max.setMax(max, face.mPositions[i]);
-                }
-
-                if (face.mTexCoords)
-                {
-                    LLVector2& min_tc = face.mTexCoordExtents[0];
-                    LLVector2& max_tc = face.mTexCoordExtents[1];
-
-                    min_tc = face.mTexCoords[0];
-                    max_tc = face.mTexCoords[0];
-
-                    for (U32 j = 1; j < face.mNumVertices; ++j)
-                    {
-                        update_min_max(min_tc, max_tc, face.mTexCoords[j]);
-                    }
-                }
-                else
-                {
-                    face.mTexCoordExtents[0].set(0,0);
-                    face.mTexCoordExtents[1].set(1,1);
+                    mVolumeFaces.clear();
+                    return false;
                 }
             }
         }
-    }
+        src += decoded_index_bytes(num_indices);
 
-    if (!cacheOptimize(true))
-    {
-        // Out of memory?
-        LL_WARNS() << "Failed to optimize!" << LL_ENDL;
-        mVolumeFaces.clear();
-        return false;
+        face.mExtents[0].loadua(face_header->mExtents);
+        face.mExtents[1].loadua(face_header->mExtents + 4);
+        face.mCenter->loadua(face_header->mExtents + 8);
+        face.mTexCoordExtents[0].set(face_header->mTexCoordExtents[0], face_header->mTexCoordExtents[1]);
+        face.mTexCoordExtents[1].set(face_header->mTexCoordExtents[2], face_header->mTexCoordExtents[3]);
+        face.mNormalizedScale.set(face_header->mNormalizedScale[0], face_header->mNormalizedScale[1],
+                                  face_header->mNormalizedScale[2]);
+        face.mOptimized = (flags & DECODED_FACE_OPTIMIZED) ? TRUE : FALSE;
     }
 
-    mSculptLevel = 0;  // success!
+    mSculptLevel = 0;
 
     return true;
 }
@@ -2776,6 +3443,25 @@ void LLVolume::copyVolumeFaces(const LLVolume* volume)
     mSculptLevel = 0;
 }
 
+void LLVolume::takeGeneratedFrom(LLVolume* volume)
+{
+    llassert(mParams == volume->mParams);
+
+    // volume gets the stand in, and its mesh points, in exchange
+    std::swap(mPathp, volume->mPathp);
+    std::swap(mProfilep, volume->mProfilep);
+    // LLAlignedArray has no swap, and copying it would free the buffer twice
+    std::swap(mMesh.mArray, volume->mMesh.mArray);
+    std::swap(mMesh.mElementCount, volume->mMesh.mElementCount);
+    std::swap(mMesh.mCapacity, volume->mMesh.mCapacity);
+    mVolumeFaces.swap(volume->mVolumeFaces);
+    mFaceMask = volume->mFaceMask;
+    mLODScaleBias = volume->mLODScaleBias;
+    mSculptLevel = volume->mSculptLevel;
+    mSurfaceArea = volume->mSurfaceArea;
+    mGenerating = false;
+}
+
 bool LLVolume::cacheOptimize(bool gen_tangents)
 {
     for (S32 i = 0; i < mVolumeFaces.size(); ++i)
@@ -4037,6 +4723,68 @@ void LLVolume::generateSilhouetteVertices(std::vector<LLVector3> &vertices,
     }
 }
 
+// Faces with at least this many triangles get their ray cast hierarchy
+// built on a worker thread, smaller ones build it on first use
+static const S32 BVH_ASYNC_MIN_TRIANGLES = 2048;
+
+// Texture coordinate, normal and tangent at barycentric a, b of triangle tri
+static void interpolate_hit(const LLVolumeFace& face, S32 tri, F32 a, F32 b,
+                            LLVector2* tex_coord, LLVector4a* normal, LLVector4a* tangent_out)
+{
+    U16 idx0 = face.mIndices[tri*3+0];
+    U16 idx1 = face.mIndices[tri*3+1];
+    U16 idx2 = face.mIndices[tri*3+2];
+
+    if (tex_coord != NULL)
+    {
+        LLVector2* tc = (LLVector2*) face.mTexCoords;
+        *tex_coord = ((1.f - a - b)  * tc[idx0] +
+            a              * tc[idx1] +
+            b              * tc[idx2]);
+
+    }
+
+    if (normal!= NULL)
+    {
+        LLVector4a* norm = face.mNormals;
+
+        LLVector4a n1,n2,n3;
+        n1 = norm[idx0];
+        n1.mul(1.f-a-b);
+
+        n2 = norm[idx1];
+        n2.mul(a);
+
+        n3 = norm[idx2];
+        n3.mul(b);
+
+        n1.add(n2);
+        n1.add(n3);
+
+        *normal     = n1;
+    }
+
+    if (tangent_out != NULL)
+    {
+        LLVector4a* tangents = face.mTangents;
+
+        LLVector4a t1,t2,t3;
+        t1 = tangents[idx0];
+        t1.mul(1.f-a-b);
+
+        t2 = tangents[idx1];
+        t2.mul(a);
+
+        t3 = tangents[idx2];
+        t3.mul(b);
+
+        t1.add(t2);
+        t1.add(t3);
+
+        *tangent_out = t1;
+    }
+}
+
 S32 LLVolume::lineSegmentIntersect(const LLVector4a& start, const LLVector4a& end,
                                    S32 face_idx,
                                    LLVector4a* intersection,LLVector2* tex_coord, LLVector4a* normal, LLVector4a* tangent_out)
@@ -4082,8 +4830,46 @@ S32 LLVolume::lineSegmentIntersect(const LLVector4a& start, const LLVector4a& en
                 genTangents(i);
             }
 
-            if (isUnique())
-            { //don't bother with an octree for flexi volumes
+            const LLVolumeBVH* bvh = NULL;
+            if (!isUnique() && sUseBVH)
+            {
+                bvh = face.getBVH();
+                if (!bvh && !face.isBVHPending())
+                {
+                    if (face.mNumIndices / 3 >= BVH_ASYNC_MIN_TRIANGLES)
+                    {
+                        // Test this ray the slow way while a worker builds it
+                        face.requestBVH();
+                    }
+                    else
+                    {
+                        face.createBVH();
+                    }
+                    bvh = face.getBVH();
+                }
+            }
+
+            if (bvh)
+            {
+                F32 a, b;
+                S32 tri = bvh->intersect(start, dir, closest_t, a, b);
+                if (tri >= 0)
+                {
+                    hit_face = i;
+
+                    if (intersection != NULL)
+                    {
+                        LLVector4a intersect = dir;
+                        intersect.mul(closest_t);
+                        intersect.add(start);
+                        *intersection = intersect;
+                    }
+
+                    interpolate_hit(face, tri, a, b, tex_coord, normal, tangent_out);
+                }
+            }
+            else if (isUnique() || sUseBVH)
+            { //don't bother with an octree for flexi volumes, or for faces whose hierarchy isn't ready yet
                 U32 tri_count = face.mNumIndices/3;
 
                 for (U32 j = 0; j < tri_count; ++j)
@@ -4116,55 +4902,7 @@ S32 LLVolume::lineSegmentIntersect(const LLVector4a& start, const LLVector4a& en
                                 *intersection = intersect;
                             }
 
-
-                            if (tex_coord != NULL)
-                            {
-                                LLVector2* tc = (LLVector2*) face.mTexCoords;
-                                *tex_coord = ((1.f - a - b)  * tc[idx0] +
-                                    a              * tc[idx1] +
-                                    b              * tc[idx2]);
-
-                            }
-
-                            if (normal!= NULL)
-                            {
-                                LLVector4a* norm = face.mNormals;
-
-                                LLVector4a n1,n2,n3;
-                                n1 = norm[idx0];
-                                n1.mul(1.f-a-b);
-
-                                n2 = norm[idx1];
-                                n2.mul(a);
-
-                                n3 = norm[idx2];
-                                n3.mul(b);
-
-                                n1.add(n2);
-                                n1.add(n3);
-
-                                *normal     = n1;
-                            }
-
-                            if (tangent_out != NULL)
-                            {
-                                LLVector4a* tangents = face.mTangents;
-
-                                LLVector4a t1,t2,t3;
-                                t1 = tangents[idx0];
-                                t1.mul(1.f-a-b);
-
-                                t2 = tangents[idx1];
-                                t2.mul(a);
-
-                                t3 = tangents[idx2];
-                                t3.mul(b);
-
-                                t1.add(t2);
-                                t1.add(t3);
-
-                                *tangent_out = t1;
-                            }
+                            interpolate_hit(face, j, a, b, tex_coord, normal, tangent_out);
                         }
                     }
                 }
@@ -4860,6 +5598,10 @@ LLVolumeFace& LLVolumeFace::operator=(const LLVolumeFace& src)
     mOptimized = src.mOptimized;
     mNormalizedScale = src.mNormalizedScale;
 
+    // same triangles, the hierarchy can be shared
+    mBVH = src.mBVH;
+    mBVHRequest = src.mBVHRequest;
+
     //delete
     return *this;
 }
@@ -4897,6 +5639,7 @@ void LLVolumeFace::freeData()
 #endif
 
     destroyOctree();
+    destroyBVH();
 }
 
 BOOL LLVolumeFace::create(LLVolume* volume, BOOL partial_build)
@@ -4905,6 +5648,7 @@ BOOL LLVolumeFace::create(LLVolume* volume, BOOL partial_build)
 
     //tree for this face is no longer valid
     destroyOctree();
+    destroyBVH();
 
     LL_CHECK_MEMORY
     BOOL ret = FALSE ;
@@ -5673,6 +6417,81 @@ const LLVolumeOctree* LLVolumeFace::getOctree() const
     return mOctree;
 }
 
+void LLVolumeFace::createBVH()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME
+
+    if (mBVH.notNull())
+    {
+        return;
+    }
+
+    llassert(mNumIndices % 3 == 0);
+
+    mBVH = new LLVolumeBVH(mPositions, mIndices, mNumIndices);
+    mBVHRequest.reset();
+}
+
+void LLVolumeFace::requestBVH()
+{
+    if (mBVH.notNull() || mBVHRequest)
+    {
+        return;
+    }
+
+    LL::WorkQueue::ptr_t queue;
+    if (LL::ThreadPoolBase::getWidth("VolumeGen", 0) > 0)
+    {
+        queue = LL::WorkQueue::getInstance("VolumeGen");
+    }
+
+    if (!queue)
+    {
+        createBVH();
+        return;
+    }
+
+    // The face may change or go away before the worker gets to it, so the
+    // worker gets its own copy of the triangles
+    std::shared_ptr<std::vector<LLVector4a> > positions = std::make_shared<std::vector<LLVector4a> >(mPositions, mPositions + mNumVertices);
+    std::shared_ptr<std::vector<U16> > indices = std::make_shared<std::vector<U16> >(mIndices, mIndices + mNumIndices);
+    std::shared_ptr<LLVolumeBVHRequest> request = std::make_shared<LLVolumeBVHRequest>();
+
+    bool posted = queue->post(
+        [request, positions, indices]()
+        {
+            LL_PROFILE_ZONE_NAMED_CATEGORY_VOLUME("volume bvh build");
+            request->mBVH = new LLVolumeBVH(positions->data(), indices->data(), (S32)indices->size());
+            request->mDone = true;
+        });
+
+    if (posted)
+    {
+        mBVHRequest = request;
+    }
+    else
+    {
+        // Shutting down, build it here
+        createBVH();
+    }
+}
+
+void LLVolumeFace::destroyBVH()
+{
+    mBVH = NULL;
+    mBVHRequest.reset();
+}
+
+const LLVolumeBVH* LLVolumeFace::getBVH()
+{
+    if (mBVHRequest && mBVHRequest->mDone)
+    {
+        mBVH = mBVHRequest->mBVH;
+        mBVHRequest.reset();
+    }
+    return mBVH.get();
+}
+
 
 void LLVolumeFace::swapData(LLVolumeFace& rhs)
 {
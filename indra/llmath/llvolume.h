@@ -27,7 +27,9 @@
 #ifndef LL_LLVOLUME_H
 #define LL_LLVOLUME_H
 
+#include <atomic>
 #include <iostream>
+#include <memory>
 
 class LLProfileParams;
 class LLPathParams;
@@ -42,6 +44,7 @@ class LLVolumeFace;
 class LLVolume;
 class LLVolumeTriangle;
 class LLVolumeOctree;
+struct LLMeshFaceSource;
 
 #include "lluuid.h"
 #include "v4color.h"
@@ -60,6 +63,7 @@ class LLVolumeOctree;
 #include "llfile.h"
 #include "llalignedarray.h"
 #include "llrigginginfo.h"
+#include "llvolumebvh.h"
 
 //============================================================================
 
@@ -919,6 +923,15 @@ class LLVolumeFace
     // Get a reference to the octree, which may be null
     const LLVolumeOctree* getOctree() const;
 
+    // Ray cast hierarchy, an alternative to the octree. createBVH() builds
+    // it here, requestBVH() builds it on the "VolumeGen" thread pool, or
+    // here if there is no pool. getBVH() is null until one is built.
+    void createBVH();
+    void requestBVH();
+    void destroyBVH();
+    bool isBVHPending() const { return mBVHRequest != nullptr; }
+    const LLVolumeBVH* getBVH();
+
     enum
     {
         SINGLE_MASK =   0x0001,
@@ -989,6 +1002,10 @@ class LLVolumeFace
     LLVolumeOctree* mOctree;
     LLVolumeTriangle* mOctreeTriangles;
 
+    // Shared between copies of the face, the triangles are copied into it
+    LLPointer<LLVolumeBVH> mBVH;
+    std::shared_ptr<LLVolumeBVHRequest> mBVHRequest;
+
     BOOL createUnCutCubeCap(LLVolume* volume, BOOL partial_build = FALSE);
     BOOL createCap(LLVolume* volume, BOOL partial_build = FALSE);
     BOOL createSide(LLVolume* volume, BOOL partial_build = FALSE);
@@ -997,6 +1014,7 @@ class LLVolumeFace
 class LLVolume : public LLRefCount
 {
     friend class LLVolumeLODGroup;
+    friend class LLVolumeMgr;
 
 protected:
     ~LLVolume() override; // use unref
@@ -1040,6 +1058,10 @@ class LLVolume : public LLRefCount
     BOOL isFlat(S32 face);
     BOOL isUnique() const                                   { return mUnique; }
 
+    // True while LLVolumeMgr builds this LOD on its thread pool. Until then
+    // the volume holds LOD 0 geometry with the same faces.
+    bool isGenerating() const                               { return mGenerating; }
+
     S32 getSculptLevel() const                              { return mSculptLevel; }
     void setSculptLevel(S32 level)                          { mSculptLevel = level; }
 
@@ -1069,7 +1091,10 @@ class LLVolume : public LLRefCount
     LLFaceID generateFaceMask();
 
     BOOL isFaceMaskValid(LLFaceID face_mask);
-    static S32 sNumMeshPoints;
+    static std::atomic<S32> sNumMeshPoints;
+    // lineSegmentIntersect() uses LLVolumeBVH instead of the octree, see
+    // RaycastUseBVH. Main thread.
+    static bool sUseBVH;
 
     friend std::ostream& operator<<(std::ostream &s, const LLVolume &volume);
     friend std::ostream& operator<<(std::ostream &s, const LLVolume *volumep);      // HACK to bypass Windoze confusion over
@@ -1106,8 +1131,21 @@ class LLVolume : public LLRefCount
 public:
     bool unpackVolumeFaces(std::istream& is, S32 size);
     bool unpackVolumeFaces(U8* in_data, S32 size);
+    // Same as above for an asset that has already been parsed, for tools
+    // and tests
+    bool unpackVolumeFaces(const LLSD& mdl);
+
+    // Flat copy of the faces of an unpacked mesh, after cache optimization
+    // and tangent generation. Every array is 16 byte aligned and laid out
+    // as the face keeps it, so unpacking is a validated copy per buffer.
+    void packDecodedFaces(std::vector<U8>& out) const;
+    bool unpackDecodedFaces(const U8* data, S32 size);
 private:
+    // Takes the geometry of volume, built from the same params on the
+    // LLVolumeMgr thread pool
+    void takeGeneratedFrom(LLVolume* volume);
     bool unpackVolumeFacesInternal(const LLSD& mdl);
+    bool unpackMeshFaces(const std::vector<LLMeshFaceSource>& faces);
 
 public:
     virtual void setMeshAssetLoaded(bool loaded);
@@ -1122,6 +1160,7 @@ class LLVolume : public LLRefCount
     F32 mSurfaceArea; //unscaled surface area
     bool mIsMeshAssetLoaded;
     bool mIsMeshAssetUnavaliable;
+    bool mGenerating;
 
     const LLVolumeParams mParams;
     LLPath *mPathp;
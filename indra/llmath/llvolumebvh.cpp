@@ -0,0 +1,557 @@
+/**
+ * @file llvolumebvh.cpp
+ * @brief Flat bounding volume hierarchy over the triangles of a volume face
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llvolumebvh.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Buckets per axis when looking for the cheapest split
+    const U32 NUM_BINS = 12;
+    // Below this depth splits follow the surface area heuristic, past it
+    // nodes are split at the median so degenerate input can't run away
+    const U32 MAX_SAH_DEPTH = 48;
+    // Deeper than any tree the build can make, 48 SAH levels plus the
+    // median levels over 64k triangles
+    const U32 MAX_STACK = 128;
+
+    struct BuildEntry
+    {
+        U32 mNode;
+        U32 mBegin;
+        U32 mEnd;
+        U32 mDepth;
+    };
+
+    struct Bin
+    {
+        LLVector4a mMin;
+        LLVector4a mMax;
+        U32 mCount;
+    };
+
+    struct TraversalEntry
+    {
+        U32 mNode;
+        F32 mNear;
+    };
+
+    F32 half_area(const LLVector4a& min, const LLVector4a& max)
+    {
+        LLVector4a size;
+        size.setSub(max, min);
+        return size[0] * size[1] + size[1] * size[2] + size[2] * size[0];
+    }
+
+    void clear_bounds(LLVector4a& min, LLVector4a& max)
+    {
+        min.splat(F32_MAX);
+        max.splat(-F32_MAX);
+    }
+
+    // Slab test of the ray against a node. Lane 3 of the node holds mFirst
+    // or mCount and is left out of the result.
+    bool intersect_box(const F32* node_min, const F32* node_max, const LLVector4a& origin, const LLVector4a& inv_dir,
+                       F32 max_t, F32& t_near)
+    {
+        LLVector4a t0, t1;
+        t0.loadua(node_min);
+        t1.loadua(node_max);
+        t0.sub(origin);
+        t0.mul(inv_dir);
+        t1.sub(origin);
+        t1.mul(inv_dir);
+
+        LLQuad lo = _mm_min_ps(t0, t1);
+        LLQuad hi = _mm_max_ps(t0, t1);
+
+        LLQuad near_t = _mm_max_ss(_mm_max_ss(lo, _mm_shuffle_ps(lo, lo, _MM_SHUFFLE(3, 0, 2, 1))),
+                                   _mm_max_ss(_mm_shuffle_ps(lo, lo, _MM_SHUFFLE(3, 1, 0, 2)), _mm_setzero_ps()));
+        LLQuad far_t = _mm_min_ss(_mm_min_ss(hi, _mm_shuffle_ps(hi, hi, _MM_SHUFFLE(3, 0, 2, 1))),
+                                  _mm_min_ss(_mm_shuffle_ps(hi, hi, _MM_SHUFFLE(3, 1, 0, 2)), _mm_set_ss(max_t)));
+
+        t_near = _mm_cvtss_f32(near_t);
+        return _mm_comile_ss(near_t, far_t);
+    }
+
+    // out = a x b for four vectors stored one component per register
+    void cross_soa(const LLVector4a* a, const LLVector4a* b, LLVector4a* out)
+    {
+        LLVector4a tmp;
+        out[0].setMul(a[1], b[2]);
+        tmp.setMul(a[2], b[1]);
+        out[0].sub(tmp);
+        out[1].setMul(a[2], b[0]);
+        tmp.setMul(a[0], b[2]);
+        out[1].sub(tmp);
+        out[2].setMul(a[0], b[1]);
+        tmp.setMul(a[1], b[0]);
+        out[2].sub(tmp);
+    }
+
+    void dot_soa(const LLVector4a* a, const LLVector4a* b, LLVector4a& out)
+    {
+        LLVector4a tmp;
+        out.setMul(a[0], b[0]);
+        tmp.setMul(a[1], b[1]);
+        out.add(tmp);
+        tmp.setMul(a[2], b[2]);
+        out.add(tmp);
+    }
+}
+
+LLVolumeBVH::LLVolumeBVH(const LLVector4a* positions, const U16* indices, S32 num_indices)
+:   mNumTriangles(num_indices > 0 ? (U32)num_indices / 3 : 0),
+    mDepth(0)
+{
+    if (mNumTriangles > 0 && positions && indices)
+    {
+        build(positions, indices);
+    }
+}
+
+LLVolumeBVH::~LLVolumeBVH()
+{
+}
+
+size_t LLVolumeBVH::getMemoryUsage() const
+{
+    return sizeof(LLVolumeBVH) + mNodes.capacity() * sizeof(Node) + mPacks.capacity() * sizeof(TrianglePack)
+        + mTriangles.capacity() * sizeof(U32);
+}
+
+void LLVolumeBVH::build(const LLVector4a* positions, const U16* indices)
+{
+    const U32 count = mNumTriangles;
+
+    std::vector<LLVector4a> tri_min(count);
+    std::vector<LLVector4a> tri_max(count);
+    std::vector<LLVector4a> centroid(count);
+    std::vector<U32> order(count);
+
+    LLVector4a face_min, face_max;
+    clear_bounds(face_min, face_max);
+
+    for (U32 i = 0; i < count; ++i)
+    {
+        const LLVector4a& v0 = positions[indices[i * 3 + 0]];
+        const LLVector4a& v1 = positions[indices[i * 3 + 1]];
+        const LLVector4a& v2 = positions[indices[i * 3 + 2]];
+
+        tri_min[i].setMin(v0, v1);
+        tri_min[i].setMin(tri_min[i], v2);
+        tri_max[i].setMax(v0, v1);
+        tri_max[i].setMax(tri_max[i], v2);
+        centroid[i].setAdd(tri_min[i], tri_max[i]);
+        centroid[i].mul(0.5f);
+        order[i] = i;
+
+        face_min.setMin(face_min, tri_min[i]);
+        face_max.setMax(face_max, tri_max[i]);
+    }
+
+    // Grow every box a little so rays along a face of the box aren't lost to
+    // rounding in the slab test
+    LLVector4a pad;
+    pad.setSub(face_max, face_min);
+    pad.splat(llmax(llmax(pad[0], pad[1]), pad[2]) * 1.0e-5f + 1.0e-6f);
+
+    // A full binary tree has at most 2n - 1 nodes, leaves of up to four
+    // triangles usually need about half the triangle count
+    mNodes.reserve(count);
+    mPacks.reserve(count / 2 + 1);
+    mTriangles.reserve((count / 2 + 1) * LEAF_SIZE);
+
+    mNodes.emplace_back();
+
+    std::vector<BuildEntry> stack;
+    stack.push_back({ 0, 0, count, 0 });
+
+    Bin bins[NUM_BINS];
+    F32 right_area[NUM_BINS];
+    U32 right_count[NUM_BINS];
+
+    while (!stack.empty())
+    {
+        BuildEntry entry = stack.back();
+        stack.pop_back();
+
+        mDepth = llmax(mDepth, entry.mDepth);
+
+        LLVector4a node_min, node_max, cent_min, cent_max;
+        clear_bounds(node_min, node_max);
+        clear_bounds(cent_min, cent_max);
+
+        for (U32 i = entry.mBegin; i < entry.mEnd; ++i)
+        {
+            U32 tri = order[i];
+            node_min.setMin(node_min, tri_min[tri]);
+            node_max.setMax(node_max, tri_max[tri]);
+            cent_min.setMin(cent_min, centroid[tri]);
+            cent_max.setMax(cent_max, centroid[tri]);
+        }
+
+        node_min.sub(pad);
+        node_max.add(pad);
+
+        {
+            Node& node = mNodes[entry.mNode];
+            for (U32 k = 0; k < 3; ++k)
+            {
+                node.mMin[k] = node_min[k];
+                node.mMax[k] = node_max[k];
+            }
+        }
+
+        const U32 num = entry.mEnd - entry.mBegin;
+
+        if (num <= LEAF_SIZE)
+        {
+            Node& node = mNodes[entry.mNode];
+            node.mFirst = (U32)mPacks.size();
+            node.mCount = num;
+
+            mPacks.emplace_back();
+            TrianglePack& pack = mPacks.back();
+
+            F32 v0[3][LEAF_SIZE] = {};
+            F32 e1[3][LEAF_SIZE] = {};
+            F32 e2[3][LEAF_SIZE] = {};
+
+            for (U32 lane = 0; lane < LEAF_SIZE; ++lane)
+            {
+                // Unused lanes have zero edges, a zero determinant never
+                // passes the intersection test
+                U32 tri = order[entry.mBegin + llmin(lane, num - 1)];
+                mTriangles.push_back(tri);
+
+                if (lane < num)
+                {
+                    const LLVector4a& p0 = positions[indices[tri * 3 + 0]];
+                    const LLVector4a& p1 = positions[indices[tri * 3 + 1]];
+                    const LLVector4a& p2 = positions[indices[tri * 3 + 2]];
+
+                    for (U32 k = 0; k < 3; ++k)
+                    {
+                        v0[k][lane] = p0[k];
+                        e1[k][lane] = p1[k] - p0[k];
+                        e2[k][lane] = p2[k] - p0[k];
+                    }
+                }
+            }
+
+            for (U32 k = 0; k < 3; ++k)
+            {
+                pack.mV0[k].loadua(v0[k]);
+                pack.mEdge1[k].loadua(e1[k]);
+                pack.mEdge2[k].loadua(e2[k]);
+            }
+            continue;
+        }
+
+        // Find the cheapest binned split over all three axes
+        U32 mid = entry.mBegin;
+        if (entry.mDepth < MAX_SAH_DEPTH)
+        {
+            F32 best_cost = F32_MAX;
+            S32 best_axis = -1;
+            U32 best_split = 0;
+
+            for (U32 axis = 0; axis < 3; ++axis)
+            {
+                const F32 extent = cent_max[axis] - cent_min[axis];
+                if (extent <= 0.f)
+                {
+                    continue;
+                }
+
+                const F32 scale = NUM_BINS / extent;
+
+                for (U32 b = 0; b < NUM_BINS; ++b)
+                {
+                    clear_bounds(bins[b].mMin, bins[b].mMax);
+                    bins[b].mCount = 0;
+                }
+
+                for (U32 i = entry.mBegin; i < entry.mEnd; ++i)
+                {
+                    U32 tri = order[i];
+                    U32 b = llmin((U32)((centroid[tri][axis] - cent_min[axis]) * scale), NUM_BINS - 1);
+                    bins[b].mMin.setMin(bins[b].mMin, tri_min[tri]);
+                    bins[b].mMax.setMax(bins[b].mMax, tri_max[tri]);
+                    bins[b].mCount++;
+                }
+
+                LLVector4a min, max;
+                clear_bounds(min, max);
+                U32 sum = 0;
+                for (U32 b = NUM_BINS - 1; b > 0; --b)
+                {
+                    min.setMin(min, bins[b].mMin);
+                    max.setMax(max, bins[b].mMax);
+                    sum += bins[b].mCount;
+                    right_count[b] = sum;
+                    right_area[b] = sum ? half_area(min, max) : 0.f;
+                }
+
+                clear_bounds(min, max);
+                sum = 0;
+                for (U32 b = 1; b < NUM_BINS; ++b)
+                {
+                    min.setMin(min, bins[b - 1].mMin);
+                    max.setMax(max, bins[b - 1].mMax);
+                    sum += bins[b - 1].mCount;
+
+                    if (sum == 0 || right_count[b] == 0)
+                    {
+                        continue;
+                    }
+
+                    F32 cost = half_area(min, max) * sum + right_area[b] * right_count[b];
+                    if (cost < best_cost)
+                    {
+                        best_cost = cost;
+                        best_axis = axis;
+                        best_split = b;
+                    }
+                }
+            }
+
+            if (best_axis >= 0)
+            {
+                const F32 scale = NUM_BINS / (cent_max[best_axis] - cent_min[best_axis]);
+                const F32 base = cent_min[best_axis];
+                U32* split = std::partition(order.data() + entry.mBegin, order.data() + entry.mEnd,
+                    [&](U32 tri)
+                    {
+                        return llmin((U32)((centroid[tri][best_axis] - base) * scale), NUM_BINS - 1) < best_split;
+                    });
+                mid = (U32)(split - order.data());
+            }
+        }
+
+        if (mid == entry.mBegin || mid == entry.mEnd)
+        {
+            // No useful split, cut the longest centroid axis in half by count
+            LLVector4a extent;
+            extent.setSub(cent_max, cent_min);
+            S32 axis = 0;
+            if (extent[1] > extent[axis])
+            {
+                axis = 1;
+            }
+            if (extent[2] > extent[axis])
+            {
+                axis = 2;
+            }
+
+            mid = entry.mBegin + num / 2;
+            std::nth_element(order.data() + entry.mBegin, order.data() + mid, order.data() + entry.mEnd,
+                [&](U32 lhs, U32 rhs)
+                {
+                    return centroid[lhs][axis] < centroid[rhs][axis];
+                });
+        }
+
+        const U32 left = (U32)mNodes.size();
+        mNodes.emplace_back();
+        mNodes.emplace_back();
+
+        Node& node = mNodes[entry.mNode];
+        node.mFirst = left;
+        node.mCount = 0;
+
+        stack.push_back({ left + 1, mid, entry.mEnd, entry.mDepth + 1 });
+        stack.push_back({ left, entry.mBegin, mid, entry.mDepth + 1 });
+    }
+
+    llassert(mDepth < MAX_STACK);
+}
+
+S32 LLVolumeBVH::intersect(const LLVector4a& start, const LLVector4a& dir, F32& closest_t, F32& a, F32& b) const
+{
+    if (mNodes.empty())
+    {
+        return -1;
+    }
+
+    // Keep the reciprocal finite so the slab test never sees 0 * inf
+    LLVector4a inv_dir;
+    {
+        F32 inv[4];
+        for (U32 k = 0; k < 3; ++k)
+        {
+            F32 d = dir[k];
+            if (fabsf(d) < 1.0e-20f)
+            {
+                d = copysignf(1.0e-20f, d);
+            }
+            inv[k] = 1.f / d;
+        }
+        inv[3] = 0.f;
+        inv_dir.loadua(inv);
+    }
+
+    LLVector4a orig[3];
+    LLVector4a ray[3];
+    for (U32 k = 0; k < 3; ++k)
+    {
+        orig[k].splat(start, k);
+        ray[k].splat(dir, k);
+    }
+
+    const LLVector4a zero = LLVector4a::getZero();
+    const LLVector4a epsilon = LLVector4a::getEpsilon();
+    LLVector4a one;
+    one.splat(1.f);
+
+    TraversalEntry stack[MAX_STACK];
+    U32 stack_size = 0;
+
+    F32 t_near;
+    if (!intersect_box(mNodes[0].mMin, mNodes[0].mMax, start, inv_dir, closest_t, t_near))
+    {
+        return -1;
+    }
+    stack[stack_size++] = { 0, t_near };
+
+    S32 hit = -1;
+
+    while (stack_size > 0)
+    {
+        const TraversalEntry entry = stack[--stack_size];
+        if (entry.mNear > closest_t)
+        {
+            // A closer hit was found since this node was pushed
+            continue;
+        }
+
+        const Node& node = mNodes[entry.mNode];
+
+        if (node.mCount > 0)
+        {
+            const TrianglePack& pack = mPacks[node.mFirst];
+
+            // Moller-Trumbore on four triangles at once, same tests as
+            // LLTriangleRayIntersect
+            LLVector4a pvec[3];
+            cross_soa(ray, pack.mEdge2, pvec);
+
+            LLVector4a det;
+            dot_soa(pack.mEdge1, pvec, det);
+
+            U32 mask = det.greaterEqual(epsilon).getGatheredBits();
+            if (!mask)
+            {
+                continue;
+            }
+
+            LLVector4a tvec[3];
+            for (U32 k = 0; k < 3; ++k)
+            {
+                tvec[k].setSub(orig[k], pack.mV0[k]);
+            }
+
+            LLVector4a u;
+            dot_soa(tvec, pvec, u);
+            mask &= u.greaterEqual(zero).getGatheredBits() & u.lessEqual(det).getGatheredBits();
+            if (!mask)
+            {
+                continue;
+            }
+
+            LLVector4a qvec[3];
+            cross_soa(tvec, pack.mEdge1, qvec);
+
+            LLVector4a v;
+            dot_soa(ray, qvec, v);
+
+            LLVector4a sum_uv;
+            sum_uv.setAdd(u, v);
+            mask &= v.greaterEqual(zero).getGatheredBits() & sum_uv.lessEqual(det).getGatheredBits();
+            if (!mask)
+            {
+                continue;
+            }
+
+            LLVector4a t;
+            dot_soa(pack.mEdge2, qvec, t);
+            t.div(det);
+
+            LLVector4a max_t;
+            max_t.splat(closest_t);
+            mask &= t.greaterEqual(zero).getGatheredBits() & t.lessEqual(one).getGatheredBits()
+                & t.lessThan(max_t).getGatheredBits();
+
+            for (U32 lane = 0; mask; ++lane, mask >>= 1)
+            {
+                if ((mask & 1) && t[lane] < closest_t)
+                {
+                    closest_t = t[lane];
+                    a = u[lane] / det[lane];
+                    b = v[lane] / det[lane];
+                    hit = (S32)mTriangles[node.mFirst * LEAF_SIZE + lane];
+                }
+            }
+            continue;
+        }
+
+        // Visit the nearer child first, the farther one is often skipped
+        F32 t_left, t_right;
+        const Node& left = mNodes[node.mFirst];
+        const Node& right = mNodes[node.mFirst + 1];
+        bool hit_left = intersect_box(left.mMin, left.mMax, start, inv_dir, closest_t, t_left);
+        bool hit_right = intersect_box(right.mMin, right.mMax, start, inv_dir, closest_t, t_right);
+
+        if (hit_left && hit_right)
+        {
+            if (t_left <= t_right)
+            {
+                stack[stack_size++] = { node.mFirst + 1, t_right };
+                stack[stack_size++] = { node.mFirst, t_left };
+            }
+            else
+            {
+                stack[stack_size++] = { node.mFirst, t_left };
+                stack[stack_size++] = { node.mFirst + 1, t_right };
+            }
+        }
+        else if (hit_left)
+        {
+            stack[stack_size++] = { node.mFirst, t_left };
+        }
+        else if (hit_right)
+        {
+            stack[stack_size++] = { node.mFirst + 1, t_right };
+        }
+    }
+
+    return hit;
+}
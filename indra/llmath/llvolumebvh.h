@@ -0,0 +1,103 @@
+/**
+ * @file llvolumebvh.h
+ * @brief Flat bounding volume hierarchy over the triangles of a volume face
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLVOLUMEBVH_H
+#define LL_LLVOLUMEBVH_H
+
+#include "linden_common.h"
+#include "llmath.h"
+#include "llpointer.h"
+#include "llrefcount.h"
+#include "llvector4a.h"
+
+#include <atomic>
+#include <vector>
+
+// Ray cast acceleration structure for one LLVolumeFace, an alternative to
+// LLVolumeOctree. Nodes live in one array, children next to each other,
+// and are split by the surface area heuristic. Each leaf holds up to four
+// triangles stored side by side, so a ray is tested against the whole leaf
+// at once.
+//
+// The hierarchy keeps its own copy of the triangles and never changes once
+// built, so it can be built on any thread and shared between copies of the
+// face.
+class LLVolumeBVH : public LLThreadSafeRefCount
+{
+public:
+    static const U32 LEAF_SIZE = 4;
+
+    // Builds over num_indices / 3 triangles
+    LLVolumeBVH(const LLVector4a* positions, const U16* indices, S32 num_indices);
+    ~LLVolumeBVH();
+
+    // Finds the closest front facing triangle hit by the segment from start
+    // to start + dir, with the same rules as LLTriangleRayIntersect. Only
+    // hits with t in [0, 1] and below closest_t count. Returns the index of
+    // the triangle in the face (first index / 3) and updates closest_t, a and
+    // b, or returns -1.
+    S32 intersect(const LLVector4a& start, const LLVector4a& dir, F32& closest_t, F32& a, F32& b) const;
+
+    U32 getNumNodes() const { return (U32)mNodes.size(); }
+    U32 getNumTriangles() const { return mNumTriangles; }
+    U32 getDepth() const { return mDepth; }
+    size_t getMemoryUsage() const;
+
+private:
+    struct alignas(16) Node
+    {
+        F32 mMin[3];
+        U32 mFirst;     // leaf: first pack, inner node: left child
+        F32 mMax[3];
+        U32 mCount;     // triangles in the leaf, 0 for inner nodes
+    };
+
+    // Four triangles, one per lane
+    struct alignas(16) TrianglePack
+    {
+        LLVector4a mV0[3];
+        LLVector4a mEdge1[3];
+        LLVector4a mEdge2[3];
+    };
+
+    void build(const LLVector4a* positions, const U16* indices);
+
+    std::vector<Node> mNodes;
+    std::vector<TrianglePack> mPacks;
+    std::vector<U32> mTriangles;    // face triangle of each pack lane
+    U32 mNumTriangles;
+    U32 mDepth;
+};
+
+// Hand over of a hierarchy built on another thread. The builder fills in
+// mBVH and then sets mDone, the owner picks it up from its own thread.
+struct LLVolumeBVHRequest
+{
+    LLPointer<LLVolumeBVH> mBVH;
+    std::atomic<bool> mDone{ false };
+};
+
+#endif // LL_LLVOLUMEBVH_H
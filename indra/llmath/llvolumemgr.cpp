@@ -27,6 +27,7 @@
 
 #include "llvolumemgr.h"
 #include "llvolume.h"
+#include "threadpool.h"
 
 
 const F32 BASE_THRESHOLD = 0.03f;
@@ -44,17 +45,28 @@ F32 LLVolumeLODGroup::mDetailScales[NUM_LODS] = {1.f, 1.5f, 2.5f, 4.f};
 //============================================================================
 
 LLVolumeMgr::LLVolumeMgr()
-:   mDataMutex(NULL)
+:   mDataMutex(new LLMutex())
 {
-    // the LLMutex magic interferes with easy unit testing,
-    // so you now must manually call useMutex() to use it
-    //mDataMutex = new LLMutex();
 }
 
 LLVolumeMgr::~LLVolumeMgr()
 {
+    // Pending builds only know the stand ins by address
+    if (mGenerationPool)
+    {
+        mGenerationPool->close();
+        mGenerationPool.reset();
+    }
+
     cleanup();
 
+    // Built but never collected, nothing else refers to them
+    for (auto& generated : mGenerated)
+    {
+        delete generated.second;
+    }
+    mGenerated.clear();
+
     delete mDataMutex;
     mDataMutex = NULL;
 }
@@ -78,6 +90,8 @@ BOOL LLVolumeMgr::cleanup()
         delete volgroupp;
     }
     mVolumeLODGroups.clear();
+    mGenerating.clear();
+    mFinished.clear();
     if (mDataMutex)
     {
         mDataMutex->unlock();
@@ -91,11 +105,10 @@ BOOL LLVolumeMgr::cleanup()
 //  anything holding the volume and the LODGroup are destroyed
 LLVolume* LLVolumeMgr::refVolume(const LLVolumeParams &volume_params, const S32 lod)
 {
+    // The group's ref counts and LODs are shared too, so the lock is held
+    // while a missing LOD is built
+    LLMutexLock lock(mDataMutex);
     LLVolumeLODGroup* volgroupp;
-    if (mDataMutex)
-    {
-        mDataMutex->lock();
-    }
     volume_lod_group_map_t::iterator iter = mVolumeLODGroups.find(&volume_params);
     if( iter == mVolumeLODGroups.end() )
     {
@@ -105,11 +118,143 @@ LLVolume* LLVolumeMgr::refVolume(const LLVolumeParams &volume_params, const S32
     {
         volgroupp = iter->second;
     }
-    if (mDataMutex)
+    LLVolume* volumep = volgroupp->refLOD(lod);
+    if (volumep->isGenerating())
     {
-        mDataMutex->unlock();
+        // Stand ins are only for refVolumeDeferred() callers
+        finishGenerating(volumep);
+    }
+    return volumep;
+}
+
+LLVolume* LLVolumeMgr::refVolumeDeferred(const LLVolumeParams& volume_params, const S32 lod)
+{
+    if (!mGenerationPool || mGenerationPool->getWidth() == 0 || !canDefer(volume_params, lod))
+    {
+        return refVolume(volume_params, lod);
+    }
+
+    LLVolume* volumep;
+    bool placeholder;
+    {
+        LLMutexLock lock(mDataMutex);
+        LLVolumeLODGroup* volgroupp;
+        volume_lod_group_map_t::iterator iter = mVolumeLODGroups.find(&volume_params);
+        if (iter == mVolumeLODGroups.end())
+        {
+            volgroupp = createNewGroup(volume_params);
+        }
+        else
+        {
+            volgroupp = iter->second;
+        }
+        placeholder = !volgroupp->hasLOD(lod);
+        volumep = volgroupp->refLOD(lod, placeholder);
+        if (placeholder)
+        {
+            mGenerating[volumep] = volumep;
+        }
+    }
+
+    if (placeholder)
+    {
+        generate(volumep);
+    }
+    return volumep;
+}
+
+//static
+bool LLVolumeMgr::canDefer(const LLVolumeParams& volume_params, const S32 lod)
+{
+    // LOD 0 is the stand in. Sculpts and meshes replace their geometry
+    // later anyway, and flexible paths are rebuilt every frame.
+    return lod > 0
+        && volume_params.getSculptType() == LL_SCULPT_TYPE_NONE
+        && volume_params.getSculptID().isNull()
+        && volume_params.getPathParams().getCurveType() != LL_PCODE_PATH_FLEXIBLE;
+}
+
+void LLVolumeMgr::generate(LLVolume* placeholder)
+{
+    const LLVolumeParams params = placeholder->getParams();
+    const F32 detail = placeholder->getDetail();
+    const LLVolume* key = placeholder;
+
+    bool posted = mGenerationPool->getQueue().post(
+        [this, key, params, detail]()
+        {
+            LLVolume* volume = new LLVolume(params, detail);
+
+            LLMutexLock lock(&mGeneratedMutex);
+            mGenerated.emplace_back(key, volume);
+        });
+
+    if (!posted)
+    {
+        // Shutting down, build it here
+        LLPointer<LLVolume> volume = new LLVolume(params, detail);
+        LLMutexLock lock(mDataMutex);
+        placeholder->takeGeneratedFrom(volume);
+        mGenerating.erase(key);
+    }
+}
+
+// Builds the LOD of a stand in on this thread. Called with mDataMutex
+// held. The pool's copy is dropped when it comes in.
+void LLVolumeMgr::finishGenerating(LLVolume* placeholder)
+{
+    LLPointer<LLVolume> volume = new LLVolume(placeholder->getParams(), placeholder->getDetail());
+    placeholder->takeGeneratedFrom(volume);
+
+    generating_map_t::iterator iter = mGenerating.find(placeholder);
+    if (iter != mGenerating.end())
+    {
+        // Objects already showing the stand in still need a rebuild
+        mFinished.push_back(iter->second);
+        mGenerating.erase(iter);
+    }
+}
+
+void LLVolumeMgr::updateGenerated(std::vector<LLPointer<LLVolume> >& done)
+{
+    generated_list_t generated;
+    {
+        LLMutexLock lock(&mGeneratedMutex);
+        generated.swap(mGenerated);
+    }
+
+    LLMutexLock lock(mDataMutex);
+    done.insert(done.end(), mFinished.begin(), mFinished.end());
+    mFinished.clear();
+    for (auto& item : generated)
+    {
+        LLPointer<LLVolume> volume = item.second;
+        generating_map_t::iterator iter = mGenerating.find(item.first);
+        if (iter == mGenerating.end())
+        {
+            // cleaned up
+            continue;
+        }
+        // volume leaves with the stand in geometry
+        iter->second->takeGeneratedFrom(volume);
+        done.push_back(iter->second);
+        mGenerating.erase(iter);
+    }
+}
+
+S32 LLVolumeMgr::getNumGenerating() const
+{
+    LLMutexLock lock(mDataMutex);
+    return (S32)mGenerating.size();
+}
+
+void LLVolumeMgr::startGenerationPool()
+{
+    if (!mGenerationPool)
+    {
+        mGenerationPool.reset(new LL::ThreadPool("VolumeGen", 2));
+        mGenerationPool->start();
     }
-    return volgroupp->refLOD(lod);
 }
 
 // virtual
@@ -212,10 +357,6 @@ void LLVolumeMgr::dump()
 
 void LLVolumeMgr::useMutex()
 {
-    if (!mDataMutex)
-    {
-        mDataMutex = new LLMutex();
-    }
 }
 
 std::ostream& operator<<(std::ostream& s, const LLVolumeMgr& volume_mgr)
@@ -287,7 +428,7 @@ bool LLVolumeLODGroup::cleanupRefs()
     return res;
 }
 
-LLVolume* LLVolumeLODGroup::refLOD(const S32 lod)
+LLVolume* LLVolumeLODGroup::refLOD(const S32 lod, bool placeholder)
 {
     llassert(lod >=0 && lod < NUM_LODS);
     mAccessCount[lod]++;
@@ -295,7 +436,19 @@ LLVolume* LLVolumeLODGroup::refLOD(const S32 lod)
     mRefs++;
     if (mVolumeLODs[lod].isNull())
     {
-        mVolumeLODs[lod] = new LLVolume(mVolumeParams, mDetailScales[lod]);
+        if (placeholder)
+        {
+            // Reports the detail it will have, so that callers don't ask for
+            // it again
+            LLVolume* volume = new LLVolume(mVolumeParams, mDetailScales[0]);
+            volume->mDetail = mDetailScales[lod];
+            volume->mGenerating = true;
+            mVolumeLODs[lod] = volume;
+        }
+        else
+        {
+            mVolumeLODs[lod] = new LLVolume(mVolumeParams, mDetailScales[lod]);
+        }
     }
     mLODRefs[lod]++;
     return mVolumeLODs[lod];
@@ -28,10 +28,13 @@
 #define LL_LLVOLUMEMGR_H
 
 #include <map>
+#include <memory>
+#include <vector>
 
 #include "llvolume.h"
 #include "llpointer.h"
 #include "llthread.h"
+#include "threadpool_fwd.h"
 
 class LLVolumeParams;
 class LLVolumeLODGroup;
@@ -55,8 +58,11 @@ class LLVolumeLODGroup
     static F32 getVolumeScaleFromDetail(const S32 detail);
     static S32 getVolumeDetailFromScale(F32 scale);
 
-    LLVolume* refLOD(const S32 detail);
+    // A LOD that doesn't exist yet is built right away, or with placeholder
+    // set, built at LOD 0 and marked as generating, see LLVolumeMgr
+    LLVolume* refLOD(const S32 detail, bool placeholder = false);
     BOOL derefLOD(LLVolume *volumep);
+    bool hasLOD(const S32 detail) const { return mVolumeLODs[detail].notNull(); }
     S32 getNumRefs() const { return mRefs; }
 
     const LLVolumeParams* getVolumeParams() const { return &mVolumeParams; };
@@ -87,12 +93,32 @@ class LLVolumeMgr
     // whatever calls getVolume() never owns the LLVolume* and
     // cannot keep references for long since it may be deleted
     // later.  For best results hold it in an LLPointer<LLVolume>.
+    // Always full detail: a stand in left by refVolumeDeferred() is
+    // built on the spot.
     virtual LLVolume *refVolume(const LLVolumeParams &volume_params, const S32 detail);
     virtual void unrefVolume(LLVolume *volumep);
 
+    // Starts the "VolumeGen" thread pool that refVolumeDeferred() builds
+    // LODs on. Sized by the "VolumeGen" entry of ThreadPoolSizes, with 0
+    // volumes are built on the calling thread as before.
+    void startGenerationPool();
+
+    // Same as refVolume(), except that a LOD above 0 of a plain prim that
+    // isn't built yet comes back as a LOD 0 stand in while the pool builds
+    // it, see LLVolume::isGenerating(). Main thread.
+    LLVolume* refVolumeDeferred(const LLVolumeParams& volume_params, const S32 detail);
+
+    // Moves finished LODs into their stand ins, and appends the stand ins
+    // to done, along with those refVolume() finished early. Main thread,
+    // once a frame.
+    void updateGenerated(std::vector<LLPointer<LLVolume> >& done);
+
+    // debug
+    S32 getNumGenerating() const;
+
     void dump();
 
-    // manually call this for mutex magic
+    // The table is always locked now, kept for existing callers
     void useMutex();
 
     friend std::ostream& operator<<(std::ostream& s, const LLVolumeMgr& volume_mgr);
@@ -102,11 +128,29 @@ class LLVolumeMgr
     // Overridden in llphysics/abstract/utils/llphysicsvolumemanager.h
     virtual LLVolumeLODGroup* createNewGroup(const LLVolumeParams& volume_params);
 
+    static bool canDefer(const LLVolumeParams& volume_params, const S32 detail);
+    void generate(LLVolume* placeholder);
+    void finishGenerating(LLVolume* placeholder);
+
 protected:
     typedef std::map<const LLVolumeParams*, LLVolumeLODGroup*, LLVolumeParams::compare> volume_lod_group_map_t;
     volume_lod_group_map_t mVolumeLODGroups;
 
     LLMutex* mDataMutex;
+
+    // Stand ins the pool is building, by address. Under mDataMutex.
+    typedef std::map<const LLVolume*, LLPointer<LLVolume> > generating_map_t;
+    generating_map_t mGenerating;
+    // Stand ins refVolume() built early, for the next updateGenerated()
+    std::vector<LLPointer<LLVolume> > mFinished;
+
+    // Stand in and the volume the pool built for it. The pool threads only
+    // use the stand in as a key.
+    typedef std::vector<std::pair<const LLVolume*, LLVolume*> > generated_list_t;
+    generated_list_t mGenerated;
+    LLMutex mGeneratedMutex;
+
+    std::unique_ptr<LL::ThreadPool> mGenerationPool;
 };
 
 #endif // LL_LLVOLUMEMGR_H
@@ -0,0 +1,270 @@
+/**
+ * @file   llcamera_test.cpp
+ * @brief  Test for the batched frustum tests in llcamera.h.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../test/lltut.h"
+
+#include "../llcamera.h"
+
+#include <chrono>
+#include <random>
+
+namespace
+{
+    // Camera at origin looking along at, with the corners of its frustum
+    // worked out the way LLViewerCamera does
+    void make_camera(LLCamera& camera, const LLVector3& origin, const LLVector3& at, F32 far_clip)
+    {
+        camera.setNear(0.5f);
+        camera.setFar(far_clip);
+        camera.setView(1.f);
+        camera.setAspect(1.5f);
+        LLVector3 up = fabsf(at.mV[VZ]) > 0.9f ? LLVector3(1.f, 0.f, 0.f) : LLVector3(0.f, 0.f, 1.f);
+        camera.lookAt(origin, origin + at, up);
+
+        F32 h = tanf(camera.getView() * 0.5f);
+        F32 w = h * camera.getAspect();
+        const F32 dist[] = { camera.getNear(), camera.getFar() };
+        LLVector3 frust[LLCamera::AGENT_FRUSTRUM_NUM];
+        for (U32 i = 0; i < 2; ++i)
+        {
+            F32 d = dist[i];
+            frust[i * 4 + 0] = camera.getOrigin() + (camera.getAtAxis() + camera.getLeftAxis() * w - camera.getUpAxis() * h) * d;
+            frust[i * 4 + 1] = camera.getOrigin() + (camera.getAtAxis() - camera.getLeftAxis() * w - camera.getUpAxis() * h) * d;
+            frust[i * 4 + 2] = camera.getOrigin() + (camera.getAtAxis() - camera.getLeftAxis() * w + camera.getUpAxis() * h) * d;
+            frust[i * 4 + 3] = camera.getOrigin() + (camera.getAtAxis() + camera.getLeftAxis() * w + camera.getUpAxis() * h) * d;
+        }
+        camera.calcAgentFrustumPlanes(frust);
+    }
+
+    // Boxes of mixed size around the camera, a few of them huge
+    void make_boxes(LLAABBBatch& batch, std::vector<LLVector4a>& boxes, U32 count, U32 seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<F32> coord(-256.f, 256.f);
+        std::uniform_real_distribution<F32> size(0.05f, 4.f);
+
+        batch.clear();
+        boxes.resize(count * 2);
+        for (U32 i = 0; i < count; ++i)
+        {
+            F32 s = (i % 50 == 0) ? size(gen) * 16.f : size(gen);
+            boxes[i * 2].set(coord(gen), coord(gen), coord(gen) * 0.25f);
+            boxes[i * 2 + 1].set(s, s * 0.5f, s * 2.f);
+            batch.add(boxes[i * 2], boxes[i * 2 + 1]);
+        }
+    }
+
+    // LLPipeline::calcPixelArea()
+    F32 pixel_area(const LLVector4a& center, const LLVector4a& size, const LLCamera& camera, F32 pixel_angle)
+    {
+        LLVector4a origin;
+        origin.load3(camera.getOrigin().mV);
+
+        LLVector4a look_at;
+        look_at.setSub(center, origin);
+        F32 dist = look_at.getLength3().getF32();
+        if (dist < 16.f)
+        {
+            dist /= 16.f;
+            dist *= dist;
+            dist *= 16.f;
+        }
+
+        F32 app_angle = atanf(size.getLength3().getF32() / dist);
+        F32 radius = app_angle * pixel_angle;
+        return radius * radius * F_PI;
+    }
+}
+
+namespace tut
+{
+    struct llcamera_data
+    {
+    };
+    typedef test_group<llcamera_data> llcamera_test;
+    typedef llcamera_test::object llcamera_object;
+    tut::llcamera_test tut_llcamera_test("LLCamera");
+
+    // Batched results match the one box tests, for every kind of frustum
+    template<> template<>
+    void llcamera_object::test<1>()
+    {
+        LLAABBBatch batch;
+        std::vector<LLVector4a> boxes;
+
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<F32> coord(-1.f, 1.f);
+        for (U32 view = 0; view < 12; ++view)
+        {
+            // Odd counts leave a part filled group of four at the end
+            const U32 count = 1000 + view * 37;
+            make_boxes(batch, boxes, count, view);
+            ensure_equals("box count", batch.getCount(), count);
+
+            LLVector3 at(coord(gen), coord(gen), coord(gen) * 0.5f);
+            if (at.normVec() < 0.01f)
+            {
+                at.setVec(1.f, 0.f, 0.f);
+            }
+            LLCamera camera;
+            make_camera(camera, LLVector3(coord(gen) * 64.f, coord(gen) * 64.f, 20.f), at, (view & 1) ? 128.f : 512.f);
+            camera.calcRegionFrustumPlanes(LLVector3(48.f, -32.f, 0.f), camera.getFar());
+            if (view % 3 == 2)
+            {
+                camera.ignoreAgentFrustumPlane(LLCamera::AGENT_PLANE_NEAR);
+            }
+
+            std::vector<U32> visible(LLAABBBatch::getMaskSize(count));
+            std::vector<U32> inside(LLAABBBatch::getMaskSize(count));
+            for (U32 mode = 0; mode < 4; ++mode)
+            {
+                const bool far_clip = mode & 1;
+                const bool region = mode & 2;
+                U32 num_visible = region ? camera.AABBInRegionFrustumBatch(batch, visible.data(), inside.data(), far_clip) :
+                                           camera.AABBInFrustumBatch(batch, visible.data(), inside.data(), far_clip);
+
+                U32 expected_visible = 0;
+                U32 partial = 0;
+                for (U32 i = 0; i < count; ++i)
+                {
+                    const LLVector4a& center = boxes[i * 2];
+                    const LLVector4a& size = boxes[i * 2 + 1];
+                    S32 expected;
+                    if (region)
+                    {
+                        expected = far_clip ? camera.AABBInRegionFrustum(center, size) : camera.AABBInRegionFrustumNoFarClip(center, size);
+                    }
+                    else
+                    {
+                        expected = far_clip ? camera.AABBInFrustum(center, size) : camera.AABBInFrustumNoFarClip(center, size);
+                    }
+                    expected_visible += expected != 0;
+                    partial += expected == 1;
+
+                    ensure_equals(llformat("view %u mode %u box %u", view, mode, i),
+                                  LLAABBBatch::getResult(visible.data(), inside.data(), i), expected);
+                }
+                ensure_equals("visible count", num_visible, expected_visible);
+                ensure("some boxes cut by the frustum", partial > 0);
+            }
+        }
+    }
+
+    // Pixel areas match LLPipeline::calcPixelArea(), and only visible boxes
+    // are touched when a mask is given
+    template<> template<>
+    void llcamera_object::test<2>()
+    {
+        LLAABBBatch batch;
+        std::vector<LLVector4a> boxes;
+        const U32 count = 2003;
+        make_boxes(batch, boxes, count, 11);
+
+        LLCamera camera;
+        make_camera(camera, LLVector3(3.f, -5.f, 20.f), LLVector3(1.f, 0.2f, -0.1f), 256.f);
+        const F32 pixel_angle = 1024.f / camera.getView();
+
+        std::vector<F32> areas(count, -1.f);
+        camera.calcPixelAreaBatch(batch, pixel_angle, areas.data());
+        for (U32 i = 0; i < count; ++i)
+        {
+            F32 expected = pixel_area(boxes[i * 2], boxes[i * 2 + 1], camera, pixel_angle);
+            ensure(llformat("area %u", i), fabsf(areas[i] - expected) <= expected * 1.e-5f);
+        }
+
+        std::vector<U32> visible(LLAABBBatch::getMaskSize(count));
+        std::vector<U32> inside(LLAABBBatch::getMaskSize(count));
+        camera.AABBInFrustumBatch(batch, visible.data(), inside.data());
+        std::fill(areas.begin(), areas.end(), -1.f);
+        camera.calcPixelAreaBatch(batch, pixel_angle, areas.data(), visible.data());
+        for (U32 i = 0; i < count; ++i)
+        {
+            bool is_visible = LLAABBBatch::getResult(visible.data(), inside.data(), i) != 0;
+            ensure_equals(llformat("only visible %u", i), areas[i] >= 0.f, is_visible);
+        }
+
+        batch.clear();
+        ensure_equals("cleared", batch.getCount(), 0U);
+        ensure_equals("empty batch", camera.AABBInFrustumBatch(batch, visible.data(), inside.data()), 0U);
+    }
+
+    // Throughput of the batched test against one box at a time
+    template<> template<>
+    void llcamera_object::test<3>()
+    {
+        const U32 BOXES = 100000;
+        const U32 PASSES = 20;
+
+        LLAABBBatch batch;
+        std::vector<LLVector4a> boxes;
+        make_boxes(batch, boxes, BOXES, 3);
+
+        LLCamera camera;
+        make_camera(camera, LLVector3(0.f, 0.f, 20.f), LLVector3(0.6f, 0.8f, 0.f), 256.f);
+
+        std::vector<U32> visible(LLAABBBatch::getMaskSize(BOXES));
+        std::vector<U32> inside(LLAABBBatch::getMaskSize(BOXES));
+        std::vector<F32> areas(BOXES);
+        U32 batch_visible = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (U32 pass = 0; pass < PASSES; ++pass)
+        {
+            batch_visible += camera.AABBInFrustumBatch(batch, visible.data(), inside.data());
+        }
+        auto batch_time = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (U32 pass = 0; pass < PASSES; ++pass)
+        {
+            camera.calcPixelAreaBatch(batch, 1024.f, areas.data(), visible.data());
+        }
+        auto area_time = std::chrono::steady_clock::now() - start;
+
+        U32 scalar_visible = 0;
+        start = std::chrono::steady_clock::now();
+        for (U32 pass = 0; pass < PASSES; ++pass)
+        {
+            for (U32 i = 0; i < BOXES; ++i)
+            {
+                scalar_visible += camera.AABBInFrustum(boxes[i * 2], boxes[i * 2 + 1]) != 0;
+            }
+        }
+        auto scalar_time = std::chrono::steady_clock::now() - start;
+
+        ensure_equals("same boxes visible", batch_visible, scalar_visible);
+
+        auto boxes_per_us = [](std::chrono::steady_clock::duration time)
+        {
+            return (F64)(BOXES * PASSES) / llmax((F64)std::chrono::duration_cast<std::chrono::microseconds>(time).count(), 1.0);
+        };
+        LL_INFOS() << BOXES << " boxes x " << PASSES << " passes, " << batch_visible / PASSES << " visible: batched "
+                   << boxes_per_us(batch_time) << " boxes/us, one at a time "
+                   << boxes_per_us(scalar_time) << " boxes/us, pixel areas "
+                   << boxes_per_us(area_time) << " boxes/us" << LL_ENDL;
+    }
+}
@@ -0,0 +1,324 @@
+/**
+ * @file   lllinearoctree_test.cpp
+ * @brief  Test for the flat octree in lllinearoctree.h.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../test/lltut.h"
+
+#include "../llcamera.h"
+#include "../lllinearoctree.h"
+
+#include <map>
+#include <random>
+
+namespace
+{
+    struct Box
+    {
+        LLVector4a mExtents[2];
+        LLVector4a mPosition;
+        F32 mRadius;
+
+        void set(const LLVector4a& center, F32 size)
+        {
+            LLVector4a half;
+            half.splat(size * 0.5f);
+            mExtents[0].setSub(center, half);
+            mExtents[1].setAdd(center, half);
+            mPosition = center;
+            mRadius = half.getLength3().getF32();
+        }
+
+        const LLVector4a* getSpatialExtents() const { return mExtents; }
+        const LLVector4a& getPositionGroup() const  { return mPosition; }
+        F32 getBinRadius() const                    { return mRadius; }
+    };
+
+    typedef LLLinearOctree<Box, Box*> tree_t;
+
+    // Boxes of mixed size scattered over a region, a few of them huge
+    void make_boxes(std::vector<Box>& boxes, U32 count, U32 seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<F32> coord(0.f, 256.f);
+        std::uniform_real_distribution<F32> size(0.1f, 4.f);
+
+        boxes.resize(count);
+        for (U32 i = 0; i < count; ++i)
+        {
+            F32 s = (i % 100 == 0) ? size(gen) * 32.f : size(gen);
+            boxes[i].set(LLVector4a(coord(gen), coord(gen), coord(gen) * 0.25f), s);
+        }
+    }
+
+    // Camera at origin looking along at, with the corners of its frustum
+    // worked out the way LLViewerCamera does
+    void make_camera(LLCamera& camera, const LLVector3& origin, const LLVector3& at, F32 far_clip)
+    {
+        camera.setNear(0.5f);
+        camera.setFar(far_clip);
+        camera.setView(1.f);
+        camera.setAspect(1.5f);
+        LLVector3 up = fabsf(at.mV[VZ]) > 0.9f ? LLVector3(1.f, 0.f, 0.f) : LLVector3(0.f, 0.f, 1.f);
+        camera.lookAt(origin, origin + at, up);
+
+        F32 h = tanf(camera.getView() * 0.5f);
+        F32 w = h * camera.getAspect();
+        const F32 dist[] = { camera.getNear(), camera.getFar() };
+        LLVector3 frust[LLCamera::AGENT_FRUSTRUM_NUM];
+        for (U32 i = 0; i < 2; ++i)
+        {
+            F32 d = dist[i];
+            frust[i * 4 + 0] = camera.getOrigin() + (camera.getAtAxis() + camera.getLeftAxis() * w - camera.getUpAxis() * h) * d;
+            frust[i * 4 + 1] = camera.getOrigin() + (camera.getAtAxis() - camera.getLeftAxis() * w - camera.getUpAxis() * h) * d;
+            frust[i * 4 + 2] = camera.getOrigin() + (camera.getAtAxis() - camera.getLeftAxis() * w + camera.getUpAxis() * h) * d;
+            frust[i * 4 + 3] = camera.getOrigin() + (camera.getAtAxis() + camera.getLeftAxis() * w + camera.getUpAxis() * h) * d;
+        }
+        camera.calcAgentFrustumPlanes(frust);
+    }
+
+    tree_t::Frustum make_frustum(LLCamera& camera)
+    {
+        tree_t::Frustum frustum;
+        for (U32 i = 0; i < LLCamera::AGENT_PLANE_NO_USER_CLIP_NUM; ++i)
+        {
+            frustum.addPlane(camera.getAgentPlane(i));
+        }
+        return frustum;
+    }
+
+    // Culls through the tree and checks each box against LLCamera
+    U32 check_cull(const tree_t& tree, LLCamera& camera, const std::vector<Box>& boxes, const std::string& msg)
+    {
+        std::map<const Box*, U32> visited;
+        tree.cull(make_frustum(camera), [&visited](Box* box) { ++visited[box]; });
+
+        U32 visible = 0;
+        for (const Box& box : boxes)
+        {
+            LLVector4a center, size;
+            center.setAdd(box.mExtents[0], box.mExtents[1]);
+            center.mul(0.5f);
+            size.setSub(box.mExtents[1], box.mExtents[0]);
+            size.mul(0.5f);
+            bool expected = camera.AABBInFrustum(center, size) != 0;
+            visible += expected;
+
+            auto it = visited.find(&box);
+            U32 count = (it == visited.end()) ? 0 : it->second;
+            tut::ensure_equals(msg + " visited", count, (U32)expected);
+        }
+        tut::ensure_equals(msg + " nothing else", (U32)visited.size(), visible);
+        return visible;
+    }
+
+    // Checks that the elements of every node are inside its bounds
+    class BoundsCheck : public LLLinearOctreeTraveler<Box, Box*>
+    {
+    public:
+        BoundsCheck() : mElements(0), mNodes(0) { }
+
+        void visit(const node_t& node) override
+        {
+            ++mNodes;
+            mElements += node.getElementCount();
+
+            // Bounds go through center and size, allow for rounding
+            LLVector4a size, slop;
+            slop.splat(0.001f);
+            size.setAdd(node.getSize(), slop);
+            LLVector4a min, max;
+            min.setSub(node.getCenter(), size);
+            max.setAdd(node.getCenter(), size);
+            for (node_t::const_element_iter it = node.getDataBegin(); it != node.getDataEnd(); ++it)
+            {
+                const LLVector4a* exts = (*it)->getSpatialExtents();
+                tut::ensure("element inside node", exts[0].greaterEqual(min).areAllSet(LLVector4Logical::MASK_XYZ) &&
+                                                   exts[1].lessEqual(max).areAllSet(LLVector4Logical::MASK_XYZ));
+            }
+            for (U32 i = 0; i < node.getChildCount(); ++i)
+            {
+                node_t child = node.getChild(i);
+                tut::ensure_equals("child depth", child.getDepth(), node.getDepth() + 1);
+            }
+        }
+
+        U32 mElements;
+        U32 mNodes;
+    };
+}
+
+namespace tut
+{
+    struct lllinearoctree_data
+    {
+    };
+    typedef test_group<lllinearoctree_data> lllinearoctree_test;
+    typedef lllinearoctree_test::object lllinearoctree_object;
+    tut::lllinearoctree_test tut_lllinearoctree_test("LLLinearOctree");
+
+    // Culling matches LLCamera::AABBInFrustum() box by box
+    template<> template<>
+    void lllinearoctree_object::test<1>()
+    {
+        std::vector<Box> boxes;
+        make_boxes(boxes, 20000, 1234);
+
+        tree_t tree(32);
+        for (Box& box : boxes)
+        {
+            tree.insert(&box);
+        }
+        ensure_equals("queued until update", tree.getElementCount(), 0U);
+        tree.update();
+        ensure_equals("element count", tree.getElementCount(), (U32)boxes.size());
+        ensure("split into nodes", tree.getNodeCount() > 1);
+
+        BoundsCheck check;
+        tree.accept(&check);
+        ensure_equals("traveler sees every element", check.mElements, (U32)boxes.size());
+        ensure_equals("traveler sees every node", check.mNodes, tree.getNodeCount());
+
+        std::mt19937 gen(99);
+        std::uniform_real_distribution<F32> coord(-1.f, 1.f);
+        U32 visible = 0;
+        for (U32 i = 0; i < 16; ++i)
+        {
+            LLVector3 origin(128.f + coord(gen) * 160.f, 128.f + coord(gen) * 160.f, 32.f + coord(gen) * 40.f);
+            LLVector3 at(coord(gen), coord(gen), coord(gen) * 0.5f);
+            if (at.normVec() < 0.01f)
+            {
+                at.setVec(1.f, 0.f, 0.f);
+            }
+            LLCamera camera;
+            make_camera(camera, origin, at, (i & 1) ? 512.f : 64.f);
+            visible += check_cull(tree, camera, boxes, llformat("camera %u", i));
+        }
+        ensure("some boxes visible", visible > 0);
+    }
+
+    // Batched changes, moves and growing the root
+    template<> template<>
+    void lllinearoctree_object::test<2>()
+    {
+        std::vector<Box> boxes;
+        make_boxes(boxes, 4000, 42);
+
+        tree_t tree(8);
+        tree.update();
+        ensure_equals("empty", tree.getElementCount(), 0U);
+        ensure_equals("empty root", tree.getRoot().getElementCount(), 0U);
+
+        for (U32 i = 0; i < 2000; ++i)
+        {
+            tree.insert(&boxes[i]);
+        }
+        tree.update();
+
+        // Removed, inserted and removed again, inserted twice, moved far
+        // outside the root
+        for (U32 i = 0; i < 2000; i += 2)
+        {
+            tree.remove(&boxes[i]);
+        }
+        for (U32 i = 2000; i < 4000; ++i)
+        {
+            tree.insert(&boxes[i]);
+            if (i % 3 == 0)
+            {
+                tree.remove(&boxes[i]);
+            }
+            else if (i % 3 == 1)
+            {
+                tree.insert(&boxes[i]);
+            }
+        }
+        boxes[1].set(LLVector4a(5000.f, -3000.f, 200.f), 2.f);
+        tree.insert(&boxes[1]);
+        ensure("pending", tree.hasPendingChanges());
+        tree.update();
+        ensure("applied", !tree.hasPendingChanges());
+
+        std::vector<Box*> expected;
+        for (U32 i = 0; i < 4000; ++i)
+        {
+            bool in = (i < 2000) ? (i & 1) : (i % 3 != 0);
+            if (in)
+            {
+                expected.push_back(&boxes[i]);
+            }
+        }
+
+        std::vector<Box*> found;
+        tree.cull(tree_t::Frustum(), [&found](Box* box) { found.push_back(box); });
+        std::sort(found.begin(), found.end());
+        ensure("no frustum keeps everything once", found == expected);
+
+        BoundsCheck check;
+        tree.accept(&check);
+        ensure_equals("traveler after changes", check.mElements, (U32)expected.size());
+
+        LLCamera camera;
+        make_camera(camera, LLVector3(5000.f, -3000.f, 220.f), LLVector3(0.f, 0.f, -1.f), 64.f);
+        std::vector<Box*> moved;
+        tree.cull(make_frustum(camera), [&moved](Box* box) { moved.push_back(box); });
+        ensure("moved box found at its new place", moved.size() == 1 && moved[0] == &boxes[1]);
+
+        for (Box* box : expected)
+        {
+            tree.remove(box);
+        }
+        tree.update();
+        ensure_equals("all removed", tree.getElementCount(), 0U);
+    }
+
+    // Stacked boxes can't be split, they end up together at the deepest level
+    template<> template<>
+    void lllinearoctree_object::test<3>()
+    {
+        std::vector<Box> boxes(100);
+        for (Box& box : boxes)
+        {
+            box.set(LLVector4a(10.f, 10.f, 10.f), 0.01f);
+        }
+        boxes[0].set(LLVector4a(100.f, 100.f, 100.f), 0.01f);
+
+        tree_t tree(4);
+        for (Box& box : boxes)
+        {
+            tree.insert(&box);
+        }
+        tree.update();
+
+        BoundsCheck check;
+        tree.accept(&check);
+        ensure_equals("stacked elements", check.mElements, 100U);
+
+        LLCamera camera;
+        make_camera(camera, LLVector3(10.f, 10.f, 20.f), LLVector3(0.f, 0.f, -1.f), 32.f);
+        ensure_equals("stacked visible", check_cull(tree, camera, boxes, "stacked"), 99U);
+    }
+}
@@ -0,0 +1,334 @@
+/**
+ * @file   llvector4abatch_test.cpp
+ * @brief  Test for the array helpers in llvector4abatch.h.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../test/lltut.h"
+
+#include "../llvector4abatch.h"
+
+#include <chrono>
+#include <cstring>
+#include <random>
+
+namespace
+{
+    void make_vectors(std::vector<LLVector4a>& v, U32 count, F32 range, U32 seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<F32> coord(-range, range);
+        v.resize(count);
+        for (LLVector4a& p : v)
+        {
+            p.set(coord(gen), coord(gen), coord(gen), coord(gen));
+        }
+    }
+
+    // Rotation, scale and translation, rows as LLMatrix4 keeps them
+    LLMatrix4a make_matrix(U32 seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<F32> coord(-2.f, 2.f);
+        LLMatrix4 mat;
+        for (U32 row = 0; row < 4; ++row)
+        {
+            for (U32 col = 0; col < 3; ++col)
+            {
+                mat.mMatrix[row][col] = (row == 3) ? coord(gen) * 50.f : coord(gen);
+            }
+        }
+        return LLMatrix4a(mat);
+    }
+
+    // Row vector times matrix in doubles, the way LLVector3 * LLMatrix4 goes
+    LLVector3 transform_scalar(const LLMatrix4a& mat, const LLVector4a& v, F64 w)
+    {
+        const F32* m = mat.getF32ptr();
+        const F32* p = v.getF32ptr();
+        LLVector3 res;
+        for (U32 col = 0; col < 3; ++col)
+        {
+            F64 sum = (F64)p[0] * m[col] + (F64)p[1] * m[4 + col] + (F64)p[2] * m[8 + col] + w * m[12 + col];
+            res.mV[col] = (F32)sum;
+        }
+        return res;
+    }
+
+    bool same_bits(const LLVector4a& a, const LLVector4a& b)
+    {
+        return memcmp(a.getF32ptr(), b.getF32ptr(), sizeof(F32) * 4) == 0;
+    }
+
+    bool close3(const LLVector4a& a, const LLVector3& b, F32 tolerance)
+    {
+        for (U32 i = 0; i < 3; ++i)
+        {
+            F32 diff = fabsf(a[i] - b.mV[i]);
+            if (diff > tolerance * llmax(1.f, fabsf(b.mV[i])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Joint palette and weights the way LLSkinningUtil packs them, joint
+    // index in the integer part, weight in the fraction
+    void make_skin(std::vector<LLMatrix4a>& palette, std::vector<LLVector4a>& weights, U32 joints, U32 count)
+    {
+        palette.resize(joints);
+        for (U32 j = 0; j < joints; ++j)
+        {
+            palette[j] = make_matrix(100 + j);
+        }
+
+        std::mt19937 gen(5);
+        std::uniform_int_distribution<U32> joint(0, joints - 1);
+        std::uniform_real_distribution<F32> weight(0.05f, 0.95f);
+        weights.resize(count);
+        for (LLVector4a& w : weights)
+        {
+            w.set(joint(gen) + weight(gen), joint(gen) + weight(gen), joint(gen) + weight(gen), joint(gen) + weight(gen));
+        }
+    }
+
+    // LLSkinningUtil::getPerVertexSkinMatrixUnchecked() without the clamps
+    void skin_matrix(const LLVector4a& packed, const LLMatrix4a* palette, LLMatrix4a& final_mat)
+    {
+        const F32* p = packed.getF32ptr();
+        S32 idx[4];
+        F32 w[4];
+        F32 scale = 0.f;
+        for (U32 k = 0; k < 4; ++k)
+        {
+            idx[k] = (S32)p[k];
+            w[k] = p[k] - idx[k];
+            scale += w[k];
+        }
+        final_mat.setMul(palette[idx[0]], w[0] / scale);
+        final_mat.setMulAdd(palette[idx[1]], LLVector4a(w[1] / scale));
+        final_mat.setMulAdd(palette[idx[2]], LLVector4a(w[2] / scale));
+        final_mat.setMulAdd(palette[idx[3]], LLVector4a(w[3] / scale));
+    }
+
+    F64 per_us(U32 count, std::chrono::steady_clock::duration time)
+    {
+        return (F64)count / llmax((F64)std::chrono::duration_cast<std::chrono::microseconds>(time).count(), 1.0);
+    }
+}
+
+namespace tut
+{
+    struct llvector4abatch_data
+    {
+    };
+    typedef test_group<llvector4abatch_data> llvector4abatch_test;
+    typedef llvector4abatch_test::object llvector4abatch_object;
+    tut::llvector4abatch_test tut_llvector4abatch_test("LLVector4aBatch");
+
+    // Transforms match LLMatrix4a bit for bit and the scalar math within
+    // rounding, for every tail length and in place
+    template<> template<>
+    void llvector4abatch_object::test<1>()
+    {
+        std::vector<LLVector4a> src;
+        make_vectors(src, 1037, 100.f, 1);
+        const LLMatrix4a mat = make_matrix(2);
+
+        std::vector<LLVector4a> dst(src.size());
+        for (U32 count = 0; count < 12; ++count)
+        {
+            // Odd starts put pairs on 16 but not 32 byte boundaries
+            for (U32 start = 0; start < 2; ++start)
+            {
+                std::fill(dst.begin(), dst.end(), LLVector4a(-1.f));
+                LLVector4aBatch::affineTransform(mat, src.data() + start, dst.data(), count);
+                for (U32 i = 0; i < count; ++i)
+                {
+                    LLVector4a expected;
+                    mat.affineTransform(src[start + i], expected);
+                    ensure(llformat("affine %u of %u", i, count), same_bits(dst[i], expected));
+                }
+                ensure("affine writes count vectors", same_bits(dst[count], LLVector4a(-1.f)));
+
+                LLVector4aBatch::rotate(mat, src.data() + start, dst.data(), count);
+                for (U32 i = 0; i < count; ++i)
+                {
+                    LLVector4a expected;
+                    mat.rotate(src[start + i], expected);
+                    ensure(llformat("rotate %u of %u", i, count), same_bits(dst[i], expected));
+                }
+            }
+        }
+
+        std::vector<LLVector4a> in_place = src;
+        LLVector4aBatch::affineTransform(mat, in_place.data(), in_place.data(), (U32)in_place.size());
+        LLVector4aBatch::rotate(mat, src.data(), dst.data(), (U32)src.size());
+        for (U32 i = 0; i < src.size(); ++i)
+        {
+            ensure(llformat("affine scalar %u", i), close3(in_place[i], transform_scalar(mat, src[i], 1.0), 1.e-5f));
+            ensure(llformat("rotate scalar %u", i), close3(dst[i], transform_scalar(mat, src[i], 0.0), 1.e-5f));
+        }
+    }
+
+    // Normalization within rsqrt precision, bounds exact
+    template<> template<>
+    void llvector4abatch_object::test<2>()
+    {
+        std::vector<LLVector4a> src;
+        make_vectors(src, 515, 10.f, 3);
+        src[7].set(1.e-3f, 0.f, 0.f, 1.f);
+        src[8].set(0.f, 5000.f, 0.f, 0.f);
+
+        for (U32 count = 1; count < src.size(); count += (count < 8) ? 1 : 101)
+        {
+            std::vector<LLVector4a> v(src.begin(), src.begin() + count);
+            LLVector4aBatch::normalize3fast(v.data(), count);
+            for (U32 i = 0; i < count; ++i)
+            {
+                LLVector4a expected = src[i];
+                expected.normalize3fast();
+                ensure(llformat("normalize %u of %u", i, count), v[i].equals4(expected, 1.e-5f));
+
+                LLVector3 scalar(src[i].getF32ptr());
+                scalar.normVec();
+                ensure(llformat("normalize scalar %u", i), close3(v[i], scalar, 1.e-3f));
+            }
+
+            LLVector4a min, max;
+            LLVector4aBatch::getMinMax(src.data(), count, min, max);
+            for (U32 k = 0; k < 4; ++k)
+            {
+                F32 expected_min = src[0][k];
+                F32 expected_max = src[0][k];
+                for (U32 i = 1; i < count; ++i)
+                {
+                    expected_min = llmin(expected_min, src[i][k]);
+                    expected_max = llmax(expected_max, src[i][k]);
+                }
+                ensure_equals(llformat("min %u of %u", k, count), min[k], expected_min);
+                ensure_equals(llformat("max %u of %u", k, count), max[k], expected_max);
+            }
+        }
+
+        LLVector4a min(-1000.f), max(1000.f);
+        LLVector4aBatch::updateMinMax(src.data(), 0, min, max);
+        LLVector4aBatch::updateMinMax(src.data(), (U32)src.size(), min, max);
+        ensure("update keeps wider bounds", min.equals4(LLVector4a(-1000.f)) && max[1] == 5000.f);
+    }
+
+    // Throughput on the loops of LLVOVolume::updateRiggedVolume() and
+    // LLFace::getGeometryVolume(), one vertex at a time and batched
+    template<> template<>
+    void llvector4abatch_object::test<3>()
+    {
+        // A large face, small enough to stay in cache between passes
+        const U32 VERTICES = 8192;
+        const U32 PASSES = 200;
+
+        std::vector<LLVector4a> positions, normals;
+        make_vectors(positions, VERTICES, 2.f, 7);
+        make_vectors(normals, VERTICES, 1.f, 8);
+        std::vector<LLMatrix4a> palette;
+        std::vector<LLVector4a> weights;
+        make_skin(palette, weights, 32, VERTICES);
+        const LLMatrix4a bind_shape = make_matrix(9);
+        const LLMatrix4a mat_vert = make_matrix(10);
+        const LLMatrix4a mat_normal = make_matrix(11);
+
+        std::vector<LLVector4a> skinned(VERTICES), skinned_batch(VERTICES);
+        std::vector<LLVector4a> out_pos(VERTICES), out_norm(VERTICES);
+        std::vector<LLVector4a> out_pos_batch(VERTICES), out_norm_batch(VERTICES);
+        LLVector4a extents[2], extents_batch[2];
+
+        auto start = std::chrono::steady_clock::now();
+        for (U32 pass = 0; pass < PASSES; ++pass)
+        {
+            for (U32 i = 0; i < VERTICES; ++i)
+            {
+                LLMatrix4a final_mat;
+                skin_matrix(weights[i], palette.data(), final_mat);
+                LLVector4a t;
+                bind_shape.affineTransform(positions[i], t);
+                final_mat.affineTransform(t, skinned[i]);
+            }
+            extents[0] = skinned[0];
+            extents[1] = skinned[0];
+            for (U32 i = 1; i < VERTICES; ++i)
+            {
+                extents[0].setMin(extents[0], skinned[i]);
+                extents[1].setMax(extents[1], skinned[i]);
+            }
+        }
+        auto skin_time = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (U32 pass = 0; pass < PASSES; ++pass)
+        {
+            LLVector4aBatch::affineTransform(bind_shape, positions.data(), skinned_batch.data(), VERTICES);
+            for (U32 i = 0; i < VERTICES; ++i)
+            {
+                LLMatrix4a final_mat;
+                skin_matrix(weights[i], palette.data(), final_mat);
+                final_mat.affineTransform(skinned_batch[i], skinned_batch[i]);
+            }
+            LLVector4aBatch::getMinMax(skinned_batch.data(), VERTICES, extents_batch[0], extents_batch[1]);
+        }
+        auto skin_batch_time = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (U32 pass = 0; pass < PASSES; ++pass)
+        {
+            for (U32 i = 0; i < VERTICES; ++i)
+            {
+                mat_vert.affineTransform(positions[i], out_pos[i]);
+                mat_normal.rotate(normals[i], out_norm[i]);
+            }
+        }
+        auto face_time = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (U32 pass = 0; pass < PASSES; ++pass)
+        {
+            LLVector4aBatch::affineTransform(mat_vert, positions.data(), out_pos_batch.data(), VERTICES);
+            LLVector4aBatch::rotate(mat_normal, normals.data(), out_norm_batch.data(), VERTICES);
+        }
+        auto face_batch_time = std::chrono::steady_clock::now() - start;
+
+        for (U32 i = 0; i < VERTICES; ++i)
+        {
+            ensure(llformat("skinned %u", i), same_bits(skinned[i], skinned_batch[i]));
+            ensure(llformat("face position %u", i), same_bits(out_pos[i], out_pos_batch[i]));
+            ensure(llformat("face normal %u", i), same_bits(out_norm[i], out_norm_batch[i]));
+        }
+        ensure("skinned extents", same_bits(extents[0], extents_batch[0]) && same_bits(extents[1], extents_batch[1]));
+
+        const U32 total = VERTICES * PASSES;
+        LL_INFOS() << LLVector4aBatch::getBackendName() << ", " << VERTICES << " vertices x " << PASSES << " passes: skinning "
+                   << per_us(total, skin_time) << " -> " << per_us(total, skin_batch_time) << " vertices/us, face geometry "
+                   << per_us(total, face_time) << " -> " << per_us(total, face_batch_time) << " vertices/us" << LL_ENDL;
+    }
+}
@@ -0,0 +1,628 @@
+/**
+ * @file   llvolume_test.cpp
+ * @brief  Test for mesh LOD unpacking in llvolume.cpp.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../test/lltut.h"
+
+#include "../llvolume.h"
+#include "llsdserialize.h"
+#include "llsdutil.h"
+#include "llsdutil_math.h"
+
+namespace
+{
+    // Quantized values, the way the uploader writes them
+    LLSD::Binary make_u16s(U32 count, U32 seed)
+    {
+        LLSD::Binary binary(count * 2);
+        for (U32 i = 0; i < count; ++i)
+        {
+            U16 value = (U16)((i + 1) * 2654435761u * (seed + 1) >> 16);
+            memcpy(&binary[i * 2], &value, 2);
+        }
+        return binary;
+    }
+
+    LLSD make_face(U32 num_verts, U32 seed, bool normals, bool tex_coords, bool weights)
+    {
+        LLSD face;
+        face["Position"] = make_u16s(num_verts * 3, seed);
+        if (normals)
+        {
+            face["Normal"] = make_u16s(num_verts * 3, seed + 1);
+        }
+        if (tex_coords)
+        {
+            face["TexCoord0"] = make_u16s(num_verts * 2, seed + 2);
+            face["TexCoord0Domain"]["Min"] = ll_sd_from_vector2(LLVector2(-0.5f, 0.25f));
+            face["TexCoord0Domain"]["Max"] = ll_sd_from_vector2(LLVector2(2.f, 1.75f));
+        }
+        face["PositionDomain"]["Min"] = ll_sd_from_vector3(LLVector3(-1.5f, -0.5f, -0.25f));
+        face["PositionDomain"]["Max"] = ll_sd_from_vector3(LLVector3(0.5f, 1.5f, 0.75f));
+        face["NormalizedScale"] = ll_sd_from_vector3(LLVector3(2.f, 3.f, 4.f));
+
+        LLSD::Binary indices;
+        for (U32 i = 0; i + 2 < num_verts; ++i)
+        {
+            U16 triangle[3] = { (U16)i, (U16)(i + 1), (U16)(i + 2) };
+            indices.insert(indices.end(), (U8*)triangle, (U8*)(triangle + 3));
+        }
+        face["TriangleList"] = indices;
+
+        if (weights)
+        {
+            LLSD::Binary influences;
+            for (U32 i = 0; i < num_verts; ++i)
+            {
+                U32 count = i % 5;
+                for (U32 j = 0; j < count; ++j)
+                {
+                    U16 weight = (U16)(65535 / (j + 1));
+                    influences.push_back((U8)(i + j));
+                    influences.push_back((U8)(weight & 0xFF));
+                    influences.push_back((U8)(weight >> 8));
+                }
+                if (count < 4)
+                {
+                    influences.push_back(0xFF);
+                }
+            }
+            face["Weights"] = influences;
+        }
+        return face;
+    }
+
+    LLSD make_lod()
+    {
+        LLSD lod = LLSD::emptyArray();
+        lod.append(make_face(7, 1, true, true, true));
+        lod.append(make_face(4, 5, false, false, false));
+        LLSD no_geometry;
+        no_geometry["NoGeometry"] = true;
+        lod.append(no_geometry);
+        lod.append(make_face(32, 9, true, true, false));
+        return lod;
+    }
+
+    LLPointer<LLVolume> make_volume(U8 sculpt_flags)
+    {
+        LLVolumeParams params;
+        params.setType(LL_PCODE_PROFILE_SQUARE, LL_PCODE_PATH_LINE);
+        params.setSculptID(LLUUID::generateNewID(), LL_SCULPT_TYPE_MESH | sculpt_flags);
+        return new LLVolume(params, 1.f);
+    }
+
+    // Copy of LLVolume::unpackVolumeFacesInternal() from before the binary
+    // reader and the SSE2 dequantization went in, the reference both paths
+    // have to match bit for bit. Keep it as it is.
+    bool baseline_unpack(LLVolume* volume, const LLSD& mdl)
+    {
+        U32 face_count = mdl.size();
+        if (face_count == 0)
+        {
+            return false;
+        }
+
+        LLVolume::face_list_t& faces = volume->getVolumeFaces();
+        faces.resize(face_count);
+
+        for (size_t i = 0; i < face_count; ++i)
+        {
+            LLVolumeFace& face = faces[i];
+            const LLSD& mdl_face = mdl[i];
+
+            if (mdl_face.has("NoGeometry"))
+            {
+                face.resizeIndices(3);
+                face.resizeVertices(1);
+                face.mPositions->clear();
+                face.mNormals->clear();
+                face.mTexCoords->setZero();
+                memset(face.mIndices, 0, sizeof(U16) * 3);
+                continue;
+            }
+
+            const LLSD::Binary& pos = mdl_face["Position"].asBinary();
+            const LLSD::Binary& norm = mdl_face["Normal"].asBinary();
+            const LLSD::Binary& tc = mdl_face["TexCoord0"].asBinary();
+            const LLSD::Binary& idx = mdl_face["TriangleList"].asBinary();
+
+            S32 num_indices = idx.size() / 2;
+            num_indices -= num_indices % 3;
+            face.resizeIndices(num_indices);
+            if (idx.empty() || face.mNumIndices < 3)
+            {
+                continue;
+            }
+
+            U16* indices = (U16*)&(idx[0]);
+            for (S32 j = 0; j < num_indices; ++j)
+            {
+                face.mIndices[j] = indices[j];
+            }
+
+            U32 num_verts = pos.size() / (3 * 2);
+            face.resizeVertices(num_verts);
+
+            LLVector3 minp;
+            LLVector3 maxp;
+            LLVector2 min_tc;
+            LLVector2 max_tc;
+
+            minp.setValue(mdl_face["PositionDomain"]["Min"]);
+            maxp.setValue(mdl_face["PositionDomain"]["Max"]);
+            LLVector4a min_pos, max_pos;
+            min_pos.load3(minp.mV);
+            max_pos.load3(maxp.mV);
+
+            min_tc.setValue(mdl_face["TexCoord0Domain"]["Min"]);
+            max_tc.setValue(mdl_face["TexCoord0Domain"]["Max"]);
+
+            if (mdl_face.has("NormalizedScale"))
+            {
+                face.mNormalizedScale.setValue(mdl_face["NormalizedScale"]);
+            }
+            else
+            {
+                face.mNormalizedScale.set(1, 1, 1);
+            }
+
+            LLVector4a pos_range;
+            pos_range.setSub(max_pos, min_pos);
+            LLVector2 tc_range2 = max_tc - min_tc;
+
+            LLVector4a tc_range;
+            tc_range.set(tc_range2[0], tc_range2[1], tc_range2[0], tc_range2[1]);
+            LLVector4a min_tc4(min_tc[0], min_tc[1], min_tc[0], min_tc[1]);
+
+            LLVector4a* pos_out = face.mPositions;
+            LLVector4a* norm_out = face.mNormals;
+            LLVector4a* tc_out = (LLVector4a*)face.mTexCoords;
+
+            U16* v = (U16*)&(pos[0]);
+            for (U32 j = 0; j < num_verts; ++j)
+            {
+                pos_out->set((F32)v[0], (F32)v[1], (F32)v[2]);
+                pos_out->div(65535.f);
+                pos_out->mul(pos_range);
+                pos_out->add(min_pos);
+                pos_out++;
+                v += 3;
+            }
+
+            if (!norm.empty())
+            {
+                U16* n = (U16*)&(norm[0]);
+                for (U32 j = 0; j < num_verts; ++j)
+                {
+                    norm_out->set((F32)n[0], (F32)n[1], (F32)n[2]);
+                    norm_out->div(65535.f);
+                    norm_out->mul(2.f);
+                    norm_out->sub(1.f);
+                    norm_out++;
+                    n += 3;
+                }
+            }
+            else
+            {
+                for (U32 j = 0; j < num_verts; ++j)
+                {
+                    norm_out->clear();
+                    norm_out++;
+                }
+            }
+
+            if (!tc.empty())
+            {
+                U16* t = (U16*)&(tc[0]);
+                for (U32 j = 0; j < num_verts; j += 2)
+                {
+                    if (j < num_verts - 1)
+                    {
+                        tc_out->set((F32)t[0], (F32)t[1], (F32)t[2], (F32)t[3]);
+                    }
+                    else
+                    {
+                        tc_out->set((F32)t[0], (F32)t[1], 0.f, 0.f);
+                    }
+
+                    t += 4;
+
+                    tc_out->div(65535.f);
+                    tc_out->mul(tc_range);
+                    tc_out->add(min_tc4);
+
+                    tc_out++;
+                }
+            }
+            else
+            {
+                for (U32 j = 0; j < num_verts; j += 2)
+                {
+                    tc_out->clear();
+                    tc_out++;
+                }
+            }
+
+            if (mdl_face.has("Weights"))
+            {
+                face.allocateWeights(num_verts);
+
+                const LLSD::Binary& weights = mdl_face["Weights"].asBinary();
+
+                U32 idx = 0;
+                U32 cur_vertex = 0;
+                size_t weight_size = weights.size();
+                while (idx < weight_size && cur_vertex < num_verts)
+                {
+                    const U8 END_INFLUENCES = 0xFF;
+                    U8 joint = weights[idx++];
+
+                    U32 cur_influence = 0;
+                    LLVector4 wght(0, 0, 0, 0);
+                    U32 joints[4] = { 0, 0, 0, 0 };
+                    LLVector4 joints_with_weights(0, 0, 0, 0);
+
+                    while (joint != END_INFLUENCES && idx < weight_size)
+                    {
+                        U16 influence = weights[idx++];
+                        influence |= ((U16)weights[idx++] << 8);
+
+                        F32 w = llclamp((F32)influence / 65535.f, 0.001f, 0.999f);
+                        wght.mV[cur_influence] = w;
+                        joints[cur_influence] = joint;
+                        cur_influence++;
+
+                        if (cur_influence >= 4)
+                        {
+                            joint = END_INFLUENCES;
+                        }
+                        else
+                        {
+                            joint = weights[idx++];
+                        }
+                    }
+                    F32 wsum = wght.mV[VX] + wght.mV[VY] + wght.mV[VZ] + wght.mV[VW];
+                    if (wsum <= 0.f)
+                    {
+                        wght = LLVector4(0.999f, 0.f, 0.f, 0.f);
+                    }
+                    for (U32 k = 0; k < 4; k++)
+                    {
+                        joints_with_weights[k] = (F32)joints[k] + wght[k];
+                    }
+                    face.mWeights[cur_vertex].loadua(joints_with_weights.mV);
+
+                    cur_vertex++;
+                }
+            }
+
+            bool do_mirror = (volume->getParams().getSculptType() & LL_SCULPT_FLAG_MIRROR);
+            bool do_invert = (volume->getParams().getSculptType() & LL_SCULPT_FLAG_INVERT);
+
+            bool do_reflect_x = false;
+            bool do_reverse_triangles = false;
+            bool do_invert_normals = false;
+
+            if (do_mirror)
+            {
+                do_reflect_x = true;
+                do_reverse_triangles = !do_reverse_triangles;
+            }
+
+            if (do_invert)
+            {
+                do_invert_normals = true;
+                do_reverse_triangles = !do_reverse_triangles;
+            }
+
+            if (do_reflect_x)
+            {
+                for (S32 j = 0; j < face.mNumVertices; j++)
+                {
+                    face.mPositions[j].mul(-1.0f);
+                    face.mNormals[j].mul(-1.0f);
+                }
+            }
+
+            if (do_invert_normals)
+            {
+                for (S32 j = 0; j < face.mNumVertices; j++)
+                {
+                    face.mNormals[j].mul(-1.0f);
+                }
+            }
+
+            if (do_reverse_triangles)
+            {
+                for (S32 j = 0; j < face.mNumIndices; j += 3)
+                {
+                    S32 swap = face.mIndices[j + 1];
+                    face.mIndices[j + 1] = face.mIndices[j + 2];
+                    face.mIndices[j + 2] = swap;
+                }
+            }
+
+            LLVector4a& min = face.mExtents[0];
+            LLVector4a& max = face.mExtents[1];
+
+            if (face.mNumVertices < 3)
+            {
+                min.splat(-0.005f);
+                max.splat(0.005f);
+            }
+            else
+            {
+                min = max = face.mPositions[0];
+
+                for (S32 j = 1; j < face.mNumVertices; ++j)
+                {
+                    min.setMin(min, face.mPositions[j]);
+                    max.setMax(max, face.mPositions[j]);
+                }
+
+                if (face.mTexCoords)
+                {
+                    LLVector2& face_min_tc = face.mTexCoordExtents[0];
+                    LLVector2& face_max_tc = face.mTexCoordExtents[1];
+
+                    face_min_tc = face.mTexCoords[0];
+                    face_max_tc = face.mTexCoords[0];
+
+                    for (S32 j = 1; j < face.mNumVertices; ++j)
+                    {
+                        update_min_max(face_min_tc, face_max_tc, face.mTexCoords[j]);
+                    }
+                }
+                else
+                {
+                    face.mTexCoordExtents[0].set(0, 0);
+                    face.mTexCoordExtents[1].set(1, 1);
+                }
+            }
+        }
+
+        if (!volume->cacheOptimize(true))
+        {
+            faces.clear();
+            return false;
+        }
+
+        volume->setSculptLevel(0);
+        return true;
+    }
+
+    bool same_bytes(const void* a, const void* b, size_t size)
+    {
+        return size == 0 || (a && b && memcmp(a, b, size) == 0);
+    }
+
+    void ensure_same_faces(const std::string& msg, const LLVolume* a, const LLVolume* b)
+    {
+        tut::ensure_equals(msg + " face count", a->getNumVolumeFaces(), b->getNumVolumeFaces());
+        for (S32 i = 0; i < a->getNumVolumeFaces(); ++i)
+        {
+            const LLVolumeFace& fa = a->getVolumeFace(i);
+            const LLVolumeFace& fb = b->getVolumeFace(i);
+            std::string face_msg = msg + " face " + std::to_string(i);
+            tut::ensure_equals(face_msg + " vertices", fa.mNumVertices, fb.mNumVertices);
+            tut::ensure_equals(face_msg + " indices", fa.mNumIndices, fb.mNumIndices);
+            tut::ensure(face_msg + " extents", same_bytes(fa.mExtents, fb.mExtents, sizeof(LLVector4a) * 2));
+            tut::ensure(face_msg + " positions", same_bytes(fa.mPositions, fb.mPositions, sizeof(LLVector4a) * fa.mNumVertices));
+            tut::ensure(face_msg + " normals", same_bytes(fa.mNormals, fb.mNormals, sizeof(LLVector4a) * fa.mNumVertices));
+            tut::ensure(face_msg + " texcoords", same_bytes(fa.mTexCoords, fb.mTexCoords, sizeof(LLVector2) * fa.mNumVertices));
+            tut::ensure(face_msg + " index data", same_bytes(fa.mIndices, fb.mIndices, sizeof(U16) * fa.mNumIndices));
+            tut::ensure(face_msg + " texcoord extents", same_bytes(fa.mTexCoordExtents, fb.mTexCoordExtents, sizeof(LLVector2) * 2));
+            tut::ensure_equals(face_msg + " has tangents", fa.mTangents != nullptr, fb.mTangents != nullptr);
+            if (fa.mTangents)
+            {
+                tut::ensure(face_msg + " tangents", same_bytes(fa.mTangents, fb.mTangents, sizeof(LLVector4a) * fa.mNumVertices));
+            }
+            tut::ensure_equals(face_msg + " has weights", fa.mWeights != nullptr, fb.mWeights != nullptr);
+            if (fa.mWeights)
+            {
+                tut::ensure(face_msg + " weights", same_bytes(fa.mWeights, fb.mWeights, sizeof(LLVector4a) * fa.mNumVertices));
+            }
+            tut::ensure(face_msg + " scale", fa.mNormalizedScale == fb.mNormalizedScale);
+        }
+    }
+
+    // Unpacks the zipped lod with both paths and compares the results with
+    // each other and with the baseline decoder
+    void ensure_unpacks_same(const std::string& msg, LLSD lod, U8 sculpt_flags)
+    {
+        std::string zipped = zip_llsd(lod);
+        tut::ensure(msg + " zipped", !zipped.empty());
+
+        LLPointer<LLVolume> from_binary = make_volume(sculpt_flags);
+        tut::ensure(msg + " binary unpack", from_binary->unpackVolumeFaces((U8*)zipped.data(), (S32)zipped.size()));
+
+        LLPointer<LLVolume> from_llsd = make_volume(sculpt_flags);
+        tut::ensure(msg + " llsd unpack", from_llsd->unpackVolumeFaces(lod));
+
+        LLPointer<LLVolume> from_baseline = make_volume(sculpt_flags);
+        tut::ensure(msg + " baseline unpack", baseline_unpack(from_baseline, lod));
+
+        ensure_same_faces(msg + " binary", from_binary, from_baseline);
+        ensure_same_faces(msg + " llsd", from_llsd, from_baseline);
+    }
+}
+
+namespace tut
+{
+    struct LLVolumeData
+    {
+    };
+
+    typedef test_group<LLVolumeData> factory;
+    typedef factory::object object;
+}
+
+namespace
+{
+    tut::factory llvolume_test_factory("LLVolume");
+}
+
+namespace tut
+{
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("unzip");
+        LLSD lod = make_lod();
+        std::string zipped = zip_llsd(lod);
+
+        std::vector<U8> inflated;
+        ensure_equals("unzip", LLUZipHelper::unzip(inflated, (const U8*)zipped.data(), (S32)zipped.size()), LLUZipHelper::ZR_OK);
+
+        std::ostringstream binary;
+        LLSDSerialize::toBinary(lod, binary);
+        ensure("inflated bytes", std::string(inflated.begin(), inflated.end()) == binary.str());
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("binary and LLSD decode match the baseline decoder");
+        ensure_unpacks_same("plain", make_lod(), 0);
+        ensure_unpacks_same("mirror", make_lod(), LL_SCULPT_FLAG_MIRROR);
+        ensure_unpacks_same("invert", make_lod(), LL_SCULPT_FLAG_INVERT);
+        ensure_unpacks_same("mirror invert", make_lod(), LL_SCULPT_FLAG_MIRROR | LL_SCULPT_FLAG_INVERT);
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("layouts the binary reader leaves to the LLSD parser");
+
+        // integer domain
+        LLSD lod = make_lod();
+        lod[0]["PositionDomain"]["Min"] = llsd::array(-1, 0, 1);
+        ensure_unpacks_same("integer domain", lod, 0);
+
+        // short domain, extra entries
+        lod = make_lod();
+        lod[0]["TexCoord0Domain"]["Min"] = llsd::array(0.5);
+        lod[3]["Comment"] = llsd::map("nested", llsd::array(1, "two", LLUUID::generateNewID()));
+        ensure_unpacks_same("short domain", lod, 0);
+
+        // wrong type
+        lod = make_lod();
+        lod[1]["PositionDomain"] = "none";
+        ensure_unpacks_same("string domain", lod, 0);
+    }
+
+    template<> template<>
+    void object::test<4>()
+    {
+        set_test_name("bad input");
+
+        LLPointer<LLVolume> volume = make_volume(0);
+        LLSD empty = LLSD::emptyArray();
+        std::string zipped = zip_llsd(empty);
+        ensure("no faces", !volume->unpackVolumeFaces((U8*)zipped.data(), (S32)zipped.size()));
+
+        std::string garbage = "not a zipped mesh";
+        ensure("garbage", !volume->unpackVolumeFaces((U8*)garbage.data(), (S32)garbage.size()));
+
+        // short normals are treated as missing, not read past
+        LLSD lod = make_lod();
+        lod[0]["Normal"] = make_u16s(3, 2);
+        zipped = zip_llsd(lod);
+        ensure("short normals", volume->unpackVolumeFaces((U8*)zipped.data(), (S32)zipped.size()));
+    }
+
+    template<> template<>
+    void object::test<5>()
+    {
+        set_test_name("decoded faces round trip");
+
+        LLSD lod = make_lod();
+        std::string zipped = zip_llsd(lod);
+        LLPointer<LLVolume> source = make_volume(0);
+        ensure("unpack", source->unpackVolumeFaces((U8*)zipped.data(), (S32)zipped.size()));
+        ensure("weights to pack", source->getVolumeFace(0).mWeights != nullptr);
+        ensure("tangents to pack", source->getVolumeFace(0).mTangents != nullptr);
+
+        std::vector<U8> packed;
+        source->packDecodedFaces(packed);
+
+        LLPointer<LLVolume> unpacked = make_volume(0);
+        ensure("unpack decoded", unpacked->unpackDecodedFaces(packed.data(), (S32)packed.size()));
+        ensure_same_faces("decoded", unpacked, source);
+        for (S32 i = 0; i < source->getNumVolumeFaces(); ++i)
+        {
+            const LLVolumeFace& fa = unpacked->getVolumeFace(i);
+            const LLVolumeFace& fb = source->getVolumeFace(i);
+            std::string face_msg = "decoded face " + std::to_string(i);
+            ensure(face_msg + " center", same_bytes(fa.mCenter, fb.mCenter, sizeof(LLVector4a)));
+            ensure_equals(face_msg + " optimized", fa.mOptimized, fb.mOptimized);
+        }
+
+        // Packing the unpacked faces gives the same bytes
+        std::vector<U8> repacked;
+        unpacked->packDecodedFaces(repacked);
+        ensure("repacked", repacked == packed);
+
+        // Any cut short of the end leaves the last face incomplete
+        for (size_t size = 0; size < packed.size(); ++size)
+        {
+            LLPointer<LLVolume> volume = make_volume(0);
+            if (volume->unpackDecodedFaces(packed.data(), (S32)size))
+            {
+                fail("truncated to " + std::to_string(size) + " bytes");
+            }
+        }
+
+        // The first face header follows the 16 byte header, its vertex and
+        // index counts follow 20 floats of extents and scale
+        const size_t FIRST_FACE_COUNTS = 16 + 20 * sizeof(F32);
+        const LLVolumeFace& last_face = source->getVolumeFace(source->getNumVolumeFaces() - 1);
+        const size_t LAST_INDICES = packed.size() - ((last_face.mNumIndices * sizeof(U16) + 0xF) & ~0xF);
+
+        std::vector<U8> corrupt = packed;
+        ((U32*)corrupt.data())[0] = 99;
+        ensure("unknown version", !unpacked->unpackDecodedFaces(corrupt.data(), (S32)corrupt.size()));
+
+        corrupt = packed;
+        ((U32*)corrupt.data())[1] = 0x10000000;
+        ensure("too many faces", !unpacked->unpackDecodedFaces(corrupt.data(), (S32)corrupt.size()));
+
+        corrupt = packed;
+        ((S32*)(corrupt.data() + FIRST_FACE_COUNTS))[0] = -1;
+        ensure("negative vertex count", !unpacked->unpackDecodedFaces(corrupt.data(), (S32)corrupt.size()));
+
+        corrupt = packed;
+        ((S32*)(corrupt.data() + FIRST_FACE_COUNTS))[1] += 1;
+        ensure("partial triangle", !unpacked->unpackDecodedFaces(corrupt.data(), (S32)corrupt.size()));
+
+        corrupt = packed;
+        ((U16*)(corrupt.data() + LAST_INDICES))[0] = (U16)last_face.mNumVertices;
+        ensure("index out of range", !unpacked->unpackDecodedFaces(corrupt.data(), (S32)corrupt.size()));
+        ensure_equals("rejected faces dropped", unpacked->getNumVolumeFaces(), 0);
+    }
+}
@@ -0,0 +1,282 @@
+/**
+ * @file   llvolumebvh_test.cpp
+ * @brief  Test for the ray cast hierarchy in llvolumebvh.cpp.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../test/lltut.h"
+
+#include "../llvolume.h"
+#include "../llvolumebvh.h"
+
+#include <random>
+
+namespace
+{
+    struct Mesh
+    {
+        std::vector<LLVector4a> mPositions;
+        std::vector<U16> mIndices;
+    };
+
+    // Random triangles of random size in the unit cube, overlapping a lot
+    Mesh make_soup(U32 triangles, U32 seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<F32> coord(-0.5f, 0.5f);
+        std::uniform_real_distribution<F32> offset(-0.1f, 0.1f);
+
+        Mesh mesh;
+        for (U32 i = 0; i < triangles; ++i)
+        {
+            LLVector4a v0(coord(gen), coord(gen), coord(gen));
+            for (U32 j = 0; j < 3; ++j)
+            {
+                LLVector4a v(offset(gen), offset(gen), offset(gen));
+                v.add(v0);
+                mesh.mIndices.push_back((U16)mesh.mPositions.size());
+                mesh.mPositions.push_back(j ? v : v0);
+            }
+        }
+        return mesh;
+    }
+
+    // Segments from outside the unit cube through it
+    void make_ray(std::mt19937& gen, LLVector4a& start, LLVector4a& dir)
+    {
+        std::uniform_real_distribution<F32> coord(-0.5f, 0.5f);
+        start.set(coord(gen) * 4.f, coord(gen) * 4.f, coord(gen) * 4.f);
+        LLVector4a target(coord(gen), coord(gen), coord(gen));
+        dir.setSub(target, start);
+        dir.mul(2.f);
+    }
+
+    // Closest hit the slow way, same rules as LLVolume::lineSegmentIntersect()
+    S32 brute_force(const Mesh& mesh, const LLVector4a& start, const LLVector4a& dir, F32& closest_t)
+    {
+        S32 hit = -1;
+        for (U32 i = 0; i < mesh.mIndices.size() / 3; ++i)
+        {
+            F32 a, b, t;
+            if (LLTriangleRayIntersect(mesh.mPositions[mesh.mIndices[i * 3]], mesh.mPositions[mesh.mIndices[i * 3 + 1]],
+                                       mesh.mPositions[mesh.mIndices[i * 3 + 2]], start, dir, a, b, t)
+                && t >= 0.f && t <= 1.f && t < closest_t)
+            {
+                closest_t = t;
+                hit = i;
+            }
+        }
+        return hit;
+    }
+
+    // Compares against brute force, rays grazing an edge may round either
+    // way so a few disagreements are allowed
+    void ensure_matches(const std::string& msg, const Mesh& mesh, U32 rays, U32 seed)
+    {
+        LLPointer<LLVolumeBVH> bvh = new LLVolumeBVH(mesh.mPositions.data(), mesh.mIndices.data(), (S32)mesh.mIndices.size());
+        tut::ensure_equals(msg + " triangles", bvh->getNumTriangles(), (U32)mesh.mIndices.size() / 3);
+
+        std::mt19937 gen(seed);
+        U32 hits = 0;
+        U32 disagree = 0;
+        for (U32 i = 0; i < rays; ++i)
+        {
+            LLVector4a start, dir;
+            make_ray(gen, start, dir);
+
+            F32 expected_t = 2.f;
+            S32 expected = brute_force(mesh, start, dir, expected_t);
+
+            F32 t = 2.f, a = -1.f, b = -1.f;
+            S32 tri = bvh->intersect(start, dir, t, a, b);
+
+            if (expected < 0 || tri < 0)
+            {
+                disagree += (expected < 0) != (tri < 0);
+                continue;
+            }
+
+            ++hits;
+            tut::ensure_approximately_equals((msg + " t").c_str(), t, expected_t, 16);
+            tut::ensure(msg + " barycentric", a >= 0.f && b >= 0.f && a + b <= 1.0001f);
+
+            // the hit point must be on the triangle it reports
+            const LLVector4a& v0 = mesh.mPositions[mesh.mIndices[tri * 3]];
+            const LLVector4a& v1 = mesh.mPositions[mesh.mIndices[tri * 3 + 1]];
+            const LLVector4a& v2 = mesh.mPositions[mesh.mIndices[tri * 3 + 2]];
+            LLVector4a on_ray = dir;
+            on_ray.mul(t);
+            on_ray.add(start);
+            LLVector4a on_tri;
+            on_tri.setLerp(v0, v1, a);
+            LLVector4a e2;
+            e2.setSub(v2, v0);
+            e2.mul(b);
+            on_tri.add(e2);
+            tut::ensure(msg + " point", on_ray.equals3(on_tri, 0.0001f));
+        }
+
+        tut::ensure(msg + " hits", hits > 0);
+        tut::ensure(msg + " misses", hits < rays);
+        tut::ensure(msg + " agreement", disagree * 100 <= rays);
+    }
+}
+
+namespace tut
+{
+    struct LLVolumeBVHData
+    {
+    };
+
+    typedef test_group<LLVolumeBVHData> factory;
+    typedef factory::object object;
+}
+
+namespace
+{
+    tut::factory llvolumebvh_test_factory("LLVolumeBVH");
+}
+
+namespace tut
+{
+    template<> template<>
+    void object::test<1>()
+    {
+        set_test_name("closest hit matches brute force");
+        ensure_matches("one", make_soup(1, 1), 500, 2);
+        ensure_matches("leaf", make_soup(LLVolumeBVH::LEAF_SIZE, 3), 500, 4);
+        ensure_matches("soup", make_soup(2000, 5), 2000, 6);
+    }
+
+    template<> template<>
+    void object::test<2>()
+    {
+        set_test_name("degenerate input");
+
+        LLPointer<LLVolumeBVH> empty = new LLVolumeBVH(NULL, NULL, 0);
+        LLVector4a start(0.f, 0.f, 1.f);
+        LLVector4a dir(0.f, 0.f, -2.f);
+        F32 t = 2.f, a, b;
+        ensure_equals("empty", empty->intersect(start, dir, t, a, b), -1);
+        ensure_equals("empty nodes", empty->getNumNodes(), 0U);
+
+        // every centroid in one spot, the build has to split by count
+        Mesh stack;
+        for (U32 i = 0; i < 1000; ++i)
+        {
+            stack.mIndices.push_back((U16)stack.mPositions.size());
+            stack.mPositions.emplace_back(-0.5f, -0.5f, 0.f);
+            stack.mIndices.push_back((U16)stack.mPositions.size());
+            stack.mPositions.emplace_back(0.5f, -0.5f, 0.f);
+            stack.mIndices.push_back((U16)stack.mPositions.size());
+            stack.mPositions.emplace_back(0.f, 0.5f, 0.f);
+        }
+        LLPointer<LLVolumeBVH> bvh = new LLVolumeBVH(stack.mPositions.data(), stack.mIndices.data(), (S32)stack.mIndices.size());
+        ensure("depth", bvh->getDepth() < 64);
+
+        t = 2.f;
+        ensure("front face hit", bvh->intersect(start, dir, t, a, b) >= 0);
+        ensure_approximately_equals("front face t", t, 0.5f, 16);
+
+        // back faces don't count, same as LLTriangleRayIntersect
+        LLVector4a back_start(0.f, 0.f, -1.f);
+        LLVector4a back_dir(0.f, 0.f, 2.f);
+        t = 2.f;
+        ensure_equals("back face", bvh->intersect(back_start, back_dir, t, a, b), -1);
+    }
+
+    template<> template<>
+    void object::test<3>()
+    {
+        set_test_name("closest_t limits the hits");
+        Mesh mesh = make_soup(500, 7);
+        LLPointer<LLVolumeBVH> bvh = new LLVolumeBVH(mesh.mPositions.data(), mesh.mIndices.data(), (S32)mesh.mIndices.size());
+
+        std::mt19937 gen(8);
+        for (U32 i = 0; i < 200; ++i)
+        {
+            LLVector4a start, dir;
+            make_ray(gen, start, dir);
+
+            F32 t = 2.f, a, b;
+            if (bvh->intersect(start, dir, t, a, b) < 0)
+            {
+                continue;
+            }
+
+            // nothing is closer than the closest hit
+            F32 limit = t;
+            ensure_equals("limited", bvh->intersect(start, dir, limit, a, b), -1);
+            ensure_equals("limit unchanged", limit, t);
+        }
+    }
+
+    template<> template<>
+    void object::test<4>()
+    {
+        set_test_name("lineSegmentIntersect through the octree and the hierarchy");
+
+        LLVolumeParams params;
+        params.setType(LL_PCODE_PROFILE_CIRCLE | LL_PCODE_HOLE_SQUARE, LL_PCODE_PATH_CIRCLE);
+        params.setHollow(0.5f);
+        params.setTwistEnd(0.5f);
+        params.setBeginAndEndS(0.f, 1.f);
+        params.setBeginAndEndT(0.f, 1.f);
+        params.setRatio(1.f, 0.25f);
+        LLPointer<LLVolume> volume = new LLVolume(params, 3.f);
+        ensure("faces", volume->getNumVolumeFaces() > 0);
+
+        const bool use_bvh = LLVolume::sUseBVH;
+        std::mt19937 gen(9);
+        U32 hits = 0;
+        U32 disagree = 0;
+        for (U32 i = 0; i < 500; ++i)
+        {
+            LLVector4a start, dir, end;
+            make_ray(gen, start, dir);
+            end.setAdd(start, dir);
+
+            LLVector4a octree_point, bvh_point;
+            LLVector2 octree_tc, bvh_tc;
+            LLVolume::sUseBVH = false;
+            S32 octree_face = volume->lineSegmentIntersect(start, end, -1, &octree_point, &octree_tc);
+            LLVolume::sUseBVH = true;
+            S32 bvh_face = volume->lineSegmentIntersect(start, end, -1, &bvh_point, &bvh_tc);
+
+            if (octree_face < 0 || bvh_face < 0)
+            {
+                disagree += (octree_face < 0) != (bvh_face < 0);
+                continue;
+            }
+
+            ++hits;
+            ensure("point", octree_point.equals3(bvh_point, 0.0001f));
+        }
+        LLVolume::sUseBVH = use_bvh;
+
+        ensure("hits", hits > 0);
+        ensure("agreement", disagree <= 5);
+    }
+}
@@ -0,0 +1,373 @@
+/**
+* @file llmeshlodgenerator.cpp
+* @brief Builds the lower LODs of a batch of models in parallel
+*
+* $LicenseInfo:firstyear=2026&license=viewerlgpl$
+* Second Life Viewer Source Code
+* Copyright (C) 2026, Linden Research, Inc.
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation;
+* version 2.1 of the License only.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*
+* Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+* $/LicenseInfo$
+*/
+
+#include "llmeshlodgenerator.h"
+
+#include "llmeshoptimizer.h"
+#include "lltimer.h"
+#include "threadpool.h"
+
+#include <algorithm>
+#include <thread>
+
+LLMeshLODGenerator::Settings::Settings()
+:   mTargetError(1.f),
+    mNormalWeight(0.5f),
+    mUVWeight(1.f),
+    mLockBorder(false),
+    mAllowSloppy(true),
+    mAllowedRatioDrift(1.8f),
+    mOptimizeVertexCache(true),
+    mOptimizeOverdraw(true),
+    mOverdrawThreshold(1.05f),
+    mBuildMeshlets(false),
+    mMeshletMaxVertices(64),
+    mMeshletMaxTriangles(124)
+{
+    // Default decimation of the model preview
+    setDecimation(3.f);
+}
+
+void LLMeshLODGenerator::Settings::setDecimation(F32 decimation)
+{
+    decimation = llmax(decimation, 1.f);
+    F32 ratio = 1.f;
+    for (S32 lod = LOD_HIGH; lod >= 0; --lod)
+    {
+        mTriangleRatio[lod] = ratio;
+        ratio /= decimation;
+    }
+}
+
+LLMeshLODGenerator::LLMeshLODGenerator(const Settings& settings, U32 threads)
+:   mSettings(settings),
+    mSeconds(0.0)
+{
+    for (S32 lod = 0; lod < NUM_LODS; ++lod)
+    {
+        mGenerated[lod] = false;
+    }
+
+    // Not shut down by "LLApp", the pool belongs to this generator and is
+    // closed with it
+    mPool.reset(new LL::ThreadPool("MeshLOD", threads, 1024 * 1024, false));
+    mPool->start();
+}
+
+LLMeshLODGenerator::~LLMeshLODGenerator()
+{
+    mPool->close();
+}
+
+S32 LLMeshLODGenerator::addModel(const LLVolume* base)
+{
+    Model model;
+    model.mBase = base;
+    mModels.push_back(model);
+    return (S32)mModels.size() - 1;
+}
+
+//static
+U32 LLMeshLODGenerator::getDefaultThreads()
+{
+    // Leaves a core to the calling thread
+    return llmax((U32)std::thread::hardware_concurrency(), 2U) - 1;
+}
+
+U32 LLMeshLODGenerator::getNumThreads() const
+{
+    // The calling thread works too
+    return (U32)mPool->getWidth() + 1;
+}
+
+void LLMeshLODGenerator::generate(S32 lod)
+{
+    struct Job
+    {
+        const LLVolumeFace* mFace;
+        F32 mRatio;
+        FaceResult* mResult;
+    };
+
+    std::vector<Job> jobs;
+    for (S32 i = 0; i < NUM_LODS; ++i)
+    {
+        if (lod == -1 ? i == LOD_HIGH : i != lod)
+        {
+            continue;
+        }
+        for (Model& model : mModels)
+        {
+            S32 num_faces = model.mBase->getNumVolumeFaces();
+            model.mLODs[i].clear();
+            model.mLODs[i].resize(num_faces);
+            for (S32 face = 0; face < num_faces; ++face)
+            {
+                jobs.push_back({ &model.mBase->getVolumeFace(face), mSettings.mTriangleRatio[i], &model.mLODs[i][face] });
+            }
+        }
+        mGenerated[i] = true;
+    }
+
+    // Biggest faces first, so that one large face isn't left for last
+    std::stable_sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b)
+        {
+            return a.mFace->mNumIndices > b.mFace->mNumIndices;
+        });
+
+    LLTimer timer;
+
+    mPool->runJobs(jobs.size(), [&jobs, this](size_t i)
+        {
+            simplifyFace(*jobs[i].mFace, jobs[i].mRatio, mSettings, *jobs[i].mResult);
+        });
+
+    mSeconds = timer.getElapsedTimeF64();
+}
+
+bool LLMeshLODGenerator::hasLOD(S32 lod) const
+{
+    return lod >= 0 && lod < NUM_LODS && mGenerated[lod];
+}
+
+S32 LLMeshLODGenerator::getNumFaces(S32 model) const
+{
+    return mModels[model].mBase->getNumVolumeFaces();
+}
+
+const LLMeshLODGenerator::FaceResult& LLMeshLODGenerator::getFace(S32 model, S32 lod, S32 face) const
+{
+    llassert(hasLOD(lod));
+    return mModels[model].mLODs[lod][face];
+}
+
+U32 LLMeshLODGenerator::getNumTriangles(S32 lod) const
+{
+    U32 triangles = 0;
+    for (const Model& model : mModels)
+    {
+        if (!mGenerated[lod])
+        {
+            // Not generated, count the base
+            for (S32 i = 0; i < model.mBase->getNumVolumeFaces(); ++i)
+            {
+                triangles += model.mBase->getVolumeFace(i).mNumIndices / 3;
+            }
+        }
+        else
+        {
+            for (const FaceResult& result : model.mLODs[lod])
+            {
+                triangles += result.mFace.mNumIndices / 3;
+            }
+        }
+    }
+    return triangles;
+}
+
+U32 LLMeshLODGenerator::getNumMeshlets(S32 lod) const
+{
+    U32 meshlets = 0;
+    for (const Model& model : mModels)
+    {
+        for (const FaceResult& result : model.mLODs[lod])
+        {
+            meshlets += result.mMeshlets;
+        }
+    }
+    return meshlets;
+}
+
+U32 LLMeshLODGenerator::getNumFaces(S32 lod, EMethod method) const
+{
+    U32 faces = 0;
+    for (const Model& model : mModels)
+    {
+        for (const FaceResult& result : model.mLODs[lod])
+        {
+            if (result.mMethod == method)
+            {
+                ++faces;
+            }
+        }
+    }
+    return faces;
+}
+
+//static
+void LLMeshLODGenerator::simplifyFace(const LLVolumeFace& face, F32 ratio, const Settings& settings, FaceResult& result)
+{
+    result.mFace = face;
+    result.mMethod = METHOD_COPY;
+    result.mError = 0.f;
+    result.mMeshlets = 0;
+
+    U32 index_count = face.mNumIndices;
+    U32 vertex_count = face.mNumVertices;
+    if (index_count < 3 || vertex_count == 0 || ratio >= 1.f)
+    {
+        return;
+    }
+
+    U32 target_count = llclamp((U32)(index_count * ratio) / 3 * 3, (U32)3, index_count);
+    U32 allowed_count = (U32)(target_count * settings.mAllowedRatioDrift);
+
+    std::vector<U32> indices(face.mIndices, face.mIndices + index_count);
+    std::vector<U32> output(index_count);
+    U64 output_count = 0;
+    F32 error = 0.f;
+
+    bool use_attributes = (face.mNormals && settings.mNormalWeight > 0.f) || (face.mTexCoords && settings.mUVWeight > 0.f);
+    if (use_attributes)
+    {
+        output_count = LLMeshOptimizer::simplifyWithAttributesU32(output.data(), indices.data(), index_count,
+            face.mPositions, face.mNormals, face.mTexCoords, vertex_count,
+            settings.mNormalWeight, settings.mUVWeight,
+            target_count, settings.mTargetError, settings.mLockBorder, &error);
+        result.mMethod = METHOD_ATTRIBUTES;
+    }
+
+    if (!use_attributes || output_count < 3 || output_count > allowed_count)
+    {
+        // Seams and creases held it back
+        output_count = LLMeshOptimizer::simplifyU32(output.data(), indices.data(), index_count,
+            face.mPositions, vertex_count, sizeof(LLVector4a),
+            target_count, settings.mTargetError, false, &error, settings.mLockBorder);
+        result.mMethod = METHOD_POSITIONS;
+    }
+
+    if (settings.mAllowSloppy && (output_count < 3 || output_count > allowed_count))
+    {
+        // Ignores topology, can remove everything
+        std::vector<U32> sloppy(index_count);
+        F32 sloppy_error = 0.f;
+        U64 sloppy_count = LLMeshOptimizer::simplifyU32(sloppy.data(), indices.data(), index_count,
+            face.mPositions, vertex_count, sizeof(LLVector4a),
+            target_count, settings.mTargetError, true, &sloppy_error);
+        if (sloppy_count >= 3 && (output_count < 3 || sloppy_count < output_count))
+        {
+            output.swap(sloppy);
+            output_count = sloppy_count;
+            error = sloppy_error;
+            result.mMethod = METHOD_SLOPPY;
+        }
+    }
+
+    LLVolumeFace& new_face = result.mFace;
+    result.mError = error;
+
+    if (output_count < 3)
+    {
+        // Same stand in as LLModelPreview::genMeshOptimizerPerFace()
+        new_face.resizeIndices(3);
+        new_face.resizeVertices(1);
+        memset(new_face.mIndices, 0, sizeof(U16) * 3);
+        new_face.mPositions[0].clear();
+        new_face.mNormals[0].clear();
+        new_face.mTexCoords[0].setZero();
+        result.mMethod = METHOD_EMPTY;
+        return;
+    }
+
+    if (settings.mOptimizeVertexCache)
+    {
+        LLMeshOptimizer::optimizeVertexCacheU32(indices.data(), output.data(), output_count, vertex_count);
+        output.swap(indices);
+        if (settings.mOptimizeOverdraw)
+        {
+            LLMeshOptimizer::optimizeOverdrawU32(indices.data(), output.data(), output_count,
+                face.mPositions, vertex_count, settings.mOverdrawThreshold);
+            output.swap(indices);
+        }
+    }
+
+    // Drop the vertices nothing uses anymore, numbered in the order the
+    // triangles first use them
+    std::vector<U32> remap(vertex_count, U32_MAX);
+    U32 new_vertex_count = 0;
+    for (U64 i = 0; i < output_count; ++i)
+    {
+        U32& index = remap[output[i]];
+        if (index == U32_MAX)
+        {
+            index = new_vertex_count++;
+        }
+        output[i] = index;
+    }
+
+    new_face.resizeVertices(new_vertex_count);
+    if (face.mWeights)
+    {
+        new_face.allocateWeights(new_vertex_count);
+    }
+    if (face.mTangents)
+    {
+        new_face.allocateTangents(new_vertex_count);
+    }
+    for (U32 i = 0; i < vertex_count; ++i)
+    {
+        U32 index = remap[i];
+        if (index == U32_MAX)
+        {
+            continue;
+        }
+        new_face.mPositions[index] = face.mPositions[i];
+        new_face.mNormals[index] = face.mNormals[i];
+        new_face.mTexCoords[index] = face.mTexCoords[i];
+        if (face.mWeights)
+        {
+            new_face.mWeights[index] = face.mWeights[i];
+        }
+        if (face.mTangents)
+        {
+            new_face.mTangents[index] = face.mTangents[i];
+        }
+    }
+
+    new_face.resizeIndices((S32)output_count);
+    for (U64 i = 0; i < output_count; ++i)
+    {
+        new_face.mIndices[i] = (U16)output[i];
+    }
+
+    LLVector4a& min = new_face.mExtents[0];
+    LLVector4a& max = new_face.mExtents[1];
+    min = max = new_face.mPositions[0];
+    for (U32 i = 1; i < new_vertex_count; ++i)
+    {
+        min.setMin(min, new_face.mPositions[i]);
+        max.setMax(max, new_face.mPositions[i]);
+    }
+    new_face.mCenter->setAdd(min, max);
+    new_face.mCenter->mul(0.5f);
+
+    if (settings.mBuildMeshlets)
+    {
+        result.mMeshlets = (U32)LLMeshOptimizer::buildMeshletsU32(output.data(), output_count,
+            new_face.mPositions, new_vertex_count,
+            settings.mMeshletMaxVertices, settings.mMeshletMaxTriangles);
+    }
+}
@@ -0,0 +1,151 @@
+/**
+* @file llmeshlodgenerator.h
+* @brief Builds the lower LODs of a batch of models in parallel
+*
+* $LicenseInfo:firstyear=2026&license=viewerlgpl$
+* Second Life Viewer Source Code
+* Copyright (C) 2026, Linden Research, Inc.
+*
+* This library is free software; you can redistribute it and/or
+* modify it under the terms of the GNU Lesser General Public
+* License as published by the Free Software Foundation;
+* version 2.1 of the License only.
+*
+* This library is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+* Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this library; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*
+* Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+* $/LicenseInfo$
+*/
+#ifndef LLMESHLODGENERATOR_H
+#define LLMESHLODGENERATOR_H
+
+#include "linden_common.h"
+
+#include "llvolume.h"
+#include "threadpool_fwd.h"
+
+#include <memory>
+#include <vector>
+
+// Generates LODs for every face of every model of an upload at once.
+// Each face at each LOD is one job, the jobs are spread over a "MeshLOD"
+// thread pool and the calling thread, so a scene with many models or
+// faces uses every core instead of simplifying one face after another.
+//
+// Faces are simplified by position, normals and texture coordinates
+// first. When that can't get close to the target, they fall back to
+// positions only and then to sloppy simplification, like the auto mode of
+// the model preview. The results are reordered for the vertex cache and
+// for overdraw, and unused vertices are dropped.
+class LLMeshLODGenerator
+{
+public:
+    // Same numbering as LLModel, LOD_HIGH is the base model
+    static const S32 NUM_LODS = 4;
+    static const S32 LOD_HIGH = 3;
+
+    struct Settings
+    {
+        Settings();
+
+        // Keeps 1/decimation of the triangles of the next LOD up
+        void setDecimation(F32 decimation);
+
+        // Fraction of the base triangles to keep at each LOD, the LOD_HIGH
+        // entry is ignored
+        F32 mTriangleRatio[NUM_LODS];
+        // Largest deviation allowed, relative to the size of the face. 1
+        // lets the triangle ratio alone decide.
+        F32 mTargetError;
+        // Error weight of normals and texture coordinates, 0 leaves them out
+        F32 mNormalWeight;
+        F32 mUVWeight;
+        // Keep the open edges of each face in place
+        bool mLockBorder;
+        // Retry by position only, then sloppily, when a face ends up with
+        // more than mAllowedRatioDrift times the target
+        bool mAllowSloppy;
+        F32 mAllowedRatioDrift;
+        bool mOptimizeVertexCache;
+        bool mOptimizeOverdraw;
+        F32 mOverdrawThreshold;
+        // Count the meshlets of each generated face, for stats only, the
+        // renderer doesn't draw meshlets
+        bool mBuildMeshlets;
+        U32 mMeshletMaxVertices;
+        U32 mMeshletMaxTriangles;
+    };
+
+    typedef enum
+    {
+        METHOD_COPY = 0,    // target at or above the base
+        METHOD_ATTRIBUTES,
+        METHOD_POSITIONS,
+        METHOD_SLOPPY,
+        METHOD_EMPTY,       // nothing left, holds one degenerate triangle
+    } EMethod;
+
+    struct FaceResult
+    {
+        LLVolumeFace mFace;
+        EMethod mMethod = METHOD_COPY;
+        F32 mError = 0.f;
+        U32 mMeshlets = 0;
+    };
+
+    // threads is the default width of the pool, ThreadPoolSizes can
+    // override it. With 0 every job runs on the calling thread.
+    LLMeshLODGenerator(const Settings& settings, U32 threads);
+    ~LLMeshLODGenerator();
+
+    // The base isn't copied, it must stay alive and unchanged until
+    // generate() returns. Returns the index of the model.
+    S32 addModel(const LLVolume* base);
+    S32 getNumModels() const { return (S32)mModels.size(); }
+
+    // Builds the given LOD, or every LOD below LOD_HIGH when lod is -1, and
+    // returns once all models are done. LOD_HIGH itself is only built when
+    // asked for, from its own triangle ratio.
+    void generate(S32 lod = -1);
+
+    bool hasLOD(S32 lod) const;
+    const FaceResult& getFace(S32 model, S32 lod, S32 face) const;
+    S32 getNumFaces(S32 model) const;
+
+    // Totals over every model, LODs that weren't generated count the base
+    U32 getNumTriangles(S32 lod) const;
+    U32 getNumMeshlets(S32 lod) const;
+    U32 getNumFaces(S32 lod, EMethod method) const;
+
+    // Wall clock time of the last generate()
+    F64 getSeconds() const { return mSeconds; }
+    U32 getNumThreads() const;
+
+    // One thread per core, less the calling thread
+    static U32 getDefaultThreads();
+
+    // Simplifies one face, safe on any thread
+    static void simplifyFace(const LLVolumeFace& face, F32 ratio, const Settings& settings, FaceResult& result);
+
+private:
+    struct Model
+    {
+        const LLVolume* mBase;
+        std::vector<FaceResult> mLODs[NUM_LODS];
+    };
+
+    Settings mSettings;
+    std::vector<Model> mModels;
+    bool mGenerated[NUM_LODS];
+    F64 mSeconds;
+    std::unique_ptr<LL::ThreadPool> mPool;
+};
+
+#endif //LLMESHLODGENERATOR_H
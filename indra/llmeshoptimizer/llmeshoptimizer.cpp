@@ -29,8 +29,11 @@
 #include "meshoptimizer.h"
 
 #include "llmath.h"
+#include "llvector4a.h"
 #include "v2math.h"
 
+#include <vector>
+
 LLMeshOptimizer::LLMeshOptimizer()
 {
     // Todo: Looks like for memory management, we can add allocator and deallocator callbacks
@@ -152,6 +155,49 @@ void LLMeshOptimizer::optimizeVertexCacheU16(U16 * destination, const U16 * indi
     meshopt_optimizeVertexCache<unsigned short>(destination, indices, index_count, vertex_count);
 }
 
+//static
+void LLMeshOptimizer::optimizeOverdrawU32(U32 *destination,
+    const U32 *indices,
+    U64 index_count,
+    const LLVector4a * vertex_positions,
+    U64 vertex_count,
+    F32 threshold)
+{
+    meshopt_optimizeOverdraw<unsigned int>(destination,
+        indices,
+        index_count,
+        (const float*)vertex_positions,
+        vertex_count,
+        sizeof(LLVector4a),
+        threshold);
+}
+
+//static
+U64 LLMeshOptimizer::buildMeshletsU32(const U32 *indices,
+    U64 index_count,
+    const LLVector4a * vertex_positions,
+    U64 vertex_count,
+    U64 max_vertices,
+    U64 max_triangles)
+{
+    size_t max_meshlets = meshopt_buildMeshletsBound(index_count, max_vertices, max_triangles);
+    std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+    std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
+    std::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
+
+    return meshopt_buildMeshlets(meshlets.data(),
+        meshlet_vertices.data(),
+        meshlet_triangles.data(),
+        indices,
+        index_count,
+        (const float*)vertex_positions,
+        vertex_count,
+        sizeof(LLVector4a),
+        max_vertices,
+        max_triangles,
+        0.f);
+}
+
 size_t LLMeshOptimizer::generateRemapMultiU32(
     unsigned int* remap,
     const U32 * indices,
@@ -265,7 +311,8 @@ U64 LLMeshOptimizer::simplifyU32(U32 *destination,
     U64 target_index_count,
     F32 target_error,
     bool sloppy,
-    F32* result_error
+    F32* result_error,
+    bool lock_border
 )
 {
     if (sloppy)
@@ -291,12 +338,95 @@ U64 LLMeshOptimizer::simplifyU32(U32 *destination,
             vertex_positions_stride,
             target_index_count,
             target_error,
-            0,
+            lock_border ? meshopt_SimplifyLockBorder : 0,
             result_error
             );
     }
 }
 
+//static
+U64 LLMeshOptimizer::simplifyWithAttributesU32(U32 *destination,
+    const U32 *indices,
+    U64 index_count,
+    const LLVector4a *vertex_positions,
+    const LLVector4a *normals,
+    const LLVector2 *text_coords,
+    U64 vertex_count,
+    F32 normal_weight,
+    F32 uv_weight,
+    U64 target_index_count,
+    F32 target_error,
+    bool lock_border,
+    F32* result_error
+)
+{
+    if (normal_weight <= 0.f)
+    {
+        normals = NULL;
+    }
+    if (uv_weight <= 0.f)
+    {
+        text_coords = NULL;
+    }
+
+    // meshoptimizer wants the attributes interleaved, x y z of the normal
+    // then u v
+    const size_t max_attributes = 5;
+    F32 weights[max_attributes];
+    size_t attribute_count = 0;
+    if (normals)
+    {
+        weights[attribute_count++] = normal_weight;
+        weights[attribute_count++] = normal_weight;
+        weights[attribute_count++] = normal_weight;
+    }
+    if (text_coords)
+    {
+        weights[attribute_count++] = uv_weight;
+        weights[attribute_count++] = uv_weight;
+    }
+
+    if (attribute_count == 0)
+    {
+        return simplifyU32(destination, indices, index_count, vertex_positions, vertex_count, sizeof(LLVector4a),
+            target_index_count, target_error, false, result_error, lock_border);
+    }
+
+    std::vector<F32> attributes(vertex_count * attribute_count);
+    F32* dst = attributes.data();
+    for (U64 i = 0; i < vertex_count; ++i)
+    {
+        if (normals)
+        {
+            const F32* normal = normals[i].getF32ptr();
+            *dst++ = normal[0];
+            *dst++ = normal[1];
+            *dst++ = normal[2];
+        }
+        if (text_coords)
+        {
+            *dst++ = text_coords[i].mV[0];
+            *dst++ = text_coords[i].mV[1];
+        }
+    }
+
+    return meshopt_simplifyWithAttributes(destination,
+        indices,
+        index_count,
+        (const float*)vertex_positions,
+        vertex_count,
+        sizeof(LLVector4a),
+        attributes.data(),
+        sizeof(F32) * attribute_count,
+        weights,
+        attribute_count,
+        target_index_count,
+        target_error,
+        lock_border ? meshopt_SimplifyLockBorder : 0,
+        result_error
+        );
+}
+
 //static
 U64 LLMeshOptimizer::simplify(U16 *destination,
                               const U16 *indices,
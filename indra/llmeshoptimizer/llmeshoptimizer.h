@@ -67,6 +67,28 @@ class LLMeshOptimizer
         U64 index_count,
         U64 vertex_count);
 
+    // Reorders triangles to cut overdraw while keeping most of the vertex
+    // cache efficiency. indices should come from optimizeVertexCacheU32.
+    // threshold is how much worse (1.05 = 5%) the vertex cache may get.
+    static void optimizeOverdrawU32(
+        U32 *destination,
+        const U32 *indices,
+        U64 index_count,
+        const LLVector4a * vertex_positions,
+        U64 vertex_count,
+        F32 threshold);
+
+    // Returns how many meshlets of at most max_vertices vertices and
+    // max_triangles triangles the mesh splits into.
+    // max_triangles must be a multiple of 4.
+    static U64 buildMeshletsU32(
+        const U32 *indices,
+        U64 index_count,
+        const LLVector4a * vertex_positions,
+        U64 vertex_count,
+        U64 max_vertices,
+        U64 max_triangles);
+
     // Remap functions
     // Welds indentical vertexes together.
     // Removes unused vertices if indices were provided.
@@ -132,6 +154,26 @@ class LLMeshOptimizer
         U64 target_index_count,
         F32 target_error,
         bool sloppy,
+        F32* result_error,
+        bool lock_border = false);
+
+    // Like simplifyU32, but normals and texture coordinates count towards
+    // the error, so collapses that would smear shading or tear uv seams
+    // are made last. A weight of 0 or a NULL array leaves an attribute out.
+    // lock_border keeps the open edges of the mesh in place.
+    static U64 simplifyWithAttributesU32(
+        U32 *destination,
+        const U32 *indices,
+        U64 index_count,
+        const LLVector4a *vertex_positions,
+        const LLVector4a *normals,
+        const LLVector2 *text_coords,
+        U64 vertex_count,
+        F32 normal_weight,
+        F32 uv_weight,
+        U64 target_index_count,
+        F32 target_error,
+        bool lock_border,
         F32* result_error);
 
     // Returns amount of indices in destiantion
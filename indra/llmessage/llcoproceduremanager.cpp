@@ -32,10 +32,12 @@
 #include "llcoproceduremanager.h"
 
 #include <chrono>
+#include <set>
 
 #include <boost/fiber/buffered_channel.hpp>
 
 #include "llexception.h"
+#include "lltimer.h"
 #include "stringize.h"
 
 //=========================================================================
@@ -57,6 +59,8 @@ class LLCoprocedurePool: private boost::noncopyable
 {
 public:
     typedef LLCoprocedureManager::CoProcedure_t CoProcedure_t;
+    typedef LLCoprocedureManager::BatchCallback_t BatchCallback_t;
+    typedef LLCoprocedureManager::BatchProc_t BatchProc_t;
 
     LLCoprocedurePool(const std::string &name, size_t size);
     ~LLCoprocedurePool() = default;
@@ -92,7 +96,53 @@ class LLCoprocedurePool: private boost::noncopyable
 
     void close();
 
+    void registerBatch(const std::string &batch, BatchProc_t proc, size_t max_size, F32 window);
+    bool enqueueBatched(const std::string &batch, const std::string &target,
+                        const LLSD &key, BatchCallback_t callback);
+
 private:
+    struct BatchType
+    {
+        BatchProc_t mProc;
+        size_t      mMaxSize;
+        F32         mWindow;
+    };
+
+    // Keys collected for one batch type and target.  Detached from
+    // mOpenBatches once full or once its coprocedure starts sending,
+    // after which new keys go to a fresh batch.
+    struct OpenBatch
+    {
+        typedef std::shared_ptr<OpenBatch> ptr_t;
+
+        OpenBatch(const std::string &batch, const std::string &target) :
+            mBatch(batch),
+            mTarget(target),
+            mKeys(LLSD::emptyArray())
+        {}
+
+        std::string mBatch;
+        std::string mTarget;
+        LLSD        mKeys;
+        std::map<std::string, std::vector<BatchCallback_t> > mCallbacks;
+        LLTimer     mOpened;
+    };
+
+    typedef std::pair<std::string, std::string> BatchKey_t;
+    typedef std::map<std::string, BatchType> BatchTypeMap_t;
+    typedef std::map<BatchKey_t, OpenBatch::ptr_t> OpenBatchMap_t;
+
+    BatchTypeMap_t  mBatchTypes;
+    OpenBatchMap_t  mOpenBatches;
+    // Every batch whose request hasn't been issued yet, open or not.
+    // close() fails them, their coprocedures would never run.
+    std::set<OpenBatch::ptr_t> mUnsentBatches;
+
+    void sendBatch(LLCoreHttpUtil::HttpCoroutineAdapter::ptr_t &httpAdapter, OpenBatch::ptr_t batch);
+    void detachBatch(const OpenBatch::ptr_t &batch);
+    void failUnsentBatches();
+    static void deliverResults(const OpenBatch &batch, const LLSD &results);
+
     struct QueuedCoproc
     {
         typedef std::shared_ptr<QueuedCoproc> ptr_t;
@@ -199,6 +249,32 @@ LLUUID LLCoprocedureManager::enqueueCoprocedure(const std::string &pool, const s
     return targetPool->enqueueCoprocedure(name, proc);
 }
 
+void LLCoprocedureManager::registerBatch(const std::string &pool, const std::string &batch, BatchProc_t proc,
+                                         size_t max_size, F32 window)
+{
+    poolMap_t::iterator it = mPoolMap.find(pool);
+
+    if (it == mPoolMap.end())
+    {
+        LL_ERRS() << "Uninitialized pool " << pool << LL_ENDL;
+    }
+
+    it->second->registerBatch(batch, proc, max_size, window);
+}
+
+bool LLCoprocedureManager::enqueueBatched(const std::string &pool, const std::string &batch, const std::string &target,
+                                          const LLSD &key, BatchCallback_t callback)
+{
+    poolMap_t::iterator it = mPoolMap.find(pool);
+
+    if (it == mPoolMap.end())
+    {
+        LL_ERRS() << "Uninitialized pool " << pool << LL_ENDL;
+    }
+
+    return it->second->enqueueBatched(batch, target, key, callback);
+}
+
 void LLCoprocedureManager::setPropertyMethods(SettingQuery_t queryfn, SettingUpdate_t updatefn)
 {
     // functions to discover and store the pool sizes
@@ -306,7 +382,7 @@ LLCoprocedurePool::LLCoprocedurePool(const std::string &poolName, size_t size):
         // Monitores application status
         mStatusListener = LLEventPumps::instance().obtain("LLApp").listen(
             poolName + "_pool", // Make sure it won't repeat names from lleventcoro
-            [pendingCoprocs = mPendingCoprocs, poolName](const LLSD& status)
+            [this, poolName](const LLSD& status)
         {
             auto& statsd = status["status"];
             if (statsd.asString() != "running")
@@ -316,7 +392,7 @@ LLCoprocedurePool::LLCoprocedurePool(const std::string &poolName, size_t size):
                                       << LL_ENDL;
                 // This should ensure that all waiting coprocedures in this
                 // pool will wake up and terminate.
-                pendingCoprocs->close();
+                close();
             }
             return false;
         });
@@ -472,4 +548,153 @@ void LLCoprocedurePool::coprocedureInvokerCoro(
 void LLCoprocedurePool::close()
 {
     mPendingCoprocs->close();
+    failUnsentBatches();
+}
+
+//-------------------------------------------------------------------------
+void LLCoprocedurePool::registerBatch(const std::string &batch, BatchProc_t proc, size_t max_size, F32 window)
+{
+    BatchType &type = mBatchTypes[batch];
+    type.mProc = proc;
+    type.mMaxSize = llmax(max_size, size_t(1));
+    type.mWindow = llmax(window, 0.f);
+}
+
+bool LLCoprocedurePool::enqueueBatched(const std::string &batch, const std::string &target,
+                                       const LLSD &key, BatchCallback_t callback)
+{
+    BatchTypeMap_t::const_iterator type_it = mBatchTypes.find(batch);
+    if (type_it == mBatchTypes.end())
+    {
+        LL_WARNS("CoProcMgr") << "Batch '" << batch << "' not registered in pool \"" << mPoolName << "\"" << LL_ENDL;
+        return false;
+    }
+    const BatchType &type = type_it->second;
+
+    const BatchKey_t batch_key(batch, target);
+    OpenBatch::ptr_t open_batch;
+    OpenBatchMap_t::iterator it = mOpenBatches.find(batch_key);
+    if (it != mOpenBatches.end())
+    {
+        open_batch = it->second;
+    }
+    else
+    {
+        // Queue the coprocedure that will send this batch right away.
+        // Keys keep arriving until a pool coroutine picks it up (and
+        // the window, if any, has passed).
+        open_batch = std::make_shared<OpenBatch>(batch, target);
+        LLUUID id = enqueueCoprocedure(batch,
+            [this, open_batch](LLCoreHttpUtil::HttpCoroutineAdapter::ptr_t &httpAdapter, const LLUUID &)
+            {
+                sendBatch(httpAdapter, open_batch);
+            });
+        if (id.isNull())
+        {
+            return false;
+        }
+        mOpenBatches.emplace(batch_key, open_batch);
+        mUnsentBatches.insert(open_batch);
+    }
+
+    const std::string key_string(key.asString());
+    std::vector<BatchCallback_t> &callbacks = open_batch->mCallbacks[key_string];
+    if (callbacks.empty())
+    {
+        open_batch->mKeys.append(key);
+    }
+    callbacks.push_back(callback);
+
+    if (open_batch->mKeys.size() >= type.mMaxSize)
+    {
+        // Full, later keys start a new batch
+        detachBatch(open_batch);
+    }
+    return true;
+}
+
+void LLCoprocedurePool::detachBatch(const OpenBatch::ptr_t &batch)
+{
+    OpenBatchMap_t::iterator it = mOpenBatches.find(BatchKey_t(batch->mBatch, batch->mTarget));
+    if (it != mOpenBatches.end() && it->second == batch)
+    {
+        mOpenBatches.erase(it);
+    }
+}
+
+void LLCoprocedurePool::sendBatch(LLCoreHttpUtil::HttpCoroutineAdapter::ptr_t &httpAdapter, OpenBatch::ptr_t batch)
+{
+    BatchTypeMap_t::const_iterator type_it = mBatchTypes.find(batch->mBatch);
+    if (type_it == mBatchTypes.end())
+    {
+        return;
+    }
+    const BatchType &type = type_it->second;
+
+    // Hold the batch open for the rest of its window unless it
+    // has already filled up.
+    OpenBatchMap_t::const_iterator it = mOpenBatches.find(BatchKey_t(batch->mBatch, batch->mTarget));
+    if (it != mOpenBatches.end() && it->second == batch)
+    {
+        F32 remaining = type.mWindow - batch->mOpened.getElapsedTimeF32();
+        if (remaining > 0.f)
+        {
+            llcoro::suspendUntilTimeout(remaining);
+        }
+    }
+    detachBatch(batch);
+    if (!mUnsentBatches.erase(batch))
+    {
+        // Already failed by close()
+        return;
+    }
+
+    LL_DEBUGS("CoProcMgr") << "Sending batch '" << batch->mBatch << "' of " << batch->mKeys.size()
+                           << " keys in pool \"" << mPoolName << "\"" << LL_ENDL;
+
+    LLSD results;
+    try
+    {
+        results = type.mProc(httpAdapter, batch->mTarget, batch->mKeys);
+    }
+    catch (const LLCoros::Stop &)
+    {
+        deliverResults(*batch, LLSD());
+        throw;
+    }
+    catch (...)
+    {
+        // Still fan out below so every caller hears about the failure
+        LOG_UNHANDLED_EXCEPTION(STRINGIZE("Batch('" << batch->mBatch << "') in pool '" << mPoolName << "'"));
+        results = LLSD();
+    }
+
+    deliverResults(*batch, results);
+}
+
+void LLCoprocedurePool::failUnsentBatches()
+{
+    // Callbacks may enqueue again, which the closed pool refuses
+    std::set<OpenBatch::ptr_t> unsent;
+    unsent.swap(mUnsentBatches);
+    mOpenBatches.clear();
+    for (const OpenBatch::ptr_t &batch : unsent)
+    {
+        LL_DEBUGS("CoProcMgr") << "Failing unsent batch '" << batch->mBatch << "' of " << batch->mKeys.size()
+                               << " keys in pool \"" << mPoolName << "\"" << LL_ENDL;
+        deliverResults(*batch, LLSD());
+    }
+}
+
+//static
+void LLCoprocedurePool::deliverResults(const OpenBatch &batch, const LLSD &results)
+{
+    for (const auto &entry : batch.mCallbacks)
+    {
+        const LLSD result = results.has(entry.first) ? results[entry.first] : LLSD();
+        for (const BatchCallback_t &callback : entry.second)
+        {
+            callback(result);
+        }
+    }
 }
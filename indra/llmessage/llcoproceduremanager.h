@@ -54,6 +54,42 @@ class LLCoprocedureManager final : public LLSingleton < LLCoprocedureManager >
     /// @return This method returns a UUID that can be used later to cancel execution.
     LLUUID enqueueCoprocedure(const std::string &pool, const std::string &name, CoProcedure_t proc);
 
+    /// Batched requests.  Many callers need one small answer per key (an
+    /// object id, an experience id...) from a capability that will take
+    /// the keys in bulk.  Rather than one coprocedure per key, register a
+    /// batch procedure on the pool and enqueue keys against it.  Keys for
+    /// the same batch and target (usually a capability URL) are collected
+    /// until the batch reaches its size limit or its window expires, then
+    /// the procedure runs once in the pool for the lot.
+    ///
+    /// The procedure receives the keys as an LLSD array and returns an
+    /// LLSD map of per-key results keyed by each key's string form.  Each
+    /// caller's callback gets its key's entry, or an undefined LLSD if the
+    /// request failed, the result had no entry for it or the pool closed
+    /// before the batch was sent.  A key enqueued
+    /// again while its batch is still open is only sent once; every
+    /// callback waiting on it receives the result.
+    typedef boost::function<void(const LLSD &result)> BatchCallback_t;
+    typedef boost::function<LLSD(LLCoreHttpUtil::HttpCoroutineAdapter::ptr_t &, const std::string &target, const LLSD &keys)> BatchProc_t;
+
+    /// Register a batch procedure on a pool.
+    ///
+    /// @param pool   An initialized pool.
+    /// @param batch  Name identifying the batch procedure within the pool.
+    /// @param proc   Issues one request for a batch of keys.
+    /// @param max_size Most keys sent in one batch.
+    /// @param window Seconds to wait for more keys after a batch opens.
+    ///               Zero sends as soon as a pool coroutine is free, which
+    ///               still collects everything enqueued in the meantime.
+    void registerBatch(const std::string &pool, const std::string &batch, BatchProc_t proc,
+                       size_t max_size, F32 window);
+
+    /// Add a key to the open batch for batch/target, opening one if needed.
+    ///
+    /// @return false if the batch isn't registered or the pool is closed.
+    bool enqueueBatched(const std::string &pool, const std::string &batch, const std::string &target,
+                        const LLSD &key, BatchCallback_t callback);
+
     /// Cancel a coprocedure. If the coprocedure is already being actively executed
     /// this method calls cancelYieldingOperation() on the associated HttpAdapter
     /// If it has not yet been dequeued it is simply removed from the queue.
@@ -0,0 +1,183 @@
+/**
+ * @file llmessagecapture.cpp
+ * @brief Recording of raw lludp traffic to a replayable capture file.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "llmessagecapture.h"
+
+#include "lltimer.h"
+#include "net.h"
+
+static const char CAPTURE_MAGIC[8] = { 'L', 'L', 'M', 'S', 'G', 'C', 'A', 'P' };
+
+namespace
+{
+    template<typename T>
+    void write_value(LLFILE* fp, const T& value)
+    {
+        fwrite(&value, sizeof(T), 1, fp);
+    }
+
+    template<typename T>
+    bool read_value(LLFILE* fp, T& value)
+    {
+        return fread(&value, sizeof(T), 1, fp) == 1;
+    }
+}
+
+/* static */
+LLFILE* LLMessageCapture::sFile = nullptr;
+/* static */
+U64 LLMessageCapture::sStartTime = 0;
+/* static */
+U32 LLMessageCapture::sRecordCount = 0;
+
+/* static */
+bool LLMessageCapture::start(const std::string& filename)
+{
+    stop();
+
+    sFile = LLFile::fopen(filename, "wb");
+    if (!sFile)
+    {
+        LL_WARNS("Messaging") << "Unable to open message capture file " << filename << LL_ENDL;
+        return false;
+    }
+
+    fwrite(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC), 1, sFile);
+    write_value(sFile, CAPTURE_VERSION);
+
+    sStartTime = LLTimer::getTotalTime();
+    sRecordCount = 0;
+    LL_INFOS("Messaging") << "Capturing message traffic to " << filename << LL_ENDL;
+    return true;
+}
+
+/* static */
+void LLMessageCapture::stop()
+{
+    if (sFile)
+    {
+        LLFile::close(sFile);
+        sFile = nullptr;
+        LL_INFOS("Messaging") << "Message capture stopped after " << sRecordCount << " packets" << LL_ENDL;
+    }
+}
+
+/* static */
+void LLMessageCapture::capture(bool inbound, const LLHost& sender, const LLHost& receiver,
+                               U32 circuit_code, bool trusted, const U8* data, S32 data_size)
+{
+    if (!sFile || !data || data_size <= 0) return;
+
+    U8 flags = 0;
+    if (inbound) flags |= LLMessageCaptureRecord::FLAG_INBOUND;
+    if (trusted) flags |= LLMessageCaptureRecord::FLAG_TRUSTED;
+
+    write_value(sFile, (U64)(LLTimer::getTotalTime() - sStartTime));
+    write_value(sFile, (U32)sender.getAddress());
+    write_value(sFile, (U16)sender.getPort());
+    write_value(sFile, (U32)receiver.getAddress());
+    write_value(sFile, (U16)receiver.getPort());
+    write_value(sFile, circuit_code);
+    write_value(sFile, flags);
+    write_value(sFile, (U32)data_size);
+    fwrite(data, 1, data_size, sFile);
+
+    ++sRecordCount;
+}
+
+LLMessageCaptureReader::LLMessageCaptureReader()
+:   mFile(nullptr)
+{
+}
+
+LLMessageCaptureReader::~LLMessageCaptureReader()
+{
+    close();
+}
+
+bool LLMessageCaptureReader::open(const std::string& filename)
+{
+    close();
+
+    mFile = LLFile::fopen(filename, "rb");
+    if (!mFile)
+    {
+        LL_WARNS("Messaging") << "Unable to open message capture file " << filename << LL_ENDL;
+        return false;
+    }
+
+    char magic[sizeof(CAPTURE_MAGIC)];
+    U32 version = 0;
+    if (fread(magic, sizeof(magic), 1, mFile) != 1
+        || memcmp(magic, CAPTURE_MAGIC, sizeof(magic)) != 0
+        || !read_value(mFile, version))
+    {
+        LL_WARNS("Messaging") << filename << " is not a message capture file" << LL_ENDL;
+        close();
+        return false;
+    }
+
+    if (version != LLMessageCapture::CAPTURE_VERSION)
+    {
+        LL_WARNS("Messaging") << "Unsupported message capture version " << version
+                              << " in " << filename << LL_ENDL;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void LLMessageCaptureReader::close()
+{
+    if (mFile)
+    {
+        LLFile::close(mFile);
+        mFile = nullptr;
+    }
+}
+
+bool LLMessageCaptureReader::readRecord(LLMessageCaptureRecord& record)
+{
+    if (!mFile) return false;
+
+    U32 sender_ip = 0, receiver_ip = 0, data_size = 0;
+    U16 sender_port = 0, receiver_port = 0;
+    if (!read_value(mFile, record.mTimestamp)
+        || !read_value(mFile, sender_ip)
+        || !read_value(mFile, sender_port)
+        || !read_value(mFile, receiver_ip)
+        || !read_value(mFile, receiver_port)
+        || !read_value(mFile, record.mCircuitCode)
+        || !read_value(mFile, record.mFlags)
+        || !read_value(mFile, data_size))
+    {
+        return false;
+    }
+
+    if (data_size > NET_BUFFER_SIZE)
+    {
+        LL_WARNS("Messaging") << "Corrupt message capture record of " << data_size << " bytes" << LL_ENDL;
+        return false;
+    }
+
+    record.mSender = LLHost(sender_ip, sender_port);
+    record.mReceiver = LLHost(receiver_ip, receiver_port);
+    record.mData.resize(data_size);
+    return data_size == 0 || fread(record.mData.data(), 1, data_size, mFile) == data_size;
+}
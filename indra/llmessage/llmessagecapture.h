@@ -0,0 +1,115 @@
+/**
+ * @file llmessagecapture.h
+ * @brief Recording of raw lludp traffic to a replayable capture file.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMESSAGECAPTURE_H
+#define LL_LLMESSAGECAPTURE_H
+
+#include "llhost.h"
+#include "llfile.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief One packet as stored in a capture file.
+ *
+ * The payload is the packet exactly as it appeared on the wire: still
+ * zero-coded and, for inbound packets, with any appended acks in place.
+ */
+struct LLMessageCaptureRecord
+{
+    enum ERecordFlags
+    {
+        FLAG_INBOUND = 1 << 0,  // packet was received, not sent
+        FLAG_TRUSTED = 1 << 1,  // remote circuit was trusted at capture time
+    };
+
+    LLMessageCaptureRecord()
+    :   mTimestamp(0)
+    ,   mCircuitCode(0)
+    ,   mFlags(0)
+    {}
+
+    bool isInbound() const { return (mFlags & FLAG_INBOUND) != 0; }
+    bool isTrusted() const { return (mFlags & FLAG_TRUSTED) != 0; }
+    /// The far end of the circuit, whichever direction the packet travelled
+    const LLHost& getRemoteHost() const { return isInbound() ? mSender : mReceiver; }
+
+    U64 mTimestamp;         // microseconds since the capture was started
+    LLHost mSender;
+    LLHost mReceiver;
+    U32 mCircuitCode;
+    U8 mFlags;
+    std::vector<U8> mData;
+};
+
+/**
+ * @brief Static class writing lludp traffic to a capture file
+ *
+ * File layout (native little-endian):
+ *   header: "LLMSGCAP" magic, U32 version
+ *   record: U64 timestamp, U32 sender ip, U16 sender port,
+ *           U32 receiver ip, U16 receiver port, U32 circuit code,
+ *           U8 flags, U32 data size, data bytes
+ *
+ * Only called from the thread that owns gMessageSystem.
+ */
+class LLMessageCapture
+{
+public:
+    static const U32 CAPTURE_VERSION = 1;
+
+    /// Begin writing packets to filename, truncating it. Returns false on failure.
+    static bool start(const std::string& filename);
+    /// Flush and close the capture file
+    static void stop();
+    static bool isCapturing() { return sFile != nullptr; }
+
+    static void capture(bool inbound, const LLHost& sender, const LLHost& receiver,
+                        U32 circuit_code, bool trusted, const U8* data, S32 data_size);
+
+    static U32 getRecordCount() { return sRecordCount; }
+
+private:
+    static LLFILE* sFile;
+    static U64 sStartTime;
+    static U32 sRecordCount;
+};
+
+/**
+ * @brief Sequential reader for files written by LLMessageCapture
+ */
+class LLMessageCaptureReader
+{
+public:
+    LLMessageCaptureReader();
+    ~LLMessageCaptureReader();
+
+    /// Open filename and validate its header
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const { return mFile != nullptr; }
+
+    /// Read the next record; returns false at end of file or on a truncated record
+    bool readRecord(LLMessageCaptureRecord& record);
+
+private:
+    LLFILE* mFile;
+};
+
+#endif // LL_LLMESSAGECAPTURE_H
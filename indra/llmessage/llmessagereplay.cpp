@@ -0,0 +1,190 @@
+/**
+ * @file llmessagereplay.cpp
+ * @brief Offline replay of captured lludp traffic through LLMessageSystem.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "llmessagereplay.h"
+
+#include "llmessagecapture.h"
+#include "lltimer.h"
+#include "message.h"
+
+LLMessageReplay::LLMessageReplay()
+:   mLastDispatchName(nullptr)
+,   mLastDispatchTime(0.0)
+,   mPacketsReplayed(0)
+,   mPacketsRejected(0)
+,   mTotalTime(0.0)
+,   mRealtime(false)
+{
+}
+
+bool LLMessageReplay::replay(const std::string& filename)
+{
+    if (!gMessageSystem)
+    {
+        LL_WARNS("Messaging") << "Cannot replay " << filename << " without a message system" << LL_ENDL;
+        return false;
+    }
+
+    LLMessageCaptureReader reader;
+    if (!reader.open(filename))
+    {
+        return false;
+    }
+
+    mStats.clear();
+    mPacketsReplayed = 0;
+    mPacketsRejected = 0;
+
+    // Borrow the timing hook for the duration of the replay
+    LLMessageSystem::msg_timing_callback old_callback = gMessageSystem->getTimingCallback();
+    void* old_callback_data = gMessageSystem->getTimingCallbackData();
+    gMessageSystem->setTimingFunc(&LLMessageReplay::timingCallback, this);
+
+    LLTimer total_timer;
+    LLMessageCaptureRecord record;
+    U64 last_timestamp = 0;
+    bool first = true;
+    while (reader.readRecord(record))
+    {
+        if (!record.isInbound())
+        {
+            continue;
+        }
+
+        if (mRealtime && !first && record.mTimestamp > last_timestamp)
+        {
+            ms_sleep((U32)((record.mTimestamp - last_timestamp) / 1000));
+        }
+        first = false;
+        last_timestamp = record.mTimestamp;
+
+        replayRecord(record);
+    }
+    mTotalTime = total_timer.getElapsedTimeF64();
+
+    gMessageSystem->setTimingFunc(old_callback, old_callback_data);
+
+    // Don't leave the captured hosts pinged and timing out afterwards
+    for (const LLHost& host : mEnabledCircuits)
+    {
+        gMessageSystem->disableCircuit(host);
+    }
+    mEnabledCircuits.clear();
+
+    LL_INFOS("Messaging") << "Replayed " << mPacketsReplayed << " packets from " << filename
+                          << " in " << mTotalTime << "s, " << mPacketsRejected << " rejected" << LL_ENDL;
+    return true;
+}
+
+void LLMessageReplay::replayRecord(const LLMessageCaptureRecord& record)
+{
+    const LLHost& host = record.mSender;
+    S32 size = (S32)record.mData.size();
+    if (size < LL_MINIMUM_VALID_PACKET_SIZE || size > MAX_BUFFER_SIZE)
+    {
+        ++mPacketsRejected;
+        return;
+    }
+
+    if (!gMessageSystem->mCircuitInfo.findCircuit(host))
+    {
+        gMessageSystem->enableCircuit(host, record.isTrusted());
+        mEnabledCircuits.insert(host);
+    }
+
+    U8 buffer[MAX_BUFFER_SIZE];
+    memcpy(buffer, record.mData.data(), size);
+
+    // checkMessages() leaves appended acks in place for faked messages,
+    // so strip them here to hand it the same bytes a live receive would decode.
+    if (buffer[0] & LL_ACK_FLAG)
+    {
+        S32 acks = buffer[size - 1];
+        S32 stripped_size = size - 1 - acks * (S32)sizeof(TPACKETID);
+        if (stripped_size < LL_MINIMUM_VALID_PACKET_SIZE)
+        {
+            ++mPacketsRejected;
+            return;
+        }
+        size = stripped_size;
+        buffer[0] &= ~LL_ACK_FLAG;
+    }
+
+    mLastDispatchName = nullptr;
+    mLastDispatchTime = 0.0;
+
+    LLTimer timer;
+    bool valid = false;
+    {
+        LockMessageChecker lmc(gMessageSystem);
+        valid = lmc.checkMessages(0, true, buffer, host, size);
+    }
+    F64 elapsed = timer.getElapsedTimeF64();
+
+    if (!valid || !mLastDispatchName)
+    {
+        ++mPacketsRejected;
+        return;
+    }
+    ++mPacketsReplayed;
+
+    MessageStats& stats = mStats[mLastDispatchName];
+    stats.mCount++;
+    stats.mDispatchTime += mLastDispatchTime;
+    stats.mDecodeTime += llmax(elapsed - mLastDispatchTime, 0.0);
+    stats.mMaxTime = llmax(stats.mMaxTime, elapsed);
+}
+
+// static
+void LLMessageReplay::timingCallback(const char* hashed_name, F32 time, void* data)
+{
+    LLMessageReplay* self = static_cast<LLMessageReplay*>(data);
+    self->mLastDispatchName = hashed_name;
+    self->mLastDispatchTime = time;
+}
+
+LLSD LLMessageReplay::asLLSD() const
+{
+    LLSD result = LLSD::emptyMap();
+    for (const auto& [name, stats] : mStats)
+    {
+        LLSD entry;
+        entry["count"] = (LLSD::Integer)stats.mCount;
+        entry["decode_seconds"] = stats.mDecodeTime;
+        entry["dispatch_seconds"] = stats.mDispatchTime;
+        entry["max_seconds"] = stats.mMaxTime;
+        result[name] = entry;
+    }
+    return result;
+}
+
+void LLMessageReplay::dumpStats() const
+{
+    LL_INFOS("Messaging") << llformat("%-32s %8s %12s %12s %10s", "Message", "Count", "Decode(us)", "Dispatch(us)", "Max(us)") << LL_ENDL;
+    for (const auto& [name, stats] : mStats)
+    {
+        F64 count = llmax((F64)stats.mCount, 1.0);
+        LL_INFOS("Messaging") << llformat("%-32s %8u %12.2f %12.2f %10.2f",
+                                          name.c_str(),
+                                          stats.mCount,
+                                          stats.mDecodeTime * 1000000.0 / count,
+                                          stats.mDispatchTime * 1000000.0 / count,
+                                          stats.mMaxTime * 1000000.0) << LL_ENDL;
+    }
+}
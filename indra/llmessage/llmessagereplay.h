@@ -0,0 +1,95 @@
+/**
+ * @file llmessagereplay.h
+ * @brief Offline replay of captured lludp traffic through LLMessageSystem.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMESSAGEREPLAY_H
+#define LL_LLMESSAGEREPLAY_H
+
+#include "llhost.h"
+#include "llsd.h"
+
+#include <map>
+#include <set>
+#include <string>
+
+struct LLMessageCaptureRecord;
+
+/**
+ * @brief Headless driver feeding a capture file back through gMessageSystem
+ *
+ * Inbound packets are pushed through LLMessageSystem::checkMessages() as
+ * faked messages so that the regular template reader, circuit bookkeeping
+ * and registered handlers all run. Circuits seen in the capture are enabled
+ * before their first packet is replayed and those the replay enabled are
+ * disabled again when it is done. Outbound packets are skipped.
+ *
+ * Per message type it records how long the template reader spent decoding
+ * and how long the registered handler took, using the message system timing
+ * callback for the dispatch half.
+ */
+class LLMessageReplay
+{
+public:
+    struct MessageStats
+    {
+        MessageStats()
+        :   mCount(0)
+        ,   mDecodeTime(0.0)
+        ,   mDispatchTime(0.0)
+        ,   mMaxTime(0.0)
+        {}
+
+        U32 mCount;
+        F64 mDecodeTime;    // seconds, summed
+        F64 mDispatchTime;  // seconds, summed
+        F64 mMaxTime;       // seconds, worst single decode + dispatch
+    };
+    typedef std::map<std::string, MessageStats> stats_map_t;
+
+    LLMessageReplay();
+
+    /// When true, sleep between packets to reproduce the captured pacing.
+    /// Off by default so that replays are as fast and repeatable as possible.
+    void setRealtime(bool realtime) { mRealtime = realtime; }
+
+    /// Replay every inbound packet in filename. Requires gMessageSystem.
+    bool replay(const std::string& filename);
+
+    const stats_map_t& getStats() const { return mStats; }
+    U32 getPacketsReplayed() const { return mPacketsReplayed; }
+    U32 getPacketsRejected() const { return mPacketsRejected; }
+    F64 getTotalTime() const { return mTotalTime; }
+
+    /// Stats as a map keyed by message name, for saving alongside benchmark results
+    LLSD asLLSD() const;
+    void dumpStats() const;
+
+private:
+    void replayRecord(const LLMessageCaptureRecord& record);
+    static void timingCallback(const char* hashed_name, F32 time, void* data);
+
+    stats_map_t mStats;
+    std::set<LLHost> mEnabledCircuits;
+    const char* mLastDispatchName;
+    F64 mLastDispatchTime;
+    U32 mPacketsReplayed;
+    U32 mPacketsRejected;
+    F64 mTotalTime;
+    bool mRealtime;
+};
+
+#endif // LL_LLMESSAGEREPLAY_H
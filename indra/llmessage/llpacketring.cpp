@@ -42,6 +42,7 @@
 #include "llrand.h"
 #include "message.h"
 #include "u64.h"
+#include "llmessagecapture.h"
 #include "llmessagelog.h"
 
 ///////////////////////////////////////////////////////////
@@ -275,6 +276,12 @@ BOOL LLPacketRing::sendPacket(int h_socket, char * send_buffer, S32 buf_size, co
 {
 #define LOCALHOST_ADDR 16777343
     LLMessageLog::log(LLHost(LOCALHOST_ADDR, gMessageSystem->getListenPort()), host, (U8*)send_buffer, buf_size);
+    if (LLMessageCapture::isCapturing())
+    {
+        LLCircuitData* cdp = gMessageSystem->mCircuitInfo.findCircuit(host);
+        LLMessageCapture::capture(false, LLHost(LOCALHOST_ADDR, gMessageSystem->getListenPort()), host,
+                                  gMessageSystem->findCircuitCode(host), cdp && cdp->getTrusted(), (U8*)send_buffer, buf_size);
+    }
 #undef LOCALHOST_ADDR
     BOOL status = TRUE;
     if (!mUseOutThrottle)
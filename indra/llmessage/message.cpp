@@ -80,6 +80,7 @@
 #include "lltransfertargetvfile.h"
 #include "llcorehttputil.h"
 #include "llrand.h"
+#include "llmessagecapture.h"
 #include "llmessagelog.h"
 #include "llpounceable.h"
 
@@ -538,6 +539,12 @@ BOOL LLMessageSystem::checkMessages(LockMessageChecker&, S64 frame_count,
         {
 #define LOCALHOST_ADDR 16777343
             LLMessageLog::log(mLastSender, LLHost(LOCALHOST_ADDR, mPort), buffer, mTrueReceiveSize);
+            if (LLMessageCapture::isCapturing())
+            {
+                LLCircuitData* capture_cdp = mCircuitInfo.findCircuit(mLastSender);
+                LLMessageCapture::capture(true, mLastSender, LLHost(LOCALHOST_ADDR, mPort), findCircuitCode(mLastSender),
+                                          capture_cdp && capture_cdp->getTrusted(), buffer, mTrueReceiveSize);
+            }
 #undef LOCALHOST_ADDR
         }
 
@@ -29,6 +29,7 @@
 #include "llwin32headers.h"
 
 #include "linden_common.h"
+#include "lleventcoro.h"
 #include "llsdserialize.h"
 
 #include "../llcoproceduremanager.h"
@@ -182,4 +183,133 @@ namespace tut
         LL_INFOS("CoMain") << "checking count" << LL_ENDL;
         ensure_equals("coprocedure failed to update counter", counter, 5);
     }
+
+    template<> template<>
+    void coproceduremanager_object_t::test<5>()
+    {
+        set_test_name("batched keys are coalesced");
+
+        Sync sync;
+        LLCoprocedureManager &mgr(LLCoprocedureManager::instance());
+        mgr.initializePool("BatchPool");
+
+        int calls = 0;
+        LLSD sent;
+        mgr.registerBatch("BatchPool", "Lookup",
+            [&calls, &sent, &sync](LLCoreHttpUtil::HttpCoroutineAdapter::ptr_t &, const std::string &target, const LLSD &keys)
+            {
+                ++calls;
+                sent = keys;
+                LLSD results;
+                results["a"] = target + "-a";
+                // no entry for "b"
+                sync.bump();
+                return results;
+            },
+            10, 0.f);
+
+        std::vector<LLSD> results(3);
+        ensure("enqueue a", mgr.enqueueBatched("BatchPool", "Lookup", "cap", "a",
+            [&results](const LLSD &result) { results[0] = result; }));
+        ensure("enqueue b", mgr.enqueueBatched("BatchPool", "Lookup", "cap", "b",
+            [&results](const LLSD &result) { results[1] = result; }));
+        ensure("enqueue a again", mgr.enqueueBatched("BatchPool", "Lookup", "cap", "a",
+            [&results](const LLSD &result) { results[2] = result; }));
+        ensure("unregistered batch", !mgr.enqueueBatched("BatchPool", "Bogus", "cap", "a",
+            [](const LLSD &) {}));
+
+        sync.yield();
+        ensure_equals("one request", calls, 1);
+        ensure_equals("duplicate key sent once", sent.size(), 2);
+        ensure_equals("first result", results[0].asString(), "cap-a");
+        ensure("missing result undefined", results[1].isUndefined());
+        ensure_equals("duplicate result", results[2].asString(), "cap-a");
+
+        mgr.close("BatchPool");
+    }
+
+    template<> template<>
+    void coproceduremanager_object_t::test<6>()
+    {
+        set_test_name("batches split at max size");
+
+        Sync sync;
+        LLCoprocedureManager &mgr(LLCoprocedureManager::instance());
+        mgr.initializePool("SplitPool");
+
+        std::vector<size_t> sizes;
+        mgr.registerBatch("SplitPool", "Lookup",
+            [&sizes, &sync](LLCoreHttpUtil::HttpCoroutineAdapter::ptr_t &, const std::string &, const LLSD &keys)
+            {
+                sizes.push_back(keys.size());
+                sync.bump();
+                return LLSD();
+            },
+            2, 0.f);
+
+        int failures = 0;
+        for (int i = 0; i < 5; ++i)
+        {
+            mgr.enqueueBatched("SplitPool", "Lookup", "cap", i,
+                [&failures](const LLSD &result) { if (result.isUndefined()) ++failures; });
+        }
+
+        sync.yield(3);
+        ensure_equals("batch count", sizes.size(), size_t(3));
+        ensure_equals("first batch", sizes[0], size_t(2));
+        ensure_equals("second batch", sizes[1], size_t(2));
+        ensure_equals("last batch", sizes[2], size_t(1));
+        ensure_equals("every caller told of failure", failures, 5);
+
+        mgr.close("SplitPool");
+    }
+
+    template<> template<>
+    void coproceduremanager_object_t::test<7>()
+    {
+        set_test_name("closing fails unsent batches");
+
+        LLCoprocedureManager &mgr(LLCoprocedureManager::instance());
+        mgr.initializePool("ClosePool");
+
+        int calls = 0;
+        mgr.registerBatch("ClosePool", "Lookup",
+            [&calls](LLCoreHttpUtil::HttpCoroutineAdapter::ptr_t &, const std::string &, const LLSD &)
+            {
+                ++calls;
+                return LLSD();
+            },
+            2, 0.f);
+
+        // Nothing yields before close(), so neither the full batch nor
+        // the open one is picked up by the pool
+        std::vector<int> told(3, 0);
+        int failures = 0;
+        for (int i = 0; i < 3; ++i)
+        {
+            ensure("enqueue", mgr.enqueueBatched("ClosePool", "Lookup", "cap", i,
+                [&told, &failures, i](const LLSD &result)
+                {
+                    ++told[i];
+                    if (result.isUndefined()) ++failures;
+                }));
+        }
+        ensure_equals("nothing sent yet", calls, 0);
+
+        mgr.close("ClosePool");
+        ensure_equals("every caller told of failure", failures, 3);
+        ensure("enqueue after close", !mgr.enqueueBatched("ClosePool", "Lookup", "cap", 3,
+            [](const LLSD &) {}));
+
+        // Let the pool coroutines drain what was queued
+        for (int i = 0; i < 10; ++i)
+        {
+            llcoro::suspend();
+        }
+        ensure_equals("never sent", calls, 0);
+        for (int i = 0; i < 3; ++i)
+        {
+            ensure_equals("told once", told[i], 1);
+        }
+    }
 }  // namespace tut
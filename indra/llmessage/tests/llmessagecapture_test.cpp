@@ -0,0 +1,183 @@
+/**
+ * @file llmessagecapture_test.cpp
+ * @brief LLMessageCapture and LLMessageCaptureReader test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llmessagecapture.h"
+#include "../llmessagereplay.h"
+#include "../message.h"
+#include "../net.h"
+
+#include "lltimer.h"
+
+#include "../test/lltut.h"
+#include "../test/namedtempfile.h"
+
+namespace
+{
+    // Just the one message the replay test sends to itself
+    const char* REPLAY_TEMPLATE =
+        "version 2.0\n"
+        "{\n"
+        "    TestMessage Low 1 NotTrusted Unencoded\n"
+        "    {\n"
+        "        TestBlock1 Single\n"
+        "        {   Test1   U32 }\n"
+        "    }\n"
+        "}\n";
+
+    U32 sTestMessages = 0;
+    U32 sTestSum = 0;
+
+    void process_test_message(LLMessageSystem* msg, void**)
+    {
+        U32 value = 0;
+        msg->getU32Fast(_PREHASH_TestBlock1, _PREHASH_Test1, value);
+        ++sTestMessages;
+        sTestSum += value;
+    }
+}
+
+namespace tut
+{
+    struct messagecapture_data
+    {
+        messagecapture_data()
+        :   mFile("llmessagecapture", "")
+        {}
+
+        NamedTempFile mFile;
+    };
+    typedef test_group<messagecapture_data> messagecapture_test;
+    typedef messagecapture_test::object messagecapture_object;
+    tut::messagecapture_test messagecapture_testcase("LLMessageCapture");
+
+    template<> template<>
+    void messagecapture_object::test<1>()
+    {
+        set_test_name("round trip");
+
+        LLHost remote(ip_string_to_u32("192.168.1.1"), 13005);
+        LLHost local(ip_string_to_u32("127.0.0.1"), 13000);
+        U8 inbound[] = { 0x40, 0x00, 0x00, 0x00, 0x01, 0x00, 0xff, 0x01, 0x02 };
+        U8 outbound[] = { 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x03 };
+
+        ensure("capture started", LLMessageCapture::start(mFile.getName()));
+        LLMessageCapture::capture(true, remote, local, 1234, true, inbound, sizeof(inbound));
+        LLMessageCapture::capture(false, local, remote, 1234, false, outbound, sizeof(outbound));
+        ensure_equals("record count", LLMessageCapture::getRecordCount(), 2U);
+        LLMessageCapture::stop();
+        ensure("capture stopped", !LLMessageCapture::isCapturing());
+
+        LLMessageCaptureReader reader;
+        ensure("reader opened", reader.open(mFile.getName()));
+
+        LLMessageCaptureRecord record;
+        ensure("first record", reader.readRecord(record));
+        ensure("first inbound", record.isInbound());
+        ensure("first trusted", record.isTrusted());
+        ensure("first sender", record.mSender == remote);
+        ensure("first receiver", record.mReceiver == local);
+        ensure("first remote", record.getRemoteHost() == remote);
+        ensure_equals("first circuit", record.mCircuitCode, 1234U);
+        ensure_equals("first size", record.mData.size(), sizeof(inbound));
+        ensure("first payload", memcmp(record.mData.data(), inbound, sizeof(inbound)) == 0);
+
+        U64 first_timestamp = record.mTimestamp;
+        ensure("second record", reader.readRecord(record));
+        ensure("second outbound", !record.isInbound());
+        ensure("second untrusted", !record.isTrusted());
+        ensure("second remote", record.getRemoteHost() == remote);
+        ensure("timestamps ordered", record.mTimestamp >= first_timestamp);
+        ensure_equals("second size", record.mData.size(), sizeof(outbound));
+        ensure("second payload", memcmp(record.mData.data(), outbound, sizeof(outbound)) == 0);
+
+        ensure("end of file", !reader.readRecord(record));
+    }
+
+    template<> template<>
+    void messagecapture_object::test<2>()
+    {
+        set_test_name("rejects foreign files");
+
+        NamedTempFile bogus("llmessagecapture", "not a capture file");
+        LLMessageCaptureReader reader;
+        ensure("bogus file rejected", !reader.open(bogus.getName()));
+        ensure("reader closed", !reader.isOpen());
+    }
+
+    template<> template<>
+    void messagecapture_object::test<3>()
+    {
+        set_test_name("capture and replay");
+
+        NamedTempFile message_template("message_template", REPLAY_TEMPLATE);
+        gMessageSystem = new LLMessageSystem(message_template.getName(), NET_USE_OS_ASSIGNED_PORT,
+                                             1, 0, 0, false, 5.f, 100.f);
+        ensure("message system", gMessageSystem->isOK());
+        gMessageSystem->setHandlerFuncFast(_PREHASH_TestMessage, process_test_message);
+
+        // Talk to ourselves over loopback so that both capture hooks see the
+        // packets the way they would live
+        LLHost self(ip_string_to_u32("127.0.0.1"), gMessageSystem->getListenPort());
+        gMessageSystem->enableCircuit(self, FALSE);
+
+        const U32 SENT = 3;
+        sTestMessages = 0;
+        sTestSum = 0;
+        ensure("capture started", LLMessageCapture::start(mFile.getName()));
+        for (U32 i = 1; i <= SENT; ++i)
+        {
+            gMessageSystem->newMessageFast(_PREHASH_TestMessage);
+            gMessageSystem->nextBlockFast(_PREHASH_TestBlock1);
+            gMessageSystem->addU32Fast(_PREHASH_Test1, i);
+            gMessageSystem->sendMessage(self);
+        }
+        for (S32 tries = 0; sTestMessages < SENT && tries < 200; ++tries)
+        {
+            {
+                LockMessageChecker lmc(gMessageSystem);
+                while (lmc.checkMessages(0))
+                {
+                }
+            }
+            ms_sleep(10);
+        }
+        LLMessageCapture::stop();
+        ensure_equals("received live", sTestMessages, SENT);
+        ensure_equals("captured in and out", LLMessageCapture::getRecordCount(), SENT * 2);
+
+        sTestMessages = 0;
+        sTestSum = 0;
+        LLMessageReplay replay;
+        ensure("replay ran", replay.replay(mFile.getName()));
+        ensure_equals("packets replayed", replay.getPacketsReplayed(), SENT);
+        ensure_equals("packets rejected", replay.getPacketsRejected(), 0U);
+        ensure_equals("handler ran again", sTestMessages, SENT);
+        ensure_equals("payloads decoded", sTestSum, 1U + 2U + 3U);
+
+        const LLMessageReplay::stats_map_t& stats = replay.getStats();
+        LLMessageReplay::stats_map_t::const_iterator it = stats.find("TestMessage");
+        ensure("stats by message", it != stats.end());
+        ensure_equals("stats count", it->second.mCount, SENT);
+        ensure("stats in llsd", replay.asLLSD().has("TestMessage"));
+        ensure("circuit left alone", gMessageSystem->mCircuitInfo.findCircuit(self) != NULL);
+
+        end_messaging_system(false);
+    }
+}
@@ -148,29 +148,216 @@ bool get_dom_sources(const domInputLocalOffset_Array& inputs, S32& pos_offset, S
     return true;
 }
 
+// Everything the face loaders read from one <triangles>, <polylist> or
+// <polygons> element. collada-dom resolves URIs and counts references to
+// its elements without locking, so these are looked up on the loader thread
+// and the faces are then built from the plain arrays on any thread.
+struct DomFaceSources
+{
+    typedef enum
+    {
+        TRIANGLES = 0,
+        POLYLIST,
+        POLYGONS
+    } EType;
+
+    EType mType = TRIANGLES;
+    bool mBadElement = false;   // an input or the index list is missing
+
+    S32 mPosOffset = -1;
+    S32 mTcOffset = -1;
+    S32 mNormOffset = -1;
+    S32 mIdxStride = 0;
+
+    const domListOfFloats* mPositions = NULL;
+    const domListOfFloats* mTexCoords = NULL;
+    const domListOfFloats* mNormals = NULL;
+
+    const domListOfUInts* mIndices = NULL;  // triangles and polylist
+    const domListOfUInts* mVCount = NULL;   // polylist
+    std::vector<const domListOfUInts*> mPolygons;
+
+    std::string mMaterial;
+};
+
+const domListOfFloats* get_dom_float_list(domSource* source)
+{
+    if (source && source->getFloat_array())
+    {
+        return &source->getFloat_array()->getValue();
+    }
+    return NULL;
+}
+
+void get_dom_face_sources(const domInputLocalOffset_Array& inputs, daeString material, DomFaceSources& src)
+{
+    domSource* pos_source = NULL;
+    domSource* tc_source = NULL;
+    domSource* norm_source = NULL;
+
+    if (!get_dom_sources(inputs, src.mPosOffset, src.mTcOffset, src.mNormOffset, src.mIdxStride, pos_source, tc_source, norm_source))
+    {
+        src.mBadElement = true;
+    }
+
+    src.mPositions = get_dom_float_list(pos_source);
+    src.mTexCoords = get_dom_float_list(tc_source);
+    src.mNormals = get_dom_float_list(norm_source);
+
+    if (material)
+    {
+        src.mMaterial = std::string(material);
+    }
+}
+
+void get_dom_triangles_sources(domTrianglesRef& tri, DomFaceSources& src)
+{
+    src.mType = DomFaceSources::TRIANGLES;
+    get_dom_face_sources(tri->getInput_array(), tri->getMaterial(), src);
+
+    domPRef p = tri->getP();
+    if (p)
+    {
+        src.mIndices = &p->getValue();
+    }
+    else
+    {
+        src.mBadElement = true;
+    }
+}
+
+void get_dom_polylist_sources(domPolylistRef& poly, DomFaceSources& src)
+{
+    src.mType = DomFaceSources::POLYLIST;
+
+    domPRef p = poly->getP();
+    if (p)
+    {
+        src.mIndices = &p->getValue();
+    }
+    if (!src.mIndices || src.mIndices->getCount() == 0)
+    {
+        // Nothing to load, the loader skips it without looking at the inputs
+        return;
+    }
+
+    get_dom_face_sources(poly->getInput_array(), poly->getMaterial(), src);
+
+    domPolylist::domVcountRef vcount = poly->getVcount();
+    if (vcount)
+    {
+        src.mVCount = &vcount->getValue();
+    }
+    else
+    {
+        src.mBadElement = true;
+    }
+}
+
+void get_dom_polygons_sources(domPolygonsRef& poly, DomFaceSources& src)
+{
+    src.mType = DomFaceSources::POLYGONS;
+
+    const domInputLocalOffset_Array& inputs = poly->getInput_array();
+
+    U32 stride = 0;
+    for (U32 i = 0; i < inputs.getCount(); ++i)
+    {
+        stride = llmax((U32) inputs[i]->getOffset()+1, stride);
+
+        if (strcmp(COMMON_PROFILE_INPUT_VERTEX, inputs[i]->getSemantic()) == 0)
+        { //found vertex array
+            src.mPosOffset = inputs[i]->getOffset();
+
+            const domURIFragmentType& uri = inputs[i]->getSource();
+            daeElementRef elem = uri.getElement();
+            domVertices* vertices = (domVertices*) elem.cast();
+            if (!vertices)
+            {
+                src.mBadElement = true;
+                return;
+            }
+            domInputLocal_Array& v_inp = vertices->getInput_array();
+
+            for (U32 k = 0; k < v_inp.getCount(); ++k)
+            {
+                if (strcmp(COMMON_PROFILE_INPUT_POSITION, v_inp[k]->getSemantic()) == 0)
+                {
+                    const domURIFragmentType& uri = v_inp[k]->getSource();
+                    daeElementRef elem = uri.getElement();
+                    domSource* source = (domSource*) elem.cast();
+                    if (!source)
+                    {
+                        src.mBadElement = true;
+                        return;
+                    }
+                    src.mPositions = &(source->getFloat_array()->getValue());
+                }
+            }
+        }
+        else if (strcmp(COMMON_PROFILE_INPUT_NORMAL, inputs[i]->getSemantic()) == 0)
+        {
+            src.mNormOffset = inputs[i]->getOffset();
+            //found normal array for this triangle list
+            const domURIFragmentType& uri = inputs[i]->getSource();
+            daeElementRef elem = uri.getElement();
+            domSource* source = (domSource*) elem.cast();
+            if (!source)
+            {
+                src.mBadElement = true;
+                return;
+            }
+            src.mNormals = &(source->getFloat_array()->getValue());
+        }
+        else if (strcmp(COMMON_PROFILE_INPUT_TEXCOORD, inputs[i]->getSemantic()) == 0 && inputs[i]->getSet() == 0)
+        { //found texCoords
+            src.mTcOffset = inputs[i]->getOffset();
+            const domURIFragmentType& uri = inputs[i]->getSource();
+            daeElementRef elem = uri.getElement();
+            domSource* source = (domSource*) elem.cast();
+            if (!source)
+            {
+                src.mBadElement = true;
+                return;
+            }
+            src.mTexCoords = &(source->getFloat_array()->getValue());
+        }
+    }
+    src.mIdxStride = stride;
+
+    domP_Array& ps = poly->getP_array();
+    for (U32 i = 0; i < ps.getCount(); ++i)
+    {
+        src.mPolygons.push_back(&ps[i]->getValue());
+    }
+
+    if (poly->getMaterial())
+    {
+        src.mMaterial = std::string(poly->getMaterial());
+    }
+}
+
 LLModel::EModelStatus load_face_from_dom_triangles(
     std::vector<LLVolumeFace>& face_list,
     std::vector<std::string>& materials,
-    domTrianglesRef& tri,
+    const DomFaceSources& src,
     LLSD& log_msg)
 {
     LLVolumeFace face;
     std::vector<LLVolumeFace::VertexData> verts;
     std::vector<U16> indices;
 
-    const domInputLocalOffset_Array& inputs = tri->getInput_array();
+    S32 pos_offset = src.mPosOffset;
+    S32 tc_offset = src.mTcOffset;
+    S32 norm_offset = src.mNormOffset;
 
-    S32 pos_offset = -1;
-    S32 tc_offset = -1;
-    S32 norm_offset = -1;
+    const domListOfFloats* pos_source = src.mPositions;
+    const domListOfFloats* tc_source = src.mTexCoords;
+    const domListOfFloats* norm_source = src.mNormals;
 
-    domSource* pos_source = NULL;
-    domSource* tc_source = NULL;
-    domSource* norm_source = NULL;
+    S32 idx_stride = src.mIdxStride;
 
-    S32 idx_stride = 0;
-
-    if ( !get_dom_sources(inputs, pos_offset, tc_offset, norm_offset, idx_stride, pos_source, tc_source, norm_source))
+    if (src.mBadElement)
     {
         LLSD args;
         args["Message"] = "ParsingErrorBadElement";
@@ -178,7 +365,7 @@ LLModel::EModelStatus load_face_from_dom_triangles(
         return LLModel::BAD_ELEMENT;
     }
 
-    if (!pos_source || !pos_source->getFloat_array())
+    if (!pos_source)
     {
         LL_WARNS() << "Unable to process mesh without position data; invalid model;  invalid model." << LL_ENDL;
         LLSD args;
@@ -187,13 +374,12 @@ LLModel::EModelStatus load_face_from_dom_triangles(
         return LLModel::BAD_ELEMENT;
     }
 
-    domPRef p = tri->getP();
-    domListOfUInts& idx = p->getValue();
+    const domListOfUInts& idx = *src.mIndices;
 
     domListOfFloats  dummy ;
-    domListOfFloats& v = pos_source ? pos_source->getFloat_array()->getValue() : dummy ;
-    domListOfFloats& tc = tc_source ? tc_source->getFloat_array()->getValue() : dummy ;
-    domListOfFloats& n = norm_source ? norm_source->getFloat_array()->getValue() : dummy ;
+    const domListOfFloats& v = pos_source ? *pos_source : dummy ;
+    const domListOfFloats& tc = tc_source ? *tc_source : dummy ;
+    const domListOfFloats& n = norm_source ? *norm_source : dummy ;
 
     if (pos_source)
     {
@@ -305,14 +491,7 @@ LLModel::EModelStatus load_face_from_dom_triangles(
 
         if (indices.size()%3 == 0 && verts.size() >= 65532)
         {
-            std::string material;
-
-            if (tri->getMaterial())
-            {
-                material = std::string(tri->getMaterial());
-            }
-
-            materials.push_back(material);
+            materials.push_back(src.mMaterial);
             face_list.push_back(face);
             face_list.rbegin()->fillFromLegacyData(verts, indices);
             LLVolumeFace& new_face = *face_list.rbegin();
@@ -341,14 +520,7 @@ LLModel::EModelStatus load_face_from_dom_triangles(
 
     if (!verts.empty())
     {
-        std::string material;
-
-        if (tri->getMaterial())
-        {
-            material = std::string(tri->getMaterial());
-        }
-
-        materials.push_back(material);
+        materials.push_back(src.mMaterial);
         face_list.push_back(face);
 
         face_list.rbegin()->fillFromLegacyData(verts, indices);
@@ -372,33 +544,27 @@ LLModel::EModelStatus load_face_from_dom_triangles(
 LLModel::EModelStatus load_face_from_dom_polylist(
     std::vector<LLVolumeFace>& face_list,
     std::vector<std::string>& materials,
-    domPolylistRef& poly,
+    const DomFaceSources& src,
     LLSD& log_msg)
 {
-    domPRef p = poly->getP();
-    domListOfUInts& idx = p->getValue();
-
-    if (idx.getCount() == 0)
+    if (!src.mIndices || src.mIndices->getCount() == 0)
     {
         return LLModel::NO_ERRORS ;
     }
 
-    const domInputLocalOffset_Array& inputs = poly->getInput_array();
-
-
-    domListOfUInts& vcount = poly->getVcount()->getValue();
+    const domListOfUInts& idx = *src.mIndices;
 
-    S32 pos_offset = -1;
-    S32 tc_offset = -1;
-    S32 norm_offset = -1;
+    S32 pos_offset = src.mPosOffset;
+    S32 tc_offset = src.mTcOffset;
+    S32 norm_offset = src.mNormOffset;
 
-    domSource* pos_source = NULL;
-    domSource* tc_source = NULL;
-    domSource* norm_source = NULL;
+    const domListOfFloats* pos_source = src.mPositions;
+    const domListOfFloats* tc_source = src.mTexCoords;
+    const domListOfFloats* norm_source = src.mNormals;
 
-    S32 idx_stride = 0;
+    S32 idx_stride = src.mIdxStride;
 
-    if (!get_dom_sources(inputs, pos_offset, tc_offset, norm_offset, idx_stride, pos_source, tc_source, norm_source))
+    if (src.mBadElement)
     {
         LL_WARNS() << "Bad element." << LL_ENDL;
         LLSD args;
@@ -407,33 +573,25 @@ LLModel::EModelStatus load_face_from_dom_polylist(
         return LLModel::BAD_ELEMENT;
     }
 
+    const domListOfUInts& vcount = *src.mVCount;
+
     LLVolumeFace face;
 
     std::vector<U16> indices;
     std::vector<LLVolumeFace::VertexData> verts;
 
-    domListOfFloats v;
-    domListOfFloats tc;
-    domListOfFloats n;
+    domListOfFloats dummy;
+    const domListOfFloats& v = pos_source ? *pos_source : dummy;
+    const domListOfFloats& tc = tc_source ? *tc_source : dummy;
+    const domListOfFloats& n = norm_source ? *norm_source : dummy;
 
     if (pos_source)
     {
-        v = pos_source->getFloat_array()->getValue();
         // VFExtents change
         face.mExtents[0].set(v[0], v[1], v[2]);
         face.mExtents[1].set(v[0], v[1], v[2]);
     }
 
-    if (tc_source)
-    {
-        tc = tc_source->getFloat_array()->getValue();
-    }
-
-    if (norm_source)
-    {
-        n = norm_source->getFloat_array()->getValue();
-    }
-
     LLVolumeFace::VertexMapData::PointMap point_map;
 
     U32 cur_idx = 0;
@@ -586,14 +744,7 @@ LLModel::EModelStatus load_face_from_dom_polylist(
 
             if (indices.size()%3 == 0 && indices.size() >= 65532)
             {
-                std::string material;
-
-                if (poly->getMaterial())
-                {
-                    material = std::string(poly->getMaterial());
-                }
-
-                materials.push_back(material);
+                materials.push_back(src.mMaterial);
                 face_list.push_back(face);
                 face_list.rbegin()->fillFromLegacyData(verts, indices);
                 LLVolumeFace& new_face = *face_list.rbegin();
@@ -622,14 +773,7 @@ LLModel::EModelStatus load_face_from_dom_polylist(
 
     if (!verts.empty())
     {
-        std::string material;
-
-        if (poly->getMaterial())
-        {
-            material = std::string(poly->getMaterial());
-        }
-
-        materials.push_back(material);
+        materials.push_back(src.mMaterial);
         face_list.push_back(face);
         face_list.rbegin()->fillFromLegacyData(verts, indices);
 
@@ -650,88 +794,31 @@ LLModel::EModelStatus load_face_from_dom_polylist(
     return LLModel::NO_ERRORS ;
 }
 
-LLModel::EModelStatus load_face_from_dom_polygons(std::vector<LLVolumeFace>& face_list, std::vector<std::string>& materials, domPolygonsRef& poly)
+LLModel::EModelStatus load_face_from_dom_polygons(std::vector<LLVolumeFace>& face_list, std::vector<std::string>& materials, const DomFaceSources& src)
 {
+    if (src.mBadElement)
+    {
+        return LLModel::BAD_ELEMENT;
+    }
+
     LLVolumeFace face;
     std::vector<U16> indices;
     std::vector<LLVolumeFace::VertexData> verts;
 
-    const domInputLocalOffset_Array& inputs = poly->getInput_array();
-
-    S32 v_offset = -1;
-    S32 n_offset = -1;
-    S32 t_offset = -1;
-
-    domListOfFloats* v = NULL;
-    domListOfFloats* n = NULL;
-    domListOfFloats* t = NULL;
-
-    U32 stride = 0;
-    for (U32 i = 0; i < inputs.getCount(); ++i)
-    {
-        stride = llmax((U32) inputs[i]->getOffset()+1, stride);
-
-        if (strcmp(COMMON_PROFILE_INPUT_VERTEX, inputs[i]->getSemantic()) == 0)
-        { //found vertex array
-            v_offset = inputs[i]->getOffset();
-
-            const domURIFragmentType& uri = inputs[i]->getSource();
-            daeElementRef elem = uri.getElement();
-            domVertices* vertices = (domVertices*) elem.cast();
-            if (!vertices)
-            {
-                return LLModel::BAD_ELEMENT;
-            }
-            domInputLocal_Array& v_inp = vertices->getInput_array();
+    S32 v_offset = src.mPosOffset;
+    S32 n_offset = src.mNormOffset;
+    S32 t_offset = src.mTcOffset;
 
-            for (U32 k = 0; k < v_inp.getCount(); ++k)
-            {
-                if (strcmp(COMMON_PROFILE_INPUT_POSITION, v_inp[k]->getSemantic()) == 0)
-                {
-                    const domURIFragmentType& uri = v_inp[k]->getSource();
-                    daeElementRef elem = uri.getElement();
-                    domSource* src = (domSource*) elem.cast();
-                    if (!src)
-                    {
-                        return LLModel::BAD_ELEMENT;
-                    }
-                    v = &(src->getFloat_array()->getValue());
-                }
-            }
-        }
-        else if (strcmp(COMMON_PROFILE_INPUT_NORMAL, inputs[i]->getSemantic()) == 0)
-        {
-            n_offset = inputs[i]->getOffset();
-            //found normal array for this triangle list
-            const domURIFragmentType& uri = inputs[i]->getSource();
-            daeElementRef elem = uri.getElement();
-            domSource* src = (domSource*) elem.cast();
-            if (!src)
-            {
-                return LLModel::BAD_ELEMENT;
-            }
-            n = &(src->getFloat_array()->getValue());
-        }
-        else if (strcmp(COMMON_PROFILE_INPUT_TEXCOORD, inputs[i]->getSemantic()) == 0 && inputs[i]->getSet() == 0)
-        { //found texCoords
-            t_offset = inputs[i]->getOffset();
-            const domURIFragmentType& uri = inputs[i]->getSource();
-            daeElementRef elem = uri.getElement();
-            domSource* src = (domSource*) elem.cast();
-            if (!src)
-            {
-                return LLModel::BAD_ELEMENT;
-            }
-            t = &(src->getFloat_array()->getValue());
-        }
-    }
+    const domListOfFloats* v = src.mPositions;
+    const domListOfFloats* n = src.mNormals;
+    const domListOfFloats* t = src.mTexCoords;
 
-    domP_Array& ps = poly->getP_array();
+    U32 stride = src.mIdxStride;
 
     //make a triangle list in <verts>
-    for (U32 i = 0; i < ps.getCount(); ++i)
+    for (U32 i = 0; i < src.mPolygons.size(); ++i)
     { //for each polygon
-        domListOfUInts& idx = ps[i]->getValue();
+        const domListOfUInts& idx = *src.mPolygons[i];
         for (U32 j = 0; j < idx.getCount()/stride; ++j)
         { //for each vertex
             if (j > 2)
@@ -848,14 +935,7 @@ LLModel::EModelStatus load_face_from_dom_polygons(std::vector<LLVolumeFace>& fac
 
     if (!new_verts.empty())
     {
-        std::string material;
-
-        if (poly->getMaterial())
-        {
-            material = std::string(poly->getMaterial());
-        }
-
-        materials.push_back(material);
+        materials.push_back(src.mMaterial);
         face_list.push_back(face);
         face_list.rbegin()->fillFromLegacyData(new_verts, indices);
 
@@ -918,6 +998,22 @@ LLDAELoader::~LLDAELoader()
     mHandler.reset();
 }
 
+struct LLDAELoader::MeshSources
+{
+    std::string mLabel; // without the LOD suffix
+    std::vector<DomFaceSources> mFaces;
+};
+
+struct LLDAELoader::SkinSources
+{
+    LLModel* mModel = NULL;
+    LLMatrix4 mInverseNormalizedTransformation;
+    const domListOfFloats* mPositions = NULL;
+    const domListOfFloats* mWeights = NULL;
+    const domListOfUInts* mVCount = NULL;
+    const domListOfInts* mV = NULL;
+};
+
 struct ModelSort
 {
     bool operator()(const LLPointer< LLModel >& lhs, const LLPointer< LLModel >& rhs)
@@ -1067,6 +1163,19 @@ bool LLDAELoader::OpenFile(const std::string& filename)
     mTransform.condition();
 
     U32 submodel_limit = count > 0 ? mGeneratedModelLimit/count : 0;
+
+    struct MeshImport
+    {
+        domMesh* mMesh = NULL;
+        MeshSources mSources;
+        std::vector<LLPointer<LLModel> > mModels;
+        LLSD mLog;
+    };
+
+    // collada-dom isn't thread safe, so what each mesh needs is read off
+    // the DOM first, then the meshes are converted in parallel. Results are
+    // merged in DOM order, the same as when converting one after another.
+    std::vector<MeshImport> imports(count);
     for (daeInt idx = 0; idx < count; ++idx)
     { //build map of domEntities to LLModel
         domMesh* mesh = NULL;
@@ -1074,28 +1183,47 @@ bool LLDAELoader::OpenFile(const std::string& filename)
 
         if (mesh)
         {
+            imports[idx].mMesh = mesh;
+            getMeshSources(mesh, imports[idx].mSources);
+        }
+    }
 
-            std::vector<LLModel*> models;
+    runImportJobs(imports.size(), [this, &imports, submodel_limit](size_t idx)
+        {
+            MeshImport& import = imports[idx];
+            if (import.mMesh)
+            {
+                std::vector<LLModel*> models;
+                import.mLog = LLSD::emptyArray();
+                loadModelsFromDomMesh(import.mSources, models, submodel_limit, import.mLog);
+                import.mModels.assign(models.begin(), models.end());
+            }
+        });
 
-            loadModelsFromDomMesh(mesh, models, submodel_limit);
+    for (MeshImport& import : imports)
+    {
+        if (!import.mMesh)
+        {
+            continue;
+        }
 
-            std::vector<LLModel*>::iterator i;
-            i = models.begin();
-            while (i != models.end())
+        for (LLSD::array_const_iterator it = import.mLog.beginArray(); it != import.mLog.endArray(); ++it)
+        {
+            mWarningsArray.append(*it);
+        }
+
+        for (LLPointer<LLModel>& mdl : import.mModels)
+        {
+            if(mdl->getStatus() != LLModel::NO_ERRORS)
             {
-                LLModel* mdl = *i;
-                if(mdl->getStatus() != LLModel::NO_ERRORS)
-                {
-                    setLoadState(ERROR_MODEL + mdl->getStatus()) ;
-                    return false; //abort
-                }
+                setLoadState(ERROR_MODEL + mdl->getStatus()) ;
+                return false; //abort
+            }
 
-                if (mdl && validate_model(mdl))
-                {
-                    mModelList.push_back(mdl);
-                    mModelsMap[mesh].push_back(mdl);
-                }
-                i++;
+            if (validate_model(mdl))
+            {
+                mModelList.push_back(mdl);
+                mModelsMap[import.mMesh].push_back(mdl);
             }
         }
     }
@@ -1120,6 +1248,8 @@ bool LLDAELoader::OpenFile(const std::string& filename)
         model_iter++;
     }
 
+    std::vector<SkinSources> skin_sources;
+
     count = db->getElementCount(NULL, COLLADA_TYPE_SKIN);
     for (daeInt idx = 0; idx < count; ++idx)
     { //add skinned meshes as instances
@@ -1139,7 +1269,7 @@ bool LLDAELoader::OpenFile(const std::string& filename)
                     while (i != mModelsMap[mesh].end())
                     {
                         LLPointer<LLModel> mdl = *i;
-                        LLDAELoader::processDomModel(mdl, &dae, root, mesh, skin);
+                        LLDAELoader::processDomModel(mdl, &dae, root, mesh, skin, skin_sources);
                         i++;
                     }
                 }
@@ -1147,6 +1277,29 @@ bool LLDAELoader::OpenFile(const std::string& filename)
         }
     }
 
+    // Skins of the same model are applied one after another, in DOM order,
+    // different models get their weights in parallel
+    std::vector<std::vector<const SkinSources*> > skin_jobs;
+    std::map<LLModel*, size_t> skin_job_index;
+    for (const SkinSources& sources : skin_sources)
+    {
+        std::map<LLModel*, size_t>::iterator iter = skin_job_index.find(sources.mModel);
+        if (iter == skin_job_index.end())
+        {
+            iter = skin_job_index.emplace(sources.mModel, skin_jobs.size()).first;
+            skin_jobs.emplace_back();
+        }
+        skin_jobs[iter->second].push_back(&sources);
+    }
+
+    runImportJobs(skin_jobs.size(), [&skin_jobs](size_t idx)
+        {
+            for (const SkinSources* sources : skin_jobs[idx])
+            {
+                buildSkinWeights(*sources);
+            }
+        });
+
     LL_INFOS()<< "Collada skins processed: " << count <<LL_ENDL;
 
     daeElement* scene = root->getDescendant("visual_scene");
@@ -1214,7 +1367,7 @@ std::string LLDAELoader::preprocessDAE(std::string filename)
     return buffer;
 }
 
-void LLDAELoader::processDomModel(LLModel* model, DAE* dae, daeElement* root, domMesh* mesh, domSkin* skin)
+void LLDAELoader::processDomModel(LLModel* model, DAE* dae, daeElement* root, domMesh* mesh, domSkin* skin, std::vector<SkinSources>& skin_sources)
 {
     llassert(model && dae && mesh && skin);
 
@@ -1571,40 +1724,25 @@ void LLDAELoader::processDomModel(LLModel* model, DAE* dae, daeElement* root, do
             LL_WARNS("Mesh") << "Model " << model->mLabel << " has invalid joint bind matrix list." << LL_ENDL;
         }
 
+        // The positions and weights are only read off the DOM here,
+        // buildSkinWeights() turns them into skin weights later, in parallel
+        // with the other models
+        SkinSources sources;
+        sources.mModel = model;
+        sources.mInverseNormalizedTransformation = inverse_normalized_transformation;
+
         //grab raw position array
 
         domVertices* verts = mesh->getVertices();
         if (verts)
         {
             domInputLocal_Array& inputs = verts->getInput_array();
-            for (size_t i = 0; i < inputs.getCount() && model->mPosition.empty(); ++i)
+            for (size_t i = 0; i < inputs.getCount() && !sources.mPositions; ++i)
             {
                 if (strcmp(inputs[i]->getSemantic(), COMMON_PROFILE_INPUT_POSITION) == 0)
                 {
                     domSource* pos_source = daeSafeCast<domSource>(inputs[i]->getSource().getElement());
-                    if (pos_source)
-                    {
-                        domFloat_array* pos_array = pos_source->getFloat_array();
-                        if (pos_array)
-                        {
-                            domListOfFloats& pos = pos_array->getValue();
-
-                            for (size_t j = 0; j < pos.getCount(); j += 3)
-                            {
-                                if (pos.getCount() <= j+2)
-                                {
-                                    LL_ERRS() << "Invalid position array size." << LL_ENDL;
-                                }
-
-                                LLVector3 v(pos[j], pos[j+1], pos[j+2]);
-
-                                //transform from COLLADA space to volume space
-                                v = v * inverse_normalized_transformation;
-
-                                model->mPosition.push_back(v);
-                            }
-                        }
-                    }
+                    sources.mPositions = get_dom_float_list(pos_source);
                 }
             }
         }
@@ -1627,81 +1765,115 @@ void LLDAELoader::processDomModel(LLModel* model, DAE* dae, daeElement* root, do
                 }
             }
 
-            if (vertex_weights)
+            if (vertex_weights && weights->getVcount() && weights->getV())
             {
-                domListOfFloats& w = vertex_weights->getValue();
-                domListOfUInts& vcount = weights->getVcount()->getValue();
-                domListOfInts& v = weights->getV()->getValue();
+                sources.mWeights = &vertex_weights->getValue();
+                sources.mVCount = &weights->getVcount()->getValue();
+                sources.mV = &weights->getV()->getValue();
+            }
+        }
 
-                U32 c_idx = 0;
-                for (size_t vc_idx = 0; vc_idx < vcount.getCount(); ++vc_idx)
-                { //for each vertex
-                    daeUInt count = vcount[vc_idx];
+        skin_sources.push_back(sources);
 
-                    //create list of weights that influence this vertex
-                    LLModel::weight_list weight_list;
+        //add instance to scene for this model
 
-                    for (daeUInt i = 0; i < count; ++i)
-                    { //for each weight
-                        daeInt joint_idx = v[c_idx++];
-                        daeInt weight_idx = v[c_idx++];
+        LLMatrix4 transformation;
+        transformation.initScale(mesh_scale_vector);
+        transformation.setTranslation(mesh_translation_vector);
+        transformation *= mTransform;
 
-                        if (joint_idx == -1)
-                        {
-                            //ignore bindings to bind_shape_matrix
-                            continue;
-                        }
+        std::map<std::string, LLImportMaterial> materials;
+        for (U32 i = 0; i < model->mMaterialList.size(); ++i)
+        {
+            materials[model->mMaterialList[i]] = LLImportMaterial();
+        }
+        mScene[transformation].push_back(LLModelInstance(model, model->mLabel, transformation, materials));
+        stretch_extents(model, transformation, mExtents[0], mExtents[1], mFirstTransform);
+    }
+}
 
-                        F32 weight_value = w[weight_idx];
+//static
+void LLDAELoader::buildSkinWeights(const SkinSources& sources)
+{
+    LLModel* model = sources.mModel;
 
-                        weight_list.push_back(LLModel::JointWeight(joint_idx, weight_value));
-                    }
+    if (sources.mPositions && model->mPosition.empty())
+    {
+        const domListOfFloats& pos = *sources.mPositions;
 
-                    //sort by joint weight
-                    std::sort(weight_list.begin(), weight_list.end(), LLModel::CompareWeightGreater());
+        for (size_t j = 0; j < pos.getCount(); j += 3)
+        {
+            if (pos.getCount() <= j+2)
+            {
+                LL_ERRS() << "Invalid position array size." << LL_ENDL;
+            }
 
-                    std::vector<LLModel::JointWeight> wght;
+            LLVector3 v(pos[j], pos[j+1], pos[j+2]);
 
-                    F32 total = 0.f;
+            //transform from COLLADA space to volume space
+            v = v * sources.mInverseNormalizedTransformation;
 
-                    for (U32 i = 0; i < llmin((U32) 4, (U32) weight_list.size()); ++i)
-                    { //take up to 4 most significant weights
-                        if (weight_list[i].mWeight > 0.f)
-                        {
-                            wght.push_back( weight_list[i] );
-                            total += weight_list[i].mWeight;
-                        }
-                    }
+            model->mPosition.push_back(v);
+        }
+    }
 
-                    F32 scale = 1.f/total;
-                    if (scale != 1.f)
-                    { //normalize weights
-                        for (U32 i = 0; i < wght.size(); ++i)
-                        {
-                            wght[i].mWeight *= scale;
-                        }
-                    }
+    if (sources.mWeights)
+    {
+        const domListOfFloats& w = *sources.mWeights;
+        const domListOfUInts& vcount = *sources.mVCount;
+        const domListOfInts& v = *sources.mV;
+
+        U32 c_idx = 0;
+        for (size_t vc_idx = 0; vc_idx < vcount.getCount(); ++vc_idx)
+        { //for each vertex
+            daeUInt count = vcount[vc_idx];
+
+            //create list of weights that influence this vertex
+            LLModel::weight_list weight_list;
+
+            for (daeUInt i = 0; i < count; ++i)
+            { //for each weight
+                daeInt joint_idx = v[c_idx++];
+                daeInt weight_idx = v[c_idx++];
 
-                    model->mSkinWeights[model->mPosition[vc_idx]] = wght;
+                if (joint_idx == -1)
+                {
+                    //ignore bindings to bind_shape_matrix
+                    continue;
                 }
+
+                F32 weight_value = w[weight_idx];
+
+                weight_list.push_back(LLModel::JointWeight(joint_idx, weight_value));
             }
 
-        }
+            //sort by joint weight
+            std::sort(weight_list.begin(), weight_list.end(), LLModel::CompareWeightGreater());
 
-        //add instance to scene for this model
+            std::vector<LLModel::JointWeight> wght;
 
-        LLMatrix4 transformation;
-        transformation.initScale(mesh_scale_vector);
-        transformation.setTranslation(mesh_translation_vector);
-        transformation *= mTransform;
+            F32 total = 0.f;
 
-        std::map<std::string, LLImportMaterial> materials;
-        for (U32 i = 0; i < model->mMaterialList.size(); ++i)
-        {
-            materials[model->mMaterialList[i]] = LLImportMaterial();
+            for (U32 i = 0; i < llmin((U32) 4, (U32) weight_list.size()); ++i)
+            { //take up to 4 most significant weights
+                if (weight_list[i].mWeight > 0.f)
+                {
+                    wght.push_back( weight_list[i] );
+                    total += weight_list[i].mWeight;
+                }
+            }
+
+            F32 scale = 1.f/total;
+            if (scale != 1.f)
+            { //normalize weights
+                for (U32 i = 0; i < wght.size(); ++i)
+                {
+                    wght[i].mWeight *= scale;
+                }
+            }
+
+            model->mSkinWeights[model->mPosition[vc_idx]] = wght;
         }
-        mScene[transformation].push_back(LLModelInstance(model, model->mLabel, transformation, materials));
-        stretch_extents(model, transformation, mExtents[0], mExtents[1], mFirstTransform);
     }
 }
 
@@ -2471,44 +2643,56 @@ LLColor4 LLDAELoader::getDaeColor(daeElement* element)
     return value;
 }
 
-bool LLDAELoader::addVolumeFacesFromDomMesh(LLModel* pModel,domMesh* mesh, LLSD& log_msg)
+//static
+void LLDAELoader::getMeshSources(domMesh* mesh, MeshSources& sources)
 {
-    LLModel::EModelStatus status = LLModel::NO_ERRORS;
-    domTriangles_Array& tris = mesh->getTriangles_array();
+    sources.mLabel = getLodlessLabel(mesh);
 
+    domTriangles_Array& tris = mesh->getTriangles_array();
     for (U32 i = 0; i < tris.getCount(); ++i)
     {
         domTrianglesRef& tri = tris.get(i);
-
-        status = load_face_from_dom_triangles(pModel->getVolumeFaces(), pModel->getMaterialList(), tri, log_msg);
-        pModel->mStatus = status;
-        if(status != LLModel::NO_ERRORS)
-        {
-            pModel->ClearFacesAndMaterials();
-            return false;
-        }
+        sources.mFaces.emplace_back();
+        get_dom_triangles_sources(tri, sources.mFaces.back());
     }
 
     domPolylist_Array& polys = mesh->getPolylist_array();
     for (U32 i = 0; i < polys.getCount(); ++i)
     {
         domPolylistRef& poly = polys.get(i);
-        status = load_face_from_dom_polylist(pModel->getVolumeFaces(), pModel->getMaterialList(), poly, log_msg);
-
-        if(status != LLModel::NO_ERRORS)
-        {
-            pModel->ClearFacesAndMaterials();
-            return false;
-        }
+        sources.mFaces.emplace_back();
+        get_dom_polylist_sources(poly, sources.mFaces.back());
     }
 
     domPolygons_Array& polygons = mesh->getPolygons_array();
-
     for (U32 i = 0; i < polygons.getCount(); ++i)
     {
         domPolygonsRef& poly = polygons.get(i);
+        sources.mFaces.emplace_back();
+        get_dom_polygons_sources(poly, sources.mFaces.back());
+    }
+}
+
+//static
+bool LLDAELoader::addVolumeFacesFromDomMesh(LLModel* pModel, const MeshSources& sources, LLSD& log_msg)
+{
+    LLModel::EModelStatus status = LLModel::NO_ERRORS;
 
-        status = load_face_from_dom_polygons(pModel->getVolumeFaces(), pModel->getMaterialList(), poly);
+    for (const DomFaceSources& src : sources.mFaces)
+    {
+        switch (src.mType)
+        {
+        case DomFaceSources::TRIANGLES:
+            status = load_face_from_dom_triangles(pModel->getVolumeFaces(), pModel->getMaterialList(), src, log_msg);
+            pModel->mStatus = status;
+            break;
+        case DomFaceSources::POLYLIST:
+            status = load_face_from_dom_polylist(pModel->getVolumeFaces(), pModel->getMaterialList(), src, log_msg);
+            break;
+        case DomFaceSources::POLYGONS:
+            status = load_face_from_dom_polygons(pModel->getVolumeFaces(), pModel->getMaterialList(), src);
+            break;
+        }
 
         if(status != LLModel::NO_ERRORS)
         {
@@ -2523,7 +2707,7 @@ bool LLDAELoader::addVolumeFacesFromDomMesh(LLModel* pModel,domMesh* mesh, LLSD&
 //static diff version supports creating multiple models when material counts spill
 // over the 8 face server-side limit
 //
-bool LLDAELoader::loadModelsFromDomMesh(domMesh* mesh, std::vector<LLModel*>& models_out, U32 submodel_limit)
+bool LLDAELoader::loadModelsFromDomMesh(const MeshSources& sources, std::vector<LLModel*>& models_out, U32 submodel_limit, LLSD& log_msg)
 {
 
     LLVolumeParams volume_params;
@@ -2533,7 +2717,7 @@ bool LLDAELoader::loadModelsFromDomMesh(domMesh* mesh, std::vector<LLModel*>& mo
 
     LLModel* ret = new LLModel(volume_params, 0.f);
 
-    std::string model_name = getLodlessLabel(mesh);
+    std::string model_name = sources.mLabel;
     ret->mLabel = model_name + lod_suffix[mLod];
 
     llassert(!ret->mLabel.empty());
@@ -2544,7 +2728,7 @@ bool LLDAELoader::loadModelsFromDomMesh(domMesh* mesh, std::vector<LLModel*>& mo
 
     // Get the whole set of volume faces
     //
-    addVolumeFacesFromDomMesh(ret, mesh, mWarningsArray);
+    addVolumeFacesFromDomMesh(ret, sources, log_msg);
 
     U32 volume_faces = ret->getNumVolumeFaces();
 
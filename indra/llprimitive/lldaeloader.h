@@ -68,8 +68,18 @@ class LLDAELoader final : public LLModelLoader
 
 protected:
 
+    // What the face loaders need from a <mesh>, and processDomModel from a
+    // <skin>, read off the DOM on the loader thread so that the conversion
+    // itself can run on the import pool
+    struct MeshSources;
+    struct SkinSources;
+
     void processElement(daeElement* element, bool& badElement, DAE* dae);
-    void processDomModel(LLModel* model, DAE* dae, daeElement* pRoot, domMesh* mesh, domSkin* skin);
+    void processDomModel(LLModel* model, DAE* dae, daeElement* pRoot, domMesh* mesh, domSkin* skin, std::vector<SkinSources>& skin_sources);
+
+    // Fills the positions and skin weights of a model, safe on any thread
+    // as long as no other job works on the same model
+    static void buildSkinWeights(const SkinSources& sources);
 
     material_map getMaterials(LLModel* model, domInstance_geometry* instance_geo, DAE* dae);
     LLImportMaterial profileToMaterial(domProfile_COMMON* material, DAE* dae);
@@ -91,12 +101,14 @@ class LLDAELoader final : public LLModelLoader
     //Verify that a controller matches vertex counts
     bool verifyController( domController* pController );
 
-    static bool addVolumeFacesFromDomMesh(LLModel* model, domMesh* mesh, LLSD& log_msg);
+    static void getMeshSources(domMesh* mesh, MeshSources& sources);
+    static bool addVolumeFacesFromDomMesh(LLModel* model, const MeshSources& sources, LLSD& log_msg);
 
     // Loads a mesh breaking it into one or more models as necessary
-    // to get around volume face limitations while retaining >8 materials
+    // to get around volume face limitations while retaining >8 materials.
+    // Doesn't touch the DOM, safe on any thread.
     //
-    bool loadModelsFromDomMesh(domMesh* mesh, std::vector<LLModel*>& models_out, U32 submodel_limit);
+    bool loadModelsFromDomMesh(const MeshSources& sources, std::vector<LLModel*>& models_out, U32 submodel_limit, LLSD& log_msg);
 
     static std::string getElementLabel(daeElement *element);
     static size_t getSuffixPosition(std::string label);
@@ -154,11 +154,21 @@ bool LLGLTFLoader::parseMeshes()
     LLVolumeParams volume_params;
     volume_params.setType(LL_PCODE_PROFILE_SQUARE, LL_PCODE_PATH_LINE);
 
-    for (tinygltf::Mesh mesh : mGltfModel.meshes)
+    // Meshes only read mGltfModel, so they are converted in parallel and
+    // then added in file order
+    std::vector<LLPointer<LLModel> > models(mGltfModel.meshes.size());
+    std::vector<U8> populated(models.size(), 0);
+    runImportJobs(models.size(), [this, &volume_params, &models, &populated](size_t i)
+        {
+            models[i] = new LLModel(volume_params, 0.f);
+            populated[i] = populateModelFromMesh(models[i], mGltfModel.meshes[i]);
+        });
+
+    for (size_t i = 0; i < models.size(); ++i)
     {
-        LLModel *pModel = new LLModel(volume_params, 0.f);
+        LLModel *pModel = models[i];
 
-        if (populateModelFromMesh(pModel, mesh)         &&
+        if (populated[i]                                &&
             (LLModel::NO_ERRORS == pModel->getStatus()) &&
             validate_model(pModel))
         {
@@ -167,7 +177,6 @@ bool LLGLTFLoader::parseMeshes()
         else
         {
             setLoadState(ERROR_MODEL + pModel->getStatus());
-            delete(pModel);
             return false;
         }
     }
@@ -33,10 +33,19 @@
 #include "lltimer.h"
 
 #include "llmatrix4a.h"
+#include "threadpool.h"
 #include <boost/bind.hpp>
 
+#include <thread>
+
 std::list<LLModelLoader*> LLModelLoader::sActiveLoaderList;
 
+// Started by the first loader and shared by all of them, a pool of its own
+// per loader would collide on the name. "LLApp" closes it at shutdown; it
+// isn't deleted, with the other statics it could outlive the ThreadPool
+// instance map.
+static LL::ThreadPool* sImportPool = nullptr;
+
 void stretch_extents(LLModel* model, LLMatrix4a& mat, LLVector4a& min, LLVector4a& max, BOOL& first_transform)
 {
     LLVector4a box[] =
@@ -132,6 +141,7 @@ LLModelLoader::LLModelLoader(
 , mLegacyRigFlags(0)
 , mNoNormalize(false)
 , mNoOptimize(false)
+, mImportThreads(getDefaultImportThreads())
 , mCacheOnlyHitIfRigged(false)
 , mMaxJointsPerMesh(maxJointsPerMesh)
 , mJointMap(legalJointNamesMap)
@@ -139,6 +149,12 @@ LLModelLoader::LLModelLoader(
     assert_main_thread();
     sActiveLoaderList.push_back(this) ;
     mWarningsArray = LLSD::emptyArray();
+
+    if (!sImportPool)
+    {
+        sImportPool = new LL::ThreadPool("ModelImport", getDefaultImportThreads(), 1024);
+        sImportPool->start();
+    }
 }
 
 LLModelLoader::~LLModelLoader()
@@ -147,6 +163,28 @@ LLModelLoader::~LLModelLoader()
     sActiveLoaderList.remove(this);
 }
 
+//static
+U32 LLModelLoader::getDefaultImportThreads()
+{
+    // Leaves a core to the loader thread
+    return llmax((U32)std::thread::hardware_concurrency(), 2U) - 1;
+}
+
+void LLModelLoader::runImportJobs(size_t count, const std::function<void(size_t)>& job)
+{
+    if (sImportPool && mImportThreads > 0)
+    {
+        sImportPool->runJobs(count, job, mImportThreads);
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            job(i);
+        }
+    }
+}
+
 void LLModelLoader::run()
 {
     mWarningsArray.clear();
@@ -30,6 +30,7 @@
 #include "llmodel.h"
 #include "llthread.h"
 #include <boost/function.hpp>
+#include <functional>
 #include <list>
 
 class LLJoint;
@@ -141,6 +142,13 @@ class LLModelLoader : public LLThread
     void setNoNormalize() { mNoNormalize = true; }
     void setNoOptimize() { mNoOptimize = true; }
 
+    // Threads of the "ModelImport" pool this loader may convert meshes and
+    // skins on, 0 converts them on the loader thread. The pool is shared
+    // by every loader, getDefaultImportThreads() wide unless
+    // ThreadPoolSizes overrides it.
+    void setImportThreads(U32 threads) { mImportThreads = threads; }
+    static U32 getDefaultImportThreads();
+
     void run() final;
 
     static bool getSLMFilename(const std::string& model_filename, std::string& slm_filename);
@@ -206,11 +214,17 @@ class LLModelLoader : public LLThread
 
     bool        mNoNormalize;
     bool        mNoOptimize;
+    U32         mImportThreads;
 
     JointTransformMap   mJointTransformMap;
 
     LLSD mWarningsArray; // preview floater will pull logs from here
 
+    // Calls job(0) to job(count - 1) spread over the "ModelImport" pool and
+    // this thread, and returns once they are all done. Jobs must only touch
+    // their own data, not the loader's.
+    void runImportJobs(size_t count, const std::function<void(size_t)>& job);
+
     static std::list<LLModelLoader*> sActiveLoaderList;
     static bool isAlive(LLModelLoader* loader) ;
 };
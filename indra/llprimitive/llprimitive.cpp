@@ -807,7 +807,14 @@ BOOL LLPrimitive::setVolume(const LLVolumeParams &volume_params, const S32 detai
             }
         }
 
-        volumep = sVolumeManager->refVolume(volume_params, detail);
+        if (canDeferVolume())
+        {
+            volumep = sVolumeManager->refVolumeDeferred(volume_params, detail);
+        }
+        else
+        {
+            volumep = sVolumeManager->refVolume(volume_params, detail);
+        }
         if (volumep == mVolumep.get())
         {
             sVolumeManager->unrefVolume( volumep );  // LLVolumeMgr::refVolume() creates a reference, but we don't need a second one.
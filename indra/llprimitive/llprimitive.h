@@ -463,6 +463,9 @@ class LLPrimitive : public LLXform
     const LLVolume *getVolumeConst() const { return mVolumep; }     // HACK for Windoze confusion about ostream operator in LLVolume
     LLVolume *getVolume() const { return mVolumep; }
     virtual BOOL setVolume(const LLVolumeParams &volume_params, const S32 detail, bool unique_volume = false);
+    // Whether setVolume() may hand out a stand in while the LOD is built on
+    // another thread, see LLVolumeMgr::refVolumeDeferred()
+    virtual bool canDeferVolume() const { return false; }
 
     // Modify texture entry properties
     inline BOOL validTE(const U8 te_num) const;
@@ -1450,6 +1450,7 @@ void LLGLManager::initExtensions()
     mHasTransformFeedback = mGLVersion >= 3.99f;
     mHasDebugOutput = mGLVersion >= 4.29f;
     mHasTextureSwizzle = mGLVersion >= 3.29f;
+    mHasTextureCompressionBPTC = mGLVersion >= 4.19f || ExtensionExists("GL_ARB_texture_compression_bptc", gGLHExts.mSysExts);
     mHasTextureFilterAnisotropic = mGLVersion >= 4.59f || ExtensionExists("GL_EXT_texture_filter_anisotropic", gGLHExts.mSysExts);
 
     // Misc
@@ -95,6 +95,7 @@ class LLGLManager
     bool mHasDebugOutput = false;
     bool mHasTransformFeedback = false;
     bool mHasTextureSwizzle = false;
+    bool mHasTextureCompressionBPTC = false;
     bool mHasGPUShader4  = false;
     bool mHasAdaptiveVSync = false;
 
@@ -34,6 +34,8 @@
 #include "llerror.h"
 #include "llfasttimer.h"
 #include "llimage.h"
+#include "llimagedxt.h"
+#include "llimagemips.h"
 
 #include "llmath.h"
 #include "llgl.h"
@@ -277,6 +279,8 @@ S32 LLImageGL::dataFormatBits(S32 dataformat)
     case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:    return 8;
     case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:          return 8;
     case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:    return 8;
+    case GL_COMPRESSED_RG_RGTC2:                    return 8;
+    case GL_COMPRESSED_RGBA_BPTC_UNORM:             return 8;
     case GL_LUMINANCE:                              return 8;
     case GL_ALPHA:                                  return 8;
     case GL_RED:                                    return 8;
@@ -310,6 +314,8 @@ S64 LLImageGL::dataFormatBytes(S32 dataformat, S32 width, S32 height)
     case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
     case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
     case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_RG_RGTC2:
+    case GL_COMPRESSED_RGBA_BPTC_UNORM:
         if (width < 4) width = 4;
         if (height < 4) height = 4;
         break;
@@ -332,6 +338,8 @@ S32 LLImageGL::dataFormatComponents(S32 dataformat)
       case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT: return 4;
       case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:    return 4;
       case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT: return 4;
+      case GL_COMPRESSED_RG_RGTC2:              return 2;
+      case GL_COMPRESSED_RGBA_BPTC_UNORM:       return 4;
       case GL_LUMINANCE:                        return 1;
       case GL_ALPHA:                            return 1;
       case GL_RED:                              return 1;
@@ -349,6 +357,20 @@ S32 LLImageGL::dataFormatComponents(S32 dataformat)
     }
 }
 
+//static
+LLGLenum LLImageGL::getCompressedFormat(const LLImageDXT* image)
+{
+    switch (image->getFileFormat())
+    {
+    case LLImageDXT::FORMAT_DXR1:   return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    case LLImageDXT::FORMAT_DXR3:   return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+    case LLImageDXT::FORMAT_DXR5:   return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case LLImageDXT::FORMAT_BC5R:   return GL_COMPRESSED_RG_RGTC2;
+    case LLImageDXT::FORMAT_BC7R:   return gGLManager.mHasTextureCompressionBPTC ? GL_COMPRESSED_RGBA_BPTC_UNORM : 0;
+    default:                        return 0;
+    }
+}
+
 //----------------------------------------------------------------------------
 
 // static
@@ -533,6 +555,7 @@ void LLImageGL::init(BOOL usemipmaps)
     mPickMaskHeight = 0;
     mUseMipMaps = usemipmaps;
     mHasExplicitFormat = FALSE;
+    mPrecompressed = false;
 
     mIsMask = FALSE;
     mMaskRMSE = 1.f ;
@@ -724,6 +747,7 @@ void LLImageGL::setExplicitFormat( LLGLint internal_format, LLGLenum primary_for
     // Note: must be called before createTexture()
     // Note: it's up to the caller to ensure that the format matches the number of components.
     mHasExplicitFormat = TRUE;
+    mPrecompressed = false;
     mFormatInternal = internal_format;
     mFormatPrimary = primary_format;
     if(type_format == 0)
@@ -1607,25 +1631,51 @@ BOOL LLImageGL::createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S
         discard_level = mCurrentDiscardLevel;
     }
 
-    // Actual image width/height = raw image width/height * 2^discard_level
-    S32 raw_w = imageraw->getWidth() ;
-    S32 raw_h = imageraw->getHeight() ;
+    if (!setSizeAndFormat(discard_level, imageraw->getWidth(), imageraw->getHeight(), imageraw->getComponents()))
+    {
+        mGLTextureCreated = false;
+        return FALSE;
+    }
 
+    if(!to_create) //not create a gl texture
+    {
+        destroyGLTexture();
+        mCurrentDiscardLevel = discard_level;
+        mLastBindTime = sLastFrameTime;
+        mGLTextureCreated = false;
+        return TRUE ;
+    }
+
+    setCategory(category);
+    const U8* rawdata = imageraw->getData();
+    return createGLTexture(discard_level, rawdata, FALSE, usename, defer_copy, tex_name);
+}
+
+BOOL LLImageGL::setSizeAndFormat(S32 discard_level, S32 raw_w, S32 raw_h, S32 components)
+{
+    // Actual image width/height = raw image width/height * 2^discard_level
     S32 w = raw_w << discard_level;
     S32 h = raw_h << discard_level;
 
     // setSize may call destroyGLTexture if the size does not match
 #ifdef NO_STUPID
-    if (!setSize(w, h, imageraw->getComponents(), discard_level))
+    if (!setSize(w, h, components, discard_level))
     {
         LL_WARNS() << "Trying to create a texture with incorrect dimensions!" << LL_ENDL;
-        mGLTextureCreated = false;
         return FALSE;
     }
 #else
-    setSize(w, h, imageraw->getComponents(), discard_level);
+    setSize(w, h, components, discard_level);
 #endif
 
+    // The format was set for an image compressed ahead of time, and this
+    // upload isn't one
+    if (mPrecompressed)
+    {
+        mHasExplicitFormat = FALSE;
+        mPrecompressed = false;
+    }
+
     if (mHasExplicitFormat &&
         ((mFormatPrimary == GL_RGBA && mComponents < 4) ||
          (mFormatPrimary == GL_RGB  && mComponents < 3)))
@@ -1668,18 +1718,113 @@ BOOL LLImageGL::createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S
         calcAlphaChannelOffsetAndStride() ;
     }
 
-    if(!to_create) //not create a gl texture
+    return TRUE;
+}
+
+BOOL LLImageGL::createGLTexture(S32 discard_level, const LLImageMipChain* mips, S32 usename, S32 category, bool defer_copy, LLGLuint* tex_name)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    checkActiveThread();
+
+    if (gGLManager.mIsDisabled)
     {
-        destroyGLTexture();
-        mCurrentDiscardLevel = discard_level;
-        mLastBindTime = sLastFrameTime;
+        LL_WARNS() << "Trying to create a texture while GL is disabled!" << LL_ENDL;
+        return FALSE;
+    }
+
+    llassert(gGLManager.mInited);
+    stop_glerror();
+
+    if (!mips || mips->isEmpty())
+    {
+        LL_WARNS() << "Trying to create a texture from an empty mip chain" << LL_ENDL;
         mGLTextureCreated = false;
-        return TRUE ;
+        return FALSE;
+    }
+
+    if (discard_level < 0)
+    {
+        llassert(mCurrentDiscardLevel >= 0);
+        discard_level = mCurrentDiscardLevel;
+    }
+
+    if (!setSizeAndFormat(discard_level, mips->getWidth(), mips->getHeight(), mips->getComponents()))
+    {
+        mGLTextureCreated = false;
+        return FALSE;
     }
 
     setCategory(category);
-    const U8* rawdata = imageraw->getData();
-    return createGLTexture(discard_level, rawdata, FALSE, usename, defer_copy, tex_name);
+
+    // setImage() walks back from level 0 down to mMaxDiscardLevel, and
+    // the chain's layout only matches plain 8 bit formats
+    bool has_mips = mUseMipMaps
+        && !isCompressed()
+        && dataFormatComponents(mFormatPrimary) == mips->getComponents()
+        && mips->getLevelCount() > mMaxDiscardLevel - discard_level;
+    return createGLTexture(discard_level, mips->getLevelData(0), has_mips, usename, defer_copy, tex_name);
+}
+
+BOOL LLImageGL::createGLTexture(S32 discard_level, LLImageDXT* compressed, const LLImageRaw* source, S32 usename, S32 category, bool defer_copy, LLGLuint* tex_name)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    checkActiveThread();
+
+    if (gGLManager.mIsDisabled)
+    {
+        LL_WARNS() << "Trying to create a texture while GL is disabled!" << LL_ENDL;
+        return FALSE;
+    }
+
+    llassert(gGLManager.mInited);
+    stop_glerror();
+
+    LLGLenum format = compressed ? getCompressedFormat(compressed) : 0;
+    if (!format || !compressed->getData())
+    {
+        LL_WARNS() << "Trying to create a texture from an unsupported compressed image" << LL_ENDL;
+        mGLTextureCreated = false;
+        return FALSE;
+    }
+
+    if (discard_level < 0)
+    {
+        llassert(mCurrentDiscardLevel >= 0);
+        discard_level = mCurrentDiscardLevel;
+    }
+
+    // Alpha and the pick mask can't be read back from the blocks, so they
+    // come from the image the blocks were made of, in its own format
+    if (source && !source->isBufferInvalid() && mNeedsAlphaAndPickMask)
+    {
+        if (!setSizeAndFormat(discard_level, source->getWidth(), source->getHeight(), source->getComponents()))
+        {
+            mGLTextureCreated = false;
+            return FALSE;
+        }
+        analyzeAlpha(source->getData(), source->getWidth(), source->getHeight());
+        updatePickMask(source->getWidth(), source->getHeight(), source->getData());
+    }
+    else
+    {
+        setNeedsAlphaAndPickMask(FALSE);
+    }
+
+    // The image holds every level down to 1 pixel, with level 0 being
+    // the texture at discard_level
+    setExplicitFormat(format, format);
+    if (!setSizeAndFormat(discard_level, compressed->getWidth(), compressed->getHeight(),
+                          dataFormatComponents(format)))
+    {
+        mGLTextureCreated = false;
+        return FALSE;
+    }
+
+    mPrecompressed = true;
+
+    setCategory(category);
+    const U8* data = compressed->getData() + compressed->getMipOffset(0);
+    return createGLTexture(discard_level, data, mUseMipMaps, usename, defer_copy, tex_name);
 }
 
 BOOL LLImageGL::createGLTexture(S32 discard_level, const U8* data_in, BOOL data_hasmips, S32 usename, bool defer_copy, LLGLuint* tex_name)
@@ -2175,6 +2320,12 @@ void LLImageGL::calcAlphaChannelOffsetAndStride()
     case GL_BGRA_EXT:
         mAlphaStride = 4;
         break;
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_RG_RGTC2:
+    case GL_COMPRESSED_RGBA_BPTC_UNORM:
+        return; //analyzed from the source image, see createGLTexture(S32, LLImageDXT*, ...)
     default:
         break;
     }
@@ -2412,6 +2563,8 @@ bool LLImageGL::isCompressed()
     case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
     case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
     case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_RG_RGTC2:
+    case GL_COMPRESSED_RGBA_BPTC_UNORM:
         is_compressed = true;
         break;
     default:
@@ -42,6 +42,8 @@
 
 #define LL_IMAGEGL_THREAD_CHECK 0 //set to 1 to enable thread debugging for ImageGL
 
+class LLImageDXT;
+class LLImageMipChain;
 class LLWindow;
 
 #define BYTES_TO_MEGA_BYTES(x) ((x) >> 20)
@@ -67,6 +69,9 @@ class LLImageGL : public LLRefCount
     static S32 dataFormatBits(S32 dataformat);
     static S64 dataFormatBytes(S32 dataformat, S32 width, S32 height);
     static S32 dataFormatComponents(S32 dataformat);
+    // GL format for a block compressed DXR/BC5R/BC7R image, 0 when it
+    // isn't one or the GL can't sample it
+    static LLGLenum getCompressedFormat(const LLImageDXT* image);
 
     BOOL updateBindStats() const ;
     F32 getTimePassedSinceLastBound();
@@ -102,6 +107,8 @@ class LLImageGL : public LLRefCount
 
     void analyzeAlpha(const void* data_in, U32 w, U32 h);
     void calcAlphaChannelOffsetAndStride();
+    // Size and format for raw data of raw_w x raw_h at discard_level
+    BOOL setSizeAndFormat(S32 discard_level, S32 raw_w, S32 raw_h, S32 components);
 
 public:
     virtual void dump();    // debugging info to LL_INFOS()
@@ -116,6 +123,17 @@ class LLImageGL : public LLRefCount
     BOOL createGLTexture(S32 discard_level, const LLImageRaw* imageraw, S32 usename = 0, BOOL to_create = TRUE,
         S32 category = sMaxCategories-1, bool defer_copy = false, LLGLuint* tex_name = nullptr);
     BOOL createGLTexture(S32 discard_level, const U8* data, BOOL data_hasmips = FALSE, S32 usename = 0, bool defer_copy = false, LLGLuint* tex_name = nullptr);
+    // Upload a chain built by LLImageMipChain instead of generating the
+    // mips here. Level 0 of the chain is the image at discard_level.
+    // Chains too short for this texture only contribute their level 0.
+    BOOL createGLTexture(S32 discard_level, const LLImageMipChain* mips, S32 usename = 0,
+        S32 category = sMaxCategories-1, bool defer_copy = false, LLGLuint* tex_name = nullptr);
+    // Upload an image compressed ahead of time, see LLImageDXT::encodeCompressed().
+    // source is the raw image it was made of, used for the alpha and pick mask
+    // analysis, or null to skip it. The format set here lasts until the next
+    // raw upload.
+    BOOL createGLTexture(S32 discard_level, LLImageDXT* compressed, const LLImageRaw* source, S32 usename = 0,
+        S32 category = sMaxCategories-1, bool defer_copy = false, LLGLuint* tex_name = nullptr);
     void setImage(const LLImageRaw* imageraw);
     BOOL setImage(const U8* data_in, BOOL data_hasmips = FALSE, S32 usename = 0);
     // *TODO: This function may not work if the textures is compressed (i.e.
@@ -150,6 +168,7 @@ class LLImageGL : public LLRefCount
     BOOL getBoundRecently() const;
     BOOL isJustBound() const;
     BOOL getHasExplicitFormat() const { return mHasExplicitFormat; }
+    bool getPrecompressed() const { return mPrecompressed; }
     LLGLenum getPrimaryFormat() const { return mFormatPrimary; }
     LLGLenum getFormatType() const { return mFormatType; }
 
@@ -226,6 +245,7 @@ class LLImageGL : public LLRefCount
     U16 mPickMaskHeight;
     S8 mUseMipMaps;
     BOOL mHasExplicitFormat; // If false (default), GL format is f(mComponents)
+    bool mPrecompressed;     // The explicit format was set by the LLImageDXT upload
     bool mAutoGenMips = false;
 
     BOOL mIsMask;
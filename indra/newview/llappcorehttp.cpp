@@ -52,6 +52,7 @@
 
 const F64 LLAppCoreHttp::MAX_THREAD_WAIT_TIME(10.0);
 const long LLAppCoreHttp::PIPELINING_DEPTH(5L);
+const long LLAppCoreHttp::HTTP2_STREAMS(16L);
 
 //  Default and dynamic values for classes
 static const struct
@@ -61,62 +62,64 @@ static const struct
     U32                         mMax;
     U32                         mRate;
     bool                        mPipelined;
+    bool                        mMultiplexed;
+    bool                        mAdaptive;
     std::string                 mKey;
     const char *                mUsage;
 } init_data[LLAppCoreHttp::AP_COUNT] =
 {
     { // AP_DEFAULT
-        8,      8,      8,      0,      false,
+        8,      8,      8,      0,      false,  false,  false,
         "",
         "other"
     },
     { // AP_ASSET
-        8,      1,      16,     0,      true,
+        8,      1,      16,     0,      true,   true,   true,
         "AssetFetchConcurrency",
         "asset fetch"
     },
     { // AP_TEXTURE
-        8,      1,      12,     0,      true,
+        8,      1,      12,     0,      true,   true,   true,
         "TextureFetchConcurrency",
         "texture fetch"
     },
     { // AP_MESH1
-        32,     1,      128,    0,      false,
+        32,     1,      128,    0,      false,  true,   true,
         "MeshMaxConcurrentRequests",
         "mesh fetch"
     },
     { // AP_MESH2
-        8,      1,      32,     0,      true,
+        8,      1,      32,     0,      true,   true,   true,
         "Mesh2MaxConcurrentRequests",
         "mesh2 fetch"
     },
     { // AP_LARGE_MESH
-        2,      1,      8,      0,      false,
+        2,      1,      8,      0,      false,  true,   true,
         "",
         "large mesh fetch"
     },
     { // AP_UPLOADS
-        2,      1,      8,      0,      false,
+        2,      1,      8,      0,      false,  false,  false,
         "",
         "asset upload"
     },
     { // AP_LONG_POLL
-        32,     32,     32,     0,      false,
+        32,     32,     32,     0,      false,  false,  false,
         "",
         "long poll"
     },
     { // AP_INVENTORY
-        4,      1,      4,      0,      false,
+        4,      1,      4,      0,      false,  true,   true,
         "",
         "inventory"
     },
     { // AP_MATERIALS
-        2,      1,      8,      0,      false,
+        2,      1,      8,      0,      false,  false,  false,
         "RenderMaterials",
         "material manager requests"
     },
     { // AP_AGENT
-        2,      1,      32,     0,      false,
+        2,      1,      32,     0,      false,  false,  false,
         "Agent",
         "Agent requests"
     }
@@ -129,7 +132,9 @@ static void ssl_verification_changed();
 LLAppCoreHttp::HttpClass::HttpClass()
     : mPolicy(LLCore::HttpRequest::DEFAULT_POLICY_ID),
       mConnLimit(0U),
-      mPipelined(false)
+      mPipelined(false),
+      mMultiplexed(false),
+      mAdaptive(false)
 {}
 
 
@@ -138,7 +143,9 @@ LLAppCoreHttp::LLAppCoreHttp()
       mStopHandle(LLCORE_HTTP_HANDLE_INVALID),
       mStopRequested(0.0),
       mStopped(false),
-      mPipelined(true)
+      mPipelined(true),
+      mMultiplexed(false),
+      mAdaptive(false)
 {}
 
 
@@ -275,6 +282,22 @@ void LLAppCoreHttp::init()
         }
     }
 
+    // Global HTTP/2 multiplexing setting, needed by the initial settings pass
+    static const std::string http_multiplexing("HttpMultiplexing");
+    if (gSavedSettings.controlExists(http_multiplexing))
+    {
+        mMultiplexed = gSavedSettings.getBOOL(http_multiplexing);
+        LL_INFOS("Init") << "HTTP/2 multiplexing " << (mMultiplexed ? "enabled" : "disabled") << "!" << LL_ENDL;
+    }
+
+    // Global adaptive concurrency setting, also only read at startup
+    static const std::string http_adaptive("HttpAdaptiveConcurrency");
+    if (gSavedSettings.controlExists(http_adaptive))
+    {
+        mAdaptive = gSavedSettings.getBOOL(http_adaptive);
+        LL_INFOS("Init") << "HTTP adaptive concurrency " << (mAdaptive ? "enabled" : "disabled") << "!" << LL_ENDL;
+    }
+
     // Need a request object to handle dynamic options before setting them
     mRequest = new LLCore::HttpRequest;
 
@@ -468,6 +491,63 @@ void LLAppCoreHttp::refreshSettings(bool initial)
             }
         }
 
+        // HTTP/2 election.  Like pipelining, only applied at startup.
+        if (initial)
+        {
+            const bool to_multiplex(mMultiplexed && init_data[i].mMultiplexed);
+            if (to_multiplex != mHttpClasses[app_policy].mMultiplexed)
+            {
+                LLCore::HttpHandle handle;
+                const long new_streams(to_multiplex ? HTTP2_STREAMS : 0);
+
+                handle = mRequest->setPolicyOption(LLCore::HttpRequest::PO_HTTP2_STREAMS,
+                                                   mHttpClasses[app_policy].mPolicy,
+                                                   new_streams,
+                                                   LLCore::HttpHandler::ptr_t());
+                if (LLCORE_HTTP_HANDLE_INVALID == handle)
+                {
+                    status = mRequest->getStatus();
+                    LL_WARNS("Init") << "Unable to set " << init_data[i].mUsage
+                                     << " HTTP/2 streams.  Reason:  " << status.toString()
+                                     << LL_ENDL;
+                }
+                else
+                {
+                    LL_DEBUGS("Init") << "Changed " << init_data[i].mUsage
+                                      << " HTTP/2 streams.  New value:  " << new_streams
+                                      << LL_ENDL;
+                    mHttpClasses[app_policy].mMultiplexed = to_multiplex;
+                }
+            }
+        }
+
+        // Adaptive concurrency election.  The concurrency settings
+        // below then become ceilings for the controller.
+        if (initial)
+        {
+            const bool to_adapt(mAdaptive && init_data[i].mAdaptive);
+            if (to_adapt != mHttpClasses[app_policy].mAdaptive)
+            {
+                LLCore::HttpHandle handle;
+
+                handle = mRequest->setPolicyOption(LLCore::HttpRequest::PO_ADAPTIVE_CONCURRENCY,
+                                                   mHttpClasses[app_policy].mPolicy,
+                                                   (to_adapt ? 1L : 0L),
+                                                   LLCore::HttpHandler::ptr_t());
+                if (LLCORE_HTTP_HANDLE_INVALID == handle)
+                {
+                    status = mRequest->getStatus();
+                    LL_WARNS("Init") << "Unable to set " << init_data[i].mUsage
+                                     << " adaptive concurrency.  Reason:  " << status.toString()
+                                     << LL_ENDL;
+                }
+                else
+                {
+                    mHttpClasses[app_policy].mAdaptive = to_adapt;
+                }
+            }
+        }
+
         // Get target connection concurrency value
         U32 setting(init_data[i].mDefault);
         if (! init_data[i].mKey.empty() && gSavedSettings.controlExists(init_data[i].mKey))
@@ -499,7 +579,8 @@ void LLAppCoreHttp::refreshSettings(bool initial)
             LLCore::HttpHandle handle;
             handle = mRequest->setPolicyOption(LLCore::HttpRequest::PO_CONNECTION_LIMIT,
                                                mHttpClasses[app_policy].mPolicy,
-                                               (mHttpClasses[app_policy].mPipelined ? 2 * setting : setting),
+                                               ((mHttpClasses[app_policy].mPipelined || mHttpClasses[app_policy].mMultiplexed)
+                                                ? 2 * setting : setting),
                                                LLCore::HttpHandler::ptr_t());
             if (LLCORE_HTTP_HANDLE_INVALID == handle)
             {
@@ -42,6 +42,7 @@ class LLAppCoreHttp : public LLCore::HttpHandler
 {
 public:
     static const long           PIPELINING_DEPTH;
+    static const long           HTTP2_STREAMS;
 
     typedef LLCore::HttpRequest::policy_t policy_t;
 
@@ -260,6 +261,8 @@ class LLAppCoreHttp : public LLCore::HttpHandler
         policy_t                    mPolicy;            // Policy class id for the class
         U32                         mConnLimit;
         bool                        mPipelined;
+        bool                        mMultiplexed;       // Class runs HTTP/2 streams
+        bool                        mAdaptive;          // Class adapts its in-flight limit
         boost::signals2::connection mSettingsSignal;    // Signal to global setting that affect this class (if any)
     };
 
@@ -269,6 +272,8 @@ class LLAppCoreHttp : public LLCore::HttpHandler
     bool                        mStopped;
     HttpClass                   mHttpClasses[AP_COUNT];
     bool                        mPipelined;             // Global setting
+    bool                        mMultiplexed;           // Global 'HttpMultiplexing' setting
+    bool                        mAdaptive;              // Global 'HttpAdaptiveConcurrency' setting
     boost::signals2::connection mPipelinedSignal;       // Signal for 'HttpPipelining' setting
     boost::signals2::connection mSSLNoVerifySignal;     // Signal for 'NoVerifySSLCert' setting
 
@@ -56,6 +56,7 @@
 #include "llmarketplacenotifications.h"
 #include "llmd5.h"
 #include "llmeshrepository.h"
+#include "llmeshdecodedcache.h"
 #include "llpumpio.h"
 #include "llmimetypes.h"
 #include "llslurl.h"
@@ -133,6 +134,7 @@
 #include "llurlentry.h"
 #include "llvolumemgr.h"
 #include "llxfermanager.h"
+#include "llmessagecapture.h"
 #include "llphysicsextensions.h"
 
 #include "llnotificationmanager.h"
@@ -175,6 +177,7 @@
 #include "llworkerthread.h"
 #include "lltexturecache.h"
 #include "lltexturefetch.h"
+#include "llviewerbenchmark.h"
 #include "llimageworker.h"
 #include "llevents.h"
 
@@ -557,6 +560,8 @@ static void settings_to_globals()
     LLVOVolume::sLODFactor              = llclamp(gSavedSettings.getF32("RenderVolumeLODFactor"), 0.01f, MAX_LOD_FACTOR);
     LLVOVolume::sDistanceFactor         = 1.f-LLVOVolume::sLODFactor * 0.1f;
     LLVolumeImplFlexible::sUpdateFactor = gSavedSettings.getF32("RenderFlexTimeFactor");
+    LLVolume::sUseBVH                   = gSavedSettings.getBOOL("RaycastUseBVH");
+    LLViewerOctreePartition::sUseLinearOctree = gSavedSettings.getBOOL("OctreeLinearCulling");
     LLVOTree::sTreeFactor               = gSavedSettings.getF32("RenderTreeLODFactor");
     LLVOAvatar::sLODFactor              = llclamp(gSavedSettings.getF32("RenderAvatarLODFactor"), 0.f, MAX_AVATAR_LOD_FACTOR);
     LLVOAvatar::sPhysicsLODFactor       = llclamp(gSavedSettings.getF32("RenderAvatarPhysicsLODFactor"), 0.f, MAX_AVATAR_LOD_FACTOR);
@@ -939,6 +944,10 @@ bool LLAppViewer::init()
     }
     LL_INFOS("InitInfo") << "Cache initialization is done." << LL_ENDL ;
 
+    // Benchmarks asked for on the command line, see --texturefetchbenchmark,
+    // --meshdecodebenchmark and the others
+    LLViewerBenchmark::initClass();
+
     // Initialize event recorder
     LLViewerEventRecorder::createInstance();
 
@@ -1195,6 +1204,7 @@ bool LLAppViewer::init()
     LLCoprocedureManager::getInstance()->setPropertyMethods(
         boost::bind(&LLControlGroup::getU32, boost::ref(gSavedSettings), _1),
         boost::bind(&LLControlGroup::declareU32, boost::ref(gSavedSettings), _1, _2, _3, LLControlVariable::PERSIST_ALWAYS));
+    LLViewerObjectList::initFetchPool();
 
     // TODO: consider moving proxy initialization here or LLCopocedureManager after proxy initialization, may be implement
     // some other protection to make sure we don't use network before initializng proxy
@@ -1720,6 +1730,8 @@ bool LLAppViewer::cleanup()
 
     LL_INFOS() << "Cleaning Up" << LL_ENDL;
 
+    LLViewerBenchmark::cleanupClass();
+
     // shut down mesh streamer
     gMeshRepo.shutdown();
 
@@ -2011,6 +2023,7 @@ bool LLAppViewer::cleanup()
     LLDiskCache::deleteSingleton();
 
     LL_INFOS() << "Shutting down message system" << LL_ENDL;
+    LLMessageCapture::stop();
     end_messaging_system();
 
     // Non-LLCurl libcurl library
@@ -2169,6 +2182,15 @@ bool LLAppViewer::initThreads()
 
     // Image decoding
     LLAppViewer::sImageDecodeThread = new LLImageDecodeThread(enable_threads && true);
+    // Large textures may spread their decode over the idle part of the
+    // ImageDecode pool rather than adding threads of their own. The budget
+    // is the width the pool actually got, after any ThreadPoolSizes
+    // override, and every decode counts against it along with the threads
+    // it borrows, so decoding never runs more threads than the pool has.
+    // The pool itself is sized to leave the other viewer threads their
+    // cores, so a 1 thread pool decodes each image on 1 thread.
+    S32 decode_budget = (S32)LL::ThreadPoolBase::getWidth("ImageDecode", image_decode_count);
+    LLImageJ2C::setDecodeThreading(decode_budget, gSavedSettings.getS32("TextureDecodeThreadedMinArea"));
     LLAppViewer::sTextureCache = new LLTextureCache(enable_threads && true);
     LLAppViewer::sTextureFetch = new LLTextureFetch(LLAppViewer::getTextureCache(),
                                                     enable_threads && true,
@@ -2881,7 +2903,7 @@ bool LLAppViewer::initConfiguration()
 
     //LLVolumeMgr::initClass();
     LLVolumeMgr* volume_manager = new LLVolumeMgr();
-    volume_manager->useMutex(); // LLApp and LLMutex magic must be manually enabled
+    volume_manager->startGenerationPool();
     LLPrimitive::setVolumeManager(volume_manager);
 
     // Note: this is where we used to initialize gFeatureManagerp.
@@ -3922,6 +3944,7 @@ void LLAppViewer::fastQuit(S32 error_code)
     // let sim know we're logging out
     sendLogoutRequest();
     // flush network buffers by shutting down messaging system
+    LLMessageCapture::stop();
     end_messaging_system();
     // figure out the error code
     S32 final_error_code = error_code ? error_code : (S32)isError();
@@ -4166,6 +4189,13 @@ bool LLAppViewer::initCache()
             // purge excessive files from the new file system based cache in background thread
             LLAppViewer::getPurgeDiskCacheThread()->start();
         }
+
+        // Unpacked mesh LODs, sized on their own on top of DiskCacheSize
+        const S64 decoded_mesh_size = gSavedSettings.getBOOL("MeshDecodedCacheEnabled") ?
+            (S64)gSavedSettings.getU32("MeshDecodedCacheSize") * 1024ll * 1024ll : 0;
+        gMeshRepo.getDecodedCache()->initCache(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "meshdecoded"),
+                                               decoded_mesh_size, gSavedSettings.getU32("MeshDecodedCacheMinUses"),
+                                               read_only);
     }
 
     // Init the texture cache
@@ -4223,6 +4253,7 @@ void LLAppViewer::purgeCache()
 
     LLSplashScreen::update(LLTrans::getString("StartupClearingDiskCache"));
     LLDiskCache::getInstance()->clearCache(LL_PATH_CACHE, false);
+    gMeshRepo.getDecodedCache()->purge(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "meshdecoded"), true);
 
     LLSplashScreen::update(LLTrans::getString("StartupClearingObjectCache"));
     LLVOCache::getInstance()->removeCache(LL_PATH_CACHE);
@@ -4250,6 +4281,7 @@ void LLAppViewer::purgeCacheSelective(const LLSD& insd)
         LL_INFOS("AppCache") << "Purging Disk Cache..." << LL_ENDL;
         LLSplashScreen::update(LLTrans::getString("StartupClearingDiskCache"));
         LLDiskCache::getInstance()->clearCache(LL_PATH_CACHE, false);
+        gMeshRepo.getDecodedCache()->purge(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "meshdecoded"), true);
     }
 
     if (insd.has("regions"))
@@ -4641,6 +4673,8 @@ void LLAppViewer::idle()
         }
     }
 
+    LLViewerBenchmark::updateClass();
+
     // Must wait until both have avatar object and mute list, so poll
     // here.
     LLIMProcessing::requestOfflineMessages();
@@ -0,0 +1,441 @@
+/**
+ * @file lldecodeddiskcache.cpp
+ * @brief Indexed disk store shared by the decoded texture and mesh caches
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "lldecodeddiskcache.h"
+
+#include "llapr.h"
+#include "lldir.h"
+#include "workqueue.h"
+
+#include <algorithm>
+
+// Cache organization:
+// <dir>/decoded.entries
+//  IndexHeader followed by one IndexRecord per known key
+// <dir>/[0-F]/UUID_level_variant.decoded
+//  Whatever the subclass builds
+
+namespace
+{
+    const U32 INDEX_VERSION = 1;
+
+    // Reduce the cache to this fraction of its size when it is full
+    const F32 DECODED_CACHE_PURGE_AMOUNT = .10f;
+    // Entries counted but not yet written. Beyond this the oldest quarter
+    // is forgotten.
+    const size_t MAX_UNSTORED_ENTRIES = 32768;
+
+#if LL_WINDOWS
+#pragma pack(push,1)
+#endif
+    struct IndexHeader
+    {
+        U32 mMagic;
+        U32 mVersion;
+        U32 mCount;
+    };
+    struct IndexRecord
+    {
+        LLUUID mID;
+        S32 mLevel;
+        U32 mVariant;
+        U32 mTime;
+        U32 mUses;
+        S32 mSize;
+    };
+#if LL_WINDOWS
+#pragma pack(pop)
+#endif
+}
+
+LLDecodedDiskCache::LLDecodedDiskCache(const char* description, U32 index_magic)
+    : mDescription(description),
+      mIndexMagic(index_magic),
+      mMutex(),
+      mMaxSize(0),
+      mMinUses(2),
+      mReadOnly(true),
+      mUsage(0),
+      mEntryCount(0)
+{
+}
+
+LLDecodedDiskCache::~LLDecodedDiskCache()
+{
+}
+
+// Called in the main thread
+void LLDecodedDiskCache::initCache(const std::string& dir_name, S64 max_size, U32 min_uses, bool read_only)
+{
+    mDirName = dir_name;
+    mIndexFileName = mDirName + gDirUtilp->getDirDelimiter() + "decoded.entries";
+    mMinUses = llmax(min_uses, 1U);
+    mReadOnly = read_only;
+    if (max_size <= 0)
+    {
+        mMaxSize = 0;
+        return;
+    }
+
+    if (!mReadOnly)
+    {
+        LLFile::mkdir(mDirName);
+        const char* subdirs = "0123456789abcdef";
+        for (S32 i = 0; i < 16; i++)
+        {
+            LLFile::mkdir(mDirName + gDirUtilp->getDirDelimiter() + subdirs[i]);
+        }
+    }
+    readIndex();
+
+    std::vector<std::string> files;
+    {
+        LLMutexLock lock(&mMutex);
+        mMaxSize = max_size;
+        if (mUsage > mMaxSize)
+        {
+            purgeEntries(files);
+        }
+    }
+    for (const std::string& file : files)
+    {
+        LLAPRFile::remove(file);
+    }
+
+    LL_INFOS("DecodedCache") << mDescription << ": " << mEntryCount.load() << " using " << mUsage.load() / (1024 * 1024)
+                             << " of " << mMaxSize / (1024 * 1024) << " MB" << LL_ENDL;
+}
+
+// Called in the main thread
+void LLDecodedDiskCache::purge(const std::string& dir_name, bool remove_dir)
+{
+    const char* subdirs = "0123456789abcdef";
+    std::string delem = gDirUtilp->getDirDelimiter();
+    for (S32 i = 0; i < 16; i++)
+    {
+        std::string dirname = dir_name + delem + subdirs[i];
+        if (remove_dir)
+        {
+            gDirUtilp->deleteDirAndContents(dirname);
+        }
+        else
+        {
+            gDirUtilp->deleteFilesInDir(dirname, "*");
+        }
+    }
+    gDirUtilp->deleteFilesInDir(dir_name, "*"); // index
+    if (remove_dir)
+    {
+        LLFile::rmdir(dir_name);
+    }
+
+    LLMutexLock lock(&mMutex);
+    mEntries.clear();
+    mUsage = 0;
+    mEntryCount = 0;
+}
+
+std::string LLDecodedDiskCache::getFileName(const Key& key) const
+{
+    std::string idstr = key.mID.asString();
+    std::string delem = gDirUtilp->getDirDelimiter();
+    return llformat("%s%s%c%s%s_%d_%u.decoded", mDirName.c_str(), delem.c_str(), idstr[0], delem.c_str(), idstr.c_str(),
+                    key.mLevel, key.mVariant);
+}
+
+// Called in the main thread from initCache(). A missing or damaged index
+// leaves files nothing knows about, so the directory is cleared.
+void LLDecodedDiskCache::readIndex()
+{
+    std::vector<IndexRecord> records;
+    IndexHeader header;
+    bool valid = LLAPRFile::readEx(mIndexFileName, &header, 0, sizeof(header)) == (S32)sizeof(header) &&
+                 header.mMagic == mIndexMagic && header.mVersion == INDEX_VERSION;
+    if (valid && header.mCount > 0)
+    {
+        S64 bytes = (S64)header.mCount * (S64)sizeof(IndexRecord);
+        valid = LLAPRFile::size(mIndexFileName) == (S64)sizeof(header) + bytes;
+        if (valid)
+        {
+            records.resize(header.mCount);
+            valid = LLAPRFile::readEx(mIndexFileName, records.data(), sizeof(header), (S32)bytes) == (S32)bytes;
+        }
+    }
+    if (!valid)
+    {
+        if (!mReadOnly)
+        {
+            purge(mDirName, false);
+        }
+        return;
+    }
+
+    LLMutexLock lock(&mMutex);
+    mEntries.clear();
+    S64 usage = 0;
+    U32 count = 0;
+    for (const IndexRecord& record : records)
+    {
+        Entry& entry = mEntries[Key{ record.mID, record.mLevel, record.mVariant }];
+        entry.mTime = record.mTime;
+        entry.mUses = record.mUses;
+        entry.mSize = llmax(record.mSize, 0);
+        if (entry.mSize > 0)
+        {
+            usage += entry.mSize;
+            ++count;
+        }
+    }
+    mUsage = usage;
+    mEntryCount = count;
+}
+
+// Called in the main thread, at shutdown. Files still being written are
+// saved as not written and so are written again later.
+void LLDecodedDiskCache::writeIndex()
+{
+    if (mReadOnly || !isEnabled())
+    {
+        return;
+    }
+
+    std::vector<U8> buffer;
+    {
+        LLMutexLock lock(&mMutex);
+        buffer.resize(sizeof(IndexHeader) + mEntries.size() * sizeof(IndexRecord));
+        IndexHeader* header = (IndexHeader*)buffer.data();
+        header->mMagic = mIndexMagic;
+        header->mVersion = INDEX_VERSION;
+        header->mCount = (U32)mEntries.size();
+        IndexRecord* record = (IndexRecord*)(buffer.data() + sizeof(IndexHeader));
+        for (const entry_map_t::value_type& pair : mEntries)
+        {
+            record->mID = pair.first.mID;
+            record->mLevel = pair.first.mLevel;
+            record->mVariant = pair.first.mVariant;
+            record->mTime = pair.second.mTime;
+            record->mUses = pair.second.mUses;
+            record->mSize = llmax(pair.second.mSize, 0);
+            ++record;
+        }
+    }
+    // writeEx() doesn't truncate
+    LLAPRFile::remove(mIndexFileName);
+    LLAPRFile::writeEx(mIndexFileName, buffer.data(), 0, (S32)buffer.size());
+}
+
+S32 LLDecodedDiskCache::getStoredSize(const Key& key)
+{
+    if (!isEnabled())
+    {
+        return 0;
+    }
+    LLMutexLock lock(&mMutex);
+    entry_map_t::iterator iter = mEntries.find(key);
+    return iter == mEntries.end() ? 0 : llmax(iter->second.mSize, 0);
+}
+
+bool LLDecodedDiskCache::finishRead(const Key& key, bool success)
+{
+    LLMutexLock lock(&mMutex);
+    entry_map_t::iterator iter = mEntries.find(key);
+    if (iter == mEntries.end() || iter->second.mSize <= 0)
+    {
+        // Purged while we were reading
+        return false;
+    }
+    if (!success)
+    {
+        // Missing or damaged, forget it and let it be written again
+        mUsage -= iter->second.mSize;
+        --mEntryCount;
+        iter->second.mSize = 0;
+        return false;
+    }
+    iter->second.mTime = (U32)time(NULL);
+    ++iter->second.mUses;
+    return true;
+}
+
+bool LLDecodedDiskCache::countUse(const Key& key)
+{
+    if (!isEnabled() || mReadOnly)
+    {
+        return false;
+    }
+
+    LLMutexLock lock(&mMutex);
+    Entry& entry = mEntries[key];
+    entry.mTime = (U32)time(NULL);
+    ++entry.mUses;
+    if (entry.mSize != 0 || entry.mUses < mMinUses)
+    {
+        if (mEntries.size() - mEntryCount > MAX_UNSTORED_ENTRIES)
+        {
+            trimUnstored();
+        }
+        return false;
+    }
+    entry.mSize = -1;
+    return true;
+}
+
+void LLDecodedDiskCache::write(const Key& key, make_file_t make_file)
+{
+    LL::WorkQueue::ptr_t queue = LL::WorkQueue::getInstance("General");
+    std::shared_ptr<LLDecodedDiskCache> self = shared_from_this();
+    if (!queue || !queue->post([self, key, make_file]() { self->writeFile(key, make_file); }))
+    {
+        // Shutting down
+        cancelWrite(key);
+    }
+}
+
+void LLDecodedDiskCache::cancelWrite(const Key& key)
+{
+    LLMutexLock lock(&mMutex);
+    entry_map_t::iterator iter = mEntries.find(key);
+    if (iter != mEntries.end() && iter->second.mSize < 0)
+    {
+        iter->second.mSize = 0;
+    }
+}
+
+// Called from the General work queue
+void LLDecodedDiskCache::writeFile(const Key& key, const make_file_t& make_file)
+{
+    std::vector<U8> buffer;
+    bool made = false;
+    try
+    {
+        made = make_file(buffer);
+    }
+    catch (const std::bad_alloc&)
+    {
+        LL_WARNS_ONCE("DecodedCache") << "Out of memory building " << getFileName(key) << LL_ENDL;
+    }
+    if (!made || buffer.empty())
+    {
+        cancelWrite(key);
+        return;
+    }
+
+    std::string filename = getFileName(key);
+    LLAPRFile::remove(filename);
+    S32 written = LLAPRFile::writeEx(filename, buffer.data(), 0, (S32)buffer.size());
+
+    std::vector<std::string> files;
+    {
+        LLMutexLock lock(&mMutex);
+        entry_map_t::iterator iter = mEntries.find(key);
+        if (iter == mEntries.end() || iter->second.mSize >= 0)
+        {
+            // Purged while we were writing
+            files.push_back(filename);
+        }
+        else if (written != (S32)buffer.size())
+        {
+            iter->second.mSize = 0;
+            files.push_back(filename);
+        }
+        else
+        {
+            iter->second.mSize = written;
+            mUsage += written;
+            ++mEntryCount;
+            if (mUsage > mMaxSize)
+            {
+                purgeEntries(files);
+            }
+        }
+    }
+    for (const std::string& file : files)
+    {
+        LLAPRFile::remove(file);
+    }
+}
+
+// mMutex must be locked
+void LLDecodedDiskCache::purgeEntries(std::vector<std::string>& files)
+{
+    std::vector<std::pair<U32, Key> > stored;
+    stored.reserve(mEntryCount);
+    for (const entry_map_t::value_type& pair : mEntries)
+    {
+        if (pair.second.mSize > 0)
+        {
+            stored.emplace_back(pair.second.mTime, pair.first);
+        }
+    }
+    std::sort(stored.begin(), stored.end(),
+              [](const std::pair<U32, Key>& a, const std::pair<U32, Key>& b) { return a.first < b.first; });
+
+    S64 target = (S64)((F64)mMaxSize * (1.0 - DECODED_CACHE_PURGE_AMOUNT));
+    for (const std::pair<U32, Key>& oldest : stored)
+    {
+        if (mUsage <= target)
+        {
+            break;
+        }
+        Entry& entry = mEntries[oldest.second];
+        mUsage -= entry.mSize;
+        --mEntryCount;
+        // Keep the use count, it is cheap and lets the entry back in
+        // quickly if it turns out to be popular after all
+        entry.mSize = 0;
+        files.push_back(getFileName(oldest.second));
+    }
+}
+
+// mMutex must be locked
+void LLDecodedDiskCache::trimUnstored()
+{
+    std::vector<U32> times;
+    times.reserve(mEntries.size());
+    for (const entry_map_t::value_type& pair : mEntries)
+    {
+        if (pair.second.mSize == 0)
+        {
+            times.push_back(pair.second.mTime);
+        }
+    }
+    std::vector<U32>::iterator quarter = times.begin() + times.size() / 4;
+    std::nth_element(times.begin(), quarter, times.end());
+    U32 cutoff = *quarter;
+    for (entry_map_t::iterator iter = mEntries.begin(); iter != mEntries.end();)
+    {
+        if (iter->second.mSize == 0 && iter->second.mTime <= cutoff)
+        {
+            iter = mEntries.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
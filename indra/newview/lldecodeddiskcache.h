@@ -0,0 +1,142 @@
+/**
+ * @file lldecodeddiskcache.h
+ * @brief Indexed disk store shared by the decoded texture and mesh caches
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLDECODEDDISKCACHE_H
+#define LL_LLDECODEDDISKCACHE_H
+
+#include "llmutex.h"
+#include "lluuid.h"
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Files of decoded assets, one per (id, level, variant), with an index of
+// use counts, ages and sizes. An entry is only written once it has been
+// counted min_uses times, which keeps one-off assets from churning the
+// cache, and the least recently used files are removed when the cache grows
+// past its size.
+//
+// Subclasses decide what goes in the files: they build the file contents
+// for write() and parse what they read back. Writes run on the "General"
+// work queue. Everything but init, purge and writeIndex is thread safe.
+class LLDecodedDiskCache : public std::enable_shared_from_this<LLDecodedDiskCache>
+{
+public:
+    // level is the discard or LOD, variant anything else that changes the
+    // decoded data
+    struct Key
+    {
+        LLUUID mID;
+        S32 mLevel;
+        U32 mVariant;
+        bool operator<(const Key& rhs) const
+        {
+            if (mID != rhs.mID)
+            {
+                return mID < rhs.mID;
+            }
+            return mLevel == rhs.mLevel ? mVariant < rhs.mVariant : mLevel < rhs.mLevel;
+        }
+    };
+
+    // description names the entries in the summary logged by initCache(),
+    // index_magic tells the indexes of different caches apart
+    LLDecodedDiskCache(const char* description, U32 index_magic);
+    virtual ~LLDecodedDiskCache();
+
+    // Called in the main thread. A max_size of 0 disables the cache.
+    void initCache(const std::string& dir_name, S64 max_size, U32 min_uses, bool read_only);
+    // Removes all files. Called in the main thread, and works before
+    // initCache(). Callers check for read only.
+    void purge(const std::string& dir_name, bool remove_dir);
+    // Saves the index so that use counts and ages survive a restart
+    void writeIndex();
+
+    bool isEnabled() const { return mMaxSize > 0; }
+    bool isReadOnly() const { return mReadOnly; }
+
+    // debug
+    S64 getUsage() const { return mUsage; }
+    S64 getMaxUsage() const { return mMaxSize; }
+    U32 getEntries() const { return mEntryCount; }
+
+protected:
+    typedef std::function<bool(std::vector<U8>& file)> make_file_t;
+
+    std::string getFileName(const Key& key) const;
+    // Bytes on disk of key, 0 if it isn't stored
+    S32 getStoredSize(const Key& key);
+    // Called once a stored entry has been read. Returns success, or false
+    // if the entry was purged meanwhile. A failed read forgets the file so
+    // that it is written again.
+    bool finishRead(const Key& key, bool success);
+    // Counts a use of key. Returns true when the caller should now store
+    // it, with write() or cancelWrite().
+    bool countUse(const Key& key);
+    // Runs make_file on the General work queue and writes what it builds
+    // as the file of key. make_file returns false if it couldn't.
+    void write(const Key& key, make_file_t make_file);
+    // Called instead of write() when the caller can't provide the data
+    void cancelWrite(const Key& key);
+
+private:
+    struct Entry
+    {
+        U32 mTime = 0;      // seconds since 1/1/1970 of the last use
+        U32 mUses = 0;
+        S32 mSize = 0;      // bytes on disk, 0 if not written, -1 while being written
+    };
+    typedef std::map<Key, Entry> entry_map_t;
+
+    void readIndex();
+    void writeFile(const Key& key, const make_file_t& make_file);
+    // Called with mMutex locked. Returns the files to remove once unlocked.
+    void purgeEntries(std::vector<std::string>& files);
+    // Called with mMutex locked. Forgets the oldest entries that were
+    // counted but never written.
+    void trimUnstored();
+
+private:
+    const char* mDescription;
+    const U32 mIndexMagic;
+
+    LLMutex mMutex;
+    entry_map_t mEntries;
+
+    std::string mDirName;
+    std::string mIndexFileName;
+    S64 mMaxSize;
+    U32 mMinUses;
+    bool mReadOnly;
+
+    std::atomic<S64> mUsage;
+    std::atomic<U32> mEntryCount; // stored entries
+};
+
+#endif // LL_LLDECODEDDISKCACHE_H
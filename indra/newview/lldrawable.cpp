@@ -1787,7 +1787,7 @@ LLHUDBridge::LLHUDBridge(LLDrawable* drawablep, LLViewerRegion* regionp)
     mSlopRatio = 0.0f;
 }
 
-F32 LLHUDBridge::calcPixelArea(LLSpatialGroup* group, LLCamera& camera)
+F32 LLHUDBridge::calcPixelArea(LLSpatialGroup* group, LLCamera& camera, F32 estimate)
 {
     return 1024.f;
 }
@@ -0,0 +1,347 @@
+/**
+ * @file llmeshdecodebenchmark.cpp
+ * @brief Decodes a directory of cached mesh assets on the main thread and
+ *        on the mesh decode pool and reports the throughput of each
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llmeshdecodebenchmark.h"
+
+#include "lldir.h"
+#include "llmeshrepository.h"
+#include "llsdserialize.h"
+#include "lltimer.h"
+#include "llviewercontrol.h"
+#include "llvolume.h"
+#include "llvolumemgr.h"
+#include "threadpool.h"
+
+#include <atomic>
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
+
+static const char* SECTION_NAMES[] = { "lod", "skin", "physics_convex", "physics_mesh" };
+
+static LLViewerBenchmark::Registrar<LLMeshDecodeBenchmark> sMeshDecodeBenchmark;
+
+LLMeshDecodeBenchmark::LLMeshDecodeBenchmark()
+    : LLViewerBenchmark("mesh_decode", "MeshDecodeBenchmarkQuit"),
+      mAssets(0),
+      mBytes(0)
+{
+}
+
+bool LLMeshDecodeBenchmark::start()
+{
+    const std::string directory = gSavedSettings.getString("MeshDecodeBenchmarkDir");
+    if (directory.empty())
+    {
+        return false;
+    }
+
+    mJobs.clear();
+    mAssets = 0;
+    mBytes = 0;
+
+    boost::system::error_code ec;
+    for (boost::filesystem::recursive_directory_iterator iter(directory, ec), end; !ec && iter != end; iter.increment(ec))
+    {
+        if (boost::filesystem::is_regular_file(iter->status()))
+        {
+            addAsset(iter->path().string());
+        }
+    }
+
+    if (mJobs.empty())
+    {
+        LL_WARNS() << "No mesh assets found in " << directory << LL_ENDL;
+        return false;
+    }
+
+    LL_INFOS() << "Loaded " << mJobs.size() << " mesh sections from " << mAssets << " assets in " << directory << LL_ENDL;
+    return true;
+}
+
+bool LLMeshDecodeBenchmark::addAsset(const std::string& filename)
+{
+    llifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    auto asset = std::make_shared<std::vector<U8>>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (asset->empty())
+    {
+        return false;
+    }
+
+    // Cache files are named after the mesh id, anything else gets one
+    LLUUID id;
+    std::string name = gDirUtilp->getBaseFileName(filename, true);
+    if (!LLUUID::parseUUID(name.substr(0, UUID_STR_LENGTH - 1), &id))
+    {
+        id.generate();
+    }
+
+    // Same header parse as LLMeshRepoThread::headerReceived()
+    llssize data_size = asset->size();
+    llssize header_size = 0;
+    char* start = strip_deprecated_header((char*)asset->data(), data_size, &header_size);
+    boost::iostreams::stream<boost::iostreams::array_source> stream(start, data_size);
+    LLSD header_data;
+    if (!LLSDSerialize::fromBinary(header_data, stream, data_size) || !header_data.isMap())
+    {
+        return false;
+    }
+    LLMeshHeader header(header_data);
+    header_size += stream.tellg();
+
+    auto add_job = [&](ESection section, S32 lod, S32 offset, S32 size)
+    {
+        if (offset < 0 || size <= 0 || header_size + offset + size > (llssize)asset->size())
+        {
+            return;
+        }
+        // Sections the cache reserved but never wrote are all zeros, see
+        // LLMeshRepoThread::loadInfoFromFilesystem()
+        const U8* data = asset->data() + header_size + offset;
+        bool zero = true;
+        for (S32 i = 0; i < llmin(size, S32(1024)) && zero; ++i)
+        {
+            zero = data[i] == 0;
+        }
+        if (!zero)
+        {
+            mJobs.push_back({ id, section, lod, asset, (S32)header_size + offset, size });
+        }
+    };
+
+    size_t jobs = mJobs.size();
+    for (S32 lod = 0; lod < LLVolumeLODGroup::NUM_LODS; ++lod)
+    {
+        add_job(SECTION_LOD, lod, header.mLodOffset[lod], header.mLodSize[lod]);
+    }
+    add_job(SECTION_SKIN, 0, header.mSkinOffset, header.mSkinSize);
+    add_job(SECTION_CONVEX, 0, header.mPhysicsConvexOffset, header.mPhysicsConvexSize);
+    add_job(SECTION_PHYSICS_MESH, 0, header.mPhysicsMeshOffset, header.mPhysicsMeshSize);
+
+    if (mJobs.size() == jobs)
+    {
+        return false;
+    }
+    ++mAssets;
+    for (size_t i = jobs; i < mJobs.size(); ++i)
+    {
+        mBytes += mJobs[i].mSize;
+    }
+    return true;
+}
+
+// The work of LLMeshRepoThread's *Received() decoders, without queueing the
+// results for the main thread. Safe on any thread.
+//static
+bool LLMeshDecodeBenchmark::decode(const Job& job)
+{
+    U8* data = job.mAsset->data() + job.mOffset;
+    switch (job.mSection)
+    {
+    case SECTION_LOD:
+    case SECTION_PHYSICS_MESH:
+    {
+        LLVolumeParams volume_params;
+        volume_params.setType(LL_PCODE_PROFILE_SQUARE, LL_PCODE_PATH_LINE);
+        volume_params.setSculptID(job.mID, LL_SCULPT_TYPE_MESH);
+        F32 detail = job.mSection == SECTION_LOD ? LLVolumeLODGroup::getVolumeScaleFromDetail(job.mLOD) : 0.f;
+        LLPointer<LLVolume> volume = new LLVolume(volume_params, detail);
+        return volume->unpackVolumeFaces(data, job.mSize) && volume->getNumVolumeFaces() > 0;
+    }
+    case SECTION_SKIN:
+    case SECTION_CONVEX:
+    {
+        LLSD sd;
+        try
+        {
+            if (LLUZipHelper::unzip_llsd(sd, data, job.mSize) != LLUZipHelper::ZR_OK)
+            {
+                return false;
+            }
+            if (job.mSection == SECTION_SKIN)
+            {
+                LLMeshSkinInfo skin_info(job.mID, sd);
+            }
+            else
+            {
+                LLModel::Decomposition decomposition(sd);
+            }
+        }
+        catch (const std::bad_alloc&)
+        {
+            return false;
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+F64 LLMeshDecodeBenchmark::runInline(U32& failed, F64* section_times)
+{
+    failed = 0;
+    LLTimer total;
+    for (const Job& job : mJobs)
+    {
+        F64 start = LLTimer::getTotalSeconds();
+        if (!decode(job))
+        {
+            ++failed;
+        }
+        section_times[job.mSection] += LLTimer::getTotalSeconds() - start;
+    }
+    return total.getElapsedTimeF64();
+}
+
+F64 LLMeshDecodeBenchmark::runPooled(U32& failed)
+{
+    std::atomic<U32> done(0);
+    std::atomic<U32> bad(0);
+    LL::WorkQueue::ptr_t queue = LL::WorkQueue::getInstance("MeshDecode");
+
+    LLTimer total;
+    for (const Job& job : mJobs)
+    {
+        const Job* jobp = &job;
+        if (!queue->post([jobp, &done, &bad]()
+                {
+                    if (!decode(*jobp))
+                    {
+                        ++bad;
+                    }
+                    ++done;
+                }))
+        {
+            // Shutting down
+            ++bad;
+            ++done;
+        }
+    }
+    while (done < mJobs.size())
+    {
+        ms_sleep(1);
+    }
+    F64 elapsed = total.getElapsedTimeF64();
+
+    failed = bad;
+    return elapsed;
+}
+
+void LLMeshDecodeBenchmark::idle()
+{
+    // The main thread pass doubles as warm up for the pool pass
+    F64 section_times[SECTION_COUNT] = { 0.0 };
+    U32 failed = 0;
+    F64 inline_time = runInline(failed, section_times);
+
+    F64 pooled_time = 0.0;
+    if (LL::WorkQueue::getInstance("MeshDecode") && LL::ThreadPoolBase::getWidth("MeshDecode", 0) > 0)
+    {
+        U32 pooled_failed = 0;
+        pooled_time = runPooled(pooled_failed);
+        if (pooled_failed != failed)
+        {
+            LL_WARNS() << pooled_failed << " sections failed on the pool, " << failed << " inline" << LL_ENDL;
+        }
+    }
+    else
+    {
+        LL_WARNS() << "MeshDecode thread pool isn't running, only timing the main thread" << LL_ENDL;
+    }
+
+    report(inline_time, pooled_time, failed, section_times);
+    finish();
+}
+
+void LLMeshDecodeBenchmark::report(F64 inline_time, F64 pooled_time, U32 failed, const F64* section_times)
+{
+    S32 threads = (S32)LL::ThreadPoolBase::getWidth("MeshDecode", 0);
+    inline_time = llmax(inline_time, 0.000001);
+
+    LLSD sd;
+    sd["assets"] = (LLSD::Integer)mAssets;
+    sd["sections"] = (LLSD::Integer)mJobs.size();
+    sd["failed"] = (LLSD::Integer)failed;
+    sd["bytes"] = (LLSD::Real)mBytes;
+    sd["threads"] = threads;
+
+    LLSD& main_thread = sd["main_thread"];
+    main_thread["seconds"] = inline_time;
+    main_thread["sections_per_second"] = mJobs.size() / inline_time;
+    main_thread["bytes_per_second"] = mBytes / inline_time;
+
+    if (pooled_time > 0.0)
+    {
+        LLSD& pool = sd["pool"];
+        pool["seconds"] = pooled_time;
+        pool["sections_per_second"] = mJobs.size() / pooled_time;
+        pool["bytes_per_second"] = mBytes / pooled_time;
+        pool["speedup"] = inline_time / pooled_time;
+    }
+
+    // Where the main thread pass spent its time
+    U32 counts[SECTION_COUNT] = { 0 };
+    for (const Job& job : mJobs)
+    {
+        ++counts[job.mSection];
+    }
+    LLSD& sections = sd["main_thread"]["sections"];
+    for (S32 i = 0; i < SECTION_COUNT; ++i)
+    {
+        if (counts[i])
+        {
+            LLSD& section = sections[SECTION_NAMES[i]];
+            section["count"] = (LLSD::Integer)counts[i];
+            section["seconds"] = section_times[i];
+            section["mean"] = section_times[i] / counts[i];
+        }
+    }
+
+    LL_INFOS() << llformat("%u sections from %u assets, %.2f MB, %u failed", (U32)mJobs.size(), mAssets,
+                           mBytes / (1024.0 * 1024.0), failed) << LL_ENDL;
+    LL_INFOS() << llformat("Main thread: %.3fs, %.0f sections/s, %.2f MB/s", inline_time, mJobs.size() / inline_time,
+                           mBytes / inline_time / (1024.0 * 1024.0)) << LL_ENDL;
+    if (pooled_time > 0.0)
+    {
+        LL_INFOS() << llformat("Pool of %d:   %.3fs, %.0f sections/s, %.2f MB/s, %.2fx", threads, pooled_time,
+                               mJobs.size() / pooled_time, mBytes / pooled_time / (1024.0 * 1024.0),
+                               inline_time / pooled_time) << LL_ENDL;
+    }
+    for (LLSD::map_const_iterator iter = sections.beginMap(); iter != sections.endMap(); ++iter)
+    {
+        LL_INFOS() << llformat("%-16s %6d %9.3fs total %8.5fs mean", iter->first.c_str(), iter->second["count"].asInteger(),
+                               iter->second["seconds"].asReal(), iter->second["mean"].asReal()) << LL_ENDL;
+    }
+    writeReport(sd);
+}
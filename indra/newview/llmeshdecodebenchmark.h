@@ -0,0 +1,98 @@
+/**
+ * @file llmeshdecodebenchmark.h
+ * @brief Decodes a directory of cached mesh assets on the main thread and
+ *        on the mesh decode pool and reports the throughput of each
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMESHDECODEBENCHMARK_H
+#define LL_LLMESHDECODEBENCHMARK_H
+
+#include "lluuid.h"
+#include "llviewerbenchmark.h"
+
+#include <memory>
+#include <vector>
+
+// Replays the decode half of mesh loading over a directory of mesh assets,
+// such as the viewer's own cache directory after visiting a busy region.
+// Every LOD, skin and physics section found is decoded once in turn on the
+// main thread and once spread over the "MeshDecode" thread pool that
+// LLMeshRepoThread hands fetched data to, which shows how the pool scales
+// with its ThreadPoolSizes entry.
+//
+// Started with --meshdecodebenchmark <directory>. Files are searched
+// recursively and sections the cache never filled in are skipped. The
+// report is logged and written to mesh_decode_benchmark.xml in the log
+// directory.
+class LLMeshDecodeBenchmark final : public LLViewerBenchmark
+{
+    LOG_CLASS(LLMeshDecodeBenchmark);
+
+public:
+    LLMeshDecodeBenchmark();
+
+protected:
+    // Reads the mesh assets in MeshDecodeBenchmarkDir. Returns false if
+    // none are found.
+    bool start() override;
+
+    // Runs the benchmark on the first call, once the mesh repository is up
+    void idle() override;
+
+private:
+    enum ESection
+    {
+        SECTION_LOD,
+        SECTION_SKIN,
+        SECTION_CONVEX,
+        SECTION_PHYSICS_MESH,
+        SECTION_COUNT
+    };
+
+    struct Job
+    {
+        LLUUID mID;
+        ESection mSection;
+        S32 mLOD;
+        std::shared_ptr<std::vector<U8>> mAsset;
+        S32 mOffset;
+        S32 mSize;
+    };
+
+    bool addAsset(const std::string& filename);
+    static bool decode(const Job& job);
+
+    // Seconds to decode every job, on the calling thread or on the pool
+    F64 runInline(U32& failed, F64* section_times);
+    F64 runPooled(U32& failed);
+
+    void report(F64 inline_time, F64 pooled_time, U32 failed, const F64* section_times);
+
+private:
+    std::vector<Job> mJobs;
+    U32 mAssets;
+    S64 mBytes;
+};
+
+#endif // LL_LLMESHDECODEBENCHMARK_H
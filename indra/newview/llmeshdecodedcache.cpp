@@ -0,0 +1,145 @@
+/**
+ * @file llmeshdecodedcache.cpp
+ * @brief Disk cache of unpacked mesh LODs, keyed by id and LOD
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llmeshdecodedcache.h"
+
+#include "llapr.h"
+#include "llvolume.h"
+
+// Files, see LLDecodedDiskCache for the index:
+// cache/meshdecoded/[0-F]/UUID_lod_flags.decoded
+//  FileHeader followed by LLVolume::packDecodedFaces()
+
+namespace
+{
+    const U32 INDEX_MAGIC = 0x49434D44;     // "DMCI"
+    const U32 FILE_MAGIC = 0x46434D44;      // "DMCF"
+    const U32 FILE_VERSION = 1;
+
+#if LL_WINDOWS
+#pragma pack(push,1)
+#endif
+    // 32 bytes, which keeps the face arrays behind it 16 byte aligned
+    struct FileHeader
+    {
+        U32 mMagic;
+        U32 mVersion;
+        LLUUID mID;
+        S32 mLOD;
+        U32 mSculptFlags;
+    };
+#if LL_WINDOWS
+#pragma pack(pop)
+#endif
+}
+
+LLMeshDecodedCache::LLMeshDecodedCache()
+    : LLDecodedDiskCache("Decoded mesh LODs", INDEX_MAGIC)
+{
+}
+
+// Called from the mesh threads
+bool LLMeshDecodedCache::contains(const LLUUID& id, S32 lod, U8 sculpt_flags)
+{
+    return getStoredSize(Key{ id, lod, sculpt_flags }) > 0;
+}
+
+// Called from the mesh decode pool
+bool LLMeshDecodedCache::read(const LLUUID& id, S32 lod, U8 sculpt_flags, LLVolume* volume)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+    Key key{ id, lod, sculpt_flags };
+    S32 size = getStoredSize(key);
+    if (size <= 0)
+    {
+        return false;
+    }
+
+    // One read of the whole file, the faces are copied straight out of it
+    std::string filename = getFileName(key);
+    bool success = false;
+    if (size > (S32)sizeof(FileHeader) && LLAPRFile::size(filename) == size)
+    {
+        std::vector<U8> buffer;
+        try
+        {
+            buffer.resize(size);
+        }
+        catch (const std::bad_alloc&)
+        {
+            LL_WARNS_ONCE("Mesh") << "Failed to allocate " << size << " bytes for a decoded mesh" << LL_ENDL;
+            return false;
+        }
+        const FileHeader* header = (const FileHeader*)buffer.data();
+        success = LLAPRFile::readEx(filename, buffer.data(), 0, size) == size &&
+                  header->mMagic == FILE_MAGIC && header->mVersion == FILE_VERSION && header->mID == id &&
+                  header->mLOD == lod && header->mSculptFlags == sculpt_flags &&
+                  volume->unpackDecodedFaces(buffer.data() + sizeof(FileHeader), size - (S32)sizeof(FileHeader));
+    }
+    if (!success)
+    {
+        LL_WARNS("Mesh") << "Decoded mesh " << id << " LOD " << lod << " is damaged, unpacking it again" << LL_ENDL;
+    }
+    return finishRead(key, success);
+}
+
+// Called from the mesh decode pool
+void LLMeshDecodedCache::decoded(const LLUUID& id, S32 lod, U8 sculpt_flags, const LLVolume* volume)
+{
+    Key key{ id, lod, sculpt_flags };
+    if (!volume || !countUse(key))
+    {
+        return;
+    }
+
+    // The volume goes on to the main thread, write a copy of its faces
+    std::shared_ptr<std::vector<U8>> faces;
+    try
+    {
+        faces = std::make_shared<std::vector<U8>>();
+        volume->packDecodedFaces(*faces);
+    }
+    catch (const std::bad_alloc&)
+    {
+        cancelWrite(key);
+        return;
+    }
+
+    write(key, [key, faces](std::vector<U8>& file)
+        {
+            file.resize(sizeof(FileHeader) + faces->size());
+            FileHeader* header = (FileHeader*)file.data();
+            header->mMagic = FILE_MAGIC;
+            header->mVersion = FILE_VERSION;
+            header->mID = key.mID;
+            header->mLOD = key.mLevel;
+            header->mSculptFlags = key.mVariant;
+            memcpy(file.data() + sizeof(FileHeader), faces->data(), faces->size());
+            return true;
+        });
+}
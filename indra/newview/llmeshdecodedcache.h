@@ -0,0 +1,60 @@
+/**
+ * @file llmeshdecodedcache.h
+ * @brief Disk cache of unpacked mesh LODs, keyed by id and LOD
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMESHDECODEDCACHE_H
+#define LL_LLMESHDECODEDCACHE_H
+
+#include "lldecodeddiskcache.h"
+
+class LLVolume;
+
+// Second tier of the mesh cache. The asset cache keeps the compressed LLSD
+// of every mesh; this keeps the LODs that get loaded over and over as they
+// are after LLVolume::unpackVolumeFaces(), cache optimized and with their
+// tangents, so that LLMeshRepoThread can skip the inflate, the LLSD parse
+// and the optimization.
+//
+// A LOD is only written once it has been unpacked MeshDecodedCacheMinUses
+// times. Mirrored and inverted sculpt flags change the unpacked faces and
+// so are part of the key.
+//
+// Lookups run on the mesh decode pool and are synchronous.
+class LLMeshDecodedCache : public LLDecodedDiskCache
+{
+public:
+    LLMeshDecodedCache();
+
+    // True if the LOD is stored. Cheap, for deciding where to load from.
+    bool contains(const LLUUID& id, S32 lod, U8 sculpt_flags);
+    // Fills volume with the stored faces of the LOD. Returns false, and
+    // forgets the entry, if it is missing or damaged.
+    bool read(const LLUUID& id, S32 lod, U8 sculpt_flags, LLVolume* volume);
+    // Called after volume was unpacked from the asset. Counts the use and
+    // stores a copy of the faces once the LOD has been used enough.
+    void decoded(const LLUUID& id, S32 lod, U8 sculpt_flags, const LLVolume* volume);
+};
+
+#endif // LL_LLMESHDECODEDCACHE_H
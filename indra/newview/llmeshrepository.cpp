@@ -46,11 +46,13 @@
 #include "llsdserialize.h"
 #include "llthread.h"
 #include "llfilesystem.h"
+#include "threadpool.h"
 #include "llviewercontrol.h"
 #include "llviewerinventory.h"
 #include "llviewermenufile.h"
 #include "llviewermessage.h"
 #include "llviewernetwork.h"
+#include "llmeshdecodedcache.h"
 #include "llviewerobjectlist.h"
 #include "llviewerregion.h"
 #include "llviewerstatsrecorder.h"
@@ -109,6 +111,7 @@
 //
 //   main     Main rendering thread, very sensitive to locking and other stalls
 //   repo     Overseeing worker thread associated with the LLMeshRepoThread class
+//   decode   "MeshDecode" thread pool unpacking fetched and cached mesh data for repo
 //   decom    Worker thread for mesh decomposition requests
 //   core     HTTP worker thread:  does the work but doesn't intrude here
 //   uploadN  0-N temporary mesh upload threads (0-1 in practice)
@@ -145,13 +148,19 @@
 //                             ...
 //                             scan mLODReqQ
 //                             fetchMeshLOD() invoked
+//                               hand decoded LOD to decode pool if cached
 //                               issue Byte-Range GET for LOD
 //                             ...
 //                             onCompleted() invoked for GET
-//                               data copied
-//                               lodReceived() invoked
-//                                 unpack data into LLVolume
-//                                 append LoadedMesh to mLoadedQ
+//                               data handed to decode pool
+//                             ...
+//                                                   decode thread
+//
+//                                                   lodReceived() invoked
+//                                                     unpack data into LLVolume
+//                                                     count use in decoded cache
+//                                                     append LoadedMesh to mLoadedQ
+//                                                   data written to cache
 //                             ...
 //         notifyLoadedMeshes() invoked again
 //           scan mLoadedQ
@@ -222,9 +231,9 @@
 //     sLODPending                     mMeshMutex [4]  rw.main.mMeshMutex
 //     sLODProcessing                  Repo::mMutex    rw.any.Repo::mMutex
 //     sCacheBytesRead                 none            rw.repo.none, ro.main.none [1]
-//     sCacheBytesWritten              "
-//     sCacheReads                     "
-//     sCacheWrites                    "
+//     sCacheBytesWritten              Repo::mMutex    rw.decode.Repo::mMutex, ro.main.none [1]
+//     sCacheReads                     none            rw.repo.none, ro.main.none [1]
+//     sCacheWrites                    Repo::mMutex    rw.decode.Repo::mMutex, ro.main.none [1]
 //     mLoadingMeshes                  mMeshMutex [4]  rw.main.none, rw.any.mMeshMutex
 //     mSkinMap                        none            rw.main.none
 //     mDecompositionMap               none            rw.main.none
@@ -240,6 +249,7 @@
 //     mInventoryQ                     mMeshMutex [4]  rw.main.mMeshMutex, ro.main.none [5]
 //     mUploadErrorQ                   mMeshMutex      rw.main.mMeshMutex, rw.any.mMeshMutex
 //     mGetMeshVersion                 none            rw.main.none
+//     mDecodedCache                   own mutex       rw.any.none
 //
 //   LLMeshRepoThread:
 //
@@ -248,16 +258,17 @@
 //     sMaxConcurrentRequests   mMutex        wo.main.none, ro.repo.none, ro.main.mMutex
 //     mMeshHeader              mHeaderMutex  rw.repo.mHeaderMutex, ro.main.mHeaderMutex, ro.main.none [0]
 //     mSkinReqQ                mMutex        rw.repo.mMutex, ro.repo.none [5]
-//     mSkinUnavailableQ        mMutex        rw.repo.mMutex, ro.repo.none [5]
-//     mSkinInfoQ               mMutex        rw.repo.mMutex, rw.main.mMutex [5] (was:  [0])
+//     mSkinUnavailableQ        mMutex        rw.any.mMutex, ro.repo.none [5]
+//     mSkinInfoQ               mMutex        rw.decode.mMutex, rw.main.mMutex [5] (was:  [0])
 //     mDecompositionRequests   mMutex        rw.repo.mMutex, ro.repo.none [5]
 //     mPhysicsShapeRequests    mMutex        rw.repo.mMutex, ro.repo.none [5]
-//     mDecompositionQ          mMutex        rw.repo.mMutex, rw.main.mMutex [5] (was:  [0])
+//     mDecompositionQ          mMutex        rw.decode.mMutex, rw.main.mMutex [5] (was:  [0])
 //     mHeaderReqQ              mMutex        ro.repo.none [5], rw.repo.mMutex, rw.any.mMutex
 //     mLODReqQ                 mMutex        ro.repo.none [5], rw.repo.mMutex, rw.any.mMutex
 //     mUnavailableQ            mMutex        rw.repo.none [0], ro.main.none [5], rw.main.mMutex
-//     mLoadedQ                 mMutex        rw.repo.mMutex, ro.main.none [5], rw.main.mMutex
+//     mLoadedQ                 mMutex        rw.decode.mMutex, ro.main.none [5], rw.main.mMutex
 //     mPendingLOD              mMutex        rw.repo.mMutex, rw.any.mMutex
+//     mCacheDecodeFailed       mMutex        ro.repo.mMutex, wo.decode.mMutex
 //     mGetMeshCapability       mMutex        rw.main.mMutex, ro.repo.mMutex (was:  [0])
 //     mGetMesh2Capability      mMutex        rw.main.mMutex, ro.repo.mMutex (was:  [0])
 //     mGetMeshVersion          mMutex        rw.main.mMutex, ro.repo.mMutex
@@ -409,6 +420,12 @@ namespace {
 
     void NoOpDeletor(LLCore::HttpHandler *)
     { /*NoOp*/ }
+
+    // Sculpt flags that change the faces a mesh LOD unpacks to
+    U8 decoded_sculpt_flags(const LLVolumeParams& mesh_params)
+    {
+        return mesh_params.getSculptType() & LL_SCULPT_FLAG_MASK;
+    }
 }
 
 static S32 dump_num = 0;
@@ -576,6 +593,7 @@ S32 LLMeshRepoThread::sRequestWaterLevel = 0;
 //   LLMeshUploadThread
 
 class LLMeshHandlerBase : public LLCore::HttpHandler,
+    public LLCore::HttpResponseSink,
     public std::enable_shared_from_this<LLMeshHandlerBase>
 {
 public:
@@ -588,7 +606,10 @@ class LLMeshHandlerBase : public LLCore::HttpHandler,
           mProcessed(false),
           mHttpHandle(LLCORE_HTTP_HANDLE_INVALID),
           mOffset(offset),
-          mRequestedBytes(requested_bytes)
+          mRequestedBytes(requested_bytes),
+          mStreamOffset(0),
+          mStreamSkip(0),
+          mStreamSize(0)
         {}
 
     virtual ~LLMeshHandlerBase() = default;
@@ -601,12 +622,29 @@ class LLMeshHandlerBase : public LLCore::HttpHandler,
     virtual void processData(LLCore::BufferArray * body, S32 body_offset, U8 * data, S32 data_size) = 0;
     virtual void processFailure(LLCore::HttpStatus status) = 0;
 
+    // Response sink, lets the body land in mStreamData without
+    // going through a BufferArray and a second copy.
+    //
+    // Thread:  llcorehttp worker
+    bool onBodyStart(const LLCore::HttpStatus & status, size_t offset, size_t length, size_t full_length) override;
+    bool onBodyData(const char * data, size_t size) override;
+
+    // Hand the data passed to processData() over to the decode pool.
+    // A streamed body is moved out of mStreamData, anything else copied.
+    LLMeshRepoThread::payload_t takeData(U8 * data, S32 data_size);
+
 public:
     LLVolumeParams mMeshParams;
     bool mProcessed;
     LLCore::HttpHandle mHttpHandle;
     U32 mOffset;
     U32 mRequestedBytes;
+
+    // Streamed body from mOffset onward, only valid in onCompleted()
+    std::vector<U8> mStreamData;
+    size_t mStreamOffset;                   // Resource offset of the response's first byte
+    size_t mStreamSkip;                     // Leading bytes before mOffset still to drop
+    size_t mStreamSize;                     // Body bytes received, skipped ones included
 };
 
 
@@ -841,6 +879,9 @@ LLMeshRepoThread::LLMeshRepoThread()
     mHttpPolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_MESH2);
     mHttpLegacyPolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_MESH1);
     mHttpLargePolicyClass = app_core_http.getPolicy(LLAppCoreHttp::AP_LARGE_MESH);
+
+    mDecodePool.reset(new LL::ThreadPool("MeshDecode", 2));
+    mDecodePool->start();
 }
 
 
@@ -851,6 +892,10 @@ LLMeshRepoThread::~LLMeshRepoThread()
                        << ", Max Lock Holdoffs:  " << LLMeshRepository::sMaxLockHoldoffs
                        << LL_ENDL;
 
+    // Decodes still queued use the mutex and queues below
+    mDecodePool->close();
+    mDecodePool.reset();
+
     mHttpRequestSet.clear();
     mHttpHeaders.reset();
 
@@ -1281,15 +1326,20 @@ LLCore::HttpHandle LLMeshRepoThread::getByteRange(const std::string & url, int l
 
     LLCore::HttpHandle handle(LLCORE_HTTP_HANDLE_INVALID);
 
+    // Mesh handlers take the body directly, @see LLMeshHandlerBase::onBodyData()
+    const LLCore::HttpResponseSink::ptr_t sink(std::dynamic_pointer_cast<LLCore::HttpResponseSink>(handler));
+    llassert(sink);
+
     if (len < LARGE_MESH_FETCH_THRESHOLD)
     {
-        handle = mHttpRequest->requestGetByteRange( ((legacy_cap_version == 0 || legacy_cap_version == 2) ? mHttpPolicyClass : mHttpLegacyPolicyClass),
-                                                    url,
-                                                    (disable_range_req ? size_t(0) : offset),
-                                                    (disable_range_req ? size_t(0) : len),
-                                                    mHttpOptions,
-                                                    mHttpHeaders,
-                                                    handler);
+        handle = mHttpRequest->requestGetToSink( ((legacy_cap_version == 0 || legacy_cap_version == 2) ? mHttpPolicyClass : mHttpLegacyPolicyClass),
+                                                 url,
+                                                 (disable_range_req ? size_t(0) : offset),
+                                                 (disable_range_req ? size_t(0) : len),
+                                                 mHttpOptions,
+                                                 mHttpHeaders,
+                                                 sink,
+                                                 handler);
         if (LLCORE_HTTP_HANDLE_INVALID != handle)
         {
             ++LLMeshRepository::sHTTPRequestCount;
@@ -1297,13 +1347,14 @@ LLCore::HttpHandle LLMeshRepoThread::getByteRange(const std::string & url, int l
     }
     else
     {
-        handle = mHttpRequest->requestGetByteRange(mHttpLargePolicyClass,
-                                                   url,
-                                                   (disable_range_req ? size_t(0) : offset),
-                                                   (disable_range_req ? size_t(0) : len),
-                                                   mHttpLargeOptions,
-                                                   mHttpHeaders,
-                                                   handler);
+        handle = mHttpRequest->requestGetToSink(mHttpLargePolicyClass,
+                                                url,
+                                                (disable_range_req ? size_t(0) : offset),
+                                                (disable_range_req ? size_t(0) : len),
+                                                mHttpLargeOptions,
+                                                mHttpHeaders,
+                                                sink,
+                                                handler);
         if (LLCORE_HTTP_HANDLE_INVALID != handle)
         {
             ++LLMeshRepository::sHTTPLargeRequestCount;
@@ -1317,22 +1368,88 @@ LLCore::HttpHandle LLMeshRepoThread::getByteRange(const std::string & url, int l
     return handle;
 }
 
-bool LLMeshRepoThread::loadInfoFromFilesystem(const LLUUID& mesh_id, MeshHeaderInfo& info, boost::function<bool(const LLUUID&, U8*, S32)> fn)
+// Thread:  repo
+void LLMeshRepoThread::postDecode(const std::function<void()>& work)
+{
+    if (mDecodePool->getWidth() == 0 || !mDecodePool->getQueue().post(work))
+    {
+        work();
+    }
+}
+
+// Thread:  repo
+void LLMeshRepoThread::decodeFetched(const LLUUID& mesh_id, const payload_t& payload, S32 offset, S32 size,
+                                     const decode_fn_t& decode, const fallback_fn_t& on_failure)
+{
+    postDecode([this, mesh_id, payload, offset, size, decode, on_failure]()
+        {
+            EMeshProcessingResult result = decode(payload->data(), (S32)payload->size());
+            if (result == MESH_OK)
+            {
+                // good fetch from sim, write to cache
+                // <FS:Ansariel> Fix asset caching
+                //LLFileSystem file(mesh_id, LLAssetType::AT_MESH, LLFileSystem::WRITE);
+                LLFileSystem file(mesh_id, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
+
+                S32 bytes = llmin(size, (S32)payload->size());
+                if (file.getSize() >= offset + bytes)
+                {
+                    file.seek(offset);
+                    file.write(payload->data(), bytes);
+
+                    LLMutexLock lock(mMutex);
+                    LLMeshRepository::sCacheBytesWritten += bytes;
+                    ++LLMeshRepository::sCacheWrites;
+                }
+            }
+            else
+            {
+                LL_WARNS(LOG_MESH) << "Error during mesh processing.  ID:  " << mesh_id
+                                   << ", Reason: " << result
+                                   << " Offset: " << offset
+                                   << " Data size: " << payload->size()
+                                   << " Not retrying."
+                                   << LL_ENDL;
+                if (on_failure)
+                {
+                    LLMutexLock lock(mMutex);
+                    on_failure();
+                }
+            }
+        });
+}
+
+// Thread:  repo
+bool LLMeshRepoThread::loadInfoFromFilesystem(const LLUUID& mesh_id, MeshHeaderInfo& info,
+                                              const decode_fn_t& decode, const fallback_fn_t& requeue)
 {
-    //check cache for mesh skin info
+    {
+        LLMutexLock lock(mMutex);
+        if (mCacheDecodeFailed.count(mesh_id))
+        {
+            return false;
+        }
+    }
+
+    //check cache for mesh data
     LLFileSystem file(mesh_id, LLAssetType::AT_MESH);
     if (file.getSize() >= info.mOffset + info.mSize)
     {
-        auto buffer = std::make_unique<U8[]>(info.mSize);
-        if (!buffer)
+        payload_t payload;
+        try
+        {
+            payload = std::make_shared<std::vector<U8>>(info.mSize);
+        }
+        catch (const std::bad_alloc&)
         {
             LL_WARNS_ONCE(LOG_MESH) << "Failed to allocate memory for mesh data load, size: " << info.mSize << LL_ENDL;
             return false;
         }
+        U8* buffer = payload->data();
         LLMeshRepository::sCacheBytesRead += info.mSize;
         ++LLMeshRepository::sCacheReads;
         file.seek(info.mOffset);
-        file.read(buffer.get(), info.mSize);
+        file.read(buffer, info.mSize);
 
         //make sure buffer isn't all 0's by checking the first 1KB (reserved block but not written)
         bool zero = true;
@@ -1343,10 +1460,18 @@ bool LLMeshRepoThread::loadInfoFromFilesystem(const LLUUID& mesh_id, MeshHeaderI
 
         if (!zero)
         { //attempt to parse
-            if (fn(mesh_id, buffer.get(), info.mSize) == MESH_OK)
-            {
-                return true;
-            }
+            postDecode([this, mesh_id, payload, decode, requeue]()
+                {
+                    if (decode(payload->data(), (S32)payload->size()) != MESH_OK)
+                    {
+                        LL_WARNS(LOG_MESH) << "Cached data for mesh " << mesh_id
+                                           << " failed to decode, fetching it from the simulator." << LL_ENDL;
+                        LLMutexLock lock(mMutex);
+                        mCacheDecodeFailed.insert(mesh_id);
+                        requeue();
+                    }
+                });
+            return true;
         }
     }
     return false;
@@ -1383,7 +1508,8 @@ bool LLMeshRepoThread::fetchMeshSkinInfo(const LLUUID& mesh_id, bool can_retry)
     if (info.mVersion <= MAX_MESH_VERSION && info.mOffset >= 0 && info.mSize > 0)
     {
         //check cache for mesh skin info
-        if (loadInfoFromFilesystem(mesh_id, info, boost::bind(&LLMeshRepoThread::skinInfoReceived, this, _1, _2, _3)))
+        if (loadInfoFromFilesystem(mesh_id, info, boost::bind(&LLMeshRepoThread::skinInfoReceived, this, mesh_id, _1, _2),
+                                   [this, mesh_id]() { mSkinReqQ.push(UUIDBasedRequest(mesh_id)); }))
             return true;
 
         //reading from cache failed for whatever reason, fetch from sim
@@ -1461,7 +1587,8 @@ bool LLMeshRepoThread::fetchMeshDecomposition(const LLUUID& mesh_id)
     if (info.mVersion <= MAX_MESH_VERSION && info.mOffset >= 0 && info.mSize > 0)
     {
         //check cache for mesh physics info
-        if (loadInfoFromFilesystem(mesh_id, info, boost::bind(&LLMeshRepoThread::decompositionReceived, this, _1, _2, _3)))
+        if (loadInfoFromFilesystem(mesh_id, info, boost::bind(&LLMeshRepoThread::decompositionReceived, this, mesh_id, _1, _2),
+                                   [this, mesh_id]() { mDecompositionRequests.insert(UUIDBasedRequest(mesh_id)); }))
             return true;
 
         //reading from cache failed for whatever reason, fetch from sim
@@ -1523,7 +1650,8 @@ bool LLMeshRepoThread::fetchMeshPhysicsShape(const LLUUID& mesh_id)
 
     if (info.mVersion <= MAX_MESH_VERSION && info.mOffset >= 0 && info.mSize > 0)
     {
-        if (loadInfoFromFilesystem(mesh_id, info, boost::bind(&LLMeshRepoThread::physicsShapeReceived, this, _1, _2, _3)))
+        if (loadInfoFromFilesystem(mesh_id, info, boost::bind(&LLMeshRepoThread::physicsShapeReceived, this, mesh_id, _1, _2),
+                                   [this, mesh_id]() { mPhysicsShapeRequests.insert(UUIDBasedRequest(mesh_id)); }))
             return true;
 
         //reading from cache failed for whatever reason, fetch from sim
@@ -1687,7 +1815,27 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
 
     if(info.mVersion <= MAX_MESH_VERSION && info.mOffset >= 0 && info.mSize > 0)
     {
-        if (loadInfoFromFilesystem(mesh_id, info, boost::bind(&LLMeshRepoThread::lodReceived, this, mesh_params, lod, _2, _3 )))
+        if (gMeshRepo.getDecodedCache()->contains(mesh_id, lod, decoded_sculpt_flags(mesh_params)))
+        {
+            postDecode([this, mesh_params, lod]()
+                {
+                    if (!decodedLODReceived(mesh_params, lod))
+                    {
+                        // damaged and now forgotten, unpack it from the asset instead
+                        LLMutexLock lock(mMutex);
+                        mLODReqQ.push(LODRequest(mesh_params, lod));
+                        ++LLMeshRepository::sLODProcessing;
+                    }
+                });
+            return true;
+        }
+
+        if (loadInfoFromFilesystem(mesh_id, info, boost::bind(&LLMeshRepoThread::lodReceived, this, mesh_params, lod, _1, _2),
+                                   [this, mesh_params, lod]()
+                                   {
+                                       mLODReqQ.push(LODRequest(mesh_params, lod));
+                                       ++LLMeshRepository::sLODProcessing;
+                                   }))
             return true;
 
         //reading from cache failed for whatever reason, fetch from sim
@@ -1825,17 +1973,8 @@ EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_p
     {
         if (volume->getNumFaces() > 0)
         {
-            LoadedMesh mesh(volume, mesh_params, lod);
-            {
-                LLMutexLock lock(mMutex);
-                mLoadedQ.push_back(mesh);
-                // LLPointer is not thread safe, since we added this pointer into
-                // threaded list, make sure counter gets decreased inside mutex lock
-                // and won't affect mLoadedQ processing
-                volume = NULL;
-                // might be good idea to turn mesh into pointer to avoid making a copy
-                mesh.mVolume = NULL;
-            }
+            gMeshRepo.getDecodedCache()->decoded(mesh_params.getSculptID(), lod, decoded_sculpt_flags(mesh_params), volume);
+            queueLoadedLOD(volume, mesh_params, lod);
             return MESH_OK;
         }
     }
@@ -1843,6 +1982,35 @@ EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_p
     return MESH_UNKNOWN;
 }
 
+// Thread:  decode
+bool LLMeshRepoThread::decodedLODReceived(const LLVolumeParams& mesh_params, S32 lod)
+{
+    LLPointer<LLVolume> volume = new LLVolume(mesh_params, LLVolumeLODGroup::getVolumeScaleFromDetail(lod));
+    if (gMeshRepo.getDecodedCache()->read(mesh_params.getSculptID(), lod, decoded_sculpt_flags(mesh_params), volume)
+        && volume->getNumFaces() > 0)
+    {
+        queueLoadedLOD(volume, mesh_params, lod);
+        return true;
+    }
+    return false;
+}
+
+// Thread:  decode
+void LLMeshRepoThread::queueLoadedLOD(LLPointer<LLVolume>& volume, const LLVolumeParams& mesh_params, S32 lod)
+{
+    LoadedMesh mesh(volume, mesh_params, lod);
+    {
+        LLMutexLock lock(mMutex);
+        mLoadedQ.push_back(mesh);
+        // LLPointer is not thread safe, since we added this pointer into
+        // threaded list, make sure counter gets decreased inside mutex lock
+        // and won't affect mLoadedQ processing
+        volume = NULL;
+        // might be good idea to turn mesh into pointer to avoid making a copy
+        mesh.mVolume = NULL;
+    }
+}
+
 EMeshProcessingResult LLMeshRepoThread::skinInfoReceived(const LLUUID& mesh_id, U8* data, S32 data_size)
 {
     if (data == NULL || data_size == 0)
@@ -2964,6 +3132,27 @@ void LLMeshHandlerBase::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRespo
         processFailure(status);
         ++LLMeshRepository::sHTTPErrorCount;
     }
+    else if (response->getStreamedSize())
+    {
+        // Body was streamed into mStreamData already trimmed to start
+        // at mOffset.  Same overlap validation as the buffered case.
+        if (mStreamOffset > mOffset || (mStreamOffset + mStreamSize) <= mOffset)
+        {
+            LL_WARNS(LOG_MESH) << "Mesh response (bytes ["
+                               << mStreamOffset << ".." << (mStreamOffset + mStreamSize - 1)
+                               << "]) didn't overlap with request's origin (bytes ["
+                               << mOffset << ".." << (mOffset + mRequestedBytes - 1)
+                               << "])." << LL_ENDL;
+            processFailure(LLCore::HttpStatus(LLCore::HttpStatus::LLCORE, LLCore::HE_INV_CONTENT_RANGE_HDR));
+            ++LLMeshRepository::sHTTPErrorCount;
+        }
+        else
+        {
+            LLMeshRepository::sBytesReceived += (S32)mStreamSize;
+            processData(NULL, 0, mStreamData.data(), (S32)mStreamData.size());
+        }
+        std::vector<U8>().swap(mStreamData);
+    }
     else
     {
         // From texture fetch code and may apply here:
@@ -3062,6 +3251,89 @@ void LLMeshHandlerBase::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRespo
 }
 
 
+LLMeshRepoThread::payload_t LLMeshHandlerBase::takeData(U8 * data, S32 data_size)
+{
+    auto payload = std::make_shared<std::vector<U8>>();
+    if (data && data == mStreamData.data())
+    {
+        payload->swap(mStreamData);
+    }
+    else if (data_size > 0)
+    {
+        try
+        {
+            payload->assign(data, data + data_size);
+        }
+        catch (const std::bad_alloc &)
+        {
+            LL_WARNS(LOG_MESH) << "Failed to allocate " << data_size << " memory for mesh response" << LL_ENDL;
+        }
+    }
+    return payload;
+}
+
+
+bool LLMeshHandlerBase::onBodyStart(const LLCore::HttpStatus & status, size_t offset, size_t length, size_t /* full_length */)
+{
+    static const LLCore::HttpStatus par_status(HTTP_PARTIAL_CONTENT);
+
+    // Work out where the response starts as onCompleted() does for
+    // buffered bodies:  206 without a usable Content-Range is assumed
+    // to be what we asked for, anything else is the whole asset.
+    if (par_status == status)
+    {
+        if (! offset && ! length)
+        {
+            offset = mOffset;
+        }
+    }
+    else
+    {
+        offset = 0;
+    }
+
+    mStreamOffset = offset;
+    mStreamSkip = (offset < mOffset) ? (mOffset - offset) : 0;
+    mStreamSize = 0;
+    mStreamData.clear();
+    try
+    {
+        mStreamData.reserve(mRequestedBytes);
+    }
+    catch (const std::bad_alloc &)
+    {
+        LL_WARNS(LOG_MESH) << "Failed to allocate " << mRequestedBytes << " memory for mesh response" << LL_ENDL;
+        return false;
+    }
+    return true;
+}
+
+
+bool LLMeshHandlerBase::onBodyData(const char * data, size_t size)
+{
+    mStreamSize += size;
+    if (mStreamSkip >= size)
+    {
+        mStreamSkip -= size;
+        return true;
+    }
+    data += mStreamSkip;
+    size -= mStreamSkip;
+    mStreamSkip = 0;
+
+    try
+    {
+        mStreamData.insert(mStreamData.end(), (const U8 *) data, (const U8 *) data + size);
+    }
+    catch (const std::bad_alloc &)
+    {
+        LL_WARNS(LOG_MESH) << "Failed to allocate " << mStreamData.size() + size << " memory for mesh response" << LL_ENDL;
+        return false;
+    }
+    return true;
+}
+
+
 LLMeshHeaderHandler::~LLMeshHeaderHandler()
 {
     if (!LLApp::isExiting())
@@ -3235,36 +3507,13 @@ void LLMeshLODHandler::processData(LLCore::BufferArray * /* body */, S32 /* body
     if ((!MESH_LOD_PROCESS_FAILED)
         && ((data != NULL) == (data_size > 0))) // if we have data but no size or have size but no data, something is wrong
     {
-        EMeshProcessingResult result = gMeshRepo.mThread->lodReceived(mMeshParams, mLOD, data, data_size);
-        if (result == MESH_OK)
-        {
-            // good fetch from sim, write to cache
-            // <FS:Ansariel> Fix asset caching
-            //LLFileSystem file(mMeshParams.getSculptID(), LLAssetType::AT_MESH, LLFileSystem::WRITE);
-            LLFileSystem file(mMeshParams.getSculptID(), LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
-
-            S32 offset = mOffset;
-            S32 size = mRequestedBytes;
-
-            if (file.getSize() >= offset+size)
-            {
-                file.seek(offset);
-                file.write(data, size);
-                LLMeshRepository::sCacheBytesWritten += size;
-                ++LLMeshRepository::sCacheWrites;
-            }
-        }
-        else
-        {
-            LL_WARNS(LOG_MESH) << "Error during mesh LOD processing.  ID:  " << mMeshParams.getSculptID()
-                               << ", Reason: " << result
-                               << " LOD: " << mLOD
-                               << " Data size: " << data_size
-                               << " Not retrying."
-                               << LL_ENDL;
-            LLMutexLock lock(gMeshRepo.mThread->mMutex);
-            gMeshRepo.mThread->mUnavailableQ.emplace_back(mMeshParams, mLOD);
-        }
+        // unpacked on the decode pool, which also writes good data to cache
+        LLMeshRepoThread* thread = gMeshRepo.mThread;
+        const LLVolumeParams mesh_params = mMeshParams;
+        const S32 lod = mLOD;
+        thread->decodeFetched(mMeshParams.getSculptID(), takeData(data, data_size), mOffset, mRequestedBytes,
+                              boost::bind(&LLMeshRepoThread::lodReceived, thread, mesh_params, lod, _1, _2),
+                              [thread, mesh_params, lod]() { thread->mUnavailableQ.emplace_back(mesh_params, lod); });
     }
     else
     {
@@ -3300,24 +3549,14 @@ void LLMeshSkinInfoHandler::processData(LLCore::BufferArray * /* body */, S32 /*
                                         U8 * data, S32 data_size)
 {
     if ((!MESH_SKIN_INFO_PROCESS_FAILED)
-        && ((data != NULL) == (data_size > 0)) // if we have data but no size or have size but no data, something is wrong
-        && gMeshRepo.mThread->skinInfoReceived(mMeshID, data, data_size) == MESH_OK)
+        && ((data != NULL) == (data_size > 0))) // if we have data but no size or have size but no data, something is wrong
     {
-        // good fetch from sim, write to cache
-        // <FS:Ansariel> Fix asset caching
-        //LLFileSystem file(mMeshID, LLAssetType::AT_MESH, LLFileSystem::WRITE);
-        LLFileSystem file(mMeshID, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
-
-        S32 offset = mOffset;
-        S32 size = mRequestedBytes;
-
-        if (file.getSize() >= offset+size)
-        {
-            LLMeshRepository::sCacheBytesWritten += size;
-            ++LLMeshRepository::sCacheWrites;
-            file.seek(offset);
-            file.write(data, size);
-        }
+        // parsed on the decode pool, which also writes good data to cache
+        LLMeshRepoThread* thread = gMeshRepo.mThread;
+        const LLUUID mesh_id = mMeshID;
+        thread->decodeFetched(mMeshID, takeData(data, data_size), mOffset, mRequestedBytes,
+                              boost::bind(&LLMeshRepoThread::skinInfoReceived, thread, mesh_id, _1, _2),
+                              [thread, mesh_id]() { thread->mSkinUnavailableQ.emplace_back(mesh_id); });
     }
     else
     {
@@ -3351,24 +3590,13 @@ void LLMeshDecompositionHandler::processData(LLCore::BufferArray * /* body */, S
                                              U8 * data, S32 data_size)
 {
     if ((!MESH_DECOMP_PROCESS_FAILED)
-        && ((data != NULL) == (data_size > 0)) // if we have data but no size or have size but no data, something is wrong
-        && gMeshRepo.mThread->decompositionReceived(mMeshID, data, data_size) == MESH_OK)
+        && ((data != NULL) == (data_size > 0))) // if we have data but no size or have size but no data, something is wrong
     {
-        // good fetch from sim, write to cache
-        // <FS:Ansariel> Fix asset caching
-        //LLFileSystem file(mMeshID, LLAssetType::AT_MESH, LLFileSystem::WRITE);
-        LLFileSystem file(mMeshID, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
-
-        S32 offset = mOffset;
-        S32 size = mRequestedBytes;
-
-        if (file.getSize() >= offset+size)
-        {
-            LLMeshRepository::sCacheBytesWritten += size;
-            ++LLMeshRepository::sCacheWrites;
-            file.seek(offset);
-            file.write(data, size);
-        }
+        // parsed on the decode pool, which also writes good data to cache
+        LLMeshRepoThread* thread = gMeshRepo.mThread;
+        thread->decodeFetched(mMeshID, takeData(data, data_size), mOffset, mRequestedBytes,
+                              boost::bind(&LLMeshRepoThread::decompositionReceived, thread, mMeshID, _1, _2),
+                              nullptr);
     }
     else
     {
@@ -3400,24 +3628,13 @@ void LLMeshPhysicsShapeHandler::processData(LLCore::BufferArray * /* body */, S3
                                             U8 * data, S32 data_size)
 {
     if ((!MESH_PHYS_SHAPE_PROCESS_FAILED)
-        && ((data != NULL) == (data_size > 0)) // if we have data but no size or have size but no data, something is wrong
-        && gMeshRepo.mThread->physicsShapeReceived(mMeshID, data, data_size) == MESH_OK)
+        && ((data != NULL) == (data_size > 0))) // if we have data but no size or have size but no data, something is wrong
     {
-        // good fetch from sim, write to cache for caching
-        // <FS:Ansariel> Fix asset caching
-        //LLFileSystem file(mMeshID, LLAssetType::AT_MESH, LLFileSystem::WRITE);
-        LLFileSystem file(mMeshID, LLAssetType::AT_MESH, LLFileSystem::READ_WRITE);
-
-        S32 offset = mOffset;
-        S32 size = mRequestedBytes;
-
-        if (file.getSize() >= offset+size)
-        {
-            LLMeshRepository::sCacheBytesWritten += size;
-            ++LLMeshRepository::sCacheWrites;
-            file.seek(offset);
-            file.write(data, size);
-        }
+        // unpacked on the decode pool, which also writes good data to cache
+        LLMeshRepoThread* thread = gMeshRepo.mThread;
+        thread->decodeFetched(mMeshID, takeData(data, data_size), mOffset, mRequestedBytes,
+                              boost::bind(&LLMeshRepoThread::physicsShapeReceived, thread, mMeshID, _1, _2),
+                              nullptr);
     }
     else
     {
@@ -3433,7 +3650,8 @@ LLMeshRepository::LLMeshRepository()
   mDecompThread(NULL),
   mMeshThreadCount(0),
   mThread(NULL),
-  mLegacyGetMeshVersion(0)
+  mLegacyGetMeshVersion(0),
+  mDecodedCache(std::make_shared<LLMeshDecodedCache>())
 {
     mSkinInfoCullTimer.resetWithExpiry(10.f);
 }
@@ -3486,6 +3704,8 @@ void LLMeshRepository::shutdown()
     delete mThread;
     mThread = NULL;
 
+    mDecodedCache->writeIndex();
+
     for (U32 i = 0; i < mUploads.size(); ++i)
     {
         LL_INFOS(LOG_MESH) << "Waiting for pending mesh upload " << (i + 1) << "/" << mUploads.size() << LL_ENDL;
@@ -40,9 +40,11 @@
 #include "httpheaders.h"
 #include "httphandler.h"
 #include "llthread.h"
+#include "threadpool_fwd.h"
 
 #include "boost/unordered/unordered_map.hpp"
 #include "boost/unordered/unordered_flat_map.hpp"
+#include "boost/unordered/unordered_flat_set.hpp"
 #include "boost/unordered/unordered_node_map.hpp"
 
 #define LLCONVEXDECOMPINTER_STATIC 1
@@ -54,6 +56,7 @@ class LLVOVolume;
 class LLMutex;
 class LLCondition;
 class LLMeshRepository;
+class LLMeshDecodedCache;
 
 typedef enum e_mesh_processing_result_enum
 {
@@ -398,6 +401,9 @@ class LLMeshRepoThread final : public LLThread
     typedef boost::unordered_map<LLUUID, std::vector<S32>> pending_lod_map;
     pending_lod_map mPendingLOD;
 
+    //meshes whose cached data failed to decode, fetched over http for the rest of the session
+    boost::unordered_flat_set<LLUUID> mCacheDecodeFailed;
+
     // llcorehttp library interface objects.
     LLCore::HttpStatus                  mHttpStatus;
     LLCore::HttpRequest *               mHttpRequest;
@@ -428,6 +434,9 @@ class LLMeshRepoThread final : public LLThread
     bool fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod, bool can_retry = true);
     EMeshProcessingResult headerReceived(const LLVolumeParams& mesh_params, U8* data, S32 data_size);
     EMeshProcessingResult lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size);
+    // Loads the LOD from the decoded mesh cache.  Returns false if the
+    // cache no longer holds it.
+    bool decodedLODReceived(const LLVolumeParams& mesh_params, S32 lod);
     EMeshProcessingResult skinInfoReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
     EMeshProcessingResult decompositionReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
     EMeshProcessingResult physicsShapeReceived(const LLUUID& mesh_id, U8* data, S32 data_size);
@@ -435,7 +444,27 @@ class LLMeshRepoThread final : public LLThread
     bool hasSkinInfoInHeader(const LLUUID& mesh_id);
     bool hasHeader(const LLUUID& mesh_id);
 
-    bool loadInfoFromFilesystem(const LLUUID& mesh_id, MeshHeaderInfo& info, boost::function<bool(const LLUUID&, U8*, S32)> fn);
+    // Fetched mesh data on its way to one of the *Received() decoders above
+    typedef std::shared_ptr<std::vector<U8>> payload_t;
+    typedef std::function<EMeshProcessingResult(U8*, S32)> decode_fn_t;
+    // Called with mMutex held
+    typedef std::function<void()> fallback_fn_t;
+
+    // Decode payload fetched over http on the decode pool.  Good data is
+    // written to the cache at offset, bad data gets on_failure.
+    //
+    // Threads:  Repo thread only
+    void decodeFetched(const LLUUID& mesh_id, const payload_t& payload, S32 offset, S32 size,
+                       const decode_fn_t& decode, const fallback_fn_t& on_failure);
+
+    // Read the section described by info from the cache and decode it on
+    // the decode pool.  Returns false if the cache doesn't hold it.  If
+    // the data turns out to be bad the mesh skips the cache from then on
+    // and requeue is called to fetch it over http.
+    //
+    // Threads:  Repo thread only
+    bool loadInfoFromFilesystem(const LLUUID& mesh_id, MeshHeaderInfo& info,
+                                const decode_fn_t& decode, const fallback_fn_t& requeue);
 
     void notifyLoadedMeshes(); // Only call from main thread.
     S32 getActualMeshLOD(const LLVolumeParams& mesh_params, S32 lod);
@@ -480,6 +509,23 @@ class LLMeshRepoThread final : public LLThread
     LLCore::HttpHandle getByteRange(const std::string & url, int legacy_cap_version,
                                     size_t offset, size_t len,
                                     const LLCore::HttpHandler::ptr_t &handler);
+
+    // Run work on the decode pool, or right away if the pool has
+    // no threads or is shutting down.
+    //
+    // Threads:  Repo thread only
+    void postDecode(const std::function<void()>& work);
+
+    // Appends an unpacked LOD to mLoadedQ and drops volume under mMutex
+    //
+    // Threads:  decode
+    void queueLoadedLOD(LLPointer<LLVolume>& volume, const LLVolumeParams& mesh_params, S32 lod);
+
+    // Inflating, parsing and unpacking mesh data is most of the cost of
+    // loading a mesh, so it runs here rather than on the repo thread.
+    // Size it with the "MeshDecode" entry of ThreadPoolSizes, 0 decodes
+    // on the repo thread.
+    std::unique_ptr<LL::ThreadPool> mDecodePool;
 };
 
 
@@ -771,6 +817,12 @@ class LLMeshRepository
     void uploadError(LLSD& args);
     void updateInventory(inventory_data data);
     int mLegacyGetMeshVersion;      // Shadows value in LLMeshRepoThread
+
+public:
+    LLMeshDecodedCache* getDecodedCache() { return mDecodedCache.get(); }
+
+private:
+    std::shared_ptr<LLMeshDecodedCache> mDecodedCache;
 };
 
 extern LLMeshRepository gMeshRepo;
@@ -0,0 +1,75 @@
+/**
+ * @file llmessagereplaybenchmark.cpp
+ * @brief Replays a message capture through the message system and reports timings
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llmessagereplaybenchmark.h"
+
+#include "llmessagereplay.h"
+#include "llsd.h"
+#include "llviewercontrol.h"
+#include "message.h"
+
+static LLViewerBenchmark::Registrar<LLMessageReplayBenchmark> sMessageReplayBenchmark;
+
+LLMessageReplayBenchmark::LLMessageReplayBenchmark()
+    : LLViewerBenchmark("message_replay", "MessageReplayQuit")
+{
+}
+
+bool LLMessageReplayBenchmark::start()
+{
+    mFilename = gSavedSettings.getString("MessageReplayFile");
+    return !mFilename.empty();
+}
+
+void LLMessageReplayBenchmark::idle()
+{
+    if (!gMessageSystem || !gMessageSystem->isOK())
+    {
+        return;
+    }
+
+    LLMessageReplay replay;
+    replay.setRealtime(gSavedSettings.getBOOL("MessageReplayRealtime"));
+    if (replay.replay(mFilename))
+    {
+        replay.dumpStats();
+
+        LLSD sd;
+        sd["file"] = mFilename;
+        sd["packets_replayed"] = (LLSD::Integer)replay.getPacketsReplayed();
+        sd["packets_rejected"] = (LLSD::Integer)replay.getPacketsRejected();
+        sd["total_seconds"] = replay.getTotalTime();
+        sd["messages"] = replay.asLLSD();
+        writeReport(sd);
+    }
+    else
+    {
+        LL_WARNS() << "Could not replay " << mFilename << LL_ENDL;
+    }
+    finish();
+}
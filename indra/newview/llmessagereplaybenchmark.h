@@ -0,0 +1,59 @@
+/**
+ * @file llmessagereplaybenchmark.h
+ * @brief Replays a message capture through the message system and reports timings
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMESSAGEREPLAYBENCHMARK_H
+#define LL_LLMESSAGEREPLAYBENCHMARK_H
+
+#include "llviewerbenchmark.h"
+
+#include <string>
+
+// Feeds a file recorded with --messagecapture back through gMessageSystem
+// with LLMessageReplay and reports decode and dispatch times per message.
+//
+// Started with --messagereplay <file>. The replay runs at the login screen,
+// so only the handlers the message system registers itself are dispatched,
+// the other messages are decoded and timed without one. The report is
+// logged and written to message_replay_benchmark.xml in the log directory.
+class LLMessageReplayBenchmark final : public LLViewerBenchmark
+{
+    LOG_CLASS(LLMessageReplayBenchmark);
+
+public:
+    LLMessageReplayBenchmark();
+
+protected:
+    // Runs when MessageReplayFile is set
+    bool start() override;
+
+    // Replays the capture on the first call that finds the message system up
+    void idle() override;
+
+private:
+    std::string mFilename;
+};
+
+#endif // LL_LLMESSAGEREPLAYBENCHMARK_H
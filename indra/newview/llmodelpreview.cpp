@@ -42,6 +42,7 @@
 #include "lliconctrl.h"
 #include "llmatrix4a.h"
 #include "llmeshrepository.h"
+#include "llmeshlodgenerator.h"
 #include "llmeshoptimizer.h"
 #include "llrender.h"
 #include "llsdutil_math.h"
@@ -1354,306 +1355,6 @@ void LLModelPreview::restoreNormals()
     updateStatusMessages();
 }
 
-// Runs per object, but likely it is a better way to run per model+submodels
-// returns a ratio of base model indices to resulting indices
-// returns -1 in case of failure
-F32 LLModelPreview::genMeshOptimizerPerModel(LLModel *base_model, LLModel *target_model, F32 indices_decimator, F32 error_threshold, eSimplificationMode simplification_mode)
-{
-    // I. Weld faces together
-    // Figure out buffer size
-    S32 size_indices = 0;
-    S32 size_vertices = 0;
-
-    for (U32 face_idx = 0; face_idx < base_model->getNumVolumeFaces(); ++face_idx)
-    {
-        const LLVolumeFace &face = base_model->getVolumeFace(face_idx);
-        size_indices += face.mNumIndices;
-        size_vertices += face.mNumVertices;
-    }
-
-    if (size_indices < 3)
-    {
-        return -1;
-    }
-
-    // Allocate buffers, note that we are using U32 buffer instead of U16
-    U32* combined_indices = (U32*)ll_aligned_malloc_32(size_indices * sizeof(U32));
-    U32* output_indices = (U32*)ll_aligned_malloc_32(size_indices * sizeof(U32));
-
-    // extra space for normals and text coords
-    S32 tc_bytes_size = ((size_vertices * sizeof(LLVector2)) + 0xF) & ~0xF;
-    LLVector4a* combined_positions = (LLVector4a*)ll_aligned_malloc<64>(sizeof(LLVector4a) * 3 * size_vertices + tc_bytes_size);
-    LLVector4a* combined_normals = combined_positions + size_vertices;
-    LLVector2* combined_tex_coords = (LLVector2*)(combined_normals + size_vertices);
-
-    // copy indices and vertices into new buffers
-    S32 combined_positions_shift = 0;
-    S32 indices_idx_shift = 0;
-    S32 combined_indices_shift = 0;
-    for (U32 face_idx = 0; face_idx < base_model->getNumVolumeFaces(); ++face_idx)
-    {
-        const LLVolumeFace &face = base_model->getVolumeFace(face_idx);
-
-        // Vertices
-        S32 copy_bytes = face.mNumVertices * sizeof(LLVector4a);
-        LLVector4a::memcpyNonAliased16((F32*)(combined_positions + combined_positions_shift), (F32*)face.mPositions, copy_bytes);
-
-        // Normals
-        LLVector4a::memcpyNonAliased16((F32*)(combined_normals + combined_positions_shift), (F32*)face.mNormals, copy_bytes);
-
-        // Tex coords
-        copy_bytes = face.mNumVertices * sizeof(LLVector2);
-        memcpy((void*)(combined_tex_coords + combined_positions_shift), (void*)face.mTexCoords, copy_bytes);
-
-        combined_positions_shift += face.mNumVertices;
-
-        // Indices
-        // Sadly can't do dumb memcpy for indices, need to adjust each value
-        for (S32 i = 0; i < face.mNumIndices; ++i)
-        {
-            U16 idx = face.mIndices[i];
-
-            combined_indices[combined_indices_shift] = idx + indices_idx_shift;
-            combined_indices_shift++;
-        }
-        indices_idx_shift += face.mNumVertices;
-    }
-
-    // II. Generate a shadow buffer if nessesary.
-    // Welds together vertices if possible
-
-    U32* shadow_indices = NULL;
-    // if MESH_OPTIMIZER_FULL, just leave as is, since generateShadowIndexBufferU32
-    // won't do anything new, model was remaped on a per face basis.
-    // Similar for MESH_OPTIMIZER_NO_TOPOLOGY, it's pointless
-    // since 'simplifySloppy' ignores all topology, including normals and uvs.
-    // Note: simplifySloppy can affect UVs significantly.
-    if (simplification_mode == MESH_OPTIMIZER_NO_NORMALS)
-    {
-        // strip normals, reflections should restore relatively correctly
-        shadow_indices = (U32*)ll_aligned_malloc_32(size_indices * sizeof(U32));
-        LLMeshOptimizer::generateShadowIndexBufferU32(shadow_indices, combined_indices, size_indices, combined_positions, NULL, combined_tex_coords, size_vertices);
-    }
-    if (simplification_mode == MESH_OPTIMIZER_NO_UVS)
-    {
-        // strip uvs, can heavily affect textures
-        shadow_indices = (U32*)ll_aligned_malloc_32(size_indices * sizeof(U32));
-        LLMeshOptimizer::generateShadowIndexBufferU32(shadow_indices, combined_indices, size_indices, combined_positions, NULL, NULL, size_vertices);
-    }
-
-    U32* source_indices = NULL;
-    if (shadow_indices)
-    {
-        source_indices = shadow_indices;
-    }
-    else
-    {
-        source_indices = combined_indices;
-    }
-
-    // III. Simplify
-    S32 target_indices = 0;
-    F32 result_error = 0; // how far from original the model is, 1 == 100%
-    S32 size_new_indices = 0;
-
-    if (indices_decimator > 0)
-    {
-        target_indices = llclamp(llfloor(size_indices / indices_decimator), 3, (S32)size_indices); // leave at least one triangle
-    }
-    else // indices_decimator can be zero for error_threshold based calculations
-    {
-        target_indices = 3;
-    }
-
-    size_new_indices = LLMeshOptimizer::simplifyU32(
-        output_indices,
-        source_indices,
-        size_indices,
-        combined_positions,
-        size_vertices,
-        LLVertexBuffer::sTypeSize[LLVertexBuffer::TYPE_VERTEX],
-        target_indices,
-        error_threshold,
-        simplification_mode == MESH_OPTIMIZER_NO_TOPOLOGY,
-        &result_error);
-
-    if (result_error < 0)
-    {
-        LL_WARNS() << "Negative result error from meshoptimizer for model " << target_model->mLabel
-            << " target Indices: " << target_indices
-            << " new Indices: " << size_new_indices
-            << " original count: " << size_indices << LL_ENDL;
-    }
-
-    // free unused buffers
-    ll_aligned_free_32(combined_indices);
-    ll_aligned_free_32(shadow_indices);
-    combined_indices = NULL;
-    shadow_indices = NULL;
-
-    if (size_new_indices < 3)
-    {
-        // Model should have at least one visible triangle
-        ll_aligned_free<64>(combined_positions);
-        ll_aligned_free_32(output_indices);
-
-        return -1;
-    }
-
-    // IV. Repack back into individual faces
-
-    LLVector4a* buffer_positions = (LLVector4a*)ll_aligned_malloc<64>(sizeof(LLVector4a) * 3 * size_vertices + tc_bytes_size);
-    LLVector4a* buffer_normals = buffer_positions + size_vertices;
-    LLVector2* buffer_tex_coords = (LLVector2*)(buffer_normals + size_vertices);
-    S32 buffer_idx_size = (size_indices * sizeof(U16) + 0xF) & ~0xF;
-    U16* buffer_indices = (U16*)ll_aligned_malloc_16(buffer_idx_size);
-    S32* old_to_new_positions_map = new S32[size_vertices];
-
-    S32 buf_positions_copied = 0;
-    S32 buf_indices_copied = 0;
-    indices_idx_shift = 0;
-    S32 valid_faces = 0;
-
-    // Crude method to copy indices back into face
-    for (U32 face_idx = 0; face_idx < base_model->getNumVolumeFaces(); ++face_idx)
-    {
-        const LLVolumeFace &face = base_model->getVolumeFace(face_idx);
-
-        // reset data for new run
-        buf_positions_copied = 0;
-        buf_indices_copied = 0;
-        bool copy_triangle = false;
-        S32 range = indices_idx_shift + face.mNumVertices;
-
-        for (S32 i = 0; i < size_vertices; i++)
-        {
-            old_to_new_positions_map[i] = -1;
-        }
-
-        // Copy relevant indices and vertices
-        for (S32 i = 0; i < size_new_indices; ++i)
-        {
-            U32 idx = output_indices[i];
-
-            if ((i % 3) == 0)
-            {
-                copy_triangle = idx >= indices_idx_shift && idx < range;
-            }
-
-            if (copy_triangle)
-            {
-                if (old_to_new_positions_map[idx] == -1)
-                {
-                    // New position, need to copy it
-                    // Validate size
-                    if (buf_positions_copied >= U16_MAX)
-                    {
-                        // Normally this shouldn't happen since the whole point is to reduce amount of vertices
-                        // but it might happen if user tries to run optimization with too large triangle or error value
-                        // so fallback to 'per face' mode or verify requested limits and copy base model as is.
-                        LL_WARNS() << "Over triangle limit. Failed to optimize in 'per object' mode, falling back to per face variant for"
-                            << " model " << target_model->mLabel
-                            << " target Indices: " << target_indices
-                            << " new Indices: " << size_new_indices
-                            << " original count: " << size_indices
-                            << " error treshold: " << error_threshold
-                            << LL_ENDL;
-
-                        // U16 vertices overflow shouldn't happen, but just in case
-                        size_new_indices = 0;
-                        valid_faces = 0;
-                        for (U32 face_idx = 0; face_idx < base_model->getNumVolumeFaces(); ++face_idx)
-                        {
-                            genMeshOptimizerPerFace(base_model, target_model, face_idx, indices_decimator, error_threshold, simplification_mode);
-                            const LLVolumeFace &face = target_model->getVolumeFace(face_idx);
-                            size_new_indices += face.mNumIndices;
-                            if (face.mNumIndices >= 3)
-                            {
-                                valid_faces++;
-                            }
-                        }
-                        if (valid_faces)
-                        {
-                            return (F32)size_indices / (F32)size_new_indices;
-                        }
-                        else
-                        {
-                            return -1;
-                        }
-                    }
-
-                    // Copy vertice, normals, tcs
-                    buffer_positions[buf_positions_copied] = combined_positions[idx];
-                    buffer_normals[buf_positions_copied] = combined_normals[idx];
-                    buffer_tex_coords[buf_positions_copied] = combined_tex_coords[idx];
-
-                    old_to_new_positions_map[idx] = buf_positions_copied;
-
-                    buffer_indices[buf_indices_copied] = (U16)buf_positions_copied;
-                    buf_positions_copied++;
-                }
-                else
-                {
-                    // existing position
-                    buffer_indices[buf_indices_copied] = (U16)old_to_new_positions_map[idx];
-                }
-                buf_indices_copied++;
-            }
-        }
-
-        if (buf_positions_copied >= U16_MAX)
-        {
-            break;
-        }
-
-        LLVolumeFace &new_face = target_model->getVolumeFace(face_idx);
-        //new_face = face; //temp
-
-        if (buf_indices_copied < 3)
-        {
-            // face was optimized away
-            new_face.resizeIndices(3);
-            new_face.resizeVertices(1);
-            memset(new_face.mIndices, 0, sizeof(U16) * 3);
-            new_face.mPositions[0].clear(); // set first vertice to 0
-            new_face.mNormals[0].clear();
-            new_face.mTexCoords[0].setZero();
-        }
-        else
-        {
-            new_face.resizeIndices(buf_indices_copied);
-            new_face.resizeVertices(buf_positions_copied);
-            new_face.allocateTangents(buf_positions_copied);
-            S32 idx_size = (buf_indices_copied * sizeof(U16) + 0xF) & ~0xF;
-            LLVector4a::memcpyNonAliased16((F32*)new_face.mIndices, (F32*)buffer_indices, idx_size);
-
-            LLVector4a::memcpyNonAliased16((F32*)new_face.mPositions, (F32*)buffer_positions, buf_positions_copied * sizeof(LLVector4a));
-            LLVector4a::memcpyNonAliased16((F32*)new_face.mNormals, (F32*)buffer_normals, buf_positions_copied * sizeof(LLVector4a));
-
-            U32 tex_size = (buf_positions_copied * sizeof(LLVector2) + 0xF)&~0xF;
-            LLVector4a::memcpyNonAliased16((F32*)new_face.mTexCoords, (F32*)buffer_tex_coords, tex_size);
-
-            valid_faces++;
-        }
-
-        indices_idx_shift += face.mNumVertices;
-    }
-
-    delete[]old_to_new_positions_map;
-    ll_aligned_free<64>(combined_positions);
-    ll_aligned_free<64>(buffer_positions);
-    ll_aligned_free_32(output_indices);
-    ll_aligned_free_16(buffer_indices);
-
-    if (size_new_indices < 3 || valid_faces == 0)
-    {
-        // Model should have at least one visible triangle
-        return -1;
-    }
-
-    return (F32)size_indices / (F32)size_new_indices;
-}
-
 F32 LLModelPreview::genMeshOptimizerPerFace(LLModel *base_model, LLModel *target_model, U32 face_idx, F32 indices_decimator, F32 error_threshold, eSimplificationMode simplification_mode)
 {
     const LLVolumeFace &face = base_model->getVolumeFace(face_idx);
@@ -1890,6 +1591,25 @@ void LLModelPreview::genMeshOptimizerLODs(S32 which_lod, S32 meshopt_mode, U32 d
         mModel[lod].resize(mBaseModel.size());
         mVertexBuffer[lod].clear();
 
+        // Auto mode simplifies every face of every model at once, spread
+        // over all cores
+        std::unique_ptr<LLMeshLODGenerator> generator;
+        if (meshopt_mode == MESH_OPTIMIZER_AUTO)
+        {
+            LLMeshLODGenerator::Settings settings;
+            settings.mTriangleRatio[lod] = indices_decimator > 0 ? 1.f / indices_decimator : 0.f;
+            settings.mTargetError = lod_error_threshold;
+
+            generator = std::make_unique<LLMeshLODGenerator>(settings, LLMeshLODGenerator::getDefaultThreads());
+            for (U32 mdl_idx = 0; mdl_idx < mBaseModel.size(); ++mdl_idx)
+            {
+                generator->addModel(mBaseModel[mdl_idx]);
+            }
+            generator->generate(lod);
+
+            LL_INFOS() << "Simplified " << mBaseModel.size() << " models for lod " << lod
+                << " in " << generator->getSeconds() << "s on " << generator->getNumThreads() << " threads" << LL_ENDL;
+        }
 
         for (U32 mdl_idx = 0; mdl_idx < mBaseModel.size(); ++mdl_idx)
         {
@@ -1950,119 +1670,26 @@ void LLModelPreview::genMeshOptimizerLODs(S32 which_lod, S32 meshopt_mode, U32 d
 
             if (model_meshopt_mode == MESH_OPTIMIZER_AUTO)
             {
-                // Remove progressively more data if we can't reach the target.
-                F32 allowed_ratio_drift = 1.8f;
-                F32 precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
-
-                if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
-                {
-                    precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_NORMALS);
-                }
-
-                if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
-                {
-                    precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_UVS);
-                }
-
-                if (precise_ratio < 0 || (precise_ratio * allowed_ratio_drift < indices_decimator))
+                // Faces come from the batch, it picked the method per face
+                for (U32 face_idx = 0; face_idx < base->getNumVolumeFaces(); ++face_idx)
                 {
-                    // Try sloppy variant if normal one failed to simplify model enough.
-                    // Sloppy variant can fail entirely and has issues with precision,
-                    // so code needs to do multiple attempts with different decimators.
-                    // Todo: this is a bit of a mess, needs to be refined and improved
-
-                    F32 last_working_decimator = 0.f;
-                    F32 last_working_ratio = F32_MAX;
-
-                    F32 sloppy_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
-
-                    if (sloppy_ratio > 0)
+                    const LLMeshLODGenerator::FaceResult& result = generator->getFace(mdl_idx, lod, face_idx);
+                    LLVolumeFace &new_face = target_model->getVolumeFace(face_idx);
+                    if (result.mMethod == LLMeshLODGenerator::METHOD_EMPTY)
                     {
-                        // Would be better to do a copy of target_model here, but if
-                        // we need to use sloppy decimation, model should be cheap
-                        // and fast to generate and it won't affect end result
-                        last_working_decimator = indices_decimator;
-                        last_working_ratio = sloppy_ratio;
-                    }
-
-                    // Sloppy has a tendecy to error into lower side, so a request for 100
-                    // triangles turns into ~70, so check for significant difference from target decimation
-                    F32 sloppy_ratio_drift = 1.4f;
-                    if (lod_mode == LIMIT_TRIANGLES
-                        && (sloppy_ratio > indices_decimator * sloppy_ratio_drift || sloppy_ratio < 0))
-                    {
-                        // Apply a correction to compensate.
-
-                        // (indices_decimator / res_ratio) by itself is likely to overshoot to a differend
-                        // side due to overal lack of precision, and we don't need an ideal result, which
-                        // likely does not exist, just a better one, so a partial correction is enough.
-                        F32 sloppy_decimator = indices_decimator * (indices_decimator / sloppy_ratio + 1) / 2;
-                        sloppy_ratio = genMeshOptimizerPerModel(base, target_model, sloppy_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
-                    }
-
-                    if (last_working_decimator > 0 && sloppy_ratio < last_working_ratio)
-                    {
-                        // Compensation didn't work, return back to previous decimator
-                        sloppy_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
-                    }
-
-                    if (sloppy_ratio < 0)
-                    {
-                        // Sloppy method didn't work, try with smaller decimation values
-                        {
-                            // Find a decimator that does work
-                            F32 sloppy_decimation_step = sqrt((F32)decimation); // example: 27->15->9->5->3
-                            F32 sloppy_decimator = indices_decimator / sloppy_decimation_step;
-                            U64Microseconds end_time = LLTimer::getTotalTime() + U64Seconds(5);
-
-                            while (sloppy_ratio < 0
-                                && sloppy_decimator > precise_ratio
-                                && sloppy_decimator > 1 // precise_ratio isn't supposed to be below 1, but check just in case
-                                && end_time > LLTimer::getTotalTime())
-                            {
-                                sloppy_ratio = genMeshOptimizerPerModel(base, target_model, sloppy_decimator, lod_error_threshold, MESH_OPTIMIZER_NO_TOPOLOGY);
-                                sloppy_decimator = sloppy_decimator / sloppy_decimation_step;
-                            }
-                        }
-                    }
-
-                    if (sloppy_ratio < 0 || sloppy_ratio < precise_ratio)
-                    {
-                        // Sloppy variant failed to generate triangles or is worse.
-                        // Can happen with models that are too simple as is.
-
-                        if (precise_ratio < 0)
-                        {
-                            // Precise method failed as well, just copy face over
-                            target_model->copyVolumeFaces(base);
-                            precise_ratio = 1.f;
-                        }
-                        else
-                        {
-                            // Fallback to normal method
-                            precise_ratio = genMeshOptimizerPerModel(base, target_model, indices_decimator, lod_error_threshold, MESH_OPTIMIZER_FULL);
-                        }
-
-                        LL_INFOS() << "Model " << target_model->getName()
-                            << " lod " << which_lod
-                            << " resulting ratio " << precise_ratio
-                            << " simplified using per model method." << LL_ENDL;
+                        // Simplified away entirely, keep the face as is
+                        new_face = base->getVolumeFace(face_idx);
                     }
                     else
                     {
-                        LL_INFOS() << "Model " << target_model->getName()
-                            << " lod " << which_lod
-                            << " resulting ratio " << sloppy_ratio
-                            << " sloppily simplified using per model method." << LL_ENDL;
+                        new_face = result.mFace;
                     }
                 }
-                else
-                {
-                    LL_INFOS() << "Model " << target_model->getName()
-                        << " lod " << which_lod
-                        << " resulting ratio " << precise_ratio
-                        << " simplified using per model method." << LL_ENDL;
-                }
+
+                LL_INFOS() << "Model " << target_model->getName()
+                    << " lod " << lod
+                    << " resulting triangles " << target_model->getNumTriangles()
+                    << " of " << base->getNumTriangles() << LL_ENDL;
             }
 
             //blind copy skin weights and just take closest skin weight to point on
@@ -250,10 +250,6 @@ class LLModelPreview final : public LLViewerDynamicTexture, public LLMutex
         MESH_OPTIMIZER_NO_TOPOLOGY,
     } eSimplificationMode;
 
-    // Merges faces into single mesh, simplifies using mesh optimizer,
-    // then splits back into faces.
-    // Returns reached simplification ratio. -1 in case of a failure.
-    F32 genMeshOptimizerPerModel(LLModel *base_model, LLModel *target_model, F32 indices_ratio, F32 error_threshold, eSimplificationMode simplification_mode);
     // Simplifies specified face using mesh optimizer.
     // Returns reached simplification ratio. -1 in case of a failure.
     F32 genMeshOptimizerPerFace(LLModel *base_model, LLModel *target_model, U32 face_idx, F32 indices_ratio, F32 error_threshold, eSimplificationMode simplification_mode);
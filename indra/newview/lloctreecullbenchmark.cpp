@@ -0,0 +1,463 @@
+/**
+ * @file lloctreecullbenchmark.cpp
+ * @brief Times frustum culling through LLOctreeNode and LLLinearOctree
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "lloctreecullbenchmark.h"
+
+#include "lllinearoctree.h"
+#include "lloctree.h"
+#include "llsd.h"
+#include "lltimer.h"
+#include "llviewercontrol.h"
+
+#include <random>
+
+static const U32 NUM_VIEWS = 32;
+static const U32 NUM_PASSES = 4;
+static const F32 REGION_WIDTH = 256.f;
+static const U32 REGIONS_PER_SIDE = 2;
+static const F32 DRAW_DISTANCE = 256.f;
+
+namespace
+{
+    // Stands in for a drawable, with what both trees need
+    class Box : public LLRefCount
+    {
+        LL_ALIGN_NEW
+    public:
+        Box(const LLVector4a& center, const LLVector4a& size, U32 index)
+            : mIndex(index), mBinIndex(-1)
+        {
+            set(center, size);
+        }
+
+        void set(const LLVector4a& center, const LLVector4a& size)
+        {
+            mExtents[0].setSub(center, size);
+            mExtents[1].setAdd(center, size);
+
+            // Back from the extents, so both trees test the same numbers
+            mCenter.setAdd(mExtents[0], mExtents[1]);
+            mCenter.mul(0.5f);
+            mSize.setSub(mExtents[1], mExtents[0]);
+            mSize.mul(0.5f);
+            mRadius = mSize.getLength3().getF32();
+        }
+
+        const LLVector4a* getSpatialExtents() const { return mExtents; }
+        const LLVector4a& getPositionGroup() const  { return mCenter; }
+        F32 getBinRadius() const                    { return mRadius; }
+        S32 getBinIndex() const                     { return mBinIndex; }
+        void setBinIndex(S32 index) const           { mBinIndex = index; }
+
+        LL_ALIGN_16(LLVector4a mCenter);
+        LL_ALIGN_16(LLVector4a mSize);
+        LL_ALIGN_16(LLVector4a mExtents[2]);
+        F32 mRadius;
+        U32 mIndex;
+        mutable S32 mBinIndex;
+    };
+
+    typedef LLOctreeNode<Box, LLPointer<Box>> box_node_t;
+    typedef LLOctreeRoot<Box, LLPointer<Box>> box_root_t;
+    typedef LLLinearOctree<Box, LLPointer<Box>> box_linear_t;
+
+    // Bounds of a node and everything under it, like LLViewerOctreeGroup
+    class BoxGroup : public LLOctreeListener<Box, LLPointer<Box>>
+    {
+        LL_ALIGN_NEW
+    public:
+        BoxGroup(box_node_t* node)
+        {
+            mBounds[0].clear();
+            mBounds[1].clear();
+            node->addListener(this);
+        }
+
+        void handleInsertion(const LLTreeNode<Box>* node, Box* data) override { }
+        void handleRemoval(const LLTreeNode<Box>* node, Box* data) override { }
+        void handleDestruction(const LLTreeNode<Box>* node) override { }
+        void handleStateChange(const LLTreeNode<Box>* node) override { }
+        void handleChildAddition(const box_node_t* parent, box_node_t* child) override
+        {
+            if (child->getListenerCount() == 0)
+            {
+                new BoxGroup(child);
+            }
+        }
+        void handleChildRemoval(const box_node_t* parent, const box_node_t* child) override { }
+
+        LL_ALIGN_16(LLVector4a mBounds[2]);     // center and half size
+    };
+
+    // Children first, so every group can take the bounds of its children
+    class BoxGroupBounds : public LLOctreeTravelerDepthFirst<Box, LLPointer<Box>>
+    {
+    public:
+        void visit(const box_node_t* branch) override
+        {
+            LLVector4a min, max;
+            min.splat(FLT_MAX);
+            max.splat(-FLT_MAX);
+            for (box_node_t::const_element_iter i = branch->getDataBegin(); i != branch->getDataEnd(); ++i)
+            {
+                update_min_max(min, max, (*i)->mExtents[0]);
+                update_min_max(min, max, (*i)->mExtents[1]);
+            }
+            for (U32 i = 0; i < branch->getChildCount(); i++)
+            {
+                const BoxGroup* child = (const BoxGroup*)branch->getChild(i)->getListener(0);
+                LLVector4a low, high;
+                low.setSub(child->mBounds[0], child->mBounds[1]);
+                high.setAdd(child->mBounds[0], child->mBounds[1]);
+                update_min_max(min, max, low);
+                update_min_max(min, max, high);
+            }
+
+            BoxGroup* group = (BoxGroup*)branch->getListener(0);
+            if (min[0] > max[0])
+            {
+                group->mBounds[0].clear();
+                group->mBounds[1].clear();
+                return;
+            }
+            group->mBounds[0].setAdd(min, max);
+            group->mBounds[0].mul(0.5f);
+            group->mBounds[1].setSub(max, min);
+            group->mBounds[1].mul(0.5f);
+        }
+    };
+
+    // Same walk as LLViewerOctreeCull, groups fully inside take everything
+    // under them without further tests
+    class BoxCull : public LLOctreeTraveler<Box, LLPointer<Box>>
+    {
+    public:
+        BoxCull(LLCamera* camera, std::vector<U32>& visible)
+            : mCamera(camera), mVisible(visible), mRes(0) { }
+
+        void traverse(const box_node_t* node) override
+        {
+            if (mRes == 2)
+            {
+                LLOctreeTraveler<Box, LLPointer<Box>>::traverse(node);
+                return;
+            }
+
+            const BoxGroup* group = (const BoxGroup*)node->getListener(0);
+            mRes = mCamera->AABBInFrustum(group->mBounds[0], group->mBounds[1]);
+            if (mRes)
+            {
+                LLOctreeTraveler<Box, LLPointer<Box>>::traverse(node);
+            }
+            mRes = 0;
+        }
+
+        void visit(const box_node_t* branch) override
+        {
+            for (box_node_t::const_element_iter i = branch->getDataBegin(); i != branch->getDataEnd(); ++i)
+            {
+                const Box* box = *i;
+                if (mRes == 2 || mCamera->AABBInFrustum(box->mCenter, box->mSize))
+                {
+                    mVisible.push_back(box->mIndex);
+                }
+            }
+        }
+
+    private:
+        LLCamera* mCamera;
+        std::vector<U32>& mVisible;
+        S32 mRes;
+    };
+}
+
+static LLViewerBenchmark::Registrar<LLOctreeCullBenchmark> sOctreeCullBenchmark;
+
+LLOctreeCullBenchmark::LLOctreeCullBenchmark()
+    : LLViewerBenchmark("octree_cull", "OctreeCullBenchmarkQuit")
+{
+}
+
+bool LLOctreeCullBenchmark::start()
+{
+    const U32 count = gSavedSettings.getU32("OctreeCullBenchmarkCount");
+    if (count == 0)
+    {
+        return false;
+    }
+
+    std::mt19937 gen(2468);
+    auto pick = [&gen](F32 low, F32 high)
+    {
+        return std::uniform_real_distribution<F32>(low, high)(gen);
+    };
+
+    // Most boxes sit in clusters near the ground, like builds, a few are
+    // scattered anywhere, and one in a hundred is large
+    const F32 width = REGION_WIDTH * REGIONS_PER_SIDE;
+    std::vector<LLVector3> clusters;
+    for (U32 i = 0; i < 64; ++i)
+    {
+        clusters.emplace_back(pick(0.f, width), pick(0.f, width), pick(20.f, 60.f));
+    }
+
+    std::normal_distribution<F32> spread(0.f, 12.f);
+    mBoxes.clear();
+    mBoxes.reserve(count * 2);
+    for (U32 i = 0; i < count; ++i)
+    {
+        LLVector3 pos;
+        if (i % 4)
+        {
+            const LLVector3& cluster = clusters[gen() % clusters.size()];
+            pos.set(cluster.mV[VX] + spread(gen), cluster.mV[VY] + spread(gen), cluster.mV[VZ] + fabsf(spread(gen)));
+        }
+        else
+        {
+            pos.set(pick(0.f, width), pick(0.f, width), pick(0.f, 200.f));
+        }
+
+        F32 scale = (i % 100) ? 1.f : 16.f;
+        LLVector4a center, size;
+        center.load3(pos.mV);
+        size.set(pick(0.05f, 2.f) * scale, pick(0.05f, 2.f) * scale, pick(0.05f, 2.f) * scale);
+        mBoxes.push_back(center);
+        mBoxes.push_back(size);
+    }
+
+    // Cameras at avatar height looking about, some from above
+    mViews.clear();
+    for (U32 i = 0; i < NUM_VIEWS; ++i)
+    {
+        View view;
+        view.mOrigin.set(pick(0.f, width), pick(0.f, width), (i % 4) ? pick(22.f, 40.f) : pick(80.f, 200.f));
+        view.mAt.set(pick(-1.f, 1.f), pick(-1.f, 1.f), (i % 4) ? pick(-0.2f, 0.2f) : pick(-1.f, -0.3f));
+        if (view.mAt.normVec() < 0.01f)
+        {
+            view.mAt.set(1.f, 0.f, 0.f);
+        }
+        mViews.push_back(view);
+    }
+
+    LL_INFOS() << "Generated " << count << " boxes and " << NUM_VIEWS << " views" << LL_ENDL;
+    return true;
+}
+
+void LLOctreeCullBenchmark::setupCamera(LLCamera& camera, const View& view) const
+{
+    camera.setNear(0.1f);
+    camera.setFar(DRAW_DISTANCE);
+    camera.setView(1.f);
+    camera.setAspect(16.f / 9.f);
+    LLVector3 up = fabsf(view.mAt.mV[VZ]) > 0.9f ? LLVector3(1.f, 0.f, 0.f) : LLVector3(0.f, 0.f, 1.f);
+    camera.lookAt(view.mOrigin, view.mOrigin + view.mAt, up);
+
+    // Corners the way LLViewerCamera::updateFrustumPlanes() finds them
+    F32 h = tanf(camera.getView() * 0.5f);
+    F32 w = h * camera.getAspect();
+    const F32 dist[] = { camera.getNear(), camera.getFar() };
+    LLVector3 frust[LLCamera::AGENT_FRUSTRUM_NUM];
+    for (U32 i = 0; i < 2; ++i)
+    {
+        const LLVector3 at = camera.getAtAxis() * dist[i];
+        const LLVector3 left = camera.getLeftAxis() * (w * dist[i]);
+        const LLVector3 up_axis = camera.getUpAxis() * (h * dist[i]);
+        frust[i * 4 + 0] = camera.getOrigin() + at + left - up_axis;
+        frust[i * 4 + 1] = camera.getOrigin() + at - left - up_axis;
+        frust[i * 4 + 2] = camera.getOrigin() + at - left + up_axis;
+        frust[i * 4 + 3] = camera.getOrigin() + at + left + up_axis;
+    }
+    camera.calcAgentFrustumPlanes(frust);
+}
+
+void LLOctreeCullBenchmark::idle()
+{
+    // Same node capacity as the partitions, the pipeline may not have set
+    // it yet
+    if (!gOctreeMaxCapacity)
+    {
+        gOctreeMaxCapacity = gSavedSettings.getU32("OctreeMaxNodeCapacity");
+        gOctreeMinSize = gSavedSettings.getF32("OctreeMinimumNodeSize");
+    }
+
+    const U32 count = (U32)mBoxes.size() / 2;
+    std::vector<LLPointer<Box>> boxes;
+    boxes.reserve(count);
+    for (U32 i = 0; i < count; ++i)
+    {
+        boxes.push_back(new Box(mBoxes[i * 2], mBoxes[i * 2 + 1], i));
+    }
+
+    // Same start as LLViewerOctreePartition, the root grows to fit
+    LLVector4a root_center, root_size;
+    root_center.splat(0.f);
+    root_size.splat(1.f);
+    box_root_t* octree = new box_root_t(root_center, root_size, NULL);
+    new BoxGroup(octree);
+
+    LLTimer timer;
+    for (LLPointer<Box>& box : boxes)
+    {
+        octree->insert(box);
+    }
+    BoxGroupBounds bounds;
+    bounds.traverse(octree);
+    F64 octree_build = timer.getElapsedTimeF64();
+
+    timer.reset();
+    box_linear_t linear(gOctreeMaxCapacity);
+    for (LLPointer<Box>& box : boxes)
+    {
+        linear.insert(box);
+    }
+    linear.update();
+    F64 linear_build = timer.getElapsedTimeF64();
+
+    // Move one box in fifty a little, as a frame of moving objects would
+    std::mt19937 gen(1357);
+    std::uniform_real_distribution<F32> nudge(-2.f, 2.f);
+    std::vector<U32> moved;
+    for (U32 i = 0; i < count; i += 50)
+    {
+        moved.push_back(i);
+        LLVector4a offset(nudge(gen), nudge(gen), nudge(gen));
+        LLVector4a center;
+        center.setAdd(boxes[i]->mCenter, offset);
+        mBoxes[i * 2] = center;
+    }
+
+    timer.reset();
+    for (U32 i : moved)
+    {
+        LLPointer<Box> box = boxes[i];
+        octree->remove(box);
+        box->set(mBoxes[i * 2], mBoxes[i * 2 + 1]);
+        octree->insert(box);
+    }
+    bounds.traverse(octree);
+    F64 octree_move = timer.getElapsedTimeF64();
+
+    timer.reset();
+    for (U32 i : moved)
+    {
+        linear.insert(boxes[i]);
+    }
+    linear.update();
+    F64 linear_move = timer.getElapsedTimeF64();
+
+    // Both walks for every view, a few passes over all of them. The first
+    // pass of each doubles as warm up.
+    std::vector<std::vector<U32>> octree_visible(NUM_VIEWS), linear_visible(NUM_VIEWS);
+    F64 octree_cull = 0.0;
+    F64 linear_cull = 0.0;
+    for (U32 pass = 0; pass < NUM_PASSES; ++pass)
+    {
+        for (U32 i = 0; i < NUM_VIEWS; ++i)
+        {
+            LLCamera camera;
+            setupCamera(camera, mViews[i]);
+
+            std::vector<U32>& octree_result = octree_visible[i];
+            octree_result.clear();
+            timer.reset();
+            BoxCull culler(&camera, octree_result);
+            culler.traverse(octree);
+            octree_cull += timer.getElapsedTimeF64();
+
+            std::vector<U32>& linear_result = linear_visible[i];
+            linear_result.clear();
+            timer.reset();
+            box_linear_t::Frustum frustum;
+            for (U32 j = 0; j < LLCamera::AGENT_PLANE_NO_USER_CLIP_NUM; ++j)
+            {
+                frustum.addPlane(camera.getAgentPlane(j));
+            }
+            linear.cull(frustum, [&linear_result](const LLPointer<Box>& box)
+                {
+                    linear_result.push_back(box->mIndex);
+                });
+            linear_cull += timer.getElapsedTimeF64();
+        }
+    }
+
+    U64 visible = 0;
+    U32 mismatches = 0;
+    for (U32 i = 0; i < NUM_VIEWS; ++i)
+    {
+        std::sort(octree_visible[i].begin(), octree_visible[i].end());
+        std::sort(linear_visible[i].begin(), linear_visible[i].end());
+        visible += octree_visible[i].size();
+        if (octree_visible[i] != linear_visible[i])
+        {
+            ++mismatches;
+        }
+    }
+
+    const U32 culls = NUM_VIEWS * NUM_PASSES;
+    octree_cull = llmax(octree_cull, 0.000001);
+    linear_cull = llmax(linear_cull, 0.000001);
+
+    LLSD sd;
+    sd["boxes"] = (LLSD::Integer)count;
+    sd["views"] = (LLSD::Integer)NUM_VIEWS;
+    sd["passes"] = (LLSD::Integer)NUM_PASSES;
+    sd["visible_per_view"] = (LLSD::Real)visible / NUM_VIEWS;
+    sd["moved"] = (LLSD::Integer)moved.size();
+    sd["mismatched_views"] = (LLSD::Integer)mismatches;
+
+    LLSD& octree_sd = sd["octree"];
+    octree_sd["build_seconds"] = octree_build;
+    octree_sd["move_seconds"] = octree_move;
+    octree_sd["cull_seconds"] = octree_cull;
+    octree_sd["ms_per_cull"] = octree_cull * 1000.0 / culls;
+
+    LLSD& linear_sd = sd["linear"];
+    linear_sd["build_seconds"] = linear_build;
+    linear_sd["move_seconds"] = linear_move;
+    linear_sd["cull_seconds"] = linear_cull;
+    linear_sd["ms_per_cull"] = linear_cull * 1000.0 / culls;
+    linear_sd["nodes"] = (LLSD::Integer)linear.getNodeCount();
+    linear_sd["bytes"] = (LLSD::Real)linear.getMemoryUsage();
+    linear_sd["cull_speedup"] = octree_cull / linear_cull;
+
+    LL_INFOS() << llformat("%u boxes, %u views, %.0f visible per view", count, NUM_VIEWS, (F64)visible / NUM_VIEWS) << LL_ENDL;
+    LL_INFOS() << llformat("Octree: %.3fs to build, %.3fs to move %u, %.3fms per cull", octree_build, octree_move,
+                           (U32)moved.size(), octree_cull * 1000.0 / culls) << LL_ENDL;
+    LL_INFOS() << llformat("Linear: %.3fs to build, %.3fs to move %u, %.3fms per cull, %.2fx, %u nodes, %u KB",
+                           linear_build, linear_move, (U32)moved.size(), linear_cull * 1000.0 / culls,
+                           octree_cull / linear_cull, linear.getNodeCount(), (U32)(linear.getMemoryUsage() / 1024))
+               << LL_ENDL;
+    if (mismatches)
+    {
+        LL_WARNS() << mismatches << " views saw different boxes" << LL_ENDL;
+    }
+    writeReport(sd);
+
+    delete octree;
+    finish();
+}
@@ -0,0 +1,74 @@
+/**
+ * @file lloctreecullbenchmark.h
+ * @brief Times frustum culling through LLOctreeNode and LLLinearOctree
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLOCTREECULLBENCHMARK_H
+#define LL_LLOCTREECULLBENCHMARK_H
+
+#include "llcamera.h"
+#include "llvector4a.h"
+#include "llviewerbenchmark.h"
+
+#include <vector>
+
+// Scatters boxes over a few regions, the way the drawables of a busy scene
+// are spread, and frustum culls them from a set of cameras twice: through
+// an LLOctreeNode tree with bounds kept in a listener on every node, the
+// way LLViewerOctreeCull walks a partition, and through LLLinearOctree.
+// Building, moving a few percent of the boxes and culling are timed apart,
+// and the visible sets of both trees are checked against each other.
+//
+// Started with --octreecullbenchmark <count>, 100000 is a good size. Boxes
+// and cameras come from a fixed seed so that runs compare. The report is
+// logged and written to octree_cull_benchmark.xml in the log directory.
+class LLOctreeCullBenchmark final : public LLViewerBenchmark
+{
+    LOG_CLASS(LLOctreeCullBenchmark);
+
+public:
+    LLOctreeCullBenchmark();
+
+protected:
+    // Makes OctreeCullBenchmarkCount random boxes and the cameras
+    bool start() override;
+
+    // Runs the benchmark on the first call
+    void idle() override;
+
+private:
+    struct View
+    {
+        LLVector3 mOrigin;
+        LLVector3 mAt;
+    };
+
+    void setupCamera(LLCamera& camera, const View& view) const;
+
+private:
+    std::vector<LLVector4a> mBoxes;     // center and half size of each box
+    std::vector<View> mViews;
+};
+
+#endif // LL_LLOCTREECULLBENCHMARK_H
@@ -0,0 +1,252 @@
+/**
+ * @file llraycastbenchmark.cpp
+ * @brief Times volume ray casts through the octree and through LLVolumeBVH
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llraycastbenchmark.h"
+
+#include "llsd.h"
+#include "lltimer.h"
+#include "llviewercontrol.h"
+#include "llvolumebvh.h"
+#include "llvolumemgr.h"
+
+#include <random>
+
+static const S32 BENCHMARK_LOD = 3;
+static const U32 RAYS_PER_VOLUME = 256;
+
+static LLViewerBenchmark::Registrar<LLRaycastBenchmark> sRaycastBenchmark;
+
+LLRaycastBenchmark::LLRaycastBenchmark()
+    : LLViewerBenchmark("raycast", "RaycastBenchmarkQuit")
+{
+}
+
+bool LLRaycastBenchmark::start()
+{
+    const U32 count = gSavedSettings.getU32("RaycastBenchmarkCount");
+    if (count == 0)
+    {
+        return false;
+    }
+
+    static const U8 profiles[] = { LL_PCODE_PROFILE_CIRCLE, LL_PCODE_PROFILE_SQUARE, LL_PCODE_PROFILE_ISOTRI,
+                                   LL_PCODE_PROFILE_EQUALTRI, LL_PCODE_PROFILE_RIGHTTRI, LL_PCODE_PROFILE_CIRCLE_HALF };
+    static const U8 holes[] = { LL_PCODE_HOLE_SAME, LL_PCODE_HOLE_CIRCLE, LL_PCODE_HOLE_SQUARE, LL_PCODE_HOLE_TRIANGLE };
+    static const U8 paths[] = { LL_PCODE_PATH_LINE, LL_PCODE_PATH_CIRCLE, LL_PCODE_PATH_CIRCLE2, LL_PCODE_PATH_TEST };
+
+    std::mt19937 gen(4321);
+    auto pick = [&gen](F32 low, F32 high)
+    {
+        return std::uniform_real_distribution<F32>(low, high)(gen);
+    };
+
+    mParams.clear();
+    mParams.reserve(count);
+    for (U32 i = 0; i < count; ++i)
+    {
+        LLVolumeParams params;
+        params.setType(profiles[gen() % LL_ARRAY_SIZE(profiles)] | holes[gen() % LL_ARRAY_SIZE(holes)],
+                       paths[gen() % LL_ARRAY_SIZE(paths)]);
+
+        // Setters clamp, so out of range picks just land on the limits
+        F32 begin = pick(0.f, 0.5f);
+        params.setBeginAndEndS(begin, pick(begin + 0.1f, 1.f));
+        begin = pick(0.f, 0.5f);
+        params.setBeginAndEndT(begin, pick(begin + 0.1f, 1.f));
+        params.setHollow(pick(0.f, 0.95f));
+        params.setTwistBegin(pick(-1.f, 1.f));
+        params.setTwistEnd(pick(-1.f, 1.f));
+        params.setRatio(pick(0.f, 2.f), pick(0.f, 2.f));
+        params.setShear(pick(-0.5f, 0.5f), pick(-0.5f, 0.5f));
+        params.setTaper(pick(-1.f, 1.f), pick(-1.f, 1.f));
+        params.setRevolutions(pick(1.f, 4.f));
+        params.setRadiusOffset(pick(-1.f, 1.f));
+        params.setSkew(pick(-0.95f, 0.95f));
+        mParams.push_back(params);
+    }
+
+    // Segments from a sphere around the unit cube towards a point inside it,
+    // running on past it like a pick ray would. The same rays serve every
+    // volume.
+    mRays.clear();
+    mRays.reserve(RAYS_PER_VOLUME * 2);
+    for (U32 i = 0; i < RAYS_PER_VOLUME; ++i)
+    {
+        LLVector3 from(pick(-1.f, 1.f), pick(-1.f, 1.f), pick(-1.f, 1.f));
+        from.normVec();
+        from *= 2.f;
+        LLVector3 target(pick(-0.5f, 0.5f), pick(-0.5f, 0.5f), pick(-0.5f, 0.5f));
+        LLVector3 to = from + (target - from) * 2.f;
+
+        LLVector4a start, end;
+        start.load3(from.mV);
+        end.load3(to.mV);
+        mRays.push_back(start);
+        mRays.push_back(end);
+    }
+
+    LL_INFOS() << "Generated " << mParams.size() << " prim shapes and " << RAYS_PER_VOLUME << " rays" << LL_ENDL;
+    return true;
+}
+
+F64 LLRaycastBenchmark::cast(std::vector<LLPointer<LLVolume> >& volumes, std::vector<Hit>& hits)
+{
+    hits.clear();
+    hits.reserve(volumes.size() * RAYS_PER_VOLUME);
+
+    LLTimer total;
+    for (LLPointer<LLVolume>& volume : volumes)
+    {
+        for (size_t i = 0; i < mRays.size(); i += 2)
+        {
+            Hit hit;
+            hit.mPoint.clear();
+            hit.mFace = volume->lineSegmentIntersect(mRays[i], mRays[i + 1], -1, &hit.mPoint);
+            hits.push_back(hit);
+        }
+    }
+    return total.getElapsedTimeF64();
+}
+
+void LLRaycastBenchmark::idle()
+{
+    F32 detail = LLVolumeLODGroup::getVolumeScaleFromDetail(BENCHMARK_LOD);
+    std::vector<LLPointer<LLVolume> > volumes;
+    volumes.reserve(mParams.size());
+    U64 triangles = 0;
+    for (const LLVolumeParams& params : mParams)
+    {
+        LLPointer<LLVolume> volume = new LLVolume(params, detail);
+        for (S32 i = 0; i < volume->getNumVolumeFaces(); ++i)
+        {
+            triangles += volume->getVolumeFace(i).mNumIndices / 3;
+        }
+        volumes.push_back(volume);
+    }
+
+    LLTimer timer;
+    for (LLPointer<LLVolume>& volume : volumes)
+    {
+        for (S32 i = 0; i < volume->getNumVolumeFaces(); ++i)
+        {
+            volume->getVolumeFace(i).createOctree();
+        }
+    }
+    F64 octree_build = timer.getElapsedTimeF64();
+
+    timer.reset();
+    for (LLPointer<LLVolume>& volume : volumes)
+    {
+        for (S32 i = 0; i < volume->getNumVolumeFaces(); ++i)
+        {
+            volume->getVolumeFace(i).createBVH();
+        }
+    }
+    F64 bvh_build = timer.getElapsedTimeF64();
+
+    U64 bvh_nodes = 0;
+    U64 bvh_bytes = 0;
+    for (LLPointer<LLVolume>& volume : volumes)
+    {
+        for (S32 i = 0; i < volume->getNumVolumeFaces(); ++i)
+        {
+            const LLVolumeBVH* bvh = volume->getVolumeFace(i).getBVH();
+            if (bvh)
+            {
+                bvh_nodes += bvh->getNumNodes();
+                bvh_bytes += bvh->getMemoryUsage();
+            }
+        }
+    }
+
+    // The octree pass doubles as warm up for the hierarchy pass
+    const bool use_bvh = LLVolume::sUseBVH;
+    std::vector<Hit> octree_hits, bvh_hits;
+    LLVolume::sUseBVH = false;
+    F64 octree_time = cast(volumes, octree_hits);
+    LLVolume::sUseBVH = true;
+    F64 bvh_time = cast(volumes, bvh_hits);
+    LLVolume::sUseBVH = use_bvh;
+
+    U32 hits = 0;
+    U32 mismatches = 0;
+    for (size_t i = 0; i < octree_hits.size(); ++i)
+    {
+        const Hit& lhs = octree_hits[i];
+        const Hit& rhs = bvh_hits[i];
+        if (lhs.mFace >= 0)
+        {
+            ++hits;
+        }
+        // Ties between faces can go either way, the point can't
+        if ((lhs.mFace < 0) != (rhs.mFace < 0) || !lhs.mPoint.equals3(rhs.mPoint, 0.0001f))
+        {
+            ++mismatches;
+        }
+    }
+
+    const size_t count = octree_hits.size();
+    octree_time = llmax(octree_time, 0.000001);
+    bvh_time = llmax(bvh_time, 0.000001);
+
+    LLSD sd;
+    sd["volumes"] = (LLSD::Integer)volumes.size();
+    sd["lod"] = BENCHMARK_LOD;
+    sd["triangles"] = (LLSD::Real)triangles;
+    sd["rays"] = (LLSD::Integer)count;
+    sd["hits"] = (LLSD::Integer)hits;
+    sd["mismatches"] = (LLSD::Integer)mismatches;
+
+    LLSD& octree = sd["octree"];
+    octree["build_seconds"] = octree_build;
+    octree["cast_seconds"] = octree_time;
+    octree["rays_per_second"] = count / octree_time;
+
+    LLSD& bvh = sd["bvh"];
+    bvh["build_seconds"] = bvh_build;
+    bvh["cast_seconds"] = bvh_time;
+    bvh["rays_per_second"] = count / bvh_time;
+    bvh["nodes"] = (LLSD::Real)bvh_nodes;
+    bvh["bytes"] = (LLSD::Real)bvh_bytes;
+    bvh["cast_speedup"] = octree_time / bvh_time;
+    bvh["build_speedup"] = octree_build / llmax(bvh_build, 0.000001);
+
+    LL_INFOS() << llformat("%u volumes at LOD %d, %llu triangles, %u rays, %u hits", (U32)volumes.size(), BENCHMARK_LOD,
+                           (unsigned long long)triangles, (U32)count, hits) << LL_ENDL;
+    LL_INFOS() << llformat("Octree: %.3fs to build, %.3fs to cast, %.0f rays/s", octree_build, octree_time,
+                           count / octree_time) << LL_ENDL;
+    LL_INFOS() << llformat("BVH:    %.3fs to build, %.3fs to cast, %.0f rays/s, %.2fx, %llu nodes, %llu KB", bvh_build,
+                           bvh_time, count / bvh_time, octree_time / bvh_time, (unsigned long long)bvh_nodes,
+                           (unsigned long long)(bvh_bytes / 1024)) << LL_ENDL;
+    if (mismatches)
+    {
+        LL_WARNS() << mismatches << " rays hit differently" << LL_ENDL;
+    }
+    writeReport(sd);
+    finish();
+}
@@ -0,0 +1,73 @@
+/**
+ * @file llraycastbenchmark.h
+ * @brief Times volume ray casts through the octree and through LLVolumeBVH
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLRAYCASTBENCHMARK_H
+#define LL_LLRAYCASTBENCHMARK_H
+
+#include "llviewerbenchmark.h"
+#include "llvolume.h"
+
+#include <vector>
+
+// Builds a set of random prim shapes at the highest LOD and casts random
+// segments through each of them, once with the per face octrees and once
+// with LLVolumeBVH, both through LLVolume::lineSegmentIntersect(). Build
+// times are reported apart from the casts, and every hit is checked
+// against the other path.
+//
+// Started with --raycastbenchmark <count>. Shapes and rays come from a
+// fixed seed so that runs compare. The report is logged and written to
+// raycast_benchmark.xml in the log directory.
+class LLRaycastBenchmark final : public LLViewerBenchmark
+{
+    LOG_CLASS(LLRaycastBenchmark);
+
+public:
+    LLRaycastBenchmark();
+
+protected:
+    // Makes RaycastBenchmarkCount random shapes and their rays
+    bool start() override;
+
+    // Runs the benchmark on the first call
+    void idle() override;
+
+private:
+    struct Hit
+    {
+        S32 mFace;
+        LLVector4a mPoint;
+    };
+
+    // Seconds to cast every ray at every volume
+    F64 cast(std::vector<LLPointer<LLVolume> >& volumes, std::vector<Hit>& hits);
+
+private:
+    std::vector<LLVolumeParams> mParams;
+    std::vector<LLVector4a> mRays;  // start and end of each ray, in volume space
+};
+
+#endif // LL_LLRAYCASTBENCHMARK_H
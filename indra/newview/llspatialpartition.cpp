@@ -603,7 +603,7 @@ LLSpatialGroup::LLSpatialGroup(OctreeNode* node, LLSpatialPartition* part) : LLO
     mPixelArea = 1024.f;
 }
 
-void LLSpatialGroup::updateDistance(LLCamera &camera)
+void LLSpatialGroup::updateDistance(LLCamera &camera, F32 pixel_area)
 {
     if (LLViewerCamera::sCurCameraID != LLViewerCamera::CAMERA_WORLD)
     {
@@ -628,7 +628,7 @@ void LLSpatialGroup::updateDistance(LLCamera &camera)
         mRadius = getSpatialPartition()->mRenderByGroup ? mObjectBounds[1].getLength3().getF32() :
                         (F32) mOctreeNode->getSize().getLength3().getF32();
         mDistance = getSpatialPartition()->calcDistance(this, camera);
-        mPixelArea = getSpatialPartition()->calcPixelArea(this, camera);
+        mPixelArea = getSpatialPartition()->calcPixelArea(this, camera, pixel_area);
     }
 }
 
@@ -709,8 +709,12 @@ F32 LLSpatialPartition::calcDistance(LLSpatialGroup* group, LLCamera& camera)
     return dist;
 }
 
-F32 LLSpatialPartition::calcPixelArea(LLSpatialGroup* group, LLCamera& camera)
+F32 LLSpatialPartition::calcPixelArea(LLSpatialGroup* group, LLCamera& camera, F32 estimate)
 {
+    if (estimate >= 0.f)
+    {
+        return estimate;
+    }
     return LLPipeline::calcPixelArea(group->mObjectBounds[0], group->mObjectBounds[1], camera);
 }
 
@@ -1038,6 +1042,8 @@ void LLSpatialPartition::shift(const LLVector4a &offset)
     shifter.traverse(mOctree);
 }
 
+extern BOOL gCubeSnapshot;
+
 class LLOctreeCull : public LLViewerOctreeCull
 {
 public:
@@ -1084,6 +1090,20 @@ class LLOctreeCull : public LLViewerOctreeCull
         return res;
     }
 
+    virtual bool frustumCheckBatch(LLViewerOctreeGroup* const* groups, U32 count, S32* results, F32* pixel_area)
+    {
+        AABBInFrustumGroupBoundsBatch(groups, count, results, false, false);
+        for (U32 i = 0; i < count; i++)
+        {
+            if (results[i] != 0)
+            {
+                results[i] = llmin(results[i], AABBSphereIntersectGroupExtents(groups[i]));
+            }
+        }
+        calcPixelAreaBatch(count, pixel_area);
+        return true;
+    }
+
     virtual void processGroup(LLViewerOctreeGroup* base_group)
     {
         LLSpatialGroup* group = (LLSpatialGroup*)base_group;
@@ -1092,7 +1112,20 @@ class LLOctreeCull : public LLViewerOctreeCull
         {
             group->doOcclusion(mCamera);
         }*/
-        gPipeline.markNotCulled(group, *mCamera);
+        gPipeline.markNotCulled(group, *mCamera, mPixelArea);
+    }
+
+protected:
+    //pixel areas of the boxes of the last batch that are in view, for
+    //markNotCulled() to pass on to LLSpatialGroup::updateDistance(). Leaf
+    //group bounds are their object bounds, which the areas are taken of.
+    void calcPixelAreaBatch(U32 count, F32* pixel_area)
+    {
+        std::fill(pixel_area, pixel_area + count, -1.f);
+        if (LLViewerCamera::sCurCameraID == LLViewerCamera::CAMERA_WORLD && !gCubeSnapshot)
+        {
+            mCamera->calcPixelAreaBatch(mBatch, LLDrawable::sCurPixelAngle, pixel_area, mVisibleMask.data());
+        }
     }
 };
 
@@ -1112,6 +1145,13 @@ class LLOctreeCullNoFarClip : public LLOctreeCull
         S32 res = AABBInFrustumNoFarClipObjectBounds(group);
         return res;
     }
+
+    virtual bool frustumCheckBatch(LLViewerOctreeGroup* const* groups, U32 count, S32* results, F32* pixel_area)
+    {
+        AABBInFrustumGroupBoundsBatch(groups, count, results, false, false);
+        calcPixelAreaBatch(count, pixel_area);
+        return true;
+    }
 };
 
 class LLOctreeCullShadow : public LLOctreeCull
@@ -1129,6 +1169,13 @@ class LLOctreeCullShadow : public LLOctreeCull
     {
         return AABBInFrustumObjectBounds(group);
     }
+
+    virtual bool frustumCheckBatch(LLViewerOctreeGroup* const* groups, U32 count, S32* results, F32* pixel_area)
+    {
+        AABBInFrustumGroupBoundsBatch(groups, count, results, true, false);
+        calcPixelAreaBatch(count, pixel_area);
+        return true;
+    }
 };
 
 class LLOctreeCullVisExtents: public LLOctreeCullShadow
@@ -1429,8 +1476,6 @@ S32 LLSpatialPartition::cull(LLCamera &camera, std::vector<LLDrawable *>* result
     return 0;
 }
 
-extern BOOL gCubeSnapshot;
-
 S32 LLSpatialPartition::cull(LLCamera &camera, bool do_occlusion)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_SPATIAL;
@@ -285,7 +285,8 @@ class LLSpatialGroup final : public LLOcclusionCullingGroup
     // TODO: this no longer appears to be called, figure out if it's important and if not remove it
     void destroyGLState(bool keep_occlusion = false);
 
-    void updateDistance(LLCamera& camera);
+    // pixel_area is the culler's estimate when it has one, see LLSpatialPartition::calcPixelArea()
+    void updateDistance(LLCamera& camera, F32 pixel_area = -1.f);
     F32 getUpdateUrgency() const;
     BOOL changeLOD();
     void rebuildGeom();
@@ -393,7 +394,9 @@ class LLSpatialPartition: public LLViewerOctreePartition, public LLGeometryManag
     virtual void shift(const LLVector4a &offset);
 
     virtual F32 calcDistance(LLSpatialGroup* group, LLCamera& camera);
-    virtual F32 calcPixelArea(LLSpatialGroup* group, LLCamera& camera);
+    // estimate is what LLPipeline::calcPixelArea() gives for the object bounds
+    // of the group when culling already worked it out, negative otherwise
+    virtual F32 calcPixelArea(LLSpatialGroup* group, LLCamera& camera, F32 estimate);
 
     virtual void rebuildGeom(LLSpatialGroup* group);
     virtual void rebuildMesh(LLSpatialGroup* group);
@@ -623,7 +626,7 @@ class LLParticlePartition : public LLSpatialPartition
     void rebuildGeom(LLSpatialGroup* group) final;
     void getGeometry(LLSpatialGroup* group) final;
     void addGeometryCount(LLSpatialGroup* group, U32 &vertex_count, U32& index_count) final;
-    F32 calcPixelArea(LLSpatialGroup* group, LLCamera& camera) final;
+    F32 calcPixelArea(LLSpatialGroup* group, LLCamera& camera, F32 estimate) final;
 protected:
     U32 mRenderPass;
 };
@@ -721,7 +724,7 @@ class LLHUDBridge final : public LLVolumeBridge
 public:
     LLHUDBridge(LLDrawable* drawablep, LLViewerRegion* regionp);
     virtual void shiftPos(const LLVector4a& vec);
-    virtual F32 calcPixelArea(LLSpatialGroup* group, LLCamera& camera);
+    virtual F32 calcPixelArea(LLSpatialGroup* group, LLCamera& camera, F32 estimate);
 };
 
 //spatial partition that holds nothing but spatial bridges
@@ -66,6 +66,7 @@
 #include "llloginflags.h"
 #include "llmd5.h"
 #include "llmemorystream.h"
+#include "llmessagecapture.h"
 #include "llmessageconfig.h"
 #include "llmoveview.h"
 #include "llfloaterimcontainer.h"
@@ -650,6 +651,17 @@ bool idle_startup()
                 msg->startLogging();
             }
 
+            // Record the session's traffic for LLMessageReplay, see --messagecapture
+            std::string capture_file = gSavedSettings.getString("MessageCaptureFile");
+            if (!capture_file.empty())
+            {
+                if (gDirUtilp->getBaseFileName(capture_file) == capture_file)
+                {
+                    capture_file = gDirUtilp->getExpandedFilename(LL_PATH_LOGS, capture_file);
+                }
+                LLMessageCapture::start(capture_file);
+            }
+
             // start the xfer system. by default, choke the downloads
             // a lot...
             const S32 VIEWER_MAX_XFER = 3;
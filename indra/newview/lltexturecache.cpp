@@ -33,6 +33,7 @@
 #include "llimage.h"
 #include "llimagej2c.h" // for version control
 #include "lllfsthread.h"
+#include "lltexturedecodedcache.h"
 #include "llviewercontrol.h"
 
 // Included to allow LLTextureCache::purgeTextures() to pause watchdog timeout
@@ -46,6 +47,8 @@
 //  First TEXTURE_CACHE_ENTRY_SIZE bytes of each texture in texture.entries in same order
 // cache/textures/[0-F]/UUID.texture
 //  Actual texture body files
+// cache/textures/decoded
+//  LLTextureDecodedCache
 
 //note: there is no good to define 1024 for TEXTURE_CACHE_ENTRY_SIZE while FIRST_PACKET_SIZE is 600 on sim side.
 const S32 TEXTURE_CACHE_ENTRY_SIZE = FIRST_PACKET_SIZE;//1024;
@@ -806,7 +809,8 @@ LLTextureCache::LLTextureCache(bool threaded)
       mDoPurge(FALSE),
       mFastCachep(NULL),
       mFastCachePoolp(NULL),
-      mFastCachePadBuffer(NULL)
+      mFastCachePadBuffer(NULL),
+      mDecodedCache(std::make_shared<LLTextureDecodedCache>())
 {
     mHeaderAPRFilePoolp = new LLVolatileAPRPool("Texture Cache Pool"); // is_local = true, because this pool is for headers, headers are under own mutex
 }
@@ -815,6 +819,7 @@ LLTextureCache::~LLTextureCache()
 {
     clearDeleteList() ;
     writeUpdatedEntries() ;
+    mDecodedCache->writeIndex();
     delete mFastCachep;
     delete mFastCachePoolp;
     delete mHeaderAPRFilePoolp;
@@ -949,6 +954,7 @@ const char* old_textures_dirname = "textures";
 //change the location of the texture cache to prevent from being deleted by old version viewers.
 const char* textures_dirname = "texturecache";
 const char* fast_cache_filename = "FastCache.cache";
+const char* decoded_dirname = "decoded";
 
 void LLTextureCache::setDirNames(ELLPath location)
 {
@@ -958,6 +964,11 @@ void LLTextureCache::setDirNames(ELLPath location)
     mFastCacheFileName =  gDirUtilp->getExpandedFilename(location, textures_dirname, fast_cache_filename);
 }
 
+std::string LLTextureCache::getDecodedDirName() const
+{
+    return mTexturesDirName + gDirUtilp->getDirDelimiter() + decoded_dirname;
+}
+
 void LLTextureCache::purgeCache(ELLPath location, bool remove_dir)
 {
     LLMutexLock lock(&mHeaderMutex);
@@ -1045,6 +1056,15 @@ S64 LLTextureCache::initCache(ELLPath location, S64 max_size, BOOL texture_cache
     llassert_always(getPending() == 0) ; //should not start accessing the texture cache before initialized.
     openFastCache(true);
 
+    // Sized on its own, on top of TextureCacheSize
+    const S64 MB = 1024ll * 1024ll;
+    S64 decoded_size = gSavedSettings.getBOOL("TextureDecodedCacheEnabled") ?
+        (S64)gSavedSettings.getU32("TextureDecodedCacheSize") * MB : 0;
+    mDecodedCache->initCache(getDecodedDirName(), decoded_size,
+                             gSavedSettings.getU32("TextureDecodedCacheMinUses"),
+                             gSavedSettings.getBOOL("TextureDecodedCacheCompress"),
+                             mReadOnly);
+
     return max_size; // unused cache space
 }
 
@@ -1609,6 +1629,7 @@ void LLTextureCache::purgeAllTextures(bool purge_directories)
             PeekMessage(&msg, 0, 0, 0, PM_NOREMOVE | PM_NOYIELD);
 #endif
         }
+        mDecodedCache->purge(getDecodedDirName(), purge_directories);
         gDirUtilp->deleteFilesInDir(mTexturesDirName, mask); // headers, fast cache
         if (purge_directories)
         {
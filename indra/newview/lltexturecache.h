@@ -36,8 +36,11 @@
 
 #include <boost/unordered/unordered_flat_map.hpp>
 
+#include <memory>
+
 class LLImageFormatted;
 class LLTextureCacheWorker;
+class LLTextureDecodedCache;
 class LLImageRaw;
 
 class LLTextureCache final : public LLWorkerThread
@@ -135,6 +138,9 @@ class LLTextureCache final : public LLWorkerThread
 
     bool removeFromCache(const LLUUID& id);
 
+    // Second tier holding decoded textures, see lltexturedecodedcache.h
+    LLTextureDecodedCache* getDecodedCache() { return mDecodedCache.get(); }
+
     // For LLTextureCacheWorker::Responder
     LLTextureCacheWorker* getReader(handle_t handle);
     LLTextureCacheWorker* getWriter(handle_t handle);
@@ -162,6 +168,7 @@ class LLTextureCache final : public LLWorkerThread
 
 private:
     void setDirNames(ELLPath location);
+    std::string getDecodedDirName() const;
     void readHeaderCache();
     void clearCorruptedCache();
     void purgeAllTextures(bool purge_directories);
@@ -241,6 +248,9 @@ class LLTextureCache final : public LLWorkerThread
     S64 mTexturesSizeTotal;
     LLAtomicBool mDoPurge;
 
+    // Shared with the writes it posts to the General work queue
+    std::shared_ptr<LLTextureDecodedCache> mDecodedCache;
+
     typedef std::map<S32, Entry> idx_entry_map_t;
     idx_entry_map_t mUpdatedEntryMap;
     typedef std::vector<std::pair<S32, Entry> > idx_entry_vector_t;
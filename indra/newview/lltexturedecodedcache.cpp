@@ -0,0 +1,217 @@
+/**
+ * @file lltexturedecodedcache.cpp
+ * @brief Disk cache of decoded textures, keyed by id and discard level
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "lltexturedecodedcache.h"
+
+#include "llapr.h"
+#include "llimage.h"
+#include "llimagebc.h"
+
+// Files, see LLDecodedDiskCache for the index:
+// cache/texturecache/decoded/[0-F]/UUID_discard_0.decoded
+//  FileHeader followed by the pixels, raw or block compressed
+
+namespace
+{
+    const U32 INDEX_MAGIC = 0x49435444;     // "DTCI"
+    const U32 FILE_MAGIC = 0x46435444;      // "DTCF"
+    const U32 FILE_VERSION = 1;
+
+    enum ECodec : U8
+    {
+        CODEC_RAW = 0,
+        CODEC_BC1,
+        CODEC_BC3
+    };
+
+#if LL_WINDOWS
+#pragma pack(push,1)
+#endif
+    struct FileHeader
+    {
+        U32 mMagic;
+        U32 mVersion;
+        LLUUID mID;
+        U16 mWidth;
+        U16 mHeight;
+        U8 mComponents;
+        U8 mDiscard;
+        U8 mCodec;
+        U8 mPad;
+    };
+#if LL_WINDOWS
+#pragma pack(pop)
+#endif
+
+    S32 payload_size(U8 codec, S32 width, S32 height, S32 components)
+    {
+        switch (codec)
+        {
+        case CODEC_BC1: return LLImageBC::levelBytes(LLImageBC::FORMAT_BC1, width, height);
+        case CODEC_BC3: return LLImageBC::levelBytes(LLImageBC::FORMAT_BC3, width, height);
+        default:        return width * height * components;
+        }
+    }
+}
+
+LLTextureDecodedCache::LLTextureDecodedCache()
+    : LLDecodedDiskCache("Decoded textures", INDEX_MAGIC),
+      mCompress(false)
+{
+}
+
+// Called in the main thread
+void LLTextureDecodedCache::initCache(const std::string& dir_name, S64 max_size, U32 min_uses, bool compress, bool read_only)
+{
+    mCompress = compress;
+    LLDecodedDiskCache::initCache(dir_name, max_size, min_uses, read_only);
+}
+
+// Called from the fetch threads
+LLPointer<LLImageRaw> LLTextureDecodedCache::read(const LLUUID& id, S32& discard)
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+    Key key{ id, discard, 0 };
+    if (getStoredSize(key) <= 0)
+    {
+        return NULL;
+    }
+
+    std::string filename = getFileName(key);
+    LLPointer<LLImageRaw> raw;
+    FileHeader header;
+    if (LLAPRFile::readEx(filename, &header, 0, sizeof(header)) == (S32)sizeof(header) &&
+        header.mMagic == FILE_MAGIC && header.mVersion == FILE_VERSION && header.mID == id &&
+        header.mWidth > 0 && header.mWidth <= MAX_IMAGE_SIZE &&
+        header.mHeight > 0 && header.mHeight <= MAX_IMAGE_SIZE &&
+        header.mComponents >= 1 && header.mComponents <= 4 && header.mCodec <= CODEC_BC3)
+    {
+        S32 width = header.mWidth;
+        S32 height = header.mHeight;
+        S32 components = header.mComponents;
+        S32 bytes = payload_size(header.mCodec, width, height, components);
+        raw = new LLImageRaw(width, height, components);
+        if (raw->isBufferInvalid())
+        {
+            raw = NULL;
+        }
+        else if (header.mCodec == CODEC_RAW)
+        {
+            if (LLAPRFile::readEx(filename, raw->getData(), sizeof(header), bytes) != bytes)
+            {
+                raw = NULL;
+            }
+        }
+        else
+        {
+            std::vector<U8> compressed(bytes);
+            if (LLAPRFile::readEx(filename, compressed.data(), sizeof(header), bytes) == bytes)
+            {
+                LLImageBC::EFormat format = header.mCodec == CODEC_BC1 ? LLImageBC::FORMAT_BC1 : LLImageBC::FORMAT_BC3;
+                std::vector<U8> rgba(width * height * 4);
+                LLImageBC::decompress(format, compressed.data(), width, height, rgba.data());
+                U8* dst = raw->getData();
+                for (S32 i = 0; i < width * height; ++i)
+                {
+                    memcpy(dst + i * components, &rgba[i * 4], components);
+                }
+            }
+            else
+            {
+                raw = NULL;
+            }
+        }
+    }
+
+    if (!finishRead(key, raw.notNull()))
+    {
+        return NULL;
+    }
+    discard = header.mDiscard;
+    return raw;
+}
+
+// Called from the fetch threads
+void LLTextureDecodedCache::decoded(const LLUUID& id, S32 discard, S32 decoded_discard, const LLImageRaw* raw)
+{
+    if (!raw || raw->isBufferInvalid())
+    {
+        return;
+    }
+    Key key{ id, discard, 0 };
+    if (!countUse(key))
+    {
+        return;
+    }
+
+    // The fetcher keeps using its image, write a copy
+    LLPointer<LLImageRaw> copy = new LLImageRaw(raw->getData(), raw->getWidth(), raw->getHeight(), raw->getComponents());
+    if (copy->isBufferInvalid())
+    {
+        cancelWrite(key);
+        return;
+    }
+
+    bool compress = mCompress;
+    write(key, [id, decoded_discard, copy, compress](std::vector<U8>& file)
+        {
+            LL_PROFILE_ZONE_NAMED_CATEGORY_TEXTURE("decoded texture file");
+            S32 width = copy->getWidth();
+            S32 height = copy->getHeight();
+            S32 components = copy->getComponents();
+            U8 codec = CODEC_RAW;
+            if (compress && components >= 3)
+            {
+                codec = components == 3 ? CODEC_BC1 : CODEC_BC3;
+            }
+            S32 bytes = payload_size(codec, width, height, components);
+
+            file.resize(sizeof(FileHeader) + bytes);
+            FileHeader* header = (FileHeader*)file.data();
+            header->mMagic = FILE_MAGIC;
+            header->mVersion = FILE_VERSION;
+            header->mID = id;
+            header->mWidth = (U16)width;
+            header->mHeight = (U16)height;
+            header->mComponents = (U8)components;
+            header->mDiscard = (U8)decoded_discard;
+            header->mCodec = codec;
+            header->mPad = 0;
+            U8* payload = file.data() + sizeof(FileHeader);
+            if (codec == CODEC_RAW)
+            {
+                memcpy(payload, copy->getData(), bytes);
+            }
+            else
+            {
+                LLImageBC::compress(codec == CODEC_BC1 ? LLImageBC::FORMAT_BC1 : LLImageBC::FORMAT_BC3,
+                                    LLImageBC::QUALITY_FAST, copy->getData(), width, height, components, payload);
+            }
+            return true;
+        });
+}
@@ -0,0 +1,64 @@
+/**
+ * @file lltexturedecodedcache.h
+ * @brief Disk cache of decoded textures, keyed by id and discard level
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLTEXTUREDECODEDCACHE_H
+#define LL_LLTEXTUREDECODEDCACHE_H
+
+#include "lldecodeddiskcache.h"
+#include "llpointer.h"
+
+class LLImageRaw;
+
+// Second tier of the texture cache. LLTextureCache keeps the J2C stream of
+// every texture; this keeps the decoded pixels of the textures that get
+// decoded over and over, so that LLTextureFetch can skip the decode.
+//
+// A texture is only written once it has been decoded at the same discard
+// level TextureDecodedCacheMinUses times. Files are optionally stored as
+// BC1/BC3, which is a quarter to a sixth of the size but lossy.
+//
+// Lookups run on the fetch thread and are synchronous.
+class LLTextureDecodedCache : public LLDecodedDiskCache
+{
+public:
+    LLTextureDecodedCache();
+
+    // Called in the main thread. A max_size of 0 disables the cache.
+    void initCache(const std::string& dir_name, S64 max_size, U32 min_uses, bool compress, bool read_only);
+
+    // Returns the image decoded from id at discard, or NULL if it isn't
+    // cached. discard is set to the level the image actually has.
+    LLPointer<LLImageRaw> read(const LLUUID& id, S32& discard);
+    // Called after a decode of id at discard produced raw, which has
+    // decoded_discard. Counts the use and stores a copy of raw once the
+    // texture has been used enough.
+    void decoded(const LLUUID& id, S32 discard, S32 decoded_discard, const LLImageRaw* raw);
+
+private:
+    bool mCompress;
+};
+
+#endif // LL_LLTEXTUREDECODEDCACHE_H
@@ -42,6 +42,7 @@
 
 #include "llagent.h"
 #include "lltexturecache.h"
+#include "lltexturedecodedcache.h"
 #include "llviewercontrol.h"
 #include "llviewertexturelist.h"
 #include "llviewertexture.h"
@@ -65,6 +66,8 @@
 LLTrace::CountStatHandle<F64> LLTextureFetch::sCacheHit("texture_cache_hit");
 LLTrace::CountStatHandle<F64> LLTextureFetch::sCacheAttempt("texture_cache_attempt");
 LLTrace::EventStatHandle<LLUnit<F32, LLUnits::Percent> > LLTextureFetch::sCacheHitRate("texture_cache_hits");
+LLTrace::CountStatHandle<F64> LLTextureFetch::sDecodedCacheHit("texture_decoded_cache_hit");
+LLTrace::CountStatHandle<F64> LLTextureFetch::sDecodedCacheAttempt("texture_decoded_cache_attempt");
 
 LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sCacheReadLatency("texture_cache_read_latency");
 LLTrace::SampleStatHandle<F32Seconds> LLTextureFetch::sTexDecodeLatency("texture_decode_latency");
@@ -481,6 +484,9 @@ class LLTextureFetchWorker : public LLWorkerClass, public LLCore::HttpHandler
     // Threads:  Ttf
     bool writeToCacheComplete();
 
+    // Threads:  Ttf
+    bool canUseDecodedCache() const;
+
     // Threads:  Ttf
     void recordTextureStart(bool is_http);
 
@@ -549,6 +555,7 @@ class LLTextureFetchWorker : public LLWorkerClass, public LLCore::HttpHandler
     S32 mRequestedDiscard;
     S32 mLoadedDiscard;
     S32 mDecodedDiscard;
+    S32 mDecodeDiscard; // level asked of the decoder, the decoded cache key
     LLFrameTimer mRequestedDeltaTimer;
     LLFrameTimer mFetchDeltaTimer;
     LLTimer mCacheReadTimer;
@@ -562,6 +569,7 @@ class LLTextureFetchWorker : public LLWorkerClass, public LLCore::HttpHandler
     F32 mFetchTime;     // total time from req to finished fetch
     std::map<S32, F32> mStateTimersMap;
     F32 mSkippedStatesTime;
+    F32 mStateTimes[DONE + 1]; // total time in each state since INIT
     LLTextureCache::handle_t    mCacheReadHandle,
                                 mCacheWriteHandle;
     S32                         mRequestedSize,
@@ -573,6 +581,7 @@ class LLTextureFetchWorker : public LLWorkerClass, public LLCore::HttpHandler
     handle_t mDecodeHandle;
     BOOL mLoaded;
     BOOL mDecoded;
+    bool mDecodedFromCache;
     BOOL mWritten;
     BOOL mNeedsAux;
     BOOL mHaveAllData;
@@ -897,6 +906,7 @@ LLTextureFetchWorker::LLTextureFetchWorker(LLTextureFetch* fetcher,
       mRequestedDiscard(-1),
       mLoadedDiscard(-1),
       mDecodedDiscard(-1),
+      mDecodeDiscard(-1),
       mCacheReadTime(0.f),
       mCacheWriteTime(0.f),
       mDecodeTime(0.f),
@@ -913,6 +923,7 @@ LLTextureFetchWorker::LLTextureFetchWorker(LLTextureFetch* fetcher,
       mSentRequest(UNSENT),
       mDecodeHandle(0),
       mDecoded(FALSE),
+      mDecodedFromCache(false),
       mWritten(FALSE),
       mNeedsAux(FALSE),
       mHaveAllData(FALSE),
@@ -942,6 +953,7 @@ LLTextureFetchWorker::LLTextureFetchWorker(LLTextureFetch* fetcher,
       mRegionRetryAttempt(0)
 {
     mType = host.isOk() ? LLImageBase::TYPE_AVATAR_BAKE : LLImageBase::TYPE_NORMAL;
+    std::fill(std::begin(mStateTimes), std::end(mStateTimes), 0.f);
 //  LL_INFOS(LOG_TXT) << "Create: " << mID << " mHost:" << host << " Discard=" << discard << LL_ENDL;
     if (!mFetcher->mDebugPause)
     {
@@ -1146,10 +1158,12 @@ bool LLTextureFetchWorker::doWork(S32 param)
             mStateTimersMap[i] = 0;
         }
         mSkippedStatesTime = 0;
+        std::fill(std::begin(mStateTimes), std::end(mStateTimes), 0.f);
         mRawImage = NULL ;
         mRequestedDiscard = -1;
         mLoadedDiscard = -1;
         mDecodedDiscard = -1;
+        mDecodeDiscard = -1;
         mRequestedSize = 0;
         mRequestedOffset = 0;
         mFileSize = 0;
@@ -1321,7 +1335,16 @@ bool LLTextureFetchWorker::doWork(S32 param)
         if (mCanUseHTTP && mUrl.empty())//get http url.
         {
             LLViewerRegion* region = getRegion();
-            if (region)
+            if (!mFetcher->mAssetUrlOverride.empty())
+            {
+                // Test server, see LLTextureFetch::setAssetUrlOverride()
+                setUrl(mFetcher->mAssetUrlOverride + "/?texture_id=" + mID.asString());
+                mWriteToCacheState = CAN_WRITE;
+                mCanUseCapability = true;
+                mRegionRetryAttempt = 0;
+                mLastRegionId.setNull();
+            }
+            else if (region)
             {
                 std::string http_url = region->getViewerAssetUrl();
                 if (http_url.empty())
@@ -1579,7 +1602,7 @@ bool LLTextureFetchWorker::doWork(S32 param)
                     if (mCanUseHTTP && !mUrl.empty() && cur_size <= 0)
                     {
                         LLViewerRegion* region = getRegion();
-                        if (!region || mLastRegionId != region->getRegionID())
+                        if (mFetcher->mAssetUrlOverride.empty() && (!region || mLastRegionId != region->getRegionID()))
                         {
                             // cap failure? try on new region.
                             mUrl.clear();
@@ -1596,7 +1619,7 @@ bool LLTextureFetchWorker::doWork(S32 param)
                     if (mCanUseHTTP && !mUrl.empty() && cur_size <= 0)
                     {
                         LLViewerRegion* region = getRegion();
-                        if (!region || mLastRegionId != region->getRegionID())
+                        if (mFetcher->mAssetUrlOverride.empty() && (!region || mLastRegionId != region->getRegionID()))
                         {
                             // try on new region.
                             mUrl.clear();
@@ -1820,25 +1843,48 @@ bool LLTextureFetchWorker::doWork(S32 param)
         llassert_always(mFormattedImage.notNull());
         S32 discard = mHaveAllData ? 0 : mLoadedDiscard;
         mDecoded  = FALSE;
+        mDecodedFromCache = false;
+        mDecodeDiscard = discard;
         setState(DECODE_IMAGE_UPDATE);
+
+        if (canUseDecodedCache())
+        {
+            add(LLTextureFetch::sDecodedCacheAttempt, 1.0);
+            S32 decoded_discard = discard;
+            LLPointer<LLImageRaw> raw = mFetcher->mTextureCache->getDecodedCache()->read(mID, decoded_discard);
+            if (raw.notNull())
+            {
+                add(LLTextureFetch::sDecodedCacheHit, 1.0);
+                mRawImage = raw;
+                mDecodedDiscard = decoded_discard;
+                mDecodedFromCache = true;
+                mDecoded = TRUE;
 #ifdef SHOW_DEBUG
-        LL_DEBUGS(LOG_TXT) << mID << ": Decoding. Bytes: " << mFormattedImage->getDataSize() << " Discard: " << discard
-                           << " All Data: " << mHaveAllData << LL_ENDL;
+                LL_DEBUGS(LOG_TXT) << mID << ": Decoded cache hit. Discard: " << mDecodedDiscard << LL_ENDL;
 #endif
-        // In case worked manages to request decode, be shut down,
-        // then init and request decode again with first decode
-        // still in progress, assign a sufficiently unique id
-        mDecodeHandle = LLAppViewer::getImageDecodeThread()->decodeImage(mFormattedImage,
-                                                                       discard,
-                                                                       mNeedsAux,
-                                                                       new DecodeResponder(mFetcher, mID, this));
-        if (mDecodeHandle == 0)
-        {
-            // Abort, failed to put into queue.
-            // Happens if viewer is shutting down
-            setState(DONE);
-            LL_DEBUGS(LOG_TXT) << mID << " DECODE_IMAGE abort: failed to post for decoding" << LL_ENDL;
-            return true;
+            }
+        }
+        if (!mDecoded)
+        {
+#ifdef SHOW_DEBUG
+            LL_DEBUGS(LOG_TXT) << mID << ": Decoding. Bytes: " << mFormattedImage->getDataSize() << " Discard: " << discard
+                               << " All Data: " << mHaveAllData << LL_ENDL;
+#endif
+            // In case worked manages to request decode, be shut down,
+            // then init and request decode again with first decode
+            // still in progress, assign a sufficiently unique id
+            mDecodeHandle = LLAppViewer::getImageDecodeThread()->decodeImage(mFormattedImage,
+                                                                           discard,
+                                                                           mNeedsAux,
+                                                                           new DecodeResponder(mFetcher, mID, this));
+            if (mDecodeHandle == 0)
+            {
+                // Abort, failed to put into queue.
+                // Happens if viewer is shutting down
+                setState(DONE);
+                LL_DEBUGS(LOG_TXT) << mID << " DECODE_IMAGE abort: failed to post for decoding" << LL_ENDL;
+                return true;
+            }
         }
         // fall though
     }
@@ -1880,6 +1926,10 @@ bool LLTextureFetchWorker::doWork(S32 param)
                 LL_DEBUGS(LOG_TXT) << mID << ": Decoded. Discard: " << mDecodedDiscard
                                    << " Raw Image: " << llformat("%dx%d",mRawImage->getWidth(),mRawImage->getHeight()) << LL_ENDL;
 #endif
+                if (!mDecodedFromCache && canUseDecodedCache())
+                {
+                    mFetcher->mTextureCache->getDecodedCache()->decoded(mID, mDecodeDiscard, mDecodedDiscard, mRawImage);
+                }
                 setState(WRITE_TO_CACHE);
             }
             // fall through
@@ -2404,6 +2454,17 @@ void LLTextureFetchWorker::callbackDecoded(bool success, const std::string &erro
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Threads:  Ttf
+bool LLTextureFetchWorker::canUseDecodedCache() const
+{
+    // Assets never change under the same id. Map tiles and local files can,
+    // and aux data (the alpha mask for bakes) isn't kept.
+    return !mNeedsAux
+        && (mFTType == FTT_DEFAULT || mFTType == FTT_SERVER_BAKE)
+        && mUrl.compare(0, 7, "file://") != 0
+        && mFetcher->mTextureCache->getDecodedCache()->isEnabled();
+}
+
 // Threads:  Ttf
 bool LLTextureFetchWorker::writeToCacheComplete()
 {
@@ -3166,6 +3227,7 @@ void LLTextureFetchWorker::setState(e_state new_state)
     }
 
     F32 d_time = mStateTimer.getElapsedTimeF32();
+    mStateTimes[mState] += d_time;
     if (d_time >= 0.0001F)
     {
         if (LOGGED_STATES.count(mState))
@@ -3272,6 +3334,20 @@ S32 LLTextureFetch::getFetchState(const LLUUID& id, F32& data_progress_p, F32& r
     return state;
 }
 
+bool LLTextureFetch::getStateTimes(const LLUUID& id, std::vector<F32>& state_times, S32& file_size)
+{
+    LLTextureFetchWorker* worker = getWorker(id);
+    if (!worker)
+    {
+        return false;
+    }
+    worker->lockWorkMutex();                                            // +Mw
+    state_times.assign(std::begin(worker->mStateTimes), std::end(worker->mStateTimes));
+    file_size = worker->mFileSize;
+    worker->unlockWorkMutex();                                          // -Mw
+    return true;
+}
+
 void LLTextureFetch::dump()
 {
     LL_INFOS(LOG_TXT) << "LLTextureFetch ACTIVE_HTTP:" << LL_ENDL;
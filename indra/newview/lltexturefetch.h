@@ -120,6 +120,18 @@ class LLTextureFetch final : public LLWorkerThread
     S32 getFetchState(const LLUUID& id, F32& decode_progress_p, F32& requested_priority_p,
                       U32& fetch_priority_p, F32& fetch_dtime_p, F32& request_dtime_p, bool& can_use_http);
 
+    // Seconds the request for id has spent in each worker state since it
+    // was last (re)started, indexed by state, and the size of the
+    // formatted image. Returns false if there is no such request.
+    // Threads:  T*
+    bool getStateTimes(const LLUUID& id, std::vector<F32>& state_times, S32& file_size);
+
+    // Fetch textures from url + "/?texture_id=<id>" instead of the agent
+    // region's ViewerAsset capability, for testing against a local server.
+    // An empty url restores the capability.
+    // Threads:  Tmain, before any request that should use it
+    void setAssetUrlOverride(const std::string& url) { mAssetUrlOverride = url; }
+
     // Debug utility - generally not safe
     void dump();
 
@@ -298,6 +310,8 @@ class LLTextureFetch final : public LLWorkerThread
 
     static LLTrace::CountStatHandle<F64>        sCacheHit;
     static LLTrace::CountStatHandle<F64>        sCacheAttempt;
+    static LLTrace::CountStatHandle<F64>        sDecodedCacheHit;
+    static LLTrace::CountStatHandle<F64>        sDecodedCacheAttempt;
     static LLTrace::SampleStatHandle<F32Seconds> sCacheReadLatency;
     static LLTrace::SampleStatHandle<F32Seconds> sTexDecodeLatency;
     static LLTrace::SampleStatHandle<F32Seconds> sCacheWriteLatency;
@@ -343,6 +357,9 @@ class LLTextureFetch final : public LLWorkerThread
     // If true, modifies some behaviors that help with QA tasks.
     const bool mQAMode;
 
+    // See setAssetUrlOverride()
+    std::string mAssetUrlOverride;
+
     // Interfaces and objects into the core http library used
     // to make our HTTP requests.  These replace the various
     // LLCurl interfaces used in the past.
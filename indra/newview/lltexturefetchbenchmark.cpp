@@ -0,0 +1,256 @@
+/**
+ * @file lltexturefetchbenchmark.cpp
+ * @brief Replays a texture request trace through LLTextureFetch and reports
+ *        throughput, latency and time spent per fetch state
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "lltexturefetchbenchmark.h"
+
+#include "llappviewer.h"
+#include "llimage.h"
+#include "llsdserialize.h"
+#include "lltexturefetch.h"
+#include "llviewercontrol.h"
+
+#include <algorithm>
+
+// A request that hasn't finished after this long is cancelled and counted
+// as timed out
+static const F64 REQUEST_TIMEOUT = 60.0;
+static const F32 DEFAULT_PRIORITY = 1000000.f;
+
+static LLViewerBenchmark::Registrar<LLTextureFetchBenchmark> sTextureFetchBenchmark;
+
+LLTextureFetchBenchmark::LLTextureFetchBenchmark()
+    : LLViewerBenchmark("texture_fetch", "TextureFetchBenchmarkQuit"),
+      mNextEntry(0),
+      mStarted(false),
+      mIssued(0),
+      mCompleted(0),
+      mFailed(0),
+      mTimedOut(0),
+      mDecodedBytes(0),
+      mFileBytes(0)
+{
+}
+
+bool LLTextureFetchBenchmark::start()
+{
+    const std::string trace_file = gSavedSettings.getString("TextureFetchBenchmarkTrace");
+    if (trace_file.empty())
+    {
+        return false;
+    }
+    const std::string url = gSavedSettings.getString("TextureFetchBenchmarkURL");
+
+    llifstream file(trace_file.c_str(), std::ios::in | std::ios::binary);
+    LLSD trace;
+    if (!file.is_open() || !LLSDSerialize::deserialize(trace, file, LLSDSerialize::SIZE_UNLIMITED) || !trace.isArray())
+    {
+        LL_WARNS() << "Unable to read texture fetch trace " << trace_file << LL_ENDL;
+        return false;
+    }
+
+    mTrace.clear();
+    for (LLSD::array_const_iterator iter = trace.beginArray(); iter != trace.endArray(); ++iter)
+    {
+        const LLSD& entry = *iter;
+        TraceEntry request;
+        request.mTime = entry["time"].asReal();
+        request.mID = entry["id"].asUUID();
+        request.mDiscard = entry.has("discard") ? entry["discard"].asInteger() : 0;
+        request.mPriority = entry.has("priority") ? (F32)entry["priority"].asReal() : DEFAULT_PRIORITY;
+        request.mWidth = entry["width"].asInteger();
+        request.mHeight = entry["height"].asInteger();
+        request.mComponents = entry["components"].asInteger();
+        if (request.mID.isNull())
+        {
+            LL_WARNS() << "Skipping trace entry without an id" << LL_ENDL;
+            continue;
+        }
+        mTrace.push_back(request);
+    }
+    std::stable_sort(mTrace.begin(), mTrace.end(),
+                     [](const TraceEntry& a, const TraceEntry& b) { return a.mTime < b.mTime; });
+
+    LLAppViewer::getTextureFetch()->setAssetUrlOverride(url);
+    mStateTimes.clear();
+    mNextEntry = 0;
+    mStarted = false;
+    LL_INFOS() << "Replaying " << mTrace.size() << " texture requests from " << trace_file
+               << " against " << url << LL_ENDL;
+    return true;
+}
+
+void LLTextureFetchBenchmark::idle()
+{
+    if (!mStarted)
+    {
+        // Start the clock on the first frame rather than in start(), which
+        // runs before the window is up
+        mTimer.reset();
+        mStarted = true;
+    }
+
+    LLTextureFetch* fetcher = LLAppViewer::getTextureFetch();
+    F64 now = mTimer.getElapsedTimeF64();
+
+    while (mNextEntry < mTrace.size() && mTrace[mNextEntry].mTime <= now)
+    {
+        const TraceEntry& entry = mTrace[mNextEntry++];
+        S32 result = fetcher->createRequest(FTT_DEFAULT, LLStringUtil::null, entry.mID, LLHost(), entry.mPriority,
+                                            entry.mWidth, entry.mHeight, entry.mComponents, entry.mDiscard,
+                                            false, true);
+        if (result < 0)
+        {
+            ++mIssued;
+            ++mFailed;
+            continue;
+        }
+        if (mActive.find(entry.mID) == mActive.end())
+        {
+            // A repeat of an id still in flight only updates that request
+            ++mIssued;
+            mActive[entry.mID] = { now, entry.mDiscard };
+        }
+    }
+
+    std::vector<F32> state_times;
+    for (std::map<LLUUID, Request>::iterator iter = mActive.begin(); iter != mActive.end(); )
+    {
+        const LLUUID& id = iter->first;
+        S32 discard = -1;
+        LLPointer<LLImageRaw> raw;
+        LLPointer<LLImageRaw> aux;
+        LLCore::HttpStatus status;
+        if (fetcher->getRequestFinished(id, discard, raw, aux, status))
+        {
+            S32 file_size = 0;
+            if (fetcher->getStateTimes(id, state_times, file_size))
+            {
+                mStateTimes.resize(llmax(mStateTimes.size(), state_times.size()), 0.0);
+                for (size_t i = 0; i < state_times.size(); ++i)
+                {
+                    mStateTimes[i] += state_times[i];
+                }
+            }
+            if (raw.notNull() && discard >= 0)
+            {
+                ++mCompleted;
+                mLatencies.push_back((F32)(now - iter->second.mStart));
+                mDecodedBytes += raw->getDataSize();
+                mFileBytes += file_size;
+            }
+            else
+            {
+                LL_WARNS() << "Fetch failed for " << id << " status " << status.toTerseString() << LL_ENDL;
+                ++mFailed;
+            }
+            fetcher->deleteRequest(id, false);
+            iter = mActive.erase(iter);
+        }
+        else if (now - iter->second.mStart > REQUEST_TIMEOUT)
+        {
+            LL_WARNS() << "Fetch timed out for " << id << LL_ENDL;
+            ++mTimedOut;
+            fetcher->deleteRequest(id, true);
+            iter = mActive.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    if (mNextEntry >= mTrace.size() && mActive.empty())
+    {
+        fetcher->setAssetUrlOverride(LLStringUtil::null);
+        report();
+        finish();
+    }
+}
+
+void LLTextureFetchBenchmark::report()
+{
+    F64 elapsed = llmax(mTimer.getElapsedTimeF64(), 0.001);
+
+    LLSD sd;
+    sd["requests"] = (LLSD::Integer)mIssued;
+    sd["completed"] = (LLSD::Integer)mCompleted;
+    sd["failed"] = (LLSD::Integer)mFailed;
+    sd["timed_out"] = (LLSD::Integer)mTimedOut;
+    sd["elapsed"] = elapsed;
+    sd["textures_per_second"] = mCompleted / elapsed;
+    sd["file_bytes"] = (LLSD::Real)mFileBytes;
+    sd["decoded_bytes"] = (LLSD::Real)mDecodedBytes;
+    sd["file_bytes_per_second"] = mFileBytes / elapsed;
+
+    if (!mLatencies.empty())
+    {
+        std::sort(mLatencies.begin(), mLatencies.end());
+        const F32 percentiles[] = { 0.5f, 0.9f, 0.95f, 0.99f };
+        const char* names[] = { "p50", "p90", "p95", "p99" };
+        LLSD& latency = sd["latency"];
+        latency["min"] = mLatencies.front();
+        for (size_t i = 0; i < LL_ARRAY_SIZE(percentiles); ++i)
+        {
+            size_t index = llmin(mLatencies.size() - 1, (size_t)(percentiles[i] * mLatencies.size()));
+            latency[names[i]] = mLatencies[index];
+        }
+        latency["max"] = mLatencies.back();
+    }
+
+    // Total and mean seconds per finished request in each state. Waiting
+    // states show where requests queue, the others where the work goes.
+    U32 finished = llmax(mCompleted + mFailed, 1U);
+    LLSD& states = sd["states"];
+    for (size_t i = 0; i < mStateTimes.size(); ++i)
+    {
+        if (mStateTimes[i] > 0.0)
+        {
+            LLSD& state = states[LLTextureFetch::getStateString((S32)i)];
+            state["total"] = mStateTimes[i];
+            state["mean"] = mStateTimes[i] / finished;
+        }
+    }
+
+    LL_INFOS() << llformat("%u of %u textures in %.2fs, %.1f/s, %.2f MB/s. %u failed, %u timed out.",
+                           mCompleted, mIssued, elapsed, mCompleted / elapsed, mFileBytes / elapsed / (1024.0 * 1024.0),
+                           mFailed, mTimedOut) << LL_ENDL;
+    if (sd.has("latency"))
+    {
+        const LLSD& latency = sd["latency"];
+        LL_INFOS() << llformat("Latency p50 %.3fs p90 %.3fs p99 %.3fs max %.3fs",
+                               latency["p50"].asReal(), latency["p90"].asReal(),
+                               latency["p99"].asReal(), latency["max"].asReal()) << LL_ENDL;
+    }
+    for (LLSD::map_const_iterator iter = states.beginMap(); iter != states.endMap(); ++iter)
+    {
+        LL_INFOS() << llformat("%-24s %9.3fs total %8.4fs mean", iter->first.c_str(),
+                               iter->second["total"].asReal(), iter->second["mean"].asReal()) << LL_ENDL;
+    }
+    writeReport(sd);
+}
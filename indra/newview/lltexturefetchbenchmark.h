@@ -0,0 +1,108 @@
+/**
+ * @file lltexturefetchbenchmark.h
+ * @brief Replays a texture request trace through LLTextureFetch and reports
+ *        throughput, latency and time spent per fetch state
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLTEXTUREFETCHBENCHMARK_H
+#define LL_LLTEXTUREFETCHBENCHMARK_H
+
+#include "lltimer.h"
+#include "lluuid.h"
+#include "llviewerbenchmark.h"
+
+#include <map>
+#include <vector>
+
+// Drives LLTextureFetch, and through it LLTextureCache and the image decode
+// thread, from a scripted trace instead of the scene, without logging in.
+// Textures come from a local HTTP server standing in for the ViewerAsset
+// capability, see scripts/perf/texture_fetch_server.py.
+//
+// Started with --texturefetchbenchmark <trace>, best together with
+// HeadlessClient. The trace is an LLSD array of maps:
+//   time       seconds after the start to issue the request
+//   id         texture id, the server looks up <id>.j2c
+//   discard    desired discard level, default 0
+//   priority   fetch priority, default 1000000
+//   width, height, components   optional, as LLViewerFetchedTexture passes
+// Requesting an id again after its earlier request finished goes through
+// the cache, so a trace that repeats itself measures warm cache fetches.
+//
+// The report is logged and written to texture_fetch_benchmark.xml in the
+// log directory.
+class LLTextureFetchBenchmark final : public LLViewerBenchmark
+{
+    LOG_CLASS(LLTextureFetchBenchmark);
+
+public:
+    LLTextureFetchBenchmark();
+
+protected:
+    // Loads the trace and points the fetcher at TextureFetchBenchmarkURL.
+    // Returns false if the trace can't be read.
+    bool start() override;
+
+    // Issues due requests and collects finished ones
+    void idle() override;
+
+private:
+    struct TraceEntry
+    {
+        F64 mTime;
+        LLUUID mID;
+        S32 mDiscard;
+        F32 mPriority;
+        S32 mWidth;
+        S32 mHeight;
+        S32 mComponents;
+    };
+
+    struct Request
+    {
+        F64 mStart;
+        S32 mDiscard;
+    };
+
+    void report();
+
+private:
+    std::vector<TraceEntry> mTrace;
+    size_t mNextEntry;
+    std::map<LLUUID, Request> mActive;
+    LLTimer mTimer;
+    bool mStarted;
+
+    // results
+    U32 mIssued;
+    U32 mCompleted;
+    U32 mFailed;
+    U32 mTimedOut;
+    S64 mDecodedBytes;
+    S64 mFileBytes;
+    std::vector<F32> mLatencies;
+    std::vector<F64> mStateTimes;
+};
+
+#endif // LL_LLTEXTUREFETCHBENCHMARK_H
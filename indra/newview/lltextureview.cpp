@@ -34,6 +34,7 @@
 #include "llerror.h"
 #include "lllfsthread.h"
 #include "llui.h"
+#include "llimagebufferpool.h"
 #include "llimageworker.h"
 #include "llrender.h"
 
@@ -515,6 +516,11 @@ void LLGLTexMemBar::draw()
 
     F32 cacheHitRate = (cacheAttempts > 0.0) ? F32((cacheHits / cacheAttempts) * 100.0f) : 0.0f;
 
+    F64 decodedHits     = recording.getSampleCount(LLTextureFetch::sDecodedCacheHit);
+    F64 decodedAttempts = recording.getSampleCount(LLTextureFetch::sDecodedCacheAttempt);
+
+    F32 decodedHitRate = (decodedAttempts > 0.0) ? F32((decodedHits / decodedAttempts) * 100.0f) : 0.0f;
+
     U32 cacheReadLatMin = U32(recording.getMin(LLTextureFetch::sCacheReadLatency).value() * 1000.0f);
     U32 cacheReadLatMed = U32(recording.getMean(LLTextureFetch::sCacheReadLatency).value() * 1000.0f);
     U32 cacheReadLatMax = U32(recording.getMax(LLTextureFetch::sCacheReadLatency).value() * 1000.0f);
@@ -527,13 +533,18 @@ void LLGLTexMemBar::draw()
     U32 texFetchLatMed = U32(recording.getMean(LLTextureFetch::sTexFetchLatency).value() * 1000.0f);
     U32 texFetchLatMax = U32(recording.getMax(LLTextureFetch::sTexFetchLatency).value() * 1000.0f);
 
-    text = llformat("GL Free: %d MB Sys Free: %d MB FBO: %d MB Bias: %.2f Cache: %.1f/%.1f MB",
+    LLImageBufferPool::Stats image_pool = LLImageBufferPool::getStats();
+    U64 image_pool_requests = image_pool.mHits + image_pool.mMisses;
+    text = llformat("GL Free: %d MB Sys Free: %d MB FBO: %d MB Bias: %.2f Cache: %.1f/%.1f MB ImgPool: %.1f MB %.0f%% Rel: %.0f MB",
                     gViewerWindow->getWindow()->getAvailableVRAMMegabytes(),
                     LLMemory::getAvailableMemKB()/1024,
                     LLRenderTarget::sBytesAllocated/(1024*1024),
                     discard_bias,
                     cache_usage,
-                    cache_max_usage);
+                    cache_max_usage,
+                    image_pool.mCachedBytes / (1024.f * 1024.f),
+                    image_pool_requests ? image_pool.mHits * 100.f / image_pool_requests : 0.f,
+                    image_pool.mReleasedBytes / (1024.f * 1024.f));
     //, cache_entries, cache_max_entries
 
     LLFontGL::getFontMonospace()->renderUTF8(text, 0, 0, v_offset + line_height*6,
@@ -555,8 +566,9 @@ void LLGLTexMemBar::draw()
     LLFontGL::getFontMonospace()->renderUTF8(text, 0, 0, v_offset + line_height*5,
                                              text_color, LLFontGL::LEFT, LLFontGL::TOP);
 
-    text = llformat("CacheHitRate: %3.2f Read: %d/%d/%d Decode: %d/%d/%d Fetch: %d/%d/%d",
+    text = llformat("CacheHitRate: %3.2f DecodedHitRate: %3.2f Read: %d/%d/%d Decode: %d/%d/%d Fetch: %d/%d/%d",
                     cacheHitRate,
+                    decodedHitRate,
                     cacheReadLatMin,
                     cacheReadLatMed,
                     cacheReadLatMax,
@@ -0,0 +1,132 @@
+/**
+ * @file llviewerbenchmark.cpp
+ * @brief Base of the benchmarks started from the command line
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llviewerbenchmark.h"
+
+#include "llappviewer.h"
+#include "lldir.h"
+#include "llsdserialize.h"
+#include "llviewercontrol.h"
+
+std::vector<LLViewerBenchmark*> LLViewerBenchmark::sBenchmarks;
+
+LLViewerBenchmark::LLViewerBenchmark(const char* name, const char* quit_setting)
+    : mName(name),
+      mQuitSetting(quit_setting),
+      mFinished(false)
+{
+}
+
+LLViewerBenchmark::~LLViewerBenchmark()
+{
+}
+
+// Registrars run during static initialization, in no particular order
+//static
+std::vector<LLViewerBenchmark::factory_t>& LLViewerBenchmark::getFactories()
+{
+    static std::vector<factory_t> factories;
+    return factories;
+}
+
+//static
+void LLViewerBenchmark::addFactory(const factory_t& factory)
+{
+    getFactories().push_back(factory);
+}
+
+//static
+void LLViewerBenchmark::initClass()
+{
+    for (const factory_t& factory : getFactories())
+    {
+        LLViewerBenchmark* benchmark = factory();
+        if (benchmark->start())
+        {
+            sBenchmarks.push_back(benchmark);
+        }
+        else
+        {
+            delete benchmark;
+        }
+    }
+}
+
+//static
+void LLViewerBenchmark::updateClass()
+{
+    for (std::vector<LLViewerBenchmark*>::iterator iter = sBenchmarks.begin(); iter != sBenchmarks.end(); )
+    {
+        LLViewerBenchmark* benchmark = *iter;
+        benchmark->idle();
+        if (benchmark->mFinished)
+        {
+            delete benchmark;
+            iter = sBenchmarks.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
+//static
+void LLViewerBenchmark::cleanupClass()
+{
+    for (LLViewerBenchmark* benchmark : sBenchmarks)
+    {
+        delete benchmark;
+    }
+    sBenchmarks.clear();
+}
+
+void LLViewerBenchmark::writeReport(const LLSD& sd) const
+{
+    std::string filename = gDirUtilp->getExpandedFilename(LL_PATH_LOGS, llformat("%s_benchmark.xml", mName));
+    llofstream file(filename.c_str());
+    if (file.is_open())
+    {
+        LLSDSerialize::toPrettyXML(sd, file);
+        LL_INFOS() << "Report written to " << filename << LL_ENDL;
+    }
+    else
+    {
+        LL_WARNS() << "Unable to write report " << filename << LL_ENDL;
+    }
+}
+
+void LLViewerBenchmark::finish()
+{
+    mFinished = true;
+
+    if (gSavedSettings.getBOOL(mQuitSetting))
+    {
+        LLAppViewer::instance()->forceQuit();
+    }
+}
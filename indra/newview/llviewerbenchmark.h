@@ -0,0 +1,97 @@
+/**
+ * @file llviewerbenchmark.h
+ * @brief Base of the benchmarks started from the command line
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLVIEWERBENCHMARK_H
+#define LL_LLVIEWERBENCHMARK_H
+
+#include <functional>
+#include <vector>
+
+class LLSD;
+
+// A benchmark reads its own settings in start(), which the command line
+// switches map to, does its work from idle() and calls finish() when done.
+// The base writes the report to <name>_benchmark.xml in the log directory
+// and quits the viewer after finish() when the quit setting is on.
+//
+// Benchmarks register with a file scope Registrar in their .cpp, the
+// viewer only calls initClass(), updateClass() and cleanupClass().
+class LLViewerBenchmark
+{
+    LOG_CLASS(LLViewerBenchmark);
+
+public:
+    virtual ~LLViewerBenchmark();
+
+    // Creates every registered benchmark and keeps the ones that start.
+    // Called once at startup, after the caches are up.
+    static void initClass();
+    // Steps the running benchmarks and deletes the finished ones. Called
+    // every frame from the main loop.
+    static void updateClass();
+    // Deletes the benchmarks still running on quit
+    static void cleanupClass();
+
+    template <class T>
+    class Registrar
+    {
+    public:
+        Registrar()
+        {
+            addFactory([]() -> LLViewerBenchmark* { return new T(); });
+        }
+    };
+
+protected:
+    // name makes the report file name, quit_setting is the Boolean setting
+    // that quits the viewer once the benchmark finishes
+    LLViewerBenchmark(const char* name, const char* quit_setting);
+
+    // Reads the settings. Returns false when the benchmark wasn't asked
+    // for or can't run.
+    virtual bool start() = 0;
+    // Called every frame until finish()
+    virtual void idle() = 0;
+
+    // Writes sd as the report and logs where it went
+    void writeReport(const LLSD& sd) const;
+    // Stops the idle() calls and quits the viewer if asked to
+    void finish();
+
+private:
+    typedef std::function<LLViewerBenchmark*()> factory_t;
+    static void addFactory(const factory_t& factory);
+    static std::vector<factory_t>& getFactories();
+
+private:
+    const char* mName;
+    const char* mQuitSetting;
+    bool mFinished;
+
+    static std::vector<LLViewerBenchmark*> sBenchmarks;
+};
+
+#endif // LL_LLVIEWERBENCHMARK_H
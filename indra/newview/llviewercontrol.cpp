@@ -300,6 +300,12 @@ static bool handleVolumeLODChanged(const LLSD& newvalue)
     return true;
 }
 
+static bool handleRaycastUseBVHChanged(const LLSD& newvalue)
+{
+    LLVolume::sUseBVH = newvalue.asBoolean();
+    return true;
+}
+
 static bool handleAvatarLODChanged(const LLSD& newvalue)
 {
     LLVOAvatar::sLODFactor = llclamp((F32) newvalue.asReal(), 0.f, MAX_AVATAR_LOD_FACTOR);
@@ -436,6 +442,12 @@ static bool handleRepartition(const LLSD&)
     return true;
 }
 
+static bool handleOctreeLinearCullingChanged(const LLSD& newvalue)
+{
+    LLViewerOctreePartition::sUseLinearOctree = newvalue.asBoolean();
+    return true;
+}
+
 static bool handleRenderDynamicLODChanged(const LLSD& newvalue)
 {
     LLPipeline::sDynamicLOD = newvalue.asBoolean();
@@ -789,6 +801,7 @@ void settings_setup_listeners()
     setting_setup_signal_listener(gSavedSettings, "OctreeStaticObjectSizeFactor", handleRepartition);
     setting_setup_signal_listener(gSavedSettings, "OctreeDistanceFactor", handleRepartition);
     setting_setup_signal_listener(gSavedSettings, "OctreeMaxNodeCapacity", handleRepartition);
+    setting_setup_signal_listener(gSavedSettings, "OctreeLinearCulling", handleOctreeLinearCullingChanged);
     setting_setup_signal_listener(gSavedSettings, "OctreeAlphaDistanceFactor", handleRepartition);
     setting_setup_signal_listener(gSavedSettings, "OctreeAttachmentSizeFactor", handleRepartition);
     setting_setup_signal_listener(gSavedSettings, "RenderMaxTextureIndex", handleSetShaderChanged);
@@ -812,6 +825,7 @@ void settings_setup_listeners()
     setting_setup_signal_listener(gSavedSettings, "RenderTerrainLODFactor", handleTerrainLODChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderTreeLODFactor", handleTreeLODChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderFlexTimeFactor", handleFlexLODChanged);
+    setting_setup_signal_listener(gSavedSettings, "RaycastUseBVH", handleRaycastUseBVHChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderGamma", handleGammaChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderFogRatio", handleFogRatioChanged);
     setting_setup_signal_listener(gSavedSettings, "RenderMaxPartCount", handleMaxPartCountChanged);
@@ -83,6 +83,7 @@
 #include "llfloaterperms.h"
 #include "llvocache.h"
 #include "llcorehttputil.h"
+#include "llcoproceduremanager.h"
 #include "llstartup.h"
 
 #include <algorithm>
@@ -93,6 +94,13 @@ extern BOOL gAnimateTextures;
 
 #define MAX_CONCURRENT_PHYSICS_REQUESTS 256
 
+// Object cost and physics flag lookups are coalesced into batched
+// POSTs in their own coprocedure pool.
+static const std::string OBJECT_DATA_POOL("ObjectData");
+static const std::string OBJECT_COST_BATCH("ObjectCost");
+static const std::string PHYSICS_FLAGS_BATCH("PhysicsFlags");
+static const F32 OBJECT_DATA_BATCH_WINDOW = 0.1f;
+
 void dialog_refresh_all();
 
 // Global lists of objects - should go away soon.
@@ -1100,13 +1108,24 @@ void LLViewerObjectList::update(LLAgent &agent)
     sample(LLStatViewer::NUM_ACTIVE_OBJECTS, idle_count);
 }
 
+// static
+void LLViewerObjectList::initFetchPool()
+{
+    LLCoprocedureManager &mgr(LLCoprocedureManager::instance());
+    mgr.initializePool(OBJECT_DATA_POOL);
+    mgr.registerBatch(OBJECT_DATA_POOL, OBJECT_COST_BATCH,
+        boost::bind(&LLViewerObjectList::postObjectIdsBatch, "cost", _1, _2, _3),
+        MAX_CONCURRENT_PHYSICS_REQUESTS, OBJECT_DATA_BATCH_WINDOW);
+    mgr.registerBatch(OBJECT_DATA_POOL, PHYSICS_FLAGS_BATCH,
+        boost::bind(&LLViewerObjectList::postObjectIdsBatch, "physics flags", _1, _2, _3),
+        MAX_CONCURRENT_PHYSICS_REQUESTS, OBJECT_DATA_BATCH_WINDOW);
+}
+
 void LLViewerObjectList::fetchObjectCosts()
 {
-    // issue http request for stale object physics costs
+    // queue stale object physics costs for the next batched request
     if (!mStaleObjectCost.empty())
     {
-        boost::unordered_map<LLViewerRegion*, uuid_hash_set_t> regionObjectMap{};
-
         // Swap it for thread safety since we're going to iterate over it
         uuid_hash_set_t staleObjectCostIds{};
         staleObjectCostIds.swap(mStaleObjectCost);
@@ -1114,77 +1133,60 @@ void LLViewerObjectList::fetchObjectCosts()
         for (const auto& staleObjectId : staleObjectCostIds)
         {
             LLViewerObject* staleObject = findObject(staleObjectId);
-            if (staleObject && staleObject->getRegion())
+            if (!staleObject || !staleObject->getRegion() || mPendingObjectCost.count(staleObjectId))
             {
-                if (regionObjectMap.find(staleObject->getRegion()) == regionObjectMap.end())
-                {
-                    regionObjectMap.insert(std::make_pair(staleObject->getRegion(), uuid_hash_set_t()));
-                }
-
-                regionObjectMap[staleObject->getRegion()].insert(staleObjectId);
+                continue;
             }
-        }
 
-        for (const auto& region : regionObjectMap)
-        {
+            LLViewerRegion* regionp = staleObject->getRegion();
             std::string url;
-            if(region.first->capabilitiesReceived())
-                url = region.first->getCapability("GetObjectCost");
+            if (regionp->capabilitiesReceived())
+                url = regionp->getCapability("GetObjectCost");
 
-            if (!url.empty())
+            if (url.empty())
             {
-                LLCoros::instance().launch("LLViewerObjectList::fetchObjectCostsCoro",
-                    boost::bind(&LLViewerObjectList::fetchObjectCostsCoro, this, url, region.second));
+                continue;
             }
-            else
+
+            mPendingObjectCost.insert(staleObjectId);
+            LLUUID objectId = staleObjectId;
+            if (!LLCoprocedureManager::instance().enqueueBatched(OBJECT_DATA_POOL, OBJECT_COST_BATCH, url, objectId,
+                    [objectId](const LLSD& objectData) { gObjectList.onObjectCostFetched(objectId, objectData); }))
             {
-                for (const auto& objectId : region.second)
-                {
-                    mPendingObjectCost.erase(objectId);
-                }
+                mPendingObjectCost.erase(objectId);
             }
         }
     }
 }
 
-/*static*/
-void LLViewerObjectList::reportObjectCostFailure(LLSD &objectList)
+void LLViewerObjectList::onObjectCostFetched(const LLUUID& objectId, const LLSD& objectData)
 {
-    // TODO*: No more hard coding
-    for (LLSD::array_iterator it = objectList.beginArray(); it != objectList.endArray(); ++it)
-    {
-        gObjectList.onObjectCostFetchFailure(it->asUUID());
-    }
-}
-
-
-void LLViewerObjectList::fetchObjectCostsCoro(std::string url, uuid_hash_set_t staleObjects)
-{
-    LLCore::HttpRequest::policy_t httpPolicy(LLCore::HttpRequest::DEFAULT_POLICY_ID);
-    LLCoreHttpUtil::HttpCoroutineAdapter::ptr_t
-        httpAdapter(std::make_shared<LLCoreHttpUtil::HttpCoroutineAdapter>("genericPostCoro", httpPolicy));
-    LLCore::HttpRequest::ptr_t httpRequest(std::make_shared<LLCore::HttpRequest>());
-
-    uuid_set_t diff;
-
-    std::set_difference(staleObjects.begin(), staleObjects.end(),
-        mPendingObjectCost.begin(), mPendingObjectCost.end(),
-        std::inserter(diff, diff.begin()));
+    // Object could have been added to the mStaleObjectCost after request started
+    mStaleObjectCost.erase(objectId);
+    mPendingObjectCost.erase(objectId);
 
-    if (diff.empty())
+    // Check to see if the request contains data for the object
+    if (objectData.isMap())
     {
-        //LL_INFOS() << "No outstanding object IDs to request. Pending count: " << mPendingObjectCost.size() << LL_ENDL;
-        return;
-    }
+        F32 linkCost = objectData["linked_set_resource_cost"].asReal();
+        F32 objectCost = objectData["resource_cost"].asReal();
+        F32 physicsCost = objectData["physics_cost"].asReal();
+        F32 linkPhysicsCost = objectData["linked_set_physics_cost"].asReal();
 
-    LLSD idList(LLSD::emptyArray());
-
-    for (uuid_set_t::iterator it = diff.begin(); it != diff.end(); ++it)
+        updateObjectCost(objectId, objectCost, linkCost, physicsCost, linkPhysicsCost);
+    }
+    else
     {
-        idList.append(*it);
+        // TODO*: Give user feedback about the missing data?
+        onObjectCostFetchFailure(objectId);
     }
+}
 
-    mPendingObjectCost.insert(diff.begin(), diff.end());
+// static
+LLSD LLViewerObjectList::postObjectIdsBatch(const char* what, LLCoreHttpUtil::HttpCoroutineAdapter::ptr_t& httpAdapter,
+                                            const std::string& url, const LLSD& idList)
+{
+    LLCore::HttpRequest::ptr_t httpRequest(std::make_shared<LLCore::HttpRequest>());
 
     LLSD postData = LLSD::emptyMap();
 
@@ -1200,52 +1202,24 @@ void LLViewerObjectList::fetchObjectCostsCoro(std::string url, uuid_hash_set_t s
         if (result.has("error"))
         {
             LL_WARNS() << "Application level error when fetching object "
-                << "cost.  Message: " << result["error"]["message"].asString()
+                << what << ".  Message: " << result["error"]["message"].asString()
                 << ", identifier: " << result["error"]["identifier"].asString()
                 << LL_ENDL;
 
             // TODO*: Adaptively adjust request size if the
             // service says we've requested too many and retry
         }
-        reportObjectCostFailure(idList);
-
-        return;
-    }
-
-    // Success, grab the resource cost and linked set costs
-    // for an object if one was returned
-    for (LLSD::array_iterator it = idList.beginArray(); it != idList.endArray(); ++it)
-    {
-        LLUUID objectId = it->asUUID();
-
-        // Object could have been added to the mStaleObjectCost after request started
-        mStaleObjectCost.erase(objectId);
-        mPendingObjectCost.erase(objectId);
-
-        // Check to see if the request contains data for the object
-        if (result.has(it->asString()))
-        {
-            LLSD objectData = result[it->asString()];
-
-            F32 linkCost = objectData["linked_set_resource_cost"].asReal();
-            F32 objectCost = objectData["resource_cost"].asReal();
-            F32 physicsCost = objectData["physics_cost"].asReal();
-            F32 linkPhysicsCost = objectData["linked_set_physics_cost"].asReal();
-
-            gObjectList.updateObjectCost(objectId, objectCost, linkCost, physicsCost, linkPhysicsCost);
-        }
-        else
-        {
-            // TODO*: Give user feedback about the missing data?
-            gObjectList.onObjectCostFetchFailure(objectId);
-        }
+        // Every object in the batch is reported as failed
+        return LLSD();
     }
 
+    result.erase(LLCoreHttpUtil::HttpCoroutineAdapter::HTTP_RESULTS);
+    return result;
 }
 
 void LLViewerObjectList::fetchPhysicsFlags()
 {
-    // issue http request for stale object physics flags
+    // queue stale object physics flags for the next batched request
     if (!mStalePhysicsFlags.empty())
     {
         LLViewerRegion* regionp = gAgent.getRegion();
@@ -1256,8 +1230,24 @@ void LLViewerObjectList::fetchPhysicsFlags()
 
             if (!url.empty())
             {
-                LLCoros::instance().launch("LLViewerObjectList::fetchPhisicsFlagsCoro",
-                    boost::bind(&LLViewerObjectList::fetchPhisicsFlagsCoro, this, url));
+                for (const auto& staleObjectId : mStalePhysicsFlags)
+                {
+                    // Check to see if a request for this object
+                    // has already been made.
+                    if (mPendingPhysicsFlags.count(staleObjectId))
+                    {
+                        continue;
+                    }
+
+                    mPendingPhysicsFlags.insert(staleObjectId);
+                    LLUUID objectId = staleObjectId;
+                    if (!LLCoprocedureManager::instance().enqueueBatched(OBJECT_DATA_POOL, PHYSICS_FLAGS_BATCH, url, objectId,
+                            [objectId](const LLSD& data) { gObjectList.onPhysicsFlagsFetched(objectId, data); }))
+                    {
+                        mPendingPhysicsFlags.erase(objectId);
+                    }
+                }
+                mStalePhysicsFlags.clear();
             }
             else
             {
@@ -1268,107 +1258,30 @@ void LLViewerObjectList::fetchPhysicsFlags()
     }
 }
 
-/*static*/
-void LLViewerObjectList::reportPhysicsFlagFailure(LLSD &objectList)
+void LLViewerObjectList::onPhysicsFlagsFetched(const LLUUID& objectId, const LLSD& data)
 {
-    // TODO*: No more hard coding
-    for (LLSD::array_iterator it = objectList.beginArray(); it != objectList.endArray(); ++it)
+    // Check to see if the request contains data for the object
+    if (data.isMap())
     {
-        gObjectList.onPhysicsFlagsFetchFailure(it->asUUID());
-    }
-}
-
-void LLViewerObjectList::fetchPhisicsFlagsCoro(std::string url)
-{
-    LLCore::HttpRequest::policy_t httpPolicy(LLCore::HttpRequest::DEFAULT_POLICY_ID);
-    LLCoreHttpUtil::HttpCoroutineAdapter::ptr_t
-        httpAdapter(std::make_shared<LLCoreHttpUtil::HttpCoroutineAdapter>("genericPostCoro", httpPolicy));
-    LLCore::HttpRequest::ptr_t httpRequest(std::make_shared<LLCore::HttpRequest>());
+        S32 shapeType = data["PhysicsShapeType"].asInteger();
 
-    LLSD idList;
-    U32 objectIndex = 0;
+        updatePhysicsShapeType(objectId, shapeType);
 
-    for (auto it = mStalePhysicsFlags.begin(); it != mStalePhysicsFlags.end();)
-    {
-        // Check to see if a request for this object
-        // has already been made.
-        if (mPendingPhysicsFlags.find(*it) == mPendingPhysicsFlags.end())
+        if (data.has("Density"))
         {
-            mPendingPhysicsFlags.insert(*it);
-            idList[objectIndex++] = *it;
-        }
-
-        it = mStalePhysicsFlags.erase(it);
+            F32 density = data["Density"].asReal();
+            F32 friction = data["Friction"].asReal();
+            F32 restitution = data["Restitution"].asReal();
+            F32 gravityMult = data["GravityMultiplier"].asReal();
 
-        if (objectIndex >= MAX_CONCURRENT_PHYSICS_REQUESTS)
-        {
-            break;
+            updatePhysicsProperties(objectId, density,
+                friction, restitution, gravityMult);
         }
     }
-
-    if (idList.size() < 1)
-    {
-        //LL_INFOS() << "No outstanding object physics flags to request." << LL_ENDL;
-        return;
-    }
-
-    LLSD postData = LLSD::emptyMap();
-
-    postData["object_ids"] = idList;
-
-    LLSD result = httpAdapter->postAndSuspend(httpRequest, url, postData);
-
-    LLSD httpResults = result[LLCoreHttpUtil::HttpCoroutineAdapter::HTTP_RESULTS];
-    LLCore::HttpStatus status = LLCoreHttpUtil::HttpCoroutineAdapter::getStatusFromLLSD(httpResults);
-
-    if (!status || result.has("error"))
-    {
-        if (result.has("error"))
-        {
-            LL_WARNS() << "Application level error when fetching object "
-                << "physics flags.  Message: " << result["error"]["message"].asString()
-                << ", identifier: " << result["error"]["identifier"].asString()
-                << LL_ENDL;
-
-            // TODO*: Adaptively adjust request size if the
-            // service says we've requested too many and retry
-        }
-        reportPhysicsFlagFailure(idList);
-
-        return;
-    }
-
-    // Success, grab the resource cost and linked set costs
-    // for an object if one was returned
-    for (LLSD::array_iterator it = idList.beginArray(); it != idList.endArray(); ++it)
+    else
     {
-        LLUUID objectId = it->asUUID();
-
-        // Check to see if the request contains data for the object
-        if (result.has(it->asString()))
-        {
-            const LLSD& data = result[it->asString()];
-
-            S32 shapeType = data["PhysicsShapeType"].asInteger();
-
-            gObjectList.updatePhysicsShapeType(objectId, shapeType);
-
-            if (data.has("Density"))
-            {
-                F32 density = data["Density"].asReal();
-                F32 friction = data["Friction"].asReal();
-                F32 restitution = data["Restitution"].asReal();
-                F32 gravityMult = data["GravityMultiplier"].asReal();
-
-                gObjectList.updatePhysicsProperties(objectId, density,
-                    friction, restitution, gravityMult);
-            }
-        }
-        else
-        {
-            // TODO*: Give user feedback about the missing data?
-            gObjectList.onPhysicsFlagsFetchFailure(objectId);
-        }
+        // TODO*: Give user feedback about the missing data?
+        onPhysicsFlagsFetchFailure(objectId);
     }
 }
 
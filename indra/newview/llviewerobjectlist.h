@@ -38,6 +38,7 @@
 #include "llviewerobject.h"
 #include "lleventcoro.h"
 #include "llcoros.h"
+#include "llcorehttputil.h"
 
 // system includes
 #include <boost/unordered/unordered_flat_map.hpp>
@@ -94,6 +95,9 @@ class LLViewerObjectList
     void updateApparentAngles(LLAgent &agent);
     void update(LLAgent &agent);
 
+    // Set up the coprocedure pool that batches object cost and physics
+    // flag requests.  Call once the coprocedure manager has its settings.
+    static void initFetchPool();
     void fetchObjectCosts();
     void fetchPhysicsFlags();
 
@@ -234,11 +238,10 @@ class LLViewerObjectList
     friend class LLViewerObject;
 
 private:
-    static void reportObjectCostFailure(LLSD &objectList);
-    void fetchObjectCostsCoro(std::string url, uuid_hash_set_t staleObjects);
-
-    static void reportPhysicsFlagFailure(LLSD &obejectList);
-    void fetchPhisicsFlagsCoro(std::string url);
+    static LLSD postObjectIdsBatch(const char* what, LLCoreHttpUtil::HttpCoroutineAdapter::ptr_t& httpAdapter,
+                                   const std::string& url, const LLSD& idList);
+    void onObjectCostFetched(const LLUUID& objectId, const LLSD& objectData);
+    void onPhysicsFlagsFetched(const LLUUID& objectId, const LLSD& data);
 
 };
 
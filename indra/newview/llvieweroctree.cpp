@@ -39,6 +39,7 @@
 //-----------------------------------------------------------------------------------
 U32 LLViewerOctreeEntryData::sCurVisible = 10; //reserve the low numbers for special use.
 BOOL LLViewerOctreeDebug::sInDebug = FALSE;
+bool LLViewerOctreePartition::sUseLinearOctree = false;
 
 static LLTrace::CountStatHandle<S32> sOcclusionQueries("occlusion_queries", "Number of occlusion queries executed"),
                                      sNumObjectsOccluded("occluded_objects", "Count of objects being occluded by a query"),
@@ -1304,7 +1305,8 @@ LLViewerOctreePartition::LLViewerOctreePartition() :
     mOcclusionEnabled(TRUE),
     mDrawableType(0),
     mLODSeed(0),
-    mLODPeriod(1)
+    mLODPeriod(1),
+    mLinearOctree(nullptr)
 {
     LLVector4a center, size;
     center.splat(0.f);
@@ -1320,10 +1322,49 @@ LLViewerOctreePartition::~LLViewerOctreePartition()
 
 void LLViewerOctreePartition::cleanup()
 {
+    delete mLinearOctree;
+    mLinearOctree = nullptr;
     delete mOctree;
     mOctree = nullptr;
 }
 
+class LLLinearOctreeFill : public OctreeTraveler
+{
+public:
+    LLLinearOctreeFill(LinearOctree* tree) : mTree(tree) {}
+
+    virtual void visit(const OctreeNode* branch)
+    {
+        for (OctreeNode::const_element_iter i = branch->getDataBegin(); i != branch->getDataEnd(); ++i)
+        {
+            mTree->insert(*i);
+        }
+    }
+
+private:
+    LinearOctree* mTree;
+};
+
+LinearOctree* LLViewerOctreePartition::getLinearOctree()
+{
+    if (!sUseLinearOctree)
+    {
+        delete mLinearOctree;
+        mLinearOctree = nullptr;
+        return nullptr;
+    }
+
+    if (!mLinearOctree)
+    {
+        mLinearOctree = new LinearOctree(gOctreeMaxCapacity);
+        LLLinearOctreeFill fill(mLinearOctree);
+        fill.traverse(mOctree);
+    }
+
+    mLinearOctree->update();
+    return mLinearOctree;
+}
+
 BOOL LLViewerOctreePartition::isOcclusionEnabled()
 {
     return mOcclusionEnabled || LLPipeline::sUseOcclusion > 2;
@@ -1359,8 +1400,12 @@ void LLViewerOctreeCull::traverse(const OctreeNode* n)
     {
         mRes = frustumCheck(group);
 
-        if (mRes)
-        { //at least partially in, run on down
+        if (mRes == 1)
+        { //partially in, check the leaves below together
+            traverseLeaves(n);
+        }
+        else if (mRes)
+        { //fully in, run on down
             OctreeTraveler::traverse(n);
         }
 
@@ -1368,6 +1413,73 @@ void LLViewerOctreeCull::traverse(const OctreeNode* n)
     }
 }
 
+//same as OctreeTraveler::traverse(n) with mRes == 1, except that the
+//frustumCheck() of the leaf children is done in one batch up front
+void LLViewerOctreeCull::traverseLeaves(const OctreeNode* n)
+{
+    const U32 MAX_CHILDREN = 8;
+    LLViewerOctreeGroup* leaves[MAX_CHILDREN];
+    S32 results[MAX_CHILDREN];
+    F32 pixel_area[MAX_CHILDREN];
+
+    U32 count = 0;
+    for (U32 i = 0; i < n->getChildCount(); i++)
+    {
+        const OctreeNode* child = n->getChild(i);
+        if (child->getChildCount() == 0 && count < MAX_CHILDREN)
+        {
+            leaves[count++] = (LLViewerOctreeGroup*) child->getListener(0);
+        }
+    }
+
+    if (count < 2 || !frustumCheckBatch(leaves, count, results, pixel_area))
+    {
+        OctreeTraveler::traverse(n);
+        return;
+    }
+
+    n->accept(this);
+
+    U32 leaf = 0;
+    for (U32 i = 0; i < n->getChildCount(); i++)
+    {
+        const OctreeNode* child = n->getChild(i);
+        if (child->getChildCount() != 0 || leaf == count)
+        {
+            traverse(child);
+            continue;
+        }
+
+        //what traverse(child) does, with the frustum check already made
+        LLViewerOctreeGroup* group = leaves[leaf];
+        S32 res = results[leaf];
+        mPixelArea = pixel_area[leaf];
+        leaf++;
+
+        if (earlyFail(group))
+        {
+            mPixelArea = -1.f;
+            continue;
+        }
+
+        if (mRes == 2 ||
+            (mRes && group->hasState(LLViewerOctreeGroup::SKIP_FRUSTUM_CHECK)))
+        {
+            OctreeTraveler::traverse(child);
+        }
+        else
+        {
+            mRes = res;
+            if (mRes)
+            {
+                OctreeTraveler::traverse(child);
+            }
+            mRes = 0;
+        }
+        mPixelArea = -1.f;
+    }
+}
+
 //------------------------------------------
 //agent space group culling
 S32 LLViewerOctreeCull::AABBInFrustumNoFarClipGroupBounds(const LLViewerOctreeGroup* group)
@@ -1386,6 +1498,31 @@ S32 LLViewerOctreeCull::AABBInFrustumGroupBounds(const LLViewerOctreeGroup* grou
 }
 //------------------------------------------
 
+void LLViewerOctreeCull::AABBInFrustumGroupBoundsBatch(LLViewerOctreeGroup* const* groups, U32 count, S32* results, bool far_clip, bool region)
+{
+    mBatch.clear();
+    for (U32 i = 0; i < count; i++)
+    {
+        mBatch.add(groups[i]->mBounds[0], groups[i]->mBounds[1]);
+    }
+
+    mVisibleMask.resize(LLAABBBatch::getMaskSize(count));
+    mInsideMask.resize(LLAABBBatch::getMaskSize(count));
+    if (region)
+    {
+        mCamera->AABBInRegionFrustumBatch(mBatch, mVisibleMask.data(), mInsideMask.data(), far_clip);
+    }
+    else
+    {
+        mCamera->AABBInFrustumBatch(mBatch, mVisibleMask.data(), mInsideMask.data(), far_clip);
+    }
+    for (U32 i = 0; i < count; i++)
+    {
+        results[i] = LLAABBBatch::getResult(mVisibleMask.data(), mInsideMask.data(), i);
+    }
+}
+//------------------------------------------
+
 //------------------------------------------
 //agent space object set culling
 S32 LLViewerOctreeCull::AABBInFrustumNoFarClipObjectBounds(const LLViewerOctreeGroup* group)
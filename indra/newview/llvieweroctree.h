@@ -36,6 +36,7 @@
 #include "m4math.h"
 #include "llvector4a.h"
 #include "llquaternion.h"
+#include "lllinearoctree.h"
 #include "lloctree.h"
 #include "llviewercamera.h"
 
@@ -50,6 +51,7 @@ typedef LLTreeNode<LLViewerOctreeEntry> TreeNode;
 typedef LLOctreeNode<LLViewerOctreeEntry, LLPointer<LLViewerOctreeEntry>> OctreeNode;
 typedef LLOctreeRoot<LLViewerOctreeEntry, LLPointer<LLViewerOctreeEntry>> OctreeRoot;
 typedef LLOctreeTraveler<LLViewerOctreeEntry, LLPointer<LLViewerOctreeEntry>> OctreeTraveler;
+typedef LLLinearOctree<LLViewerOctreeEntry, LLPointer<LLViewerOctreeEntry>> LinearOctree;
 
 #if LL_OCTREE_PARANOIA_CHECK
 #define assert_octree_valid(x) x->validate()
@@ -352,6 +354,12 @@ class LLViewerOctreePartition
     virtual S32 cull(LLCamera &camera, bool do_occlusion) = 0;
     BOOL isOcclusionEnabled();
 
+    // Flat copy of mOctree that culling can walk instead, with every queued
+    // change applied. Built from mOctree on first use, null unless
+    // sUseLinearOctree is set. Partitions that use it keep it up to date
+    // through mLinearOctree when elements come and go.
+    LinearOctree* getLinearOctree();
+
 protected:
     // MUST call from destructor of any derived classes (SL-17276)
     void cleanup();
@@ -364,17 +372,23 @@ class LLViewerOctreePartition
     BOOL             mOcclusionEnabled; // if TRUE, occlusion culling is performed
     U32              mLODSeed;
     U32              mLODPeriod;    //number of frames between LOD updates for a given spatial group (staggered by mLODSeed)
+    LinearOctree*    mLinearOctree; // see getLinearOctree()
+
+    static bool      sUseLinearOctree; // OctreeLinearCulling
 };
 
 class LLViewerOctreeCull : public OctreeTraveler
 {
 public:
     LLViewerOctreeCull(LLCamera* camera)
-        : mCamera(camera), mRes(0) { }
+        : mCamera(camera), mRes(0), mPixelArea(-1.f) { }
 
     virtual void traverse(const OctreeNode* n);
 
 protected:
+    //traverse a partly visible node, checking its leaf children in one batch
+    void traverseLeaves(const OctreeNode* n);
+
     virtual bool earlyFail(LLViewerOctreeGroup* group);
 
     //agent space group cull
@@ -397,9 +411,18 @@ class LLViewerOctreeCull : public OctreeTraveler
     S32 AABBInRegionFrustumObjectBounds(const LLViewerOctreeGroup* group);
     S32 AABBRegionSphereIntersectObjectExtents(const LLViewerOctreeGroup* group, const LLVector3& shift);
 
+    //batched group bounds cull, in agent space or local region space, with
+    //the results AABBIn[Region]Frustum[NoFarClip]GroupBounds() would give
+    void AABBInFrustumGroupBoundsBatch(LLViewerOctreeGroup* const* groups, U32 count, S32* results, bool far_clip, bool region);
+
     virtual S32 frustumCheck(const LLViewerOctreeGroup* group) = 0;
     virtual S32 frustumCheckObjects(const LLViewerOctreeGroup* group) = 0;
 
+    // Fills in results with what frustumCheck() returns for each group, and
+    // pixel_area with an estimate of each group's pixel area or a negative
+    // value. Returns false if this culler has no batched check.
+    virtual bool frustumCheckBatch(LLViewerOctreeGroup* const* groups, U32 count, S32* results, F32* pixel_area) { return false; }
+
     bool checkProjectionArea(const LLVector4a& center, const LLVector4a& size, const LLVector3& shift, F32 pixel_threshold, F32 near_radius);
     virtual bool checkObjects(const OctreeNode* branch, const LLViewerOctreeGroup* group);
     virtual void preprocess(LLViewerOctreeGroup* group);
@@ -409,6 +432,10 @@ class LLViewerOctreeCull : public OctreeTraveler
 protected:
     LLCamera *mCamera;
     S32 mRes;
+    F32 mPixelArea;             //estimated pixel area of the group being visited, negative if unknown
+    LLAABBBatch mBatch;         //boxes of the last batched check
+    std::vector<U32> mVisibleMask;
+    std::vector<U32> mInsideMask;
 };
 
 //scan the octree, output the info of each node for debug use.
@@ -36,8 +36,11 @@
 #include "llhost.h"
 #include "llimage.h"
 #include "llimagebmp.h"
+#include "llimagebufferpool.h"
+#include "llimagedxt.h"
 #include "llimagej2c.h"
 #include "llimagetga.h"
+#include "llimageworker.h"
 #include "llstl.h"
 #include "message.h"
 #include "lltimer.h"
@@ -544,6 +547,27 @@ void LLViewerTexture::updateClass()
 
     LLViewerMediaTexture::updateClass();
 
+    static LLCachedControl<U32> image_pool_size(gSavedSettings, "ImageBufferPoolSize", 128);
+    S64 image_pool_bytes = (S64)image_pool_size() * 1024 * 1024;
+    if (image_pool_bytes != LLImageBufferPool::getMaxBytes())
+    {
+        LLImageBufferPool::setMaxBytes(image_pool_bytes);
+    }
+    // Idle image buffers are the first thing to give back when system
+    // memory runs short
+    const S32Megabytes MIN_FREE_MAIN_MEMORY(256);
+    S32Megabytes gpu_free;
+    S32Megabytes physical_free;
+    getGPUMemoryForTextures(gpu_free, physical_free);
+    if (physical_free < MIN_FREE_MAIN_MEMORY)
+    {
+        LLImageBufferPool::trim();
+    }
+    else
+    {
+        LLImageBufferPool::update();
+    }
+
     static LLCachedControl<U32> max_vram_budget(gSavedSettings, "RenderMaxVRAMBudget", 0);
 
     F64 texture_bytes_alloc = LLImageGL::getTextureBytesAllocated() / 1024.0 / 512.0;
@@ -688,6 +712,7 @@ void LLViewerTexture::setBoostLevel(S32 level)
     if (mBoostLevel >= LLViewerTexture::BOOST_HIGH)
     {
         mMaxVirtualSize = 2048.f * 2048.f;
+        scheduleUpdate();
     }
 }
 
@@ -771,6 +796,10 @@ void LLViewerTexture::addTextureStats(F32 virtual_size, BOOL needs_gltexture) co
     if (virtual_size > mMaxVirtualSize)
     {
         mMaxVirtualSize = virtual_size;
+        if (virtual_size > mScheduledVirtualSize * 2.f)
+        {
+            scheduleUpdate();
+        }
     }
 }
 
@@ -806,6 +835,7 @@ void LLViewerTexture::addFace(U32 ch, LLFace* facep)
     facep->setIndexInTex(ch, mNumFaces[ch]);
     mNumFaces[ch]++;
     mLastFaceListUpdateTimer.reset();
+    scheduleUpdate();
 }
 
 //virtual
@@ -1581,7 +1611,19 @@ BOOL LLViewerFetchedTexture::createTexture(S32 usename/*= 0*/)
         return FALSE;
     }
 
-    BOOL res = mGLTexturep->createGLTexture(mRawDiscardLevel, mRawImage, usename, TRUE, mBoostLevel);
+    BOOL res;
+    if (mCompressedImage.notNull())
+    {
+        res = mGLTexturep->createGLTexture(mRawDiscardLevel, mCompressedImage, mRawImage, usename, mBoostLevel);
+    }
+    else if (mMipChain.notNull())
+    {
+        res = mGLTexturep->createGLTexture(mRawDiscardLevel, mMipChain, usename, mBoostLevel);
+    }
+    else
+    {
+        res = mGLTexturep->createGLTexture(mRawDiscardLevel, mRawImage, usename, TRUE, mBoostLevel);
+    }
 
     return res;
 }
@@ -1598,6 +1640,8 @@ void LLViewerFetchedTexture::postCreateTexture()
 #endif
 
     setActive();
+    mMipChain = NULL;
+    mCompressedImage = NULL;
 
     if (!needsToSaveRawImage())
     {
@@ -1615,72 +1659,179 @@ void LLViewerFetchedTexture::scheduleCreateTexture()
     if (!mNeedsCreateTexture)
     {
         mNeedsCreateTexture = true;
-        if (preCreateTexture())
+        if (preCreateTexture() && !requestCompression() && !requestMipChain())
         {
-#if LL_IMAGEGL_THREAD_CHECK
-            //grab a copy of the raw image data to make sure it isn't modified pending texture creation
-            U8* data = mRawImage->getData();
-            U8* data_copy = nullptr;
-            S32 size = mRawImage->getDataSize();
-            if (data != nullptr && size > 0)
+            queueCreateTexture();
+        }
+    }
+}
+
+bool LLViewerFetchedTexture::requestCompression()
+{
+    static LLCachedControl<U32> cpu_compression(gSavedSettings, "RenderTextureCPUCompression", 0);
+    LLImageDecodeThread* decode_thread = LLAppViewer::getImageDecodeThread();
+    if (!cpu_compression || !decode_thread)
+    {
+        return false;
+    }
+
+    // Normal maps lose too much as DXT, and textures with a format of their
+    // own must keep it
+    S32 components = mRawImage->getComponents();
+    if (mBoostLevel == LLGLTexture::BOOST_BUMP
+        || (components != 3 && components != 4)
+        || mRawImage->getWidth() < 4 || mRawImage->getHeight() < 4
+        || (mGLTexturep->getHasExplicitFormat() && !mGLTexturep->getPrecompressed()))
+    {
+        return false;
+    }
+
+    LLImageBC::EQuality quality = (LLImageBC::EQuality)(llclamp((S32)cpu_compression, 1, (S32)LLImageBC::QUALITY_COUNT) - 1);
+    LLImageDXT::EFileFormat format = LLImageDXT::FORMAT_DXR1;
+    if (components == 4)
+    {
+        format = quality == LLImageBC::QUALITY_HIGH && gGLManager.mHasTextureCompressionBPTC
+            ? LLImageDXT::FORMAT_BC7R : LLImageDXT::FORMAT_DXR5;
+    }
+
+    // Same as requestMipChain(), the compressed image carries its own mips.
+    // A failed compression creates the texture from mRawImage.
+    ref();
+    LL::WorkQueue::weak_t main_queue = mMainQueue;
+    U32 request_id = decode_thread->compressImage(mRawImage, format, quality,
+        [this, main_queue](LLImageDXT* compressed, U32)
+        {
+            LLPointer<LLImageDXT> image = compressed;
+            LL::WorkQueue::ptr_t mainq = main_queue.lock();
+            // When the main loop has closed the texture is left to shutdown
+            if (mainq)
             {
-                data_copy = new U8[size];
-                memcpy(data_copy, data, size);
+                mainq->post([this, image]()
+                    {
+                        mCompressedImage = image;
+                        queueCreateTexture();
+                        unref();
+                    });
             }
-#endif
-            mNeedsCreateTexture = true;
-            auto mainq = LLImageGLThread::sEnabledTextures ? mMainQueue.lock() : nullptr;
+        });
+    if (!request_id)
+    {
+        // Shutting down
+        unref();
+        return false;
+    }
+    return true;
+}
+
+bool LLViewerFetchedTexture::requestMipChain()
+{
+    static LLCachedControl<bool> cpu_mipmaps(gSavedSettings, "RenderTextureCPUMipmaps", false);
+    LLImageDecodeThread* decode_thread = LLAppViewer::getImageDecodeThread();
+    if (!cpu_mipmaps || !mUseMipMaps || !decode_thread || mRawImage->getComponents() > 4)
+    {
+        return false;
+    }
+
+    LLImageMipChain::Params params;
+    // Normal maps hold vectors rather than colors
+    params.mSRGB = mBoostLevel != LLGLTexture::BOOST_BUMP;
+
+    // mRawImage doesn't change while mNeedsCreateTexture is set. The
+    // chain comes back through the main loop, which creates the texture
+    // as queueCreateTexture() would have without it.
+    ref();
+    LL::WorkQueue::weak_t main_queue = mMainQueue;
+    U32 request_id = decode_thread->generateMips(mRawImage, params,
+        [this, main_queue](LLImageMipChain* mips, U32)
+        {
+            LLPointer<LLImageMipChain> chain = mips;
+            LL::WorkQueue::ptr_t mainq = main_queue.lock();
+            // When the main loop has closed the texture is left to shutdown
             if (mainq)
             {
-                ref();
-                mainq->postTo(
-                    mImageQueue,
-                    // work to be done on LLImageGL worker thread
-#if LL_IMAGEGL_THREAD_CHECK
-                    [this, data, data_copy, size]()
+                mainq->post([this, chain]()
                     {
-                        mGLTexturep->mActiveThread = LLThread::currentID();
-                        //verify data is unmodified
-                        llassert(data == mRawImage->getData());
-                        llassert(mRawImage->getDataSize() == size);
-                        llassert(memcmp(data, data_copy, size) == 0);
+                        mMipChain = chain;
+                        queueCreateTexture();
+                        unref();
+                    });
+            }
+        });
+    if (!request_id)
+    {
+        // Shutting down
+        unref();
+        return false;
+    }
+    return true;
+}
+
+void LLViewerFetchedTexture::queueCreateTexture()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
+
+#if LL_IMAGEGL_THREAD_CHECK
+    //grab a copy of the raw image data to make sure it isn't modified pending texture creation
+    U8* data = mRawImage->getData();
+    U8* data_copy = nullptr;
+    S32 size = mRawImage->getDataSize();
+    if (data != nullptr && size > 0)
+    {
+        data_copy = new U8[size];
+        memcpy(data_copy, data, size);
+    }
+#endif
+    mNeedsCreateTexture = true;
+    auto mainq = LLImageGLThread::sEnabledTextures ? mMainQueue.lock() : nullptr;
+    if (mainq)
+    {
+        ref();
+        mainq->postTo(
+            mImageQueue,
+            // work to be done on LLImageGL worker thread
+#if LL_IMAGEGL_THREAD_CHECK
+            [this, data, data_copy, size]()
+            {
+                mGLTexturep->mActiveThread = LLThread::currentID();
+                //verify data is unmodified
+                llassert(data == mRawImage->getData());
+                llassert(mRawImage->getDataSize() == size);
+                llassert(memcmp(data, data_copy, size) == 0);
 #else
-                    [this]()
-                    {
+            [this]()
+            {
 #endif
-                        //actually create the texture on a background thread
-                        createTexture();
+                //actually create the texture on a background thread
+                createTexture();
 
 #if LL_IMAGEGL_THREAD_CHECK
-                        //verify data is unmodified
-                        llassert(data == mRawImage->getData());
-                        llassert(mRawImage->getDataSize() == size);
-                        llassert(memcmp(data, data_copy, size) == 0);
+                //verify data is unmodified
+                llassert(data == mRawImage->getData());
+                llassert(mRawImage->getDataSize() == size);
+                llassert(memcmp(data, data_copy, size) == 0);
 #endif
-                    },
-                    // callback to be run on main thread
+            },
+            // callback to be run on main thread
 #if LL_IMAGEGL_THREAD_CHECK
-                        [this, data, data_copy, size]()
-                    {
-                        mGLTexturep->mActiveThread = LLThread::currentID();
-                        llassert(data == mRawImage->getData());
-                        llassert(mRawImage->getDataSize() == size);
-                        llassert(memcmp(data, data_copy, size) == 0);
-                        delete[] data_copy;
+                [this, data, data_copy, size]()
+            {
+                mGLTexturep->mActiveThread = LLThread::currentID();
+                llassert(data == mRawImage->getData());
+                llassert(mRawImage->getDataSize() == size);
+                llassert(memcmp(data, data_copy, size) == 0);
+                delete[] data_copy;
 #else
-                        [this]()
-                        {
+                [this]()
+                {
 #endif
-                        //finalize on main thread
-                        postCreateTexture();
-                        unref();
-                    });
-            }
-            else
-            {
-                gTextureList.mCreateTextureList.insert(this);
-            }
-        }
+                //finalize on main thread
+                postCreateTexture();
+                unref();
+            });
+    }
+    else
+    {
+        gTextureList.mCreateTextureList.insert(this);
     }
 }
 
@@ -1857,6 +2008,17 @@ void LLViewerFetchedTexture::setBoostLevel(S32 level)
     }
 }
 
+//virtual
+void LLViewerFetchedTexture::scheduleUpdate() const
+{
+    // Stats are also gathered for textures that aren't in the list, and
+    // from threads other than main
+    if (mInImageList && on_main_thread())
+    {
+        gTextureList.requestImageUpdate(const_cast<LLViewerFetchedTexture*>(this), mMaxVirtualSize);
+    }
+}
+
 bool LLViewerFetchedTexture::updateFetch()
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
@@ -2058,9 +2220,18 @@ bool LLViewerFetchedTexture::updateFetch()
         else
         {
             static const F32 MAX_HOLD_TIME = 5.0f; //seconds to wait before canceling fecthing if decode_priority is 0.f.
-            if(decode_priority > 0.0f || mStopFetchingTimer.getElapsedTimeF32() > MAX_HOLD_TIME)
+            if(decode_priority > 0.0f)
+            {
+                mStopFetchingTimer.reset();
+            }
+            // Only post to the fetcher when the priority it has is out of date.
+            // Compare with what we last posted, getFetchState() doesn't
+            // report the worker's priority while it is on the network.
+            if((decode_priority > 0.0f || mStopFetchingTimer.getElapsedTimeF32() > MAX_HOLD_TIME) &&
+               decode_priority != mPostedFetchPriority)
             {
                 mStopFetchingTimer.reset();
+                mPostedFetchPriority = decode_priority;
                 LLAppViewer::getTextureFetch()->updateRequestPriority(mID, decode_priority);
             }
         }
@@ -2146,6 +2317,7 @@ bool LLViewerFetchedTexture::updateFetch()
             LL_PROFILE_ZONE_NAMED_CATEGORY_TEXTURE("vftuf - request created");
             mHasFetcher = TRUE;
             mIsFetching = TRUE;
+            mPostedFetchPriority = decode_priority;
             // in some cases createRequest can modify discard, as an example
             // bake textures are always at discard 0
             mRequestedDiscardLevel = llmin(desired_discard, fetch_request_discard);
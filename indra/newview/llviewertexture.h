@@ -29,6 +29,7 @@
 
 #include "llatomic.h"
 #include "llgltexture.h"
+#include "llimagemips.h"
 #include "lltimer.h"
 #include "llframetimer.h"
 #include "llhost.h"
@@ -45,6 +46,7 @@ extern const S32Megabytes gMinVideoRam;
 extern const S32Megabytes gMaxVideoRam;
 
 class LLFace;
+class LLImageDXT;
 class LLImageGL ;
 class LLImageRaw;
 class LLViewerObject;
@@ -178,6 +180,10 @@ class LLViewerTexture : public LLGLTexture
     void init(bool firstinit) ;
     void reorganizeFaceList() ;
     void reorganizeVolumeList();
+    // Asks the texture list to update this texture soon rather than when
+    // its turn comes round. Called when faces are added, the boost level
+    // rises or the virtual size has doubled since the last update.
+    virtual void scheduleUpdate() const {}
 
 private:
     friend class LLBumpImageList;
@@ -195,6 +201,7 @@ class LLViewerTexture : public LLGLTexture
     S32 mTextureListType; // along with mID identifies where to search for this texture in TextureList
 
     mutable F32 mMaxVirtualSize = 0.f;  // The largest virtual size of the image, in pixels - how much data to we need?
+    mutable F32 mScheduledVirtualSize = 0.f; // mMaxVirtualSize when the texture list last updated this texture
     mutable S32  mMaxVirtualSizeResetCounter;
     mutable S32  mMaxVirtualSizeResetInterval;
     LLFrameTimer mLastReferencedTimer;
@@ -423,6 +430,7 @@ class LLViewerFetchedTexture : public LLViewerTexture
 
 protected:
     /*virtual*/ void switchToCachedImage() override;
+    /*virtual*/ void scheduleUpdate() const override;
     S32 getCurrentDiscardLevelForFetching() ;
     void forceToRefetchTexture(S32 desired_discard = 0, F32 kept_time = 60.f);
 
@@ -433,6 +441,18 @@ class LLViewerFetchedTexture : public LLViewerTexture
     void saveRawImage() ;
     void setCachedRawImage() ;
 
+    // Block compresses mRawImage into mCompressedImage on the ImageDecode
+    // pool when RenderTextureCPUCompression is set, then queues the
+    // texture's creation. Returns false, without queueing, if the image
+    // isn't to be compressed.
+    bool requestCompression();
+    // Builds mMipChain from mRawImage on the ImageDecode pool when
+    // RenderTextureCPUMipmaps is set, then queues the texture's creation.
+    // Returns false, without queueing, if there is no chain to build.
+    bool requestMipChain();
+    // Creates the GL texture on the image thread or through the texture list
+    void queueCreateTexture();
+
     //for atlas
     void resetFaceAtlas() ;
     void invalidateAtlas(BOOL rebuild_geom) ;
@@ -460,6 +480,7 @@ class LLViewerFetchedTexture : public LLViewerTexture
 
     S32 mRequestedDiscardLevel;
     F32 mRequestedDownloadPriority;
+    F32 mPostedFetchPriority = -1.f; // Last priority given to the fetcher, -1 when none
     S32 mFetchState;
     S32 mLastFetchState = -1; // DEBUG
     U32 mFetchPriority;
@@ -490,6 +511,8 @@ class LLViewerFetchedTexture : public LLViewerTexture
 
     LLPointer<LLImageRaw> mRawImage;
     S32 mRawDiscardLevel = -1;
+    LLPointer<LLImageMipChain> mMipChain; // mips of mRawImage to upload with it, see requestMipChain()
+    LLPointer<LLImageDXT> mCompressedImage; // mRawImage and its mips compressed, see requestCompression()
 
     // Used ONLY for cloth meshes right now.  Make SURE you know what you're
     // doing if you use it for anything else! - djs
@@ -375,6 +375,7 @@ void LLViewerTextureList::shutdown()
     mUUIDMap.clear();
 
     mImageList.clear();
+    mUpdateHeap.clear();
 
     mInitialized = FALSE ; //prevent loading textures again.
 }
@@ -746,6 +747,7 @@ void LLViewerTextureList::removeImageFromList(LLViewerFetchedTexture *image)
         }
     }
 
+    mUpdateHeap.erase(image);
     image->setInImageList(FALSE) ;
 }
 
@@ -1115,18 +1117,56 @@ void LLViewerTextureList::forceImmediateUpdate(LLViewerFetchedTexture* imagep)
     return ;
 }
 
+void LLViewerTextureList::requestImageUpdate(LLViewerFetchedTexture* imagep, F32 priority)
+{
+    llassert(imagep->isInImageList());
+    mUpdateHeap.raise(imagep, priority);
+}
+
+void LLViewerTextureList::updateImageFetch(LLViewerFetchedTexture* imagep)
+{
+    updateImageDecodePriority(imagep);
+    imagep->updateFetch();
+
+    // Stats gathered while updating don't need another update
+    imagep->mScheduledVirtualSize = imagep->mMaxVirtualSize;
+    mUpdateHeap.erase(imagep);
+}
+
 F32 LLViewerTextureList::updateImagesFetchTextures(F32 max_time)
 {
     LL_PROFILE_ZONE_SCOPED_CATEGORY_TEXTURE;
     typedef std::vector<LLPointer<LLViewerFetchedTexture> > entries_list_t;
     entries_list_t entries;
 
-    // update N textures at beginning of mImageList
-    U32 update_count = 0;
     static const S32 MIN_UPDATE_COUNT = gSavedSettings.getS32("TextureFetchUpdateMinCount");       // default: 32
-    // WIP -- dumb code here
-    //update MIN_UPDATE_COUNT or 5% of other textures, whichever is greater
-    update_count = llmax((U32) MIN_UPDATE_COUNT, (U32) mUUIDMap.size()/20);
+    static LLCachedControl<S32> max_scheduled(gSavedSettings, "TextureFetchUpdateMaxScheduled", 128);
+    static LLCachedControl<F32> sweep_percent(gSavedSettings, "TextureFetchUpdateSweepPercent", 5.f);
+
+    LLTimer timer;
+
+    // Textures that asked for an update because they got new faces or
+    // grew on screen, most important first. Only the urgent end of the
+    // heap is touched, so the cost doesn't grow with the number of
+    // textures.
+    {
+        LL_PROFILE_ZONE_NAMED_CATEGORY_TEXTURE("vtluift - scheduled");
+        S32 count = llmax((S32)max_scheduled, 0);
+        while (count-- > 0 && !mUpdateHeap.empty() && timer.getElapsedTimeF32() < max_time * 0.5f)
+        {
+            LLPointer<LLViewerFetchedTexture> imagep = mUpdateHeap.pop();
+            if (imagep->getGLTexture())
+            {
+                updateImageFetch(imagep);
+            }
+        }
+    }
+
+    // Round robin over everything else, for textures that got smaller or
+    // went off screen, which doesn't raise an event, and for the lazy
+    // flush of unused ones. MIN_UPDATE_COUNT or sweep_percent of the
+    // textures, whichever is greater.
+    U32 update_count = llmax((U32)MIN_UPDATE_COUNT, (U32)(mUUIDMap.size() * llclamp((F32)sweep_percent, 0.f, 100.f) / 100.f));
     update_count = llmin(update_count, (U32) mUUIDMap.size());
 
     {
@@ -1150,8 +1190,6 @@ F32 LLViewerTextureList::updateImagesFetchTextures(F32 max_time)
         }
     }
 
-    LLTimer timer;
-
     LLPointer<LLViewerTexture> last_imagep = nullptr;
 
     for (auto& imagep : entries)
@@ -1159,8 +1197,7 @@ F32 LLViewerTextureList::updateImagesFetchTextures(F32 max_time)
         if (imagep && imagep->getNumRefs() > 1) // make sure this image hasn't been deleted before attempting to update (may happen as a side effect of some other image updating)
 
         {
-            updateImageDecodePriority(imagep);
-            imagep->updateFetch();
+            updateImageFetch(imagep);
         }
 
         last_imagep = imagep;
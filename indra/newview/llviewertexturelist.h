@@ -30,6 +30,7 @@
 #include "lluuid.h"
 //#include "message.h"
 #include "llgl.h"
+#include "llindexedheap.h"
 #include "llviewertexture.h"
 #include "llui.h"
 #include <list>
@@ -158,12 +159,18 @@ class LLViewerTextureList
     void clearFetchingRequests();
     void setDebugFetching(LLViewerFetchedTexture* tex, S32 debug_level);
 
+    // Queues imagep to be updated ahead of the round robin sweep, highest
+    // priority first. See LLViewerTexture::scheduleUpdate().
+    void requestImageUpdate(LLViewerFetchedTexture* imagep, F32 priority);
+
 private:
     // do some book keeping on the specified texture
     // - updates decode priority
     // - updates desired discard level
     // - cleans up textures that haven't been referenced in awhile
     void updateImageDecodePriority(LLViewerFetchedTexture* imagep);
+    // updateImageDecodePriority() and updateFetch()
+    void updateImageFetch(LLViewerFetchedTexture* imagep);
     F32  updateImagesCreateTextures(F32 max_time);
     F32  updateImagesFetchTextures(F32 max_time);
     void updateImagesUpdateStats();
@@ -240,6 +247,10 @@ class LLViewerTextureList
     typedef std::set < LLPointer<LLViewerFetchedTexture> > image_priority_list_t;
     image_priority_list_t mImageList;
 
+    // Textures in mImageList waiting for an update, by priority. Just raw
+    // pointers, removeImageFromList() takes them out.
+    LLIndexedHeap<LLViewerFetchedTexture*> mUpdateHeap;
+
     // simply holds on to LLViewerFetchedTexture references to stop them from being purged too soon
     std::set<LLPointer<LLViewerFetchedTexture> > mImagePreloads;
 
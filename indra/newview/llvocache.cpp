@@ -374,6 +374,7 @@ void LLVOCacheEntry::addChild(LLVOCacheEntry* entry)
     if(getEntry() != NULL && isState(INACTIVE))
     {
         updateParentBoundingInfo(entry);
+        updatePartitionBounds();
         resetVisible();
     }
 }
@@ -641,6 +642,7 @@ void LLVOCacheEntry::setBoundingInfo(const LLVector3& pos, const LLVector3& scal
     else
     {
         setBinRadius(llmin(size.getLength3().getF32() * 4.f, 256.f));
+        updatePartitionBounds();
     }
 }
 
@@ -656,6 +658,7 @@ void LLVOCacheEntry::updateParentBoundingInfo()
     {
         updateParentBoundingInfo(*iter);
     }
+    updatePartitionBounds();
     resetVisible();
 }
 
@@ -693,6 +696,15 @@ void LLVOCacheEntry::updateParentBoundingInfo(const LLVOCacheEntry* child)
     size.mul(0.5f);
     setBinRadius(llmin(size.getLength3().getF32() * 4.f, 256.f));
 }
+
+void LLVOCacheEntry::updatePartitionBounds()
+{
+    LLOcclusionCullingGroup* group = (LLOcclusionCullingGroup*)getGroup();
+    if(group)
+    {
+        ((LLVOCachePartition*)group->getSpatialPartition())->updateEntry(getEntry());
+    }
+}
 //-------------------------------------------------------------------
 //LLVOCachePartition
 //-------------------------------------------------------------------
@@ -755,12 +767,29 @@ bool LLVOCachePartition::addEntry(LLViewerOctreeEntry* entry)
     }
 
     mOctree->insert(entry);
+    if (mLinearOctree)
+    {
+        mLinearOctree->insert(entry);
+    }
 
     return true;
 }
 
+//the linear octree copies the bounds of an entry when it is queued, queue it again
+void LLVOCachePartition::updateEntry(LLViewerOctreeEntry* entry)
+{
+    if (mLinearOctree)
+    {
+        mLinearOctree->insert(entry);
+    }
+}
+
 void LLVOCachePartition::removeEntry(LLViewerOctreeEntry* entry)
 {
+    if (mLinearOctree)
+    {
+        mLinearOctree->remove(entry);
+    }
     entry->getVOCacheEntry()->setGroup(NULL);
 
     llassert(!entry->getGroup());
@@ -841,6 +870,80 @@ class LLVOCacheOctreeCull final : public LLViewerOctreeCull
         return res;
     }
 
+    virtual bool frustumCheckBatch(LLViewerOctreeGroup* const* groups, U32 count, S32* results, F32* pixel_area)
+    {
+        AABBInFrustumGroupBoundsBatch(groups, count, results, false, true);
+        for (U32 i = 0; i < count; i++)
+        {
+            if (results[i] != 0)
+            {
+                results[i] = llmin(results[i], AABBRegionSphereIntersectGroupExtents(groups[i], mLocalShift));
+            }
+            pixel_area[i] = -1.f;
+        }
+        return true;
+    }
+
+    // Same groups as traverse(mOctree) without occlusion, found through
+    // the entries of the flat tree. Every group with an entry in the
+    // frustum goes through the group checks traverse() would make.
+    void cull(LinearOctree& tree)
+    {
+        llassert(!mUseObjectCacheOcclusion);
+
+        LLPlane planes[LLCamera::AGENT_PLANE_USER_CLIP_NUM];
+        LinearOctree::Frustum frustum;
+        U32 count = mCamera->getRegionFrustumPlanes(planes, false);
+        for (U32 i = 0; i < count; i++)
+        {
+            frustum.addPlane(planes[i]);
+        }
+
+        const LLVector3 origin = mCamera->getOrigin() - mLocalShift;
+        std::vector<LLViewerOctreeGroup*> groups;
+        std::vector<LLViewerOctreeEntry*> stale;
+        tree.cull(frustum, [&](const LLPointer<LLViewerOctreeEntry>& entry)
+            {
+                LLVOCacheEntry* vo_entry = (LLVOCacheEntry*)entry->getVOCacheEntry();
+                LLViewerOctreeGroup* group = entry->getGroup();
+                if (!vo_entry || !vo_entry->hasState(LLVOCacheEntry::IN_VO_TREE) || !group)
+                {
+                    // Left the cache tree some other way
+                    stale.push_back(entry);
+                    return;
+                }
+
+                const LLVector4a* exts = entry->getSpatialExtents();
+                if (AABBSphereIntersect(exts[0], exts[1], origin, mCamera->mFrustumCornerDist))
+                {
+                    groups.push_back(group);
+                }
+            });
+
+        for (LLViewerOctreeEntry* entry : stale)
+        {
+            tree.remove(entry);
+        }
+
+        std::sort(groups.begin(), groups.end());
+        groups.erase(std::unique(groups.begin(), groups.end()), groups.end());
+
+        std::vector<S32> results(groups.size());
+        std::vector<F32> pixel_area(groups.size());
+        frustumCheckBatch(groups.data(), (U32)groups.size(), results.data(), pixel_area.data());
+        for (U32 i = 0; i < groups.size(); i++)
+        {
+            LLViewerOctreeGroup* group = groups[i];
+            preprocess(group);
+            mRes = results[i];
+            if (mRes && (mRes == 2 || group->getOctreeNode()->getChildCount() == 0 || frustumCheckObjects(group)))
+            {
+                processGroup(group);
+            }
+        }
+        mRes = 0;
+    }
+
     virtual void processGroup(LLViewerOctreeGroup* base_group)
     {
         if( !mUseObjectCacheOcclusion ||
@@ -1042,9 +1145,21 @@ S32 LLVOCachePartition::cull(LLCamera &camera, bool do_occlusion)
     camera.calcRegionFrustumPlanes(region_agent, gAgentCamera.mDrawDistance);
 
     mFrontCull = TRUE;
-    LLVOCacheOctreeCull culler(&camera, mRegionp, region_agent, do_occlusion && use_object_cache_occlusion,
+    const bool use_occlusion = do_occlusion && use_object_cache_occlusion;
+    LLVOCacheOctreeCull culler(&camera, mRegionp, region_agent, use_occlusion,
         LLVOCacheEntry::getSquaredPixelThreshold(mFrontCull), this);
-    culler.traverse(mOctree);
+
+    // Occlusion state lives on the groups of mOctree, only plain frustum
+    // culling can go through the flat tree
+    LinearOctree* linear_octree = use_occlusion ? nullptr : getLinearOctree();
+    if (linear_octree)
+    {
+        culler.cull(*linear_octree);
+    }
+    else
+    {
+        culler.traverse(mOctree);
+    }
 
     if(!sNeedsOcclusionCheck)
     {
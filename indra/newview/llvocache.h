@@ -157,6 +157,8 @@ class LLVOCacheEntry final
 
 private:
     void updateParentBoundingInfo(const LLVOCacheEntry* child);
+    // Tells the partition holding this entry that its bounds changed
+    void updatePartitionBounds();
 
 public:
     typedef std::map<U32, LLPointer<LLVOCacheEntry> >      vocache_entry_map_t;
@@ -219,6 +221,8 @@ class LLVOCachePartition final : public LLViewerOctreePartition
 
     bool addEntry(LLViewerOctreeEntry* entry);
     void removeEntry(LLViewerOctreeEntry* entry);
+    // Called when the bounds of an entry in the tree change in place
+    void updateEntry(LLViewerOctreeEntry* entry);
     /*virtual*/ S32 cull(LLCamera &camera, bool do_occlusion);
     void addOccluders(LLViewerOctreeGroup* gp);
     void resetOccluders();
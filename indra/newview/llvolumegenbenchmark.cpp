@@ -0,0 +1,233 @@
+/**
+ * @file llvolumegenbenchmark.cpp
+ * @brief Times procedural prim volume generation on and off the main thread
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llvolumegenbenchmark.h"
+
+#include "llprimitive.h"
+#include "llsd.h"
+#include "lltimer.h"
+#include "llviewercontrol.h"
+#include "llvolumemgr.h"
+#include "llvovolume.h"
+#include "threadpool.h"
+
+#include <atomic>
+#include <random>
+
+static const S32 BENCHMARK_LOD = 3;
+
+static LLViewerBenchmark::Registrar<LLVolumeGenBenchmark> sVolumeGenBenchmark;
+
+LLVolumeGenBenchmark::LLVolumeGenBenchmark()
+    : LLViewerBenchmark("volume_gen", "VolumeGenBenchmarkQuit")
+{
+}
+
+bool LLVolumeGenBenchmark::start()
+{
+    const U32 count = gSavedSettings.getU32("VolumeGenBenchmarkCount");
+    if (count == 0)
+    {
+        return false;
+    }
+
+    static const U8 profiles[] = { LL_PCODE_PROFILE_CIRCLE, LL_PCODE_PROFILE_SQUARE, LL_PCODE_PROFILE_ISOTRI,
+                                   LL_PCODE_PROFILE_EQUALTRI, LL_PCODE_PROFILE_RIGHTTRI, LL_PCODE_PROFILE_CIRCLE_HALF };
+    static const U8 holes[] = { LL_PCODE_HOLE_SAME, LL_PCODE_HOLE_CIRCLE, LL_PCODE_HOLE_SQUARE, LL_PCODE_HOLE_TRIANGLE };
+    static const U8 paths[] = { LL_PCODE_PATH_LINE, LL_PCODE_PATH_CIRCLE, LL_PCODE_PATH_CIRCLE2, LL_PCODE_PATH_TEST };
+
+    std::mt19937 gen(1234);
+    auto pick = [&gen](F32 low, F32 high)
+    {
+        return std::uniform_real_distribution<F32>(low, high)(gen);
+    };
+
+    mParams.clear();
+    mParams.reserve(count);
+    for (U32 i = 0; i < count; ++i)
+    {
+        LLVolumeParams params;
+        params.setType(profiles[gen() % LL_ARRAY_SIZE(profiles)] | holes[gen() % LL_ARRAY_SIZE(holes)],
+                       paths[gen() % LL_ARRAY_SIZE(paths)]);
+
+        // Setters clamp, so out of range picks just land on the limits
+        F32 begin = pick(0.f, 0.5f);
+        params.setBeginAndEndS(begin, pick(begin + 0.1f, 1.f));
+        begin = pick(0.f, 0.5f);
+        params.setBeginAndEndT(begin, pick(begin + 0.1f, 1.f));
+        params.setHollow(pick(0.f, 0.95f));
+        params.setTwistBegin(pick(-1.f, 1.f));
+        params.setTwistEnd(pick(-1.f, 1.f));
+        params.setRatio(pick(0.f, 2.f), pick(0.f, 2.f));
+        params.setShear(pick(-0.5f, 0.5f), pick(-0.5f, 0.5f));
+        params.setTaper(pick(-1.f, 1.f), pick(-1.f, 1.f));
+        params.setRevolutions(pick(1.f, 4.f));
+        params.setRadiusOffset(pick(-1.f, 1.f));
+        params.setSkew(pick(-0.95f, 0.95f));
+        mParams.push_back(params);
+    }
+
+    LL_INFOS() << "Generated " << mParams.size() << " prim shapes" << LL_ENDL;
+    return true;
+}
+
+F64 LLVolumeGenBenchmark::runInline(U64& vertices)
+{
+    vertices = 0;
+    F32 detail = LLVolumeLODGroup::getVolumeScaleFromDetail(BENCHMARK_LOD);
+
+    LLTimer total;
+    for (const LLVolumeParams& params : mParams)
+    {
+        LLPointer<LLVolume> volume = new LLVolume(params, detail);
+        for (S32 i = 0; i < volume->getNumVolumeFaces(); ++i)
+        {
+            vertices += volume->getVolumeFace(i).mNumVertices;
+        }
+    }
+    return total.getElapsedTimeF64();
+}
+
+F64 LLVolumeGenBenchmark::runPooled()
+{
+    std::atomic<U32> done(0);
+    LL::WorkQueue::ptr_t queue = LL::WorkQueue::getInstance("VolumeGen");
+    F32 detail = LLVolumeLODGroup::getVolumeScaleFromDetail(BENCHMARK_LOD);
+
+    LLTimer total;
+    for (const LLVolumeParams& params : mParams)
+    {
+        const LLVolumeParams* paramsp = &params;
+        if (!queue->post([paramsp, detail, &done]()
+                {
+                    LLPointer<LLVolume> volume = new LLVolume(*paramsp, detail);
+                    ++done;
+                }))
+        {
+            // Shutting down
+            ++done;
+        }
+    }
+    while (done < mParams.size())
+    {
+        ms_sleep(1);
+    }
+    return total.getElapsedTimeF64();
+}
+
+F64 LLVolumeGenBenchmark::runDeferred(F64& until_done)
+{
+    LLVolumeMgr* volume_mgr = LLPrimitive::getVolumeManager();
+    std::vector<LLVolume*> volumes;
+    volumes.reserve(mParams.size());
+
+    LLTimer total;
+    for (const LLVolumeParams& params : mParams)
+    {
+        volumes.push_back(volume_mgr->refVolumeDeferred(params, BENCHMARK_LOD));
+    }
+    F64 handed_out = total.getElapsedTimeF64();
+
+    // Same path the render pipeline takes every frame
+    while (volume_mgr->getNumGenerating() > 0)
+    {
+        ms_sleep(1);
+        LLVOVolume::notifyGeneratedVolumes();
+    }
+    until_done = total.getElapsedTimeF64();
+
+    for (LLVolume* volume : volumes)
+    {
+        volume_mgr->unrefVolume(volume);
+    }
+    return handed_out;
+}
+
+void LLVolumeGenBenchmark::idle()
+{
+    // The main thread pass doubles as warm up for the pool passes
+    U64 vertices = 0;
+    F64 inline_time = runInline(vertices);
+
+    F64 pooled_time = 0.0;
+    F64 deferred_time = 0.0;
+    F64 deferred_done = 0.0;
+    if (LL::WorkQueue::getInstance("VolumeGen") && LL::ThreadPoolBase::getWidth("VolumeGen", 0) > 0)
+    {
+        pooled_time = runPooled();
+        deferred_time = runDeferred(deferred_done);
+    }
+    else
+    {
+        LL_WARNS() << "VolumeGen thread pool isn't running, only timing the main thread" << LL_ENDL;
+    }
+
+    report(inline_time, pooled_time, deferred_time, deferred_done, vertices);
+    finish();
+}
+
+void LLVolumeGenBenchmark::report(F64 inline_time, F64 pooled_time, F64 deferred_time, F64 deferred_done, U64 vertices)
+{
+    S32 threads = (S32)LL::ThreadPoolBase::getWidth("VolumeGen", 0);
+    inline_time = llmax(inline_time, 0.000001);
+    size_t count = mParams.size();
+
+    LLSD sd;
+    sd["volumes"] = (LLSD::Integer)count;
+    sd["lod"] = BENCHMARK_LOD;
+    sd["vertices"] = (LLSD::Real)vertices;
+    sd["threads"] = threads;
+
+    LLSD& main_thread = sd["main_thread"];
+    main_thread["seconds"] = inline_time;
+    main_thread["volumes_per_second"] = count / inline_time;
+
+    if (pooled_time > 0.0)
+    {
+        LLSD& pool = sd["pool"];
+        pool["seconds"] = pooled_time;
+        pool["volumes_per_second"] = count / pooled_time;
+        pool["speedup"] = inline_time / pooled_time;
+
+        LLSD& deferred = sd["deferred"];
+        deferred["main_thread_seconds"] = deferred_time;
+        deferred["seconds_until_done"] = deferred_done;
+        deferred["main_thread_speedup"] = inline_time / llmax(deferred_time, 0.000001);
+    }
+
+    LL_INFOS() << llformat("%u volumes at LOD %d, %llu vertices", (U32)count, BENCHMARK_LOD, (unsigned long long)vertices) << LL_ENDL;
+    LL_INFOS() << llformat("Main thread: %.3fs, %.0f volumes/s", inline_time, count / inline_time) << LL_ENDL;
+    if (pooled_time > 0.0)
+    {
+        LL_INFOS() << llformat("Pool of %d:   %.3fs, %.0f volumes/s, %.2fx", threads, pooled_time, count / pooled_time,
+                               inline_time / pooled_time) << LL_ENDL;
+        LL_INFOS() << llformat("Deferred:    %.3fs on the main thread, %.3fs until every LOD was in", deferred_time,
+                               deferred_done) << LL_ENDL;
+    }
+    writeReport(sd);
+}
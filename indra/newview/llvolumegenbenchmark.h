@@ -0,0 +1,72 @@
+/**
+ * @file llvolumegenbenchmark.h
+ * @brief Times procedural prim volume generation on and off the main thread
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLVOLUMEGENBENCHMARK_H
+#define LL_LLVOLUMEGENBENCHMARK_H
+
+#include "llviewerbenchmark.h"
+#include "llvolume.h"
+
+#include <vector>
+
+// Builds a set of random prim shapes, twisted, hollowed, tapered and cut
+// the way busy regions are, at the highest LOD. They are built once in turn
+// on the main thread and once spread over the "VolumeGen" thread pool, and
+// finally through LLVolumeMgr::refVolumeDeferred() to time what the main
+// thread still pays for the LOD 0 stand ins.
+//
+// Started with --volumegenbenchmark <count>. The shapes come from a fixed
+// seed so that runs compare. The report is logged and written to
+// volume_gen_benchmark.xml in the log directory.
+class LLVolumeGenBenchmark final : public LLViewerBenchmark
+{
+    LOG_CLASS(LLVolumeGenBenchmark);
+
+public:
+    LLVolumeGenBenchmark();
+
+protected:
+    // Makes VolumeGenBenchmarkCount random shapes
+    bool start() override;
+
+    // Runs the benchmark on the first call
+    void idle() override;
+
+private:
+    // Seconds to build every shape, on the calling thread or on the pool
+    F64 runInline(U64& vertices);
+    F64 runPooled();
+    // Seconds the main thread spends handing out stand ins, and until the
+    // last LOD is swapped in
+    F64 runDeferred(F64& until_done);
+
+    void report(F64 inline_time, F64 pooled_time, F64 deferred_time, F64 deferred_done, U64 vertices);
+
+private:
+    std::vector<LLVolumeParams> mParams;
+};
+
+#endif // LL_LLVOLUMEGENBENCHMARK_H
@@ -956,7 +956,7 @@ void LLParticlePartition::getGeometry(LLSpatialGroup* group)
     mFaceList.clear();
 }
 
-F32 LLParticlePartition::calcPixelArea(LLSpatialGroup* group, LLCamera& camera)
+F32 LLParticlePartition::calcPixelArea(LLSpatialGroup* group, LLCamera& camera, F32 estimate)
 {
     return 1024.f;
 }
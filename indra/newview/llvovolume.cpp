@@ -59,6 +59,7 @@
 #include "llsky.h"
 #include "lltexturefetch.h"
 #include "llvector4a.h"
+#include "llvector4abatch.h"
 #include "llviewercamera.h"
 #include "llviewertexturelist.h"
 #include "llviewerobjectlist.h"
@@ -106,6 +107,7 @@ F32 LLVOVolume::sLODFactor = 1.f;
 F32 LLVOVolume::sLODSlopDistanceFactor = 0.5f; //Changing this to zero, effectively disables the LOD transition slop
 F32 LLVOVolume::sDistanceFactor = 1.0f;
 S32 LLVOVolume::sNumLODChanges = 0;
+std::map<const LLVolume*, uuid_set_t> LLVOVolume::sGeneratingVolumes;
 S32 LLVOVolume::mRenderComplexity_last = 0;
 S32 LLVOVolume::mRenderComplexity_current = 0;
 LLPointer<LLObjectMediaDataClient> LLVOVolume::sObjectMediaClient = NULL;
@@ -1101,6 +1103,11 @@ BOOL LLVOVolume::setVolume(const LLVolumeParams &params_in, const S32 detail, bo
     {
         mFaceMappingChanged = TRUE;
 
+        if (getVolume()->isGenerating())
+        {
+            sGeneratingVolumes[getVolume()].insert(getID());
+        }
+
         if (mVolumeImpl)
         {
             mVolumeImpl->onSetVolume(volume_params, mLOD);
@@ -1168,6 +1175,13 @@ BOOL LLVOVolume::setVolume(const LLVolumeParams &params_in, const S32 detail, bo
     return FALSE;
 }
 
+bool LLVOVolume::canDeferVolume() const
+{
+    // Flexible volumes are rebuilt every frame, and shape edits should show
+    // right away
+    return !mVolumeImpl && !isSelected();
+}
+
 void LLVOVolume::updateSculptTexture()
 {
     LLPointer<LLViewerFetchedTexture> old_sculpt = mSculptTexture;
@@ -1245,6 +1259,41 @@ void LLVOVolume::notifyMeshLoaded()
     updateVisualComplexity();
 }
 
+void LLVOVolume::notifyVolumeGenerated()
+{
+    mSculptChanged = TRUE;
+    gPipeline.markRebuild(mDrawable, LLDrawable::REBUILD_GEOMETRY);
+}
+
+//static
+void LLVOVolume::notifyGeneratedVolumes()
+{
+    LL_PROFILE_ZONE_SCOPED_CATEGORY_VOLUME;
+
+    std::vector<LLPointer<LLVolume> > done;
+    LLPrimitive::getVolumeManager()->updateGenerated(done);
+
+    for (const LLPointer<LLVolume>& volume : done)
+    {
+        auto iter = sGeneratingVolumes.find(volume.get());
+        if (iter == sGeneratingVolumes.end())
+        {
+            continue;
+        }
+        for (const LLUUID& id : iter->second)
+        {
+            // Objects can be gone or have moved on to another volume
+            LLViewerObject* objectp = gObjectList.findObject(id);
+            LLVOVolume* vobj = objectp ? objectp->asVolume() : nullptr;
+            if (vobj && !vobj->isDead() && vobj->getVolume() == volume.get())
+            {
+                vobj->notifyVolumeGenerated();
+            }
+        }
+        sGeneratingVolumes.erase(iter);
+    }
+}
+
 void LLVOVolume::notifySkinInfoLoaded(const LLMeshSkinInfo* skin)
 {
     mSkinInfoUnavaliable = false;
@@ -5032,17 +5081,12 @@ void LLRiggedVolume::update(
                 rigged_face_count++;
 
                 {
+                    LLVector4aBatch::affineTransform(bind_shape_matrix, vol_face.mPositions, pos, dst_face.mNumVertices);
                     for (U32 j = 0; j < dst_face.mNumVertices; ++j)
                     {
                         LLMatrix4a final_mat;
                         LLSkinningUtil::getPerVertexSkinMatrixUnchecked(weight[j], mat, final_mat);
-
-                        LLVector4a& v = vol_face.mPositions[j];
-                        LLVector4a t;
-                        LLVector4a dst;
-                        bind_shape_matrix.affineTransform(v, t);
-                        final_mat.affineTransform(t, dst);
-                        pos[j] = dst;
+                        final_mat.affineTransform(pos[j], pos[j]);
                     }
                 }
 
@@ -5051,32 +5095,34 @@ void LLRiggedVolume::update(
                 LLVector4a& min = dst_face.mExtents[0];
                 LLVector4a& max = dst_face.mExtents[1];
 
-                min = pos[0];
-                max = pos[1];
+                LLVector4aBatch::getMinMax(pos, dst_face.mNumVertices, min, max);
                 if (i==0)
                 {
                     box_min = min;
                     box_max = max;
                 }
 
-                for (U32 j = 1; j < dst_face.mNumVertices; ++j)
-                {
-                    min.setMin(min, pos[j]);
-                    max.setMax(max, pos[j]);
-                }
-
                 box_min.setMin(min,box_min);
                 box_max.setMax(max,box_max);
 
                 dst_face.mCenter->setAdd(dst_face.mExtents[0], dst_face.mExtents[1]);
                 dst_face.mCenter->mul(0.5f);
 
+                // the hierarchy holds a copy of the old positions
+                dst_face.destroyBVH();
             }
 
             if (rebuild_face_octrees)
             {
-                dst_face.destroyOctree();
-                dst_face.createOctree();
+                if (LLVolume::sUseBVH)
+                {
+                    dst_face.createBVH();
+                }
+                else
+                {
+                    dst_face.destroyOctree();
+                    dst_face.createOctree();
+                }
             }
         }
     }
@@ -232,6 +232,7 @@ class LLVOVolume final : public LLViewerObject
                 void    setTexture(const S32 face);
                 S32     getIndexInTex(U32 ch) const {return mIndexInTex[ch];}
     /*virtual*/ BOOL    setVolume(const LLVolumeParams &volume_params, const S32 detail, bool unique_volume = false) override;
+                bool    canDeferVolume() const override;
                 void    updateSculptTexture();
                 void    setIndexInTex(U32 ch, S32 index) { mIndexInTex[ch] = index ;}
                 void    sculpt();
@@ -392,6 +393,11 @@ class LLVOVolume final : public LLViewerObject
     void updateVisualComplexity();
 
     void notifyMeshLoaded();
+    // The volume finished building on the LLVolumeMgr thread pool
+    void notifyVolumeGenerated();
+    // Collects the volumes LLVolumeMgr finished and rebuilds the objects
+    // that waited on them. Main thread, once a frame.
+    static void notifyGeneratedVolumes();
     void notifySkinInfoLoaded(const LLMeshSkinInfo* skin);
     void notifySkinInfoUnavailable();
 
@@ -507,6 +513,9 @@ class LLVOVolume final : public LLViewerObject
 protected:
     static S32 sNumLODChanges;
 
+    // Objects showing a stand in, by the volume being built
+    static std::map<const LLVolume*, uuid_set_t> sGeneratingVolumes;
+
     friend class LLVolumeImplFlexible;
 };
 
@@ -2499,7 +2499,7 @@ void LLPipeline::updateCull(LLCamera& camera, LLCullResult& result)
     }
 }
 
-void LLPipeline::markNotCulled(LLSpatialGroup* group, LLCamera& camera)
+void LLPipeline::markNotCulled(LLSpatialGroup* group, LLCamera& camera, F32 pixel_area)
 {
     if (group->isEmpty())
     {
@@ -2510,7 +2510,7 @@ void LLPipeline::markNotCulled(LLSpatialGroup* group, LLCamera& camera)
 
     if (LLViewerCamera::sCurCameraID == LLViewerCamera::CAMERA_WORLD && !gCubeSnapshot)
     {
-        group->updateDistance(camera);
+        group->updateDistance(camera, pixel_area);
     }
 
     assertInitialized();
@@ -2746,6 +2746,7 @@ void LLPipeline::rebuildPriorityGroups()
     assertInitialized();
 
     gMeshRepo.notifyLoadedMeshes();
+    LLVOVolume::notifyGeneratedVolumes();
 
     mGroupQ1Locked = true;
     // Iterate through all drawables on the priority build queue,
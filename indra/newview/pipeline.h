@@ -172,7 +172,7 @@ class LLPipeline
     void        markOccluder(LLSpatialGroup* group);
 
     void        doOcclusion(LLCamera& camera);
-    void        markNotCulled(LLSpatialGroup* group, LLCamera &camera);
+    void        markNotCulled(LLSpatialGroup* group, LLCamera &camera, F32 pixel_area = -1.f);
     void        markMoved(LLDrawable *drawablep, bool damped_motion = false);
     void        markShift(LLDrawable *drawablep);
     void        markTextured(LLDrawable *drawablep);
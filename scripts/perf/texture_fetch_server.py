@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+"""\
+@file texture_fetch_server.py
+@brief Serve a directory of j2c files the way the ViewerAsset capability
+       does, for the Viewer's texture fetch benchmark. Pass --help for details.
+
+$LicenseInfo:firstyear=2026&license=viewerlgpl$
+Second Life Viewer Source Code
+Copyright (C) 2026, Linden Research, Inc.
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation;
+version 2.1 of the License only.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+$/LicenseInfo$
+"""
+
+# Typical use, with a directory of <uuid>.j2c files:
+#
+#   texture_fetch_server.py textures --trace trace.xml --passes 2
+#   texture_fetch_server.py textures --latency 50 --bandwidth 4096 &
+#   secondlife-bin --texturefetchbenchmark trace.xml --set HeadlessClient 1 --purge
+#
+# The first pass of the trace fetches everything over HTTP, the second
+# reads it back from the texture cache. The Viewer logs the results and
+# writes them to texture_fetch_benchmark.xml in its log directory.
+
+import argparse
+import os
+import re
+import threading
+import time
+import uuid
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import urlparse, parse_qs
+from xml.sax.saxutils import escape
+
+RANGE_RE = re.compile(r"bytes=(\d+)-(\d*)")
+
+
+class Stats:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.requests = 0
+        self.bytes = 0
+        self.missing = 0
+
+    def add(self, sent, missing=False):
+        with self.lock:
+            self.requests += 1
+            self.bytes += sent
+            self.missing += int(missing)
+
+
+class TextureHandler(BaseHTTPRequestHandler):
+    # Set by main()
+    directory = "."
+    latency = 0.0
+    bandwidth = 0
+    stats = Stats()
+
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, format, *args):
+        if self.server.verbose:
+            BaseHTTPRequestHandler.log_message(self, format, *args)
+
+    def do_GET(self):
+        query = parse_qs(urlparse(self.path).query)
+        texture_id = query.get("texture_id", [""])[0]
+        try:
+            texture_id = str(uuid.UUID(texture_id))
+        except ValueError:
+            self.send_error(400, "Bad texture_id")
+            return
+        path = os.path.join(self.directory, texture_id + ".j2c")
+        try:
+            with open(path, "rb") as f:
+                data = f.read()
+        except OSError:
+            self.stats.add(0, missing=True)
+            self.send_error(404, "Not found")
+            return
+
+        if self.latency:
+            time.sleep(self.latency)
+
+        # The fetcher asks for a byte range and reads the full size from
+        # Content-Range, like the real asset servers answer
+        status = 200
+        start, end = 0, len(data) - 1
+        match = RANGE_RE.match(self.headers.get("Range", ""))
+        if match:
+            start = int(match.group(1))
+            if match.group(2):
+                end = min(int(match.group(2)), end)
+            if start >= len(data):
+                self.send_response(416)
+                self.send_header("Content-Range", "bytes */%d" % len(data))
+                self.send_header("Content-Length", "0")
+                self.end_headers()
+                self.stats.add(0)
+                return
+            status = 206
+
+        body = data[start:end + 1]
+        self.send_response(status)
+        self.send_header("Content-Type", "image/x-j2c")
+        self.send_header("Content-Length", str(len(body)))
+        if status == 206:
+            self.send_header("Content-Range", "bytes %d-%d/%d" % (start, end, len(data)))
+        self.end_headers()
+        self.send_body(body)
+        self.stats.add(len(body))
+
+    def send_body(self, body):
+        if not self.bandwidth:
+            self.wfile.write(body)
+            return
+        # Trickle the body out at the requested rate per connection
+        chunk = max(1024, self.bandwidth // 20)
+        for offset in range(0, len(body), chunk):
+            self.wfile.write(body[offset:offset + chunk])
+            time.sleep(chunk / self.bandwidth)
+
+
+def write_trace(args):
+    ids = []
+    for name in sorted(os.listdir(args.directory)):
+        root, ext = os.path.splitext(name)
+        if ext.lower() != ".j2c":
+            continue
+        try:
+            ids.append(str(uuid.UUID(root)))
+        except ValueError:
+            continue
+    if not ids:
+        print(f"No <uuid>.j2c files in {args.directory}")
+        return
+
+    # Each pass requests every texture, spread over --spread seconds,
+    # starting --interval seconds after the previous pass
+    with open(args.trace, "w") as f:
+        f.write('<?xml version="1.0" ?>\n<llsd>\n<array>\n')
+        for p in range(args.passes):
+            for i, texture_id in enumerate(ids):
+                t = p * args.interval + args.spread * i / len(ids)
+                f.write("  <map><key>time</key><real>%f</real>"
+                        "<key>id</key><uuid>%s</uuid>"
+                        "<key>discard</key><integer>%d</integer></map>\n"
+                        % (t, escape(texture_id), args.discard))
+        f.write("</array>\n</llsd>\n")
+    print(f"Wrote {len(ids) * args.passes} requests for {len(ids)} textures to {args.trace}")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Serve <uuid>.j2c files as /?texture_id=<uuid> for "
+                    "the Viewer's --texturefetchbenchmark option")
+    parser.add_argument("directory", help="directory of <uuid>.j2c files")
+    parser.add_argument("--port", type=int, default=8000)
+    parser.add_argument("--latency", type=float, default=0,
+                        help="milliseconds to wait before answering each request")
+    parser.add_argument("--bandwidth", type=int, default=0,
+                        help="KB/s per connection, 0 for unlimited")
+    parser.add_argument("--verbose", action="store_true", help="log every request")
+    parser.add_argument("--trace", help="write a request trace for the directory to this file and exit")
+    parser.add_argument("--passes", type=int, default=1, help="times the trace requests each texture")
+    parser.add_argument("--interval", type=float, default=30, help="seconds between passes")
+    parser.add_argument("--spread", type=float, default=0, help="seconds over which a pass is issued")
+    parser.add_argument("--discard", type=int, default=0, help="discard level the trace requests")
+    args = parser.parse_args()
+
+    if args.trace:
+        write_trace(args)
+        return
+
+    TextureHandler.directory = args.directory
+    TextureHandler.latency = args.latency / 1000.0
+    TextureHandler.bandwidth = args.bandwidth * 1024
+    server = ThreadingHTTPServer(("127.0.0.1", args.port), TextureHandler)
+    server.verbose = args.verbose
+    print(f"Serving {args.directory} on http://127.0.0.1:{args.port}")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    stats = TextureHandler.stats
+    print(f"{stats.requests} requests, {stats.bytes} bytes sent, {stats.missing} not found")
+
+
+if __name__ == "__main__":
+    main()